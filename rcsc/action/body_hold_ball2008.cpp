@@ -47,6 +47,10 @@
 #include <rcsc/geom/rect_2d.h>
 #include <rcsc/geom/line_2d.h>
 
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
 // #define DEBUG_CREATE
 // #define DEBUG_EVAL
 // #define DEBUG_PRINT_RESULTS
@@ -55,13 +59,39 @@ namespace rcsc {
 
 namespace {
 
-struct KeepPointSorter {
-    bool operator()( const Body_HoldBall2008::KeepPoint & lhs,
-                     const Body_HoldBall2008::KeepPoint & rhs ) const
-      {
-          return lhs.score_ < rhs.score_;
-      }
-};
+//! the number of candidate directions
+constexpr int DIR_DIVS = 20;
+constexpr double DIR_STEP = 360.0 / DIR_DIVS;
+
+/*-------------------------------------------------------------------*/
+const std::array< Vector2D, DIR_DIVS > &
+get_unit_vectors()
+{
+    static std::array< Vector2D, DIR_DIVS > s_unit_vectors;
+    static bool s_initialized = false;
+
+    if ( ! s_initialized )
+    {
+        for ( int a = 0; a < DIR_DIVS; ++a )
+        {
+            s_unit_vectors[a] = Vector2D::polar2vector( 1.0, AngleDeg( -180.0 + DIR_STEP * a ) );
+        }
+        s_initialized = true;
+    }
+
+    return s_unit_vectors;
+}
+
+/*-------------------------------------------------------------------*/
+const Rect2D &
+their_penalty_area()
+{
+    static const Rect2D penalty_area( Vector2D( ServerParam::i().theirPenaltyAreaLineX(),
+                                                - ServerParam::i().penaltyAreaHalfWidth() ),
+                                      Size2D( ServerParam::i().penaltyAreaLength(),
+                                              ServerParam::i().penaltyAreaWidth() ) );
+    return penalty_area;
+}
 
 }
 
@@ -163,21 +193,24 @@ Vector2D
 Body_HoldBall2008::searchKeepPoint( const WorldModel & wm )
 {
     static GameTime s_last_update_time( 0, 0 );
-    static std::vector< KeepPoint > s_keep_points;
+    static KeepPointCont s_keep_points;
     static KeepPoint s_best_keep_point;
 
     if ( s_last_update_time != wm.time() )
     {
+        s_last_update_time = wm.time();
         s_best_keep_point.reset();
 
         createKeepPoints( wm, s_keep_points );
-        evaluateKeepPoints( wm, s_keep_points );
 
-        if ( ! s_keep_points.empty() )
+        const int best = select_best_keep_point( wm.self().pos() + wm.self().vel(),
+                                                 wm.ball().pos(),
+                                                 wm.self().playerType().kickableArea(),
+                                                 getOpponentReaches( wm ),
+                                                 s_keep_points );
+        if ( best >= 0 )
         {
-            s_best_keep_point = *std::max_element( s_keep_points.begin(),
-                                                   s_keep_points.end(),
-                                                   KeepPointSorter() );
+            s_best_keep_point = s_keep_points.points_[best];
         }
     }
 
@@ -190,7 +223,7 @@ Body_HoldBall2008::searchKeepPoint( const WorldModel & wm )
  */
 void
 Body_HoldBall2008::createKeepPoints( const WorldModel & wm,
-                                     std::vector< KeepPoint > & candidates )
+                                     KeepPointCont & candidates )
 {
     const ServerParam & SP = ServerParam::i();
 
@@ -201,8 +234,7 @@ Body_HoldBall2008::createKeepPoints( const WorldModel & wm,
                                  ? SP.keepawayWidth() * 0.5 - 0.2
                                  : SP.pitchHalfWidth() - 0.2 );
 
-    const int dir_divs = 20;
-    const double dir_step = 360.0 / dir_divs;
+    static_assert( 3 * DIR_DIVS <= MAX_KEEP_POINTS, "too many keep points" );
 
     const double near_dist = wm.self().playerType().playerSize()
         + SP.ballSize()
@@ -214,13 +246,12 @@ Body_HoldBall2008::createKeepPoints( const WorldModel & wm,
         + SP.ballSize()
         + wm.self().playerType().kickableMargin() * 0.75;
 
-    candidates.clear();
-    candidates.reserve( dir_divs * 2 );
+    candidates.size_ = 0;
 
 #ifdef DEBUG_CREATE
     dlog.addText( Logger::HOLD,
                   __FILE__": createCandidatePoints() dir_divs=%d",
-                  dir_divs );
+                  DIR_DIVS );
 #endif
 
     const Vector2D my_next = wm.self().pos() + wm.self().vel();
@@ -239,12 +270,15 @@ Body_HoldBall2008::createKeepPoints( const WorldModel & wm,
         = 0.5 + 0.5 * ( wm.ball().vel().r()
                         / ( SP.ballSpeedMax() * SP.ballDecay() ) );
 
+    const std::array< Vector2D, DIR_DIVS > & unit_vectors = get_unit_vectors();
+
     // angle loop
-    for ( double d = -180.0; d < 180.0; d += dir_step )
+    for ( int a = 0; a < DIR_DIVS; ++a )
     {
+        const double d = -180.0 + DIR_STEP * a;
         const AngleDeg angle = d;
         const double dir_diff = ( angle - wm.self().body() ).abs();
-        const Vector2D unit_pos = Vector2D::polar2vector( 1.0, angle );
+        const Vector2D & unit_pos = unit_vectors[a];
 
         // near side point
         {
@@ -268,9 +302,9 @@ Body_HoldBall2008::createKeepPoints( const WorldModel & wm,
                                   near_pos.x, near_pos.y,
                                   d, near_dist );
 #endif
-                    candidates.emplace_back( near_pos,
-                                             near_krate,
-                                             DEFAULT_SCORE );
+                    candidates.points_[candidates.size_++] = KeepPoint( near_pos,
+                                                                        near_krate,
+                                                                        DEFAULT_SCORE );
                 }
 #ifdef DEBUG_CREATE
                 else
@@ -338,9 +372,9 @@ Body_HoldBall2008::createKeepPoints( const WorldModel & wm,
                                       mid_pos.x, mid_pos.y,
                                       d, mid_dist );
 #endif
-                        candidates.emplace_back( mid_pos,
-                                                 mid_krate,
-                                                 DEFAULT_SCORE );
+                        candidates.points_[candidates.size_++] = KeepPoint( mid_pos,
+                                                                            mid_krate,
+                                                                            DEFAULT_SCORE );
                     }
 #ifdef DEBUG_CREATE
                     else
@@ -423,9 +457,9 @@ Body_HoldBall2008::createKeepPoints( const WorldModel & wm,
                                       far_pos.x, far_pos.y,
                                       d, far_dist );
 #endif
-                        candidates.emplace_back( far_pos,
-                                                 far_krate,
-                                                 DEFAULT_SCORE );
+                        candidates.points_[candidates.size_++] = KeepPoint( far_pos,
+                                                                            far_krate,
+                                                                            DEFAULT_SCORE );
                     }
 #ifdef DEBUG_CREATE
                     else
@@ -476,7 +510,7 @@ Body_HoldBall2008::createKeepPoints( const WorldModel & wm,
 
     dlog.addText( Logger::HOLD,
                   __FILE__": createCandidatePoints() size=%d",
-                  (int)candidates.size() );
+                  candidates.size_ );
 }
 
 /*-------------------------------------------------------------------*/
@@ -484,81 +518,90 @@ Body_HoldBall2008::createKeepPoints( const WorldModel & wm,
 
  */
 void
-Body_HoldBall2008::evaluateKeepPoints( const WorldModel & wm,
-                                       std::vector< KeepPoint > & keep_points )
+Body_HoldBall2008::OpponentReach::assign( const Vector2D & next_pos,
+                                          const AngleDeg & body,
+                                          const PlayerType & player_type,
+                                          const bool goalie_in_penalty_area )
 {
-#ifdef DEBUG_EVAL
-    int count = 0;
-    dlog.addText( Logger::HOLD,
-                  __FILE__"(evaluate) =========" );
-#endif
-    for ( KeepPoint & p : keep_points )
+    const ServerParam & SP = ServerParam::i();
+
+    next_pos_ = next_pos;
+    kickable_area_ = player_type.kickableArea();
+    goalie_in_penalty_area_ = goalie_in_penalty_area;
+
+    // same as Vector2D::rotatedVector( -body )
+    const double rotate_deg = ( -body ).degree();
+    rotate_cos_ = std::cos( rotate_deg * AngleDeg::DEG2RAD );
+    rotate_sin_ = std::sin( rotate_deg * AngleDeg::DEG2RAD );
+
+    //
+    // max move by one dash for each direction
+    //
+    const double dash_angle_step = std::max( 15.0, SP.dashAngleStep() );
+    dash_divs_ = std::min( MAX_DASH_DIVS,
+                           static_cast< int >( std::floor( ( SP.maxDashAngle() - SP.minDashAngle() )
+                                                           / dash_angle_step ) ) );
+
+    double max_move_dist = 0.0;
+    for ( int d = 0; d < dash_divs_; ++d )
     {
-#ifdef DEBUG_EVAL
-        dlog.addText( Logger::HOLD,
-                      "%d: (evaluate) (%.2f %.2f)",
-                      ++count, p.pos_.x, p.pos_.y );
-#endif
-        p.score_ = evaluateKeepPoint( wm, p.pos_ );
-        // if ( p.score_ < DEFAULT_SCORE - 1.0e-5 )
-        // {
-        //     p.score_ += p.pos_.dist( wm.ball().pos() ) * 0.001;
-        // }
-        // else
-        {
-            p.score_ += p.kick_rate_ * 1000.0;
-        }
+        const double dir = AngleDeg::normalize_angle( SP.minDashAngle() + ( dash_angle_step * d ) );
+        const AngleDeg dash_angle = SP.discretizeDashAngle( dir );
+        const double max_accel = ( SP.maxDashPower()
+                                   * player_type.dashPowerRate()
+                                   * player_type.effortMax()
+                                   * SP.dashDirRate( dir ) );
+        max_move_[d] = Vector2D::from_polar( max_accel, dash_angle );
+        max_move_dist = std::max( max_move_dist, std::fabs( max_accel ) );
     }
 
-#ifdef DEBUG_EVAL
-    Vector2D self_next = wm.self().pos() + wm.self().vel();
-    double k = wm.self().playerType().kickableArea();
-    dlog.addCircle( Logger::HOLD,
-                    self_next, 0.3, "#F00", true );
-    dlog.addCircle( Logger::HOLD,
-                    self_next, k, "#F00" );
-
-    dlog.addText( Logger::HOLD,
-                  __FILE__"(results) =========" );
-    count = 0;
-    for ( const KeepPoint & p : keep_points )
+    //
+    // the keep point outside of this radius is affected only by the body line check.
+    //
+    if ( SP.foulExponent() <= 0.0 )
     {
-        ++count;
-        char score[16];
-        snprintf( score, 16, "%d:%.3f", count, p.score_ );
-        dlog.addText( Logger::HOLD,
-                      "%d: (evaluate) (%.2f %.2f) score=%f",
-                      count, p.pos_.x, p.pos_.y, p.score_ );
-        dlog.addRect( Logger::HOLD,
-                      p.pos_.x - 0.02, p.pos_.y - 0.02, 0.04, 0.04, "#0F0" );
-        dlog.addMessage( Logger::HOLD,
-                         p.pos_, score );
+        reach_radius2_ = std::numeric_limits< double >::max();
+        return;
     }
-    dlog.addText( Logger::HOLD,
-                  __FILE__"(results) =========" );
-#endif
+
+    const double control_area = ( goalie_in_penalty_area
+                                  ? std::max( SP.catchableArea(), kickable_area_ )
+                                  : kickable_area_ );
+    const double tackle_radius = std::hypot( std::max( SP.tackleDist(), SP.tackleBackDist() ),
+                                             SP.tackleWidth() );
+    const double next_tackle_radius = std::hypot( SP.tackleDist() + 0.1,
+                                                  SP.tackleWidth() + 0.1 );
+    const double radius = std::max( { control_area + 0.1,
+                                      tackle_radius,
+                                      std::max( control_area + 0.1, next_tackle_radius ) + max_move_dist } )
+        + 1.0e-3;
+
+    reach_radius2_ = radius * radius;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
 
  */
-double
-Body_HoldBall2008::evaluateKeepPoint( const WorldModel & wm,
-                                      const Vector2D & keep_point )
+const Body_HoldBall2008::OpponentReachCont &
+Body_HoldBall2008::getOpponentReaches( const WorldModel & wm )
 {
-    static const Rect2D penalty_area( Vector2D( ServerParam::i().theirPenaltyAreaLineX(),
-                                                - ServerParam::i().penaltyAreaHalfWidth() ),
-                                      Size2D( ServerParam::i().penaltyAreaLength(),
-                                              ServerParam::i().penaltyAreaWidth() ) );
     static const double consider_dist = ( ServerParam::i().tackleDist()
                                           + ServerParam::i().defaultPlayerSpeedMax()
                                           + 1.0 );
-    const ServerParam & SP = ServerParam::i();
+    static GameTime s_update_time( -1, 0 );
+    static OpponentReachCont s_opponents;
 
+    if ( s_update_time == wm.time() )
+    {
+        return s_opponents;
+    }
+    s_update_time = wm.time();
+
+    const Rect2D & penalty_area = their_penalty_area();
     const Vector2D my_next = wm.self().pos() + wm.self().vel();
 
-    double score = DEFAULT_SCORE;
+    s_opponents.size_ = 0;
 
     for ( const PlayerObject * o : wm.opponentsFromBall() )
     {
@@ -568,48 +611,9 @@ Body_HoldBall2008::evaluateKeepPoint( const WorldModel & wm,
         if ( o->isGhost() ) continue;
         if ( o->isTackling() ) continue;
 
-        const PlayerType * player_type = o->playerTypePtr();
-        const Vector2D opp_next = o->pos() + o->vel();
-        const double control_area = ( ( o->goalie()
-                                        && penalty_area.contains( opp_next )
-                                        && penalty_area.contains( keep_point ) )
-                                      ? SP.catchableArea()
-                                      : player_type->kickableArea() );
-        const double opp_dist = opp_next.dist( keep_point );
-
-        if ( opp_dist < control_area * 0.5 )
-        {
-            score -= 200.0;
-#ifdef DEBUG_EVAL
-            dlog.addText( Logger::HOLD,
-                          "____ opp %d(%.1f %.1f) can control(1). score=%.3f",
-                          o->unum(),
-                          o->pos().x, o->pos().y, score );
-
-#endif
-        }
-        else if ( opp_dist < control_area + 0.1 )
-        {
-            score -= 150.0;
-#ifdef DEBUG_EVAL
-            dlog.addText( Logger::HOLD,
-                          "____ opp %d(%.1f %.1f) can control(2). score=%.3f",
-                          o->unum(),
-                          o->pos().x, o->pos().y, score );
-
-#endif
-        }
-        else if ( opp_dist < SP.tackleDist() - 0.2 )
-        {
-            score -= 25.0;
-#ifdef DEBUG_EVAL
-            dlog.addText( Logger::HOLD,
-                          "____ opp %d(%.1f %.1f) within tackle. score=%.3f",
-                          o->unum(),
-                          o->pos().x, o->pos().y, score );
+        if ( s_opponents.size_ >= MAX_OPPONENTS ) break;
 
-#endif
-        }
+        const Vector2D opp_next = o->pos() + o->vel();
 
         AngleDeg opp_body;
         if ( o->bodyCount() == 0 )
@@ -626,140 +630,313 @@ Body_HoldBall2008::evaluateKeepPoint( const WorldModel & wm,
             opp_body = ( my_next - opp_next ).th();
         }
 
+        s_opponents.opponents_[s_opponents.size_].assign( opp_next,
+                                                          opp_body,
+                                                          *o->playerTypePtr(),
+                                                          ( o->goalie()
+                                                            && penalty_area.contains( opp_next ) ) );
+        ++s_opponents.size_;
+    }
+
+    return s_opponents;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+Body_HoldBall2008::evaluateKeepPoint( const WorldModel & wm,
+                                      const Vector2D & keep_point )
+{
+    return evaluate_keep_point( keep_point,
+                                wm.self().pos() + wm.self().vel(),
+                                wm.ball().pos(),
+                                wm.self().playerType().kickableArea(),
+                                getOpponentReaches( wm ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+Body_HoldBall2008::add_opponent_penalty( const Vector2D & keep_point,
+                                         const OpponentReach & opponent,
+                                         double score )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    const Vector2D rel = keep_point - opponent.next_pos_;
+    const Vector2D player_2_pos( rel.x * opponent.rotate_cos_ - rel.y * opponent.rotate_sin_,
+                                 rel.x * opponent.rotate_sin_ + rel.y * opponent.rotate_cos_ );
+
+    const double control_area = ( ( opponent.goalie_in_penalty_area_
+                                    && their_penalty_area().contains( keep_point ) )
+                                  ? SP.catchableArea()
+                                  : opponent.kickable_area_ );
+
+    if ( rel.r2() > opponent.reach_radius2_ )
+    {
         //
         // check opponent body line
         //
-
-        const Vector2D player_2_pos = ( keep_point - opp_next ).rotatedVector( -opp_body );
-
         if ( player_2_pos.absY() < control_area )
         {
-            // if ( player_2_pos.absY() < control_area * 0.8 )
-            // {
-            //     score -= 20.0;
-            // }
-            // else
-            // {
-            //     score -= 10.0;
-            // }
-
             score -= ( control_area - player_2_pos.absY() ) * 50.0;
+        }
+        return score;
+    }
+
+    const double opp_dist = opponent.next_pos_.dist( keep_point );
 
+    if ( opp_dist < control_area * 0.5 )
+    {
+        score -= 200.0;
 #ifdef DEBUG_EVAL
-            dlog.addText( Logger::HOLD,
-                          "____ opp %d(%.1f %.1f) on body line. body=%.1f y=%.3f score=%.3f",
-                          o->unum(),
-                          o->pos().x, o->pos().y, opp_body.degree(),
-                          player_2_pos.absY(),
-                          score );
+        dlog.addText( Logger::HOLD,
+                      "____ opp (%.1f %.1f) can control(1). score=%.3f",
+                      opponent.next_pos_.x, opponent.next_pos_.y, score );
+#endif
+    }
+    else if ( opp_dist < control_area + 0.1 )
+    {
+        score -= 150.0;
+#ifdef DEBUG_EVAL
+        dlog.addText( Logger::HOLD,
+                      "____ opp (%.1f %.1f) can control(2). score=%.3f",
+                      opponent.next_pos_.x, opponent.next_pos_.y, score );
+#endif
+    }
+    else if ( opp_dist < SP.tackleDist() - 0.2 )
+    {
+        score -= 25.0;
+#ifdef DEBUG_EVAL
+        dlog.addText( Logger::HOLD,
+                      "____ opp (%.1f %.1f) within tackle. score=%.3f",
+                      opponent.next_pos_.x, opponent.next_pos_.y, score );
+#endif
+    }
 
+    //
+    // check opponent body line
+    //
+    if ( player_2_pos.absY() < control_area )
+    {
+        score -= ( control_area - player_2_pos.absY() ) * 50.0;
+#ifdef DEBUG_EVAL
+        dlog.addText( Logger::HOLD,
+                      "____ opp (%.1f %.1f) on body line. y=%.3f score=%.3f",
+                      opponent.next_pos_.x, opponent.next_pos_.y,
+                      player_2_pos.absY(), score );
 #endif
-        }
+    }
 
-        //
-        // check tackle probability
-        //
+    //
+    // check tackle probability
+    //
+    {
+        double tackle_dist = ( player_2_pos.x > 0.0
+                               ? SP.tackleDist()
+                               : SP.tackleBackDist() );
+        if ( tackle_dist > 1.0e-5 )
         {
-            double tackle_dist = ( player_2_pos.x > 0.0
-                                   ? SP.tackleDist()
-                                   : SP.tackleBackDist() );
-            if ( tackle_dist > 1.0e-5 )
+            double tackle_fail_prob = ( std::pow( player_2_pos.absX() / tackle_dist,
+                                                  SP.foulExponent() )
+                                        + std::pow( player_2_pos.absY() / SP.tackleWidth(),
+                                                    SP.foulExponent() ) );
+            if ( tackle_fail_prob < 1.0 )
             {
-                double tackle_fail_prob = ( std::pow( player_2_pos.absX() / tackle_dist,
-                                                      SP.foulExponent() )
-                                            + std::pow( player_2_pos.absY() / SP.tackleWidth(),
-                                                        SP.foulExponent() ) );
-                if ( tackle_fail_prob < 1.0 )
-                    //&& 1.0 - tackle_fail_prob > 0.7 ) // success probability
-                {
-                    //score -= 30.0;
-                    score -= ( 1.0 - tackle_fail_prob ) * 50.0;
+                score -= ( 1.0 - tackle_fail_prob ) * 50.0;
 #ifdef DEBUG_EVAL
-                    dlog.addText( Logger::HOLD,
-                                  "____ tackle_prob=%.3f %d(%.1f %.1f) body=%.1f score=%.3f",
-                                  1.0 - tackle_fail_prob,
-                                  o->unum(),
-                                  o->pos().x, o->pos().y,
-                                  opp_body.degree(), score );
+                dlog.addText( Logger::HOLD,
+                              "____ tackle_prob=%.3f (%.1f %.1f) score=%.3f",
+                              1.0 - tackle_fail_prob,
+                              opponent.next_pos_.x, opponent.next_pos_.y, score );
 #endif
-                }
             }
         }
+    }
 
-        //
-        // check kick or tackle possibility after dash
-        //
-        const double dash_angle_step = std::max( 15.0, SP.dashAngleStep() );
-        const int dash_angle_divs
-            = static_cast< int >( std::floor( ( SP.maxDashAngle() - SP.minDashAngle() )
-                                              / dash_angle_step ) );
-
-        double next_kick_penalty = 0.0;
-        double next_tackle_penalty = 0.0;
-        for ( int d = 0; d < dash_angle_divs; ++d )
-        {
-            const double dir = AngleDeg::normalize_angle( SP.minDashAngle() + ( dash_angle_step * d ) );
-            const AngleDeg dash_angle = SP.discretizeDashAngle( dir );
-            const double max_accel = ( SP.maxDashPower()
-                                       * player_type->dashPowerRate()
-                                       * player_type->effortMax()
-                                       * SP.dashDirRate( dir ) );
-            const Vector2D max_move = Vector2D::from_polar( max_accel, dash_angle );
+    //
+    // check kick or tackle possibility after dash
+    //
+    const double next_control_area2 = std::pow( control_area + 0.1, 2 );
 
-            const Vector2D next_player_2_pos = player_2_pos - max_move;
+    double next_kick_penalty = 0.0;
+    double next_tackle_penalty = 0.0;
+    for ( int d = 0; d < opponent.dash_divs_; ++d )
+    {
+        const Vector2D next_player_2_pos = player_2_pos - opponent.max_move_[d];
 
-            if ( next_player_2_pos.r2() < std::pow( control_area + 0.1, 2 ) )
-            {
+        if ( next_player_2_pos.r2() < next_control_area2 )
+        {
+            next_kick_penalty -= 20.0;
+        }
+        else if ( next_player_2_pos.absY() < SP.tackleWidth() + 0.1
+                  && next_player_2_pos.x > 0.0
+                  && next_player_2_pos.x < SP.tackleDist() + 0.1 )
+        {
+            next_tackle_penalty -= 10.0;
+        }
+    }
+
+    score += next_kick_penalty;
+    score += next_tackle_penalty;
 #ifdef DEBUG_EVAL
-                dlog.addText( Logger::HOLD,
-                              "____ next kickable %d opponent_body=%.1f dash_dir=%.0f max_accel=%.3f",
-                              o->unum(), opp_body.degree(), dir, max_accel );
+    dlog.addText( Logger::HOLD,
+                  "____ kick_penalty=%.1f tackle_penalty=%.1f score=%.3f",
+                  next_kick_penalty, next_tackle_penalty, score );
 #endif
-                //next_kick_penalty = -20.0;
-                next_kick_penalty -= 20.0;
-            }
-            else if ( next_player_2_pos.absY() < SP.tackleWidth() + 0.1
-                      && next_player_2_pos.x > 0.0
-                      && next_player_2_pos.x < SP.tackleDist() + 0.1 )
+
+    return score;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+Body_HoldBall2008::keep_distance_rate( const Vector2D & keep_point,
+                                       const Vector2D & my_next,
+                                       const Vector2D & ball_pos,
+                                       const double my_kickable_area )
+{
+    double ball_move_dist = ( keep_point - ball_pos ).r();
+    if ( ball_move_dist > my_kickable_area * 1.6 )
+    {
+        double next_ball_dist = my_next.dist( keep_point );
+        double threshold = my_kickable_area - 0.4;
+        return 1.0 - 0.5 * std::max( 0.0, ( next_ball_dist - threshold ) / 0.4 );
+    }
+
+    return 1.0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+Body_HoldBall2008::evaluate_keep_point( const Vector2D & keep_point,
+                                        const Vector2D & my_next,
+                                        const Vector2D & ball_pos,
+                                        const double my_kickable_area,
+                                        const OpponentReachCont & opponents )
+{
+    double score = DEFAULT_SCORE;
+
+    for ( int i = 0; i < opponents.size_; ++i )
+    {
+        score = add_opponent_penalty( keep_point, opponents.opponents_[i], score );
+    }
+
+    // all penalties are negative and the rate is always positive.
+    score *= keep_distance_rate( keep_point, my_next, ball_pos, my_kickable_area );
+
+    return score;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+Body_HoldBall2008::select_best_keep_point( const Vector2D & my_next,
+                                           const Vector2D & ball_pos,
+                                           const double my_kickable_area,
+                                           const OpponentReachCont & opponents,
+                                           KeepPointCont & keep_points )
+{
+    const int size = keep_points.size_;
+
+    std::array< double, MAX_KEEP_POINTS > rates;
+    std::array< double, MAX_KEEP_POINTS > upper_bounds;
+    std::array< int, MAX_KEEP_POINTS > order;
+
+    for ( int i = 0; i < size; ++i )
+    {
+        const KeepPoint & p = keep_points.points_[i];
+        rates[i] = keep_distance_rate( p.pos_, my_next, ball_pos, my_kickable_area );
+        upper_bounds[i] = DEFAULT_SCORE * rates[i] + p.kick_rate_ * 1000.0;
+        order[i] = i;
+    }
+
+    // best-first. ties are evaluated in the creation order.
+    std::sort( order.begin(), order.begin() + size,
+               [&]( const int lhs, const int rhs )
+                 {
+                     return ( upper_bounds[lhs] > upper_bounds[rhs]
+                              || ( upper_bounds[lhs] == upper_bounds[rhs]
+                                   && lhs < rhs ) );
+                 } );
+
+    int best_index = -1;
+    double best_score = 0.0;
+
+    // the first element in the creation order wins the tie.
+    const auto beats = [&]( const double value, const int index )
+        {
+            return ( best_index < 0
+                     || value > best_score
+                     || ( value == best_score && index < best_index ) );
+        };
+
+    for ( int k = 0; k < size; ++k )
+    {
+        const int i = order[k];
+        KeepPoint & p = keep_points.points_[i];
+
+        if ( best_index >= 0
+             && upper_bounds[i] < best_score )
+        {
+            // all remaining candidates have the lower upper bound.
+            break;
+        }
+
+        double score = DEFAULT_SCORE;
+        bool pruned = false;
+
+        for ( int o = 0; o < opponents.size_; ++o )
+        {
+            score = add_opponent_penalty( p.pos_, opponents.opponents_[o], score );
+
+            // penalties only decrease the score
+            if ( ! beats( score * rates[i] + p.kick_rate_ * 1000.0, i ) )
             {
-#ifdef DEBUG_EVAL
-                dlog.addText( Logger::HOLD,
-                              "____ next tackle %d opponent_body=%.1f dash_dir=%.0f max_accel=%.3f",
-                              o->unum(), opp_body.degree(), dir, max_accel );
-#endif
-                //next_tackle_penalty = -10.0;
-                next_tackle_penalty -= 10.0;
+                pruned = true;
+                break;
             }
         }
 
-        score += next_kick_penalty;
-        score += next_tackle_penalty;
-#ifdef DEBUG_EVAL
-        dlog.addText( Logger::HOLD,
-                      "____ %d kick_penalty=%.1f tackle_penalty=%.1f score=%.3f",
-                      o->unum(), next_kick_penalty, next_tackle_penalty, score );
-#endif
+        if ( pruned )
+        {
+            // the partial score is not stored.
+            continue;
+        }
+
+        p.score_ = score * rates[i];
+        p.score_ += p.kick_rate_ * 1000.0;
 
+        if ( beats( p.score_, i ) )
+        {
+            best_index = i;
+            best_score = p.score_;
+        }
     }
 
-#if 1
-    double ball_move_dist = ( keep_point - wm.ball().pos() ).r();
-    if ( ball_move_dist > wm.self().playerType().kickableArea() * 1.6 )
+#ifdef DEBUG_PRINT_RESULTS
+    for ( int i = 0; i < size; ++i )
     {
-        double next_ball_dist = my_next.dist( keep_point );
-        double threshold = wm.self().playerType().kickableArea() - 0.4;
-        double rate = 1.0 - 0.5 * std::max( 0.0, ( next_ball_dist - threshold ) / 0.4 );
-        score *= rate;
-
-#ifdef DEBUG_EVAL
+        const KeepPoint & p = keep_points.points_[i];
         dlog.addText( Logger::HOLD,
-                      "__ applied keep distance threshold. ball_dist=%.3f thr=%.3f rate=%f",
-                      next_ball_dist, threshold, rate );
-#endif
+                      "%d: (%.2f %.2f) score=%f%s",
+                      i, p.pos_.x, p.pos_.y, p.score_,
+                      i == best_index ? " (best)" : "" );
     }
 #endif
 
-    return score;
+    return best_index;
 }
 
 /*-------------------------------------------------------------------*/
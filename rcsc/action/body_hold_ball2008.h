@@ -34,12 +34,14 @@
 
 #include <rcsc/player/soccer_action.h>
 #include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/angle_deg.h>
 
-#include <vector>
+#include <array>
 
 namespace rcsc {
 
 class PlayerObject;
+class PlayerType;
 class WorldModel;
 
 /*!
@@ -53,6 +55,13 @@ public:
     //! default score value
     static const double DEFAULT_SCORE;
 
+    //! the maximum number of candidate keep points
+    static constexpr int MAX_KEEP_POINTS = 60;
+    //! the maximum number of opponents considered in the evaluation
+    static constexpr int MAX_OPPONENTS = 22;
+    //! the maximum number of dash directions checked for each opponent
+    static constexpr int MAX_DASH_DIVS = 24;
+
     /*!
       \struct KeepPoint
       \brief keep point info
@@ -96,8 +105,107 @@ public:
           }
     };
 
+    /*!
+      \struct KeepPointCont
+      \brief fixed size keep point container
+     */
+    struct KeepPointCont {
+        std::array< KeepPoint, MAX_KEEP_POINTS > points_; //!< candidate points
+        int size_; //!< the number of valid candidates
+
+        KeepPointCont()
+            : size_( 0 )
+          { }
+    };
+
+    /*!
+      \struct OpponentReach
+      \brief opponent information precomputed before the keep point evaluation
+     */
+    struct OpponentReach {
+        Vector2D next_pos_; //!< estimated opponent position at the next cycle
+        double kickable_area_; //!< kickable area of the opponent
+        bool goalie_in_penalty_area_; //!< true if the opponent goalie can catch the ball
+        double rotate_cos_; //!< cosine of the opponent body angle (negative rotation)
+        double rotate_sin_; //!< sine of the opponent body angle (negative rotation)
+        double reach_radius2_; //!< squared radius that any penalty other than the body line can be applied
+        int dash_divs_; //!< the number of dash directions
+        std::array< Vector2D, MAX_DASH_DIVS > max_move_; //!< max dash move for each direction
+
+        /*!
+          \brief create the reach info of the opponent.
+          \param next_pos estimated opponent position at the next cycle
+          \param body estimated body angle
+          \param player_type player type of the opponent
+          \param goalie_in_penalty_area true if the opponent goalie in their penalty area
+         */
+        void assign( const Vector2D & next_pos,
+                     const AngleDeg & body,
+                     const PlayerType & player_type,
+                     const bool goalie_in_penalty_area );
+    };
+
+    /*!
+      \struct OpponentReachCont
+      \brief fixed size opponent container
+     */
+    struct OpponentReachCont {
+        std::array< OpponentReach, MAX_OPPONENTS > opponents_; //!< opponent info
+        int size_; //!< the number of valid opponents
+
+        OpponentReachCont()
+            : size_( 0 )
+          { }
+    };
+
+    /*!
+      \brief evaluate the keep point
+      \param keep_point evaluated point
+      \param my_next estimated self position at the next cycle
+      \param ball_pos current ball position
+      \param my_kickable_area kickable area of the kicker
+      \param opponents precomputed opponent info
+      \return evaluated score
+     */
+    static
+    double evaluate_keep_point( const Vector2D & keep_point,
+                                const Vector2D & my_next,
+                                const Vector2D & ball_pos,
+                                const double my_kickable_area,
+                                const OpponentReachCont & opponents );
+
+    /*!
+      \brief select the best keep point. candidates are evaluated in best-first
+      order and the evaluation is stopped when the candidate can not beat the
+      current best candidate.  The result is same as evaluating all candidates
+      and selecting the first element that has the max score.
+      \param my_next estimated self position at the next cycle
+      \param ball_pos current ball position
+      \param my_kickable_area kickable area of the kicker
+      \param opponents precomputed opponent info
+      \param keep_points candidate points. scores are updated only for the fully
+      evaluated points. the pruned and the skipped points keep their previous scores.
+      \return index of the best candidate, or -1 if no candidate
+     */
+    static
+    int select_best_keep_point( const Vector2D & my_next,
+                                const Vector2D & ball_pos,
+                                const double my_kickable_area,
+                                const OpponentReachCont & opponents,
+                                KeepPointCont & keep_points );
 
 private:
+
+    static
+    double keep_distance_rate( const Vector2D & keep_point,
+                               const Vector2D & my_next,
+                               const Vector2D & ball_pos,
+                               const double my_kickable_area );
+    static
+    double add_opponent_penalty( const Vector2D & keep_point,
+                                 const OpponentReach & opponent,
+                                 double score );
+
     //! if true, agent will try to face to the target point
     const bool M_do_turn;
     //! face target point
@@ -149,15 +257,14 @@ private:
       \param keep_points reference to the variable container
      */
     void createKeepPoints( const WorldModel & wm,
-                           std::vector< KeepPoint > & keep_points );
+                           KeepPointCont & keep_points );
 
     /*!
-      \brief evaluate candidate keep points
+      \brief get the opponent info for the current cycle
       \param wm const reference to the WorldModel instance
-      \param keep_points reference to the variable container
+      \return const reference to the cached opponent info
      */
-    void evaluateKeepPoints( const WorldModel & wm,
-                             std::vector< KeepPoint > & keep_points );
+    const OpponentReachCont & getOpponentReaches( const WorldModel & wm );
 
     /*!
       \brief evaluate the keep point
@@ -44,9 +44,11 @@
 #include "body_hold_ball2008.h"
 
 #include <rcsc/player/player_agent.h>
+#include <rcsc/player/compute_budget.h>
 #include <rcsc/player/debug_client.h>
 #include <rcsc/player/audio_sensor.h>
 #include <rcsc/player/say_message_builder.h>
+#include <rcsc/player/reach_grid.h>
 
 #include <rcsc/common/logger.h>
 #include <rcsc/common/server_param.h>
@@ -55,10 +57,209 @@
 #include <rcsc/soccer_math.h>
 #include <rcsc/math_util.h>
 
+#include <algorithm>
+
 //#define DEBUG
 
 namespace rcsc {
 
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the minimum opponent arrival step without the grid.
+  the estimation is same as ReachGrid::add_player(), but not limited by
+  ReachGrid::MAX_STEP.
+  \param world const reference to the world model
+  \param pos global coordinate
+  \return minimum arrival step
+*/
+int
+get_opponent_reach_step( const WorldModel & world,
+                         const Vector2D & pos )
+{
+    int min_step = 1000;
+
+    for ( const PlayerObject * o : world.opponentsFromSelf() )
+    {
+        if ( o->posCount() > 10 ) continue;
+
+        const PlayerType * ptype = o->playerTypePtr();
+        if ( ! ptype ) continue;
+
+        const int bonus_step = std::min( ReachGrid::MAX_BONUS_STEP, o->posCount() );
+        const Vector2D rel = pos - o->inertiaPoint( 1 );
+        const double dist = rel.r();
+        const double angle_diff = ( o->bodyCount() <= 3 && dist > 1.0e-3
+                                    ? ( rel.th() - o->body() ).abs()
+                                    : 0.0 );
+
+        const int step = std::max( 0, ptype->reachStep( dist, angle_diff ) - bonus_step );
+        if ( step < min_step )
+        {
+            min_step = step;
+        }
+    }
+
+    return min_step;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if any opponent can reach the ball route before the ball.
+  the reach grid is used within its horizon, and each opponent is
+  checked directly after that.
+  \param world const reference to the world model
+  \param target_dist distance from the ball to the target point
+  \param first_vel ball first velocity
+  \return true if no opponent can reach the ball route
+*/
+bool
+is_safe_pass_route( const WorldModel & world,
+                    const double target_dist,
+                    const Vector2D & first_vel )
+{
+    const ReachGrid & grid = world.reachGrid();
+    const double ball_decay = ServerParam::i().ballDecay();
+
+    Vector2D ball_pos = world.ball().pos();
+    Vector2D ball_vel = first_vel;
+    double ball_speed = first_vel.r();
+    double ball_move = 0.0;
+
+    for ( int step = 1; ball_speed > 0.01; ++step )
+    {
+        ball_pos += ball_vel;
+        ball_move += ball_speed;
+        ball_vel *= ball_decay;
+        ball_speed *= ball_decay;
+
+        const double opp_step = ( step < ReachGrid::MAX_STEP
+                                  ? grid.opponentStep( ball_pos )
+                                  : get_opponent_reach_step( world, ball_pos ) );
+        if ( opp_step <= step )
+        {
+#ifdef DEBUG
+            dlog.addText( Logger::PASS,
+                          "______ opponent can reach the ball route (%.1f %.1f)."
+                          " ball_step=%d opp_step=%.1f",
+                          ball_pos.x, ball_pos.y,
+                          step, opp_step );
+#endif
+            return false;
+        }
+
+        if ( ball_move > target_dist )
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief evaluate the pass receive point.
+  \param world const reference to the world model
+  \param receiver pointer to the receiver player
+  \param receive_point pass receive point
+  \return evaluated value without the kick bonus
+*/
+double
+evaluate_receive_point( const WorldModel & world,
+                        const PlayerObject * receiver,
+                        const Vector2D & receive_point )
+{
+    const AngleDeg min_angle = -45.0;
+    const AngleDeg max_angle = 45.0;
+
+    //-----------------------------------------------------------
+    double opp_dist_rate = 1.0;
+    {
+        double opp_dist = 100.0;
+        world.getOpponentNearestTo( receive_point, 20, &opp_dist );
+        opp_dist_rate = std::pow( 0.99, std::max( 0.0, 30.0 - opp_dist ) );
+    }
+    //-----------------------------------------------------------
+    double x_diff_rate = 1.0;
+    {
+        double x_diff = receive_point.x - world.self().pos().x;
+        x_diff_rate = std::pow( 0.98, std::max( 0.0, 30.0 - x_diff ) );
+    }
+    //-----------------------------------------------------------
+    double receiver_move_rate = 1.0;
+    //= std::pow( 0.995,
+    //receiver->pos().dist( receive_point ) );
+    //-----------------------------------------------------------
+    double pos_conf_rate = std::pow( 0.98, receiver->posCount() );
+    //-----------------------------------------------------------
+    double dir_conf_rate = 1.0;
+    {
+        AngleDeg pass_angle = ( receive_point - world.self().pos() ).th();
+        int max_count = 0;
+        world.dirRangeCount( pass_angle, 20.0, &max_count, NULL, NULL );
+
+        dir_conf_rate = std::pow( 0.95, max_count );
+    }
+    //-----------------------------------------------------------
+    double offense_rate
+        = std::pow( 0.98,
+                    std::max( 5.0, std::fabs( receive_point.y
+                                              - world.ball().pos().y ) ) );
+    //-----------------------------------------------------------
+    const Sector2D sector( receive_point,
+                           0.0, 10.0,
+                           min_angle, max_angle );
+
+    // opponent check with goalie
+    double front_space_rate = 1.0;
+    if ( world.existOpponentIn( sector, 10, true ) )
+    {
+        front_space_rate = 0.95;
+    }
+
+    //-----------------------------------------------------------
+    double score = 1000.0;
+    score *= opp_dist_rate;
+    score *= x_diff_rate;
+    score *= receiver_move_rate;
+    score *= pos_conf_rate;
+    score *= dir_conf_rate;
+    score *= offense_rate;
+    score *= front_space_rate;
+
+#ifdef DEBUG
+    dlog.addText( Logger::PASS,
+                  "____ opp_dist=%.2f x_diff=%.2f pos_conf=%.2f"
+                  " dir_conf=%.2f space=%.1f",
+                  opp_dist_rate, x_diff_rate, pos_conf_rate,
+                  dir_conf_rate, front_space_rate );
+#endif
+
+    return score;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief route creation task used by the limited search.
+*/
+struct RouteTask {
+    Body_Pass::PassType type_; //!< pass type id
+    const PlayerObject * receiver_; //!< pointer to the receiver player
+    double value_; //!< expected value of the routes
+
+    RouteTask( const Body_Pass::PassType type,
+               const PlayerObject * receiver,
+               const double value )
+        : type_( type )
+        , receiver_( receiver )
+        , value_( value )
+      { }
+};
+
+}
+
 std::vector< Body_Pass::PassRoute > Body_Pass::S_cached_pass_route;
 
 /*-------------------------------------------------------------------*/
@@ -87,7 +288,8 @@ Body_Pass::execute( PlayerAgent * agent )
     double first_speed = 0.0;
     int receiver = 0;
 
-    if ( ! get_best_pass( agent->world(), &target_point, &first_speed, &receiver ) )
+    if ( ! get_best_pass( agent->world(), &target_point, &first_speed, &receiver,
+                          &agent->computeBudget() ) )
     {
         return false;
     }
@@ -154,7 +356,8 @@ bool
 Body_Pass::get_best_pass( const WorldModel & world,
                           Vector2D * target_point,
                           double * first_speed,
-                          int * receiver )
+                          int * receiver,
+                          ComputeBudget * budget )
 {
     static GameTime S_last_calc_time( 0, 0 );
     static bool S_last_calc_valid = false;
@@ -187,7 +390,7 @@ Body_Pass::get_best_pass( const WorldModel & world,
     S_last_calc_valid = false;
 
     // create route
-    create_routes( world );
+    create_routes( world, budget );
 
     if ( ! S_cached_pass_route.empty() )
     {
@@ -242,12 +445,14 @@ Body_Pass::get_best_pass( const WorldModel & world,
   static method
 */
 void
-Body_Pass::create_routes( const WorldModel & world )
+Body_Pass::create_routes( const WorldModel & world,
+                          ComputeBudget * budget )
 {
     // reset old info
     S_cached_pass_route.clear();
 
-    // loop candidate teammates
+    // select candidate teammates
+    std::vector< const PlayerObject * > receivers;
     for ( const PlayerObject * t : world.teammatesFromSelf() )
     {
         if ( t->goalie() && t->pos().x < -22.0 )
@@ -271,14 +476,92 @@ Body_Pass::create_routes( const WorldModel & world )
             continue;
         }
 
-        // create & verify each route
-        create_direct_pass( world, t );
-        create_lead_pass( world, t );
-        if ( world.self().pos().x > world.offsideLineX() - 20.0 )
+        receivers.push_back( t );
+    }
+
+    const bool through = ( world.self().pos().x > world.offsideLineX() - 20.0 );
+    bool truncated = false;
+
+    if ( ! budget
+         || ! budget->isLimited() )
+    {
+        //
+        // create & verify each route.
+        //
+        for ( const PlayerObject * t : receivers )
         {
-            create_through_pass( world, t );
+            create_direct_pass( world, t );
+            create_lead_pass( world, t );
+            if ( through )
+            {
+                create_through_pass( world, t );
+            }
         }
     }
+    else
+    {
+        //
+        // the search may be stopped by the deadline.
+        // the routes are created in the order of the expected value,
+        // that is the evaluation of the receiver position.
+        // through passes are evaluated at the nearest dash target.
+        //
+        std::vector< RouteTask > tasks;
+        tasks.reserve( receivers.size() * 3 );
+
+        for ( const PlayerObject * t : receivers )
+        {
+            const double value = evaluate_receive_point( world, t, t->pos() );
+            tasks.emplace_back( DIRECT, t, value );
+            tasks.emplace_back( LEAD, t, value );
+            if ( through )
+            {
+                tasks.emplace_back( THROUGH, t,
+                                    evaluate_receive_point( world, t, t->pos() + Vector2D( 5.0, 0.0 ) ) );
+            }
+        }
+
+        std::stable_sort( tasks.begin(), tasks.end(),
+                          []( const RouteTask & lhs, const RouteTask & rhs )
+                            {
+                                return lhs.value_ > rhs.value_;
+                            } );
+
+        for ( const RouteTask & task : tasks )
+        {
+            if ( budget->shouldStop() )
+            {
+                truncated = true;
+                break;
+            }
+
+            switch ( task.type_ ) {
+            case DIRECT:
+                create_direct_pass( world, task.receiver_ );
+                break;
+            case LEAD:
+                create_lead_pass( world, task.receiver_ );
+                break;
+            case THROUGH:
+                create_through_pass( world, task.receiver_ );
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    if ( budget )
+    {
+        budget->addSearch( truncated );
+    }
+
+    if ( truncated )
+    {
+        dlog.addText( Logger::ACTION,
+                      __FILE__": create_routes() truncated by the budget. size=%zd",
+                      S_cached_pass_route.size() );
+    }
 
     ////////////////////////////////////////////////////////////////
     // evaluation
@@ -1020,118 +1303,22 @@ Body_Pass::create_through_pass(const WorldModel & world,
 bool
 Body_Pass::verify_direct_pass( const WorldModel & world,
                                const PlayerObject * /*receiver*/,
-                               const Vector2D & target_point,
+                               const Vector2D & /*target_point*/,
                                const double & target_dist,
                                const AngleDeg & target_angle,
                                const double & first_speed )
 {
-    static const double player_dash_speed = 1.0;
-
     const Vector2D first_vel = Vector2D::polar2vector( first_speed, target_angle );
-    const AngleDeg minus_target_angle = -target_angle;
-    const double next_speed = first_speed * ServerParam::i().ballDecay();
 
 #ifdef DEBUG
     dlog.addText( Logger::PASS,
-                  "____ verify direct pass to(%.1f %.1f). first_speed=%.3f. angle=%.1f",
-                  target_point.x, target_point.y,
-                  first_speed, target_angle.degree() );
+                  "____ verify direct pass. dist=%.1f first_speed=%.3f. angle=%.1f",
+                  target_dist, first_speed, target_angle.degree() );
 #endif
 
-    for ( const PlayerObject * o : world.opponentsFromSelf() )
+    if ( ! is_safe_pass_route( world, target_dist, first_vel ) )
     {
-        if ( o->posCount() > 10 ) continue;
-        if ( o->isGhost() && o->posCount() >= 4 ) continue;
-
-        const double virtual_dash
-            = player_dash_speed * 0.8 * std::min( 5, o->posCount() );
-
-//         if ( o->pos().dist( target_point ) - virtual_dash > target_dist + 2.0 )
-//         {
-// #ifdef DEBUG
-//             dlog.addText( Logger::PASS,
-//                           "______ opp%d(%.1f %.1f) is too far. not calculated.",
-//                           o->unum(),
-//                           o->pos().x, o->pos().y );
-// #endif
-//             continue;
-//         }
-
-
-        if ( ( o->angleFromSelf() - target_angle ).abs() > 100.0 )
-        {
-// #ifdef DEBUG
-//             dlog.addText( Logger::PASS,
-//                           "______ opp%d(%.1f %.1f) is back of target dir. not calculated.",
-//                           o->unum(),
-//                           o->pos().x, o->pos().y );
-//#endif
-            continue;
-        }
-
-        if ( o->pos().dist2( target_point ) < 3.0 * 3.0 )
-        {
-#ifdef DEBUG
-            dlog.addText( Logger::PASS,
-                          "______ opp%d(%.1f %.1f) is already on target point(%.1f %.1f).",
-                          o->unum(),
-                          o->pos().x, o->pos().y,
-                          target_point.x, target_point.y );
-#endif
-            return false;
-        }
-
-        Vector2D ball_to_opp = o->pos();
-        ball_to_opp -= world.ball().pos();
-        ball_to_opp -= first_vel;
-        ball_to_opp.rotate( minus_target_angle );
-
-        if ( 0.0 < ball_to_opp.x && ball_to_opp.x < target_dist )
-        {
-            double opp2line_dist = ball_to_opp.absY();
-            opp2line_dist -= virtual_dash;
-            opp2line_dist -= ServerParam::i().defaultKickableArea();
-            opp2line_dist -= 0.1;
-
-            if ( opp2line_dist < 0.0 )
-            {
-#ifdef DEBUG
-                dlog.addText( Logger::PASS,
-                              "______ opp%d(%.1f %.1f) can reach pass line. rejected. vdash=%.1f",
-                              o->unum(),
-                              o->pos().x, o->pos().y,
-                              virtual_dash );
-#endif
-                return false;
-            }
-
-            const double ball_steps_to_project
-                = calc_length_geom_series( next_speed,
-                                           ball_to_opp.x,
-                                           ServerParam::i().ballDecay() );
-            //= move_step_for_first(ball_to_opp.x,
-            //next_speed,
-            //ServerParam::i().ballDecay());
-            if ( ball_steps_to_project < 0.0
-                 || opp2line_dist / player_dash_speed < ball_steps_to_project )
-            {
-#ifdef DEBUG
-                dlog.addText( Logger::PASS,
-                              "______ opp%d(%.1f %.1f) can reach pass line."
-                              " ball reach step to project= %.1f",
-                              o->unum(),
-                              o->pos().x, o->pos().y,
-                              ball_steps_to_project );
-#endif
-                return false;
-            }
-#ifdef DEBUG
-            dlog.addText( Logger::PASS,
-                          "______ opp%d(%.1f %.1f) cannot intercept.",
-                          o->unum(),
-                          o->pos().x, o->pos().y );
-#endif
-        }
+        return false;
     }
 
 #ifdef DEBUG
@@ -1271,67 +1458,11 @@ Body_Pass::verify_through_pass( const WorldModel & world,
 void
 Body_Pass::evaluate_routes( const WorldModel & world )
 {
-    const AngleDeg min_angle = -45.0;
-    const AngleDeg max_angle = 45.0;
-
     for ( std::vector< PassRoute >::iterator it = S_cached_pass_route.begin(), end = S_cached_pass_route.end();
           it != end;
           ++it )
     {
-        //-----------------------------------------------------------
-        double opp_dist_rate = 1.0;
-        {
-            double opp_dist = 100.0;
-            world.getOpponentNearestTo( it->receive_point_, 20, &opp_dist );
-            opp_dist_rate = std::pow( 0.99, std::max( 0.0, 30.0 - opp_dist ) );
-        }
-        //-----------------------------------------------------------
-        double x_diff_rate = 1.0;
-        {
-            double x_diff = it->receive_point_.x - world.self().pos().x;
-            x_diff_rate = std::pow( 0.98, std::max( 0.0, 30.0 - x_diff ) );
-        }
-        //-----------------------------------------------------------
-        double receiver_move_rate = 1.0;
-        //= std::pow( 0.995,
-        //it->receiver_->pos().dist( it->receive_point_ ) );
-        //-----------------------------------------------------------
-        double pos_conf_rate = std::pow( 0.98, it->receiver_->posCount() );
-        //-----------------------------------------------------------
-        double dir_conf_rate = 1.0;
-        {
-            AngleDeg pass_angle = ( it->receive_point_ - world.self().pos() ).th();
-            int max_count = 0;
-            world.dirRangeCount( pass_angle, 20.0, &max_count, NULL, NULL );
-
-            dir_conf_rate = std::pow( 0.95, max_count );
-        }
-        //-----------------------------------------------------------
-        double offense_rate
-            = std::pow( 0.98,
-                        std::max( 5.0, std::fabs( it->receive_point_.y
-                                                  - world.ball().pos().y ) ) );
-        //-----------------------------------------------------------
-        const Sector2D sector( it->receive_point_,
-                               0.0, 10.0,
-                               min_angle, max_angle );
-
-        // opponent check with goalie
-        double front_space_rate = 1.0;
-        if ( world.existOpponentIn( sector, 10, true ) )
-        {
-            front_space_rate = 0.95;
-        }
-
-        //-----------------------------------------------------------
-        it->score_ = 1000.0;
-        it->score_ *= opp_dist_rate;
-        it->score_ *= x_diff_rate;
-        it->score_ *= receiver_move_rate;
-        it->score_ *= pos_conf_rate;
-        it->score_ *= dir_conf_rate;
-        it->score_ *= offense_rate;
-        it->score_ *= front_space_rate;
+        it->score_ = evaluate_receive_point( world, it->receiver_, it->receive_point_ );
 
         if ( it->one_step_kick_ )
         {
@@ -1349,10 +1480,7 @@ Body_Pass::evaluate_routes( const WorldModel & world )
                       it->type_,
                       it->first_speed_ );
         dlog.addText( Logger::PASS,
-                      "____ opp_dist=%.2f x_diff=%.2f pos_conf=%.2f"
-                      " dir_conf=%.2f space=%.1f %s",
-                      opp_dist_rate, x_diff_rate, pos_conf_rate,
-                      dir_conf_rate, front_space_rate,
+                      "____ %s",
                       ( it->one_step_kick_ ? "one_step" : "" ) );
 #endif
     }
@@ -40,6 +40,7 @@
 
 namespace rcsc {
 
+class ComputeBudget;
 class WorldModel;
 class PlayerObject;
 
@@ -121,17 +122,20 @@ public:
       \param target_point receive target point is stored to this
       \param first_speed ball first speed is stored to this
       \param receiver receiver number
+      \param budget compute budget. if expired, the best route found so far is returned.
       \return true if pass route is found.
     */
     static
     bool get_best_pass( const WorldModel & world,
                         Vector2D * target_point,
                         double * first_speed,
-                        int * receiver );
+                        int * receiver,
+                        ComputeBudget * budget = nullptr );
 
 private:
     static
-    void create_routes( const WorldModel & world );
+    void create_routes( const WorldModel & world,
+                        ComputeBudget * budget );
 
     static
     void create_direct_pass( const WorldModel & world,
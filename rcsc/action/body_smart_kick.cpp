@@ -88,7 +88,8 @@ Body_SmartKick::execute( PlayerAgent * agent )
                                          first_speed,
                                          first_speed_thr,
                                          max_step,
-                                         M_sequence )
+                                         M_sequence,
+                                         &agent->computeBudget() )
          || M_sequence.speed_ >= first_speed_thr )
     {
         agent->debugClient().addMessage( "SmartKick%d", (int)M_sequence.pos_list_.size() );
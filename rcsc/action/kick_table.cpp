@@ -39,6 +39,7 @@
 #include <rcsc/geom/ray_2d.h>
 #include <rcsc/geom/circle_2d.h>
 #include <rcsc/geom/rect_2d.h>
+#include <rcsc/player/compute_budget.h>
 #include <rcsc/common/logger.h>
 #include <rcsc/common/server_param.h>
 #include <rcsc/common/player_param.h>
@@ -308,7 +309,9 @@ KickTable::KickTable()
     : M_player_size( 0.0 ),
       M_kickable_margin( 0.0 ),
       M_ball_size( 0.0 ),
-      M_use_risky_node( false )
+      M_use_risky_node( false ),
+      M_budget( nullptr ),
+      M_truncated( false )
 {
     for ( int i = 0; i < MAX_DEPTH; ++ i )
     {
@@ -1337,6 +1340,23 @@ KickTable::checkInterfereAfterRelease( const WorldModel & world,
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+KickTable::budgetExpired()
+{
+    if ( M_budget
+         && M_budget->shouldStop() )
+    {
+        M_truncated = true;
+        return true;
+    }
+
+    return false;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -1449,6 +1469,12 @@ KickTable::simulateTwoStep( const WorldModel & world,
 
     for ( int i = 0; i < NUM_STATE; ++i, ++count )
     {
+        if ( ( count & 0x0f ) == 0
+             && budgetExpired() )
+        {
+            break;
+        }
+
         const State & state = M_state_cache[0][i];
 
         if ( state.flag_ & OUT_OF_PITCH )
@@ -1665,6 +1691,14 @@ KickTable::simulateThreeStep( const WorldModel & world,
           it != end && count < MAX_TABLE_SIZE && success_count <= 10;
           ++it, ++count )
     {
+        // the table is sorted by the heuristic value.
+        // the best paths found so far are kept if the budget is expired.
+        if ( ( count & 0x0f ) == 0
+             && budgetExpired() )
+        {
+            break;
+        }
+
         const State & state_1st = M_state_cache[0][it->origin_];
         const State & state_2nd = M_state_cache[1][it->dest_];
 
@@ -2098,7 +2132,8 @@ KickTable::simulate( const WorldModel & world,
                      const double first_speed,
                      const double allowable_speed,
                      const int max_step,
-                     Sequence & sequence )
+                     Sequence & sequence,
+                     ComputeBudget * budget )
 {
     if ( M_state_list.empty() )
     {
@@ -2127,6 +2162,8 @@ KickTable::simulate( const WorldModel & world,
                   target_speed );
 
     M_candidates.clear();
+    M_budget = budget;
+    M_truncated = false;
 
     updateState( world );
 
@@ -2152,7 +2189,13 @@ KickTable::simulate( const WorldModel & world,
 
     M_use_risky_node = false;
 
+    //
+    // one step kick is always simulated.
+    // multi step kicks are searched only while the budget is left.
+    //
+
     if ( max_step >= 2
+         && ! budgetExpired()
          && simulateTwoStep( world,
                              target_point,
                              target_speed ) )
@@ -2162,6 +2205,7 @@ KickTable::simulate( const WorldModel & world,
     }
 
     if ( max_step >= 3
+         && ! budgetExpired()
          && simulateThreeStep( world,
                                target_point,
                                target_speed ) )
@@ -2173,7 +2217,8 @@ KickTable::simulate( const WorldModel & world,
     // dlog.addText( Logger::KICK,
     //               "(KickTable::simulate) candidate size = %zd", M_candidates.size() );
 
-    if ( ! check_candidates_max_speed( M_candidates, speed_thr ) )
+    if ( ! budgetExpired()
+         && ! check_candidates_max_speed( M_candidates, speed_thr ) )
     {
         M_use_risky_node = true;
 
@@ -2190,6 +2235,7 @@ KickTable::simulate( const WorldModel & world,
         }
 
         if ( max_step >= 3
+             && ! budgetExpired()
              && simulateThreeStep( world,
                                    target_point,
                                    target_speed ) )
@@ -2202,6 +2248,19 @@ KickTable::simulate( const WorldModel & world,
     // TODO:
     // 4 steps simulation
 
+    if ( M_budget )
+    {
+        M_budget->addSearch( M_truncated );
+        M_budget = nullptr;
+    }
+
+    if ( M_truncated )
+    {
+        dlog.addText( Logger::KICK,
+                      "(KickTable::simulate) truncated by the budget. candidate size = %zd",
+                      M_candidates.size() );
+    }
+
     if ( M_candidates.empty() )
     {
         dlog.addText( Logger::KICK,
@@ -40,6 +40,7 @@
 
 namespace rcsc {
 
+class ComputeBudget;
 class GameTime;
 class PlayerType;
 class WorldModel;
@@ -216,6 +217,11 @@ private:
 
     bool M_use_risky_node;
 
+    //! compute budget of the current simulation. may be null.
+    ComputeBudget * M_budget;
+    //! true if the current simulation is stopped by the budget
+    bool M_truncated;
+
     /*!
       \brief private constructor for singleton
      */
@@ -296,6 +302,12 @@ private:
                                      const int cycle,
                                      State & state );
 
+    /*!
+      \brief check if the compute budget has been expired
+      \return true if the simulation should be stopped
+     */
+    bool budgetExpired();
+
     /*!
       \brief simulate one step kick
       \param world const reference to the WorldModel
@@ -386,6 +398,8 @@ public:
       \param allowable_speed required first speed threshold
       \param max_step maximum size of kick sequence
       \param sequence reference to the result variable
+      \param budget compute budget. if expired, multi step kicks are not
+      searched any more and the best sequence found so far is returned.
       \return if successful kick is found, then true, else false is returned but kick sequence is generated anyway.
      */
     bool simulate( const WorldModel & world,
@@ -393,7 +407,8 @@ public:
                    const double first_speed,
                    const double allowable_speed,
                    const int max_step,
-                   Sequence & sequence );
+                   Sequence & sequence,
+                   ComputeBudget * budget = nullptr );
 
     /*!
       \brief get the candidate kick sequences
@@ -44,7 +44,6 @@
 #include <rcsc/geom/rect_2d.h>
 
 #include <algorithm>
-#include <numeric>
 #include <deque>
 
 // #define DEBUG_PRINT
@@ -245,6 +244,7 @@ Neck_ScanField::calcAngleDefault( const PlayerAgent * agent,
         ( rint( shrinked_next_view_width / WorldModel::DIR_STEP ) );
 
     std::deque< int > dir_counts( size_of_view_width );
+    int tmp_count_sum = 0;
 
     // generate first visible cone score list
     {
@@ -254,6 +254,7 @@ Neck_ScanField::calcAngleDefault( const PlayerAgent * agent,
               ++it )
         {
             *it = wm.dirCount( tmp_angle );
+            tmp_count_sum += *it;
             tmp_angle += WorldModel::DIR_STEP;
         }
     }
@@ -272,8 +273,6 @@ Neck_ScanField::calcAngleDefault( const PlayerAgent * agent,
 
     do
     {
-        int tmp_count_sum = std::accumulate( dir_counts.begin(), dir_counts.end(), 0 );
-
         AngleDeg angle = tmp_angle - shrinked_next_view_width * 0.5;
 #ifdef DEBUG_PRINT
         dlog.addText( Logger::ACTION,
@@ -333,10 +332,13 @@ Neck_ScanField::calcAngleDefault( const PlayerAgent * agent,
             }
         }
 
+        // slide the window. the sum is updated by the difference.
+        tmp_count_sum -= dir_counts.front();
         dir_counts.pop_front();
         add_dir += WorldModel::DIR_STEP;
         tmp_angle += WorldModel::DIR_STEP;
         dir_counts.push_back( wm.dirCount( tmp_angle ) );
+        tmp_count_sum += dir_counts.back();
     }
     while ( add_dir <= scan_range );
 
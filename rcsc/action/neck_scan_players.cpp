@@ -49,6 +49,7 @@
 #include <rcsc/game_time.h>
 
 #include <algorithm>
+#include <vector>
 #include <limits>
 #include <cstdio>
 
@@ -59,6 +60,30 @@ namespace rcsc {
 //! invalid angle value
 const double Neck_ScanPlayers::INVALID_ANGLE = -360.0;
 
+namespace {
+
+/*!
+  \struct Target
+  \brief observation target player
+ */
+struct Target {
+    double dir_; //!< player direction relative to the next body angle
+    double score_; //!< observation score
+
+    Target( const double dir,
+            const double score )
+        : dir_( dir ),
+          score_( score )
+      { }
+
+    bool operator<( const Target & rhs ) const
+      {
+          return dir_ < rhs.dir_;
+      }
+};
+
+}
+
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -163,23 +188,93 @@ Neck_ScanPlayers::get_best_angle( const PlayerAgent * agent,
                   neck_step );
 #endif
 
+    //
+    // create the target list sorted by the direction relative to the body angle.
+    // the score of each view cone is computed by the prefix sum over the list.
+    //
+
+    const int our_min = std::min( wm.interceptTable().selfStep(),
+                                  wm.interceptTable().teammateStep() );
+    const int opp_min = wm.interceptTable().opponentStep();
+    const bool our_ball = ( our_min <= opp_min );
+
+    std::vector< Target > targets;
+    targets.reserve( wm.allPlayers().size() );
+
+    for ( const AbstractPlayerObject * p : wm.allPlayers() )
+    {
+        if ( p->isSelf() ) continue;
+        if ( p->ghostCount() >= 5 ) continue;
+
+        const Vector2D pos = p->pos() + p->vel();
+        const AngleDeg rel_angle = ( pos - next_self_pos ).th() - next_self_body;
+
+        targets.emplace_back( rel_angle.degree(),
+                              calculate_score( wm, p, our_ball ) );
+    }
+
+    std::sort( targets.begin(), targets.end() );
+
+    std::vector< double > score_sum( targets.size() + 1, 0.0 );
+    for ( std::size_t i = 0; i < targets.size(); ++i )
+    {
+        score_sum[i + 1] = score_sum[i] + targets[i].score_;
+    }
+
     double best_dir = INVALID_ANGLE;
     double best_score = 0.0; //-std::numeric_limits< double >::max();
 
+    // [first, last) : the targets in the reduced view cone
+    std::size_t first = 0;
+    std::size_t last = 0;
+
     for ( double dir = neck_min; dir < neck_max + 0.5; dir += neck_step )
     {
-        const AngleDeg left_angle = next_self_body + ( dir - ( view_half_width - 0.01 ) );
-        const AngleDeg right_angle = next_self_body + ( dir + ( view_half_width - 0.01 ) );
+        const double left_dir = dir - ( view_half_width - 0.01 );
+        const double right_dir = dir + ( view_half_width - 0.01 );
+
+        // the reduced view cone never crosses the back of the body,
+        // because the neck range is within [-90, 90].
+        while ( first < targets.size()
+                && targets[first].dir_ <= left_dir + 5.0 )
+        {
+            ++first;
+        }
+        last = std::max( first, last );
+        while ( last < targets.size()
+                && targets[last].dir_ < right_dir - 5.0 )
+        {
+            ++last;
+        }
 
 #ifdef DEBUG_PRINT
         dlog.addText( Logger::ACTION,
                       "@ angle=%.0f (dir=%.0f): left=%.1f right=%.1f",
                       ( next_self_body + dir ).degree(),
                       dir,
-                      left_angle.degree(), right_angle.degree() );
+                      ( next_self_body + left_dir ).degree(),
+                      ( next_self_body + right_dir ).degree() );
 #endif
 
-        double score = calculate_score( wm, next_self_pos, left_angle, right_angle );
+        double score = score_sum[last] - score_sum[first];
+
+        // The bigger view buffer, the bigger rate
+        // range: [1.0:2.0]
+        double view_buffer = 90.0;
+        if ( first < last )
+        {
+            view_buffer = std::min( view_buffer, targets[first].dir_ - left_dir );
+            view_buffer = std::min( view_buffer, right_dir - targets[last - 1].dir_ );
+        }
+        score *= 1.0 + view_buffer / 90.0;
+
+#ifdef DEBUG_PRINT
+        dlog.addText( Logger::ACTION,
+                      "__ targets=%d view_buf=%.1f score=%f",
+                      static_cast< int >( last - first ),
+                      view_buffer,
+                      score );
+#endif
 
         if ( score > best_score )
         {
@@ -235,96 +330,41 @@ Neck_ScanPlayers::get_best_angle( const PlayerAgent * agent,
 */
 double
 Neck_ScanPlayers::calculate_score( const WorldModel & wm,
-                                   const Vector2D & next_self_pos,
-                                   const AngleDeg & left_angle,
-                                   const AngleDeg & right_angle )
+                                   const AbstractPlayerObject * p,
+                                   const bool our_ball )
 {
-    double score = 0.0;
-    double view_buffer = 90.0;
-
-    const int our_min = std::min( wm.interceptTable()->selfReachCycle(),
-                                  wm.interceptTable()->teammateReachCycle() );
-    const int opp_min = wm.interceptTable()->opponentReachCycle();
-    const bool our_ball = ( our_min <= opp_min );
-
-    const AngleDeg reduced_left_angle = left_angle + 5.0;
-    const AngleDeg reduced_right_angle = right_angle - 5.0;
-
-    for ( const AbstractPlayerObject * p : wm.allPlayers() )
+    double pos_count = p->seenPosCount();
+    if ( p->isGhost()
+         && p->ghostCount() % 2 == 1 )
     {
-        if ( p->isSelf() ) continue;
-
-        Vector2D pos = p->pos() + p->vel();
-        AngleDeg angle = ( pos - next_self_pos ).th();
-
-        if ( ! angle.isRightOf( reduced_left_angle )
-             || ! angle.isLeftOf( reduced_right_angle ) )
-        {
-            continue;
-        }
-
-        if ( p->ghostCount() >= 5 ) continue;
-
-        double pos_count = p->seenPosCount();
-        if ( p->isGhost()
-             && p->ghostCount() % 2 == 1 )
-        {
-            pos_count = std::min( 2.0, pos_count );
-        }
-        pos_count += 1.0;
-
-        if ( our_ball )
-        {
-            if ( p->side() == wm.ourSide()
-                 && ( p->pos().x > wm.ball().pos().x - 10.0
-                      || p->pos().x > 30.0 ) )
-            {
-                pos_count *= 2.0;
-            }
-        }
-
-        double base_val = std::pow( pos_count, 2 );
-        double rate = std::exp( - std::pow( p->distFromSelf(), 2 )
-                                / ( 2.0 * std::pow( 20.0, 2 ) ) ); // Magic Number
-        score += base_val * rate;
-
-        double buf = std::min( ( angle - left_angle ).abs(),
-                               ( angle - right_angle ).abs() );
-#ifdef DEBUG_PRINT
-        dlog.addText( Logger::ACTION,
-                      "__ %c_%d (%.2f %.2f) count=%d base=%f rate=%f +%f buf=%.1f",
-                      p->side() == LEFT ? 'L' : p->side() == RIGHT ? 'R' : 'N',
-                      p->unum(),
-                      p->pos().x, p->pos().y,
-                      p->posCount(),
-                      base_val, rate, base_val * rate,
-                      buf );
-#endif
+        pos_count = std::min( 2.0, pos_count );
+    }
+    pos_count += 1.0;
 
-        if ( buf < view_buffer )
+    if ( our_ball )
+    {
+        if ( p->side() == wm.ourSide()
+             && ( p->pos().x > wm.ball().pos().x - 10.0
+                  || p->pos().x > 30.0 ) )
         {
-            view_buffer = buf;
+            pos_count *= 2.0;
         }
     }
 
-    // The bigger view buffer, the bigger rate
-    // range: [1.0:2.0]
-    // double rate = 2.0 - std::exp( - std::pow( view_buffer, 2 )
-    //                               / ( 2.0 * std::pow( 180.0, 2 ) ) ); // Magic Number
-    double rate = 1.0 + view_buffer / 90.0;
+    double base_val = std::pow( pos_count, 2 );
+    double rate = std::exp( - std::pow( p->distFromSelf(), 2 )
+                            / ( 2.0 * std::pow( 20.0, 2 ) ) ); // Magic Number
 #ifdef DEBUG_PRINT
     dlog.addText( Logger::ACTION,
-                  "base_score=%.1f view_buf=%.1f rate=%f -> %f",
-                  score,
-                  view_buffer,
-                  rate,
-                  score * rate );
+                  "__ %c_%d (%.2f %.2f) count=%d base=%f rate=%f +%f",
+                  p->side() == LEFT ? 'L' : p->side() == RIGHT ? 'R' : 'N',
+                  p->unum(),
+                  p->pos().x, p->pos().y,
+                  p->posCount(),
+                  base_val, rate, base_val * rate );
 #endif
 
-    score *= rate;
-
-    return score;
-
+    return base_val * rate;
 }
 
 }
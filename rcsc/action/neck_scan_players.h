@@ -36,8 +36,7 @@
 
 namespace rcsc {
 
-class AngleDeg;
-class Vector2D;
+class AbstractPlayerObject;
 class WorldModel;
 
 /*!
@@ -100,17 +99,16 @@ public:
 
 private:
     /*!
-      \brief calculate score of range [left_angle, right_angle]
+      \brief calculate the score of the player observation
       \param wm world model
-      \param next_self_pos next agent position
-      \param left_angle search range: global angle
-      \param right_angle search range: global angle
+      \param p target player
+      \param our_ball true if our team will get the ball first
+      \return score value
      */
     static
     double calculate_score( const WorldModel & wm,
-                            const Vector2D & next_self_pos,
-                            const AngleDeg & left_angle,
-                            const AngleDeg & right_angle );
+                            const AbstractPlayerObject * p,
+                            const bool our_ball );
 
 };
 
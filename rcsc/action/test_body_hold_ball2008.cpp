@@ -0,0 +1,477 @@
+// -*-c++-*-
+
+/*!
+  \file test_body_hold_ball2008.cpp
+  \brief regression test for the keep point search in rcsc::Body_HoldBall2008
+
+  The search is compared with an embedded copy of the evaluator before
+  the pruning, on handmade and random situations.  No recorded game
+  situation is used.  rcsc/action is not part of the build, so this test
+  is not run by "make check".
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "body_hold_ball2008.h"
+
+#include <rcsc/common/server_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/geom/rect_2d.h>
+#include <rcsc/time/timer.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+using namespace rcsc;
+
+class BodyHoldBall2008Test
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( BodyHoldBall2008Test );
+    CPPUNIT_TEST( testHandmade );
+    CPPUNIT_TEST( testRandomSituations );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testHandmade();
+    void testRandomSituations();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( BodyHoldBall2008Test );
+
+namespace {
+
+/*!
+  \brief opponent state given to the keep point search
+ */
+struct OpponentState {
+    Vector2D next_pos_;
+    AngleDeg body_;
+    bool goalie_;
+};
+
+/*!
+  \brief handmade or random hold ball situation
+ */
+struct Situation {
+    Vector2D my_next_;
+    AngleDeg my_body_;
+    Vector2D ball_pos_;
+    std::vector< OpponentState > opponents_;
+};
+
+const PlayerType &
+default_type()
+{
+    static const PlayerType s_type;
+    return s_type;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief the keep point evaluation before the fixed size implementation.
+ */
+double
+reference_evaluate( const Situation & s,
+                    const Vector2D & keep_point )
+{
+    static const Rect2D penalty_area( Vector2D( ServerParam::i().theirPenaltyAreaLineX(),
+                                                - ServerParam::i().penaltyAreaHalfWidth() ),
+                                      Size2D( ServerParam::i().penaltyAreaLength(),
+                                              ServerParam::i().penaltyAreaWidth() ) );
+    const ServerParam & SP = ServerParam::i();
+    const PlayerType * player_type = &default_type();
+
+    double score = Body_HoldBall2008::DEFAULT_SCORE;
+
+    for ( const OpponentState & o : s.opponents_ )
+    {
+        const Vector2D & opp_next = o.next_pos_;
+        const double control_area = ( ( o.goalie_
+                                        && penalty_area.contains( opp_next )
+                                        && penalty_area.contains( keep_point ) )
+                                      ? SP.catchableArea()
+                                      : player_type->kickableArea() );
+        const double opp_dist = opp_next.dist( keep_point );
+
+        if ( opp_dist < control_area * 0.5 )
+        {
+            score -= 200.0;
+        }
+        else if ( opp_dist < control_area + 0.1 )
+        {
+            score -= 150.0;
+        }
+        else if ( opp_dist < SP.tackleDist() - 0.2 )
+        {
+            score -= 25.0;
+        }
+
+        const AngleDeg opp_body = o.body_;
+        const Vector2D player_2_pos = ( keep_point - opp_next ).rotatedVector( -opp_body );
+
+        if ( player_2_pos.absY() < control_area )
+        {
+            score -= ( control_area - player_2_pos.absY() ) * 50.0;
+        }
+
+        {
+            double tackle_dist = ( player_2_pos.x > 0.0
+                                   ? SP.tackleDist()
+                                   : SP.tackleBackDist() );
+            if ( tackle_dist > 1.0e-5 )
+            {
+                double tackle_fail_prob = ( std::pow( player_2_pos.absX() / tackle_dist,
+                                                      SP.foulExponent() )
+                                            + std::pow( player_2_pos.absY() / SP.tackleWidth(),
+                                                        SP.foulExponent() ) );
+                if ( tackle_fail_prob < 1.0 )
+                {
+                    score -= ( 1.0 - tackle_fail_prob ) * 50.0;
+                }
+            }
+        }
+
+        const double dash_angle_step = std::max( 15.0, SP.dashAngleStep() );
+        const int dash_angle_divs
+            = static_cast< int >( std::floor( ( SP.maxDashAngle() - SP.minDashAngle() )
+                                              / dash_angle_step ) );
+
+        double next_kick_penalty = 0.0;
+        double next_tackle_penalty = 0.0;
+        for ( int d = 0; d < dash_angle_divs; ++d )
+        {
+            const double dir = AngleDeg::normalize_angle( SP.minDashAngle() + ( dash_angle_step * d ) );
+            const AngleDeg dash_angle = SP.discretizeDashAngle( dir );
+            const double max_accel = ( SP.maxDashPower()
+                                       * player_type->dashPowerRate()
+                                       * player_type->effortMax()
+                                       * SP.dashDirRate( dir ) );
+            const Vector2D max_move = Vector2D::from_polar( max_accel, dash_angle );
+
+            const Vector2D next_player_2_pos = player_2_pos - max_move;
+
+            if ( next_player_2_pos.r2() < std::pow( control_area + 0.1, 2 ) )
+            {
+                next_kick_penalty -= 20.0;
+            }
+            else if ( next_player_2_pos.absY() < SP.tackleWidth() + 0.1
+                      && next_player_2_pos.x > 0.0
+                      && next_player_2_pos.x < SP.tackleDist() + 0.1 )
+            {
+                next_tackle_penalty -= 10.0;
+            }
+        }
+
+        score += next_kick_penalty;
+        score += next_tackle_penalty;
+    }
+
+    const double my_kickable_area = default_type().kickableArea();
+    double ball_move_dist = ( keep_point - s.ball_pos_ ).r();
+    if ( ball_move_dist > my_kickable_area * 1.6 )
+    {
+        double next_ball_dist = s.my_next_.dist( keep_point );
+        double threshold = my_kickable_area - 0.4;
+        double rate = 1.0 - 0.5 * std::max( 0.0, ( next_ball_dist - threshold ) / 0.4 );
+        score *= rate;
+    }
+
+    return score;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the keep point candidates on 3 circles around the player.
+ */
+void
+create_candidates( const Situation & s,
+                   Body_HoldBall2008::KeepPointCont * result )
+{
+    const ServerParam & SP = ServerParam::i();
+    const PlayerType & ptype = default_type();
+
+    const double base = ptype.playerSize() + SP.ballSize();
+    const double dists[3] = { base + ptype.kickableMargin() * 0.4,
+                              base + ptype.kickableMargin() * 0.6,
+                              base + ptype.kickableMargin() * 0.75 };
+
+    result->size_ = 0;
+    for ( int a = 0; a < 20; ++a )
+    {
+        const AngleDeg angle = -180.0 + 18.0 * a;
+        const double dir_diff = ( angle - s.my_body_ ).abs();
+        for ( const double dist : dists )
+        {
+            const Vector2D pos = s.my_next_ + Vector2D::polar2vector( dist, angle );
+            if ( pos.absX() > SP.pitchHalfLength() - 0.2
+                 || pos.absY() > SP.pitchHalfWidth() - 0.2 )
+            {
+                continue;
+            }
+            result->points_[result->size_++]
+                = Body_HoldBall2008::KeepPoint( pos,
+                                                ptype.kickRate( dist, dir_diff ),
+                                                Body_HoldBall2008::DEFAULT_SCORE );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check the evaluation result against the reference implementation.
+  \return true if the search was actually pruned
+ */
+bool
+check_situation( const Situation & s )
+{
+    Body_HoldBall2008::OpponentReachCont opponents;
+    for ( const OpponentState & o : s.opponents_ )
+    {
+        static const Rect2D penalty_area( Vector2D( ServerParam::i().theirPenaltyAreaLineX(),
+                                                    - ServerParam::i().penaltyAreaHalfWidth() ),
+                                          Size2D( ServerParam::i().penaltyAreaLength(),
+                                                  ServerParam::i().penaltyAreaWidth() ) );
+        opponents.opponents_[opponents.size_++].assign( o.next_pos_,
+                                                        o.body_,
+                                                        default_type(),
+                                                        o.goalie_ && penalty_area.contains( o.next_pos_ ) );
+    }
+
+    Body_HoldBall2008::KeepPointCont candidates;
+    create_candidates( s, &candidates );
+
+    //
+    // reference: evaluate all candidates and select the first max element
+    //
+    std::vector< Body_HoldBall2008::KeepPoint > reference( candidates.points_.begin(),
+                                                           candidates.points_.begin() + candidates.size_ );
+    for ( Body_HoldBall2008::KeepPoint & p : reference )
+    {
+        p.score_ = reference_evaluate( s, p.pos_ );
+        p.score_ += p.kick_rate_ * 1000.0;
+
+        const double value = Body_HoldBall2008::evaluate_keep_point( p.pos_,
+                                                                     s.my_next_,
+                                                                     s.ball_pos_,
+                                                                     default_type().kickableArea(),
+                                                                     opponents );
+        CPPUNIT_ASSERT_EQUAL( reference_evaluate( s, p.pos_ ), value );
+    }
+
+    const std::vector< Body_HoldBall2008::KeepPoint >::const_iterator ref_best
+        = std::max_element( reference.begin(), reference.end(),
+                            []( const Body_HoldBall2008::KeepPoint & lhs,
+                                const Body_HoldBall2008::KeepPoint & rhs )
+                              {
+                                  return lhs.score_ < rhs.score_;
+                              } );
+
+    const int best = Body_HoldBall2008::select_best_keep_point( s.my_next_,
+                                                                 s.ball_pos_,
+                                                                 default_type().kickableArea(),
+                                                                 opponents,
+                                                                 candidates );
+    if ( reference.empty() )
+    {
+        CPPUNIT_ASSERT_EQUAL( -1, best );
+        return false;
+    }
+
+    CPPUNIT_ASSERT_EQUAL( static_cast< int >( ref_best - reference.begin() ), best );
+    CPPUNIT_ASSERT_EQUAL( ref_best->score_, candidates.points_[best].score_ );
+
+    for ( int i = 0; i < candidates.size_; ++i )
+    {
+        if ( candidates.points_[i].score_ != reference[i].score_ )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+BodyHoldBall2008Test::testHandmade()
+{
+    //
+    // no opponent
+    //
+    {
+        Situation s;
+        s.my_next_.assign( 0.0, 0.0 );
+        s.my_body_ = 0.0;
+        s.ball_pos_.assign( 0.7, 0.0 );
+        check_situation( s );
+    }
+
+    //
+    // one opponent in front of the player
+    //
+    {
+        Situation s;
+        s.my_next_.assign( 10.0, 5.0 );
+        s.my_body_ = 0.0;
+        s.ball_pos_.assign( 10.6, 5.1 );
+        s.opponents_.push_back( { Vector2D( 11.5, 5.0 ), AngleDeg( 180.0 ), false } );
+        check_situation( s );
+    }
+
+    //
+    // surrounded by three opponents
+    //
+    {
+        Situation s;
+        s.my_next_.assign( -20.0, -10.0 );
+        s.my_body_ = 90.0;
+        s.ball_pos_.assign( -20.3, -9.5 );
+        s.opponents_.push_back( { Vector2D( -19.0, -10.0 ), AngleDeg( 180.0 ), false } );
+        s.opponents_.push_back( { Vector2D( -21.0, -9.0 ), AngleDeg( -45.0 ), false } );
+        s.opponents_.push_back( { Vector2D( -20.0, -11.3 ), AngleDeg( 90.0 ), false } );
+        check_situation( s );
+    }
+
+    //
+    // in front of the opponent goalie
+    //
+    {
+        Situation s;
+        s.my_next_.assign( 46.0, 3.0 );
+        s.my_body_ = 0.0;
+        s.ball_pos_.assign( 46.5, 3.2 );
+        s.opponents_.push_back( { Vector2D( 47.5, 2.5 ), AngleDeg( 160.0 ), true } );
+        s.opponents_.push_back( { Vector2D( 45.0, 4.5 ), AngleDeg( -30.0 ), false } );
+        check_situation( s );
+    }
+
+    //
+    // near the touch line
+    //
+    {
+        Situation s;
+        s.my_next_.assign( 30.0, 33.6 );
+        s.my_body_ = 0.0;
+        s.ball_pos_.assign( 30.5, 33.5 );
+        s.opponents_.push_back( { Vector2D( 31.2, 32.8 ), AngleDeg( 135.0 ), false } );
+        check_situation( s );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+BodyHoldBall2008Test::testRandomSituations()
+{
+    const int max_loop = 2000;
+
+    std::mt19937 gen( 20080101 );
+    std::uniform_real_distribution<> x_dist( -50.0, 50.0 );
+    std::uniform_real_distribution<> y_dist( -32.0, 32.0 );
+    std::uniform_real_distribution<> dir_dist( -180.0, 180.0 );
+    std::uniform_real_distribution<> near_dist( 0.0, 3.5 );
+    std::uniform_int_distribution<> opponent_dist( 0, 5 );
+
+    std::vector< Situation > situations;
+    for ( int i = 0; i < max_loop; ++i )
+    {
+        Situation s;
+        s.my_next_.assign( x_dist( gen ), y_dist( gen ) );
+        s.my_body_ = dir_dist( gen );
+        s.ball_pos_ = s.my_next_ + Vector2D::from_polar( 0.3 + near_dist( gen ) * 0.15, dir_dist( gen ) );
+
+        const int n = opponent_dist( gen );
+        for ( int o = 0; o < n; ++o )
+        {
+            s.opponents_.push_back( { s.my_next_ + Vector2D::from_polar( 0.6 + near_dist( gen ), dir_dist( gen ) ),
+                                      AngleDeg( dir_dist( gen ) ),
+                                      ( o == 0 && i % 10 == 0 ) } );
+        }
+        situations.push_back( s );
+    }
+
+    int pruned_count = 0;
+    for ( const Situation & s : situations )
+    {
+        if ( check_situation( s ) )
+        {
+            ++pruned_count;
+        }
+    }
+
+    std::cout << "\npruned " << pruned_count << "/" << max_loop << " situations" << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -33,8 +33,10 @@
 #define RCSC_ANN_BPN1_H
 
 #include <array>
+#include <vector>
 #include <algorithm>
 #include <numeric> // inner_product
+#include <iterator>
 #include <iostream>
 #include <cmath>
 
@@ -57,6 +59,16 @@ struct SigmoidFunc {
           return 1.0 / ( 1.0 + std::exp( - x ) );
       }
 
+    /*!
+      \brief functional operator for the single precision value
+      \param x input value
+      \return output value of sigmoid function
+     */
+    float operator()( const float & x ) const
+      {
+          return 1.0f / ( 1.0f + std::exp( - x ) );
+      }
+
     /*!
       \brief inverse function
       \param y output value of this function.
@@ -107,6 +119,16 @@ struct LinearFunc {
           return x;
       }
 
+    /*!
+      \brief functional operator for the single precision value
+      \param x input value
+      \return output value of linear function
+     */
+    float operator()( const float & x ) const
+      {
+          return x;
+      }
+
     /*!
       \brief inverse function
       \param y output value of this function.
@@ -231,17 +253,17 @@ public:
      */
     void init()
       {
-          M_hidden_layer.assign( 0 );
+          M_hidden_layer.fill( 0 );
           M_hidden_layer.back() = 1;
           for ( std::size_t i = 0; i < HIDDEN; ++i )
           {
-              M_weight_i_to_h[i].assign( 0 );
-              M_delta_weight_i_to_h[i].assign( 0 );
+              M_weight_i_to_h[i].fill( 0 );
+              M_delta_weight_i_to_h[i].fill( 0 );
           }
           for ( std::size_t i = 0; i < OUTPUT; ++i )
           {
-              M_weight_h_to_o[i].assign( 0 );
-              M_delta_weight_h_to_o[i].assign( 0 );
+              M_weight_h_to_o[i].fill( 0 );
+              M_delta_weight_h_to_o[i].fill( 0 );
           }
       }
 
@@ -266,6 +288,26 @@ public:
           }
       }
 
+    /*!
+      \brief get the connection weights from the input layer to the hidden unit
+      \param i index of the hidden unit
+      \return const reference to the weights. the last element is the bias weight.
+     */
+    const std::array< value_type, INPUT + 1 > & weightInputToHidden( const std::size_t i ) const
+      {
+          return M_weight_i_to_h[i];
+      }
+
+    /*!
+      \brief get the connection weights from the hidden layer to the output unit
+      \param i index of the output unit
+      \return const reference to the weights. the last element is the bias weight.
+     */
+    const std::array< value_type, HIDDEN + 1 > & weightHiddenToOutput( const std::size_t i ) const
+      {
+          return M_weight_h_to_o[i];
+      }
+
     /*!
       \brief simulate network.
       \param input input data
@@ -436,6 +478,189 @@ public:
       }
 };
 
+////////////////////////////////////////////////////////////////
+
+/*!
+  \brief batch inference of BPNetwork1.
+
+  The weights of the source network are copied to the contiguous arrays
+  of the value type T (e.g. float).  propagate() evaluates the inputs
+  by the block of BLOCK_SIZE, and the inner loops run over the inputs in
+  the block, so that the compiler can vectorize them.  The copied
+  weights are not updated by the training of the source network.
+  assign() must be called again after the training.
+*/
+template < std::size_t INPUT,
+           std::size_t HIDDEN,
+           std::size_t OUTPUT,
+           typename FuncH = SigmoidFunc,
+           typename FuncO = SigmoidFunc,
+           typename T = float >
+class BPNetwork1Batch {
+public:
+    typedef T value_type; //!< typedef of the value type
+
+    //! the number of inputs evaluated at once
+    static const std::size_t BLOCK_SIZE = 64;
+
+private:
+
+    //! weights from the input to the hidden layer. [h * (INPUT + 1) + j], bias at j == INPUT.
+    std::vector< value_type > M_weight_i_to_h;
+    //! weights from the hidden to the output layer. [o * (HIDDEN + 1) + h], bias at h == HIDDEN.
+    std::vector< value_type > M_weight_h_to_o;
+
+    //! transposed input block. [j * BLOCK_SIZE + b]
+    mutable std::vector< value_type > M_input_block;
+    //! hidden layer values. [h * BLOCK_SIZE + b]
+    mutable std::vector< value_type > M_hidden_block;
+    //! output layer values. [o * BLOCK_SIZE + b]
+    mutable std::vector< value_type > M_output_block;
+
+public:
+
+    /*!
+      \brief create the batch network with the weights of the source network
+      \param net source network
+     */
+    template < typename NET >
+    explicit
+    BPNetwork1Batch( const NET & net )
+        : M_weight_i_to_h( HIDDEN * ( INPUT + 1 ) ),
+          M_weight_h_to_o( OUTPUT * ( HIDDEN + 1 ) ),
+          M_input_block( INPUT * BLOCK_SIZE ),
+          M_hidden_block( HIDDEN * BLOCK_SIZE ),
+          M_output_block( OUTPUT * BLOCK_SIZE )
+      {
+          assign( net );
+      }
+
+    /*!
+      \brief copy the weights of the source network
+      \param net source network
+     */
+    template < typename NET >
+    void assign( const NET & net )
+      {
+          for ( std::size_t h = 0; h < HIDDEN; ++h )
+          {
+              std::copy( net.weightInputToHidden( h ).begin(),
+                         net.weightInputToHidden( h ).end(),
+                         M_weight_i_to_h.begin() + h * ( INPUT + 1 ) );
+          }
+          for ( std::size_t o = 0; o < OUTPUT; ++o )
+          {
+              std::copy( net.weightHiddenToOutput( o ).begin(),
+                         net.weightHiddenToOutput( o ).end(),
+                         M_weight_h_to_o.begin() + o * ( HIDDEN + 1 ) );
+          }
+      }
+
+    /*!
+      \brief evaluate the inputs
+      \param inputs row major input matrix (size * INPUT)
+      \param size the number of inputs
+      \param outputs row major output matrix (size * OUTPUT)
+     */
+    void propagate( const value_type * inputs,
+                    const std::size_t size,
+                    value_type * outputs ) const
+      {
+          const FuncH func_h;
+          const FuncO func_o;
+
+          value_type * x = M_input_block.data();
+          value_type * hidden = M_hidden_block.data();
+          value_type * out = M_output_block.data();
+
+          // the loops always run over the whole block with the local accumulator,
+          // so that they have the fixed trip count and no aliasing.
+          value_type sum[BLOCK_SIZE];
+
+          for ( std::size_t first = 0; first < size; first += BLOCK_SIZE )
+          {
+              const std::size_t n = std::min( BLOCK_SIZE, size - first );
+
+              if ( n < BLOCK_SIZE )
+              {
+                  std::fill( M_input_block.begin(), M_input_block.end(), static_cast< value_type >( 0 ) );
+              }
+
+              for ( std::size_t b = 0; b < n; ++b )
+              {
+                  for ( std::size_t j = 0; j < INPUT; ++j )
+                  {
+                      x[j * BLOCK_SIZE + b] = inputs[( first + b ) * INPUT + j];
+                  }
+              }
+
+              // Input to Hidden
+              for ( std::size_t h = 0; h < HIDDEN; ++h )
+              {
+                  const value_type * w = &M_weight_i_to_h[h * ( INPUT + 1 )];
+
+                  for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+                  {
+                      sum[b] = w[INPUT]; // bias
+                  }
+                  for ( std::size_t j = 0; j < INPUT; ++j )
+                  {
+                      const value_type wj = w[j];
+                      const value_type * xj = x + j * BLOCK_SIZE;
+                      for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+                      {
+                          sum[b] += wj * xj[b];
+                      }
+                  }
+
+                  value_type * hh = hidden + h * BLOCK_SIZE;
+                  for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+                  {
+                      hh[b] = func_h( sum[b] );
+                  }
+              }
+
+              // Hidden to Output
+              for ( std::size_t o = 0; o < OUTPUT; ++o )
+              {
+                  const value_type * w = &M_weight_h_to_o[o * ( HIDDEN + 1 )];
+
+                  for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+                  {
+                      sum[b] = w[HIDDEN]; // bias
+                  }
+                  for ( std::size_t h = 0; h < HIDDEN; ++h )
+                  {
+                      const value_type wh = w[h];
+                      const value_type * hh = hidden + h * BLOCK_SIZE;
+                      for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+                      {
+                          sum[b] += wh * hh[b];
+                      }
+                  }
+
+                  value_type * oo = out + o * BLOCK_SIZE;
+                  for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+                  {
+                      oo[b] = func_o( sum[b] );
+                  }
+              }
+
+              for ( std::size_t b = 0; b < n; ++b )
+              {
+                  for ( std::size_t o = 0; o < OUTPUT; ++o )
+                  {
+                      outputs[( first + b ) * OUTPUT + o] = out[o * BLOCK_SIZE + b];
+                  }
+              }
+          }
+      }
+};
+
+template < std::size_t INPUT, std::size_t HIDDEN, std::size_t OUTPUT,
+           typename FuncH, typename FuncO, typename T >
+const std::size_t BPNetwork1Batch< INPUT, HIDDEN, OUTPUT, FuncH, FuncO, T >::BLOCK_SIZE;
+
 }
 
 #endif
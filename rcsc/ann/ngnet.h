@@ -221,6 +221,72 @@ public:
 
 };
 
+////////////////////////////////////////////////////////////////
+
+/*!
+  \class NGNetBatch
+  \brief batch inference of NGNet.
+
+  The unit parameters of the source network are copied to the contiguous
+  arrays of the value type T.  float and double are available.
+  propagate() evaluates the inputs by the block of BLOCK_SIZE, and the
+  inner loops run over the inputs in the block, so that the compiler can
+  vectorize them.  The outputs are normalized by the sum of the unit
+  values as NGNet::propagate().  assign() must be called again after
+  the training of the source network.
+*/
+template < typename T >
+class NGNetBatch {
+public:
+    typedef T value_type; //!< typedef of the value type
+
+    //! the number of inputs evaluated at once
+    static const std::size_t BLOCK_SIZE = 64;
+
+private:
+
+    std::size_t M_input_dim; //!< input dimension
+    std::size_t M_output_dim; //!< output dimension
+    std::size_t M_unit_size; //!< the number of units
+
+    //! unit centers. [u * input_dim + j]
+    std::vector< value_type > M_centers;
+    //! exponent factor of each unit, -1/(2*sigma^2)
+    std::vector< value_type > M_factors;
+    //! unit weights. [u * output_dim + o]
+    std::vector< value_type > M_weights;
+
+    //! transposed input block. [j * BLOCK_SIZE + b]
+    mutable std::vector< value_type > M_input_block;
+    //! output values. [o * BLOCK_SIZE + b]
+    mutable std::vector< value_type > M_output_block;
+
+public:
+
+    /*!
+      \brief create the batch network with the parameters of the source network
+      \param net source network
+     */
+    explicit
+    NGNetBatch( const NGNet & net );
+
+    /*!
+      \brief copy the parameters of the source network
+      \param net source network
+     */
+    void assign( const NGNet & net );
+
+    /*!
+      \brief evaluate the inputs
+      \param inputs row major input matrix (size * input dimension)
+      \param size the number of inputs
+      \param outputs row major output matrix (size * output dimension)
+     */
+    void propagate( const value_type * inputs,
+                    const std::size_t size,
+                    value_type * outputs ) const;
+};
+
 }
 
 #endif
@@ -369,4 +369,144 @@ RBFNetwork::printUnits( std::ostream & os ) const
     return os << std::flush;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+template < typename T >
+const std::size_t RBFNetworkBatch< T >::BLOCK_SIZE;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+template < typename T >
+RBFNetworkBatch< T >::RBFNetworkBatch( const RBFNetwork & net )
+    : M_input_dim( 0 ),
+      M_output_dim( 0 ),
+      M_unit_size( 0 )
+{
+    assign( net );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+template < typename T >
+void
+RBFNetworkBatch< T >::assign( const RBFNetwork & net )
+{
+    M_input_dim = net.inputDim();
+    M_output_dim = net.outputDim();
+    M_unit_size = net.units().size();
+
+    M_centers.clear();
+    M_factors.clear();
+    M_weights.clear();
+    M_centers.reserve( M_unit_size * M_input_dim );
+    M_factors.reserve( M_unit_size );
+    M_weights.reserve( M_unit_size * M_output_dim );
+
+    for ( const RBFNetwork::Unit & unit : net.units() )
+    {
+        M_centers.insert( M_centers.end(), unit.center_.begin(), unit.center_.end() );
+        M_factors.push_back( static_cast< value_type >( -1.0 / ( 2.0 * unit.sigma_ * unit.sigma_ ) ) );
+        M_weights.insert( M_weights.end(), unit.weights_.begin(), unit.weights_.end() );
+    }
+
+    M_input_block.assign( M_input_dim * BLOCK_SIZE, 0 );
+    M_output_block.assign( M_output_dim * BLOCK_SIZE, 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+template < typename T >
+void
+RBFNetworkBatch< T >::propagate( const value_type * inputs,
+                                 const std::size_t size,
+                                 value_type * outputs ) const
+{
+    const std::size_t INPUT = M_input_dim;
+    const std::size_t OUTPUT = M_output_dim;
+
+    value_type * x = M_input_block.data();
+    value_type * out = M_output_block.data();
+
+    // the loops always run over the whole block with the local accumulator,
+    // so that they have the fixed trip count and no aliasing.
+    value_type unit_value[BLOCK_SIZE];
+
+    for ( std::size_t first = 0; first < size; first += BLOCK_SIZE )
+    {
+        const std::size_t n = std::min( BLOCK_SIZE, size - first );
+
+        if ( n < BLOCK_SIZE )
+        {
+            std::fill( M_input_block.begin(), M_input_block.end(), static_cast< value_type >( 0 ) );
+        }
+
+        for ( std::size_t b = 0; b < n; ++b )
+        {
+            for ( std::size_t j = 0; j < INPUT; ++j )
+            {
+                x[j * BLOCK_SIZE + b] = inputs[( first + b ) * INPUT + j];
+            }
+        }
+
+        std::fill( M_output_block.begin(), M_output_block.end(), static_cast< value_type >( 0 ) );
+
+        for ( std::size_t u = 0; u < M_unit_size; ++u )
+        {
+            // squared distance from the center
+            const value_type * center = &M_centers[u * INPUT];
+            for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+            {
+                unit_value[b] = 0;
+            }
+            for ( std::size_t j = 0; j < INPUT; ++j )
+            {
+                const value_type c = center[j];
+                const value_type * xj = x + j * BLOCK_SIZE;
+                for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+                {
+                    const value_type d = c - xj[b];
+                    unit_value[b] += d * d;
+                }
+            }
+
+            // gaussian
+            const value_type factor = M_factors[u];
+            for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+            {
+                unit_value[b] = std::exp( unit_value[b] * factor );
+            }
+
+            const value_type * w = &M_weights[u * OUTPUT];
+            for ( std::size_t o = 0; o < OUTPUT; ++o )
+            {
+                const value_type wo = w[o];
+                value_type * out_o = out + o * BLOCK_SIZE;
+                for ( std::size_t b = 0; b < BLOCK_SIZE; ++b )
+                {
+                    out_o[b] += wo * unit_value[b];
+                }
+            }
+        }
+
+        for ( std::size_t b = 0; b < n; ++b )
+        {
+            for ( std::size_t o = 0; o < OUTPUT; ++o )
+            {
+                outputs[( first + b ) * OUTPUT + o] = out[o * BLOCK_SIZE + b];
+            }
+        }
+    }
+}
+
+template class RBFNetworkBatch< float >;
+template class RBFNetworkBatch< double >;
+
 }
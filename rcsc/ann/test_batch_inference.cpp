@@ -0,0 +1,401 @@
+// -*-c++-*-
+
+/*!
+  \file test_batch_inference.cpp
+  \brief test code for the batch inference of the ann networks
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "bpn1.h"
+#include "rbf.h"
+#include "ngnet.h"
+
+#include <rcsc/time/timer.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+
+class BatchInferenceTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( BatchInferenceTest );
+    CPPUNIT_TEST( testBPNetwork1 );
+    CPPUNIT_TEST( testRBFNetwork );
+    CPPUNIT_TEST( testNGNet );
+    CPPUNIT_TEST( testBenchmark );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testBPNetwork1();
+    void testRBFNetwork();
+    void testNGNet();
+    void testBenchmark();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( BatchInferenceTest );
+
+namespace {
+
+typedef BPNetwork1< 8, 16, 1 > TestBPN;
+
+const std::size_t BATCH_SIZES[] = { 1, 63, 64, 130 };
+
+/*-------------------------------------------------------------------*/
+std::vector< double >
+create_inputs( std::mt19937 & gen,
+               const std::size_t size,
+               const double min_value,
+               const double max_value )
+{
+    std::uniform_real_distribution<> dist( min_value, max_value );
+    std::vector< double > inputs( size );
+    for ( double & v : inputs )
+    {
+        v = dist( gen );
+    }
+    return inputs;
+}
+
+/*-------------------------------------------------------------------*/
+void
+create_bpn( std::mt19937 & gen,
+            TestBPN * net )
+{
+    std::uniform_real_distribution<> dist( -1.0, 1.0 );
+    auto rng = [&]() { return dist( gen ); };
+    net->randomize( rng );
+}
+
+/*-------------------------------------------------------------------*/
+void
+create_rbf( std::mt19937 & gen,
+            RBFNetwork * net )
+{
+    for ( int i = 0; i < 30; ++i )
+    {
+        const std::vector< double > center = create_inputs( gen, net->inputDim(), -50.0, 50.0 );
+        net->addCenter( center );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+create_ngnet( std::mt19937 & gen,
+              NGNet * net )
+{
+    std::uniform_real_distribution<> dist( -50.0, 50.0 );
+    for ( int i = 0; i < 30; ++i )
+    {
+        NGNet::input_vector center;
+        center[0] = dist( gen );
+        center[1] = dist( gen );
+        net->addCenter( center );
+    }
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+BatchInferenceTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+BatchInferenceTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+BatchInferenceTest::testBPNetwork1()
+{
+    std::mt19937 gen( 1 );
+
+    TestBPN net;
+    create_bpn( gen, &net );
+
+    const BPNetwork1Batch< 8, 16, 1, SigmoidFunc, SigmoidFunc, double > batch_d( net );
+    const BPNetwork1Batch< 8, 16, 1 > batch_f( net );
+
+    for ( const std::size_t n : BATCH_SIZES )
+    {
+        const std::vector< double > inputs = create_inputs( gen, n * 8, -1.0, 1.0 );
+        const std::vector< float > inputs_f( inputs.begin(), inputs.end() );
+        std::vector< double > outputs_d( n );
+        std::vector< float > outputs_f( n );
+
+        batch_d.propagate( inputs.data(), n, outputs_d.data() );
+        batch_f.propagate( inputs_f.data(), n, outputs_f.data() );
+
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            TestBPN::input_array input;
+            std::copy( inputs.begin() + i * 8, inputs.begin() + ( i + 1 ) * 8, input.begin() );
+            TestBPN::output_array output;
+            net.propagate( input, output );
+
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( output[0], outputs_d[i], 1.0e-12 );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( output[0], outputs_f[i], 1.0e-4 );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+BatchInferenceTest::testRBFNetwork()
+{
+    std::mt19937 gen( 2 );
+
+    RBFNetwork net( 4, 2 );
+    create_rbf( gen, &net );
+
+    const RBFNetworkBatch< double > batch_d( net );
+    const RBFNetworkBatch< float > batch_f( net );
+
+    for ( const std::size_t n : BATCH_SIZES )
+    {
+        const std::vector< double > inputs = create_inputs( gen, n * 4, -50.0, 50.0 );
+        const std::vector< float > inputs_f( inputs.begin(), inputs.end() );
+        std::vector< double > outputs_d( n * 2 );
+        std::vector< float > outputs_f( n * 2 );
+
+        batch_d.propagate( inputs.data(), n, outputs_d.data() );
+        batch_f.propagate( inputs_f.data(), n, outputs_f.data() );
+
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            const RBFNetwork::input_vector input( inputs.begin() + i * 4, inputs.begin() + ( i + 1 ) * 4 );
+            RBFNetwork::output_vector output;
+            net.propagate( input, output );
+
+            for ( std::size_t o = 0; o < 2; ++o )
+            {
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( output[o], outputs_d[i * 2 + o], 1.0e-9 );
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( output[o], outputs_f[i * 2 + o],
+                                              1.0e-3 * std::max( 1.0, std::fabs( output[o] ) ) );
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+BatchInferenceTest::testNGNet()
+{
+    std::mt19937 gen( 3 );
+
+    NGNet net;
+    create_ngnet( gen, &net );
+
+    const NGNetBatch< double > batch_d( net );
+    const NGNetBatch< float > batch_f( net );
+
+    for ( const std::size_t n : BATCH_SIZES )
+    {
+        const std::vector< double > inputs = create_inputs( gen, n * 2, -50.0, 50.0 );
+        const std::vector< float > inputs_f( inputs.begin(), inputs.end() );
+        std::vector< double > outputs_d( n * 2 );
+        std::vector< float > outputs_f( n * 2 );
+
+        batch_d.propagate( inputs.data(), n, outputs_d.data() );
+        batch_f.propagate( inputs_f.data(), n, outputs_f.data() );
+
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            NGNet::input_vector input;
+            input[0] = inputs[i * 2];
+            input[1] = inputs[i * 2 + 1];
+            NGNet::output_vector output;
+            net.propagate( input, output );
+
+            for ( std::size_t o = 0; o < 2; ++o )
+            {
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( output[o], outputs_d[i * 2 + o], 1.0e-9 );
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( output[o], outputs_f[i * 2 + o],
+                                              1.0e-3 * std::max( 1.0, std::fabs( output[o] ) ) );
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+BatchInferenceTest::testBenchmark()
+{
+    const std::size_t n = 20000;
+
+    std::mt19937 gen( 4 );
+
+    // BPNetwork1
+    {
+        TestBPN net;
+        create_bpn( gen, &net );
+        const BPNetwork1Batch< 8, 16, 1 > batch( net );
+
+        const std::vector< double > inputs = create_inputs( gen, n * 8, -1.0, 1.0 );
+        const std::vector< float > inputs_f( inputs.begin(), inputs.end() );
+        std::vector< float > outputs_f( n );
+
+        double total = 0.0;
+        Timer timer;
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            TestBPN::input_array input;
+            std::copy( inputs.begin() + i * 8, inputs.begin() + ( i + 1 ) * 8, input.begin() );
+            TestBPN::output_array output;
+            net.propagate( input, output );
+            total += output[0];
+        }
+        const double single_msec = timer.elapsedNSec() * 1.0e-6;
+
+        timer.restart();
+        batch.propagate( inputs_f.data(), n, outputs_f.data() );
+        const double batch_msec = timer.elapsedNSec() * 1.0e-6;
+
+        CPPUNIT_ASSERT( total > 0.0 );
+        std::cout << "\nBPNetwork1<8,16,1> single " << n / std::max( 1.0e-6, single_msec )
+                  << " batch(float) " << n / std::max( 1.0e-6, batch_msec )
+                  << " [candidates/ms]" << std::flush;
+    }
+
+    // RBFNetwork
+    {
+        RBFNetwork net( 4, 2 );
+        create_rbf( gen, &net );
+        const RBFNetworkBatch< float > batch( net );
+
+        const std::vector< double > inputs = create_inputs( gen, n * 4, -50.0, 50.0 );
+        const std::vector< float > inputs_f( inputs.begin(), inputs.end() );
+        std::vector< float > outputs_f( n * 2 );
+
+        double total = 0.0;
+        Timer timer;
+        RBFNetwork::input_vector input( 4 );
+        RBFNetwork::output_vector output;
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            std::copy( inputs.begin() + i * 4, inputs.begin() + ( i + 1 ) * 4, input.begin() );
+            net.propagate( input, output );
+            total += std::fabs( output[0] );
+        }
+        const double single_msec = timer.elapsedNSec() * 1.0e-6;
+
+        timer.restart();
+        batch.propagate( inputs_f.data(), n, outputs_f.data() );
+        const double batch_msec = timer.elapsedNSec() * 1.0e-6;
+
+        CPPUNIT_ASSERT( total >= 0.0 );
+        std::cout << "\nRBFNetwork(4,2) 30 units single " << n / std::max( 1.0e-6, single_msec )
+                  << " batch(float) " << n / std::max( 1.0e-6, batch_msec )
+                  << " [candidates/ms]" << std::flush;
+    }
+
+    // NGNet
+    {
+        NGNet net;
+        create_ngnet( gen, &net );
+        const NGNetBatch< float > batch( net );
+
+        const std::vector< double > inputs = create_inputs( gen, n * 2, -50.0, 50.0 );
+        const std::vector< float > inputs_f( inputs.begin(), inputs.end() );
+        std::vector< float > outputs_f( n * 2 );
+
+        double total = 0.0;
+        Timer timer;
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            NGNet::input_vector input;
+            input[0] = inputs[i * 2];
+            input[1] = inputs[i * 2 + 1];
+            NGNet::output_vector output;
+            net.propagate( input, output );
+            total += std::fabs( output[0] );
+        }
+        const double single_msec = timer.elapsedNSec() * 1.0e-6;
+
+        timer.restart();
+        batch.propagate( inputs_f.data(), n, outputs_f.data() );
+        const double batch_msec = timer.elapsedNSec() * 1.0e-6;
+
+        CPPUNIT_ASSERT( total >= 0.0 );
+        std::cout << "\nNGNet 30 units single " << n / std::max( 1.0e-6, single_msec )
+                  << " batch(float) " << n / std::max( 1.0e-6, batch_msec )
+                  << " [candidates/ms]" << std::endl;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -159,6 +159,15 @@ public:
         : M_target_players( players )
       { }
 
+    /*!
+      \brief create with target players
+      \param players shared target player set.
+     */
+    explicit
+    CLangActionMark( const CLangUnumSet::Ptr & players )
+        : M_target_players( players )
+      { }
+
     // ~CLangActionMark()
     //   {
     //       std::cerr << "delete CLangActionMark " << *M_target_players << std::endl;
@@ -339,6 +348,15 @@ public:
         : M_assigned_players( players )
       { }
 
+    /*!
+      \brief create with assigned players
+      \param players shared assigned player set.
+     */
+    explicit
+    CLangActionBallTo( const CLangUnumSet::Ptr & players )
+        : M_assigned_players( players )
+      { }
+
     // ~CLangActionBallTo()
     //   {
     //       std::cerr << "delete CLangActionBallTo " << M_player_unum << std::endl;
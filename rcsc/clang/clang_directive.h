@@ -173,6 +173,15 @@ public:
           M_players = CLangUnumSet::Ptr( players );
       }
 
+    /*!
+      \brief set target players.
+      \param players shared target player set
+     */
+    void setPlayers( const CLangUnumSet::Ptr & players )
+      {
+          M_players = players;
+      }
+
     /*!
       \brief add target player
       \param unum target player's uniform number
@@ -192,6 +201,15 @@ public:
           M_actions.push_back( CLangAction::ConstPtr( act ) );
       }
 
+    /*!
+      \brief add new action.
+      \param act shared action object
+     */
+    void addAction( const CLangAction::ConstPtr & act )
+      {
+          M_actions.push_back( act );
+      }
+
     //
     //
     //
@@ -95,6 +95,15 @@ public:
           M_tokens.push_back( CLangToken::ConstPtr( tok ) );
       }
 
+    /*!
+      \brief add new token.
+      \param tok shared token object.
+     */
+    void addToken( const CLangToken::ConstPtr & tok )
+      {
+          M_tokens.push_back( tok );
+      }
+
     /*!
       \brief print clang message to the output stream
       \param os reference to the output stream
@@ -33,8 +33,6 @@
 #include <config.h>
 #endif
 
-// #define BOOST_SPIRIT_DEBUG
-
 #include "clang_parser.h"
 
 #include "clang_action.h"
@@ -44,955 +42,616 @@
 #include "clang_token.h"
 #include "clang_unum.h"
 
-#include <boost/spirit/include/classic.hpp>
-//#include <boost/bind.hpp>
-
-#include <functional>
-#include <stack>
+#include <memory_resource>
+#include <vector>
 #include <utility>
+#include <limits>
 #include <iostream>
 #include <cstring>
-#include <cassert>
-
-namespace bsc = BOOST_SPIRIT_CLASSIC_NS;
+#include <cctype>
 
 namespace rcsc {
 
 namespace {
 
-/*-------------------------------------------------------------------*/
-/*-------------------------------------------------------------------*/
-/*-------------------------------------------------------------------*/
-struct Item {
-
-    enum Type {
-        NONE,
-        TOKEN,
-        DIRECTIVE,
-        CONDITION,
-        ACTION,
-        UNUM_SET,
-        UNUM,
-        TTL,
-        HETERO_TYPE,
-        POSITIVE,
-        TEAM_OUR,
-        STRING,
-        VARIABLE,
-    };
-
-    union Value {
-        CLangToken * token_;
-        CLangDirective * directive_;
-        CLangCondition * condition_;
-        CLangAction * action_;
-        CLangUnumSet * unum_set_;
-        int int_value_;
-        bool bool_value_;
-        std::string * string_value_;
-    };
-
-    Type type_;
-    Value value_;
-
-    Item()
-        : type_( NONE )
-      {
-          std::memset( &value_, 0, sizeof( Value ) );
-      }
-    Item( CLangToken * token )
-        : type_( TOKEN )
-      {
-          value_.token_ = token;
-      }
-    Item( CLangDirective * dir )
-        : type_( DIRECTIVE )
-      {
-          value_.directive_ = dir;
-      }
-    Item( CLangCondition * cond )
-        : type_( CONDITION )
-      {
-          value_.condition_ = cond;
-      }
-    Item( CLangAction * act )
-        : type_( ACTION )
-      {
-          value_.action_ = act;
-      }
-    Item( CLangUnumSet * uset )
-        : type_( UNUM_SET )
-      {
-          value_.unum_set_ = uset;
-      }
-    Item( Type type,
-          int value )
-        : type_( type )
-      {
-          value_.int_value_ = value;
-      }
-    Item( Type type,
-          bool value )
-        : type_( type )
-      {
-          value_.bool_value_ = value;
-      }
-
-    Item( Type type,
-          std::string * str )
-        : type_( type )
-      {
-          value_.string_value_ = str;
-      }
-
-    void clear()
-      {
-          switch ( type_ ) {
-          case TOKEN:
-              delete value_.token_;
-              value_.token_ = nullptr;
-              break;
-          case DIRECTIVE:
-              delete value_.directive_;
-              value_.directive_ = nullptr;
-              break;
-          case CONDITION:
-              delete value_.condition_;
-              value_.condition_ = nullptr;
-              break;
-          case ACTION:
-              delete value_.action_;
-              value_.action_ = nullptr;
-              break;
-          case UNUM_SET:
-              delete value_.unum_set_;
-              value_.unum_set_ = nullptr;
-              break;
-          case UNUM:
-          case TTL:
-          case HETERO_TYPE:
-              value_.int_value_ = 0;
-              break;
-          case POSITIVE:
-          case TEAM_OUR:
-              value_.bool_value_ = false;
-              break;
-          case STRING:
-          case VARIABLE:
-              delete value_.string_value_;
-              value_.string_value_ = nullptr;
-              break;
-          default:
-              std::cerr << __FILE__ << ' ' << __LINE__
-                        << ": unknown item type " << type_ << std::endl;
-              break;
-          }
+//! monotonic memory pool for one message tree
+typedef std::pmr::monotonic_buffer_resource Arena;
 
-          type_ = NONE;
-      }
-};
-
-}
-
-/*-------------------------------------------------------------------*/
-/*-------------------------------------------------------------------*/
 /*-------------------------------------------------------------------*/
-class CLangParser::Impl
-    : public bsc::grammar< CLangParser::Impl > {
-private:
-
-    CLangParser & M_parser;
-
-    std::stack< Item > M_item_stack;
+/*!
+  \brief allocator that shares the ownership of the arena. the arena
+  is released when the last tree object is destroyed.
+ */
+template < typename T >
+struct ArenaAllocator {
+    typedef T value_type;
 
-public:
+    std::shared_ptr< Arena > arena_;
 
-    Impl( CLangParser & parser )
-        : M_parser( parser )
+    explicit
+    ArenaAllocator( const std::shared_ptr< Arena > & arena )
+        : arena_( arena )
       { }
 
-    ~Impl()
-      {
-          clear();
-      }
-
-    void clear()
-      {
-          while ( ! M_item_stack.empty() )
-          {
-              //std::cerr << "clear stack item" << std::endl;
-              M_item_stack.top().clear();
-              M_item_stack.pop();
-          }
-      }
-
-    bool stackIsEmpty() const
-      {
-          return M_item_stack.empty();
-      }
-
-
-    template < typename S >
-    struct definition {
-
-        bsc::rule< S > lp_p;
-        bsc::rule< S > rp_p;
-
-        bsc::rule< S > lb_p;
-        bsc::rule< S > rb_p;
-
-        bsc::rule< S > clang_true_p;
-        bsc::rule< S > clang_false_p;
-
-        bsc::rule< S > clang_raw_str_p;
-        bsc::rule< S > clang_str_p;
-        bsc::rule< S > clang_var_p;
-
-        bsc::rule< S > clang_unum_p;
-        bsc::rule< S > clang_unum_set_p;
-
-        bsc::rule< S > clang_cond_bool_p;
-        bsc::rule< S > clang_cond_p;
-
-        bsc::rule< S > clang_act_mark_p;
-        bsc::rule< S > clang_act_htype_p;
-        bsc::rule< S > clang_act_hold_p;
-        bsc::rule< S > clang_act_bto_p;
-
-        bsc::rule< S > clang_act_p;
-
-        bsc::rule< S > clang_do_dont_p;
-
-        bsc::rule< S > clang_team_p;
-
-        bsc::rule< S > clang_directive_p;
-        bsc::rule< S > clang_token_p;
-
-        bsc::rule< S > clang_info_msg_p;
-
-        bsc::rule< S > clang_msg_p;
-
-        definition( const Impl & self )
-          {
-              using std::placeholders::_1;
-              using std::placeholders::_2;
-
-              lp_p = bsc::ch_p( '(' );
-              rp_p = bsc::ch_p( ')' );
-
-              lb_p = bsc::ch_p( '{' );
-              rb_p = bsc::ch_p( '}' );
-
-              clang_true_p = bsc::str_p( "true" );
-              clang_false_p = bsc::str_p( "false" );
-
-              // str: \"[0-9A-Za-z\(\)\.\+\-\*\/\?\<\>\_ ]+\"
-              // var: [abe-oqrt-zA-Z_][a-zA-Z0-9_]*
-
-              clang_raw_str_p = *( bsc::alnum_p | bsc::chset_p( "().+-*/?<>_ " ) );
-              clang_str_p = ( bsc::ch_p( '"' )
-                              >> clang_raw_str_p
-                              >> bsc::ch_p( '"' )
-                              )[std::bind( &Impl::handleString, &self, _1, _2 )];
-              clang_var_p = ( ( bsc::chset_p( "abefghijklmnoqrtuvwxyz" )
-                                | bsc::upper_p
-                                | bsc::ch_p( '_' ) )
-                              >> +( bsc::alnum_p | bsc::ch_p( '_' ) )
-                              )[std::bind( &Impl::handleVariable, &self, _1, _2 )];
-
-              clang_unum_p = bsc::uint_p[std::bind( &Impl::handleUnum, &self, _1 )];
-              clang_unum_set_p = ( lb_p >> *clang_unum_p >> rb_p
-                                   )[std::bind( &Impl::handleUnumSet, &self )];
-
-              clang_cond_bool_p
-                  = ( lp_p >> clang_true_p >> rp_p )[std::bind( &Impl::handleConditionBool, &self, true )]
-                  | ( lp_p >> clang_false_p >> rp_p )[std::bind( &Impl::handleConditionBool, &self, false )];
-              clang_cond_p = clang_cond_bool_p;
-
-              clang_act_mark_p = ( lp_p
-                                   >> bsc::str_p( "mark" ) >> clang_unum_set_p
-                                   >> rp_p );
-              clang_act_htype_p = ( lp_p
-                                    >> bsc::str_p( "htype" )
-                                    >> bsc::int_p[std::bind( &Impl::handleActHeteroTypeId, &self, _1 )]
-                                    >> rp_p );
-              clang_act_hold_p = ( lp_p
-                                   >> bsc::str_p( "hold" )
-                                   >> rp_p );
-              clang_act_bto_p = ( lp_p
-                                  >> bsc::str_p( "bto" ) >> clang_unum_set_p
-                                  >> rp_p );
-              clang_act_p = ( clang_act_mark_p[std::bind( &Impl::handleActMark, &self )]
-                              | clang_act_htype_p[std::bind( &Impl::handleActHeteroType, &self )]
-                              | clang_act_hold_p[std::bind( &Impl::handleActHold, &self )]
-                              | clang_act_bto_p[std::bind( &Impl::handleActBallTo, &self )]
-                              );
-
-              clang_do_dont_p
-                  = bsc::str_p( "dont" )[std::bind( &Impl::handlePositive, &self, false )]
-                  | bsc::str_p( "do" )[std::bind( &Impl::handlePositive, &self, true )];
-
-              clang_team_p
-                  = bsc::str_p( "our" )[std::bind( &Impl::handleTeam, &self, true )]
-                  | bsc::str_p( "opp" )[std::bind( &Impl::handleTeam, &self, false )];
-
-              clang_directive_p = ( ( lp_p
-                                      >> clang_do_dont_p
-                                      >> clang_team_p
-                                      >> clang_unum_set_p
-                                      >> *clang_act_p
-                                      >> rp_p )[std::bind( &Impl::handleDirectiveCommon, &self )]
-                                    | clang_str_p[std::bind( &Impl::handleDirectiveNamed, &self )]
-                                    );
-
-              clang_token_p = ( ( lp_p
-                                  >> bsc::int_p[std::bind( &Impl::handleTokenTTL, &self, _1 )]
-                                  >> clang_cond_p //[std::bind( &Impl::handleCondition, &self )]
-                                  >> *clang_directive_p
-                                  >> rp_p
-                                  )[std::bind( &Impl::handleTokenRule, &self )]
-                                | ( lp_p >> bsc::str_p( "clear" ) >> rp_p
-                                    )[std::bind( &Impl::handleTokenClear, &self )]
-                                );
-
-              clang_info_msg_p = ( lp_p
-                                   >> bsc::str_p( "info" )
-                                   >> *clang_token_p
-                                   >> rp_p
-                                   )[std::bind( &Impl::handleInfoMessage, &self )];
-
-              clang_msg_p = clang_info_msg_p;
-
-#ifdef BOOST_SPIRIT_DEBUG
-              std::cerr << "boost spirit debug" << std::endl;
-              BOOST_SPIRIT_DEBUG_RULE( clang_true_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_false_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_raw_str_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_str_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_var_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_unum_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_unum_set_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_cond_bool_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_cond_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_act_mark_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_act_htype_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_act_hold_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_act_bto_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_act_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_do_dont_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_team_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_directive_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_token_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_info_msg_p );
-              BOOST_SPIRIT_DEBUG_RULE( clang_msg_p );
-#endif
-          }
-
-
-        const bsc::rule< S > & start() const
-          {
-              return clang_msg_p;
-          }
-    };
-
-
-    bool handleString( const char * first,
-                       const char * last ) const
-      {
-          return M_parser.handleString( first, last );
-      }
-
-    bool handleVariable( const char * first,
-                         const char * last ) const
-      {
-          return M_parser.handleVariable( first, last );
-      }
-
-    bool handleUnum( unsigned int value ) const
-      {
-          return M_parser.handleUnum( value );
-      }
-
-    bool handleUnumSet() const
-      {
-          return M_parser.handleUnumSet();
-      }
-
-    bool handleConditionBool( bool value ) const
-      {
-          //std::cerr << "handleConditionBool " << value << std::endl;
-          return M_parser.handleConditionBool( value );
-      }
-
-    bool handlePositive( bool on ) const
-      {
-          //std::cerr << "handlePositive " << on << std::endl;
-          return M_parser.handlePositive( on );
-      }
-
-    bool handleTeam( bool our ) const
-      {
-          //std::cerr << "handleTeam " << our << std::endl;
-          return M_parser.handleTeam( our );
-      }
-
-    bool handleActMark() const
-      {
-          return M_parser.handleActMark();
-      }
-
-    bool handleActHeteroType() const
-      {
-          return M_parser.handleActHeteroType();
-      }
-
-    bool handleActHeteroTypeId( int type ) const
-      {
-          return M_parser.handleActHeteroTypeId( type );
-      }
-
-    bool handleActHold() const
-      {
-          return M_parser.handleActHold();
-      }
+    template < typename U >
+    ArenaAllocator( const ArenaAllocator< U > & other )
+        : arena_( other.arena_ )
+      { }
 
-    bool handleActBallTo() const
+    T * allocate( const std::size_t n )
       {
-          return M_parser.handleActBallTo();
+          return static_cast< T * >( arena_->allocate( n * sizeof( T ), alignof( T ) ) );
       }
 
-    bool handleDirectiveCommon() const
+    void deallocate( T *,
+                     const std::size_t ) noexcept
       {
-          return M_parser.handleDirectiveCommon();
+          // released together with the arena
       }
 
-    bool handleDirectiveNamed() const
+    template < typename U >
+    bool operator==( const ArenaAllocator< U > & other ) const
       {
-          return M_parser.handleDirectiveNamed();
+          return arena_ == other.arena_;
       }
 
-    bool handleTokenTTL( int ttl ) const
+    template < typename U >
+    bool operator!=( const ArenaAllocator< U > & other ) const
       {
-          return M_parser.handleTokenTTL( ttl );
+          return arena_ != other.arena_;
       }
+};
 
-    bool handleTokenRule() const
-      {
-          return M_parser.handleTokenRule();
-      }
+//! initial arena size. enough for the typical advice message.
+const std::size_t ARENA_BLOCK_SIZE = 4096;
 
-    bool handleTokenClear() const
-      {
-          return M_parser.handleTokenClear();
-      }
+}
 
-    bool handleInfoMessage() const
-      {
-          return M_parser.handleInfoMessage();
-      }
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*!
+  \brief parser implementation.
 
-    void pushToken( CLangToken * tok )
-      {
-          M_item_stack.push( Item( tok ) );
-      }
+  Each method parses one grammar rule. If the rule does not match, the
+  read position is restored and false is returned. Whitespaces are
+  skipped before each terminal symbol.
+ */
+class CLangParser::Impl {
+private:
 
-    CLangToken * popToken()
-      {
-          if ( M_item_stack.empty()
-               || M_item_stack.top().type_ != Item::TOKEN )
-          {
-              return nullptr;
-          }
+    const char * M_pos; //!< current read position
+    const char * M_end; //!< end of the message
 
-          CLangToken * tok = M_item_stack.top().value_.token_;
-          M_item_stack.pop();
-          return tok;
-      }
+    std::shared_ptr< Arena > M_arena; //!< memory pool for the current message
 
-    void pushDirective( CLangDirective * dir )
-      {
-          M_item_stack.push( Item( dir ) );
-      }
+    // work area reused in each rule
+    std::vector< CLangAction::ConstPtr > M_actions;
+    std::vector< CLangDirective::ConstPtr > M_directives;
+    std::vector< CLangToken::ConstPtr > M_tokens;
 
-    CLangDirective * popDirective()
-      {
-          if ( M_item_stack.empty()
-               || M_item_stack.top().type_ != Item::DIRECTIVE )
-          {
-              return nullptr;
-          }
+public:
 
-          CLangDirective * dir = M_item_stack.top().value_.directive_;
-          M_item_stack.pop();
-          return dir;
-      }
+    Impl()
+        : M_pos( nullptr ),
+          M_end( nullptr )
+      { }
 
-    void pushCondition( CLangCondition * cond )
+    void clear()
       {
-          M_item_stack.push( Item( cond ) );
+          M_pos = M_end = nullptr;
+          M_arena.reset();
+          M_actions.clear();
+          M_directives.clear();
+          M_tokens.clear();
       }
 
-    CLangCondition * popCondition()
-      {
-          if ( M_item_stack.empty()
-               || M_item_stack.top().type_ != Item::CONDITION )
-          {
-              return nullptr;
-          }
+    bool parse( const std::string & msg,
+                CLangMessage::ConstPtr * result );
 
-          CLangCondition * cond = M_item_stack.top().value_.condition_;
-          M_item_stack.pop();
-          return cond;
-      }
+private:
 
-    void pushAction( CLangAction * act )
+    template < typename T, typename... Args >
+    std::shared_ptr< T > create( Args &&... args )
       {
-          M_item_stack.push( Item( act ) );
+          return std::allocate_shared< T >( ArenaAllocator< T >( M_arena ),
+                                            std::forward< Args >( args )... );
       }
 
-    CLangAction * popAction()
+    void skipSpace()
       {
-          if ( M_item_stack.empty()
-               || M_item_stack.top().type_ != Item::ACTION )
+          while ( M_pos != M_end
+                  && std::isspace( static_cast< unsigned char >( *M_pos ) ) )
           {
-              return nullptr;
+              ++M_pos;
           }
-
-          CLangAction * act = M_item_stack.top().value_.action_;
-          M_item_stack.pop();
-          return act;
-      }
-
-    void pushUnumSet( CLangUnumSet * uset )
-      {
-          M_item_stack.push( Item( uset ) );
       }
 
-    CLangUnumSet * popUnumSet()
+    bool parseChar( const char c )
       {
-          if ( M_item_stack.empty()
-               || M_item_stack.top().type_ != Item::UNUM_SET )
+          skipSpace();
+          if ( M_pos != M_end
+               && *M_pos == c )
           {
-              return nullptr;
+              ++M_pos;
+              return true;
           }
-
-          CLangUnumSet * uset = M_item_stack.top().value_.unum_set_;
-          M_item_stack.pop();
-          return uset;
-      }
-
-    void pushIntValue( Item::Type type,
-                       int value )
-      {
-          M_item_stack.push( Item( type, value ) );
+          return false;
       }
 
-    bool popIntValue( Item::Type type,
-                      int * rval )
+    bool parseLiteral( const char * str,
+                       const std::size_t len )
       {
-          if ( M_item_stack.empty()
-               || M_item_stack.top().type_ != type )
+          skipSpace();
+          if ( static_cast< std::size_t >( M_end - M_pos ) >= len
+               && std::memcmp( M_pos, str, len ) == 0 )
           {
-              return false;
+              M_pos += len;
+              return true;
           }
-
-          *rval = M_item_stack.top().value_.int_value_;
-          M_item_stack.pop();
-          return true;
+          return false;
       }
 
-    void pushBoolValue( Item::Type type,
-                        bool value )
+    template < std::size_t N >
+    bool parseLiteral( const char ( &str )[N] )
       {
-          M_item_stack.push( Item( type, value ) );
+          return parseLiteral( str, N - 1 );
       }
 
-    bool popBoolValue( Item::Type type,
-                       bool * rval )
-      {
-          if ( M_item_stack.empty()
-               || M_item_stack.top().type_ != type )
-          {
-              return false;
-          }
-
-          *rval = M_item_stack.top().value_.bool_value_;
-          M_item_stack.pop();
-          return true;
-      }
-
-    void pushStringValue( Item::Type type,
-                          std::string * str )
-      {
-          M_item_stack.push( Item( type, str ) );
-      }
+    bool parseInt( const bool allow_sign,
+                   int * value );
 
-    std::string * popStringValue( Item::Type type )
-      {
-          if ( M_item_stack.empty()
-               || M_item_stack.top().type_ != type )
-          {
-              return nullptr;
-          }
-
-          std::string * str = M_item_stack.top().value_.string_value_;
-          M_item_stack.pop();
-          return str;
-      }
+    bool parseUnumSet( CLangUnumSet::Ptr * result );
+    bool parseCondition( CLangCondition::Ptr * result );
+    bool parseAction( CLangAction::ConstPtr * result );
+    bool parseString();
+    bool parseDirective( CLangDirective::ConstPtr * result );
+    bool parseToken( CLangToken::ConstPtr * result );
+    bool parseInfoMessage( CLangMessage::ConstPtr * result );
 };
 
 /*-------------------------------------------------------------------*/
 /*!
 
  */
-CLangParser::CLangParser()
-    : M_impl( new Impl( *this ) )
+bool
+CLangParser::Impl::parse( const std::string & msg,
+                          CLangMessage::ConstPtr * result )
 {
+    M_pos = msg.data();
+    M_end = msg.data() + msg.size();
+    M_arena = std::make_shared< Arena >( ARENA_BLOCK_SIZE );
 
-}
+    const bool matched = parseInfoMessage( result );
 
-/*-------------------------------------------------------------------*/
-/*!
+    // trailing characters are not allowed. the skipper is not applied here.
+    const bool full = ( matched && M_pos == M_end );
 
- */
-CLangParser::~CLangParser()
-{
+    // the tree objects keep the arena alive.
+    clear();
 
+    return full;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
-
- */
-void
-CLangParser::clear()
-{
-    M_impl->clear();
-    M_message.reset();
-}
-
-/*-------------------------------------------------------------------*/
-/*!
-
+  int: [+-]?[0-9]+
+  unum: [0-9]+
  */
 bool
-CLangParser::parse( const std::string & msg )
+CLangParser::Impl::parseInt( const bool allow_sign,
+                             int * value )
 {
-    clear();
+    skipSpace();
 
-    bsc::parse_info<> info = bsc::parse( msg.c_str(), *M_impl, bsc::space_p );
+    const char * p = M_pos;
+    bool negative = false;
+    if ( allow_sign
+         && p != M_end
+         && ( *p == '+' || *p == '-' ) )
+    {
+        negative = ( *p == '-' );
+        ++p;
+    }
 
-    return info.full;
-}
+    if ( p == M_end
+         || ! std::isdigit( static_cast< unsigned char >( *p ) ) )
+    {
+        return false;
+    }
 
-/*-------------------------------------------------------------------*/
-/*!
+    long long v = 0;
+    while ( p != M_end
+            && std::isdigit( static_cast< unsigned char >( *p ) ) )
+    {
+        v = v * 10 + ( *p - '0' );
+        if ( v > static_cast< long long >( std::numeric_limits< int >::max() ) + 1 )
+        {
+            return false; // overflow
+        }
+        ++p;
+    }
 
- */
-bool
-CLangParser::handleString( const char * first,
-                           const char * last )
-{
-    M_impl->pushStringValue( Item::STRING,
-                             new std::string( first + 1, last - 1 ) );
-    return true;
-}
+    if ( negative ) v = -v;
 
-/*-------------------------------------------------------------------*/
-/*!
+    if ( v < std::numeric_limits< int >::min()
+         || std::numeric_limits< int >::max() < v )
+    {
+        return false;
+    }
 
- */
-bool
-CLangParser::handleVariable( const char * first,
-                             const char * last )
-{
-    M_impl->pushStringValue( Item::VARIABLE,
-                             new std::string( first, last ) );
+    *value = static_cast< int >( v );
+    M_pos = p;
     return true;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
-
+  unum_set: '{' unum* '}'
  */
 bool
-CLangParser::handleUnum( const int unum )
+CLangParser::Impl::parseUnumSet( CLangUnumSet::Ptr * result )
 {
-    M_impl->pushIntValue( Item::UNUM, unum );
-    return true;
-}
+    const char * start = M_pos;
 
-/*-------------------------------------------------------------------*/
-/*!
+    if ( ! parseChar( '{' ) )
+    {
+        return false;
+    }
 
- */
-bool
-CLangParser::handleUnumSet()
-{
-    CLangUnumSet * uset = new CLangUnumSet();
+    CLangUnumSet::Ptr uset = create< CLangUnumSet >();
 
-    int unum = -1;
-    while ( M_impl->popIntValue( Item::UNUM, &unum ) )
+    int unum = 0;
+    while ( parseInt( false, &unum ) )
     {
         uset->add( unum );
     }
 
-    M_impl->pushUnumSet( uset );
+    if ( ! parseChar( '}' ) )
+    {
+        M_pos = start;
+        return false;
+    }
 
+    *result = uset;
     return true;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
-
+  condition: '(' "true" ')' | '(' "false" ')'
  */
 bool
-CLangParser::handleConditionBool( bool value )
+CLangParser::Impl::parseCondition( CLangCondition::Ptr * result )
 {
-    M_impl->pushCondition( new CLangConditionBool( value ) );
-    return true;
-}
+    const char * start = M_pos;
 
-/*-------------------------------------------------------------------*/
-/*!
+    if ( ! parseChar( '(' ) )
+    {
+        return false;
+    }
 
- */
-bool
-CLangParser::handlePositive( bool on )
-{
-    M_impl->pushBoolValue( Item::POSITIVE, on );
-    return true;
-}
+    bool value = false;
+    if ( parseLiteral( "true" ) )
+    {
+        value = true;
+    }
+    else if ( ! parseLiteral( "false" ) )
+    {
+        M_pos = start;
+        return false;
+    }
 
-/*-------------------------------------------------------------------*/
-/*!
+    if ( ! parseChar( ')' ) )
+    {
+        M_pos = start;
+        return false;
+    }
 
- */
-bool
-CLangParser::handleTeam( bool our )
-{
-    //std::cout << "handleTeam " << ( our ? "our" : "opp" ) << std::endl;
-    M_impl->pushBoolValue( Item::TEAM_OUR, our );
+    *result = create< CLangConditionBool >( value );
     return true;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
-
+  action: '(' "mark" unum_set ')'
+        | '(' "htype" int ')'
+        | '(' "hold" ')'
+        | '(' "bto" unum_set ')'
  */
 bool
-CLangParser::handleActMark()
+CLangParser::Impl::parseAction( CLangAction::ConstPtr * result )
 {
-    CLangUnumSet * uset = M_impl->popUnumSet();
-    if ( ! uset )
+    const char * start = M_pos;
+
+    if ( ! parseChar( '(' ) )
     {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleActMark) could not get unum set from the stack."
-                  << std::endl;
         return false;
     }
 
-    CLangActionMark * act = new CLangActionMark( uset );
-    M_impl->pushAction( act );
-    return true;
-}
-
-/*-------------------------------------------------------------------*/
-/*!
+    CLangAction::ConstPtr act;
+    CLangUnumSet::Ptr uset;
+    int type = 0;
 
- */
-bool
-CLangParser::handleActHeteroTypeId( const int type )
-{
-    M_impl->pushIntValue( Item::HETERO_TYPE, type );
-    return true;
-}
-
-/*-------------------------------------------------------------------*/
-/*!
+    if ( parseLiteral( "mark" ) )
+    {
+        if ( parseUnumSet( &uset ) )
+        {
+            act = create< CLangActionMark >( uset );
+        }
+    }
+    else if ( parseLiteral( "htype" ) )
+    {
+        if ( parseInt( true, &type ) )
+        {
+            act = create< CLangActionHeteroType >( type );
+        }
+    }
+    else if ( parseLiteral( "hold" ) )
+    {
+        act = create< CLangActionHold >();
+    }
+    else if ( parseLiteral( "bto" ) )
+    {
+        if ( parseUnumSet( &uset ) )
+        {
+            act = create< CLangActionBallTo >( uset );
+        }
+    }
 
- */
-bool
-CLangParser::handleActHeteroType()
-{
-    int type = -1000;
-    if ( ! M_impl->popIntValue( Item::HETERO_TYPE, &type ) )
+    if ( ! act
+         || ! parseChar( ')' ) )
     {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleActHeteroType) could not get hetero type from the stack."
-                  << std::endl;
+        M_pos = start;
         return false;
     }
 
-    CLangActionHeteroType * act = new CLangActionHeteroType( type );
-    M_impl->pushAction( act );
+    *result = act;
     return true;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
-
+  str: '"' [0-9A-Za-z().+-*\/?<>_ ]* '"'
  */
 bool
-CLangParser::handleActHold()
+CLangParser::Impl::parseString()
 {
-    CLangActionHold * act = new CLangActionHold();
-    M_impl->pushAction( act );
-    return true;
-}
+    const char * start = M_pos;
 
-/*-------------------------------------------------------------------*/
-/*!
+    if ( ! parseChar( '"' ) )
+    {
+        return false;
+    }
 
- */
-bool
-CLangParser::handleActBallTo()
-{
-    CLangUnumSet * uset = M_impl->popUnumSet();
-    if ( ! uset )
+    while ( M_pos != M_end
+            && ( std::isalnum( static_cast< unsigned char >( *M_pos ) )
+                 || std::isspace( static_cast< unsigned char >( *M_pos ) )
+                 || std::strchr( "().+-*/?<>_", *M_pos ) ) )
     {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleActMark) could not get unum set from the stack."
-                  << std::endl;
+        ++M_pos;
+    }
+
+    if ( ! parseChar( '"' ) )
+    {
+        M_pos = start;
         return false;
     }
 
-    CLangActionBallTo * act = new CLangActionBallTo( uset );
-    M_impl->pushAction( act );
     return true;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
-
+  directive: '(' ( "dont" | "do" ) ( "our" | "opp" ) unum_set action* ')'
+           | str
  */
 bool
-CLangParser::handleDirectiveCommon()
+CLangParser::Impl::parseDirective( CLangDirective::ConstPtr * result )
 {
-    CLangDirectiveCommon * dir = new CLangDirectiveCommon();
+    const char * start = M_pos;
 
-    // actions
-    while ( CLangAction * act = M_impl->popAction() )
+    if ( parseString() )
     {
-        dir->addAction( act );
+        std::cerr << __FILE__ << ' ' << __LINE__
+                  << ": (parseDirective) named directive is not supported."
+                  << std::endl;
+        result->reset();
+        return true;
     }
 
-    if ( dir->actions().empty() )
+    if ( ! parseChar( '(' ) )
     {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleDirectiveCommon) empty action."
-                  << std::endl;
-        delete dir;
         return false;
     }
 
-    // unum_set
-    CLangUnumSet * uset = M_impl->popUnumSet();
-    if ( ! uset )
+    bool positive = false;
+    if ( parseLiteral( "dont" ) )
     {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleDirectiveCommon) could not get unum set."
-                  << std::endl;
-        delete dir;
+        positive = false;
+    }
+    else if ( parseLiteral( "do" ) )
+    {
+        positive = true;
+    }
+    else
+    {
+        M_pos = start;
         return false;
     }
-    dir->setPlayers( uset );
 
-    // team
     bool our = false;
-    if ( ! M_impl->popBoolValue( Item::TEAM_OUR, &our ) )
+    if ( parseLiteral( "our" ) )
     {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleDirectiveCommon) could not get team."
-                  << std::endl;
-        delete dir;
+        our = true;
+    }
+    else if ( ! parseLiteral( "opp" ) )
+    {
+        M_pos = start;
         return false;
     }
-    dir->setOur( our );
 
-    // do,dont
-    bool positive = false;
-    if ( ! M_impl->popBoolValue( Item::POSITIVE, &positive ) )
+    CLangUnumSet::Ptr uset;
+    if ( ! parseUnumSet( &uset ) )
+    {
+        M_pos = start;
+        return false;
+    }
+
+    M_actions.clear();
+    CLangAction::ConstPtr act;
+    while ( parseAction( &act ) )
+    {
+        M_actions.push_back( act );
+    }
+
+    if ( ! parseChar( ')' ) )
+    {
+        M_pos = start;
+        return false;
+    }
+
+    if ( M_actions.empty() )
     {
         std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleDirectiveCommon) could not get do_dont."
+                  << ": (parseDirective) empty action."
                   << std::endl;
-        delete dir;
-        return false;
+        result->reset();
+        return true;
     }
+
+    std::shared_ptr< CLangDirectiveCommon > dir = create< CLangDirectiveCommon >();
     dir->setPositive( positive );
+    dir->setOur( our );
+    dir->setPlayers( uset );
 
-    M_impl->pushDirective( dir );
+    // same order as the previous stack based parser
+    for ( std::vector< CLangAction::ConstPtr >::reverse_iterator it = M_actions.rbegin(), end = M_actions.rend();
+          it != end;
+          ++it )
+    {
+        dir->addAction( *it );
+    }
+
+    *result = dir;
     return true;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
-
+  token: '(' int condition directive* ')'
+       | '(' "clear" ')'
  */
 bool
-CLangParser::handleDirectiveNamed()
+CLangParser::Impl::parseToken( CLangToken::ConstPtr * result )
 {
-    std::cout << "handleDirectiveNamed " << std::endl;
-    return true;
-}
+    const char * start = M_pos;
 
-/*-------------------------------------------------------------------*/
-/*!
+    if ( ! parseChar( '(' ) )
+    {
+        return false;
+    }
 
- */
-bool
-CLangParser::handleTokenTTL( int ttl )
-{
-    M_impl->pushIntValue( Item::TTL, ttl );
+    int ttl = 0;
+    if ( ! parseInt( true, &ttl ) )
+    {
+        if ( parseLiteral( "clear" )
+             && parseChar( ')' ) )
+        {
+            *result = create< CLangTokenClear >();
+            return true;
+        }
+
+        M_pos = start;
+        return false;
+    }
+
+    CLangCondition::Ptr cond;
+    if ( ! parseCondition( &cond ) )
+    {
+        M_pos = start;
+        return false;
+    }
+
+    M_directives.clear();
+    CLangDirective::ConstPtr dir;
+    while ( parseDirective( &dir ) )
+    {
+        if ( dir )
+        {
+            M_directives.push_back( dir );
+        }
+    }
+
+    if ( ! parseChar( ')' ) )
+    {
+        M_pos = start;
+        return false;
+    }
+
+    if ( M_directives.empty() )
+    {
+        std::cerr << __FILE__ << ' ' << __LINE__
+                  << ": (parseToken) empty directive." << std::endl;
+        result->reset();
+        return true;
+    }
+
+    std::shared_ptr< CLangTokenRule > tok = create< CLangTokenRule >( ttl );
+    tok->setCondition( cond );
+
+    for ( std::vector< CLangDirective::ConstPtr >::reverse_iterator it = M_directives.rbegin(), end = M_directives.rend();
+          it != end;
+          ++it )
+    {
+        tok->addDirective( *it );
+    }
+
+    *result = tok;
     return true;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
-
+  info_message: '(' "info" token* ')'
  */
 bool
-CLangParser::handleTokenRule()
+CLangParser::Impl::parseInfoMessage( CLangMessage::ConstPtr * result )
 {
-    CLangTokenRule * tok = new CLangTokenRule();
+    const char * start = M_pos;
 
-    // directives
-    while ( CLangDirective * dir = M_impl->popDirective() )
+    if ( ! parseChar( '(' )
+         || ! parseLiteral( "info" ) )
     {
-        tok->addDirective( dir );
+        M_pos = start;
+        return false;
     }
 
-    if ( tok->directives().empty() )
+    M_tokens.clear();
+    CLangToken::ConstPtr tok;
+    while ( parseToken( &tok ) )
     {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleTokenRule) empty directive." << std::endl;
-        delete tok;
-        return false;
+        if ( tok )
+        {
+            M_tokens.push_back( tok );
+        }
     }
 
-    // condition
-    CLangCondition * cond = M_impl->popCondition();
-    if ( ! cond )
+    if ( ! parseChar( ')' ) )
     {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleTokenRule) could not get the condition."
-                  << std::endl;
-        delete tok;
+        M_pos = start;
         return false;
     }
-    tok->setCondition( cond );
 
-    // ttl
-    int ttl = -1;
-    if ( ! M_impl->popIntValue( Item::TTL, &ttl ) )
+    std::shared_ptr< CLangInfoMessage > info = create< CLangInfoMessage >();
+    for ( std::vector< CLangToken::ConstPtr >::reverse_iterator it = M_tokens.rbegin(), end = M_tokens.rend();
+          it != end;
+          ++it )
     {
-        delete tok;
-        return false;
+        info->addToken( *it );
     }
-    tok->setTTL( ttl );
 
-    M_impl->pushToken( tok );
+    *result = info;
     return true;
 }
 
@@ -1000,41 +659,42 @@ CLangParser::handleTokenRule()
 /*!
 
  */
-bool
-CLangParser::handleTokenClear()
+CLangParser::CLangParser()
+    : M_impl( new Impl() )
 {
-    CLangTokenClear * tok = new CLangTokenClear();
 
-    M_impl->pushToken( tok );
-    return true;
 }
 
 /*-------------------------------------------------------------------*/
 /*!
 
  */
-bool
-CLangParser::handleInfoMessage()
+CLangParser::~CLangParser()
 {
-    CLangInfoMessage * info = new CLangInfoMessage();
 
-    //std::cerr << "handleInfoMessage" << std::endl;
-    while ( CLangToken * tok = M_impl->popToken() )
-    {
-        info->addToken( tok );
-    }
+}
 
-    M_message = CLangMessage::ConstPtr( info );
+/*-------------------------------------------------------------------*/
+/*!
 
-    if ( ! M_impl->stackIsEmpty() )
-    {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": (handleInfoMessage) ERROR stack is not empty."
-                  << std::endl;
-        return false;
-    }
+ */
+void
+CLangParser::clear()
+{
+    M_impl->clear();
+    M_message.reset();
+}
 
-    return true;
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CLangParser::parse( const std::string & msg )
+{
+    clear();
+
+    return M_impl->parse( msg, &M_message );
 }
 
 }
@@ -42,6 +42,10 @@ namespace rcsc {
 /*!
   \class CLangParser
   \brief clang message parser
+
+  Hand-written recursive descent parser for coach_lang_grammer.txt.
+  The message tree is allocated in an arena that is released when the
+  last object of the tree is released.
  */
 class CLangParser {
 private:
@@ -88,129 +92,6 @@ public:
       {
           return M_message;
       }
-
-private:
-
-    /*!
-      \brief semantic action for clang string.
-      \param first the first point of parsed string
-      \param last the last point of parsed string
-      \return action result.
-     */
-    bool handleString( const char * first,
-                       const char * last );
-
-    /*!
-      \brief semantic action for clang variable.
-      \param first the first point of parsed string
-      \param last the last point of parsed string
-      \return action result.
-     */
-    bool handleVariable( const char * first,
-                         const char * last );
-
-    /*!
-      \brief semantic action for uniform number.
-      \param unum parsed uniform number.
-      \return action result.
-     */
-    bool handleUnum( const int unum );
-
-    /*!
-      \brief semantic action for unum_set
-      \return action result.
-     */
-    bool handleUnumSet();
-
-
-    /*!
-      \brief semantic action for boolean condition.
-      \param value parsed value.
-      \return action result.
-     */
-    bool handleConditionBool( bool value );
-
-    /*!
-      \brief semantic action for do/dont
-      \param on do/dont flag
-      \return action result.
-     */
-    bool handlePositive( bool on );
-
-    /*!
-      \brief semantic action for our/opp
-      \param our our/opp flag
-      \return action result.
-     */
-    bool handleTeam( bool our );
-
-    /*!
-      \brief semantic action for mark action
-      \return action result.
-     */
-    bool handleActMark();
-
-    /*!
-      \brief semantic action for hetero type
-      \param type player type id
-      \return action result.
-     */
-    bool handleActHeteroTypeId( const int type );
-
-    /*!
-      \brief semantic action for htype action
-      \return action result.
-     */
-    bool handleActHeteroType();
-
-    /*!
-      \brief semantic action for hold action
-      \return action result.
-     */
-    bool handleActHold();
-
-    /*!
-      \brief semantic action for bto action
-      \return action result.
-     */
-    bool handleActBallTo();
-
-    /*!
-      \brief semantic action for normal directive.
-      \return action result.
-     */
-    bool handleDirectiveCommon();
-
-    /*!
-      \brief semantic action for named directive.
-      \return action result.
-     */
-    bool handleDirectiveNamed();
-
-    /*!
-      \brief semantic action for token's ttl value.
-      \param ttl time to live value.
-      \return action result.
-     */
-    bool handleTokenTTL( int ttl );
-
-    /*!
-      \brief semantic action for rule token.
-      \return action result.
-     */
-    bool handleTokenRule();
-
-    /*!
-      \brief semantic action for clear token.
-      \return action result.
-     */
-    bool handleTokenClear();
-
-    /*!
-      \brief semantic action for info message.
-      \return action result.
-     */
-    bool handleInfoMessage();
 };
 
 }
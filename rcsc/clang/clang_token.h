@@ -180,6 +180,15 @@ public:
           M_condition = CLangCondition::Ptr( cond );
       }
 
+    /*!
+      \brief set rule condition
+      \param cond shared condition object
+     */
+    void setCondition( const CLangCondition::Ptr & cond )
+      {
+          M_condition = cond;
+      }
+
     /*!
       \brief add directive to this rule
       \param dir new directive object pointer
@@ -189,6 +198,15 @@ public:
           M_directives.push_back( CLangDirective::ConstPtr( dir ) );
       }
 
+    /*!
+      \brief add directive to this rule
+      \param dir shared directive object
+     */
+    void addDirective( const CLangDirective::ConstPtr & dir )
+      {
+          M_directives.push_back( dir );
+      }
+
     /*!
       \brief get TTL value
       \return TTL value
@@ -42,6 +42,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <iostream>
+#include <sstream>
 #include <cmath>
 
 /*!
@@ -52,6 +53,8 @@ class CLangParserTest
 
     CPPUNIT_TEST_SUITE( CLangParserTest );
     CPPUNIT_TEST( testInfoMessage );
+    CPPUNIT_TEST( testCorpus );
+    CPPUNIT_TEST( testBench );
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -62,6 +65,8 @@ public:
 protected:
 
     void testInfoMessage();
+    void testCorpus();
+    void testBench();
 };
 
 
@@ -130,7 +135,7 @@ CLangParserTest::testInfoMessage()
         }
 
         std::cout << "parsed tokens:\n";
-        for ( const rcsc::CLangToken & tok = info->tokens() )
+        for ( const rcsc::CLangToken::ConstPtr & tok : info->tokens() )
         {
             std::cout << "    " << *tok << std::endl;
         }
@@ -141,6 +146,98 @@ CLangParserTest::testInfoMessage()
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CLangParserTest::testCorpus()
+{
+    struct Sample {
+        const char * msg_;
+        bool result_;
+        const char * printed_; // NULL means no message
+    };
+
+    // the element order is same as the previous stack based parser
+    const Sample samples[] = {
+        { "(info (6000 (true) (do our {1} (mark {2 3}))))",
+          true, "(info (6000 (true) (do our {1} (mark {2 3}))))" },
+        { "(info (6000 (true) (do opp {1} (htype 1)))(0 (true) (do opp {2} (htype 2))))",
+          true, "(info (0 (true) (do opp {2} (htype 2)))(6000 (true) (do opp {1} (htype 1))))" },
+        { "(info (6000 (true) (do opp {1} (htype 1))(do opp {2} (htype 2))(do our {1} (mark {2 3}))))",
+          true, "(info (6000 (true) (do our {1} (mark {2 3})) (do opp {2} (htype 2)) (do opp {1} (htype 1))))" },
+        { "  (info  ( 100 ( false ) ( do our { 3 1 2 } ( hold ) ( bto { 5 } ) ( mark { } ) ) ) (clear) )",
+          true, "(info (clear)(100 (false) (do our {1 2 3} (mark {}) (bto {5}) (hold))))" },
+        { "(info (clear) (20 (true) (dont opp {0} (bto {1 2}) (hold))))",
+          true, "(info (20 (true) (dont opp {0} (hold) (bto {1 2})))(clear))" },
+        { "(info (+10 (true) (do our {1} (htype +3))))",
+          true, "(info (10 (true) (do our {1} (htype 3))))" },
+        { "(info)", true, "(info )" },
+        // trailing characters
+        { "(info (clear)) ", false, "(info (clear))" },
+        { "(info (10 (true) (do our {1} (hold)))) x", false, "(info (10 (true) (do our {1} (hold))))" },
+        // syntax errors
+        { "(info (clear)", false, nullptr },
+        { "(info (10 (true) (do our {1} (kick))))", false, nullptr },
+        { "(info (10 (maybe) (do our {1} (hold))))", false, nullptr },
+        { "(info (10 (true) (do our {-1} (hold))))", false, nullptr },
+        { "(info (99999999999 (true) (do our {1} (hold))))", false, nullptr },
+        { "(advice (10 (true) (do our {1} (hold))))", false, nullptr },
+    };
+
+    rcsc::CLangParser parser;
+
+    for ( const Sample & s : samples )
+    {
+        CPPUNIT_ASSERT_MESSAGE( s.msg_, s.result_ == parser.parse( s.msg_ ) );
+
+        if ( ! s.printed_ )
+        {
+            CPPUNIT_ASSERT_MESSAGE( s.msg_, ! parser.message() );
+            continue;
+        }
+
+        CPPUNIT_ASSERT_MESSAGE( s.msg_, parser.message() );
+        std::ostringstream os;
+        os << *parser.message();
+        CPPUNIT_ASSERT_EQUAL( std::string( s.printed_ ), os.str() );
+    }
+
+    // the message tree is still valid after the parser is reused.
+    CPPUNIT_ASSERT( parser.parse( samples[0].msg_ ) );
+    rcsc::CLangMessage::ConstPtr first = parser.message();
+    CPPUNIT_ASSERT( parser.parse( samples[1].msg_ ) );
+    parser.clear();
+    std::ostringstream os;
+    os << *first;
+    CPPUNIT_ASSERT_EQUAL( std::string( samples[0].printed_ ), os.str() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CLangParserTest::testBench()
+{
+    const std::string msg = "(info (6000 (true) (dont our {1} (mark {0})) (dont our {2} (mark {0})) (dont our {3} (mark {0})) (dont our {4} (mark {0})) (dont our {5} (mark {0})) (dont our {6} (mark {0})) (dont our {7} (mark {0})) (dont our {8} (mark {0})) (dont our {9} (mark {0})) (dont our {10} (mark {0})) (dont our {11} (mark {0}))))";
+    const int n_loop = 20000;
+
+    rcsc::CLangParser parser;
+    int n_success = 0;
+
+    rcsc::Timer timer;
+    for ( int i = 0; i < n_loop; ++i )
+    {
+        if ( parser.parse( msg ) ) ++n_success;
+    }
+    const double msec = timer.elapsedReal();
+
+    CPPUNIT_ASSERT_EQUAL( n_loop, n_success );
+    std::cout << "\n  " << n_loop << " messages: " << msec << " [ms] "
+              << ( msec > 0.0 ? n_loop * 1000.0 / msec : 0.0 ) << " [msg/sec]" << std::endl;
+}
 
 /*-------------------------------------------------------------------*/
 /*-------------------------------------------------------------------*/
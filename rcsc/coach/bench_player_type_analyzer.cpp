@@ -0,0 +1,104 @@
+// -*-c++-*-
+
+/*!
+  \file bench_player_type_analyzer.cpp
+  \brief replay benchmark for rcsc::PlayerTypeAnalyzer
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "player_type_analyzer.h"
+#include "coach_world_model.h"
+
+#include "player_type_replay.h"
+
+#include <rcsc/time/timer.h>
+
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+main( int argc, char ** argv )
+{
+    const int max_cycle = ( argc > 1 ? std::max( 1, std::atoi( argv[1] ) ) : 6000 );
+
+    setup_player_types();
+
+    int true_types[11];
+    const std::vector< rcsc::rcg::DispInfoT > log = create_replay_log( max_cycle, true_types );
+
+    rcsc::CoachWorldModel wm;
+    wm.init( "left", rcsc::LEFT, 18 );
+
+    rcsc::PlayerTypeAnalyzer analyzer( wm );
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        analyzer.reset( unum );
+    }
+
+    rcsc::Timer timer;
+    for ( const rcsc::rcg::DispInfoT & disp : log )
+    {
+        wm.updateAll( disp );
+        analyzer.update();
+    }
+    const double elapsed = timer.elapsedReal();
+
+    int determined = 0;
+    int wrong = 0;
+    long total_cycles = 0;
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        const int type = analyzer.playerTypeId( unum );
+        if ( type == rcsc::Hetero_Unknown )
+        {
+            continue;
+        }
+
+        if ( type != true_types[unum - 1] )
+        {
+            ++wrong;
+        }
+        ++determined;
+        total_cycles += analyzer.determinedTime( unum ).cycle();
+    }
+
+    std::cout << "replay " << max_cycle << " cycles elapsed " << elapsed << " [ms]"
+              << " (" << max_cycle / std::max( elapsed, 1.0e-3 ) * 1000.0 << " cycles/sec)"
+              << "\ndetermined " << determined << "/11 players"
+              << " (" << wrong << " wrong)"
+              << " mean time to identification " << ( determined > 0 ? total_cycles / determined : -1 )
+              << " cycles"
+              << "\ntype checks " << analyzer.checkCount() << std::endl;
+
+    return ( wrong == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
@@ -60,6 +60,7 @@
 #include <rcsc/timer.h>
 #include <rcsc/version.h>
 
+#include <algorithm>
 #include <sstream>
 #include <cstring>
 
@@ -679,7 +680,7 @@ CoachAgent::handleTimeout( const int timeout_count,
         return;
     }
 
-    TimeStamp cur_time;
+    const TimeStamp cur_time = TimeStamp::now();
 
     std::int64_t msec_from_see = -1;
     if ( M_impl->see_time_stamp_.isValid() )
@@ -1096,6 +1097,7 @@ CoachAgent::Impl::analyzeInit( const char * msg )
                        ? LEFT
                        : RIGHT );
     agent_.M_worldmodel.init( agent_.config().teamName(), side_id, agent_.config().version() );
+    agent_.M_worldmodel.setStateHistoryCapacity( std::max( 1, agent_.config().stateHistoryCapacity() ) );
 
     if ( agent_.config().hearSay() )
     {
@@ -89,6 +89,8 @@ CoachConfig::setDefaultParam()
 
     M_analyze_player_type = true;
 
+    M_state_history_capacity = 60000;
+
     M_use_advise = true;
     M_use_freeform = true;
 
@@ -179,6 +181,8 @@ CoachConfig::createParamMap()
 
         ( "analyze_player_type", "", &M_analyze_player_type )
 
+        ( "state_history_capacity", "", &M_state_history_capacity )
+
         ( "use_advise", "", &M_use_advise )
         ( "use_freeform", "", &M_use_freeform )
 
@@ -84,6 +84,9 @@ private:
     //! if true, coach will try to analyze opponent team players' player type
     bool M_analyze_player_type;
 
+    //! the number of world state snapshots stored by the world model
+    int M_state_history_capacity;
+
     //! if true, coach send advise
     bool M_use_advise;
     //! if true, coach send freeform message
@@ -277,6 +280,12 @@ public:
      */
     bool analyzePlayerType() const { return M_analyze_player_type; }
 
+    /*!
+      \brief get the size of the world state history. one snapshot takes about 930 bytes.
+      \return the number of snapshots
+     */
+    int stateHistoryCapacity() const { return M_state_history_capacity; }
+
     /*!
       \brief get the advise mode
       \return true if coach tries to advise to players.
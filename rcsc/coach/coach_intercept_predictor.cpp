@@ -41,15 +41,133 @@
 #include <rcsc/common/server_param.h>
 #include <rcsc/common/player_type.h>
 #include <rcsc/common/logger.h>
-#include <rcsc/geom/vector_2d.h>
+
+#include <algorithm>
+#include <utility>
+#include <cmath>
 
 namespace rcsc {
 
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the inertia travel factor table for the decay value.
+  table[n] is same as the factor used by inertia_n_step_travel().
+ */
+const double *
+inertia_factor_table( const double decay )
+{
+    thread_local std::vector< std::pair< double, std::vector< double > > > s_tables;
+
+    for ( const std::pair< double, std::vector< double > > & t : s_tables )
+    {
+        if ( t.first == decay )
+        {
+            return t.second.data();
+        }
+    }
+
+    std::vector< double > table( CoachInterceptPredictor::MAX_STEP + 1 );
+    for ( int n = 0; n <= CoachInterceptPredictor::MAX_STEP; ++n )
+    {
+        table[n] = ( 1.0 - std::pow( decay, n ) ) / ( 1.0 - decay );
+    }
+
+    s_tables.emplace_back( decay, std::move( table ) );
+    return s_tables.back().second.data();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the remaining penalty cycles of the player
+ */
+inline
+int
+penalty_step( const CoachPlayerObject & player )
+{
+    const ServerParam & SP = ServerParam::i();
+    return ( player.isTackling()
+             ? std::max( 0, SP.tackleCycles() - player.tackleCycle() )
+             : player.isCharged()
+             ? std::max( 0, SP.foulCycles() - player.chargedCycle() )
+             : 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief same as PlayerType::inertiaPoint() with the precomputed factor
+ */
+inline
+Vector2D
+inertia_point( const Vector2D & pos,
+               const Vector2D & vel,
+               const int n_step,
+               const double * factor,
+               const PlayerType & ptype )
+{
+    if ( n_step < 0 || CoachInterceptPredictor::MAX_STEP < n_step )
+    {
+        return ptype.inertiaPoint( pos, vel, n_step );
+    }
+
+    return Vector2D( pos.x + vel.x * factor[n_step],
+                     pos.y + vel.y * factor[n_step] );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+CoachInterceptPredictor::CoachInterceptPredictor()
+    : M_line_cos( 1.0 ),
+      M_line_sin( 0.0 )
+{
+    M_ball_cache.reserve( MAX_STEP );
+    reservePlayers();
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
 */
 CoachInterceptPredictor::CoachInterceptPredictor( const CoachBallObject & ball )
+    : M_line_cos( 1.0 ),
+      M_line_sin( 0.0 )
+{
+    M_ball_cache.reserve( MAX_STEP );
+    reservePlayers();
+    setBall( ball.pos(), ball.vel() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+CoachInterceptPredictor::reservePlayers()
+{
+    M_pos_x.reserve( 22 );
+    M_pos_y.reserve( 22 );
+    M_vel_x.reserve( 22 );
+    M_vel_y.reserve( 22 );
+    M_speed.reserve( 22 );
+    M_body.reserve( 22 );
+    M_ptype.reserve( 22 );
+    M_inertia_factor.reserve( 22 );
+    M_penalty_step.reserve( 22 );
+    M_goalie.reserve( 22 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+CoachInterceptPredictor::setBall( const Vector2D & ball_pos,
+                                  const Vector2D & ball_vel )
 {
     const ServerParam & SP = ServerParam::i();
     const double max_x = ( SP.keepawayMode()
@@ -60,11 +178,13 @@ CoachInterceptPredictor::CoachInterceptPredictor( const CoachBallObject & ball )
                            : SP.pitchHalfWidth() + 5.0 );
     const double bdecay = SP.ballDecay();
 
-    Vector2D bpos = ball.pos();
-    Vector2D bvel = ball.vel();
+    Vector2D bpos = ball_pos;
+    Vector2D bvel = ball_vel;
     double bspeed = bvel.r();
 
-    for ( int i = 0; i < 100; ++i )
+    M_ball_cache.clear();
+
+    for ( int i = 0; i < MAX_STEP; ++i )
     {
         M_ball_cache.push_back( bpos );
 
@@ -83,6 +203,14 @@ CoachInterceptPredictor::CoachInterceptPredictor( const CoachBallObject & ball )
             break;
         }
     }
+
+    // the players are projected onto the ball moving line.
+    // same as Vector2D::rotate( -move_angle )
+    const AngleDeg move_angle = ( M_ball_cache.back() - M_ball_cache.front() ).th();
+    const double deg = ( -move_angle ).degree();
+    M_line_cos = std::cos( deg * AngleDeg::DEG2RAD );
+    M_line_sin = std::sin( deg * AngleDeg::DEG2RAD );
+
 #ifdef DEBUG_PRINT
     dlog.addText( Logger::INTERCEPT,
                   "CoachInterceptPredict ball cache size=%d last pos=(%.2f %.2f)",
@@ -94,25 +222,184 @@ CoachInterceptPredictor::CoachInterceptPredictor( const CoachBallObject & ball )
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+void
+CoachInterceptPredictor::clearPlayers()
+{
+    M_pos_x.clear();
+    M_pos_y.clear();
+    M_vel_x.clear();
+    M_vel_y.clear();
+    M_speed.clear();
+    M_body.clear();
+    M_ptype.clear();
+    M_inertia_factor.clear();
+    M_penalty_step.clear();
+    M_goalie.clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+CoachInterceptPredictor::addPlayer( const CoachPlayerObject & player )
+{
+    const PlayerType * ptype = nullptr;
+    if ( player.isValid() )
+    {
+        ptype = ( player.playerTypePtr()
+                  ? player.playerTypePtr()
+                  : PlayerTypeSet::i().get( Hetero_Default ) );
+    }
+
+    M_pos_x.push_back( player.pos().x );
+    M_pos_y.push_back( player.pos().y );
+    M_vel_x.push_back( player.vel().x );
+    M_vel_y.push_back( player.vel().y );
+    M_speed.push_back( player.vel().r() );
+    M_body.push_back( player.body().degree() );
+    M_ptype.push_back( ptype );
+    M_inertia_factor.push_back( ptype ? inertia_factor_table( ptype->playerDecay() ) : nullptr );
+    M_penalty_step.push_back( penalty_step( player ) );
+    M_goalie.push_back( player.goalie() ? 1 : 0 );
+
+    return static_cast< int >( M_pos_x.size() ) - 1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 int
 CoachInterceptPredictor::predict( const CoachPlayerObject & player ) const
 {
-    if ( ! player.isValid() )
+    if ( ! player.isValid()
+         || M_ball_cache.empty() )
     {
         return -1;
     }
 
-    int step = predictReachStep( player, false );
+    Candidate c;
+    c.pos_ = player.pos();
+    c.vel_ = player.vel();
+    c.speed_ = player.vel().r();
+    c.body_ = player.body();
+    c.ptype_ = ( player.playerTypePtr()
+                 ? player.playerTypePtr()
+                 : PlayerTypeSet::i().get( Hetero_Default ) );
+    c.inertia_factor_ = inertia_factor_table( c.ptype_->playerDecay() );
+    c.penalty_step_ = penalty_step( player );
+    c.line_dist_ = std::fabs( ( c.pos_.x - M_ball_cache.front().x ) * M_line_sin
+                              + ( c.pos_.y - M_ball_cache.front().y ) * M_line_cos );
+
+    return predictCandidate( c, player.goalie() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+CoachInterceptPredictor::predictAll( std::vector< int > * steps ) const
+{
+    const int size = playerCount();
+
+    steps->assign( size, -1 );
+
+    if ( M_ball_cache.empty() )
+    {
+        return;
+    }
+
+    updateLineDistance();
 
-    if ( player.goalie() )
+    Candidate c;
+    for ( int i = 0; i < size; ++i )
     {
-        int goalie_step = predictReachStep( player, true );
+        if ( ! M_ptype[i] )
+        {
+            continue;
+        }
+
+        loadCandidate( i, &c );
+        (*steps)[i] = predictCandidate( c, M_goalie[i] != 0 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+CoachInterceptPredictor::predictAll( const Vector2D & ball_pos,
+                                     const Vector2D & ball_vel,
+                                     std::vector< int > * steps )
+{
+    setBall( ball_pos, ball_vel );
+    predictAll( steps );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+CoachInterceptPredictor::updateLineDistance() const
+{
+    const int size = playerCount();
+    const double bx = M_ball_cache.front().x;
+    const double by = M_ball_cache.front().y;
+    const double s = M_line_sin;
+    const double c = M_line_cos;
+
+    M_line_dist.resize( size );
+
+    const double * px = M_pos_x.data();
+    const double * py = M_pos_y.data();
+    double * dist = M_line_dist.data();
+
+    for ( int i = 0; i < size; ++i )
+    {
+        dist[i] = std::fabs( ( px[i] - bx ) * s + ( py[i] - by ) * c );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+CoachInterceptPredictor::loadCandidate( const int index,
+                                        Candidate * c ) const
+{
+    c->pos_.assign( M_pos_x[index], M_pos_y[index] );
+    c->vel_.assign( M_vel_x[index], M_vel_y[index] );
+    c->speed_ = M_speed[index];
+    c->body_ = M_body[index];
+    c->ptype_ = M_ptype[index];
+    c->inertia_factor_ = M_inertia_factor[index];
+    c->penalty_step_ = M_penalty_step[index];
+    c->line_dist_ = M_line_dist[index];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+CoachInterceptPredictor::predictCandidate( const Candidate & c,
+                                           const bool goalie ) const
+{
+    int step = predictReachStep( c, false );
+
+    if ( goalie )
+    {
+        int goalie_step = predictReachStep( c, true );
         step = std::min( step, goalie_step );
     }
 
     return step;
-
 }
 
 /*-------------------------------------------------------------------*/
@@ -120,26 +407,20 @@ CoachInterceptPredictor::predict( const CoachPlayerObject & player ) const
 
 */
 int
-CoachInterceptPredictor::predictReachStep( const CoachPlayerObject & player,
+CoachInterceptPredictor::predictReachStep( const Candidate & c,
                                            const bool goalie ) const
 {
     const ServerParam & SP = ServerParam::i();
-    const PlayerType * ptype = ( player.playerTypePtr()
-                                 ? player.playerTypePtr()
-                                 : PlayerTypeSet::i().get( Hetero_Default ) );
+    const PlayerType & ptype = *c.ptype_;
     const double pen_area_x = SP.pitchHalfLength() - SP.pitchHalfLength();
     const double pen_area_y = SP.penaltyAreaHalfWidth();
 
     const double control_area = ( goalie
-                                  ? ServerParam::i().catchableArea()
-                                  : ptype->kickableArea() );
-    const int penalty_step = ( player.isTackling()
-                               ? std::max( 0, SP.tackleCycles() - player.tackleCycle() )
-                               : player.isCharged()
-                               ? std::max( 0, SP.foulCycles() - player.chargedCycle() )
-                               : 0 );
-
-    const int min_step = predictMinStep( player, *ptype, control_area );
+                                  ? SP.catchableArea()
+                                  : ptype.kickableArea() );
+    const double speed_max = ptype.realSpeedMax();
+
+    const int min_step = predictMinStep( c, control_area );
     const int max_step = M_ball_cache.size() - 1;
 
     //
@@ -149,8 +430,8 @@ CoachInterceptPredictor::predictReachStep( const CoachPlayerObject & player,
     {
         const Vector2D & ball_pos = M_ball_cache[total_step];
 
-        if ( control_area + ptype->realSpeedMax() * ( total_step - penalty_step )
-             < player.pos().dist( ball_pos ) )
+        if ( control_area + speed_max * ( total_step - c.penalty_step_ )
+             < c.pos_.dist( ball_pos ) )
         {
             continue;
         }
@@ -169,8 +450,7 @@ CoachInterceptPredictor::predictReachStep( const CoachPlayerObject & player,
         }
 
         if ( canReachAfterTurnDash( total_step,
-                                    penalty_step,
-                                    player, *ptype, control_area,
+                                    c, control_area,
                                     ball_pos ) )
         {
             return total_step;
@@ -190,7 +470,7 @@ CoachInterceptPredictor::predictReachStep( const CoachPlayerObject & player,
         return -1;
     }
 
-    return predictFinal( penalty_step, player, *ptype, control_area );
+    return predictFinal( c, control_area );
 }
 
 /*-------------------------------------------------------------------*/
@@ -198,16 +478,11 @@ CoachInterceptPredictor::predictReachStep( const CoachPlayerObject & player,
 
  */
 int
-CoachInterceptPredictor::predictMinStep( const CoachPlayerObject & player,
-                                         const PlayerType & ptype,
+CoachInterceptPredictor::predictMinStep( const Candidate & c,
                                          const double control_area ) const
 {
-    Vector2D rel = player.pos() - M_ball_cache.front();
-    AngleDeg move_angle = ( M_ball_cache.back() - M_ball_cache.front() ).th();
-    rel.rotate( -move_angle );
-
-    double move_dist = rel.absY() - control_area;
-    return static_cast< int >( std::floor( move_dist / ptype.realSpeedMax() ) );
+    double move_dist = c.line_dist_ - control_area;
+    return std::max( 0, static_cast< int >( std::floor( move_dist / c.ptype_->realSpeedMax() ) ) );
 }
 
 /*-------------------------------------------------------------------*/
@@ -216,9 +491,7 @@ CoachInterceptPredictor::predictMinStep( const CoachPlayerObject & player,
  */
 bool
 CoachInterceptPredictor::canReachAfterTurnDash( const int total_step,
-                                                const int penalty_step,
-                                                const CoachPlayerObject & player,
-                                                const PlayerType & ptype,
+                                                const Candidate & c,
                                                 const double control_area,
                                                 const Vector2D & ball_pos ) const
 {
@@ -231,21 +504,59 @@ CoachInterceptPredictor::canReachAfterTurnDash( const int total_step,
       }
     */
 
+    const int dash_limit = total_step - c.penalty_step_;
+    if ( dash_limit < 0 )
+    {
+        return false;
+    }
+
+    // the player reaches the same inertia point after turns and dashes in total_step.
+    // the turn cycles only reduce the available dash steps, so the turn
+    // estimation can be skipped if the player cannot reach even without turns.
+    const PlayerType & ptype = *c.ptype_;
+    const Vector2D inertia_pos = inertia_point( c.pos_, c.vel_, total_step,
+                                                c.inertia_factor_, ptype );
+    const double dash_dist = inertia_pos.dist( ball_pos ) - control_area;
+    const int dash_step = ( dash_dist < 0.0
+                            ? 0
+                            : ptype.cyclesToReachDistance( dash_dist ) );
+    if ( dash_step > dash_limit )
+    {
+        return false;
+    }
 
-    int n_turn = predictTurnCycle( total_step,
-                                   penalty_step,
-                                   player, ptype, control_area,
-                                   ball_pos );
+    const int n_turn = predictTurnCycle( c, control_area, ball_pos, inertia_pos );
 
-    int max_dash = total_step - n_turn - penalty_step;
+    const int max_dash = dash_limit - n_turn;
     if ( max_dash < 0 )
     {
         return false;
     }
 
-    return canReachAfterDash( penalty_step, n_turn, max_dash,
-                              player, ptype, control_area,
-                              ball_pos );
+    if ( dash_dist < 0.0 )
+    {
+        // already kickable/catchable
+#ifdef DEBUG_PRINT
+        dlog.addText( Logger::INTERCEPT,
+                      "SUCCESS bpos=(%.2f %.2f) step=%d. kickable after inertia move.",
+                      ball_pos.x, ball_pos.y, total_step );
+#endif
+        return true;
+    }
+
+    if ( dash_step <= max_dash )
+    {
+#ifdef DEBUG_PRINT
+        dlog.addText( Logger::INTERCEPT,
+                      "SUCCESS bpos=(%.2f %.2f) step=%d (penalty=%d turn=%d dash=%d max_dash=%d)",
+                      ball_pos.x, ball_pos.y,
+                      c.penalty_step_ + n_turn + dash_step,
+                      c.penalty_step_, n_turn, dash_step, max_dash );
+#endif
+        return true;
+    }
+
+    return false;
 }
 
 /*-------------------------------------------------------------------*/
@@ -253,18 +564,16 @@ CoachInterceptPredictor::canReachAfterTurnDash( const int total_step,
 
  */
 int
-CoachInterceptPredictor::predictTurnCycle( const int total_step,
-                                           const int penalty_step,
-                                           const CoachPlayerObject & player,
-                                           const PlayerType & ptype,
+CoachInterceptPredictor::predictTurnCycle( const Candidate & c,
                                            const double control_area,
-                                           const Vector2D & ball_pos ) const
+                                           const Vector2D & ball_pos,
+                                           const Vector2D & inertia_pos ) const
 {
-    const Vector2D inertia_pos = ptype.inertiaPoint( player.pos(), player.vel(), total_step );
+    const PlayerType & ptype = *c.ptype_;
     const Vector2D target_rel = ball_pos - inertia_pos;
     const double target_dist = target_rel.r();
 
-    double angle_diff = ( target_rel.th() - player.body() ).abs();
+    double angle_diff = ( target_rel.th() - c.body_ ).abs();
 
     double turn_margin = 180.0;
     if ( control_area < target_dist )
@@ -283,10 +592,10 @@ CoachInterceptPredictor::predictTurnCycle( const int total_step,
 
     if ( angle_diff > turn_margin )
     {
-        double speed = player.vel().r();
+        double speed = c.speed_;
 
         // tackle/charge steps
-        speed *= std::pow( ptype.playerDecay(), penalty_step );
+        speed *= std::pow( ptype.playerDecay(), c.penalty_step_ );
 
         while ( angle_diff > turn_margin )
         {
@@ -300,85 +609,32 @@ CoachInterceptPredictor::predictTurnCycle( const int total_step,
     return n_turn;
 }
 
-
-/*-------------------------------------------------------------------*/
-/*!
-
- */
-bool
-CoachInterceptPredictor::canReachAfterDash( const int penalty_step,
-                                            const int n_turn,
-                                            const int n_dash,
-                                            const CoachPlayerObject & player,
-                                            const PlayerType & ptype,
-                                            const double control_area,
-                                            const Vector2D & ball_pos ) const
-{
-    Vector2D inertia_pos = ptype.inertiaPoint( player.pos(),
-                                               player.vel(),
-                                               penalty_step + n_turn + n_dash );
-    double dash_dist = inertia_pos.dist( ball_pos ) - control_area;
-
-    if ( dash_dist < 0.0 )
-    {
-        // already kickable/catchable
-#ifdef DEBUG_PRINT
-        dlog.addText( Logger::INTERCEPT,
-                      "SUCCESS bpos=(%.2f %.2f) step=%d. kickable after inertia move.",
-                      ball_pos.x, ball_pos.y,
-                      penalty_step + n_turn + n_dash );
-#endif
-        return true;
-    }
-
-    int dash_step = ptype.cyclesToReachDistance( dash_dist );
-
-    if ( dash_step <= n_dash )
-    {
-#ifdef DEBUG_PRINT
-        dlog.addText( Logger::INTERCEPT,
-                      "SUCCESS bpos=(%.2f %.2f) step=%d (penalty=%d turn=%d dash=%d max_dash=%d)",
-                      ball_pos.x, ball_pos.y,
-                      penalty_step + n_turn + dash_step,
-                      penalty_step, n_turn, dash_step, n_dash );
-#endif
-        return true;
-    }
-
-    return false;
-}
-
 /*-------------------------------------------------------------------*/
 /*!
 
  */
 int
-CoachInterceptPredictor::predictFinal( const int penalty_step,
-                                       const CoachPlayerObject & player,
-                                       const PlayerType & ptype,
+CoachInterceptPredictor::predictFinal( const Candidate & c,
                                        const double control_area ) const
 {
-
-    Vector2D inertia_pos = ptype.inertiaPoint( player.pos(),
-                                               player.vel(),
-                                               100 );
+    const PlayerType & ptype = *c.ptype_;
+    Vector2D inertia_pos = inertia_point( c.pos_, c.vel_, MAX_STEP,
+                                          c.inertia_factor_, ptype );
     double dash_dist = inertia_pos.dist( M_ball_cache.back() ) - control_area;
 
-    int n_turn = predictTurnCycle( 100,
-                                   penalty_step,
-                                   player,
-                                   ptype,
+    int n_turn = predictTurnCycle( c,
                                    control_area,
-                                   M_ball_cache.back() );
+                                   M_ball_cache.back(),
+                                   inertia_pos );
 
     int n_dash = ptype.cyclesToReachDistance( dash_dist );
 
-    int final_step = penalty_step + n_turn + n_dash;
+    int final_step = c.penalty_step_ + n_turn + n_dash;
 #ifdef DEBUG_PRINT
     dlog.addText( Logger::INTERCEPT,
                   "SUCCESS final. bpos=(%.2f %.2f) step=%d (penalty=%d turn=%d dash=%d)",
                   M_ball_cache.back().x, M_ball_cache.back().y,
-                  final_step, penalty_step, n_turn, n_dash );
+                  final_step, c.penalty_step_, n_turn, n_dash );
 #endif
     return final_step;
 }
@@ -32,6 +32,9 @@
 #ifndef RCSC_COACH_PLAYER_INTERCEPT_H
 #define RCSC_COACH_PLAYER_INTERCEPT_H
 
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/angle_deg.h>
+
 #include <vector>
 
 namespace rcsc {
@@ -39,24 +42,77 @@ namespace rcsc {
 class CoachBallObject;
 class CoachPlayerObject;
 class PlayerType;
-class Vector2D;
 
 /*!
   \class CoachInterceptPredictor
   \brief player intercept cycle predictor for coach
+
+  The ball position cache is created once for each ball state and
+  shared by all players.  Registered players are stored as a structure
+  of arrays, so that the same players can be evaluated for many
+  hypothetical ball states without touching the player objects again.
  */
 class CoachInterceptPredictor {
+public:
+
+    //! the maximum number of the ball cache steps
+    static const int MAX_STEP = 100;
+
 private:
 
+    /*!
+      \struct Candidate
+      \brief work data of one player evaluated by the predictor
+     */
+    struct Candidate {
+        Vector2D pos_; //!< player position
+        Vector2D vel_; //!< player velocity
+        double speed_; //!< player speed
+        AngleDeg body_; //!< player body angle
+        const PlayerType * ptype_; //!< player type
+        const double * inertia_factor_; //!< inertia travel factors [0, MAX_STEP]
+        int penalty_step_; //!< remaining tackle/foul cycles
+        double line_dist_; //!< distance from the ball moving line
+    };
+
+    //! ball position cache
     std::vector< Vector2D > M_ball_cache;
 
+    //! cosine of the negated ball move angle
+    double M_line_cos;
+    //! sine of the negated ball move angle
+    double M_line_sin;
+
+    //
+    // registered players (structure of arrays)
+    //
+
+    std::vector< double > M_pos_x; //!< player position x
+    std::vector< double > M_pos_y; //!< player position y
+    std::vector< double > M_vel_x; //!< player velocity x
+    std::vector< double > M_vel_y; //!< player velocity y
+    std::vector< double > M_speed; //!< player speed
+    std::vector< double > M_body; //!< player body angle [degree]
+    std::vector< const PlayerType * > M_ptype; //!< player type
+    std::vector< const double * > M_inertia_factor; //!< inertia travel factor table
+    std::vector< int > M_penalty_step; //!< remaining tackle/foul cycles
+    std::vector< unsigned char > M_goalie; //!< goalie flag
+
+    //! work area: distance from the ball moving line to each player
+    mutable std::vector< double > M_line_dist;
+
     // not used
-    CoachInterceptPredictor() = delete;
     CoachInterceptPredictor( const CoachInterceptPredictor & ) = delete;
     CoachInterceptPredictor & operator=( const CoachInterceptPredictor & ) = delete;
 
 public:
 
+    /*!
+      \brief create an empty predictor. setBall() has to be called
+      before the prediction.
+     */
+    CoachInterceptPredictor();
+
     /*!
       \brief create ball position cache
       \param ball current ball data
@@ -64,42 +120,96 @@ public:
     explicit
     CoachInterceptPredictor( const CoachBallObject & ball );
 
+    /*!
+      \brief recreate the ball position cache. the allocated memory is reused.
+      \param ball_pos ball position
+      \param ball_vel ball velocity
+     */
+    void setBall( const Vector2D & ball_pos,
+                  const Vector2D & ball_vel );
+
+    /*!
+      \brief get the ball position cache
+      \return const reference to the ball position cache
+     */
+    const std::vector< Vector2D > & ballCache() const
+      {
+          return M_ball_cache;
+      }
+
+    /*!
+      \brief remove all registered players
+     */
+    void clearPlayers();
+
+    /*!
+      \brief register the player for the batched prediction.
+      \param player player object. invalid player is also registered and its result is always -1.
+      \return index of the registered player
+     */
+    int addPlayer( const CoachPlayerObject & player );
+
+    /*!
+      \brief get the number of registered players
+      \return the number of registered players
+     */
+    int playerCount() const
+      {
+          return static_cast< int >( M_pos_x.size() );
+      }
+
+    /*!
+      \brief predict the ball reach step of the player for the current ball cache
+      \param player player object
+      \return predicted step, or -1 if the player is invalid or cannot reach
+     */
     int predict( const CoachPlayerObject & player ) const;
 
+    /*!
+      \brief predict the ball reach steps of all registered players for the current ball cache
+      \param steps pointer to the result container. the index is same as the registration order.
+     */
+    void predictAll( std::vector< int > * steps ) const;
+
+    /*!
+      \brief predict the ball reach steps of all registered players for the given ball state
+      \param ball_pos ball position
+      \param ball_vel ball velocity
+      \param steps pointer to the result container. the index is same as the registration order.
+     */
+    void predictAll( const Vector2D & ball_pos,
+                     const Vector2D & ball_vel,
+                     std::vector< int > * steps );
+
 private:
 
-    int predictReachStep( const CoachPlayerObject & player,
+    void reservePlayers();
+
+    void updateLineDistance() const;
+
+    void loadCandidate( const int index,
+                        Candidate * c ) const;
+
+    int predictCandidate( const Candidate & c,
                           const bool goalie ) const;
-    int predictMinStep( const CoachPlayerObject & player,
-                        const PlayerType & ptype,
+
+    int predictReachStep( const Candidate & c,
+                          const bool goalie ) const;
+
+    int predictMinStep( const Candidate & c,
                         const double control_area ) const;
 
     bool canReachAfterTurnDash( const int total_step,
-                                const int penalty_step,
-                                const CoachPlayerObject & player,
-                                const PlayerType & ptype,
+                                const Candidate & c,
                                 const double control_area,
                                 const Vector2D & ball_pos ) const;
 
-    int predictTurnCycle( const int total_step,
-                          const int penalty_step,
-                          const CoachPlayerObject & player,
-                          const PlayerType & ptype,
+    int predictTurnCycle( const Candidate & c,
                           const double control_area,
-                          const Vector2D & ball_pos ) const;
-
-
-    bool canReachAfterDash( const int penalty_step,
-                            const int n_turn,
-                            const int n_dash,
-                            const CoachPlayerObject & player,
-                            const PlayerType & ptype,
-                            const double control_area,
-                            const Vector2D & ball_pos ) const;
+                          const Vector2D & ball_pos,
+                          const Vector2D & inertia_pos ) const;
 
-    int predictFinal( const int penalty_step,
-                      const CoachPlayerObject & player,
-                      const PlayerType & ptype,
+    int predictFinal( const Candidate & c,
                       const double control_area ) const;
 
 };
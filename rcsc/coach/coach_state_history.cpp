@@ -0,0 +1,300 @@
+// -*-c++-*-
+
+/*!
+  \file coach_state_history.cpp
+  \brief ring buffer of the coach world state snapshots Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "coach_state_history.h"
+
+#include "coach_world_state.h"
+#include "coach_player_object.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace rcsc {
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the index in CoachStateSnapshot::players_
+ */
+inline
+int
+player_index( const CoachPlayerObject * p )
+{
+    if ( ! p
+         || p->side() == NEUTRAL
+         || p->unum() < 1 || 11 < p->unum() )
+    {
+        return -1;
+    }
+
+    return ( p->side() == LEFT ? 0 : 11 ) + p->unum() - 1;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoachPlayerSnapshot::assign( const CoachPlayerObject & p )
+{
+    pos_x_ = static_cast< float >( p.pos().x );
+    pos_y_ = static_cast< float >( p.pos().y );
+    vel_x_ = static_cast< float >( p.vel().x );
+    vel_y_ = static_cast< float >( p.vel().y );
+    body_ = static_cast< float >( p.body().degree() );
+    face_ = static_cast< float >( p.face().degree() );
+    pointto_ = static_cast< float >( p.pointtoAngle().degree() );
+    stamina_ = static_cast< float >( p.stamina() );
+    ball_reach_step_ = static_cast< short >( std::min( p.ballReachStep(),
+                                                       static_cast< int >( std::numeric_limits< short >::max() ) ) );
+    type_ = static_cast< signed char >( p.type() );
+    unum_ = static_cast< unsigned char >( p.unum() );
+    flags_ = 0;
+    if ( p.goalie() ) flags_ |= GOALIE;
+    if ( p.isKicking() ) flags_ |= KICKING;
+    if ( p.isTackling() ) flags_ |= TACKLING;
+    if ( p.isCharged() ) flags_ |= CHARGED;
+    if ( p.isPointing() ) flags_ |= POINTING;
+    card_ = static_cast< unsigned char >( p.card() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoachStateSnapshot::assign( const CoachWorldState & state )
+{
+    cycle_ = state.time().cycle();
+    stopped_ = state.time().stopped();
+    game_mode_type_ = static_cast< unsigned char >( state.gameMode().type() );
+    game_mode_side_ = static_cast< signed char >( state.gameMode().side() );
+    kicker_ = static_cast< signed char >( player_index( state.kicker() ) );
+    ball_owner_ = static_cast< signed char >( player_index( state.ballOwner() ) );
+    ball_owner_side_ = static_cast< signed char >( state.ballOwnerSide() );
+    ball_pos_x_ = static_cast< float >( state.ball().pos().x );
+    ball_pos_y_ = static_cast< float >( state.ball().pos().y );
+    ball_vel_x_ = static_cast< float >( state.ball().vel().x );
+    ball_vel_y_ = static_cast< float >( state.ball().vel().y );
+    our_offside_line_x_ = static_cast< float >( state.ourOffsideLineX() );
+    their_offside_line_x_ = static_cast< float >( state.theirOffsideLineX() );
+
+    for ( CoachPlayerSnapshot & p : players_ )
+    {
+        p.unum_ = 0;
+    }
+
+    for ( const CoachPlayerObject * p : state.allPlayers() )
+    {
+        const int idx = player_index( p );
+        if ( idx >= 0 )
+        {
+            players_[idx].assign( *p );
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+const std::size_t CoachStateHistory::DEFAULT_CAPACITY = 60000;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CoachStateHistory::CoachStateHistory( const std::size_t capacity )
+    : M_capacity( std::max( static_cast< std::size_t >( 1 ), capacity ) ),
+      M_buffer(),
+      M_pushed_count( 0 ),
+      M_size( 0 )
+{
+    M_cycle_first_seq.reserve( 12000 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoachStateHistory::clear()
+{
+    M_pushed_count = 0;
+    M_size = 0;
+    M_cycle_first_seq.clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoachStateHistory::setCapacity( const std::size_t capacity )
+{
+    clear();
+
+    M_capacity = std::max( static_cast< std::size_t >( 1 ), capacity );
+    M_buffer.reset();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoachStateHistory::push( const CoachWorldState & state )
+{
+    if ( ! M_buffer )
+    {
+        M_buffer.reset( new CoachStateSnapshot[M_capacity] );
+    }
+
+    const long seq = M_pushed_count;
+    const long cycle = state.time().cycle();
+
+    // states in the same normal cycle are stored contiguously.
+    // the first one of the sequence is registered as the entry point.
+    const bool continued = ( M_size > 0
+                             && back().cycle_ == cycle );
+
+    M_buffer[seq % M_capacity].assign( state );
+
+    ++M_pushed_count;
+    if ( M_size < M_capacity )
+    {
+        ++M_size;
+    }
+
+    if ( cycle < 0 )
+    {
+        return;
+    }
+
+    if ( static_cast< long >( M_cycle_first_seq.size() ) <= cycle )
+    {
+        M_cycle_first_seq.resize( cycle + 1, -1 );
+    }
+
+    if ( ! continued
+         || M_cycle_first_seq[cycle] < 0 )
+    {
+        M_cycle_first_seq[cycle] = seq;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const CoachStateSnapshot *
+CoachStateHistory::find( const GameTime & time ) const
+{
+    if ( time.cycle() < 0
+         || static_cast< long >( M_cycle_first_seq.size() ) <= time.cycle() )
+    {
+        return nullptr;
+    }
+
+    const long first = M_cycle_first_seq[time.cycle()];
+    if ( first < 0 )
+    {
+        return nullptr;
+    }
+
+    // if the first state has already been overwritten,
+    // the oldest element is used as the base point.
+    const long oldest = M_pushed_count - static_cast< long >( M_size );
+    const long base = std::max( first, oldest );
+    if ( M_pushed_count <= base )
+    {
+        return nullptr;
+    }
+
+    // the run of the cycle ends before the first state of the next registered cycle.
+    long last = M_pushed_count;
+    for ( std::size_t c = time.cycle() + 1; c < M_cycle_first_seq.size(); ++c )
+    {
+        if ( M_cycle_first_seq[c] >= 0 )
+        {
+            last = std::min( last, M_cycle_first_seq[c] );
+            break;
+        }
+    }
+
+    // fast path: no stopped time is missing from the run
+    const long guess = base + ( time.stopped() - M_buffer[base % M_capacity].stopped_ );
+    if ( base <= guess && guess < last )
+    {
+        const CoachStateSnapshot & s = M_buffer[guess % M_capacity];
+        if ( s.cycle_ == time.cycle()
+             && s.stopped_ == time.stopped() )
+        {
+            return &s;
+        }
+    }
+
+    // states in the run are sorted by the stopped time.
+    // binary search handles the missing stopped times.
+    long lo = base;
+    long hi = last;
+    while ( lo < hi )
+    {
+        const long mid = lo + ( hi - lo ) / 2;
+        if ( M_buffer[mid % M_capacity].stopped_ < time.stopped() )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    if ( lo < last )
+    {
+        const CoachStateSnapshot & s = M_buffer[lo % M_capacity];
+        if ( s.cycle_ == time.cycle()
+             && s.stopped_ == time.stopped() )
+        {
+            return &s;
+        }
+    }
+
+    return nullptr;
+}
+
+}
@@ -0,0 +1,372 @@
+// -*-c++-*-
+
+/*!
+  \file coach_state_history.h
+  \brief ring buffer of the coach world state snapshots Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_COACH_STATE_HISTORY_H
+#define RCSC_COACH_STATE_HISTORY_H
+
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/angle_deg.h>
+#include <rcsc/game_time.h>
+#include <rcsc/game_mode.h>
+#include <rcsc/types.h>
+
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+namespace rcsc {
+
+class CoachWorldState;
+class CoachPlayerObject;
+
+/*!
+  \struct CoachPlayerSnapshot
+  \brief compact copy of CoachPlayerObject
+ */
+struct CoachPlayerSnapshot {
+
+    //! bit flags
+    enum Flag {
+        GOALIE = 0x01,
+        KICKING = 0x02,
+        TACKLING = 0x04,
+        CHARGED = 0x08,
+        POINTING = 0x10,
+    };
+
+    float pos_x_; //!< global position x
+    float pos_y_; //!< global position y
+    float vel_x_; //!< velocity x
+    float vel_y_; //!< velocity y
+    float body_; //!< global body angle
+    float face_; //!< global face angle
+    float pointto_; //!< global pointing angle
+    float stamina_; //!< (heard or estimated) stamina value
+    short ball_reach_step_; //!< estimated ball interception step
+    signed char type_; //!< player type id
+    unsigned char unum_; //!< uniform number. 0 means no player.
+    unsigned char flags_; //!< bit flags
+    unsigned char card_; //!< Card value
+
+    /*!
+      \brief set the player data
+      \param p source player object
+     */
+    void assign( const CoachPlayerObject & p );
+
+    /*!
+      \brief check if this snapshot holds a player data
+      \return checked result
+     */
+    bool isValid() const
+      {
+          return unum_ != 0;
+      }
+
+    Vector2D pos() const { return Vector2D( pos_x_, pos_y_ ); }
+    Vector2D vel() const { return Vector2D( vel_x_, vel_y_ ); }
+    AngleDeg body() const { return AngleDeg( body_ ); }
+    AngleDeg face() const { return AngleDeg( face_ ); }
+    AngleDeg pointtoAngle() const { return AngleDeg( pointto_ ); }
+    double stamina() const { return stamina_; }
+    int ballReachStep() const { return ball_reach_step_; }
+    int type() const { return type_; }
+    int unum() const { return unum_; }
+    Card card() const { return static_cast< Card >( card_ ); }
+    bool goalie() const { return flags_ & GOALIE; }
+    bool isKicking() const { return flags_ & KICKING; }
+    bool isTackling() const { return flags_ & TACKLING; }
+    bool isCharged() const { return flags_ & CHARGED; }
+    bool isPointing() const { return flags_ & POINTING; }
+};
+
+/*!
+  \struct CoachStateSnapshot
+  \brief compact copy of CoachWorldState. players are stored in the
+  order of left 1-11 and right 1-11.
+ */
+struct CoachStateSnapshot {
+
+    long cycle_; //!< game time cycle
+    long stopped_; //!< game time stopped cycle
+    unsigned char game_mode_type_; //!< GameMode::Type value
+    signed char game_mode_side_; //!< SideID of the play mode
+    signed char kicker_; //!< index of the estimated kicker, or -1
+    signed char ball_owner_; //!< index of the estimated ball owner, or -1
+    signed char ball_owner_side_; //!< estimated ball owner side
+    float ball_pos_x_; //!< ball position x
+    float ball_pos_y_; //!< ball position y
+    float ball_vel_x_; //!< ball velocity x
+    float ball_vel_y_; //!< ball velocity y
+    float our_offside_line_x_; //!< offside line x for our team (or left team)
+    float their_offside_line_x_; //!< offside line x for their team (or right team)
+
+    CoachPlayerSnapshot players_[22]; //!< left players and right players
+
+    /*!
+      \brief set the state data
+      \param state source world state
+     */
+    void assign( const CoachWorldState & state );
+
+    GameTime time() const { return GameTime( cycle_, stopped_ ); }
+    GameMode::Type gameModeType() const { return static_cast< GameMode::Type >( game_mode_type_ ); }
+    SideID gameModeSide() const { return static_cast< SideID >( game_mode_side_ ); }
+    Vector2D ballPos() const { return Vector2D( ball_pos_x_, ball_pos_y_ ); }
+    Vector2D ballVel() const { return Vector2D( ball_vel_x_, ball_vel_y_ ); }
+    SideID ballOwnerSide() const { return static_cast< SideID >( ball_owner_side_ ); }
+
+    /*!
+      \brief get the player snapshot
+      \param side team side
+      \param unum uniform number (1-11)
+      \return const pointer to the player data. if no data, NULL is returned.
+     */
+    const CoachPlayerSnapshot * player( const SideID side,
+                                        const int unum ) const
+      {
+          if ( side == NEUTRAL || unum < 1 || 11 < unum ) return nullptr;
+          const CoachPlayerSnapshot & p = players_[( side == LEFT ? 0 : 11 ) + unum - 1];
+          return p.isValid() ? &p : nullptr;
+      }
+
+    /*!
+      \brief get the estimated last kicker
+      \return const pointer to the player data. if no kicker, NULL is returned.
+     */
+    const CoachPlayerSnapshot * kicker() const
+      {
+          return kicker_ >= 0 ? &players_[static_cast< int >( kicker_ )] : nullptr;
+      }
+
+    /*!
+      \brief get the estimated ball owner
+      \return const pointer to the player data. if no owner, NULL is returned.
+     */
+    const CoachPlayerSnapshot * ballOwner() const
+      {
+          return ball_owner_ >= 0 ? &players_[static_cast< int >( ball_owner_ )] : nullptr;
+      }
+};
+
+/*!
+  \class CoachStateHistory
+  \brief fixed capacity ring buffer of the state snapshots.
+
+  All elements are allocated when the first state is pushed.  Pushing a
+  new state only copies the data, and the oldest element is overwritten
+  when the buffer is full.  One snapshot takes about 930 bytes, so the
+  default capacity, that covers a whole game with extra time, takes about
+  56 MB.  Stored states can be looked up by the game time in
+  constant time.  The logical index 0 is the oldest element.
+ */
+class CoachStateHistory {
+public:
+
+    static const std::size_t DEFAULT_CAPACITY; //!< default buffer size (60000)
+
+    /*!
+      \class const_iterator
+      \brief random access iterator over the stored snapshots
+     */
+    class const_iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef CoachStateSnapshot value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const CoachStateSnapshot * pointer;
+        typedef const CoachStateSnapshot & reference;
+
+    private:
+        const CoachStateHistory * M_history;
+        std::size_t M_index;
+
+    public:
+        const_iterator()
+            : M_history( nullptr ),
+              M_index( 0 )
+          { }
+
+        const_iterator( const CoachStateHistory * history,
+                        const std::size_t index )
+            : M_history( history ),
+              M_index( index )
+          { }
+
+        reference operator*() const { return M_history->at( M_index ); }
+        pointer operator->() const { return &M_history->at( M_index ); }
+        reference operator[]( const difference_type n ) const { return M_history->at( M_index + n ); }
+
+        const_iterator & operator++() { ++M_index; return *this; }
+        const_iterator operator++( int ) { const_iterator tmp = *this; ++M_index; return tmp; }
+        const_iterator & operator--() { --M_index; return *this; }
+        const_iterator operator--( int ) { const_iterator tmp = *this; --M_index; return tmp; }
+        const_iterator & operator+=( const difference_type n ) { M_index += n; return *this; }
+        const_iterator & operator-=( const difference_type n ) { M_index -= n; return *this; }
+        const_iterator operator+( const difference_type n ) const { return const_iterator( M_history, M_index + n ); }
+        const_iterator operator-( const difference_type n ) const { return const_iterator( M_history, M_index - n ); }
+        difference_type operator-( const const_iterator & rhs ) const
+          {
+              return static_cast< difference_type >( M_index ) - static_cast< difference_type >( rhs.M_index );
+          }
+
+        bool operator==( const const_iterator & rhs ) const { return M_index == rhs.M_index; }
+        bool operator!=( const const_iterator & rhs ) const { return M_index != rhs.M_index; }
+        bool operator<( const const_iterator & rhs ) const { return M_index < rhs.M_index; }
+        bool operator>( const const_iterator & rhs ) const { return M_index > rhs.M_index; }
+        bool operator<=( const const_iterator & rhs ) const { return M_index <= rhs.M_index; }
+        bool operator>=( const const_iterator & rhs ) const { return M_index >= rhs.M_index; }
+    };
+
+private:
+
+    std::size_t M_capacity; //!< buffer size
+    std::unique_ptr< CoachStateSnapshot[] > M_buffer; //!< ring buffer. allocated by the first push
+
+    long M_pushed_count; //!< total number of pushed states
+    std::size_t M_size; //!< the number of stored states
+
+    //! sequence number of the first state for each normal cycle, or -1
+    std::vector< long > M_cycle_first_seq;
+
+    // not used
+    CoachStateHistory( const CoachStateHistory & ) = delete;
+    CoachStateHistory & operator=( const CoachStateHistory & ) = delete;
+
+public:
+
+    /*!
+      \brief set the buffer size. the buffer is allocated by the first push.
+      \param capacity buffer size
+     */
+    explicit
+    CoachStateHistory( const std::size_t capacity = DEFAULT_CAPACITY );
+
+    /*!
+      \brief remove all states. the buffer is not released.
+     */
+    void clear();
+
+    /*!
+      \brief change the buffer size. all states are removed, and the buffer
+      is released.
+      \param capacity new buffer size
+     */
+    void setCapacity( const std::size_t capacity );
+
+    /*!
+      \brief store the snapshot of the state
+      \param state source world state
+     */
+    void push( const CoachWorldState & state );
+
+    /*!
+      \brief get the buffer size
+      \return buffer size
+     */
+    std::size_t capacity() const
+      {
+          return M_capacity;
+      }
+
+    /*!
+      \brief get the number of stored states
+      \return the number of stored states
+     */
+    std::size_t size() const
+      {
+          return M_size;
+      }
+
+    /*!
+      \brief check if no state is stored
+      \return checked result
+     */
+    bool empty() const
+      {
+          return M_size == 0;
+      }
+
+    /*!
+      \brief get the snapshot by the logical index
+      \param index logical index. 0 is the oldest state.
+      \return const reference to the snapshot
+     */
+    const CoachStateSnapshot & at( const std::size_t index ) const
+      {
+          return M_buffer[( M_pushed_count - M_size + index ) % M_capacity];
+      }
+
+    /*!
+      \brief get the oldest snapshot
+      \return const reference to the snapshot
+     */
+    const CoachStateSnapshot & front() const
+      {
+          return at( 0 );
+      }
+
+    /*!
+      \brief get the latest snapshot
+      \return const reference to the snapshot
+     */
+    const CoachStateSnapshot & back() const
+      {
+          return at( M_size - 1 );
+      }
+
+    const_iterator begin() const { return const_iterator( this, 0 ); }
+    const_iterator end() const { return const_iterator( this, M_size ); }
+
+    /*!
+      \brief get the iterator to the first element of the latest n states
+      \param n window size
+      \return iterator. the range [window(n), end()) contains min(n, size()) states.
+     */
+    const_iterator window( const std::size_t n ) const
+      {
+          return const_iterator( this, n >= M_size ? 0 : M_size - n );
+      }
+
+    /*!
+      \brief find the snapshot at the specified game time
+      \param time game time
+      \return const pointer to the snapshot. if not found, NULL is returned.
+     */
+    const CoachStateSnapshot * find( const GameTime & time ) const;
+
+};
+
+}
+
+#endif
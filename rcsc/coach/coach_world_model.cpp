@@ -69,6 +69,7 @@ CoachWorldModel::CoachWorldModel()
       M_training_time( -1, 0 ),
       M_audio_memory( new AudioMemory() ),
       M_current_state( new CoachWorldState() ),
+      M_current_snapshot(),
       M_last_kicker_side( NEUTRAL ),
       M_last_kicker_unum( Unum_Unknown ),
       M_pass_time( -1, 0 ),
@@ -100,6 +101,8 @@ CoachWorldModel::CoachWorldModel()
         M_clang_capacity[i] = 0;
     }
     M_clang_capacity[CLANG_UNSUPP] = 1;
+
+    updateCurrentSnapshot();
 }
 
 /*-------------------------------------------------------------------*/
@@ -126,6 +129,16 @@ CoachWorldModel::setAudioMemory( std::shared_ptr< AudioMemory > memory )
     M_audio_memory = memory;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoachWorldModel::setStateHistoryCapacity( const std::size_t capacity )
+{
+    M_state_history.setCapacity( capacity );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -351,6 +364,8 @@ CoachWorldModel::setCard( const SideID side,
     {
         M_their_card[unum - 1] = card;
     }
+
+    updateCurrentSnapshot();
 }
 
 /*-------------------------------------------------------------------*/
@@ -438,6 +453,8 @@ CoachWorldModel::updateAfterSeeGlobal( const CoachVisualSensor & see_global,
                                                                  M_game_mode,
                                                                  M_previous_state ) );
     updatePlayerType();
+
+    updateCurrentSnapshot();
 }
 
 /*-------------------------------------------------------------------*/
@@ -457,43 +474,15 @@ CoachWorldModel::updateJustBeforeDecision( const GameTime & current )
     updateLastPasser();
 
     M_current_state->updatePlayerStamina( *M_audio_memory );
+    updateCurrentSnapshot();
 
     //
     // store the latest state data
     //
-    if ( gameMode().type() == GameMode::BeforeKickOff
-         || gameMode().type() == GameMode::TimeOver )
-    {
-        // if ( ! M_state_list.empty()
-        //      && M_state_list.back()->gameMode().type() == gameMode().type() )
-        // {
-        //     M_state_map.erase( M_state_list.back()->time() );
-        //     M_state_list.pop_back();
-        // }
-        // M_state_map[ current ] = M_current_state;
-        // M_state_list.push_back( M_current_state );
-    }
-    else
-    {
-        M_state_list.push_back( M_current_state );
-        M_state_map[ current ] = M_current_state;
-    }
-
-    //
-    // erase the oldest state data
-    //
-    if ( M_state_list.size() > 60000 )
+    if ( gameMode().type() != GameMode::BeforeKickOff
+         && gameMode().type() != GameMode::TimeOver )
     {
-        GameMode::Type mode = M_state_list.front()->gameMode().type();
-        GameTime t = M_state_list.front()->time();
-        if ( mode == GameMode::BeforeKickOff
-             || mode == GameMode::TimeOver )
-        {
-            t.setStopped( 0 );
-        }
-
-        M_state_map.erase( t );
-        M_state_list.pop_front();
+        M_state_history.push( *M_current_state );
     }
 }
 
@@ -552,6 +541,16 @@ CoachWorldModel::updateCLangCapacity()
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CoachWorldModel::updateCurrentSnapshot()
+{
+    M_current_snapshot.assign( *M_current_state );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -914,6 +913,8 @@ CoachWorldModel::updateState( const rcg::DispInfoT & disp,
                                                                  M_previous_state ) );
 
     updatePlayerType( disp );
+
+    updateCurrentSnapshot();
 }
 
 /*-------------------------------------------------------------------*/
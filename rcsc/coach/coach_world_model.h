@@ -33,6 +33,7 @@
 #define RCSC_COACH_COACH_WORLD_MODEL_H
 
 #include <rcsc/coach/coach_world_state.h>
+#include <rcsc/coach/coach_state_history.h>
 #include <rcsc/coach/coach_ball_object.h>
 #include <rcsc/coach/coach_player_object.h>
 #include <rcsc/coach/player_type_analyzer.h>
@@ -54,6 +55,15 @@ class CoachVisualSensor;
 /*!
   \class CoachWorldModel
   \brief world world for coach
+
+  The past states are stored as CoachStateSnapshot in the ring buffer
+  returned by stateHistory().  stateList() and stateMap(), which held
+  CoachWorldState::ConstPtr, are removed, and getState() returns a
+  const pointer to the snapshot instead of CoachWorldState::ConstPtr.
+  Code that iterated stateList() should iterate stateHistory() or
+  stateHistory().window(n), and code that looked up stateMap() should
+  call getState() or stateHistory().find().  Use currentStatePtr() if
+  the full CoachWorldState of the current cycle is required.
  */
 class CoachWorldModel {
 private:
@@ -94,8 +104,8 @@ private:
     CoachWorldState::Ptr M_current_state; //!< current world state. always exist instance.
     CoachWorldState::Ptr M_previous_state; //!< previous world state.
 
-    CoachWorldState::List M_state_list; //!< the record of world state.
-    CoachWorldState::Map M_state_map; //!< the map of world state;
+    CoachStateHistory M_state_history; //!< the record of world state snapshots.
+    CoachStateSnapshot M_current_snapshot; //!< snapshot of M_current_state. updated with M_current_state
 
     SideID M_last_kicker_side; //!< last ball kicker's team side
     int M_last_kicker_unum; //!< last ball kicker's uniform number
@@ -173,6 +183,12 @@ public:
      */
     void setAudioMemory( std::shared_ptr< AudioMemory > memory );
 
+    /*!
+      \brief change the size of the state history. all stored states are removed.
+      \param capacity the number of snapshots. one snapshot takes about 930 bytes.
+     */
+    void setStateHistoryCapacity( const std::size_t capacity );
+
     /*!
       \brief get audio memory
       \return co
@@ -259,6 +275,11 @@ private:
      */
     void updateCLangCapacity();
 
+    /*!
+      \brief copy the current state to the current snapshot.
+     */
+    void updateCurrentSnapshot();
+
     /*!
       \brief update team names using see information
       \param see_global analyzed visual information
@@ -471,61 +492,58 @@ public:
       }
 
     /*!
-      \brief get the state list.
-      \return the world state list.
+      \brief get the record of world state snapshots.
+      \return const reference to the ring buffer.
      */
-    const CoachWorldState::List & stateList() const
+    const CoachStateHistory & stateHistory() const
       {
-          return M_state_list;
+          return M_state_history;
       }
 
     /*!
-      \brief get the state map. key: GameTime, value: CoachWorldState::ConstPtr
-      \return the world state list.
-     */
-    const CoachWorldState::Map & stateMap() const
-      {
-          return M_state_map;
-      }
-
-    /*!
-      \brief get the state pointer at the specified game time
+      \brief get the state snapshot at the specified game time
       \param time nomal game time. the stoppage time is assued as 0.
-      \return const pointer. if not found, NULL is returned.
+      \return const pointer. if time is negative, the snapshot of the current state is returned.
+      if not found, NULL is returned. the pointed data is valid until the next update.
      */
-    CoachWorldState::ConstPtr getState( const int time ) const
+    const CoachStateSnapshot * getState( const int time ) const
       {
           if ( time < 0 )
           {
-              return M_current_state;
+              return &M_current_snapshot;
           }
 
-          CoachWorldState::Map::const_iterator it = M_state_map.find( GameTime( time, 0 ) );
-          if ( it == M_state_map.end() )
-          {
-              return CoachWorldState::ConstPtr();
-          }
-          return it->second;
+          return M_state_history.find( GameTime( time, 0 ) );
       }
 
     /*!
-      \brief get the state pointer at the specified game time
+      \brief get the state snapshot at the specified game time
       \param time game time
-      \return const pointer. if not found, NULL is returned.
+      \return const pointer. if the cycle is negative, the snapshot of the current state is returned.
+      if not found, NULL is returned. the pointed data is valid until the next update.
      */
-    CoachWorldState::ConstPtr getState( const GameTime & time ) const
+    const CoachStateSnapshot * getState( const GameTime & time ) const
       {
           if ( time.cycle() < 0 )
           {
-              return M_current_state;
+              return &M_current_snapshot;
           }
 
-          CoachWorldState::Map::const_iterator it = M_state_map.find( time );
-          if ( it == M_state_map.end() )
-          {
-              return CoachWorldState::ConstPtr();
-          }
-          return it->second;
+          return M_state_history.find( time );
+      }
+
+    /*!
+      \brief get the snapshot of the current state.
+      The current state is always available even in BeforeKickOff or
+      TimeOver mode, where no snapshot is pushed to the history.
+      The snapshot is updated whenever the current state is updated, so
+      that the reference is valid but its data is overwritten by the next
+      update. Copy it to keep the data.
+      \return const reference to the snapshot.
+     */
+    const CoachStateSnapshot & currentSnapshot() const
+      {
+          return M_current_snapshot;
       }
 
     /*!
@@ -780,33 +780,36 @@ CoachWorldState::updateInterceptTable()
 
     // Timer timer;
 
+    // all players are evaluated in one batch with the shared ball cache.
+    CoachPlayerObject * players[22];
+    int size = 0;
+
     for ( int i = 0; i < 11; ++i )
     {
-        CoachPlayerObject * p = M_teammate_array[i];
-        if ( ! p ) continue;
-
-        int step = predictor.predict( *p );
-        if ( step >= 0 )
-        {
-            p->setBallReachStep( step );
-            // dlog.addText( Logger::INTERCEPT,
-            //               "__ teammate %d step=%d",
-            //               (*p)->unum(), step );
-        }
+        if ( M_teammate_array[i] ) players[size++] = M_teammate_array[i];
     }
 
     for ( int i = 0; i < 11; ++i )
     {
-        CoachPlayerObject * p = M_opponent_array[i];
-        if ( ! p ) continue;
+        if ( M_opponent_array[i] ) players[size++] = M_opponent_array[i];
+    }
 
-        int step = predictor.predict( *p );
-        if ( step >= 0 )
+    for ( int i = 0; i < size; ++i )
+    {
+        predictor.addPlayer( *players[i] );
+    }
+
+    std::vector< int > steps;
+    predictor.predictAll( &steps );
+
+    for ( int i = 0; i < size; ++i )
+    {
+        if ( steps[i] >= 0 )
         {
-            p->setBallReachStep( step );
+            players[i]->setBallReachStep( steps[i] );
             // dlog.addText( Logger::INTERCEPT,
-            //               "__ opponent %d step=%d",
-            //               (*p)->unum(), step );
+            //               "__ player %c %d step=%d",
+            //               side_char( players[i]->side() ), players[i]->unum(), steps[i] );
         }
     }
 
@@ -44,6 +44,7 @@
 #include <rcsc/common/logger.h>
 #include <rcsc/game_mode.h>
 
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
@@ -59,7 +60,8 @@ namespace rcsc {
 
 */
 PlayerTypeAnalyzer::Data::Data()
-    : turned_( false ),
+    : changed_( false ),
+      turned_( false ),
       rotation_( 0.0 ),
       kicked_( false ),
       tackling_( false ),
@@ -70,7 +72,9 @@ PlayerTypeAnalyzer::Data::Data()
       vel_( 0.0, 0.0 ),
       body_( -360 ),
       invalid_flags_( PlayerParam::i().playerTypes(), 0 ),
-      type_( Hetero_Default )
+      candidate_count_( PlayerParam::i().playerTypes() ),
+      type_( Hetero_Default ),
+      determined_time_( -1, 0 )
 {
 
 }
@@ -83,6 +87,7 @@ void
 PlayerTypeAnalyzer::Data::setDefaultType()
 {
     invalid_flags_.assign( PlayerParam::i().playerTypes(), 0 );
+    candidate_count_ = static_cast< int >( invalid_flags_.size() );
 
     type_ = Hetero_Default;
 }
@@ -95,6 +100,7 @@ void
 PlayerTypeAnalyzer::Data::setUnknownType()
 {
     invalid_flags_.assign( PlayerParam::i().playerTypes(), 0 );
+    candidate_count_ = static_cast< int >( invalid_flags_.size() );
 
     type_ = Hetero_Unknown;
 }
@@ -102,11 +108,32 @@ PlayerTypeAnalyzer::Data::setUnknownType()
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+void
+PlayerTypeAnalyzer::Data::resizeTypes( const std::size_t max_types )
+{
+    if ( invalid_flags_.size() == max_types )
+    {
+        return;
+    }
+
+    invalid_flags_.resize( max_types, 0 );
+    candidate_count_ = static_cast< int >( std::count( invalid_flags_.begin(),
+                                                       invalid_flags_.end(),
+                                                       0 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 PlayerTypeAnalyzer::PlayerTypeAnalyzer( const CoachWorldModel & world )
     : M_world( world ),
       M_updated_time( -1, 0 ),
-      M_playmode( PM_BeforeKickOff )
+      M_playmode( PM_BeforeKickOff ),
+      M_server_param_version( 0 ),
+      M_player_type_version( 0 ),
+      M_check_count( 0 )
 {
 
 }
@@ -126,15 +153,8 @@ PlayerTypeAnalyzer::update()
     const std::size_t max_types = static_cast< std::size_t >( PlayerParam::i().playerTypes() );
     for ( int i = 0; i < 11; ++i )
     {
-        if ( M_teammate_data[i].invalid_flags_.size() != max_types )
-        {
-            M_teammate_data[i].invalid_flags_.resize( max_types, 0 );
-        }
-
-        if ( M_opponent_data[i].invalid_flags_.size() != max_types )
-        {
-            M_opponent_data[i].invalid_flags_.resize( max_types, 0 );
-        }
+        M_teammate_data[i].resizeTypes( max_types );
+        M_opponent_data[i].resizeTypes( max_types );
 
 #if 0
         // heterogeneous goalie is available in v14 or later
@@ -161,6 +181,8 @@ PlayerTypeAnalyzer::update()
 #endif
     }
 
+    updateTypeLimits();
+
     if ( M_updated_time.cycle() != M_world.time().cycle() - 1
          && M_updated_time.stopped() != M_world.time().stopped() - 1 )
     {
@@ -238,6 +260,54 @@ PlayerTypeAnalyzer::reset( const int unum )
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+void
+PlayerTypeAnalyzer::updateTypeLimits()
+{
+    const ServerParam & SP = ServerParam::i();
+    const PlayerTypeSet & PTS = PlayerTypeSet::i();
+    const std::size_t max_types = static_cast< std::size_t >( PlayerParam::i().playerTypes() );
+
+    if ( M_type_limits.size() == max_types
+         && M_server_param_version == SP.version()
+         && M_player_type_version == PTS.version() )
+    {
+        return;
+    }
+
+    M_server_param_version = SP.version();
+    M_player_type_version = PTS.version();
+
+    M_type_limits.resize( max_types );
+    for ( std::size_t t = 0; t < max_types; ++t )
+    {
+        TypeLimit & limit = M_type_limits[t];
+
+        const PlayerType * ptype = PTS.get( t );
+        if ( ! ptype )
+        {
+            limit.valid_ = false;
+            continue;
+        }
+
+        limit.valid_ = true;
+        limit.kickable_area_ = ptype->kickableArea() + 0.001;
+        limit.player_decay_ = ptype->playerDecay();
+        limit.max_accel_ = SP.maxDashPower() * ptype->dashRate( ptype->effortMax() );
+
+        // XXX
+        limit.max_move_ = ptype->realSpeedMax() * ( 1.0 + SP.playerRand() );
+        limit.max_move_ *= ptype->playerDecay();
+        limit.max_move_ += limit.max_accel_;
+        limit.max_move_ *= ( 1.0 + SP.playerRand() );
+
+        limit.inertia_moment_ = ptype->inertiaMoment();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 void
 PlayerTypeAnalyzer::updateLastData()
@@ -270,11 +340,16 @@ PlayerTypeAnalyzer::updateLastData()
 
 /*-------------------------------------------------------------------*/
 /*!
-
+  The opponents are checked one by one in this thread.
+  The work per cycle is a few arithmetic checks for each candidate type
+  (11 players x 18 types, about 15 microseconds including the world model
+  update in bench_player_type_analyzer), which is far below the cost of
+  dispatching it to other threads.
 */
 void
 PlayerTypeAnalyzer::analyze()
 {
+    checkChanged();
     checkTurn();
     checkTackle();
     checkReferee();
@@ -319,14 +394,7 @@ PlayerTypeAnalyzer::analyze()
         // if player might be moved by referee, we must not analyze
         if ( data.maybe_referee_ ) continue;
 
-        int invalid_count = 0;
-        for ( int t = 0; t < max_types; ++t )
-        {
-            if ( data.invalid_flags_[t] != 0 )
-            {
-                ++invalid_count;
-            }
-        }
+        const int invalid_count = max_types - data.candidate_count_;
 
 #ifdef DEBUG_PRINT_RESULT
         dlog.addText( Logger::ANALYZER,
@@ -364,6 +432,7 @@ PlayerTypeAnalyzer::analyze()
                                   p->unum(), t );
 #endif
                     data.type_ = t;
+                    data.determined_time_ = M_world.time();
 
                     M_opponent_type_used_count[t] += 1;
                     if ( M_opponent_type_used_count[t] >= PlayerParam::i().ptMax() )
@@ -372,7 +441,7 @@ PlayerTypeAnalyzer::analyze()
                         {
                             if ( M_opponent_data[i].type_ == Hetero_Unknown )
                             {
-                                M_opponent_data[i].invalid_flags_[t] = 1;
+                                M_opponent_data[i].setInvalid( t );
                             }
                         }
                     }
@@ -396,6 +465,38 @@ PlayerTypeAnalyzer::analyze()
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+void
+PlayerTypeAnalyzer::checkChanged()
+{
+    for ( int i = 0; i < 11; ++i )
+    {
+        M_opponent_data[i].changed_ = false;
+    }
+
+    for ( const CoachPlayerObject * p : M_world.opponents() )
+    {
+        if ( p->unum() < 1 || 11 < p->unum() ) continue;
+
+        Data & data = M_opponent_data[p->unum() - 1];
+
+        // a motionless player gives no information about the player type.
+        if ( ! data.pos_.isValid()
+             || data.body_ != p->body().degree()
+             || p->isKicking()
+             || p->isTackling()
+             || data.pos_.dist2( p->pos() ) > 1.0e-10
+             || data.vel_.r2() > 1.0e-10
+             || p->vel().r2() > 1.0e-10 )
+        {
+            data.changed_ = true;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 void
 PlayerTypeAnalyzer::checkTurn()
@@ -705,7 +806,7 @@ PlayerTypeAnalyzer::checkCollisions()
 void
 PlayerTypeAnalyzer::checkKick()
 {
-    static double S_max_kickable_area2 = -1.0;
+    double max_kickable_area2 = 0.0;
 
     for ( int i = 0; i < 11; ++i )
     {
@@ -717,18 +818,14 @@ PlayerTypeAnalyzer::checkKick()
 
     const int max_types = PlayerParam::i().playerTypes();
 
-    if ( S_max_kickable_area2 < 0.0 )
+    for ( const TypeLimit & limit : M_type_limits )
     {
-        for ( int t = 0; t < max_types; ++t )
-        {
-            const PlayerType * player_type = PlayerTypeSet::i().get( t );
-            if ( ! player_type ) continue;
+        if ( ! limit.valid_ ) continue;
 
-            double k2 = std::pow( player_type->kickableArea(), 2 );
-            if ( k2 > S_max_kickable_area2 )
-            {
-                S_max_kickable_area2 = k2;
-            }
+        const double k2 = std::pow( limit.kickable_area_ - 0.001, 2 );
+        if ( k2 > max_kickable_area2 )
+        {
+            max_kickable_area2 = k2;
         }
     }
 
@@ -814,7 +911,7 @@ PlayerTypeAnalyzer::checkKick()
                  && M_teammate_data[i].pos_.isValid() )
             {
                 if ( M_prev_ball.pos().dist2( M_teammate_data[i].pos_ )
-                     < S_max_kickable_area2 )
+                     < max_kickable_area2 )
                 {
                     M_teammate_data[i].maybe_kick_ = true;
                     ++count;
@@ -826,7 +923,7 @@ PlayerTypeAnalyzer::checkKick()
                  && M_opponent_data[i].pos_.isValid() )
             {
                 if ( M_prev_ball.pos().dist2( M_opponent_data[i].pos_ )
-                     < S_max_kickable_area2 )
+                     < max_kickable_area2 )
                 {
                     M_opponent_data[i].maybe_kick_ = true;
                     ++count;
@@ -858,7 +955,11 @@ PlayerTypeAnalyzer::checkKick()
     {
         Data & data = M_opponent_data[kicker_idx];
 
-        if ( data.maybe_collide_ )
+        if ( ! data.isAnalyzed() )
+        {
+            // already determined
+        }
+        else if ( data.maybe_collide_ )
         {
             // cannot determine kick or collide.
 #ifdef DEBUG_PRINT
@@ -875,13 +976,14 @@ PlayerTypeAnalyzer::checkKick()
             {
                 if ( data.invalid_flags_[t] != 0 ) continue;
 
-                const PlayerType * player_type = PlayerTypeSet::i().get( t );
-                if ( ! player_type ) continue;
+                const TypeLimit & limit = M_type_limits[t];
+                if ( ! limit.valid_ ) continue;
 
+                ++M_check_count;
 
-                if ( ball_dist > player_type->kickableArea() + 0.001 )
+                if ( ball_dist > limit.kickable_area_ )
                 {
-                    data.invalid_flags_[t] = 1;
+                    data.setInvalid( t );
 #ifdef DEBUG_PRINT_DETECT_INVALID
                     // std::cout << M_world.ourTeamName() << " coach: " << M_world.time()
                     //           << " opponent " << kicker_idx + 1
@@ -893,7 +995,7 @@ PlayerTypeAnalyzer::checkKick()
                                   " out of range kickable area."
                                   " ball_dist=%f kickable_area=%f",
                                   kicker_idx + 1, t,
-                                  ball_dist, player_type->kickableArea() );
+                                  ball_dist, limit.kickable_area_ - 0.001 );
 #endif
                 }
             }
@@ -924,6 +1026,9 @@ PlayerTypeAnalyzer::checkPlayerDecay()
 
         Data & data = M_opponent_data[p->unum() - 1];
 
+        if ( ! data.isAnalyzed() ) continue;
+        if ( ! data.changed_ ) continue;
+
         // If the player rotates by the two legs dash model,
         // turn and acceleration occur simultaneously.
         // In that case, it is impossible to determine the player type based on the player decay noise
@@ -954,25 +1059,27 @@ PlayerTypeAnalyzer::checkPlayerDecay()
         {
             if ( data.invalid_flags_[t] != 0 ) continue;
 
-            const PlayerType * player_type = PlayerTypeSet::i().get( t );
-            if ( ! player_type ) continue;
+            const TypeLimit & limit = M_type_limits[t];
+            if ( ! limit.valid_ ) continue;
+
+            ++M_check_count;
 
 #if 0
             // old noise model
             double rand_x
                 = std::fabs( ( p->vel().x
-                               - data.vel_.x * player_type->playerDecay() )
-                             / player_type->playerDecay() );
+                               - data.vel_.x * limit.player_decay_ )
+                             / limit.player_decay_ );
 
             double rand_y
                 = std::fabs( ( p->vel().y
-                               - data.vel_.y * player_type->playerDecay() )
-                             / player_type->playerDecay() );
+                               - data.vel_.y * limit.player_decay_ )
+                             / limit.player_decay_ );
 
             if ( rand_x > rand_max + 0.0000001
                  || rand_y > rand_max + 0.0000001 )
             {
-                data.invalid_flags_[t] = 1;
+                data.setInvalid( t );
                 //std::cout << M_world.ourTeamName() << " coach: " << M_world.time()
                 //          << "opponent " << p->unum()
                 //          << "  detect invalid decay. type = "
@@ -982,12 +1089,12 @@ PlayerTypeAnalyzer::checkPlayerDecay()
 #else
             // rcssserver-13 or lator
             const Vector2D noise_vec
-                = ( p->vel() - data.vel_ * player_type->playerDecay() )
-                / player_type->playerDecay();
+                = ( p->vel() - data.vel_ * limit.player_decay_ )
+                / limit.player_decay_;
             const double noise_magnitude = noise_vec.r();
             if ( noise_magnitude > rand_max + 1.0e-10 )
             {
-                data.invalid_flags_[t] = 1;
+                data.setInvalid( t );
 #ifdef DEBUG_PRINT_DETECT_INVALID
                 dlog.addText( Logger::ANALYZER,
                               __FILE__" (checkPlayerDecay) opponent=%d type=%d"
@@ -1016,6 +1123,8 @@ PlayerTypeAnalyzer::checkPlayerSpeedMax()
 
         Data & data = M_opponent_data[p->unum() - 1];
 
+        if ( ! data.isAnalyzed() ) continue;
+        if ( ! data.changed_ ) continue;
         if ( data.turned_ ) continue;
         if ( data.kicked_ ) continue;
         if ( data.maybe_referee_ ) continue;
@@ -1034,20 +1143,22 @@ PlayerTypeAnalyzer::checkPlayerSpeedMax()
         {
             if ( data.invalid_flags_[t] != 0 ) continue;
 
-            const PlayerType * ptype = PlayerTypeSet::i().get( t );
-            if ( ! ptype ) continue;
+            const TypeLimit & limit = M_type_limits[t];
+            if ( ! limit.valid_ ) continue;
+
+            ++M_check_count;
 
             //
             // accel range check
             //
-            const double max_accel = ServerParam::i().maxDashPower() * ptype->dashRate( ptype->effortMax() );
-            const double last_max_noise = ( current_speed / ptype->playerDecay()
+            const double max_accel = limit.max_accel_;
+            const double last_max_noise = ( current_speed / limit.player_decay_
                                             * ServerParam::i().playerRand()
                                             / ( 1.0 + ServerParam::i().playerRand() ) );
 
             if ( last_accel_r > max_accel + last_max_noise + 1.0e-10 )
             {
-                data.invalid_flags_[t] = 1;
+                data.setInvalid( t );
 #ifdef DEBUG_PRINT_DETECT_INVALID
                 std::cout << M_world.ourTeamName() << " coach: " << M_world.time()
                           << " opponent " << p->unum()
@@ -1069,11 +1180,7 @@ PlayerTypeAnalyzer::checkPlayerSpeedMax()
             // speed range check
             //
 
-            // XXX
-            double max_move = ptype->realSpeedMax() * ( 1.0 + ServerParam::i().playerRand() );
-            max_move *= ptype->playerDecay();
-            max_move += ServerParam::i().maxDashPower() * ptype->dashRate( ptype->effortMax() );
-            max_move *= ( 1.0 + ServerParam::i().playerRand() );
+            const double max_move = limit.max_move_;
 
 //             if ( p->unum() == 1 )
 //             {
@@ -1086,7 +1193,7 @@ PlayerTypeAnalyzer::checkPlayerSpeedMax()
 
             if ( last_move_dist > max_move )
             {
-                data.invalid_flags_[t] = 1;
+                data.setInvalid( t );
 #ifdef DEBUG_PRINT_DETECT_INVALID
                 std::cout << M_world.ourTeamName() << " coach: " << M_world.time()
                           << " opponent " << p->unum()
@@ -1122,6 +1229,7 @@ PlayerTypeAnalyzer::checkTurnMoment()
 
         Data & data = M_opponent_data[p->unum() - 1];
 
+        if ( ! data.isAnalyzed() ) continue;
         if ( ! data.turned_ ) continue;
 
         const double player_speed = data.vel_.r();
@@ -1131,14 +1239,16 @@ PlayerTypeAnalyzer::checkTurnMoment()
         {
             if ( data.invalid_flags_[t] != 0 ) continue;
 
-            const PlayerType * ptype = PlayerTypeSet::i().get( t );
-            if ( ! ptype ) continue;
+            const TypeLimit & limit = M_type_limits[t];
+            if ( ! limit.valid_ ) continue;
+
+            ++M_check_count;
 
-            const double max_turn = max_moment / ( 1.0 + ptype->inertiaMoment() * player_speed );
+            const double max_turn = max_moment / ( 1.0 + limit.inertia_moment_ * player_speed );
 
             if ( turn_angle > max_turn * ( 1.0 + ServerParam::i().playerRand() ) + 1.0001 )
             {
-                data.invalid_flags_[t] = 1;
+                data.setInvalid( t );
 #ifdef DEBUG_PRINT_DETECT_INVALID
                 std::cout << M_world.ourTeamName() << " coach: " << M_world.time()
                           << " opponent " << p->unum()
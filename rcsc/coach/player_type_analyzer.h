@@ -51,7 +51,23 @@ class CoachWorldModel;
 class PlayerTypeAnalyzer {
 private:
 
+    /*!
+      \struct TypeLimit
+      \brief player type dependent thresholds used by the analysis.
+      these values are recalculated only when the player types or the
+      server parameters are reloaded.
+     */
+    struct TypeLimit {
+        bool valid_; //!< true if the player type has been received
+        double kickable_area_; //!< kickable area + margin
+        double player_decay_; //!< player decay
+        double max_accel_; //!< maximum dash acceleration
+        double max_move_; //!< maximum one cycle move distance
+        double inertia_moment_; //!< inertia moment
+    };
+
     struct Data {
+        bool changed_; //!< observed state is changed from the last cycle
         bool turned_; //!< player performed turn
         double rotation_; //!< rotated degree
         bool kicked_; //!< player perfomed kick
@@ -65,12 +81,37 @@ private:
 
         //! if invalid data is detected, positive value is set
         std::vector< int > invalid_flags_;
+        int candidate_count_; //!< the number of types not yet invalidated
 
         int type_; //!< estimated type Id
+        GameTime determined_time_; //!< the time when type_ was determined
 
         Data();
         void setDefaultType();
         void setUnknownType();
+        void resizeTypes( const std::size_t max_types );
+
+        /*!
+          \brief check if the player type should be analyzed
+          \return true if the type is not determined yet.
+         */
+        bool isAnalyzed() const
+          {
+              return type_ == Hetero_Unknown;
+          }
+
+        /*!
+          \brief remove the player type from the candidates
+          \param t player type id
+         */
+        void setInvalid( const int t )
+          {
+              if ( invalid_flags_[t] == 0 )
+              {
+                  invalid_flags_[t] = 1;
+                  --candidate_count_;
+              }
+          }
     };
 
     const CoachWorldModel & M_world;
@@ -84,6 +125,12 @@ private:
 
     std::vector< int > M_opponent_type_used_count;
 
+    std::vector< TypeLimit > M_type_limits; //!< thresholds for each player type
+    std::size_t M_server_param_version; //!< ServerParam version used by M_type_limits
+    std::size_t M_player_type_version; //!< PlayerTypeSet version used by M_type_limits
+
+    long M_check_count; //!< total number of (player, type) pair checks
+
     //! not used
     PlayerTypeAnalyzer() = delete;
     //! not used
@@ -137,13 +184,58 @@ public:
           return M_opponent_data[ unum - 1 ].type_;
       }
 
+    /*!
+      \brief get the time when the opponent player's type was determined
+      \param unum target opponent uniform number
+      \return game time. if not determined, the cycle value is negative.
+     */
+    GameTime determinedTime( const int unum ) const
+      {
+          if ( unum < 1 || 11 < unum
+               || M_opponent_data[unum - 1].type_ < 0 )
+          {
+              return GameTime( -1, 0 );
+          }
+          return M_opponent_data[unum - 1].determined_time_;
+      }
+
+    /*!
+      \brief get the number of remaining player type candidates
+      \param unum target opponent uniform number
+      \return the number of candidates
+     */
+    int candidateCount( const int unum ) const
+      {
+          if ( unum < 1 || 11 < unum ) return 0;
+          return M_opponent_data[unum - 1].candidate_count_;
+      }
+
+    /*!
+      \brief get the total number of (player, type) pair checks
+      \return the number of checks
+     */
+    long checkCount() const
+      {
+          return M_check_count;
+      }
+
 private:
 
+    /*!
+      \brief update the threshold table if player types are changed
+     */
+    void updateTypeLimits();
+
     /*!
       \brief reset last seen data
      */
     void updateLastData();
 
+    /*!
+      \brief update changed flags
+     */
+    void checkChanged();
+
     /*!
       \brief analyzer player set
      */
@@ -0,0 +1,177 @@
+// -*-c++-*-
+
+/*!
+  \file player_type_replay.h
+  \brief synthetic replay log for the rcsc::PlayerTypeAnalyzer test and benchmark
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifndef RCSC_COACH_PLAYER_TYPE_REPLAY_H
+#define RCSC_COACH_PLAYER_TYPE_REPLAY_H
+
+#include <rcsc/common/player_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/rcg/types.h>
+
+#include <random>
+#include <vector>
+#include <cmath>
+
+namespace {
+
+/*!
+  \brief simple opponent movement model that follows the server's noise model.
+ */
+struct Mover {
+    const rcsc::PlayerType * type_;
+    rcsc::Vector2D pos_;
+    rcsc::Vector2D vel_;
+    rcsc::AngleDeg body_;
+
+    void step( std::mt19937 & engine )
+      {
+          const rcsc::ServerParam & SP = rcsc::ServerParam::i();
+
+          std::uniform_real_distribution< double > rng( 0.0, 1.0 );
+
+          rcsc::Vector2D accel( 0.0, 0.0 );
+
+          const bool outward = ( pos_.absX() > 40.0
+                                 && pos_.x * body_.cos() > 0.0 );
+          const double r = rng( engine );
+          if ( outward || r < 0.3 )
+          {
+              const double moment = ( outward || rng( engine ) < 0.5
+                                      ? SP.maxMoment()
+                                      : SP.minMoment() );
+              body_ += type_->effectiveTurn( moment, vel_.r() );
+          }
+          else if ( r < 0.5 )
+          {
+              // stay
+          }
+          else
+          {
+              const double power = ( rng( engine ) < 0.5 ? SP.maxDashPower() : SP.maxDashPower() * rng( engine ) );
+              accel = rcsc::Vector2D::polar2vector( power * type_->dashRate( type_->effortMax() ),
+                                                    body_ );
+          }
+
+          rcsc::Vector2D v = vel_ + accel;
+          v += rcsc::Vector2D::polar2vector( v.r() * SP.playerRand() * rng( engine ),
+                                             360.0 * rng( engine ) );
+          if ( v.r() > type_->playerSpeedMax() )
+          {
+              v.setLength( type_->playerSpeedMax() );
+          }
+
+          pos_ += v;
+          vel_ = v * type_->playerDecay();
+      }
+};
+
+
+/*!
+  \brief load the player types with the same values as rcssserver's default player_param
+ */
+inline
+void
+setup_player_types()
+{
+    rcsc::PlayerParam::instance().parse( "(player_param (player_types 18)"
+                                         "(player_decay_delta_min -0.1)"
+                                         "(player_decay_delta_max 0.1))",
+                                         18.0 );
+    rcsc::PlayerTypeSet::instance().generate( 4321 );
+}
+
+/*!
+  \brief create the log data. the left team stays still, and the right
+  team moves by the heterogeneous types.
+  \param max_cycle the number of cycles
+  \param true_types the type id of each right player is stored to this
+  \return the display data of each cycle
+ */
+inline
+std::vector< rcsc::rcg::DispInfoT >
+create_replay_log( const int max_cycle,
+                   int * true_types )
+{
+    std::mt19937 engine( 1234 );
+
+    Mover movers[11];
+    for ( int i = 0; i < 11; ++i )
+    {
+        true_types[i] = i % ( rcsc::PlayerParam::i().playerTypes() - 1 ) + 1;
+        movers[i].type_ = rcsc::PlayerTypeSet::i().get( true_types[i] );
+        movers[i].pos_.assign( -30.0 + 6.0 * i, -30.0 + 6.0 * i );
+        movers[i].vel_.assign( 0.0, 0.0 );
+        movers[i].body_ = 0.0;
+    }
+
+    std::vector< rcsc::rcg::DispInfoT > log;
+    log.reserve( max_cycle );
+    for ( int c = 1; c <= max_cycle; ++c )
+    {
+        rcsc::rcg::DispInfoT disp;
+        disp.pmode_ = rcsc::PM_PlayOn;
+        disp.team_[0].name_ = "left";
+        disp.team_[1].name_ = "right";
+        disp.show_.time_ = c;
+
+        for ( int i = 0; i < 22; ++i )
+        {
+            rcsc::rcg::PlayerT & p = disp.show_.player_[i];
+            p.side_ = ( i < 11 ? 'l' : 'r' );
+            p.unum_ = static_cast< rcsc::rcg::Int16 >( i % 11 + 1 );
+            p.state_ = rcsc::rcg::STAND;
+            if ( i < 11 )
+            {
+                p.type_ = 0;
+                p.x_ = -50.0f + 2.0f * i;
+                p.y_ = 33.5f;
+            }
+            else
+            {
+                Mover & m = movers[i - 11];
+                m.step( engine );
+                p.type_ = static_cast< rcsc::rcg::Int16 >( true_types[i - 11] );
+                p.x_ = static_cast< float >( m.pos_.x );
+                p.y_ = static_cast< float >( m.pos_.y );
+                p.vx_ = static_cast< float >( m.vel_.x );
+                p.vy_ = static_cast< float >( m.vel_.y );
+                p.body_ = static_cast< float >( m.body_.degree() );
+            }
+        }
+
+        log.push_back( disp );
+    }
+
+    return log;
+}
+
+}
+
+#endif
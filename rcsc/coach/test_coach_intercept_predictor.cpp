@@ -0,0 +1,283 @@
+// -*-c++-*-
+
+/*!
+  \file test_coach_intercept_predictor.cpp
+  \brief test code for rcsc::CoachInterceptPredictor
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "coach_intercept_predictor.h"
+#include "coach_world_state.h"
+#include "coach_player_object.h"
+#include "coach_ball_object.h"
+
+#include <rcsc/rcg/types.h>
+#include <rcsc/time/timer.h>
+#include <rcsc/game_mode.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+#include <vector>
+#include <iostream>
+
+namespace {
+
+std::vector< rcsc::CoachWorldState::Ptr >
+create_states( const int n_state )
+{
+    std::mt19937 engine( 1 );
+    std::uniform_real_distribution<> x_rng( -52.0, 52.0 );
+    std::uniform_real_distribution<> y_rng( -34.0, 34.0 );
+    std::uniform_real_distribution<> vel_rng( -0.5, 0.5 );
+    std::uniform_real_distribution<> ball_vel_rng( -2.5, 2.5 );
+    std::uniform_real_distribution<> dir_rng( -180.0, 180.0 );
+
+    std::vector< rcsc::CoachWorldState::Ptr > states;
+    rcsc::CoachWorldState::Ptr prev;
+    for ( int k = 0; k < n_state; ++k )
+    {
+        rcsc::rcg::DispInfoT disp;
+        disp.show_.ball_.x_ = static_cast< float >( x_rng( engine ) );
+        disp.show_.ball_.y_ = static_cast< float >( y_rng( engine ) );
+        disp.show_.ball_.vx_ = static_cast< float >( ball_vel_rng( engine ) );
+        disp.show_.ball_.vy_ = static_cast< float >( ball_vel_rng( engine ) );
+        for ( int i = 0; i < 22; ++i )
+        {
+            rcsc::rcg::PlayerT & p = disp.show_.player_[i];
+            p.side_ = ( i < 11 ? 'l' : 'r' );
+            p.state_ = rcsc::rcg::STAND;
+            if ( i % 11 == 0 ) p.state_ |= rcsc::rcg::GOALIE;
+            if ( k % 7 == 0 && i % 5 == 1 ) p.state_ |= rcsc::rcg::TACKLE;
+            p.unum_ = static_cast< rcsc::rcg::Int16 >( i % 11 + 1 );
+            p.type_ = 0;
+            p.x_ = static_cast< float >( x_rng( engine ) );
+            p.y_ = static_cast< float >( y_rng( engine ) );
+            p.vx_ = static_cast< float >( vel_rng( engine ) );
+            p.vy_ = static_cast< float >( vel_rng( engine ) );
+            p.body_ = static_cast< float >( dir_rng( engine ) );
+        }
+
+        prev.reset( new rcsc::CoachWorldState( disp,
+                                               rcsc::GameTime( k, 0 ),
+                                               rcsc::GameMode(),
+                                               prev ) );
+        states.push_back( prev );
+    }
+
+    return states;
+}
+
+}
+
+class CoachInterceptPredictorTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( CoachInterceptPredictorTest );
+    CPPUNIT_TEST( testPredictAll );
+    CPPUNIT_TEST( testQuery );
+    CPPUNIT_TEST( testBench );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testPredictAll();
+    void testQuery();
+    void testBench();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CoachInterceptPredictorTest );
+
+/*-------------------------------------------------------------------*/
+void
+CoachInterceptPredictorTest::testPredictAll()
+{
+    const std::vector< rcsc::CoachWorldState::Ptr > states = create_states( 50 );
+
+    std::vector< int > steps;
+    for ( const rcsc::CoachWorldState::Ptr & s : states )
+    {
+        rcsc::CoachInterceptPredictor predictor( s->ball() );
+        for ( const rcsc::CoachPlayerObject * p : s->allPlayers() )
+        {
+            predictor.addPlayer( *p );
+        }
+        CPPUNIT_ASSERT_EQUAL( 22, predictor.playerCount() );
+
+        predictor.predictAll( &steps );
+        CPPUNIT_ASSERT_EQUAL( std::size_t( 22 ), steps.size() );
+
+        int i = 0;
+        for ( const rcsc::CoachPlayerObject * p : s->allPlayers() )
+        {
+            CPPUNIT_ASSERT_EQUAL( predictor.predict( *p ), steps[i] );
+            // the world state stores the same value if reachable
+            if ( steps[i] >= 0 )
+            {
+                CPPUNIT_ASSERT_EQUAL( p->ballReachStep(), steps[i] );
+            }
+            ++i;
+        }
+
+        if ( s->fastestInterceptPlayer() )
+        {
+            CPPUNIT_ASSERT( s->ballReachStep() >= 0 );
+            for ( int v : steps )
+            {
+                CPPUNIT_ASSERT( v < 0 || s->ballReachStep() <= v );
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+CoachInterceptPredictorTest::testQuery()
+{
+    const std::vector< rcsc::CoachWorldState::Ptr > states = create_states( 20 );
+
+    std::vector< int > steps;
+    for ( const rcsc::CoachWorldState::Ptr & s : states )
+    {
+        rcsc::CoachInterceptPredictor batch;
+        for ( const rcsc::CoachPlayerObject * p : s->allPlayers() )
+        {
+            batch.addPlayer( *p );
+        }
+
+        // hypothetical ball states taken from the other states
+        for ( const rcsc::CoachWorldState::Ptr & b : states )
+        {
+            batch.predictAll( b->ball().pos(), b->ball().vel(), &steps );
+            CPPUNIT_ASSERT_EQUAL( std::size_t( 22 ), steps.size() );
+            CPPUNIT_ASSERT( batch.ballCache().size() >= 1 );
+            CPPUNIT_ASSERT( batch.ballCache().front() == b->ball().pos() );
+
+            rcsc::CoachInterceptPredictor single( b->ball() );
+            int i = 0;
+            for ( const rcsc::CoachPlayerObject * p : s->allPlayers() )
+            {
+                CPPUNIT_ASSERT_EQUAL( single.predict( *p ), steps[i] );
+                ++i;
+            }
+        }
+    }
+
+    rcsc::CoachInterceptPredictor empty;
+    empty.predictAll( rcsc::Vector2D( 0.0, 0.0 ), rcsc::Vector2D( 1.0, 0.0 ), &steps );
+    CPPUNIT_ASSERT( steps.empty() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+CoachInterceptPredictorTest::testBench()
+{
+    const std::vector< rcsc::CoachWorldState::Ptr > states = create_states( 100 );
+
+    long sum_single = 0;
+    long sum_batch = 0;
+
+    rcsc::Timer timer;
+    for ( const rcsc::CoachWorldState::Ptr & s : states )
+    {
+        for ( const rcsc::CoachWorldState::Ptr & b : states )
+        {
+            rcsc::CoachInterceptPredictor predictor( b->ball() );
+            for ( const rcsc::CoachPlayerObject * p : s->allPlayers() )
+            {
+                sum_single += predictor.predict( *p );
+            }
+        }
+    }
+    const double single_msec = timer.elapsedReal();
+
+    std::vector< int > steps;
+    timer.restart();
+    for ( const rcsc::CoachWorldState::Ptr & s : states )
+    {
+        rcsc::CoachInterceptPredictor predictor;
+        for ( const rcsc::CoachPlayerObject * p : s->allPlayers() )
+        {
+            predictor.addPlayer( *p );
+        }
+
+        for ( const rcsc::CoachWorldState::Ptr & b : states )
+        {
+            predictor.predictAll( b->ball().pos(), b->ball().vel(), &steps );
+            for ( int v : steps )
+            {
+                sum_batch += v;
+            }
+        }
+    }
+    const double batch_msec = timer.elapsedReal();
+
+    std::cerr << "\n  intercept query x" << states.size() * states.size()
+              << ": single " << single_msec << " ms"
+              << ", batch " << batch_msec << " ms" << std::endl;
+
+    CPPUNIT_ASSERT_EQUAL( sum_single, sum_batch );
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,286 @@
+// -*-c++-*-
+
+/*!
+  \file test_coach_state_history.cpp
+  \brief test code for rcsc::CoachStateHistory
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "coach_state_history.h"
+#include "coach_world_state.h"
+
+#include <rcsc/rcg/types.h>
+#include <rcsc/game_mode.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace {
+
+rcsc::CoachWorldState::Ptr
+create_state( const long cycle,
+              const long stopped,
+              const rcsc::CoachWorldState::Ptr & prev )
+{
+    rcsc::rcg::DispInfoT disp;
+    disp.show_.ball_.x_ = static_cast< float >( cycle );
+    disp.show_.ball_.y_ = static_cast< float >( stopped );
+    for ( int i = 0; i < 22; ++i )
+    {
+        disp.show_.player_[i].side_ = ( i < 11 ? 'l' : 'r' );
+        disp.show_.player_[i].state_ = rcsc::rcg::STAND;
+        disp.show_.player_[i].unum_ = static_cast< rcsc::rcg::Int16 >( i % 11 + 1 );
+        disp.show_.player_[i].x_ = static_cast< float >( i - 11 );
+    }
+
+    return rcsc::CoachWorldState::Ptr( new rcsc::CoachWorldState( disp,
+                                                                  rcsc::GameTime( cycle, stopped ),
+                                                                  rcsc::GameMode(),
+                                                                  prev ) );
+}
+
+}
+
+class CoachStateHistoryTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( CoachStateHistoryTest );
+    CPPUNIT_TEST( testFind );
+    CPPUNIT_TEST( testWrapAround );
+    CPPUNIT_TEST( testStoppedGap );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testFind();
+    void testWrapAround();
+    void testStoppedGap();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CoachStateHistoryTest );
+
+/*-------------------------------------------------------------------*/
+void
+CoachStateHistoryTest::testFind()
+{
+    rcsc::CoachStateHistory history( 100 );
+    rcsc::CoachWorldState::Ptr state;
+
+    // cycle 0-9, 5 stopped cycles at 10, then 11-19
+    for ( long c = 0; c < 20; ++c )
+    {
+        const long n = ( c == 10 ? 5 : 1 );
+        for ( long s = 0; s < n; ++s )
+        {
+            state = create_state( c, s, state );
+            history.push( *state );
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 24 ), history.size() );
+    CPPUNIT_ASSERT_EQUAL( 0L, history.front().cycle_ );
+    CPPUNIT_ASSERT_EQUAL( 19L, history.back().cycle_ );
+
+    for ( long s = 0; s < 5; ++s )
+    {
+        const rcsc::CoachStateSnapshot * p = history.find( rcsc::GameTime( 10, s ) );
+        CPPUNIT_ASSERT( p );
+        CPPUNIT_ASSERT_EQUAL( 10L, p->cycle_ );
+        CPPUNIT_ASSERT_EQUAL( s, p->stopped_ );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( double( s ), p->ballPos().y, 1.0e-6 );
+
+        const rcsc::CoachPlayerSnapshot * player = p->player( rcsc::RIGHT, 3 );
+        CPPUNIT_ASSERT( player );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0, player->pos().x, 1.0e-6 );
+    }
+
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 10, 5 ) ) );
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 5, 1 ) ) );
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 20, 0 ) ) );
+
+    long count = 0;
+    for ( rcsc::CoachStateHistory::const_iterator it = history.window( 3 ), end = history.end();
+          it != end;
+          ++it )
+    {
+        CPPUNIT_ASSERT_EQUAL( 17L + count, it->cycle_ );
+        ++count;
+    }
+    CPPUNIT_ASSERT_EQUAL( 3L, count );
+}
+
+/*-------------------------------------------------------------------*/
+void
+CoachStateHistoryTest::testWrapAround()
+{
+    rcsc::CoachStateHistory history( 10 );
+    rcsc::CoachWorldState::Ptr state;
+
+    for ( long c = 0; c < 25; ++c )
+    {
+        state = create_state( c, 0, state );
+        history.push( *state );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 10 ), history.size() );
+    CPPUNIT_ASSERT_EQUAL( 15L, history.front().cycle_ );
+    CPPUNIT_ASSERT_EQUAL( 24L, history.back().cycle_ );
+    CPPUNIT_ASSERT_EQUAL( 10L, long( history.end() - history.begin() ) );
+
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 14, 0 ) ) );
+    for ( long c = 15; c < 25; ++c )
+    {
+        const rcsc::CoachStateSnapshot * p = history.find( rcsc::GameTime( c, 0 ) );
+        CPPUNIT_ASSERT( p );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( double( c ), p->ballPos().x, 1.0e-6 );
+    }
+
+    history.clear();
+    CPPUNIT_ASSERT( history.empty() );
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 20, 0 ) ) );
+
+    history.setCapacity( 5 );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 5 ), history.capacity() );
+    for ( long c = 0; c < 8; ++c )
+    {
+        state = create_state( c, 0, state );
+        history.push( *state );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 5 ), history.size() );
+    CPPUNIT_ASSERT_EQUAL( 3L, history.front().cycle_ );
+    CPPUNIT_ASSERT_EQUAL( 7L, history.back().cycle_ );
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 2, 0 ) ) );
+    CPPUNIT_ASSERT( history.find( rcsc::GameTime( 3, 0 ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+void
+CoachStateHistoryTest::testStoppedGap()
+{
+    rcsc::CoachStateHistory history( 100 );
+    rcsc::CoachWorldState::Ptr state;
+
+    // the see messages at the stopped time 1, 4 and 5 in cycle 10 are missed.
+    const long stopped_times[] = { 0, 2, 3, 6, 7 };
+
+    for ( long c = 8; c < 13; ++c )
+    {
+        if ( c == 10 )
+        {
+            for ( const long s : stopped_times )
+            {
+                state = create_state( c, s, state );
+                history.push( *state );
+            }
+        }
+        else
+        {
+            state = create_state( c, 0, state );
+            history.push( *state );
+        }
+    }
+
+    for ( const long s : stopped_times )
+    {
+        const rcsc::CoachStateSnapshot * p = history.find( rcsc::GameTime( 10, s ) );
+        CPPUNIT_ASSERT( p );
+        CPPUNIT_ASSERT_EQUAL( 10L, p->cycle_ );
+        CPPUNIT_ASSERT_EQUAL( s, p->stopped_ );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( double( s ), p->ballPos().y, 1.0e-6 );
+    }
+
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 10, 1 ) ) );
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 10, 4 ) ) );
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 10, 5 ) ) );
+    CPPUNIT_ASSERT( ! history.find( rcsc::GameTime( 10, 8 ) ) );
+
+    for ( long c = 8; c < 13; ++c )
+    {
+        const rcsc::CoachStateSnapshot * p = history.find( rcsc::GameTime( c, 0 ) );
+        CPPUNIT_ASSERT( p );
+        CPPUNIT_ASSERT_EQUAL( c, p->cycle_ );
+    }
+
+    // the gap is also handled after the first state of the cycle is overwritten.
+    rcsc::CoachStateHistory small_history( 4 );
+    state.reset();
+    for ( long c = 9; c < 12; ++c )
+    {
+        for ( const long s : stopped_times )
+        {
+            if ( c != 10 && s != 0 ) continue;
+            state = create_state( c, s, state );
+            small_history.push( *state );
+        }
+    }
+
+    CPPUNIT_ASSERT( ! small_history.find( rcsc::GameTime( 10, 0 ) ) );
+    CPPUNIT_ASSERT( ! small_history.find( rcsc::GameTime( 10, 2 ) ) );
+    CPPUNIT_ASSERT( small_history.find( rcsc::GameTime( 10, 3 ) ) );
+    CPPUNIT_ASSERT( small_history.find( rcsc::GameTime( 10, 6 ) ) );
+    CPPUNIT_ASSERT( small_history.find( rcsc::GameTime( 10, 7 ) ) );
+    CPPUNIT_ASSERT( small_history.find( rcsc::GameTime( 11, 0 ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+// -*-c++-*-
+
+/*!
+  \file test_player_type_analyzer.cpp
+  \brief test code for rcsc::PlayerTypeAnalyzer
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "player_type_analyzer.h"
+#include "coach_world_model.h"
+
+#include "player_type_replay.h"
+
+#include <rcsc/common/player_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/common/server_param.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class PlayerTypeAnalyzerTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( PlayerTypeAnalyzerTest );
+    CPPUNIT_TEST( testReplay );
+    CPPUNIT_TEST( testParamVersion );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testReplay();
+    void testParamVersion();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( PlayerTypeAnalyzerTest );
+
+/*-------------------------------------------------------------------*/
+void
+PlayerTypeAnalyzerTest::testReplay()
+{
+    const int max_cycle = 6000;
+
+    setup_player_types();
+
+    int true_types[11];
+    const std::vector< rcsc::rcg::DispInfoT > log = create_replay_log( max_cycle, true_types );
+    for ( int i = 0; i < 11; ++i )
+    {
+        CPPUNIT_ASSERT( rcsc::PlayerTypeSet::i().get( true_types[i] ) );
+    }
+
+    rcsc::CoachWorldModel wm;
+    wm.init( "left", rcsc::LEFT, 18 );
+
+    rcsc::PlayerTypeAnalyzer analyzer( wm );
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        analyzer.reset( unum );
+    }
+
+    for ( const rcsc::rcg::DispInfoT & disp : log )
+    {
+        wm.updateAll( disp );
+        analyzer.update();
+    }
+
+    int determined = 0;
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        const int type = analyzer.playerTypeId( unum );
+        if ( type == rcsc::Hetero_Unknown )
+        {
+            continue;
+        }
+
+        CPPUNIT_ASSERT_EQUAL( true_types[unum - 1], type );
+        CPPUNIT_ASSERT( analyzer.determinedTime( unum ).cycle() > 0 );
+        ++determined;
+    }
+
+    CPPUNIT_ASSERT( determined > 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
+
+/*-------------------------------------------------------------------*/
+void
+PlayerTypeAnalyzerTest::testParamVersion()
+{
+    // the type limits in PlayerTypeAnalyzer are keyed on these versions.
+    const std::size_t server_param_version = rcsc::ServerParam::i().version();
+    const std::size_t player_type_version = rcsc::PlayerTypeSet::i().version();
+
+    CPPUNIT_ASSERT( rcsc::ServerParam::instance().parse( "(server_param (player_rand 0.1))", 18.0 ) );
+    CPPUNIT_ASSERT( rcsc::ServerParam::i().version() != server_param_version );
+    CPPUNIT_ASSERT_EQUAL( player_type_version, rcsc::PlayerTypeSet::i().version() );
+
+    rcsc::PlayerTypeSet::instance().generate( 1234 );
+    CPPUNIT_ASSERT( rcsc::PlayerTypeSet::i().version() != player_type_version );
+
+    const std::size_t generated_version = rcsc::PlayerTypeSet::i().version();
+    rcsc::PlayerTypeSet::instance().insert( rcsc::PlayerType() );
+    CPPUNIT_ASSERT( rcsc::PlayerTypeSet::i().version() != generated_version );
+}
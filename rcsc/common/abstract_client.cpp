@@ -243,6 +243,22 @@ AbstractClient::handleTimeout( SoccerAgent * agent,
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+std::int64_t
+AbstractClient::nextTimeoutUSec( const SoccerAgent * agent ) const
+{
+    const std::int64_t usec = agent->nextTimeoutUSec();
+    if ( usec < 0 )
+    {
+        return static_cast< std::int64_t >( M_interval_msec ) * 1000;
+    }
+
+    return usec;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 void
 AbstractClient::handleExit( SoccerAgent * agent )
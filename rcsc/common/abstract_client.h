@@ -34,6 +34,7 @@
 
 #include <memory>
 #include <string>
+#include <cstdint>
 
 namespace rcsc {
 
@@ -254,6 +255,14 @@ protected:
                         const int timeout_count,
                         const int waited_msec );
 
+    /*!
+      \brief get the time until the next timeout event.
+      \param agent pointer to the agent instance.
+      \return micro seconds from now. if the agent has no deadline,
+      the value of intervalMSec() is returned.
+     */
+    std::int64_t nextTimeoutUSec( const SoccerAgent * agent ) const;
+
     /*!
       \brief just call agent->handleExit()
       \param agent pointer to the agent instance.
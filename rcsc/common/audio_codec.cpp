@@ -99,11 +99,15 @@ namespace rcsc {
 
 const double AudioCodec::ERROR_VALUE = std::numeric_limits< double >::max();
 
+//! the default table is built at compile time
+static constexpr AudioCodec::CharTable DEFAULT_CHAR_TABLE = AudioCodec::make_char_table( 0 );
+
 /*-------------------------------------------------------------------*/
 /*!
 
 */
 AudioCodec::AudioCodec()
+    : M_char_to_int( DEFAULT_CHAR_TABLE )
 {
     createMap( 0 );
 }
@@ -138,27 +142,21 @@ AudioCodec::i()
 void
 AudioCodec::createMap( const int shift )
 {
-    //[-0-9a-zA-Z ().+*/?<>_]
-    M_char_set =
-        "abcdefghijklmnopqrstuvwxyz"
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        " ().+-*/?<>_"
-        "0123456789";
-
-    const int char_size = static_cast< int >( M_char_set.size() );
-    M_int_to_char_map.resize( char_size, '0' );
+    M_char_to_int = make_char_table( shift );
 
-    int shift_val = shift;
-    if ( shift_val < 0 ) shift_val = -shift_val;
+    M_char_to_int_map.clear();
+    M_int_to_char_map.resize( CHAR_SIZE, '0' );
 
-    for ( int i = 0; i < char_size; ++i )
+    for ( int c = 0; c < 256; ++c )
     {
-        int ch_i = ( i + shift_val ) % char_size;
-        char ch = M_char_set[ch_i];
-
-        //M_char_to_int_map.insert( std::make_pair( M_char_set[ch_i], i ) );
-        M_char_to_int_map[ ch ] = i;
-        M_int_to_char_map[i] = ch;
+        const int i = M_char_to_int[c];
+        if ( i >= 0 )
+        {
+            const char ch = static_cast< char >( c );
+            M_int_to_char[i] = ch;
+            M_char_to_int_map[ch] = i;
+            M_int_to_char_map[i] = ch;
+        }
     }
 }
 
@@ -169,22 +167,27 @@ AudioCodec::createMap( const int shift )
 bool
 AudioCodec::encodeInt64ToStr( const std::int64_t & ival,
                               const int len,
-                              std::string & to ) const
+                              char * to ) const
 {
-    std::vector< int > remainder_values;
-    remainder_values.reserve( len );
+    if ( ival < 0
+         || len <= 0 )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " ***ERROR*** AudioCodec::encodeInt64ToStr."
+                  << " Illegal value. "
+                  << std::endl;
+        return false;
+    }
 
     std::int64_t divided = ival;
 
-    const int char_size = static_cast< int >( M_char_set.size() );
-
-    for ( int i = 0; i < len - 1; ++i )
+    for ( int i = len - 1; i > 0; --i )
     {
-        remainder_values.push_back( divided % char_size );
-        divided /= char_size;
+        to[i] = M_int_to_char[divided % CHAR_SIZE];
+        divided /= CHAR_SIZE;
     }
 
-    if ( divided >= char_size )
+    if ( divided >= CHAR_SIZE )
     {
         std::cerr << __FILE__ << ':' << __LINE__
                   << " ***ERROR*** AudioCodec::encodeInt64ToStr."
@@ -193,23 +196,31 @@ AudioCodec::encodeInt64ToStr( const std::int64_t & ival,
         return false;
     }
 
-    remainder_values.push_back( divided );
+    to[0] = M_int_to_char[divided];
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
 
-    try
+*/
+bool
+AudioCodec::encodeInt64ToStr( const std::int64_t & ival,
+                              const int len,
+                              std::string & to ) const
+{
+    if ( len <= 0 )
     {
-        for ( std::vector< int >::reverse_iterator it = remainder_values.rbegin(), end = remainder_values.rend();
-              it != end;
-              ++it )
-        {
-            to += M_int_to_char_map.at( *it );
-        }
+        return false;
     }
-    catch ( std::exception & e )
+
+    const std::size_t old_size = to.size();
+    to.resize( old_size + len );
+
+    if ( ! encodeInt64ToStr( ival, len, &to[old_size] ) )
     {
-        std::cerr << __FILE__ << ':' << __LINE__
-                  << " ***ERROR*** AudioCodec::encodeInt64ToStr."
-                  << " Exception caught: " << e.what()
-                  << std::endl;
+        to.resize( old_size );
         return false;
     }
 
@@ -221,7 +232,7 @@ AudioCodec::encodeInt64ToStr( const std::int64_t & ival,
 
 */
 bool
-AudioCodec::decodeStrToInt64( const std::string & from,
+AudioCodec::decodeStrToInt64( const std::string_view from,
                               std::int64_t * to ) const
 {
     if ( from.empty() )
@@ -229,35 +240,31 @@ AudioCodec::decodeStrToInt64( const std::string & from,
         return false;
     }
 
-    std::int64_t rval = 0;
-    int digit_count = from.length() - 1;
+    // illegal characters are detected after the loop
+    // by checking the sign bit of the accumulated flags.
+    std::uint64_t rval = 0;
+    int flags = 0;
 
-    const int char_size = static_cast< int >( M_char_set.length() );
-
-    for ( std::string::const_iterator ch = from.begin(), end = from.end();
-          ch != end;
-          ++ch, --digit_count )
+    for ( const char ch : from )
     {
-        CharToIntCont::const_iterator it = M_char_to_int_map.find( *ch );
-        if ( it == M_char_to_int_map.end() )
-        {
-            std::cerr << __FILE__ << ": " << __LINE__
-                      << " ***ERROR*** AudioCodec::decodeStrToInt64."
-                      << " Unexpected communication message. ["
-                      << from << "]"
-                      << std::endl;
-            return false;
-        }
+        const int val = M_char_to_int[static_cast< unsigned char >( ch )];
+        flags |= val;
+        rval = rval * CHAR_SIZE + static_cast< std::uint64_t >( val );
+    }
 
-        rval
-            += static_cast< std::int64_t >( it->second )
-            * static_cast< std::int64_t >
-            ( std::pow( static_cast< double >( char_size ), digit_count ) );
+    if ( flags < 0 )
+    {
+        std::cerr << __FILE__ << ": " << __LINE__
+                  << " ***ERROR*** AudioCodec::decodeStrToInt64."
+                  << " Unexpected communication message. ["
+                  << from << "]"
+                  << std::endl;
+        return false;
     }
 
     if ( to )
     {
-        *to = rval;
+        *to = static_cast< std::int64_t >( rval );
     }
 
     return true;
@@ -278,11 +285,9 @@ AudioCodec::encodePercentageToChar( const double & value ) const
         return '\0';
     }
 
-    const int char_size = static_cast< int >( M_char_set.length() );
-
-    int ival = static_cast< int >( rint( value * ( char_size - 1 ) ) * 10000.0 );
+    int ival = static_cast< int >( rint( value * ( CHAR_SIZE - 1 ) ) * 10000.0 );
     ival /= 10000;
-    if ( ival >= char_size )
+    if ( ival < 0 || CHAR_SIZE <= ival )
     {
         std::cerr << __FILE__ << ':' << __LINE__
                   << " ***ERROR*** generated illegal index = "
@@ -290,18 +295,7 @@ AudioCodec::encodePercentageToChar( const double & value ) const
         return '\0';
     }
 
-    try
-    {
-        return  intToCharMap().at( ival );
-    }
-    catch ( ... )
-    {
-        std::cerr << __FILE__ << ": " << __LINE__
-                  << " ***ERROR*** AudioCodec::encodePercentageToChar."
-                  << " Exception caught! Failed to encode"
-                  << std::endl;
-        return '\0';
-    }
+    return M_int_to_char[ival];
 }
 
 /*-------------------------------------------------------------------*/
@@ -311,8 +305,8 @@ AudioCodec::encodePercentageToChar( const double & value ) const
 double
 AudioCodec::decodeCharToPercentage( const char ch ) const
 {
-    CharToIntCont::const_iterator it = charToIntMap().find( ch );
-    if ( it == charToIntMap().end() )
+    const int ival = charToInt( ch );
+    if ( ival < 0 )
     {
         std::cerr << __FILE__ << ": " << __LINE__
                   << " ***ERROR*** AudioCodec::decodeCharToPercentage."
@@ -321,10 +315,8 @@ AudioCodec::decodeCharToPercentage( const char ch ) const
         return ERROR_VALUE;
     }
 
-    const int char_size = static_cast< int >( M_char_set.length() );
-
-    return ( static_cast< double >( it->second )
-             / static_cast< double >( char_size - 1 ) );
+    return ( static_cast< double >( ival )
+             / static_cast< double >( CHAR_SIZE - 1 ) );
 }
 
 /*-------------------------------------------------------------------*/
@@ -551,7 +543,19 @@ AudioCodec::encodePosVelToStr5( const Vector2D & pos,
 
 */
 bool
-AudioCodec::decodeStr5ToPosVel( const std::string & from,
+AudioCodec::encodePosVelToStr5( const Vector2D & pos,
+                                const Vector2D & vel,
+                                char * to ) const
+{
+    return encodeInt64ToStr( posVelToBit31( pos, vel ), 5, to );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+AudioCodec::decodeStr5ToPosVel( const std::string_view from,
                                 Vector2D * pos,
                                 Vector2D * vel ) const
 {
@@ -592,7 +596,19 @@ AudioCodec::encodePosToStr3( const Vector2D & pos,
 
 */
 bool
-AudioCodec::decodeStr3ToPos( const std::string & from,
+AudioCodec::encodePosToStr3( const Vector2D & pos,
+                             char * to ) const
+{
+    return encodeInt64ToStr( static_cast< std::int64_t >( posToBit18( pos ) ),
+                             3, to );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+AudioCodec::decodeStr3ToPos( const std::string_view from,
                              Vector2D * pos ) const
 {
     if ( from.length() != 3 )
@@ -642,7 +658,29 @@ AudioCodec::encodeUnumPosToStr4( const int unum,
 
 */
 bool
-AudioCodec::decodeStr4ToUnumPos( const std::string & from,
+AudioCodec::encodeUnumPosToStr4( const int unum,
+                                 const Vector2D & pos,
+                                 char * to ) const
+{
+    if ( unum < 1 || 11 < unum )
+    {
+        return false;
+    }
+
+    std::int64_t ival = posToBit19( pos );
+
+    ival <<= 4;
+    ival |= static_cast< std::int64_t >( unum ); // 4 bits
+
+    return encodeInt64ToStr( ival, 4, to );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+AudioCodec::decodeStr4ToUnumPos( const std::string_view from,
                                  int * unum,
                                  Vector2D * pos ) const
 {
@@ -681,8 +719,24 @@ std::string
 AudioCodec::encodeCoordToStr2( const double & xy,
                                const double & norm_factor ) const
 {
-    const int char_size = static_cast< int >( M_char_set.length() );
+    char buf[2];
+    if ( ! encodeCoordToStr2( xy, norm_factor, buf ) )
+    {
+        return std::string();
+    }
+
+    return std::string( buf, 2 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
 
+*/
+bool
+AudioCodec::encodeCoordToStr2( const double & xy,
+                               const double & norm_factor,
+                               char * to ) const
+{
     // normalize value
     double tmp = min_max( -norm_factor, xy , norm_factor );
     tmp += norm_factor;
@@ -692,39 +746,26 @@ AudioCodec::encodeCoordToStr2( const double & xy,
 
     int ival = static_cast< int >( rint( tmp ) );
 
-    int i1 = ival % char_size;
-    ival /= char_size;
-    int i2 = ival % char_size;
+    int i1 = ival % CHAR_SIZE;
+    ival /= CHAR_SIZE;
+    int i2 = ival % CHAR_SIZE;
     //std::cout << " posx -> " << ix1 << " " << ix2 << std::endl;
 
-    if ( ival >= char_size )
+    if ( ival >= CHAR_SIZE
+         || i1 < 0 || i2 < 0 )
     {
         std::cerr << __FILE__ << ": " << __LINE__
                   << " ***ERROR*** AudioCodec::encodeCoordToStr2."
                   << " range over. value = " << xy
                   << " norm_factor = " << norm_factor
                   << std::endl;
-        return std::string();
+        return false;
     }
 
-    std::string msg;
-    msg.reserve( 2 );
+    to[0] = M_int_to_char[i1];
+    to[1] = M_int_to_char[i2];
 
-    try
-    {
-        msg += intToCharMap().at( i1 );
-        msg += intToCharMap().at( i2 );
-    }
-    catch ( ... )
-    {
-        std::cerr << __FILE__ << ": " << __LINE__
-                  << " ***ERROR*** AudioCodec::encodeCoordToStr2."
-                  << " Exception caught! "
-                  << std::endl;
-        return std::string();
-    }
-
-    return msg;
+    return true;
 }
 
 /*-------------------------------------------------------------------*/
@@ -736,10 +777,8 @@ AudioCodec::decodeStr2ToCoord( const char ch1,
                                const char ch2,
                                const double & norm_factor ) const
 {
-    const CharToIntCont::const_iterator end = charToIntMap().end();
-
-    CharToIntCont::const_iterator it = charToIntMap().find( ch1 );
-    if ( it == end )
+    const int i1 = charToInt( ch1 );
+    if ( i1 < 0 )
     {
         std::cerr << __FILE__ << ": " << __LINE__
                   << " ***ERROR*** AudioCodec::decodeStr2ToCoord()."
@@ -747,10 +786,9 @@ AudioCodec::decodeStr2ToCoord( const char ch1,
                   << std::endl;
         return ERROR_VALUE;
     }
-    int i1 = it->second;
 
-    it = charToIntMap().find( ch2 );
-    if ( it == end )
+    const int i2 = charToInt( ch2 );
+    if ( i2 < 0 )
     {
         std::cerr << __FILE__ << ": " << __LINE__
                   << " ***ERROR*** AudioCodec::decodeStr2ToCoord()."
@@ -758,13 +796,10 @@ AudioCodec::decodeStr2ToCoord( const char ch1,
                   << std::endl;
         return ERROR_VALUE;
     }
-    int i2 = it->second;
-
-    const int char_size = static_cast< int >( M_char_set.length() );
 
     return
         (
-         static_cast< double >( i1 + i2 * char_size ) * COORD_STEP_L2
+         static_cast< double >( i1 + i2 * CHAR_SIZE ) * COORD_STEP_L2
          - norm_factor
          );
 }
@@ -776,21 +811,33 @@ AudioCodec::decodeStr2ToCoord( const char ch1,
 std::string
 AudioCodec::encodePosToStr4( const Vector2D & pos ) const
 {
-    std::string pos_str;
-    pos_str.reserve( 4 );
+    char buf[4];
+    if ( ! encodePosToStr4( pos, buf ) )
+    {
+        return std::string();
+    }
 
-    pos_str += encodeCoordToStr2( pos.x, X_NORM_FACTOR );
-    pos_str += encodeCoordToStr2( pos.y, Y_NORM_FACTOR );
+    return std::string( buf, 4 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
 
-    if ( pos_str.length() != 4 )
+ */
+bool
+AudioCodec::encodePosToStr4( const Vector2D & pos,
+                             char * to ) const
+{
+    if ( ! encodeCoordToStr2( pos.x, X_NORM_FACTOR, to )
+         || ! encodeCoordToStr2( pos.y, Y_NORM_FACTOR, to + 2 ) )
     {
         std::cerr << "AudioCodec::encodePosToStr4(). "
                   << "Failed to encode " << pos
                   << std::endl;
-        pos_str.clear();
+        return false;
     }
 
-    return pos_str;
+    return true;
 }
 
 /*-------------------------------------------------------------------*/
@@ -798,7 +845,7 @@ AudioCodec::encodePosToStr4( const Vector2D & pos ) const
 
  */
 Vector2D
-AudioCodec::decodeStr4ToPos( const std::string & msg ) const
+AudioCodec::decodeStr4ToPos( const std::string_view msg ) const
 {
     if ( msg.length() < 4 )
     {
@@ -847,20 +894,16 @@ AudioCodec::encodeSpeedToChar( const double & val ) const
 
     int ival = static_cast< int >( rint( tmp ) );
 
-    try
-    {
-        return  intToCharMap().at( ival );
-    }
-    catch ( ... )
+    if ( ival < 0 || CHAR_SIZE <= ival )
     {
         std::cerr << __FILE__ << ": " << __LINE__
                   << " ***ERROR*** AudioCodec::encodeSpeedL1."
-                  << " Exception caught! Failed to encode"
+                  << " Failed to encode " << val
                   << std::endl;
         return '\0';
     }
 
-    return '\0';
+    return M_int_to_char[ival];
 }
 
 /*-------------------------------------------------------------------*/
@@ -870,8 +913,8 @@ AudioCodec::encodeSpeedToChar( const double & val ) const
 double
 AudioCodec::decodeCharToSpeed( const char ch ) const
 {
-    CharToIntCont::const_iterator it = charToIntMap().find( ch );
-    if ( it == charToIntMap().end() )
+    const int ival = charToInt( ch );
+    if ( ival < 0 )
     {
         std::cerr << __FILE__ << ": " << __LINE__
                   << " ***ERROR*** AudioCodec::decodeSpeedL1."
@@ -881,7 +924,7 @@ AudioCodec::decodeCharToSpeed( const char ch ) const
     }
 
     return
-        ( static_cast< double >( it->second ) * SPEED_STEP_L1
+        ( static_cast< double >( ival ) * SPEED_STEP_L1
           - SPEED_NORM_FACTOR
           );
 }
@@ -36,7 +36,9 @@
 
 #include <unordered_map>
 #include <vector>
+#include <array>
 #include <string>
+#include <string_view>
 #include <cmath>
 #include <cstdint>
 
@@ -51,17 +53,34 @@ public:
     typedef std::unordered_map< char, int > CharToIntCont; //!< map from char to int
     typedef std::vector< char > IntToCharCont; //!< map from int to char
 
+    //! available characters in the say message: [a-zA-Z ().+-*/?<>_0-9]
+    static constexpr char CHAR_SET[] =
+        "abcdefghijklmnopqrstuvwxyz"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+        " ().+-*/?<>_"
+        "0123456789";
+
+    //! the number of available characters (= 74)
+    static constexpr int CHAR_SIZE = static_cast< int >( sizeof( CHAR_SET ) - 1 );
+
+    //! direct-index table type. index: unsigned char value, value: integer or -1
+    typedef std::array< int, 256 > CharTable;
+
     //! constant error value (= std::numeric_limits< double >::max())
     static const double ERROR_VALUE;
 
 private:
 
-    std::string M_char_set;
+    //! direct-index table to convert character to integer. -1 means an illegal character.
+    CharTable M_char_to_int;
 
-    //! map to cnvert character to integer. key: char, value int
+    //! table to convert integer to character
+    std::array< char, CHAR_SIZE > M_int_to_char;
+
+    //! map to cnvert character to integer. kept for the backward compatibility.
     CharToIntCont M_char_to_int_map;
 
-    //! map to cnvert integer to character. vector of char
+    //! map to cnvert integer to character. kept for the backward compatibility.
     IntToCharCont M_int_to_char_map;
 
     /*!
@@ -83,8 +102,34 @@ public:
      */
     static const AudioCodec & i();
 
+    /*!
+      \brief create the conversion tables with the rotated character set
+      \param shift rotation size of the character set
+     */
     void createMap( const int shift );
 
+    /*!
+      \brief build the character to integer table at compile time
+      \param shift rotation size of the character set
+      \return direct-index table
+     */
+    static constexpr
+    CharTable make_char_table( const int shift )
+      {
+          CharTable table{};
+          for ( int c = 0; c < 256; ++c )
+          {
+              table[c] = -1;
+          }
+
+          const int s = ( shift < 0 ? -shift : shift );
+          for ( int i = 0; i < CHAR_SIZE; ++i )
+          {
+              table[static_cast< unsigned char >( CHAR_SET[( i + s ) % CHAR_SIZE] )] = i;
+          }
+          return table;
+      }
+
 private:
 
     /*!
@@ -139,7 +184,30 @@ private:
 public:
 
     /*!
-      \brief get character to interger map object
+      \brief convert the character to the integer value
+      \param ch character to be converted
+      \return integer value [0, CHAR_SIZE), or -1 if ch is illegal
+     */
+    int charToInt( const char ch ) const
+      {
+          return M_char_to_int[static_cast< unsigned char >( ch )];
+      }
+
+    /*!
+      \brief convert the integer value to the character
+      \param val integer value to be converted
+      \return converted character, or the null character if val is out of range
+     */
+    char intToChar( const int val ) const
+      {
+          return ( 0 <= val && val < CHAR_SIZE
+                   ? M_int_to_char[val]
+                   : '\0' );
+      }
+
+    /*!
+      \brief get character to interger map object.
+      charToInt() should be used instead.
       \return const reference to the map object
     */
     const CharToIntCont & charToIntMap() const
@@ -148,7 +216,8 @@ public:
       }
 
     /*!
-      \brief get integer to character map object
+      \brief get integer to character map object.
+      intToChar() should be used instead.
       \return const reference to the map object
     */
     const IntToCharCont & intToCharMap() const
@@ -156,11 +225,23 @@ public:
           return M_int_to_char_map;
       }
 
+    /*!
+      \brief encode decimal (64bit) integer to the fixed size buffer.
+      \param ival input value
+      \param len desired string length
+      \param to pointer to the buffer that has at least len bytes.
+      no null character is appended.
+      \return encode status
+     */
+    bool encodeInt64ToStr( const std::int64_t & ival,
+                           const int len,
+                           char * to ) const;
+
     /*!
       \brief encode decimal (64bit) integer to the encoded string.
       \param ival input value
       \param len desired string length
-      \param to reference to the result instance
+      \param to reference to the result instance. the result is appended.
       \return encode status
      */
     bool encodeInt64ToStr( const std::int64_t & ival,
@@ -173,7 +254,7 @@ public:
       \param to pointer to the result instance
       \return decode status
      */
-    bool decodeStrToInt64( const std::string & from,
+    bool decodeStrToInt64( const std::string_view from,
                            std::int64_t * to ) const;
 
 
@@ -206,6 +287,17 @@ public:
                              const Vector2D & vel,
                              std::string & to ) const;
 
+    /*!
+      \brief encode position and velocity to 5 characters.
+      \param pos position value to be encoded
+      \param vel velocity value to be encoded
+      \param to pointer to the buffer that has at least 5 bytes
+      \return encode status
+    */
+    bool encodePosVelToStr5( const Vector2D & pos,
+                             const Vector2D & vel,
+                             char * to ) const;
+
     /*!
       \brief decode 5 characters to position and velocity
       \param from string to be decoded
@@ -215,7 +307,7 @@ public:
 
       The length of 'from' must be 5.
     */
-    bool decodeStr5ToPosVel( const std::string & from,
+    bool decodeStr5ToPosVel( const std::string_view from,
                              Vector2D * pos,
                              Vector2D * vel ) const;
 
@@ -230,6 +322,15 @@ public:
     bool encodePosToStr3( const Vector2D & pos,
                           std::string & to ) const;
 
+    /*!
+      \brief encode position to 3 characters.
+      \param pos position value to be encoded
+      \param to pointer to the buffer that has at least 3 bytes
+      \return encode status
+    */
+    bool encodePosToStr3( const Vector2D & pos,
+                          char * to ) const;
+
     /*!
       \brief decode 3 characters to and position
       \param from string to be decoded
@@ -238,7 +339,7 @@ public:
 
       The length of 'from' must be 3.
     */
-    bool decodeStr3ToPos( const std::string & from,
+    bool decodeStr3ToPos( const std::string_view from,
                           Vector2D * pos ) const;
 
 
@@ -255,6 +356,17 @@ public:
                               const Vector2D & pos,
                               std::string & to ) const;
 
+    /*!
+      \brief encode uniform number and position to 4 characters.
+      \param unum uniform number
+      \param pos position value to be encoded
+      \param to pointer to the buffer that has at least 4 bytes
+      \return encode status
+    */
+    bool encodeUnumPosToStr4( const int unum,
+                              const Vector2D & pos,
+                              char * to ) const;
+
     /*!
       \brief decode 4 characters to uniform number and position
       \param from string to be decoded
@@ -264,7 +376,7 @@ public:
 
       The length of 'from' must be 4.
     */
-    bool decodeStr4ToUnumPos( const std::string & from,
+    bool decodeStr4ToUnumPos( const std::string_view from,
                               int * unum,
                               Vector2D * pos ) const;
 
@@ -285,6 +397,17 @@ public:
     std::string encodeCoordToStr2( const double & xy,
                                    const double & norm_factor ) const;
 
+    /*!
+      \brief encode coordinate value( x or y ) to 2 characters.
+      \param xy coordinate value to be encoded, X or Y.
+      \param norm_factor normalize factor for xy
+      \param to pointer to the buffer that has at least 2 bytes
+      \return encode status
+    */
+    bool encodeCoordToStr2( const double & xy,
+                            const double & norm_factor,
+                            char * to ) const;
+
     /*!
       \brief decode 2 characters to coordinate value( x or y )
       \param ch1 first character to be decoded
@@ -307,12 +430,21 @@ public:
      */
     std::string encodePosToStr4( const Vector2D & pos ) const;
 
+    /*!
+      \brief encode position value to 4 characters with 0.1 step
+      \param pos position value to be encoded
+      \param to pointer to the buffer that has at least 4 bytes
+      \return encode status
+     */
+    bool encodePosToStr4( const Vector2D & pos,
+                          char * to ) const;
+
     /*!
       \brief decode 4 characters to position value
       \param from message string to be decoded
       \return decoded position value
      */
-    Vector2D decodeStr4ToPos( const std::string & from ) const;
+    Vector2D decodeStr4ToPos( const std::string_view from ) const;
 
     /*!
       \brief encode speed value to 1 character.
@@ -0,0 +1,368 @@
+// -*-c++-*-
+
+/*!
+  \file joint_message_codec.cpp
+  \brief schema driven joint encoder for say messages Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "joint_message_codec.h"
+
+#include "audio_codec.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+namespace rcsc {
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief big = big * mul + add. digits are stored in the little endian order.
+ */
+void
+mul_add( std::vector< std::uint32_t > & digits,
+         const std::uint32_t base,
+         const std::uint32_t mul,
+         const std::uint32_t add )
+{
+    std::uint64_t carry = add;
+    for ( std::uint32_t & d : digits )
+    {
+        const std::uint64_t v = static_cast< std::uint64_t >( d ) * mul + carry;
+        d = static_cast< std::uint32_t >( v % base );
+        carry = v / base;
+    }
+
+    while ( carry > 0 )
+    {
+        digits.push_back( static_cast< std::uint32_t >( carry % base ) );
+        carry /= base;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief big = big / div. digits are stored in the little endian order.
+  \return remainder
+ */
+std::uint32_t
+div_mod( std::vector< std::uint32_t > & digits,
+         const std::uint32_t base,
+         const std::uint32_t div )
+{
+    std::uint64_t rem = 0;
+    for ( std::size_t i = digits.size(); i > 0; --i )
+    {
+        const std::uint64_t v = rem * base + digits[i - 1];
+        digits[i - 1] = static_cast< std::uint32_t >( v / div );
+        rem = v % div;
+    }
+
+    while ( ! digits.empty()
+            && digits.back() == 0 )
+    {
+        digits.pop_back();
+    }
+
+    return static_cast< std::uint32_t >( rem );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+JointField::JointField( const double min,
+                        const double max,
+                        const double step )
+    : min_( min ),
+      step_( step ),
+      radix_( static_cast< std::uint32_t >( std::floor( ( max - min ) / step + 0.5 ) ) + 1 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::uint32_t
+JointField::encode( const double value ) const
+{
+    const double index = std::floor( ( value - min_ ) / step_ + 0.5 );
+
+    if ( ! ( index > 0.0 ) ) // includes NaN
+    {
+        return 0;
+    }
+
+    if ( index >= radix_ - 1 )
+    {
+        return radix_ - 1;
+    }
+
+    return static_cast< std::uint32_t >( index );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+JointMessageCodec::JointMessageCodec()
+{
+    const JointField pos_x( -57.5, 57.5, 0.25 );
+    const JointField pos_y( -39.0, 39.0, 0.25 );
+    const JointField line_x( -57.5, 57.5, 0.1 );
+    const JointField rate( 0.0, 1.0, 0.01 );
+
+    M_fields[JointItem::BALL] = { JointField( -57.5, 57.5, 0.1 ),
+                                  JointField( -39.0, 39.0, 0.1 ),
+                                  JointField( -3.0, 3.0, 0.02 ),
+                                  JointField( -3.0, 3.0, 0.02 ) };
+    M_fields[JointItem::PLAYER] = { JointField( 1, 22, 1 ), pos_x, pos_y };
+    M_fields[JointItem::OPPONENT_GOALIE] = { pos_x, pos_y, JointField( -180.0, 178.0, 2.0 ) };
+    M_fields[JointItem::PASS] = { JointField( 1, 11, 1 ), pos_x, pos_y };
+    M_fields[JointItem::INTERCEPT] = { JointField( 1, 22, 1 ), JointField( 0, 63, 1 ) };
+    M_fields[JointItem::OFFSIDE_LINE] = { line_x };
+    M_fields[JointItem::DEFENSE_LINE] = { line_x };
+    M_fields[JointItem::STAMINA] = { rate };
+    M_fields[JointItem::RECOVERY] = { rate };
+    M_fields[JointItem::SETPLAY] = { JointField( 0, 127, 1 ) };
+    M_fields[JointItem::PASS_REQUEST] = { pos_x, pos_y };
+    M_fields[JointItem::DRIBBLE] = { pos_x, pos_y, JointField( 1, 10, 1 ) };
+
+    M_char_bits = std::log2( static_cast< double >( AudioCodec::CHAR_SIZE ) );
+
+    const double type_bits = std::log2( static_cast< double >( JointItem::MAX_TYPE ) );
+
+    M_item_bits[JointItem::END] = 0.0;
+    for ( int t = 1; t < JointItem::MAX_TYPE; ++t )
+    {
+        M_item_bits[t] = type_bits;
+        for ( const JointField & f : M_fields[t] )
+        {
+            M_item_bits[t] += std::log2( static_cast< double >( f.radix_ ) );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const JointMessageCodec &
+JointMessageCodec::i()
+{
+    static const JointMessageCodec s_instance;
+    return s_instance;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::vector< std::size_t >
+JointMessageCodec::select( const std::vector< JointItem > & items,
+                           const int max_length ) const
+{
+    // 0-1 knapsack over the bit budget quantized by 1/64 bit.
+    // item costs are rounded up and the capacity is rounded down,
+    // so that the selected set always fits in max_length characters.
+    const double unit = 64.0;
+    const int capacity = ( max_length > 0
+                           ? static_cast< int >( std::floor( max_length * M_char_bits * unit ) )
+                           : 0 );
+
+    std::vector< std::size_t > result;
+    if ( capacity <= 0
+         || items.empty() )
+    {
+        return result;
+    }
+
+    const std::size_t n = items.size();
+    std::vector< int > cost( n, capacity + 1 );
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        if ( JointItem::END < items[i].type_
+             && items[i].type_ < JointItem::MAX_TYPE
+             && items[i].value_ > 0.0 )
+        {
+            cost[i] = static_cast< int >( std::ceil( M_item_bits[items[i].type_] * unit ) );
+        }
+    }
+
+    // best value for each capacity, and the bitmap of the items taken
+    // when the value is improved at (item, capacity).
+    const std::size_t row_words = static_cast< std::size_t >( capacity ) / 64 + 1;
+    std::vector< double > best( capacity + 1, 0.0 );
+    std::vector< std::uint64_t > taken( n * row_words, 0 );
+
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        std::uint64_t * row = &taken[i * row_words];
+        for ( int c = capacity; c >= cost[i]; --c )
+        {
+            const double v = best[c - cost[i]] + items[i].value_;
+            if ( v > best[c] )
+            {
+                best[c] = v;
+                row[c / 64] |= ( std::uint64_t( 1 ) << ( c % 64 ) );
+            }
+        }
+    }
+
+    int c = capacity;
+    for ( std::size_t i = n; i > 0; --i )
+    {
+        if ( taken[( i - 1 ) * row_words + c / 64] & ( std::uint64_t( 1 ) << ( c % 64 ) ) )
+        {
+            result.push_back( i - 1 );
+            c -= cost[i - 1];
+        }
+    }
+
+    std::reverse( result.begin(), result.end() );
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+JointMessageCodec::encode( const std::vector< JointItem > & items,
+                           std::string & to ) const
+{
+    const AudioCodec & codec = AudioCodec::i();
+    const std::uint32_t base = static_cast< std::uint32_t >( AudioCodec::CHAR_SIZE );
+
+    // the decoder reads the first item from the least significant digit.
+    // the initial value 0 works as the terminator.
+    std::vector< std::uint32_t > digits;
+    digits.reserve( 16 );
+
+    for ( std::vector< JointItem >::const_reverse_iterator it = items.rbegin();
+          it != items.rend();
+          ++it )
+    {
+        if ( it->type_ <= JointItem::END
+             || JointItem::MAX_TYPE <= it->type_ )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__
+                      << " ***ERROR*** JointMessageCodec::encode. illegal item type "
+                      << it->type_ << std::endl;
+            return -1;
+        }
+
+        const std::vector< JointField > & fields = M_fields[it->type_];
+        for ( int f = static_cast< int >( fields.size() ) - 1; f >= 0; --f )
+        {
+            mul_add( digits, base, fields[f].radix_, fields[f].encode( it->field_[f] ) );
+        }
+
+        mul_add( digits, base, JointItem::MAX_TYPE, it->type_ );
+    }
+
+    for ( std::vector< std::uint32_t >::const_reverse_iterator d = digits.rbegin();
+          d != digits.rend();
+          ++d )
+    {
+        to += codec.intToChar( static_cast< int >( *d ) );
+    }
+
+    return static_cast< int >( digits.size() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+JointMessageCodec::decode( const char * msg,
+                           const int len,
+                           std::vector< JointItem > * items ) const
+{
+    const AudioCodec & codec = AudioCodec::i();
+    const std::uint32_t base = static_cast< std::uint32_t >( AudioCodec::CHAR_SIZE );
+
+    std::vector< std::uint32_t > digits( len, 0 );
+    int flags = 0;
+    for ( int i = 0; i < len; ++i )
+    {
+        const int val = codec.charToInt( msg[i] );
+        flags |= val;
+        digits[len - 1 - i] = static_cast< std::uint32_t >( val );
+    }
+
+    if ( flags < 0 )
+    {
+        return false;
+    }
+
+    while ( ! digits.empty()
+            && digits.back() == 0 )
+    {
+        digits.pop_back();
+    }
+
+    while ( ! digits.empty() )
+    {
+        const std::uint32_t type = div_mod( digits, base, JointItem::MAX_TYPE );
+        if ( type == JointItem::END )
+        {
+            // non-zero value after the terminator
+            return false;
+        }
+
+        JointItem item;
+        item.type_ = static_cast< JointItem::Type >( type );
+        item.value_ = 0.0;
+
+        const std::vector< JointField > & fields = M_fields[type];
+        for ( std::size_t f = 0; f < fields.size(); ++f )
+        {
+            item.field_[f] = fields[f].decode( div_mod( digits, base, fields[f].radix_ ) );
+        }
+
+        if ( items )
+        {
+            items->push_back( item );
+        }
+    }
+
+    return true;
+}
+
+}
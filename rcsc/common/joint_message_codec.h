@@ -0,0 +1,301 @@
+// -*-c++-*-
+
+/*!
+  \file joint_message_codec.h
+  \brief schema driven joint encoder for say messages Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_COMMON_JOINT_MESSAGE_CODEC_H
+#define RCSC_COMMON_JOINT_MESSAGE_CODEC_H
+
+#include <rcsc/geom/vector_2d.h>
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \struct JointField
+  \brief value range and precision of one encoded field
+ */
+struct JointField {
+    double min_; //!< minimum value
+    double step_; //!< quantization step
+    std::uint32_t radix_; //!< the number of representable values
+
+    /*!
+      \brief construct with the range and the precision
+      \param min minimum value
+      \param max maximum value
+      \param step quantization step
+     */
+    JointField( const double min,
+                const double max,
+                const double step );
+
+    /*!
+      \brief quantize the value. out of range values are clamped.
+      \param value raw value
+      \return quantized index [0, radix_)
+     */
+    std::uint32_t encode( const double value ) const;
+
+    /*!
+      \brief restore the value from the quantized index
+      \param index quantized index
+      \return restored value
+     */
+    double decode( const std::uint32_t index ) const
+      {
+          return min_ + step_ * index;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \struct JointItem
+  \brief one unit of information packed into the joint message
+ */
+struct JointItem {
+
+    /*!
+      \enum Type
+      \brief item type. the fields of each type are declared in JointMessageCodec.
+     */
+    enum Type {
+        END = 0, //!< terminator. not used as an item.
+        BALL, //!< x, y, vx, vy
+        PLAYER, //!< unum [1,22] (12+ means opponent), x, y
+        OPPONENT_GOALIE, //!< x, y, body
+        PASS, //!< receiver, x, y
+        INTERCEPT, //!< unum [1,22] (12+ means opponent), cycle
+        OFFSIDE_LINE, //!< x
+        DEFENSE_LINE, //!< x
+        STAMINA, //!< rate
+        RECOVERY, //!< rate
+        WAIT_REQUEST, //!< no field
+        SETPLAY, //!< wait step
+        PASS_REQUEST, //!< x, y
+        DRIBBLE, //!< x, y, queue count
+        MAX_TYPE,
+    };
+
+    static const int MAX_FIELD = 4; //!< max number of fields per item
+
+    Type type_; //!< item type
+    double value_; //!< importance used to select items
+    double field_[MAX_FIELD]; //!< raw field values
+
+    /*!
+      \brief create an empty item
+     */
+    JointItem()
+        : type_( END ),
+          value_( 0.0 ),
+          field_{ 0.0, 0.0, 0.0, 0.0 }
+      { }
+
+    /*!
+      \brief create an item with raw values
+     */
+    JointItem( const Type type,
+               const double value,
+               const double f0 = 0.0,
+               const double f1 = 0.0,
+               const double f2 = 0.0,
+               const double f3 = 0.0 )
+        : type_( type ),
+          value_( value ),
+          field_{ f0, f1, f2, f3 }
+      { }
+
+    static JointItem ball( const Vector2D & pos, const Vector2D & vel, const double value )
+      {
+          return JointItem( BALL, value, pos.x, pos.y, vel.x, vel.y );
+      }
+    static JointItem player( const int unum, const Vector2D & pos, const double value )
+      {
+          return JointItem( PLAYER, value, unum, pos.x, pos.y );
+      }
+    static JointItem opponent_goalie( const Vector2D & pos, const double body, const double value )
+      {
+          return JointItem( OPPONENT_GOALIE, value, pos.x, pos.y, body );
+      }
+    static JointItem pass( const int receiver, const Vector2D & pos, const double value )
+      {
+          return JointItem( PASS, value, receiver, pos.x, pos.y );
+      }
+    static JointItem intercept( const int unum, const int cycle, const double value )
+      {
+          return JointItem( INTERCEPT, value, unum, cycle );
+      }
+    static JointItem offside_line( const double x, const double value )
+      {
+          return JointItem( OFFSIDE_LINE, value, x );
+      }
+    static JointItem defense_line( const double x, const double value )
+      {
+          return JointItem( DEFENSE_LINE, value, x );
+      }
+    static JointItem stamina( const double rate, const double value )
+      {
+          return JointItem( STAMINA, value, rate );
+      }
+    static JointItem recovery( const double rate, const double value )
+      {
+          return JointItem( RECOVERY, value, rate );
+      }
+    static JointItem wait_request( const double value )
+      {
+          return JointItem( WAIT_REQUEST, value );
+      }
+    static JointItem setplay( const int wait_step, const double value )
+      {
+          return JointItem( SETPLAY, value, wait_step );
+      }
+    static JointItem pass_request( const Vector2D & pos, const double value )
+      {
+          return JointItem( PASS_REQUEST, value, pos.x, pos.y );
+      }
+    static JointItem dribble( const Vector2D & pos, const int queue_count, const double value )
+      {
+          return JointItem( DRIBBLE, value, pos.x, pos.y, queue_count );
+      }
+
+    /*!
+      \brief get the field value as a position
+      \param i index of the x field
+      \return position value
+     */
+    Vector2D pos( const int i ) const
+      {
+          return Vector2D( field_[i], field_[i + 1] );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class JointMessageCodec
+  \brief encoder/decoder that packs several items into one message.
+
+  The whole payload is treated as one big integer written by the
+  AudioCodec character set.  Each item contributes its type id and its
+  quantized fields as the mixed radix digits, so no fraction of a
+  character is wasted at the item boundaries.  The decoder reads the
+  type ids until the terminator (= 0) appears.
+ */
+class JointMessageCodec {
+private:
+
+    //! field declarations for each item type
+    std::vector< JointField > M_fields[JointItem::MAX_TYPE];
+
+    //! the number of bits used by each item type (including the type id)
+    double M_item_bits[JointItem::MAX_TYPE];
+
+    //! the number of bits represented by one character
+    double M_char_bits;
+
+    /*!
+      \brief private for singleton. declare the schema.
+     */
+    JointMessageCodec();
+
+public:
+
+    /*!
+      \brief singleton interface
+      \return const reference to the singleton instance
+     */
+    static
+    const JointMessageCodec & i();
+
+    /*!
+      \brief get the field declarations of the item type
+      \param type item type
+      \return const reference to the field container
+     */
+    const std::vector< JointField > & fields( const JointItem::Type type ) const
+      {
+          return M_fields[type];
+      }
+
+    /*!
+      \brief get the number of bits used by the item
+      \param type item type
+      \return the number of bits
+     */
+    double itemBits( const JointItem::Type type ) const
+      {
+          return M_item_bits[type];
+      }
+
+    /*!
+      \brief get the number of bits represented by one character
+      \return the number of bits
+     */
+    double charBits() const
+      {
+          return M_char_bits;
+      }
+
+    /*!
+      \brief select the set of items that maximizes the total value within the length.
+      \param items candidate items
+      \param max_length max number of payload characters
+      \return indices of the selected items in the original order
+     */
+    std::vector< std::size_t > select( const std::vector< JointItem > & items,
+                                       const int max_length ) const;
+
+    /*!
+      \brief encode the items and append the payload characters
+      \param items items to be encoded. all items are encoded in the given order.
+      \param to reference to the result string
+      \return the number of appended characters, or -1 if failed.
+     */
+    int encode( const std::vector< JointItem > & items,
+                std::string & to ) const;
+
+    /*!
+      \brief decode the payload characters
+      \param msg payload characters
+      \param len the number of payload characters
+      \param items pointer to the result container. decoded items are appended.
+      \return true if successfully decoded
+     */
+    bool decode( const char * msg,
+                 const int len,
+                 std::vector< JointItem > * items ) const;
+};
+
+}
+
+#endif
@@ -38,14 +38,21 @@
 #include "soccer_agent.h"
 
 #include <rcsc/net/udp_socket.h>
+#include <rcsc/time/timer.h>
 
 #include <iostream>
 #include <cstring>
+#include <cerrno>
 
-#include <unistd.h> // select()
+#include <unistd.h> // select(), read(), close()
 #include <sys/select.h> // select()
 #include <sys/time.h> // select()
 #include <sys/types.h> // select()
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_SYS_TIMERFD_H)
+#include <sys/epoll.h> // epoll_create1(), epoll_ctl(), epoll_wait()
+#include <sys/timerfd.h> // timerfd_create(), timerfd_settime()
+#define RCSC_USE_EPOLL
+#endif
 
 namespace rcsc {
 
@@ -73,6 +80,41 @@ OnlineClient::~OnlineClient()
     // std::cerr << "delete OnlineClient" << std::endl;
 }
 
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the elapsed milli seconds since the given time stamp
+ */
+inline
+int
+elapsed_msec( const TimeStamp & start )
+{
+    return static_cast< int >( TimeStamp::now().elapsedSince( start ) );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::int64_t
+OnlineClient::timerUSec( const SoccerAgent * agent,
+                         const bool after_timeout ) const
+{
+    std::int64_t usec = nextTimeoutUSec( agent );
+
+    // if the agent did not act at the last timeout, it must not be woken up again immediately.
+    const std::int64_t min_usec = ( after_timeout ? 1000 : 1 );
+    if ( usec < min_usec )
+    {
+        usec = min_usec;
+    }
+
+    return usec;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -89,6 +131,163 @@ OnlineClient::run( SoccerAgent * agent )
         return;
     }
 
+    if ( ! runEpollLoop( agent ) )
+    {
+        runSelectLoop( agent );
+    }
+
+    handleExit( agent );
+}
+
+#ifdef RCSC_USE_EPOLL
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+OnlineClient::runEpollLoop( SoccerAgent * agent )
+{
+    const int epoll_fd = ::epoll_create1( EPOLL_CLOEXEC );
+    const int timer_fd = ::timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+    if ( epoll_fd == -1
+         || timer_fd == -1 )
+    {
+        perror( "epoll/timerfd" );
+        if ( epoll_fd != -1 ) ::close( epoll_fd );
+        if ( timer_fd != -1 ) ::close( timer_fd );
+        return false;
+    }
+
+    struct epoll_event ev;
+    std::memset( &ev, 0, sizeof( ev ) );
+    ev.events = EPOLLIN;
+    ev.data.fd = M_socket->fd();
+    if ( ::epoll_ctl( epoll_fd, EPOLL_CTL_ADD, M_socket->fd(), &ev ) == -1 )
+    {
+        perror( "epoll_ctl" );
+        ::close( timer_fd );
+        ::close( epoll_fd );
+        return false;
+    }
+
+    ev.data.fd = timer_fd;
+    if ( ::epoll_ctl( epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev ) == -1 )
+    {
+        perror( "epoll_ctl" );
+        ::close( timer_fd );
+        ::close( epoll_fd );
+        return false;
+    }
+
+    struct itimerspec spec;
+    std::memset( &spec, 0, sizeof( spec ) );
+
+    struct epoll_event events[2];
+
+    // if timerfd_settime fails, epoll_wait uses the finite timeout instead.
+    bool use_timer = true;
+
+    int timeout_count = 0;
+    bool after_timeout = false;
+    TimeStamp last_message_time = TimeStamp::now();
+
+    while ( isServerAlive() )
+    {
+        const std::int64_t usec = timerUSec( agent, after_timeout );
+        int wait_msec = -1;
+
+        if ( use_timer )
+        {
+            // arm the one-shot timer to the agent's deadline
+            spec.it_value.tv_sec = usec / 1000000;
+            spec.it_value.tv_nsec = ( usec % 1000000 ) * 1000;
+            if ( ::timerfd_settime( timer_fd, 0, &spec, nullptr ) == -1 )
+            {
+                perror( "timerfd_settime" );
+                use_timer = false;
+            }
+        }
+
+        if ( ! use_timer )
+        {
+            // round up to milli seconds
+            wait_msec = static_cast< int >( ( usec + 999 ) / 1000 );
+        }
+
+        int ret = ::epoll_wait( epoll_fd, events, 2, wait_msec );
+        if ( ret < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            perror( "epoll_wait" );
+            break;
+        }
+
+        bool received = false;
+        bool expired = ( ret == 0 );
+        for ( int i = 0; i < ret; ++i )
+        {
+            if ( events[i].data.fd == timer_fd )
+            {
+                std::uint64_t expirations = 0;
+                if ( ::read( timer_fd, &expirations, sizeof( expirations ) ) > 0 )
+                {
+                    expired = true;
+                }
+            }
+            else
+            {
+                received = true;
+            }
+        }
+
+        after_timeout = false;
+        if ( received )
+        {
+            // received message, reset wait time
+            last_message_time.setNow();
+            timeout_count = 0;
+            handleMessage( agent );
+        }
+        else if ( expired )
+        {
+            // no meesage. timeout.
+            ++timeout_count;
+            after_timeout = true;
+            handleTimeout( agent, timeout_count, elapsed_msec( last_message_time ) );
+        }
+    }
+
+    ::close( timer_fd );
+    ::close( epoll_fd );
+
+    return true;
+}
+
+#else
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+OnlineClient::runEpollLoop( SoccerAgent * )
+{
+    return false;
+}
+
+#endif
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+OnlineClient::runSelectLoop( SoccerAgent * agent )
+{
     // set interval timeout
     struct timeval interval;
 
@@ -100,40 +299,45 @@ OnlineClient::run( SoccerAgent * agent )
     read_fds_back = read_fds;
 
     int timeout_count = 0;
-    int waited_msec = 0;
+    bool after_timeout = false;
+    TimeStamp last_message_time = TimeStamp::now();
 
     while ( isServerAlive() )
     {
+        const std::int64_t usec = timerUSec( agent, after_timeout );
         read_fds = read_fds_back;
-        interval.tv_sec = intervalMSec() / 1000;
-        interval.tv_usec = ( intervalMSec() % 1000 ) * 1000;
+        interval.tv_sec = usec / 1000000;
+        interval.tv_usec = usec % 1000000;
 
         int ret = ::select( M_socket->fd() + 1, &read_fds,
                             static_cast< fd_set * >( 0 ),
                             static_cast< fd_set * >( 0 ),
                             &interval );
+        after_timeout = false;
         if ( ret < 0 )
         {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
             perror( "select" );
             break;
         }
         else if ( ret == 0 )
         {
             // no meesage. timeout.
-            waited_msec += intervalMSec();
             ++timeout_count;
-            handleTimeout( agent, timeout_count, waited_msec );
+            after_timeout = true;
+            handleTimeout( agent, timeout_count, elapsed_msec( last_message_time ) );
         }
         else
         {
             // received message, reset wait time
-            waited_msec = 0;
+            last_message_time.setNow();
             timeout_count = 0;
             handleMessage( agent );
         }
     }
-
-    handleExit( agent );
 }
 
 /*-------------------------------------------------------------------*/
@@ -76,8 +76,11 @@ public:
       \param agent pointer to the soccer agent instance.
 
       Thie method keep infinite loop while client can estimate server is alive.
-      To handle server message, select() is used.
-      Timeout interval of select() is specified by M_interval_msec member variable.
+      To handle server message, epoll with a monotonic timerfd is used
+      (select() if they are not available).
+      The timer is armed after each event to the deadline returned by
+      SoccerAgent::nextTimeoutUSec(), or to M_interval_msec if the agent
+      has no deadline.
       When server message is received, handleMessage() is called.
       When timeout occurs, handleTimeout() is called.
       When server is not alive, loop is end and handleExit() is called.
@@ -126,6 +129,30 @@ public:
     virtual
     void printOfflineThink();
 
+private:
+
+    /*!
+      \brief get the timer value for the next wait
+      \param agent pointer to the agent instance
+      \param after_timeout true if the last event was a timeout
+      \return micro seconds from now (> 0)
+     */
+    std::int64_t timerUSec( const SoccerAgent * agent,
+                            const bool after_timeout ) const;
+
+    /*!
+      \brief wait and dispatch the events by epoll and timerfd until the server is down
+      \param agent pointer to the agent instance
+      \return false if epoll is not available or its setup failed
+     */
+    bool runEpollLoop( SoccerAgent * agent );
+
+    /*!
+      \brief wait and dispatch the events by select until the server is down
+      \param agent pointer to the agent instance
+     */
+    void runSelectLoop( SoccerAgent * agent );
+
 };
 
 }
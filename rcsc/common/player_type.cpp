@@ -39,6 +39,8 @@
 #include "server_param.h"
 #include "stamina_model.h"
 
+#include <rcsc/geom/angle_deg.h>
+#include <rcsc/param/param_table.h>
 #include <rcsc/rcg/types.h>
 #include <rcsc/rcg/util.h>
 
@@ -97,6 +99,147 @@ public:
       }
 };
 
+//! bucket size of the dash distance index
+constexpr double DASH_DISTANCE_INDEX_STEP = 0.05;
+
+//! stamina rates (relative to stamina_max) of the lower stamina levels
+constexpr double STAMINA_LEVEL_RATES[] = { 0.0, 0.125, 0.25, 0.5 };
+//! the number of stamina levels. the last level is the full stamina.
+constexpr int STAMINA_LEVELS = sizeof( STAMINA_LEVEL_RATES ) / sizeof( double ) + 1;
+
+//! distance resolution of the reach step table
+constexpr double REACH_TABLE_DIST_STEP = 0.5;
+//! the number of distance divisions of the reach step table
+constexpr int REACH_TABLE_DIST_DIVS = 81;
+//! angle resolution of the reach step table
+constexpr double REACH_TABLE_ANGLE_STEP = 5.0;
+//! the number of angle divisions of the reach step table
+constexpr int REACH_TABLE_ANGLE_DIVS = 37;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the bucket index. index[i] is the first table element
+  that is not less than i * DASH_DISTANCE_INDEX_STEP.
+ */
+void
+create_distance_index( const std::vector< double > & table,
+                       std::vector< int > * index )
+{
+    index->clear();
+
+    if ( table.empty() )
+    {
+        return;
+    }
+
+    const int size = static_cast< int >( std::ceil( table.back() / DASH_DISTANCE_INDEX_STEP ) ) + 1;
+    index->reserve( size );
+
+    int i = 0;
+    for ( int b = 0; b < size; ++b )
+    {
+        const double d = b * DASH_DISTANCE_INDEX_STEP;
+        while ( i < static_cast< int >( table.size() )
+                && table[i] < d )
+        {
+            ++i;
+        }
+        index->push_back( i );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the dash cycles using the bucket index.
+  the result is same as std::lower_bound() on the table.
+ */
+int
+lookup_dash_cycles( const std::vector< double > & table,
+                    const std::vector< int > & index,
+                    const double & speed_after_table,
+                    const double & dash_dist )
+{
+    if ( dash_dist <= 0.001 )
+    {
+        return 0;
+    }
+
+    if ( table.empty() )
+    {
+        return static_cast< int >( std::ceil( dash_dist / speed_after_table ) );
+    }
+
+    const double value = dash_dist - 0.001;
+    const int table_size = table.size();
+    const std::size_t bucket = static_cast< std::size_t >( value / DASH_DISTANCE_INDEX_STEP );
+
+    if ( bucket < index.size() )
+    {
+        int i = index[bucket];
+        while ( i < table_size
+                && table[i] < value )
+        {
+            ++i;
+        }
+
+        if ( i < table_size )
+        {
+            return i + 1;
+        }
+    }
+
+    double rest_dist = dash_dist - table.back();
+    return table_size + static_cast< int >( std::ceil( rest_dist / speed_after_table ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the speed used for the extrapolation over the table length.
+ */
+double
+last_dash_speed( const std::vector< double > & table )
+{
+    const int size = table.size();
+    if ( size >= 2 )
+    {
+        return std::max( 1.0e-3, table[size - 1] - table[size - 2] );
+    }
+    if ( size == 1 )
+    {
+        return std::max( 1.0e-3, table[0] );
+    }
+    return 1.0e-3;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the angle difference that does not require the turn before dashes.
+  the turn margin is same as InterceptSimulatorPlayer.
+ */
+double
+get_turn_margin( const double & dist,
+                 const double & kickable_area )
+{
+    if ( dist <= kickable_area )
+    {
+        return 180.0;
+    }
+
+    return std::max( 15.0, rcsc::AngleDeg::asin_deg( kickable_area / dist ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the turn is required before dashes.
+ */
+bool
+need_turn( const double & dist,
+           const double & angle_diff,
+           const double & kickable_area )
+{
+    return angle_diff > get_turn_margin( dist, kickable_area );
+}
+
 }
 
 namespace rcsc {
@@ -474,6 +617,47 @@ PlayerType::setDefault()
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+const ParamTable< PlayerType > &
+PlayerType::param_table()
+{
+    static const ParamTable< PlayerType > s_table( "player_type", {
+            { "player_speed_max", &PlayerType::M_player_speed_max },
+            { "stamina_inc_max", &PlayerType::M_stamina_inc_max },
+            { "player_decay", &PlayerType::M_player_decay },
+            { "inertia_moment", &PlayerType::M_inertia_moment },
+            { "dash_power_rate", &PlayerType::M_dash_power_rate },
+            { "player_size", &PlayerType::M_player_size },
+            { "kickable_margin", &PlayerType::M_kickable_margin },
+            { "kick_rand", &PlayerType::M_kick_rand },
+            { "extra_stamina", &PlayerType::M_extra_stamina },
+            { "effort_max", &PlayerType::M_effort_max },
+            { "effort_min", &PlayerType::M_effort_min },
+            { "kick_power_rate", &PlayerType::M_kick_power_rate },
+            { "foul_detect_probability", &PlayerType::M_foul_detect_probability },
+            { "catchable_area_l_stretch", &PlayerType::M_catchable_area_l_stretch },
+            { "unum_far_length", &PlayerType::M_unum_far_length },
+            { "unum_too_far_length", &PlayerType::M_unum_too_far_length },
+            { "team_far_length", &PlayerType::M_team_far_length },
+            { "team_too_far_length", &PlayerType::M_team_too_far_length },
+            { "player_max_observation_length", &PlayerType::M_player_max_observation_length },
+            { "ball_vel_far_length", &PlayerType::M_ball_vel_far_length },
+            { "ball_vel_too_far_length", &PlayerType::M_ball_vel_too_far_length },
+            { "ball_max_observation_length", &PlayerType::M_ball_max_observation_length },
+            { "flag_chg_far_length", &PlayerType::M_flag_chg_far_length },
+            { "flag_chg_too_far_length", &PlayerType::M_flag_chg_too_far_length },
+            { "flag_max_observation_length", &PlayerType::M_flag_max_observation_length },
+            { "dist_noise_rate", &PlayerType::M_dist_noise_rate },
+            { "focus_dist_noise_rate", &PlayerType::M_focus_dist_noise_rate },
+            { "land_dist_noise_rate", &PlayerType::M_land_dist_noise_rate },
+            { "land_focus_dist_noise_rate", &PlayerType::M_land_focus_dist_noise_rate }
+        } );
+    return s_table;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 void
 PlayerType::parseV8( const char * msg )
@@ -496,7 +680,7 @@ PlayerType::parseV8( const char * msg )
 
     char name[32];
     int id = 0;
-    if ( std::sscanf( msg, " ( player_type ( %s %d ) %n ",
+    if ( std::sscanf( msg, " ( player_type ( %31s %d ) %n ",
                       name, &id, &n_read ) != 2
          || n_read == 0
          || std::strcmp( name, "id" ) != 0
@@ -510,11 +694,13 @@ PlayerType::parseV8( const char * msg )
 
     M_id = id;
 
+    const ParamTable< PlayerType > & table = param_table();
+
     int n_param = 0;
     while ( *msg != '\0' && *msg != ')' )
     {
         double val = 0.0;
-        if ( std::sscanf( msg, " ( %s %lf ) %n ",
+        if ( std::sscanf( msg, " ( %31s %lf ) %n ",
                           name, &val, &n_read ) != 2
              || n_read == 0 )
         {
@@ -524,129 +710,19 @@ PlayerType::parseV8( const char * msg )
         }
         msg += n_read;
 
-        if ( ! std::strcmp( name, "player_speed_max" ) )
-        {
-            M_player_speed_max = val;
-        }
-        else if ( ! std::strcmp( name, "stamina_inc_max" ) )
-        {
-            M_stamina_inc_max = val;
-        }
-        else if ( ! std::strcmp( name, "player_decay" ) )
-        {
-            M_player_decay = val;
-        }
-        else if ( ! std::strcmp( name, "inertia_moment" ) )
-        {
-            M_inertia_moment = val;
-        }
-        else if ( ! std::strcmp( name, "dash_power_rate" ) )
-        {
-            M_dash_power_rate = val;
-        }
-        else if ( ! std::strcmp( name, "player_size" ) )
-        {
-            M_player_size = val;
-        }
-        else if ( ! std::strcmp( name, "kickable_margin" ) )
-        {
-            M_kickable_margin = val;
-        }
-        else if ( ! std::strcmp( name, "kick_rand" ) )
-        {
-            M_kick_rand = val;
-        }
-        else if ( ! std::strcmp( name, "extra_stamina" ) )
-        {
-            M_extra_stamina = val;
-        }
-        else if ( ! std::strcmp( name, "effort_max" ) )
-        {
-            M_effort_max = val;
-        }
-        else if ( ! std::strcmp( name, "effort_min" ) )
-        {
-            M_effort_min = val;
-        }
-        else if ( ! std::strcmp( name, "kick_power_rate" ) )
-        {
-            M_kick_power_rate = val;
-        }
-        else if ( ! std::strcmp( name, "foul_detect_probability" ) )
-        {
-            M_foul_detect_probability = val;
-        }
-        else if ( ! std::strcmp( name, "catchable_area_l_stretch" ) )
-        {
-            M_catchable_area_l_stretch = val;
-        }
-        else if ( ! std::strcmp( name, "unum_far_length" ) )
-        {
-            M_unum_far_length = val;
-        }
-        else if ( ! std::strcmp( name, "unum_too_far_length" ) )
-        {
-            M_unum_too_far_length = val;
-        }
-        else if ( ! std::strcmp( name, "team_far_length" ) )
-        {
-            M_team_far_length = val;
-        }
-        else if ( ! std::strcmp( name, "team_too_far_length" ) )
-        {
-            M_team_too_far_length = val;
-        }
-        else if ( ! std::strcmp( name, "player_max_observation_length" ) )
-        {
-            M_player_max_observation_length = val;
-        }
-        else if ( ! std::strcmp( name, "ball_vel_far_length" ) )
-        {
-            M_ball_vel_far_length = val;
-        }
-        else if ( ! std::strcmp( name, "ball_vel_too_far_length" ) )
-        {
-            M_ball_vel_too_far_length = val;
-        }
-        else if ( ! std::strcmp( name, "ball_max_observation_length" ) )
-        {
-            M_ball_max_observation_length = val;
-        }
-        else if ( ! std::strcmp( name, "flag_chg_far_length" ) )
-        {
-            M_flag_chg_far_length = val;
-        }
-        else if ( ! std::strcmp( name, "flag_chg_too_far_length" ) )
-        {
-            M_flag_chg_too_far_length = val;
-        }
-        else if ( ! std::strcmp( name, "flag_max_observation_length" ) )
-        {
-            M_flag_max_observation_length = val;
-        }
-        else if ( ! std::strcmp( name, "dist_noise_rate" ) )
-        {
-            M_dist_noise_rate = val;
-        }
-        else if ( ! std::strcmp( name, "focus_dist_noise_rate" ) )
-        {
-            M_focus_dist_noise_rate = val;
-        }
-        else if ( ! std::strcmp( name, "land_dist_noise_rate" ) )
-        {
-            M_land_dist_noise_rate = val;
-        }
-        else if ( ! std::strcmp( name, "land_focus_dist_noise_rate" ) )
-        {
-            M_land_focus_dist_noise_rate = val;
-        }
-        else
+        const ParamTable< PlayerType >::Entry * e = table.find( name );
+        double PlayerType::* const * member = ( e
+                                                ? std::get_if< double PlayerType::* >( &e->member_ )
+                                                : nullptr );
+        if ( ! member )
         {
             std::cerr << "(PlayerType::parseV8) "
                       << " ERROR: unsupported parameter name " << name << std::endl;
             break;
         }
 
+        this->**member = val;
+
         ++n_param;
     }
 
@@ -780,6 +856,146 @@ PlayerType::initAdditionalParams()
             break;
         }
     }
+
+    initReachTables();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerType::initReachTables()
+{
+    const ServerParam & SP = ServerParam::i();
+
+    create_distance_index( M_dash_distance_table, &M_dash_distance_index );
+
+    M_stamina_dash_distance_tables.resize( STAMINA_LEVELS - 1 );
+    M_stamina_dash_distance_indices.resize( STAMINA_LEVELS - 1 );
+
+    for ( int level = 0; level < STAMINA_LEVELS - 1; ++level )
+    {
+        simulateDashDistances( STAMINA_LEVEL_RATES[level] * SP.staminaMax(),
+                               &M_stamina_dash_distance_tables[level] );
+        create_distance_index( M_stamina_dash_distance_tables[level],
+                               &M_stamina_dash_distance_indices[level] );
+    }
+
+    //
+    // the value of each cell is calculated at the upper corner
+    // in order to make the table lookup conservative.
+    //
+
+    M_reach_step_table.resize( STAMINA_LEVELS * REACH_TABLE_DIST_DIVS * REACH_TABLE_ANGLE_DIVS );
+
+    std::vector< unsigned char >::iterator it = M_reach_step_table.begin();
+    for ( int level = 0; level < STAMINA_LEVELS; ++level )
+    {
+        const std::vector< double > & table = ( level == STAMINA_LEVELS - 1
+                                                ? M_dash_distance_table
+                                                : M_stamina_dash_distance_tables[level] );
+        const std::vector< int > & index = ( level == STAMINA_LEVELS - 1
+                                             ? M_dash_distance_index
+                                             : M_stamina_dash_distance_indices[level] );
+        const double speed_after_table = ( level == STAMINA_LEVELS - 1
+                                           ? realSpeedMax()
+                                           : last_dash_speed( table ) );
+
+        for ( int d = 0; d < REACH_TABLE_DIST_DIVS; ++d )
+        {
+            const double dist = d * REACH_TABLE_DIST_STEP;
+            const int n_dash = lookup_dash_cycles( table, index, speed_after_table,
+                                                   dist - kickableArea() );
+
+            // find the first angle index that requires the turn.
+            int turn_a = REACH_TABLE_ANGLE_DIVS;
+            if ( n_dash > 0 )
+            {
+                const double turn_margin = get_turn_margin( dist, kickableArea() );
+                turn_a = 0;
+                while ( turn_a < REACH_TABLE_ANGLE_DIVS
+                        && turn_a * REACH_TABLE_ANGLE_STEP <= turn_margin )
+                {
+                    ++turn_a;
+                }
+            }
+
+            const unsigned char no_turn_step = static_cast< unsigned char >( std::min( 255, n_dash ) );
+            const unsigned char turn_step = static_cast< unsigned char >( std::min( 255, n_dash + 1 ) );
+            it = std::fill_n( it, turn_a, no_turn_step );
+            it = std::fill_n( it, REACH_TABLE_ANGLE_DIVS - turn_a, turn_step );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+PlayerType::getStaminaLevel( const double & stamina ) const
+{
+    const double stamina_max = ServerParam::i().staminaMax();
+
+    if ( stamina >= stamina_max )
+    {
+        return STAMINA_LEVELS - 1;
+    }
+
+    for ( int level = STAMINA_LEVELS - 2; level > 0; --level )
+    {
+        if ( stamina >= STAMINA_LEVEL_RATES[level] * stamina_max )
+        {
+            return level;
+        }
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerType::simulateDashDistances( const double & stamina,
+                                   std::vector< double > * table ) const
+{
+    const ServerParam & SP = ServerParam::i();
+
+    StaminaModel stamina_model;
+    stamina_model.init( *this );
+    stamina_model.setStamina( stamina );
+
+    double speed = 0.0;
+    double reach_dist = 0.0;
+
+    table->clear();
+    table->reserve( 50 );
+
+    for ( int counter = 1; counter <= 50; ++counter )
+    {
+        double dash_power = std::min( SP.maxDashPower(),
+                                      stamina_model.stamina() + extraStamina() );
+        double accel = dash_power * dashPowerRate() * stamina_model.effort();
+
+        if ( speed + accel > playerSpeedMax() )
+        {
+            accel = playerSpeedMax() - speed;
+            dash_power = std::min( SP.maxDashPower(),
+                                   accel / ( dashPowerRate() * stamina_model.effort() ) );
+        }
+
+        speed += accel;
+        reach_dist += speed;
+
+        table->push_back( reach_dist );
+
+        speed *= playerDecay();
+
+        stamina_model.simulateDash( *this, dash_power );
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -1109,29 +1325,234 @@ PlayerType::cyclesToReachMaxSpeed( const double & dash_power ) const
 int
 PlayerType::cyclesToReachDistance( const double & dash_dist ) const
 {
+    return lookup_dash_cycles( M_dash_distance_table,
+                               M_dash_distance_index,
+                               realSpeedMax(),
+                               dash_dist );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+PlayerType::cyclesToReachDistance( const double & dash_dist,
+                                   const double & stamina ) const
+{
+    const int level = getStaminaLevel( stamina );
+    if ( level == STAMINA_LEVELS - 1 )
+    {
+        return cyclesToReachDistance( dash_dist );
+    }
+
+    const std::vector< double > & table = M_stamina_dash_distance_tables[level];
+    return lookup_dash_cycles( table,
+                               M_stamina_dash_distance_indices[level],
+                               last_dash_speed( table ),
+                               dash_dist );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+PlayerType::reachStep( const double & dist,
+                       const double & angle_diff ) const
+{
+    return reachStep( dist, angle_diff, ServerParam::i().staminaMax() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+double
+PlayerType::reach_step_dist_resolution()
+{
+    return REACH_TABLE_DIST_STEP;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+PlayerType::reachStep( const double & dist,
+                       const double & angle_diff,
+                       const double & stamina ) const
+{
+    const double abs_angle = std::min( 180.0, std::fabs( angle_diff ) );
+    const int d = static_cast< int >( std::ceil( dist / REACH_TABLE_DIST_STEP ) );
+    const int a = static_cast< int >( std::ceil( abs_angle / REACH_TABLE_ANGLE_STEP ) );
+
+    if ( d >= REACH_TABLE_DIST_DIVS
+         || M_reach_step_table.empty() )
+    {
+        return simulateReachStep( dist, angle_diff, stamina );
+    }
+
+    const int level = getStaminaLevel( stamina );
+    return M_reach_step_table[( level * REACH_TABLE_DIST_DIVS + std::max( 0, d ) )
+                              * REACH_TABLE_ANGLE_DIVS + a];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+PlayerType::simulateReachStep( const double & dist,
+                               const double & angle_diff,
+                               const double & stamina ) const
+{
+    const double dash_dist = dist - kickableArea();
     if ( dash_dist <= 0.001 )
     {
         return 0;
     }
 
+    const double abs_angle = std::min( 180.0, std::fabs( angle_diff ) );
+    const int n_turn = ( need_turn( dist, abs_angle, kickableArea() ) ? 1 : 0 );
+
+    // the table is discretized by the stamina level
+    const int level = getStaminaLevel( stamina );
+    if ( level == STAMINA_LEVELS - 1 )
+    {
+        std::vector< double >::const_iterator
+            it = std::lower_bound( M_dash_distance_table.begin(),
+                                   M_dash_distance_table.end(),
+                                   dash_dist - 0.001 );
+        if ( it != M_dash_distance_table.end() )
+        {
+            return n_turn + static_cast< int >( std::distance( M_dash_distance_table.begin(), it ) ) + 1;
+        }
+
+        double rest_dist = dash_dist - M_dash_distance_table.back();
+        return n_turn
+            + M_dash_distance_table.size()
+            + static_cast< int >( std::ceil( rest_dist / realSpeedMax() ) );
+    }
+
+    // use the cached table if available
+    std::vector< double > tmp_table;
+    if ( static_cast< int >( M_stamina_dash_distance_tables.size() ) <= level )
+    {
+        simulateDashDistances( STAMINA_LEVEL_RATES[level] * ServerParam::i().staminaMax(), &tmp_table );
+    }
+    const std::vector< double > & table = ( tmp_table.empty()
+                                            ? M_stamina_dash_distance_tables[level]
+                                            : tmp_table );
+
     std::vector< double >::const_iterator
-        it = std::lower_bound( M_dash_distance_table.begin(),
-                               M_dash_distance_table.end(),
-                               dash_dist - 0.001 );
+        it = std::lower_bound( table.begin(), table.end(), dash_dist - 0.001 );
+    if ( it != table.end() )
+    {
+        return n_turn + static_cast< int >( std::distance( table.begin(), it ) ) + 1;
+    }
 
-    if ( it != M_dash_distance_table.end() )
+    double rest_dist = dash_dist - table.back();
+    return n_turn
+        + table.size()
+        + static_cast< int >( std::ceil( rest_dist / last_dash_speed( table ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+PlayerType::validateReachTables( std::ostream & os ) const
+{
+    const double stamina_max = ServerParam::i().staminaMax();
+
+    int error_count = 0;
+
+    //
+    // dash distance index
+    //
+    const double max_dist = M_dash_distance_table.empty()
+        ? 10.0
+        : M_dash_distance_table.back() + 10.0;
+
+    for ( double dist = -0.1; dist < max_dist; dist += 0.0037 )
     {
-        return ( static_cast< int >
-                 ( std::distance( M_dash_distance_table.begin(), it ) )
-                 + 1 ); // is it necessary?
+        int exact = 0;
+        if ( dist > 0.001 )
+        {
+            std::vector< double >::const_iterator
+                it = std::lower_bound( M_dash_distance_table.begin(),
+                                       M_dash_distance_table.end(),
+                                       dist - 0.001 );
+            exact = ( it != M_dash_distance_table.end()
+                      ? static_cast< int >( std::distance( M_dash_distance_table.begin(), it ) ) + 1
+                      : ( static_cast< int >( M_dash_distance_table.size() )
+                          + static_cast< int >( std::ceil( ( dist - M_dash_distance_table.back() )
+                                                           / realSpeedMax() ) ) ) );
+        }
+
+        const int lookup = cyclesToReachDistance( dist );
+        if ( lookup != exact )
+        {
+            os << "player_type " << id() << ": cyclesToReachDistance(" << dist
+               << ") lookup=" << lookup << " exact=" << exact << '\n';
+            ++error_count;
+        }
     }
 
-    double rest_dist = dash_dist - M_dash_distance_table.back();
-    int cycle = M_dash_distance_table.size();
+    //
+    // reach step table
+    //
+    for ( int level = 0; level < STAMINA_LEVELS; ++level )
+    {
+        const double stamina = ( level == STAMINA_LEVELS - 1
+                                 ? stamina_max
+                                 : STAMINA_LEVEL_RATES[level] * stamina_max );
 
-    cycle += static_cast< int >( std::ceil( rest_dist / realSpeedMax() ) );
+        if ( level < STAMINA_LEVELS - 1 )
+        {
+            std::vector< double > table;
+            simulateDashDistances( stamina, &table );
+            if ( table != M_stamina_dash_distance_tables[level] )
+            {
+                os << "player_type " << id() << ": dash distance table mismatch. level="
+                   << level << '\n';
+                ++error_count;
+            }
+        }
+
+        for ( double dist = 0.0; dist < REACH_TABLE_DIST_STEP * REACH_TABLE_DIST_DIVS + 2.0; dist += 0.13 )
+        {
+            for ( double angle = 0.0; angle <= 180.0; angle += 2.5 )
+            {
+                const int lookup = reachStep( dist, angle, stamina );
+                const int exact = simulateReachStep( dist, angle, stamina );
+                const int upper = simulateReachStep( dist + REACH_TABLE_DIST_STEP,
+                                                     std::min( 180.0, angle + REACH_TABLE_ANGLE_STEP ),
+                                                     stamina );
+                if ( lookup < exact
+                     || lookup > upper )
+                {
+                    os << "player_type " << id() << ": reachStep(" << dist << ',' << angle
+                       << ',' << stamina << ") lookup=" << lookup
+                       << " exact=" << exact << " upper=" << upper << '\n';
+                    ++error_count;
+                }
+            }
+
+            // the lower bound used by the intercept simulator
+            const int lower = reachStep( dist - REACH_TABLE_DIST_STEP, 0.0, stamina );
+            const int exact = simulateReachStep( dist, 0.0, stamina );
+            if ( lower > exact )
+            {
+                os << "player_type " << id() << ": reachStep(" << dist - REACH_TABLE_DIST_STEP
+                   << ",0," << stamina << ") lower=" << lower << " exact=" << exact << '\n';
+                ++error_count;
+            }
+        }
+    }
 
-    return cycle;
+    return error_count == 0;
 }
 
 /*-------------------------------------------------------------------*/
@@ -1352,6 +1773,7 @@ PlayerTypeSet::instance()
 
 */
 PlayerTypeSet::PlayerTypeSet()
+    : M_version( 0 )
 {
     resetDefaultType();
 }
@@ -1391,6 +1813,7 @@ PlayerTypeSet::generate( const int seed )
     {
         M_player_type_map.insert( std::make_pair( i, PlayerType( i, delta ) ) );
     }
+    ++M_version;
 }
 
 /*-------------------------------------------------------------------*/
@@ -1427,6 +1850,7 @@ PlayerTypeSet::insert( const PlayerType & param )
     {
         M_player_type_map.insert( std::make_pair( param.id(), param ) );
     }
+    ++M_version;
 
     if ( static_cast< int >( M_player_type_map.size() ) == PlayerParam::i().playerTypes() )
     {
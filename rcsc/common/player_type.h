@@ -47,6 +47,9 @@ struct player_type_t;
 struct PlayerTypeT;
 }
 
+template < typename T >
+class ParamTable;
+
 /*!
   \class PlayerType
   \brief heterogeneous player parametor class
@@ -109,6 +112,17 @@ private:
     //! distance table by continuous dashes from the velocity 0.
     std::vector< double > M_dash_distance_table;
 
+    //! bucket index of M_dash_distance_table for the constant time lookup.
+    std::vector< int > M_dash_distance_index;
+
+    //! distance tables by continuous dashes for the lower stamina levels.
+    std::vector< std::vector< double > > M_stamina_dash_distance_tables;
+    //! bucket indices of M_stamina_dash_distance_tables.
+    std::vector< std::vector< int > > M_stamina_dash_distance_indices;
+
+    //! turn-then-dash reach step table. [stamina level][distance][angle]
+    std::vector< unsigned char > M_reach_step_table;
+
     // stamina cconsumption table by continuous dashes
     //std::vector< double > M_stamina_table;
 
@@ -182,6 +196,13 @@ private:
      */
     void setDefault();
 
+    /*!
+      \brief get the parameter table used by parseV8()
+      \return const reference to the table shared by all instances
+     */
+    static
+    const ParamTable< PlayerType > & param_table();
+
     /*!
       \brief analyze version 8 protocol server message
       \param msg raw message string from rcssserver
@@ -199,6 +220,26 @@ private:
      */
     void initAdditionalParams();
 
+    /*!
+      \brief create the lookup tables used by cyclesToReachDistance() and reachStep()
+     */
+    void initReachTables();
+
+    /*!
+      \brief get the stamina level index for the stamina aware tables
+      \param stamina available stamina
+      \return stamina level index. STAMINA_LEVELS - 1 means the full stamina.
+     */
+    int getStaminaLevel( const double & stamina ) const;
+
+    /*!
+      \brief simulate continuous max power dashes from the velocity 0.
+      \param stamina initial stamina
+      \param table container to store the accumulated distance of each step
+     */
+    void simulateDashDistances( const double & stamina,
+                                std::vector< double > * table ) const;
+
 public:
 
     /*!
@@ -625,6 +666,67 @@ public:
     */
     int cyclesToReachDistance( const double & dash_dist ) const;
 
+    /*!
+      \brief estimate cycles to reach the specific distance with start speed 0,
+      considering the available stamina.
+      \param dash_dist distance to reach
+      \param stamina available stamina. the value is rounded down to the stamina level.
+      \return estimated cycles to reach
+    */
+    int cyclesToReachDistance( const double & dash_dist,
+                               const double & stamina ) const;
+
+    /*!
+      \brief estimate the turn-then-dash steps to bring the target point
+      into the kickable area. the player is assumed to be stopped.
+      the result is looked up from the precomputed table and it is never
+      less than the value of simulateReachStep().
+      \param dist distance to the target point
+      \param angle_diff angle difference between the body and the target point
+      \return estimated steps
+     */
+    int reachStep( const double & dist,
+                   const double & angle_diff ) const;
+
+    /*!
+      \brief get the distance resolution of the reach step table.
+      reachStep( dist - reach_step_dist_resolution(), 0.0 ) is never greater
+      than cyclesToReachDistance( dist - kickableArea() ), so that it can be
+      used as a lower bound of the dash steps.
+      \return distance resolution
+     */
+    static
+    double reach_step_dist_resolution();
+
+    /*!
+      \brief estimate the turn-then-dash steps considering the available stamina.
+      \param dist distance to the target point
+      \param angle_diff angle difference between the body and the target point
+      \param stamina available stamina
+      \return estimated steps
+     */
+    int reachStep( const double & dist,
+                   const double & angle_diff,
+                   const double & stamina ) const;
+
+    /*!
+      \brief calculate the turn-then-dash steps without the lookup table.
+      \param dist distance to the target point
+      \param angle_diff angle difference between the body and the target point
+      \param stamina available stamina
+      \return calculated steps
+     */
+    int simulateReachStep( const double & dist,
+                           const double & angle_diff,
+                           const double & stamina ) const;
+
+    /*!
+      \brief check all lookup tables against the exact calculation.
+      \param os reference to the output stream for error messages
+      \return true if no error is found
+     */
+    bool validateReachTables( std::ostream & os ) const;
+
     double getMovableDistance( const size_t step ) const;
     ////////////////////////////////////////////////
     /*!
@@ -875,6 +977,9 @@ private:
     //! dummy player type
     PlayerType M_dummy_type;
 
+    //! incremented whenever the player type set is modified
+    std::size_t M_version;
+
     /*!
       \brief create dummy type. private access for singleton.
      */
@@ -946,6 +1051,16 @@ public:
           return M_player_type_map;
       }
 
+    /*!
+      \brief get the version of the player type set. the value is changed
+      whenever a player type is inserted or the set is cleared.
+      \return player type set version
+     */
+    std::size_t version() const
+      {
+          return M_version;
+      }
+
     const PlayerType & defaultType() const
       {
           return M_default_type;
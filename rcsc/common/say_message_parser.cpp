@@ -37,6 +37,7 @@
 
 #include "audio_codec.h"
 #include "audio_memory.h"
+#include "joint_message_codec.h"
 
 #include <rcsc/common/logger.h>
 #include <rcsc/common/server_param.h>
@@ -91,7 +92,7 @@ BallMessageParser::parse( const int sender ,
     Vector2D ball_pos;
     Vector2D ball_vel;
 
-    if ( ! AudioCodec::i().decodeStr5ToPosVel( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStr5ToPosVel( std::string_view( msg, slength() - 1 ),
                                                &ball_pos, &ball_vel ) )
     {
         std::cerr << "***ERROR*** BallMessageParser::parse()"
@@ -159,7 +160,7 @@ PassMessageParser::parse( const int sender,
     int receiver_number = 0;
     Vector2D receive_pos;
 
-    if ( ! AudioCodec::i().decodeStr4ToUnumPos( std::string( msg, 4 ),
+    if ( ! AudioCodec::i().decodeStr4ToUnumPos( std::string_view( msg, 4 ),
                                                 &receiver_number,
                                                 &receive_pos ) )
     {
@@ -176,7 +177,7 @@ PassMessageParser::parse( const int sender,
     Vector2D ball_pos;
     Vector2D ball_vel;
 
-    if ( ! AudioCodec::i().decodeStr5ToPosVel( std::string( msg, 5 ),
+    if ( ! AudioCodec::i().decodeStr5ToPosVel( std::string_view( msg, 5 ),
                                                &ball_pos, &ball_vel ) )
     {
         std::cerr << "***ERROR*** PassMessageParser::parse()"
@@ -246,10 +247,9 @@ InterceptMessageParser::parse( const int sender,
     }
     ++msg;
 
-    AudioCodec::CharToIntCont::const_iterator unum_it = AudioCodec::i().charToIntMap().find( *msg );
-    if ( unum_it == AudioCodec::i().charToIntMap().end()
-         || unum_it->second <= 0
-         || MAX_PLAYER*2 < unum_it->second )
+    const int unum_val = AudioCodec::i().charToInt( *msg );
+    if ( unum_val <= 0
+         || MAX_PLAYER*2 < unum_val )
     {
         std::cerr << "InterceptMessageParser::parse() "
                   << " Illegal player number. message = [" << msg << "]"
@@ -261,8 +261,8 @@ InterceptMessageParser::parse( const int sender,
     }
     ++msg;
 
-    AudioCodec::CharToIntCont::const_iterator cycle = AudioCodec::i().charToIntMap().find( *msg );
-    if ( cycle == AudioCodec::i().charToIntMap().end() )
+    const int cycle = AudioCodec::i().charToInt( *msg );
+    if ( cycle < 0 )
     {
         std::cerr << "InterceptMessageParser::parse() "
                   << " Illegal cycle. message = [" << msg << "]"
@@ -275,9 +275,9 @@ InterceptMessageParser::parse( const int sender,
 
     dlog.addText( Logger::SENSOR,
                   "InterceptMessageParser: success! number=%d cycle=%d",
-                  unum_it->second, cycle->second );
+                  unum_val, cycle );
 
-    M_memory->setIntercept( sender, unum_it->second, cycle->second, current );
+    M_memory->setIntercept( sender, unum_val, cycle, current );
 
     return slength();
 }
@@ -325,7 +325,7 @@ GoalieMessageParser::parse( const int sender,
     ++msg;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "GoalieMessageParser::parse()"
@@ -420,7 +420,7 @@ GoalieAndPlayerMessageParser::parse( const int sender,
     ++msg;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "Goalie1PlayerMessageParser::parse()"
@@ -593,7 +593,7 @@ DefenseLineMessageParser::parse( const int sender,
         return -1;
     }
 
-    double defense_line_x = 52.0 + ( -10.0 + 52.0 ) * rate;
+    double defense_line_x = -52.0 + ( -10.0 + 52.0 ) * rate;
 
     dlog.addText( Logger::SENSOR,
                   "DefenseLineMessageParser::parse() success! x=%.1f rate=%.3f",
@@ -672,9 +672,8 @@ SetplayMessageParser::parse( const int sender,
     }
     ++msg;
 
-    AudioCodec::CharToIntCont::const_iterator it = AudioCodec::i().charToIntMap().find( *msg );
-    if ( it == AudioCodec::i().charToIntMap().end()
-         || it->second <= 0 )
+    const int wait_step = AudioCodec::i().charToInt( *msg );
+    if ( wait_step <= 0 )
     {
         std::cerr << "(SetplayMessageParser::parse) illegal value [" << msg
                   << ']' << std::endl;
@@ -683,7 +682,7 @@ SetplayMessageParser::parse( const int sender,
         return -1;
     }
 
-    M_memory->setSetplay( sender, it->second, current );
+    M_memory->setSetplay( sender, wait_step, current );
     return slength();
 }
 
@@ -728,7 +727,7 @@ PassRequestMessageParser::parse( const int sender,
 
     Vector2D pos;
 
-    if ( ! AudioCodec::i().decodeStr3ToPos( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStr3ToPos( std::string_view( msg, slength() - 1 ),
                                             &pos ) )
     {
         std::cerr << "PassRequestMessage::parse()"
@@ -985,7 +984,7 @@ DribbleMessageParser::parse( const int sender,
 
     std::int64_t ival = 0;
 
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "DribbleMessageParser::parse()"
@@ -1062,7 +1061,7 @@ BallGoalieMessageParser::parse( const int sender,
     ++msg;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "BallGoalieMessageParser::parse()"
@@ -1168,7 +1167,7 @@ OnePlayerMessageParser::parse( const int sender,
     ++msg;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "OnePlayerMessageParser::parse()"
@@ -1255,7 +1254,7 @@ TwoPlayerMessageParser::parse( const int sender,
     ++msg;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "TwoPlayerMessageParser::parse()"
@@ -1364,7 +1363,7 @@ ThreePlayerMessageParser::parse( const int sender,
     ++msg;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "ThreePlayerMessageParser::parse()"
@@ -1486,7 +1485,7 @@ SelfMessageParser::parse( const int sender,
     ++msg;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "SelfMessageParser::parse()"
@@ -1582,7 +1581,7 @@ TeammateMessageParser::parse( const int sender,
     ++msg;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "TeammateMessageParser::parse()"
@@ -1676,7 +1675,7 @@ OpponentMessageParser::parse( const int sender,
     ++msg;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, slength() - 1 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, slength() - 1 ),
                                              &ival ) )
     {
         std::cerr << "OpponentMessageParser::parse()"
@@ -1767,7 +1766,7 @@ BallPlayerMessageParser::parse( const int sender,
     Vector2D ball_pos;
     Vector2D ball_vel;
 
-    if ( ! AudioCodec::i().decodeStr5ToPosVel( std::string( msg, 5 ),
+    if ( ! AudioCodec::i().decodeStr5ToPosVel( std::string_view( msg, 5 ),
                                                &ball_pos, &ball_vel ) )
     {
         std::cerr << "***ERROR*** BallPlayerMessageParser::parse()"
@@ -1781,7 +1780,7 @@ BallPlayerMessageParser::parse( const int sender,
     msg += 5;
 
     std::int64_t ival = 0;
-    if ( ! AudioCodec::i().decodeStrToInt64( std::string( msg, 4 ),
+    if ( ! AudioCodec::i().decodeStrToInt64( std::string_view( msg, 4 ),
                                              &ival ) )
     {
         std::cerr << "BallPlayerMessageParser::parse()"
@@ -1833,4 +1832,107 @@ BallPlayerMessageParser::parse( const int sender,
     return slength();
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+JointMessageParser::JointMessageParser( std::shared_ptr< AudioMemory > memory )
+    : M_memory( memory )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+JointMessageParser::parse( const int sender,
+                           const double & ,
+                           const char * msg,
+                           const GameTime & current )
+{
+    // format:
+    //    "J<payload>"
+    // the payload continues to the end of message
+
+    if ( *msg != sheader() )
+    {
+        return 0;
+    }
+
+    const int len = static_cast< int >( std::strlen( msg ) );
+    ++msg;
+
+    std::vector< JointItem > items;
+    items.reserve( 8 );
+
+    if ( ! JointMessageCodec::i().decode( msg, len - 1, &items ) )
+    {
+        std::cerr << "JointMessageParser::parse()"
+                  << " Failed to decode [" << msg << "]"
+                  << std::endl;
+        dlog.addText( Logger::SENSOR,
+                      "JointMessageParser: Failed to decode [%s]",
+                      msg );
+        return -1;
+    }
+
+    for ( const JointItem & item : items )
+    {
+        switch ( item.type_ ) {
+        case JointItem::BALL:
+            M_memory->setBall( sender, item.pos( 0 ), item.pos( 2 ), current );
+            break;
+        case JointItem::PLAYER:
+            M_memory->setPlayer( sender, static_cast< int >( item.field_[0] ), item.pos( 1 ), current );
+            break;
+        case JointItem::OPPONENT_GOALIE:
+            M_memory->setOpponentGoalie( sender, item.pos( 0 ), item.field_[2], current );
+            break;
+        case JointItem::PASS:
+            M_memory->setPass( sender, static_cast< int >( item.field_[0] ), item.pos( 1 ), current );
+            break;
+        case JointItem::INTERCEPT:
+            M_memory->setIntercept( sender,
+                                    static_cast< int >( item.field_[0] ),
+                                    static_cast< int >( item.field_[1] ),
+                                    current );
+            break;
+        case JointItem::OFFSIDE_LINE:
+            M_memory->setOffsideLine( sender, item.field_[0], current );
+            break;
+        case JointItem::DEFENSE_LINE:
+            M_memory->setDefenseLine( sender, item.field_[0], current );
+            break;
+        case JointItem::STAMINA:
+            M_memory->setStamina( sender, item.field_[0], current );
+            break;
+        case JointItem::RECOVERY:
+            M_memory->setRecovery( sender, item.field_[0], current );
+            break;
+        case JointItem::WAIT_REQUEST:
+            M_memory->setWaitRequest( sender, current );
+            break;
+        case JointItem::SETPLAY:
+            M_memory->setSetplay( sender, static_cast< int >( item.field_[0] ), current );
+            break;
+        case JointItem::PASS_REQUEST:
+            M_memory->setPassRequest( sender, item.pos( 0 ), current );
+            break;
+        case JointItem::DRIBBLE:
+            M_memory->setDribbleTarget( sender, item.pos( 0 ), static_cast< int >( item.field_[2] ), current );
+            break;
+        default:
+            break;
+        }
+    }
+
+    dlog.addText( Logger::SENSOR,
+                  "JointMessageParser::parse() success! %d items",
+                  static_cast< int >( items.size() ) );
+
+    return len;
+}
+
 } // end namespace rcsc
@@ -1465,6 +1465,62 @@ public:
 
 };
 
+/*-------------------------------------------------------------------*/
+/*!
+  \class JointMessageParser
+  \brief joint message parser
+
+  format:
+  "J<payload>"
+  The payload is encoded by JointMessageCodec and continues to the end
+  of the say message.  Thus, this message must be the last one.
+ */
+class JointMessageParser
+    : public SayMessageParser {
+private:
+
+    //! pointer to the audio memory
+    std::shared_ptr< AudioMemory > M_memory;
+
+public:
+
+    /*!
+      \brief construct with audio memory
+      \param memory pointer to the memory
+     */
+    explicit
+    JointMessageParser( std::shared_ptr< AudioMemory > memory );
+
+    /*!
+      \brief get the header character.
+      \return header character.
+     */
+    static
+    char sheader() { return 'J'; }
+
+    /*!
+      \brief get the header character.
+      \return header character.
+     */
+    char header() const { return sheader(); }
+
+    /*!
+      \brief virtual method which analyzes audio messages.
+      \param sender sender's uniform number
+      \param dir sender's direction
+      \param msg raw audio message
+      \param current current game time
+      \retval bytes read if success
+      \retval 0 message ID is not match. other parser should be tried.
+      \retval -1 failed to parse
+    */
+    int parse( const int sender,
+               const double & dir,
+               const char * msg,
+               const GameTime & current );
+
+};
+
 }
 
 #endif
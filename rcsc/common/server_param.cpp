@@ -384,7 +384,8 @@ ServerParam::instance()
 
 */
 ServerParam::ServerParam()
-    : M_param_map( new ParamMap( "server_param" ) )
+    : M_param_map( new ParamMap( "server_param" ) ),
+      M_version( 0 )
 {
     assert( M_param_map );
 
@@ -698,6 +699,8 @@ ServerParam::setDefaultParam()
 void
 ServerParam::setAdditionalParam()
 {
+    ++M_version;
+
     M_kickable_area = M_kickable_margin + M_ball_size + M_player_size;
     M_catchable_area = std::sqrt( std::pow( catchAreaWidth() * 0.5, 2 )
                                   + std::pow( catchAreaLength(), 2 ) );
@@ -661,6 +661,9 @@ private:
     double M_catchable_area; //!< real catchable length (diagonal line length)
     double M_real_speed_max; //!< default player's real max speed
 
+    //! incremented whenever the parameters are (re)loaded
+    std::size_t M_version;
+
 private:
     /*!
       \brief constructor defined as private member for Singleton Pattern
@@ -1278,6 +1281,16 @@ public:
           return M_catchable_area;
       }
 
+    /*!
+      \brief get the parameter version. the value is changed whenever
+      the parameters are (re)loaded, so that it can be used as a cache key.
+      \return parameter version
+     */
+    std::size_t version() const
+      {
+          return M_version;
+      }
+
     // utility
 
     /*!
@@ -35,6 +35,7 @@
 #include <memory>
 #include <list>
 #include <string>
+#include <cstdint>
 
 namespace rcsc {
 
@@ -170,6 +171,21 @@ protected:
     void handleTimeout( const int timeout_count,
                         const int waited_msec ) = 0;
 
+    /*!
+      \brief (virtual) get the time until the next timeout event that the agent needs.
+      \return micro seconds from now. a negative value means that the
+      client's fixed interval is used.
+
+      This method is called by the client after each event to arm the
+      timer.  Override this method to wake up exactly at the agent's
+      deadline instead of polling.
+     */
+    virtual
+    std::int64_t nextTimeoutUSec() const
+      {
+          return -1;
+      }
+
     /*!
       \brief (pure virtual) handle exit event
 
@@ -0,0 +1,646 @@
+// -*-c++-*-
+
+/*!
+  \file test_audio_codec.cpp
+  \brief test code for rcsc::AudioCodec and the say message builders/parsers
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "audio_codec.h"
+#include "audio_memory.h"
+#include "say_message_parser.h"
+#include "server_param.h"
+
+#include <rcsc/player/say_message_builder.h>
+#include <rcsc/game_time.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+#include <sstream>
+#include <iostream>
+#include <cstring>
+#include <cmath>
+
+using namespace rcsc;
+
+namespace {
+
+const double POS_TOLERANCE = 1.0;
+const double VEL_TOLERANCE = 0.2;
+const double ANGLE_TOLERANCE = 6.0;
+const double RATE_TOLERANCE = 1.0 / ( AudioCodec::CHAR_SIZE - 1 );
+
+/*!
+  \brief parser set that dispatches the message by its header character
+ */
+class ParserSet {
+private:
+    std::shared_ptr< AudioMemory > M_memory;
+    std::vector< SayMessageParser::Ptr > M_parsers;
+public:
+
+    ParserSet()
+        : M_memory( new AudioMemory() )
+      {
+          M_parsers.emplace_back( new BallMessageParser( M_memory ) );
+          M_parsers.emplace_back( new PassMessageParser( M_memory ) );
+          M_parsers.emplace_back( new InterceptMessageParser( M_memory ) );
+          M_parsers.emplace_back( new GoalieMessageParser( M_memory ) );
+          M_parsers.emplace_back( new GoalieAndPlayerMessageParser( M_memory ) );
+          M_parsers.emplace_back( new OffsideLineMessageParser( M_memory ) );
+          M_parsers.emplace_back( new DefenseLineMessageParser( M_memory ) );
+          M_parsers.emplace_back( new WaitRequestMessageParser( M_memory ) );
+          M_parsers.emplace_back( new SetplayMessageParser( M_memory ) );
+          M_parsers.emplace_back( new PassRequestMessageParser( M_memory ) );
+          M_parsers.emplace_back( new StaminaMessageParser( M_memory ) );
+          M_parsers.emplace_back( new RecoveryMessageParser( M_memory ) );
+          M_parsers.emplace_back( new StaminaCapacityMessageParser( M_memory ) );
+          M_parsers.emplace_back( new DribbleMessageParser( M_memory ) );
+          M_parsers.emplace_back( new BallGoalieMessageParser( M_memory ) );
+          M_parsers.emplace_back( new OnePlayerMessageParser( M_memory ) );
+          M_parsers.emplace_back( new TwoPlayerMessageParser( M_memory ) );
+          M_parsers.emplace_back( new ThreePlayerMessageParser( M_memory ) );
+          M_parsers.emplace_back( new SelfMessageParser( M_memory ) );
+          M_parsers.emplace_back( new TeammateMessageParser( M_memory ) );
+          M_parsers.emplace_back( new OpponentMessageParser( M_memory ) );
+          M_parsers.emplace_back( new BallPlayerMessageParser( M_memory ) );
+          M_parsers.emplace_back( new JointMessageParser( M_memory ) );
+      }
+
+    const AudioMemory & memory() const
+      {
+          return *M_memory;
+      }
+
+    const std::vector< SayMessageParser::Ptr > & parsers() const
+      {
+          return M_parsers;
+      }
+
+    int parse( const int sender,
+               const char * msg,
+               const GameTime & current )
+      {
+          for ( const SayMessageParser::Ptr & p : M_parsers )
+          {
+              if ( p->header() == *msg )
+              {
+                  return p->parse( sender, 0.0, msg, current );
+              }
+          }
+          return 0;
+      }
+};
+
+/*!
+  \brief build one message and parse it by the parser set
+ */
+void
+round_trip( ParserSet & parsers,
+            const SayMessage & message,
+            const GameTime & current )
+{
+    std::string msg;
+    CPPUNIT_ASSERT( message.appendTo( msg ) );
+    CPPUNIT_ASSERT_EQUAL( message.length(), static_cast< int >( msg.length() ) );
+    CPPUNIT_ASSERT_EQUAL( message.header(), msg[0] );
+    CPPUNIT_ASSERT_EQUAL( message.length(), parsers.parse( 7, msg.c_str(), current ) );
+}
+
+void
+check_pos( const Vector2D & expected,
+           const Vector2D & actual )
+{
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.x, actual.x, POS_TOLERANCE );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.y, actual.y, POS_TOLERANCE );
+}
+
+void
+check_vel( const Vector2D & expected,
+           const Vector2D & actual )
+{
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.x, actual.x, VEL_TOLERANCE );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.y, actual.y, VEL_TOLERANCE );
+}
+
+void
+check_angle( const double expected,
+             const double actual )
+{
+    CPPUNIT_ASSERT( ( AngleDeg( expected ) - AngleDeg( actual ) ).abs() <= ANGLE_TOLERANCE );
+}
+
+}
+
+class AudioCodecTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( AudioCodecTest );
+    CPPUNIT_TEST( testCharTable );
+    CPPUNIT_TEST( testInt64 );
+    CPPUNIT_TEST( testBuffer );
+    CPPUNIT_TEST( testRoundTrip );
+    CPPUNIT_TEST( testFuzz );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+
+    std::mt19937 M_engine;
+
+    double uniform( const double min,
+                    const double max )
+      {
+          return std::uniform_real_distribution<>( min, max )( M_engine );
+      }
+
+    int uniformInt( const int min,
+                    const int max )
+      {
+          return std::uniform_int_distribution<>( min, max )( M_engine );
+      }
+
+    Vector2D fieldPos()
+      {
+          return Vector2D( uniform( -52.0, 52.0 ), uniform( -33.5, 33.5 ) );
+      }
+
+    Vector2D ballVel()
+      {
+          return Vector2D::polar2vector( uniform( 0.0, 2.5 ), uniform( -180.0, 180.0 ) );
+      }
+
+public:
+
+    void setUp();
+    void tearDown();
+
+    void testCharTable();
+    void testInt64();
+    void testBuffer();
+    void testRoundTrip();
+    void testFuzz();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( AudioCodecTest );
+
+/*-------------------------------------------------------------------*/
+void
+AudioCodecTest::setUp()
+{
+    M_engine.seed( 7 );
+    AudioCodec::instance().createMap( 0 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+AudioCodecTest::tearDown()
+{
+    AudioCodec::instance().createMap( 0 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+AudioCodecTest::testCharTable()
+{
+    CPPUNIT_ASSERT_EQUAL( 74, AudioCodec::CHAR_SIZE );
+
+    for ( int shift = 0; shift < 80; shift += 13 )
+    {
+        AudioCodec::instance().createMap( shift );
+        const AudioCodec & codec = AudioCodec::i();
+
+        CPPUNIT_ASSERT_EQUAL( static_cast< std::size_t >( AudioCodec::CHAR_SIZE ),
+                              codec.charToIntMap().size() );
+
+        int valid_count = 0;
+        for ( int c = 0; c < 256; ++c )
+        {
+            const char ch = static_cast< char >( c );
+            const int val = codec.charToInt( ch );
+            if ( val < 0 )
+            {
+                CPPUNIT_ASSERT( codec.charToIntMap().find( ch ) == codec.charToIntMap().end() );
+                continue;
+            }
+
+            ++valid_count;
+            CPPUNIT_ASSERT( val < AudioCodec::CHAR_SIZE );
+            CPPUNIT_ASSERT_EQUAL( val, codec.charToIntMap().at( ch ) );
+            CPPUNIT_ASSERT_EQUAL( ch, codec.intToChar( val ) );
+            CPPUNIT_ASSERT_EQUAL( ch, codec.intToCharMap().at( val ) );
+        }
+
+        CPPUNIT_ASSERT_EQUAL( AudioCodec::CHAR_SIZE, valid_count );
+        CPPUNIT_ASSERT_EQUAL( '\0', codec.intToChar( -1 ) );
+        CPPUNIT_ASSERT_EQUAL( '\0', codec.intToChar( AudioCodec::CHAR_SIZE ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+AudioCodecTest::testInt64()
+{
+    const AudioCodec & codec = AudioCodec::i();
+
+    std::int64_t max_value = 1;
+    for ( int len = 1; len <= 10; ++len )
+    {
+        max_value *= AudioCodec::CHAR_SIZE;
+
+        for ( int loop = 0; loop < 1000; ++loop )
+        {
+            const std::int64_t ival
+                = ( loop == 0 ? 0
+                    : loop == 1 ? max_value - 1
+                    : std::uniform_int_distribution< std::int64_t >( 0, max_value - 1 )( M_engine ) );
+
+            char buf[16];
+            CPPUNIT_ASSERT( codec.encodeInt64ToStr( ival, len, buf ) );
+
+            std::string str = "x";
+            CPPUNIT_ASSERT( codec.encodeInt64ToStr( ival, len, str ) );
+            CPPUNIT_ASSERT_EQUAL( std::string( "x" ) + std::string( buf, len ), str );
+
+            std::int64_t decoded = -1;
+            CPPUNIT_ASSERT( codec.decodeStrToInt64( std::string_view( buf, len ), &decoded ) );
+            CPPUNIT_ASSERT_EQUAL( ival, decoded );
+        }
+
+    }
+
+    std::ostringstream null_stream;
+    std::streambuf * old_buf = std::cerr.rdbuf( null_stream.rdbuf() );
+
+    max_value = 1;
+    for ( int len = 1; len <= 10; ++len )
+    {
+        max_value *= AudioCodec::CHAR_SIZE;
+
+        std::string str;
+        CPPUNIT_ASSERT( ! codec.encodeInt64ToStr( max_value, len, str ) );
+        CPPUNIT_ASSERT( str.empty() );
+    }
+
+    CPPUNIT_ASSERT( ! codec.decodeStrToInt64( std::string_view(), nullptr ) );
+    CPPUNIT_ASSERT( ! codec.decodeStrToInt64( "ab!c", nullptr ) );
+    CPPUNIT_ASSERT( ! codec.decodeStrToInt64( std::string_view( "ab\0c", 4 ), nullptr ) );
+    char buf[4];
+    CPPUNIT_ASSERT( ! codec.encodeInt64ToStr( -1, 3, buf ) );
+
+    std::cerr.rdbuf( old_buf );
+}
+
+/*-------------------------------------------------------------------*/
+void
+AudioCodecTest::testBuffer()
+{
+    const AudioCodec & codec = AudioCodec::i();
+
+    for ( int loop = 0; loop < 1000; ++loop )
+    {
+        const Vector2D pos = fieldPos();
+        const Vector2D vel = ballVel();
+
+        {
+            std::string str;
+            char buf[5];
+            CPPUNIT_ASSERT( codec.encodePosVelToStr5( pos, vel, str ) );
+            CPPUNIT_ASSERT( codec.encodePosVelToStr5( pos, vel, buf ) );
+            CPPUNIT_ASSERT_EQUAL( str, std::string( buf, 5 ) );
+
+            Vector2D p, v;
+            CPPUNIT_ASSERT( codec.decodeStr5ToPosVel( std::string_view( buf, 5 ), &p, &v ) );
+            check_pos( pos, p );
+            check_vel( vel, v );
+        }
+        {
+            std::string str;
+            char buf[3];
+            CPPUNIT_ASSERT( codec.encodePosToStr3( pos, str ) );
+            CPPUNIT_ASSERT( codec.encodePosToStr3( pos, buf ) );
+            CPPUNIT_ASSERT_EQUAL( str, std::string( buf, 3 ) );
+
+            Vector2D p;
+            CPPUNIT_ASSERT( codec.decodeStr3ToPos( std::string_view( buf, 3 ), &p ) );
+            check_pos( pos, p );
+        }
+        {
+            const int unum = uniformInt( 1, 11 );
+            std::string str;
+            char buf[4];
+            CPPUNIT_ASSERT( codec.encodeUnumPosToStr4( unum, pos, str ) );
+            CPPUNIT_ASSERT( codec.encodeUnumPosToStr4( unum, pos, buf ) );
+            CPPUNIT_ASSERT_EQUAL( str, std::string( buf, 4 ) );
+
+            int u = 0;
+            Vector2D p;
+            CPPUNIT_ASSERT( codec.decodeStr4ToUnumPos( std::string_view( buf, 4 ), &u, &p ) );
+            CPPUNIT_ASSERT_EQUAL( unum, u );
+            check_pos( pos, p );
+        }
+        {
+            char buf[4];
+            CPPUNIT_ASSERT( codec.encodePosToStr4( pos, buf ) );
+            CPPUNIT_ASSERT_EQUAL( codec.encodePosToStr4( pos ), std::string( buf, 4 ) );
+
+            const Vector2D p = codec.decodeStr4ToPos( std::string_view( buf, 4 ) );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( pos.x, p.x, 0.05 + 1.0e-6 );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( pos.y, p.y, 0.05 + 1.0e-6 );
+        }
+        {
+            const double rate = uniform( 0.0, 1.0 );
+            const char ch = codec.encodePercentageToChar( rate );
+            CPPUNIT_ASSERT( ch != '\0' );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( rate, codec.decodeCharToPercentage( ch ), RATE_TOLERANCE );
+
+            const double speed = uniform( -3.0, 3.0 );
+            const char sch = codec.encodeSpeedToChar( speed );
+            CPPUNIT_ASSERT( sch != '\0' );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( speed, codec.decodeCharToSpeed( sch ), 0.05 + 1.0e-6 );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+AudioCodecTest::testRoundTrip()
+{
+    const ServerParam & SP = ServerParam::i();
+
+    ParserSet parsers;
+    const AudioMemory & memory = parsers.memory();
+
+    for ( int loop = 0; loop < 500; ++loop )
+    {
+        const GameTime current( loop + 1, 0 );
+
+        {
+            const Vector2D pos = fieldPos(), vel = ballVel();
+            round_trip( parsers, BallMessage( pos, vel ), current );
+            check_pos( pos, memory.ball().back().pos_ );
+            check_vel( vel, memory.ball().back().vel_ );
+        }
+        {
+            const int receiver = uniformInt( 1, 11 );
+            const Vector2D receive_pos = fieldPos(), pos = fieldPos(), vel = ballVel();
+            round_trip( parsers, PassMessage( receiver, receive_pos, pos, vel ), current );
+            CPPUNIT_ASSERT_EQUAL( receiver, memory.pass().back().receiver_ );
+            check_pos( receive_pos, memory.pass().back().receive_pos_ );
+            check_pos( pos, memory.ball().back().pos_ );
+            check_vel( vel, memory.ball().back().vel_ );
+        }
+        {
+            const bool our = ( uniformInt( 0, 1 ) == 0 );
+            const int unum = uniformInt( 1, 11 );
+            const int cycle = uniformInt( 1, AudioCodec::CHAR_SIZE - 1 );
+            round_trip( parsers, InterceptMessage( our, unum, cycle ), current );
+            // AudioMemory subtracts one cycle from the heard value
+            if ( our )
+            {
+                CPPUNIT_ASSERT_EQUAL( unum, memory.ourIntercept().back().interceptor_ );
+                CPPUNIT_ASSERT_EQUAL( cycle - 1, memory.ourIntercept().back().cycle_ );
+            }
+            else
+            {
+                CPPUNIT_ASSERT_EQUAL( unum, memory.oppIntercept().back().interceptor_ );
+                CPPUNIT_ASSERT_EQUAL( cycle - 1, memory.oppIntercept().back().cycle_ );
+            }
+        }
+        {
+            const Vector2D goalie_pos( uniform( 37.0, 52.9 ), uniform( -19.9, 19.9 ) );
+            const double body = uniform( -180.0, 180.0 );
+            round_trip( parsers, GoalieMessage( 1, goalie_pos, body ), current );
+            check_pos( goalie_pos, memory.goalie().back().pos_ );
+            check_angle( body, memory.goalie().back().body_.degree() );
+
+            const int player = uniformInt( 1, 22 );
+            const Vector2D player_pos = fieldPos();
+            round_trip( parsers, GoalieAndPlayerMessage( 1, goalie_pos, body, player, player_pos ),
+                        current );
+            check_pos( goalie_pos, memory.goalie().back().pos_ );
+            check_angle( body, memory.goalie().back().body_.degree() );
+            CPPUNIT_ASSERT_EQUAL( player, memory.player().back().unum_ );
+            check_pos( player_pos, memory.player().back().pos_ );
+
+            const Vector2D pos = fieldPos(), vel = ballVel();
+            const Vector2D goalie_pos2( uniform( 36.5, 52.5 ), uniform( -20.0, 20.0 ) );
+            round_trip( parsers, BallGoalieMessage( pos, vel, goalie_pos2, body ), current );
+            check_pos( pos, memory.ball().back().pos_ );
+            check_vel( vel, memory.ball().back().vel_ );
+            check_pos( goalie_pos2, memory.goalie().back().pos_ );
+            check_angle( body, memory.goalie().back().body_.degree() );
+        }
+        {
+            const double offside_x = uniform( 10.0, 52.0 );
+            round_trip( parsers, OffsideLineMessage( offside_x ), current );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( offside_x, memory.offsideLine().back().x_, POS_TOLERANCE );
+
+            const double defense_x = uniform( -52.0, -10.0 );
+            round_trip( parsers, DefenseLineMessage( defense_x ), current );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( defense_x, memory.defenseLine().back().x_, POS_TOLERANCE );
+        }
+        {
+            round_trip( parsers, WaitRequestMessage(), current );
+            CPPUNIT_ASSERT_EQUAL( 7, memory.waitRequest().back().sender_ );
+
+            const int wait_step = uniformInt( 1, AudioCodec::CHAR_SIZE - 1 );
+            round_trip( parsers, SetplayMessage( wait_step ), current );
+            CPPUNIT_ASSERT_EQUAL( wait_step, memory.setplay().back().wait_step_ );
+        }
+        {
+            const Vector2D target = fieldPos();
+            round_trip( parsers, PassRequestMessage( target ), current );
+            check_pos( target, memory.passRequest().back().pos_ );
+
+            const int count = uniformInt( 1, 10 );
+            round_trip( parsers, DribbleMessage( target, count ), current );
+            check_pos( target, memory.dribble().back().target_ );
+            CPPUNIT_ASSERT_EQUAL( count, memory.dribble().back().queue_count_ );
+        }
+        {
+            const double stamina_rate = uniform( 0.0, 1.0 );
+            round_trip( parsers, StaminaMessage( SP.staminaMax() * stamina_rate ), current );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( stamina_rate, memory.stamina().back().rate_, RATE_TOLERANCE );
+
+            const double recovery_rate = uniform( 0.0, 1.0 );
+            round_trip( parsers,
+                        RecoveryMessage( SP.recoverMin()
+                                         + ( SP.recoverInit() - SP.recoverMin() ) * recovery_rate ),
+                        current );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( recovery_rate, memory.recovery().back().rate_, RATE_TOLERANCE );
+
+            const double capacity_rate = uniform( 0.0, 1.0 );
+            round_trip( parsers, StaminaCapacityMessage( SP.staminaCapacity() * capacity_rate ), current );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( capacity_rate, memory.staminaCapacity().back().rate_, RATE_TOLERANCE );
+        }
+        {
+            int unum[3];
+            Vector2D pos[3];
+            for ( int i = 0; i < 3; ++i )
+            {
+                unum[i] = uniformInt( 1, 22 );
+                pos[i] = fieldPos();
+            }
+
+            round_trip( parsers, OnePlayerMessage( unum[0], pos[0] ), current );
+            CPPUNIT_ASSERT_EQUAL( unum[0], memory.player().back().unum_ );
+            check_pos( pos[0], memory.player().back().pos_ );
+
+            const GameTime two_time( current.cycle(), 1 );
+            round_trip( parsers, TwoPlayerMessage( unum[0], pos[0], unum[1], pos[1] ), two_time );
+            CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), memory.player().size() );
+            for ( int i = 0; i < 2; ++i )
+            {
+                CPPUNIT_ASSERT_EQUAL( unum[i], memory.player()[i].unum_ );
+                check_pos( pos[i], memory.player()[i].pos_ );
+            }
+
+            const GameTime three_time( current.cycle(), 2 );
+            round_trip( parsers,
+                        ThreePlayerMessage( unum[0], pos[0], unum[1], pos[1], unum[2], pos[2] ),
+                        three_time );
+            CPPUNIT_ASSERT_EQUAL( std::size_t( 3 ), memory.player().size() );
+            for ( int i = 0; i < 3; ++i )
+            {
+                CPPUNIT_ASSERT_EQUAL( unum[i], memory.player()[i].unum_ );
+                check_pos( pos[i], memory.player()[i].pos_ );
+            }
+        }
+        {
+            const Vector2D pos = fieldPos();
+            const double body = uniform( -180.0, 180.0 );
+            const double stamina = uniform( 0.0, SP.staminaMax() );
+
+            round_trip( parsers, SelfMessage( pos, body, stamina ), current );
+            CPPUNIT_ASSERT_EQUAL( 7, memory.player().back().unum_ );
+            check_pos( pos, memory.player().back().pos_ );
+            check_angle( body, memory.player().back().body_ );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( stamina, memory.player().back().stamina_, SP.staminaMax() * 0.05 + 1.0e-6 );
+
+            const int unum = uniformInt( 1, 11 );
+            round_trip( parsers, TeammateMessage( unum, pos, body ), current );
+            CPPUNIT_ASSERT_EQUAL( unum, memory.player().back().unum_ );
+            check_pos( pos, memory.player().back().pos_ );
+            check_angle( body, memory.player().back().body_ );
+
+            round_trip( parsers, OpponentMessage( unum, pos, body ), current );
+            CPPUNIT_ASSERT_EQUAL( unum + 11, memory.player().back().unum_ );
+            check_pos( pos, memory.player().back().pos_ );
+            check_angle( body, memory.player().back().body_ );
+
+            const Vector2D ball_pos = fieldPos(), ball_vel = ballVel();
+            const int player = uniformInt( 1, 22 );
+            round_trip( parsers, BallPlayerMessage( ball_pos, ball_vel, player, pos, body ), current );
+            check_pos( ball_pos, memory.ball().back().pos_ );
+            check_vel( ball_vel, memory.ball().back().vel_ );
+            CPPUNIT_ASSERT_EQUAL( player, memory.player().back().unum_ );
+            check_pos( pos, memory.player().back().pos_ );
+            check_angle( body, memory.player().back().body_ );
+        }
+        {
+            const Vector2D pos = fieldPos(), vel = ballVel();
+            const std::vector< JointItem > items = { JointItem::ball( pos, vel, 1.0 ) };
+            round_trip( parsers, JointMessage( items ), current );
+            check_pos( pos, memory.ball().back().pos_ );
+            check_vel( vel, memory.ball().back().vel_ );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+AudioCodecTest::testFuzz()
+{
+    ParserSet parsers;
+
+    std::ostringstream null_stream;
+    std::streambuf * old_buf = std::cerr.rdbuf( null_stream.rdbuf() );
+
+    char buf[32];
+    for ( int loop = 0; loop < 20000; ++loop )
+    {
+        const GameTime current( loop + 1, 0 );
+
+        for ( const SayMessageParser::Ptr & p : parsers.parsers() )
+        {
+            const int len = uniformInt( 0, 12 );
+            buf[0] = p->header();
+            for ( int i = 1; i <= len; ++i )
+            {
+                // mostly legal characters with some illegal bytes
+                buf[i] = ( uniformInt( 0, 9 ) == 0
+                           ? static_cast< char >( uniformInt( 1, 255 ) )
+                           : AudioCodec::CHAR_SET[uniformInt( 0, AudioCodec::CHAR_SIZE - 1 )] );
+            }
+            buf[len + 1] = '\0';
+
+            const int result = p->parse( 7, 0.0, buf, current );
+            CPPUNIT_ASSERT( -1 <= result );
+            CPPUNIT_ASSERT( result <= static_cast< int >( std::strlen( buf ) ) );
+        }
+    }
+
+    std::cerr.rdbuf( old_buf );
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+// -*-c++-*-
+
+/*!
+  \file test_joint_message_codec.cpp
+  \brief test code for rcsc::JointMessageCodec
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "joint_message_codec.h"
+#include "say_message_parser.h"
+#include "audio_memory.h"
+#include "server_param.h"
+
+#include <rcsc/game_time.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+#include <iostream>
+#include <cmath>
+
+class JointMessageCodecTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( JointMessageCodecTest );
+    CPPUNIT_TEST( testRoundTrip );
+    CPPUNIT_TEST( testSelect );
+    CPPUNIT_TEST( testParser );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testRoundTrip();
+    void testSelect();
+    void testParser();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( JointMessageCodecTest );
+
+/*-------------------------------------------------------------------*/
+void
+JointMessageCodecTest::testRoundTrip()
+{
+    const rcsc::JointMessageCodec & codec = rcsc::JointMessageCodec::i();
+
+    std::mt19937 engine( 12345 );
+
+    for ( int loop = 0; loop < 1000; ++loop )
+    {
+        std::vector< rcsc::JointItem > items;
+
+        const int n = std::uniform_int_distribution<>( 1, 6 )( engine );
+        for ( int i = 0; i < n; ++i )
+        {
+            rcsc::JointItem item;
+            item.type_ = static_cast< rcsc::JointItem::Type >
+                ( std::uniform_int_distribution<>( 1, rcsc::JointItem::MAX_TYPE - 1 )( engine ) );
+            item.value_ = 1.0;
+
+            const std::vector< rcsc::JointField > & fields = codec.fields( item.type_ );
+            for ( std::size_t f = 0; f < fields.size(); ++f )
+            {
+                const double max = fields[f].decode( fields[f].radix_ - 1 );
+                item.field_[f] = std::uniform_real_distribution<>( fields[f].min_, max )( engine );
+            }
+            items.push_back( item );
+        }
+
+        std::string msg;
+        const int len = codec.encode( items, msg );
+        CPPUNIT_ASSERT_EQUAL( static_cast< int >( msg.length() ), len );
+
+        double bits = 0.0;
+        for ( const rcsc::JointItem & item : items )
+        {
+            bits += codec.itemBits( item.type_ );
+        }
+        CPPUNIT_ASSERT( len <= static_cast< int >( std::ceil( bits / codec.charBits() ) ) );
+
+        std::vector< rcsc::JointItem > decoded;
+        CPPUNIT_ASSERT( codec.decode( msg.c_str(), len, &decoded ) );
+        CPPUNIT_ASSERT_EQUAL( items.size(), decoded.size() );
+
+        for ( std::size_t i = 0; i < items.size(); ++i )
+        {
+            CPPUNIT_ASSERT_EQUAL( items[i].type_, decoded[i].type_ );
+
+            const std::vector< rcsc::JointField > & fields = codec.fields( items[i].type_ );
+            for ( std::size_t f = 0; f < fields.size(); ++f )
+            {
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( items[i].field_[f], decoded[i].field_[f],
+                                              fields[f].step_ * 0.5 + 1.0e-9 );
+            }
+        }
+    }
+
+    // illegal character
+    std::vector< rcsc::JointItem > decoded;
+    CPPUNIT_ASSERT( ! codec.decode( "ab#", 3, &decoded ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+JointMessageCodecTest::testSelect()
+{
+    const rcsc::JointMessageCodec & codec = rcsc::JointMessageCodec::i();
+
+    std::vector< rcsc::JointItem > items;
+    items.push_back( rcsc::JointItem::stamina( 0.8, 2.0 ) );
+    items.push_back( rcsc::JointItem::ball( rcsc::Vector2D( 10.0, -5.0 ), rcsc::Vector2D( 1.0, 0.5 ), 10.0 ) );
+    items.push_back( rcsc::JointItem::player( 5, rcsc::Vector2D( -20.0, 3.0 ), 4.0 ) );
+    items.push_back( rcsc::JointItem::player( 16, rcsc::Vector2D( 15.0, 8.0 ), 3.5 ) );
+    items.push_back( rcsc::JointItem::intercept( 7, 12, 5.0 ) );
+    items.push_back( rcsc::JointItem::offside_line( 20.3, 1.0 ) );
+    items.push_back( rcsc::JointItem::wait_request( 0.5 ) );
+    items.push_back( rcsc::JointItem::defense_line( -30.1, 1.5 ) );
+
+    for ( int max_length = 1; max_length <= 12; ++max_length )
+    {
+        const std::vector< std::size_t > selected = codec.select( items, max_length );
+
+        double value = 0.0;
+        std::vector< rcsc::JointItem > selected_items;
+        for ( std::size_t i : selected )
+        {
+            value += items[i].value_;
+            selected_items.push_back( items[i] );
+        }
+
+        std::string msg;
+        const int len = codec.encode( selected_items, msg );
+        CPPUNIT_ASSERT( len <= max_length );
+
+        // brute force
+        double best = 0.0;
+        for ( unsigned int mask = 0; mask < ( 1u << items.size() ); ++mask )
+        {
+            double bits = 0.0;
+            double v = 0.0;
+            for ( std::size_t i = 0; i < items.size(); ++i )
+            {
+                if ( mask & ( 1u << i ) )
+                {
+                    bits += codec.itemBits( items[i].type_ );
+                    v += items[i].value_;
+                }
+            }
+
+            // allow the quantization margin of the selector
+            if ( bits + items.size() / 64.0 <= max_length * codec.charBits() )
+            {
+                best = std::max( best, v );
+            }
+        }
+
+        CPPUNIT_ASSERT( value >= best - 1.0e-9 );
+    }
+
+    // default say budget: header + 9 characters can hold the ball and an interceptor.
+    const std::vector< std::size_t > selected = codec.select( items, rcsc::ServerParam::DEFAULT_PLAYER_SAY_MSG_SIZE - 1 );
+    double value = 0.0;
+    for ( std::size_t i : selected ) value += items[i].value_;
+    std::cout << "\n" << selected.size() << " items (value " << value << ") in "
+              << rcsc::ServerParam::DEFAULT_PLAYER_SAY_MSG_SIZE << " characters" << std::endl;
+    CPPUNIT_ASSERT( value >= 15.0 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+JointMessageCodecTest::testParser()
+{
+    std::shared_ptr< rcsc::AudioMemory > memory( new rcsc::AudioMemory() );
+    rcsc::JointMessageParser parser( memory );
+
+    std::vector< rcsc::JointItem > items;
+    items.push_back( rcsc::JointItem::ball( rcsc::Vector2D( 10.0, -5.0 ), rcsc::Vector2D( 1.0, 0.5 ), 1.0 ) );
+    items.push_back( rcsc::JointItem::player( 16, rcsc::Vector2D( 15.0, 8.0 ), 1.0 ) );
+    items.push_back( rcsc::JointItem::player( 3, rcsc::Vector2D( -15.0, 8.25 ), 1.0 ) );
+    items.push_back( rcsc::JointItem::intercept( 7, 12, 1.0 ) );
+
+    std::string msg;
+    msg += rcsc::JointMessageParser::sheader();
+    rcsc::JointMessageCodec::i().encode( items, msg );
+
+    const rcsc::GameTime current( 10, 0 );
+    CPPUNIT_ASSERT_EQUAL( static_cast< int >( msg.length() ),
+                          parser.parse( 2, 0.0, msg.c_str(), current ) );
+
+    CPPUNIT_ASSERT( memory->ballTime() == current );
+    CPPUNIT_ASSERT_EQUAL( static_cast< std::size_t >( 1 ), memory->ball().size() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 10.0, memory->ball().front().pos_.x, 0.05 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5, memory->ball().front().vel_.y, 0.01 );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast< std::size_t >( 2 ), memory->player().size() );
+    CPPUNIT_ASSERT_EQUAL( 16, memory->player()[0].unum_ );
+    CPPUNIT_ASSERT_EQUAL( 3, memory->player()[1].unum_ );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 8.25, memory->player()[1].pos_.y, 1.0e-9 );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast< std::size_t >( 1 ), memory->ourIntercept().size() );
+    // AudioMemory subtracts one cycle from the heard value
+    CPPUNIT_ASSERT_EQUAL( 11, memory->ourIntercept().front().cycle_ );
+
+    CPPUNIT_ASSERT_EQUAL( 0, parser.parse( 2, 0.0, "b123", current ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
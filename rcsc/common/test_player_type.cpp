@@ -0,0 +1,182 @@
+// -*-c++-*-
+
+/*!
+  \file test_player_type.cpp
+  \brief test code for the reach tables of rcsc::PlayerType
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "player_type.h"
+#include "server_param.h"
+
+#include <rcsc/time/timer.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+class PlayerTypeTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( PlayerTypeTest );
+    CPPUNIT_TEST( testValidate );
+    CPPUNIT_TEST( testStamina );
+    CPPUNIT_TEST( testBenchmark );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testValidate();
+    void testStamina();
+    void testBenchmark();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( PlayerTypeTest );
+
+/*-------------------------------------------------------------------*/
+void
+PlayerTypeTest::testValidate()
+{
+    rcsc::PlayerTypeSet::instance().generate( 12345 );
+
+    const rcsc::PlayerTypeSet::Map & types = rcsc::PlayerTypeSet::i().playerTypeMap();
+    CPPUNIT_ASSERT( ! types.empty() );
+
+    for ( const rcsc::PlayerTypeSet::Map::value_type & v : types )
+    {
+        CPPUNIT_ASSERT( v.second.validateReachTables( std::cerr ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+PlayerTypeTest::testStamina()
+{
+    const rcsc::PlayerType ptype;
+    const double stamina_max = rcsc::ServerParam::i().staminaMax();
+
+    for ( double dist = 0.0; dist < 60.0; dist += 0.7 )
+    {
+        // less stamina never makes the player faster
+        int prev = ptype.cyclesToReachDistance( dist, 0.0 );
+        for ( double stamina = 500.0; stamina <= stamina_max; stamina += 500.0 )
+        {
+            const int n = ptype.cyclesToReachDistance( dist, stamina );
+            CPPUNIT_ASSERT( n <= prev );
+            prev = n;
+        }
+        CPPUNIT_ASSERT_EQUAL( ptype.cyclesToReachDistance( dist ),
+                              ptype.cyclesToReachDistance( dist, stamina_max ) );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 0, ptype.reachStep( ptype.kickableArea() * 0.5, 180.0 ) );
+    CPPUNIT_ASSERT( ptype.reachStep( 10.0, 90.0 ) > ptype.reachStep( 10.0, 0.0 ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+PlayerTypeTest::testBenchmark()
+{
+    const rcsc::PlayerType ptype;
+    const std::vector< double > & table = ptype.dashDistanceTable();
+    const int loop = 2000000;
+
+    long total = 0;
+    {
+        rcsc::Timer timer;
+        for ( int i = 0; i < loop; ++i )
+        {
+            const double dist = ( i % 4000 ) * 0.01;
+            std::vector< double >::const_iterator
+                it = std::lower_bound( table.begin(), table.end(), dist - 0.001 );
+            total += std::distance( table.begin(), it );
+        }
+        std::cout << "\nstd::lower_bound elapsed " << timer.elapsedReal()
+                  << " [ms] for " << loop << " queries." << std::endl;
+    }
+    {
+        rcsc::Timer timer;
+        for ( int i = 0; i < loop; ++i )
+        {
+            total += ptype.cyclesToReachDistance( ( i % 4000 ) * 0.01 );
+        }
+        std::cout << "cyclesToReachDistance elapsed " << timer.elapsedReal()
+                  << " [ms] for " << loop << " queries." << std::endl;
+    }
+    {
+        rcsc::Timer timer;
+        for ( int i = 0; i < loop; ++i )
+        {
+            total += ptype.reachStep( ( i % 4000 ) * 0.01, ( i % 180 ) );
+        }
+        std::cout << "reachStep elapsed " << timer.elapsedReal()
+                  << " [ms] for " << loop << " queries." << std::endl;
+    }
+
+    CPPUNIT_ASSERT( total > 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
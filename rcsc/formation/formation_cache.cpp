@@ -0,0 +1,521 @@
+// -*-c++-*-
+
+/*!
+  \file formation_cache.cpp
+  \brief compiled binary formation cache Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "formation_cache.h"
+
+#include "formation_dt.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <cstdio> // std::rename(), std::remove()
+#include <cstring> // memcpy(), memcmp()
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_UNISTD_H) && defined(HAVE_FCNTL_H)
+#include <sys/mman.h> // mmap(), munmap()
+#include <sys/stat.h> // fstat()
+#include <fcntl.h> // open()
+#include <unistd.h> // close(), getpid()
+#define RCSC_FORMATION_CACHE_MMAP
+#elif defined(HAVE_UNISTD_H)
+#include <unistd.h> // getpid()
+#endif
+
+namespace rcsc {
+
+const std::uint32_t FormationCache::FORMAT_VERSION = 1;
+const std::string FormationCache::SUFFIX = ".cache";
+
+bool FormationCache::S_enabled = true;
+
+namespace {
+
+//! magic number of the cache file
+const char MAGIC[8] = { 'R', 'C', 'S', 'C', 'F', 'M', 'C', '\0' };
+
+//! written in the host byte order to detect the foreign platform
+const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/*!
+  \struct FileHeader
+  \brief the first part of the cache file
+ */
+struct FileHeader {
+    char magic_[8]; //!< MAGIC
+    std::uint32_t format_version_; //!< FORMAT_VERSION
+    std::uint32_t byte_order_; //!< BYTE_ORDER_MARK
+    std::uint64_t source_hash_; //!< hash value of the source file content
+    std::uint64_t meta_size_; //!< byte size of the meta data block. multiple of 8
+    std::uint64_t table_size_; //!< byte size of the FormationDTTable block
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief serializer of the meta data block
+ */
+class MetaWriter {
+private:
+    std::string M_buf;
+public:
+
+    const std::string & buffer() const
+      {
+          return M_buf;
+      }
+
+    template < typename T >
+    void put( const T & value )
+      {
+          M_buf.append( reinterpret_cast< const char * >( &value ), sizeof( T ) );
+      }
+
+    void putString( const std::string & str )
+      {
+          put( static_cast< std::uint32_t >( str.size() ) );
+          M_buf.append( str );
+      }
+
+    void align()
+      {
+          while ( M_buf.size() % 8 != 0 )
+          {
+              M_buf.push_back( '\0' );
+          }
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief deserializer of the meta data block
+ */
+class MetaReader {
+private:
+    const char * M_ptr;
+    const char * M_end;
+public:
+
+    MetaReader( const char * data,
+                const std::size_t size )
+        : M_ptr( data ),
+          M_end( data + size )
+      { }
+
+    template < typename T >
+    bool get( T * value )
+      {
+          if ( static_cast< std::size_t >( M_end - M_ptr ) < sizeof( T ) ) return false;
+          std::memcpy( value, M_ptr, sizeof( T ) );
+          M_ptr += sizeof( T );
+          return true;
+      }
+
+    bool getString( std::string * str )
+      {
+          std::uint32_t len = 0;
+          if ( ! get( &len ) ) return false;
+          if ( static_cast< std::size_t >( M_end - M_ptr ) < len ) return false;
+          str->assign( M_ptr, len );
+          M_ptr += len;
+          return true;
+      }
+
+    std::size_t remaining() const
+      {
+          return static_cast< std::size_t >( M_end - M_ptr );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief read whole file into the memory block
+  \param filepath file path
+  \param size the byte size of the loaded block
+  \return owner of the memory block, or null if failed
+ */
+std::shared_ptr< const void >
+map_file( const std::string & filepath,
+          std::size_t * size )
+{
+#ifdef RCSC_FORMATION_CACHE_MMAP
+    const int fd = ::open( filepath.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+        return std::shared_ptr< const void >();
+    }
+
+    struct stat st;
+    if ( ::fstat( fd, &st ) != 0
+         || st.st_size < static_cast< off_t >( sizeof( FileHeader ) ) )
+    {
+        ::close( fd );
+        return std::shared_ptr< const void >();
+    }
+
+    const std::size_t len = static_cast< std::size_t >( st.st_size );
+    void * addr = ::mmap( nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+
+    if ( addr == MAP_FAILED )
+    {
+        return std::shared_ptr< const void >();
+    }
+
+    *size = len;
+    return std::shared_ptr< const void >( addr,
+                                          [len]( const void * p )
+                                          {
+                                              ::munmap( const_cast< void * >( p ), len );
+                                          } );
+#else
+    std::ifstream fin( filepath, std::ios::binary | std::ios::ate );
+    if ( ! fin )
+    {
+        return std::shared_ptr< const void >();
+    }
+
+    const std::streamoff len = fin.tellg();
+    if ( len < static_cast< std::streamoff >( sizeof( FileHeader ) ) )
+    {
+        return std::shared_ptr< const void >();
+    }
+
+    // double array to align the table block
+    std::shared_ptr< std::vector< double > > buf
+        = std::make_shared< std::vector< double > >( ( len + sizeof( double ) - 1 ) / sizeof( double ) );
+    fin.seekg( 0 );
+    if ( ! fin.read( reinterpret_cast< char * >( buf->data() ), len ) )
+    {
+        return std::shared_ptr< const void >();
+    }
+
+    *size = static_cast< std::size_t >( len );
+    return std::shared_ptr< const void >( buf, buf->data() );
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief restore the roles and the sample data from the meta data block
+ */
+bool
+read_meta( MetaReader & reader,
+           Formation::Ptr * result,
+           std::vector< FormationData::Data > * samples )
+{
+    std::string method;
+    std::string version;
+    if ( ! reader.getString( &method )
+         || ! reader.getString( &version ) )
+    {
+        return false;
+    }
+
+    Formation::Ptr ptr = Formation::create( method );
+    if ( ! ptr )
+    {
+        return false;
+    }
+
+    ptr->setVersion( version );
+
+    for ( int num = 1; num <= 11; ++num )
+    {
+        std::string name;
+        std::int32_t type = 0, side = 0, pair = 0;
+        if ( ! reader.getString( &name )
+             || ! reader.get( &type )
+             || ! reader.get( &side )
+             || ! reader.get( &pair ) )
+        {
+            return false;
+        }
+
+        if ( ! name.empty()
+             && ! ptr->setRoleName( num, name ) )
+        {
+            return false;
+        }
+
+        if ( ! ptr->setRoleType( num, RoleType( static_cast< RoleType::Type >( type ),
+                                                static_cast< RoleType::Side >( side ) ) )
+             || ! ptr->setPositionPair( num, pair ) )
+        {
+            return false;
+        }
+    }
+
+    std::uint32_t sample_size = 0;
+    if ( ! reader.get( &sample_size ) )
+    {
+        return false;
+    }
+
+    // the ball and 11 players for each sample.
+    // the count is checked not to reserve the memory for a broken size.
+    const std::size_t sample_bytes = ( 1 + 11 ) * 2 * sizeof( double );
+    if ( sample_size > reader.remaining() / sample_bytes )
+    {
+        return false;
+    }
+
+    samples->clear();
+    samples->reserve( sample_size );
+    for ( std::uint32_t i = 0; i < sample_size; ++i )
+    {
+        FormationData::Data d;
+        if ( ! reader.get( &d.ball_.x )
+             || ! reader.get( &d.ball_.y ) )
+        {
+            return false;
+        }
+
+        for ( int p = 0; p < 11; ++p )
+        {
+            Vector2D pos;
+            if ( ! reader.get( &pos.x )
+                 || ! reader.get( &pos.y ) )
+            {
+                return false;
+            }
+            d.players_.push_back( pos );
+        }
+
+        d.index_ = static_cast< int >( i );
+        samples->push_back( d );
+    }
+
+    *result = ptr;
+    return true;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::uint64_t
+FormationCache::hash( const std::string & content )
+{
+    std::uint64_t h = 14695981039346656037ULL;
+    for ( const char c : content )
+    {
+        h ^= static_cast< unsigned char >( c );
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Formation::Ptr
+FormationCache::load( const std::string & filepath,
+                      const std::uint64_t source_hash )
+{
+    std::size_t size = 0;
+    std::shared_ptr< const void > storage = map_file( filepath, &size );
+    if ( ! storage )
+    {
+        return Formation::Ptr();
+    }
+
+    const char * data = static_cast< const char * >( storage.get() );
+
+    FileHeader header;
+    std::memcpy( &header, data, sizeof( header ) );
+
+    if ( std::memcmp( header.magic_, MAGIC, sizeof( MAGIC ) ) != 0
+         || header.format_version_ != FORMAT_VERSION
+         || header.byte_order_ != BYTE_ORDER_MARK
+         || header.source_hash_ != source_hash )
+    {
+        // another version or stale cache
+        return Formation::Ptr();
+    }
+
+    if ( header.meta_size_ % 8 != 0
+         || header.meta_size_ > size
+         || header.table_size_ > size
+         || sizeof( header ) + header.meta_size_ + header.table_size_ != size )
+    {
+        std::cerr << "(FormationCache::load) broken cache file " << filepath << std::endl;
+        return Formation::Ptr();
+    }
+
+    Formation::Ptr ptr;
+    std::vector< FormationData::Data > samples;
+    MetaReader reader( data + sizeof( header ), header.meta_size_ );
+    if ( ! read_meta( reader, &ptr, &samples ) )
+    {
+        std::cerr << "(FormationCache::load) broken meta data " << filepath << std::endl;
+        return Formation::Ptr();
+    }
+
+    if ( header.table_size_ > 0 )
+    {
+        std::shared_ptr< FormationDT > dt = std::dynamic_pointer_cast< FormationDT >( ptr );
+        FormationDTTable table;
+        if ( ! dt
+             || ! table.assign( storage,
+                                data + sizeof( header ) + header.meta_size_,
+                                header.table_size_ )
+             || ! dt->setCompiledData( samples, table ) )
+        {
+            std::cerr << "(FormationCache::load) broken table " << filepath << std::endl;
+            return Formation::Ptr();
+        }
+
+        return ptr;
+    }
+
+    // the method without the compiled table
+    FormationData formation_data;
+    for ( const FormationData::Data & d : samples )
+    {
+        std::string err = formation_data.addData( d );
+        if ( ! err.empty() )
+        {
+            std::cerr << "(FormationCache::load) " << err << std::endl;
+            return Formation::Ptr();
+        }
+    }
+
+    if ( ! ptr->train( formation_data ) )
+    {
+        return Formation::Ptr();
+    }
+
+    return ptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+FormationCache::save( const std::string & filepath,
+                      const std::uint64_t source_hash,
+                      const Formation & formation )
+{
+    const FormationData::ConstPtr formation_data = formation.toData();
+    if ( ! formation_data )
+    {
+        return false;
+    }
+
+    MetaWriter writer;
+    writer.putString( formation.methodName() );
+    writer.putString( formation.version() );
+    for ( int i = 0; i < 11; ++i )
+    {
+        writer.putString( formation.roleNames()[i] );
+        writer.put( static_cast< std::int32_t >( formation.roleTypes()[i].type() ) );
+        writer.put( static_cast< std::int32_t >( formation.roleTypes()[i].side() ) );
+        writer.put( static_cast< std::int32_t >( formation.positionPairs()[i] ) );
+    }
+
+    writer.put( static_cast< std::uint32_t >( formation_data->dataCont().size() ) );
+    for ( const FormationData::Data & d : formation_data->dataCont() )
+    {
+        if ( d.players_.size() != 11 )
+        {
+            return false;
+        }
+
+        writer.put( d.ball_.x );
+        writer.put( d.ball_.y );
+        for ( const Vector2D & p : d.players_ )
+        {
+            writer.put( p.x );
+            writer.put( p.y );
+        }
+    }
+    writer.align();
+
+    const FormationDT * dt = dynamic_cast< const FormationDT * >( &formation );
+    const char * table_data = ( dt && ! dt->table().empty() ) ? dt->table().data() : nullptr;
+    const std::size_t table_size = ( table_data ? dt->table().size() : 0 );
+
+    FileHeader header;
+    std::memset( &header, 0, sizeof( header ) );
+    std::memcpy( header.magic_, MAGIC, sizeof( MAGIC ) );
+    header.format_version_ = FORMAT_VERSION;
+    header.byte_order_ = BYTE_ORDER_MARK;
+    header.source_hash_ = source_hash;
+    header.meta_size_ = writer.buffer().size();
+    header.table_size_ = table_size;
+
+    // write to the temporary file, and rename it not to expose the incomplete file
+    // to other processes that load the same formation at the same time.
+    std::string tmp_path = filepath + ".tmp";
+#if defined(HAVE_UNISTD_H)
+    tmp_path += std::to_string( ::getpid() );
+#endif
+
+    {
+        std::ofstream fout( tmp_path, std::ios::binary | std::ios::trunc );
+        if ( ! fout )
+        {
+            return false;
+        }
+
+        fout.write( reinterpret_cast< const char * >( &header ), sizeof( header ) );
+        fout.write( writer.buffer().data(), writer.buffer().size() );
+        if ( table_data )
+        {
+            fout.write( table_data, table_size );
+        }
+
+        fout.flush();
+        if ( ! fout )
+        {
+            fout.close();
+            std::remove( tmp_path.c_str() );
+            return false;
+        }
+    }
+
+    if ( std::rename( tmp_path.c_str(), filepath.c_str() ) != 0 )
+    {
+        std::remove( tmp_path.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+}
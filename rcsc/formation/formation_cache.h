@@ -0,0 +1,139 @@
+// -*-c++-*-
+
+/*!
+  \file formation_cache.h
+  \brief compiled binary formation cache Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_FORMATION_FORMATION_CACHE_H
+#define RCSC_FORMATION_FORMATION_CACHE_H
+
+#include <rcsc/formation/formation.h>
+
+#include <string>
+#include <cstdint>
+
+namespace rcsc {
+
+/*!
+  \class FormationCache
+  \brief compiled binary formation file that is placed next to the source file.
+
+  The cache file consists of the file header, the meta data block (method
+  name, version, roles and sample data) and, for FormationDT, the
+  FormationDTTable memory block.  The file is loaded through mmap when
+  available, and the table is used in place without copying.  The cache
+  is identified by the hash value of the source file content, so any
+  edit of the source file invalidates it.  The data are written in the
+  host byte order, and a cache written on a different platform is just
+  rejected.
+ */
+class FormationCache {
+public:
+
+    //! file format version
+    static const std::uint32_t FORMAT_VERSION;
+
+    //! file name suffix appended to the source file path
+    static const std::string SUFFIX;
+
+private:
+
+    //! global switch of the automatic cache
+    static bool S_enabled;
+
+    // not used
+    FormationCache() = delete;
+
+public:
+
+    /*!
+      \brief enable/disable the automatic cache in FormationParser::parse()
+      \param on switch value
+     */
+    static
+    void set_enabled( const bool on )
+      {
+          S_enabled = on;
+      }
+
+    /*!
+      \brief check if the automatic cache is enabled
+      \return checked result
+     */
+    static
+    bool enabled()
+      {
+          return S_enabled;
+      }
+
+    /*!
+      \brief compute the hash value (64bit FNV-1a) of the source content
+      \param content source file content
+      \return hash value
+     */
+    static
+    std::uint64_t hash( const std::string & content );
+
+    /*!
+      \brief get the cache file path for the source file
+      \param filepath source file path
+      \return cache file path
+     */
+    static
+    std::string cache_path( const std::string & filepath )
+      {
+          return filepath + SUFFIX;
+      }
+
+    /*!
+      \brief load the cache file
+      \param filepath cache file path
+      \param source_hash hash value of the current source content
+      \return formation object, or null if the cache is missing, stale or broken.
+     */
+    static
+    Formation::Ptr load( const std::string & filepath,
+                         const std::uint64_t source_hash );
+
+    /*!
+      \brief write the cache file. the file is replaced atomically.
+      \param filepath cache file path
+      \param source_hash hash value of the source content
+      \param formation formation object created from the source
+      \return true if success
+     */
+    static
+    bool save( const std::string & filepath,
+               const std::uint64_t source_hash,
+               const Formation & formation );
+
+};
+
+}
+
+#endif
@@ -35,8 +35,7 @@
 
 #include "formation_dt.h"
 
-#include <rcsc/geom/segment_2d.h>
-#include <rcsc/geom/line_2d.h>
+#include <rcsc/geom/rect_2d.h>
 
 namespace rcsc {
 
@@ -44,7 +43,8 @@ const std::string FormationDT::NAME( "DelaunayTriangulation" );
 
 /*-------------------------------------------------------------------*/
 FormationDT::FormationDT()
-    : Formation()
+    : Formation(),
+      M_triangulation_valid( true )
 {
 
 }
@@ -56,6 +56,35 @@ FormationDT::methodName() const
     return NAME;
 }
 
+/*-------------------------------------------------------------------*/
+const DelaunayTriangulation &
+FormationDT::triangulation() const
+{
+    if ( ! M_triangulation_valid )
+    {
+        computeTriangulation();
+    }
+
+    return M_triangulation;
+}
+
+/*-------------------------------------------------------------------*/
+void
+FormationDT::computeTriangulation() const
+{
+    Rect2D pitch( Vector2D( -60.0, -45.0 ),
+                  Size2D( 120.0, 90.0 ) );
+    M_triangulation.init( pitch );
+
+    for ( const FormationData::Data & d : M_points )
+    {
+        M_triangulation.addVertex( d.ball_ );
+    }
+
+    M_triangulation.compute();
+    M_triangulation_valid = true;
+}
+
 /*-------------------------------------------------------------------*/
 Vector2D
 FormationDT::getPosition( const int num,
@@ -67,10 +96,8 @@ FormationDT::getPosition( const int num,
         return Vector2D::INVALIDATED;
     }
 
-    const DelaunayTriangulation::Triangle * tri = M_triangulation.findTriangleContains( focus_point );
-
-    // linear interpolation
-    return interpolate( num, focus_point, tri );
+    // point location + affine combination of the compiled table
+    return M_table.getPosition( num, focus_point );
 }
 
 /*-------------------------------------------------------------------*/
@@ -78,123 +105,49 @@ void
 FormationDT::getPositions( const Vector2D & focus_point,
                            std::vector< Vector2D > & positions ) const
 {
-    positions.clear();
-
-    const DelaunayTriangulation::Triangle * tri = M_triangulation.findTriangleContains( focus_point );
-
-    for ( int num = 1; num <= 11; ++num )
-    {
-        positions.push_back( interpolate( num, focus_point, tri ) );
-    }
+    M_table.getPositions( focus_point, positions );
 }
 
 /*-------------------------------------------------------------------*/
-Vector2D
-FormationDT::interpolate( const int num,
-                          const Vector2D & focus_point,
-                          const DelaunayTriangulation::Triangle * tri ) const
+bool
+FormationDT::train( const FormationData & data )
 {
+    M_points.clear();
 
-    if ( ! tri )
-    {
-        const DelaunayTriangulation::Vertex * v = M_triangulation.findNearestVertex( focus_point );
-
-        if ( ! v )
-        {
-            std::cerr << "(FormationDT::interpolate) ERROR: No vertex." << std::endl;
-            return Vector2D::INVALIDATED;
-        }
-
-        try
-        {
-            //std::cerr << "found nearest vertex id= " << v->id() << std::endl;
-            return M_points.at( v->id() ).getPosition( num );
-        }
-        catch ( std::exception & e )
-        {
-            std::cerr << "(FormationDT::getPosition) exception " << e.what() << std::endl;
-            return Vector2D::INVALIDATED;
-        }
-    }
-
-    Vector2D result_0;
-    Vector2D result_1;
-    Vector2D result_2;
-    try
-    {
-        result_0 = M_points.at( tri->vertex( 0 )->id() ).getPosition( num );
-        result_1 = M_points.at( tri->vertex( 1 )->id() ).getPosition( num );
-        result_2 = M_points.at( tri->vertex( 2 )->id() ).getPosition( num );
-    }
-    catch ( std::exception & e )
+    for ( const FormationData::Data & d : data.dataCont() )
     {
-        std::cerr << "(FormationDT::getPosition) Exception " << e.what() << std::endl;
-        return  Vector2D::INVALIDATED;
+        M_points.push_back( d );
     }
 
-    Line2D line_0( tri->vertex( 0 )->pos(),
-                   focus_point );
-
-    Segment2D segment_12( tri->vertex( 1 )->pos(),
-                          tri->vertex( 2 )->pos() );
+    computeTriangulation();
 
-    Vector2D intersection_12 = segment_12.intersection( line_0 );
-
-    if ( ! intersection_12.isValid() )
+    if ( M_points.empty() )
     {
-        if ( focus_point.dist2( tri->vertex( 0 )->pos() ) < 1.0e-5 )
-        {
-            return result_0;
-        }
-
-        std::cerr << "(FormationDT::getPosition) ERROR: No intersection!\n"
-                  << " focus=" << focus_point << " line_intersection=" << intersection_12
-                  << "\n v0=" << tri->vertex( 0 )->pos()
-                  << " v1=" << tri->vertex( 1 )->pos()
-                  << " v2=" << tri->vertex( 2 )->pos()
-                  << std::endl;
-
-        return ( result_0 + result_1 + result_2 ) / 3.0;
+        M_table.clear();
+        return true;
     }
 
-    // distance from vertex_? to interxection_12
-    double dist_1i = tri->vertex( 1 )->pos().dist( intersection_12 );
-    double dist_2i = tri->vertex( 2 )->pos().dist( intersection_12 );
-
-    // interpolation result of vertex_1 & vertex_2
-    Vector2D result_12
-        = result_1
-        + ( result_2 - result_1 ) * ( dist_1i / ( dist_1i + dist_2i ) );
-
-    // distance from vertex_0 to ball
-    double dist_0b = tri->vertex( 0 )->pos().dist( focus_point );
-    // distance from interxectin_12 to ball
-    double dist_ib = intersection_12.dist( focus_point );
-
-    // interpolation result of vertex_0 & intersection_12
-    Vector2D result_012
-        = result_0
-        + ( result_12 - result_0 ) * ( dist_0b / ( dist_0b + dist_ib ) );
-
-    return result_012;
+    return M_table.build( M_triangulation, M_points );
 }
 
 /*-------------------------------------------------------------------*/
 bool
-FormationDT::train( const FormationData & data )
+FormationDT::setCompiledData( const std::vector< FormationData::Data > & points,
+                              const FormationDTTable & table )
 {
-    Rect2D pitch( Vector2D( -60.0, -45.0 ),
-                  Size2D( 120.0, 90.0 ) );
-    M_triangulation.init( pitch );
-    M_points.clear();
-
-    for ( const FormationData::Data & d : data.dataCont() )
+    if ( points.empty()
+         || table.vertexSize() > points.size() )
     {
-        M_triangulation.addVertex( d.ball_ );
-        M_points.push_back( d );
+        std::cerr << "(FormationDT::setCompiledData) ERROR: illegal table. points="
+                  << points.size() << " vertices=" << table.vertexSize() << std::endl;
+        return false;
     }
 
-    M_triangulation.compute();
+    M_points = points;
+    M_table = table;
+
+    M_triangulation.clear();
+    M_triangulation_valid = false;
     return true;
 }
 
@@ -33,6 +33,7 @@
 #define RCSC_FORMATION_FORMATION_DT_H
 
 #include <rcsc/formation/formation.h>
+#include <rcsc/formation/formation_dt_table.h>
 #include <rcsc/geom/delaunay_triangulation.h>
 #include <iostream>
 
@@ -52,8 +53,13 @@ private:
     //! desired positins used by delaunay triangulation & linear interpolation
     std::vector< FormationData::Data > M_points;
 
-    //! delaunay triangulation
-    DelaunayTriangulation M_triangulation;
+    //! delaunay triangulation. rebuilt on demand if the model is restored from the compiled table.
+    mutable DelaunayTriangulation M_triangulation;
+    //! true if M_triangulation is consistent with M_points
+    mutable bool M_triangulation_valid;
+
+    //! compiled interpolation table used by getPosition()
+    FormationDTTable M_table;
 
 public:
 
@@ -85,11 +91,26 @@ public:
       \brief get the delaunay triangulation
       \return const reference to the triangulation instance
     */
-    const DelaunayTriangulation & triangulation() const
+    const DelaunayTriangulation & triangulation() const;
+
+    /*!
+      \brief get the compiled interpolation table
+      \return const reference to the table instance
+    */
+    const FormationDTTable & table() const
     {
-        return M_triangulation;
+        return M_table;
     }
 
+    /*!
+      \brief restore the model from the compiled table without the triangulation.
+      \param points sample data array
+      \param table compiled table built from the same sample data
+      \return true if success
+    */
+    bool setCompiledData( const std::vector< FormationData::Data > & points,
+                          const FormationDTTable & table );
+
     /*!
       \brief get the method name of the formation model
       \return name string
@@ -117,9 +138,7 @@ public:
 
 private:
 
-    Vector2D interpolate( const int num,
-                          const Vector2D & focus_point,
-                          const DelaunayTriangulation::Triangle * tri ) const;
+    void computeTriangulation() const;
 
 public:
 
@@ -0,0 +1,583 @@
+// -*-c++-*-
+
+/*!
+  \file formation_dt_table.cpp
+  \brief precomputed interpolation table for FormationDT Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "formation_dt_table.h"
+
+#include <rcsc/geom/delaunay_triangulation.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <cstring>
+#include <cmath>
+
+namespace rcsc {
+
+const std::size_t FormationDTTable::TRIANGLE_STRIDE;
+const std::size_t FormationDTTable::VERTEX_STRIDE;
+
+namespace {
+
+//! tolerance of the barycentric coordinates
+const double BARYCENTRIC_EPS = 1.0e-9;
+
+//! tolerance of the grid coordinates
+const double GRID_EPS = 1.0e-6;
+
+//! the triangle whose doubled area is smaller than this value is ignored.
+const double DEGENERATE_DET = 1.0e-10;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief compute the byte size of the memory block
+ */
+std::uint64_t
+block_size( const std::uint64_t vertex_size,
+            const std::uint64_t triangle_size,
+            const std::uint64_t cell_size,
+            const std::uint64_t item_size )
+{
+    return sizeof( FormationDTTable::Header )
+        + sizeof( double ) * ( vertex_size * ( 2 + FormationDTTable::VERTEX_STRIDE )
+                               + triangle_size * FormationDTTable::TRIANGLE_STRIDE )
+        + sizeof( std::uint32_t ) * ( cell_size + 1 + item_size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief compute the coefficients of one triangle
+  \param p vertex positions
+  \param samples sample data of the vertices
+  \param coef the array of TRIANGLE_STRIDE elements
+  \return false if the triangle is degenerate
+ */
+bool
+compute_coefficients( const Vector2D * p,
+                      const FormationData::Data * const * samples,
+                      double * coef )
+{
+    const Vector2D e1 = p[1] - p[0];
+    const Vector2D e2 = p[2] - p[0];
+    const double det = e1.x * e2.y - e1.y * e2.x;
+
+    if ( std::fabs( det ) <= DEGENERATE_DET )
+    {
+        return false;
+    }
+
+    // barycentric coordinates of the vertex 1 and 2:
+    //   l1 = b[0] * x + b[1] * y + b[2]
+    //   l2 = b[3] * x + b[4] * y + b[5]
+    //   l0 = 1 - l1 - l2
+    double * b = coef;
+    b[0] = e2.y / det;
+    b[1] = -e2.x / det;
+    b[2] = -( e2.y * p[0].x - e2.x * p[0].y ) / det;
+    b[3] = -e1.y / det;
+    b[4] = e1.x / det;
+    b[5] = -( e1.x * p[0].y - e1.y * p[0].x ) / det;
+
+    // r = r0 + (r1 - r0) * l1 + (r2 - r0) * l2
+    double * c = coef + 6;
+    for ( std::size_t i = 0; i < 11; ++i, c += 6 )
+    {
+        const Vector2D & r0 = samples[0]->players_[i];
+        const Vector2D d1 = samples[1]->players_[i] - r0;
+        const Vector2D d2 = samples[2]->players_[i] - r0;
+
+        c[0] = d1.x * b[0] + d2.x * b[3];
+        c[1] = d1.x * b[1] + d2.x * b[4];
+        c[2] = r0.x + d1.x * b[2] + d2.x * b[5];
+        c[3] = d1.y * b[0] + d2.y * b[3];
+        c[4] = d1.y * b[1] + d2.y * b[4];
+        c[5] = r0.y + d1.y * b[2] + d2.y * b[5];
+    }
+
+    return true;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+FormationDTTable::FormationDTTable()
+{
+    clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FormationDTTable::clear()
+{
+    M_storage.reset();
+    M_data = nullptr;
+    M_size = 0;
+
+    M_header = nullptr;
+    M_vertices = nullptr;
+    M_vertex_players = nullptr;
+    M_triangles = nullptr;
+    M_grid_start = nullptr;
+    M_grid_items = nullptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+FormationDTTable::build( const DelaunayTriangulation & triangulation,
+                         const std::vector< FormationData::Data > & samples )
+{
+    clear();
+
+    const DelaunayTriangulation::VertexCont & vertex_cont = triangulation.vertices();
+    const std::size_t vertex_size = vertex_cont.size();
+
+    std::vector< double > vertices;
+    std::vector< double > vertex_players;
+    vertices.reserve( vertex_size * 2 );
+    vertex_players.reserve( vertex_size * VERTEX_STRIDE );
+
+    for ( const DelaunayTriangulation::Vertex & v : vertex_cont )
+    {
+        if ( v.id() < 0
+             || static_cast< std::size_t >( v.id() ) >= samples.size()
+             || samples[v.id()].players_.size() != 11 )
+        {
+            std::cerr << "(FormationDTTable::build) ERROR: illegal sample for the vertex "
+                      << v.id() << std::endl;
+            return false;
+        }
+
+        vertices.push_back( v.pos().x );
+        vertices.push_back( v.pos().y );
+        for ( const Vector2D & p : samples[v.id()].players_ )
+        {
+            vertex_players.push_back( p.x );
+            vertex_players.push_back( p.y );
+        }
+    }
+
+    //
+    // triangles. sorted by id to make the table deterministic.
+    //
+    std::vector< const DelaunayTriangulation::Triangle * > triangle_cont;
+    triangle_cont.reserve( triangulation.triangles().size() );
+    for ( const DelaunayTriangulation::TriangleCont::value_type & t : triangulation.triangles() )
+    {
+        triangle_cont.push_back( t.second );
+    }
+    std::sort( triangle_cont.begin(), triangle_cont.end(),
+               []( const DelaunayTriangulation::Triangle * lhs,
+                   const DelaunayTriangulation::Triangle * rhs )
+               {
+                   return lhs->id() < rhs->id();
+               } );
+
+    std::vector< double > triangles;
+    std::vector< Vector2D > triangle_min;
+    std::vector< Vector2D > triangle_max;
+    triangles.reserve( triangle_cont.size() * TRIANGLE_STRIDE );
+
+    for ( const DelaunayTriangulation::Triangle * t : triangle_cont )
+    {
+        Vector2D p[3];
+        const FormationData::Data * s[3];
+        bool valid = true;
+        for ( int i = 0; i < 3; ++i )
+        {
+            const int id = t->vertex( i )->id();
+            if ( id < 0 || static_cast< std::size_t >( id ) >= vertex_size )
+            {
+                valid = false;
+                break;
+            }
+            p[i] = t->vertex( i )->pos();
+            s[i] = &samples[id];
+        }
+
+        if ( ! valid )
+        {
+            continue;
+        }
+
+        double coef[TRIANGLE_STRIDE];
+        if ( ! compute_coefficients( p, s, coef ) )
+        {
+            continue;
+        }
+
+        triangles.insert( triangles.end(), coef, coef + TRIANGLE_STRIDE );
+        triangle_min.emplace_back( std::min( { p[0].x, p[1].x, p[2].x } ),
+                                   std::min( { p[0].y, p[1].y, p[2].y } ) );
+        triangle_max.emplace_back( std::max( { p[0].x, p[1].x, p[2].x } ),
+                                   std::max( { p[0].y, p[1].y, p[2].y } ) );
+    }
+
+    const std::size_t triangle_size = triangle_min.size();
+
+    //
+    // uniform grid for the point location
+    //
+    Header header;
+    std::memset( &header, 0, sizeof( header ) );
+    header.vertex_size_ = static_cast< std::uint32_t >( vertex_size );
+    header.triangle_size_ = static_cast< std::uint32_t >( triangle_size );
+
+    std::vector< std::uint32_t > grid_start( 1, 0 );
+    std::vector< std::uint32_t > grid_items;
+
+    if ( triangle_size > 0 )
+    {
+        Vector2D min_pos = triangle_min.front();
+        Vector2D max_pos = triangle_max.front();
+        for ( std::size_t i = 1; i < triangle_size; ++i )
+        {
+            min_pos.x = std::min( min_pos.x, triangle_min[i].x );
+            min_pos.y = std::min( min_pos.y, triangle_min[i].y );
+            max_pos.x = std::max( max_pos.x, triangle_max[i].x );
+            max_pos.y = std::max( max_pos.y, triangle_max[i].y );
+        }
+
+        const std::uint32_t n = static_cast< std::uint32_t >( std::ceil( std::sqrt( static_cast< double >( triangle_size ) ) ) );
+        const std::uint32_t cols = std::max( 1u, n );
+        const std::uint32_t rows = std::max( 1u, n );
+
+        header.grid_cols_ = cols;
+        header.grid_rows_ = rows;
+        header.grid_left_ = min_pos.x;
+        header.grid_top_ = min_pos.y;
+        header.grid_inv_width_ = ( max_pos.x > min_pos.x
+                                   ? cols / ( max_pos.x - min_pos.x )
+                                   : 1.0 );
+        header.grid_inv_height_ = ( max_pos.y > min_pos.y
+                                    ? rows / ( max_pos.y - min_pos.y )
+                                    : 1.0 );
+
+        std::vector< std::vector< std::uint32_t > > cells( cols * rows );
+
+        const auto to_col = [&]( const double x )
+            {
+                const double g = ( x - header.grid_left_ ) * header.grid_inv_width_;
+                return std::min( cols - 1, static_cast< std::uint32_t >( std::max( 0.0, g ) ) );
+            };
+        const auto to_row = [&]( const double y )
+            {
+                const double g = ( y - header.grid_top_ ) * header.grid_inv_height_;
+                return std::min( rows - 1, static_cast< std::uint32_t >( std::max( 0.0, g ) ) );
+            };
+
+        for ( std::size_t i = 0; i < triangle_size; ++i )
+        {
+            const std::uint32_t col_min = to_col( triangle_min[i].x - 1.0e-9 );
+            const std::uint32_t col_max = to_col( triangle_max[i].x + 1.0e-9 );
+            const std::uint32_t row_min = to_row( triangle_min[i].y - 1.0e-9 );
+            const std::uint32_t row_max = to_row( triangle_max[i].y + 1.0e-9 );
+
+            for ( std::uint32_t r = row_min; r <= row_max; ++r )
+            {
+                for ( std::uint32_t c = col_min; c <= col_max; ++c )
+                {
+                    cells[r * cols + c].push_back( static_cast< std::uint32_t >( i ) );
+                }
+            }
+        }
+
+        grid_start.reserve( cells.size() + 1 );
+        for ( const std::vector< std::uint32_t > & c : cells )
+        {
+            grid_items.insert( grid_items.end(), c.begin(), c.end() );
+            grid_start.push_back( static_cast< std::uint32_t >( grid_items.size() ) );
+        }
+
+        header.grid_item_size_ = static_cast< std::uint32_t >( grid_items.size() );
+    }
+
+    //
+    // pack all data into one block
+    //
+    const std::size_t size = block_size( vertex_size, triangle_size,
+                                         grid_start.size() - 1, grid_items.size() );
+    std::shared_ptr< std::vector< double > > storage
+        = std::make_shared< std::vector< double > >( ( size + sizeof( double ) - 1 ) / sizeof( double ) );
+
+    char * ptr = reinterpret_cast< char * >( storage->data() );
+    const auto write = [&ptr]( const void * src, const std::size_t bytes )
+        {
+            if ( bytes > 0 )
+            {
+                std::memcpy( ptr, src, bytes );
+                ptr += bytes;
+            }
+        };
+
+    write( &header, sizeof( header ) );
+    write( vertices.data(), sizeof( double ) * vertices.size() );
+    write( vertex_players.data(), sizeof( double ) * vertex_players.size() );
+    write( triangles.data(), sizeof( double ) * triangles.size() );
+    write( grid_start.data(), sizeof( std::uint32_t ) * grid_start.size() );
+    write( grid_items.data(), sizeof( std::uint32_t ) * grid_items.size() );
+
+    return assign( storage, reinterpret_cast< const char * >( storage->data() ), size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+FormationDTTable::assign( const std::shared_ptr< const void > & storage,
+                          const char * data,
+                          const std::size_t size )
+{
+    clear();
+
+    if ( ! data
+         || size < sizeof( Header )
+         || reinterpret_cast< std::uintptr_t >( data ) % alignof( double ) != 0 )
+    {
+        std::cerr << "(FormationDTTable::assign) ERROR: illegal memory block" << std::endl;
+        return false;
+    }
+
+    const Header * header = reinterpret_cast< const Header * >( data );
+    const std::uint64_t cell_size = static_cast< std::uint64_t >( header->grid_cols_ ) * header->grid_rows_;
+
+    if ( ( header->triangle_size_ == 0 ) != ( cell_size == 0 )
+         || size != block_size( header->vertex_size_, header->triangle_size_,
+                                cell_size, header->grid_item_size_ ) )
+    {
+        std::cerr << "(FormationDTTable::assign) ERROR: inconsistent block size" << std::endl;
+        return false;
+    }
+
+    M_storage = storage;
+    M_data = data;
+    M_size = size;
+    setPointers();
+
+    // validate the grid not to access out of the block
+    bool valid = ( M_grid_start[0] == 0
+                   && M_grid_start[cell_size] == header->grid_item_size_ );
+    for ( std::uint64_t i = 0; valid && i < cell_size; ++i )
+    {
+        valid = ( M_grid_start[i] <= M_grid_start[i + 1] );
+    }
+    for ( std::uint32_t i = 0; valid && i < header->grid_item_size_; ++i )
+    {
+        valid = ( M_grid_items[i] < header->triangle_size_ );
+    }
+
+    if ( ! valid )
+    {
+        std::cerr << "(FormationDTTable::assign) ERROR: broken grid" << std::endl;
+        clear();
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FormationDTTable::setPointers()
+{
+    M_header = reinterpret_cast< const Header * >( M_data );
+
+    const double * d = reinterpret_cast< const double * >( M_data + sizeof( Header ) );
+    M_vertices = d;
+    d += 2 * M_header->vertex_size_;
+    M_vertex_players = d;
+    d += VERTEX_STRIDE * M_header->vertex_size_;
+    M_triangles = d;
+    d += TRIANGLE_STRIDE * M_header->triangle_size_;
+
+    M_grid_start = reinterpret_cast< const std::uint32_t * >( d );
+    M_grid_items = M_grid_start + static_cast< std::size_t >( M_header->grid_cols_ ) * M_header->grid_rows_ + 1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+FormationDTTable::findTriangle( const Vector2D & point ) const
+{
+    if ( ! M_header
+         || M_header->triangle_size_ == 0 )
+    {
+        return -1;
+    }
+
+    const double gx = ( point.x - M_header->grid_left_ ) * M_header->grid_inv_width_;
+    const double gy = ( point.y - M_header->grid_top_ ) * M_header->grid_inv_height_;
+
+    // the negated form also rejects NaN
+    if ( ! ( -GRID_EPS <= gx && gx <= M_header->grid_cols_ + GRID_EPS )
+         || ! ( -GRID_EPS <= gy && gy <= M_header->grid_rows_ + GRID_EPS ) )
+    {
+        return -1;
+    }
+
+    const std::uint32_t col = std::min( M_header->grid_cols_ - 1,
+                                        static_cast< std::uint32_t >( std::max( 0.0, gx ) ) );
+    const std::uint32_t row = std::min( M_header->grid_rows_ - 1,
+                                        static_cast< std::uint32_t >( std::max( 0.0, gy ) ) );
+    const std::size_t cell = static_cast< std::size_t >( row ) * M_header->grid_cols_ + col;
+
+    for ( std::uint32_t i = M_grid_start[cell], end = M_grid_start[cell + 1]; i < end; ++i )
+    {
+        const double * b = M_triangles + TRIANGLE_STRIDE * M_grid_items[i];
+        const double l1 = b[0] * point.x + b[1] * point.y + b[2];
+        const double l2 = b[3] * point.x + b[4] * point.y + b[5];
+
+        if ( l1 >= -BARYCENTRIC_EPS
+             && l2 >= -BARYCENTRIC_EPS
+             && 1.0 - l1 - l2 >= -BARYCENTRIC_EPS )
+        {
+            return static_cast< int >( M_grid_items[i] );
+        }
+    }
+
+    return -1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+FormationDTTable::findNearestVertex( const Vector2D & point ) const
+{
+    int result = -1;
+    double min_dist2 = std::numeric_limits< double >::max();
+
+    const std::size_t size = vertexSize();
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        const double dx = M_vertices[2 * i] - point.x;
+        const double dy = M_vertices[2 * i + 1] - point.y;
+        const double d2 = dx * dx + dy * dy;
+        if ( d2 < min_dist2 )
+        {
+            result = static_cast< int >( i );
+            min_dist2 = d2;
+        }
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Vector2D
+FormationDTTable::getPosition( const int num,
+                               const Vector2D & focus_point ) const
+{
+    if ( num < 1 || 11 < num )
+    {
+        std::cerr << "(FormationDTTable::getPosition) ERROR: invalid number " << num << std::endl;
+        return Vector2D::INVALIDATED;
+    }
+
+    const int tri = findTriangle( focus_point );
+    if ( tri >= 0 )
+    {
+        const double * c = M_triangles + TRIANGLE_STRIDE * tri + 6 + 6 * ( num - 1 );
+        return Vector2D( c[0] * focus_point.x + c[1] * focus_point.y + c[2],
+                         c[3] * focus_point.x + c[4] * focus_point.y + c[5] );
+    }
+
+    const int v = findNearestVertex( focus_point );
+    if ( v < 0 )
+    {
+        std::cerr << "(FormationDTTable::getPosition) ERROR: No vertex." << std::endl;
+        return Vector2D::INVALIDATED;
+    }
+
+    const double * p = M_vertex_players + VERTEX_STRIDE * v + 2 * ( num - 1 );
+    return Vector2D( p[0], p[1] );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FormationDTTable::getPositions( const Vector2D & focus_point,
+                                std::vector< Vector2D > & positions ) const
+{
+    positions.clear();
+    positions.reserve( 11 );
+
+    const int tri = findTriangle( focus_point );
+    if ( tri >= 0 )
+    {
+        const double * c = M_triangles + TRIANGLE_STRIDE * tri + 6;
+        for ( int i = 0; i < 11; ++i, c += 6 )
+        {
+            positions.emplace_back( c[0] * focus_point.x + c[1] * focus_point.y + c[2],
+                                    c[3] * focus_point.x + c[4] * focus_point.y + c[5] );
+        }
+        return;
+    }
+
+    const int v = findNearestVertex( focus_point );
+    if ( v < 0 )
+    {
+        std::cerr << "(FormationDTTable::getPositions) ERROR: No vertex." << std::endl;
+        positions.assign( 11, Vector2D::INVALIDATED );
+        return;
+    }
+
+    const double * p = M_vertex_players + VERTEX_STRIDE * v;
+    for ( int i = 0; i < 11; ++i, p += 2 )
+    {
+        positions.emplace_back( p[0], p[1] );
+    }
+}
+
+}
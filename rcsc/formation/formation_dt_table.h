@@ -0,0 +1,219 @@
+// -*-c++-*-
+
+/*!
+  \file formation_dt_table.h
+  \brief precomputed interpolation table for FormationDT Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_FORMATION_FORMATION_DT_TABLE_H
+#define RCSC_FORMATION_FORMATION_DT_TABLE_H
+
+#include <rcsc/formation/formation_data.h>
+#include <rcsc/geom/vector_2d.h>
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace rcsc {
+
+class DelaunayTriangulation;
+
+/*!
+  \class FormationDTTable
+  \brief compiled form of the piecewise linear interpolation of FormationDT.
+
+  The linear interpolation in a triangle is an affine map of the focus
+  point, so the table stores for each triangle the barycentric
+  coefficients and, for each player, the 2x3 affine matrix that gives
+  the player position directly.  Triangles are located through a
+  uniform grid over the bounding box of the vertices.
+
+  All data are stored in one contiguous memory block that has the same
+  layout as the table section of the formation cache file.  The block is
+  either owned by this object or shared with a read-only memory mapped
+  file.
+ */
+class FormationDTTable {
+public:
+
+    /*!
+      \struct Header
+      \brief the first part of the memory block
+     */
+    struct Header {
+        std::uint32_t vertex_size_; //!< the number of vertices (= samples)
+        std::uint32_t triangle_size_; //!< the number of triangles
+        std::uint32_t grid_cols_; //!< the number of grid columns
+        std::uint32_t grid_rows_; //!< the number of grid rows
+        std::uint32_t grid_item_size_; //!< the total number of triangle indices in the grid
+        std::uint32_t reserved_; //!< padding
+        double grid_left_; //!< the minimum x of the grid region
+        double grid_top_; //!< the minimum y of the grid region
+        double grid_inv_width_; //!< the inverse of the cell width
+        double grid_inv_height_; //!< the inverse of the cell height
+    };
+
+    //! the number of doubles for one triangle: 6 barycentric coefficients + 11 * 6 affine coefficients
+    static const std::size_t TRIANGLE_STRIDE = 6 + 11 * 6;
+
+    //! the number of doubles for the player positions of one vertex
+    static const std::size_t VERTEX_STRIDE = 11 * 2;
+
+private:
+
+    //! owner of the memory block. owned vector or memory mapped file
+    std::shared_ptr< const void > M_storage;
+
+    const char * M_data; //!< top of the memory block
+    std::size_t M_size; //!< byte size of the memory block
+
+    const Header * M_header; //!< block header
+    const double * M_vertices; //!< vertex positions (x, y) * vertex_size
+    const double * M_vertex_players; //!< player positions for each vertex
+    const double * M_triangles; //!< coefficients for each triangle
+    const std::uint32_t * M_grid_start; //!< start index of each cell in M_grid_items. size = cols * rows + 1
+    const std::uint32_t * M_grid_items; //!< triangle indices registered to grid cells
+
+public:
+
+    /*!
+      \brief create an empty table
+     */
+    FormationDTTable();
+
+    /*!
+      \brief clear all data
+     */
+    void clear();
+
+    /*!
+      \brief build the table from the triangulation
+      \param triangulation computed triangulation. the vertex id is the index of samples.
+      \param samples sample data
+      \return true if success
+     */
+    bool build( const DelaunayTriangulation & triangulation,
+                const std::vector< FormationData::Data > & samples );
+
+    /*!
+      \brief set the memory block built by build()
+      \param storage owner of the memory block
+      \param data top of the memory block. must be aligned for double.
+      \param size byte size of the memory block
+      \return true if the block is consistent
+     */
+    bool assign( const std::shared_ptr< const void > & storage,
+                 const char * data,
+                 const std::size_t size );
+
+    /*!
+      \brief check if the table has no vertex
+      \return checked result
+     */
+    bool empty() const
+      {
+          return ! M_header || M_header->vertex_size_ == 0;
+      }
+
+    /*!
+      \brief get the top of the memory block
+      \return const pointer to the memory block
+     */
+    const char * data() const
+      {
+          return M_data;
+      }
+
+    /*!
+      \brief get the byte size of the memory block
+      \return byte size
+     */
+    std::size_t size() const
+      {
+          return M_size;
+      }
+
+    /*!
+      \brief get the number of vertices
+      \return the number of vertices
+     */
+    std::size_t vertexSize() const
+      {
+          return M_header ? M_header->vertex_size_ : 0;
+      }
+
+    /*!
+      \brief get the number of triangles
+      \return the number of triangles
+     */
+    std::size_t triangleSize() const
+      {
+          return M_header ? M_header->triangle_size_ : 0;
+      }
+
+    /*!
+      \brief find the triangle that contains the point
+      \param point target point
+      \return triangle index, or -1 if not found
+     */
+    int findTriangle( const Vector2D & point ) const;
+
+    /*!
+      \brief find the vertex nearest to the point
+      \param point target point
+      \return vertex index, or -1 if no vertex
+     */
+    int findNearestVertex( const Vector2D & point ) const;
+
+    /*!
+      \brief get the interpolated position
+      \param num player number [1..11]
+      \param focus_point focus point, usually ball position
+      \return interpolated position
+     */
+    Vector2D getPosition( const int num,
+                          const Vector2D & focus_point ) const;
+
+    /*!
+      \brief get all interpolated positions
+      \param focus_point focus point, usually ball position
+      \param positions container to store the result
+     */
+    void getPositions( const Vector2D & focus_point,
+                       std::vector< Vector2D > & positions ) const;
+
+private:
+
+    void setPointers();
+
+};
+
+}
+
+#endif
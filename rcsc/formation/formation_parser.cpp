@@ -35,7 +35,11 @@
 
 #include "formation_parser.h"
 
+#include "formation_cache.h"
+
 #include <fstream>
+#include <sstream>
+#include <iterator>
 #include <cstring>
 
 namespace rcsc {
@@ -53,8 +57,38 @@ FormationParser::parse( const std::string & filepath )
         return Formation::Ptr();
     }
 
-    std::ifstream fin( filepath );
-    return parser->parseImpl( fin );
+    if ( ! FormationCache::enabled() )
+    {
+        std::ifstream fin( filepath );
+        return parser->parseImpl( fin );
+    }
+
+    std::string content;
+    {
+        std::ifstream fin( filepath, std::ios::binary );
+        content.assign( std::istreambuf_iterator< char >( fin ),
+                        std::istreambuf_iterator< char >() );
+    }
+
+    const std::uint64_t hash = FormationCache::hash( content );
+    const std::string cache_path = FormationCache::cache_path( filepath );
+
+    Formation::Ptr ptr = FormationCache::load( cache_path, hash );
+    if ( ptr )
+    {
+        return ptr;
+    }
+
+    std::istringstream istr( content );
+    ptr = parser->parseImpl( istr );
+
+    if ( ptr )
+    {
+        // the failure is ignored. e.g. the directory is not writable.
+        FormationCache::save( cache_path, hash, *ptr );
+    }
+
+    return ptr;
 }
 
 /*-------------------------------------------------------------------*/
@@ -111,7 +111,10 @@ private:
 public:
 
     /*!
-      \brief parse the given file
+      \brief parse the given file.
+      If FormationCache is enabled, the compiled cache file next to the
+      given file is used when its hash value matches the file content.
+      Otherwise, the file is parsed and the cache file is written.
       \param filepath the file path to be parsed
       \return formation instance
      */
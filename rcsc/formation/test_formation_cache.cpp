@@ -0,0 +1,481 @@
+// -*-c++-*-
+
+/*!
+  \file test_formation_cache.cpp
+  \brief test code for rcsc::FormationDTTable and rcsc::FormationCache
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "formation_cache.h"
+#include "formation_dt.h"
+#include "formation_parser.h"
+
+#include <rcsc/geom/line_2d.h>
+#include <rcsc/geom/segment_2d.h>
+#include <rcsc/time/timer.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+using namespace rcsc;
+
+namespace {
+
+const std::string CONF_PATH = "test_formation_cache.conf";
+
+/*-------------------------------------------------------------------*/
+double
+round2( const double v )
+{
+    return std::round( v * 100.0 ) / 100.0;
+}
+
+/*-------------------------------------------------------------------*/
+void
+create_data( FormationData * data )
+{
+    std::mt19937 gen( 1 );
+    std::uniform_real_distribution<> jitter( -2.0, 2.0 );
+
+    for ( int ix = 0; ix < 11; ++ix )
+    {
+        for ( int iy = 0; iy < 9; ++iy )
+        {
+            FormationData::Data d;
+            d.ball_.assign( round2( -52.5 + 10.5 * ix + ( ix % 10 != 0 ? jitter( gen ) : 0.0 ) ),
+                            round2( -34.0 + 8.5 * iy + ( iy % 8 != 0 ? jitter( gen ) : 0.0 ) ) );
+            for ( int i = 0; i < 11; ++i )
+            {
+                const double base_x = -45.0 + 9.0 * i;
+                const double base_y = -30.0 + 6.0 * i;
+                d.players_.emplace_back( round2( base_x * 0.6 + d.ball_.x * 0.4 + 2.0 * std::sin( d.ball_.y * 0.1 + i ) ),
+                                         round2( base_y * 0.7 + d.ball_.y * 0.3 + 2.0 * std::cos( d.ball_.x * 0.1 - i ) ) );
+            }
+            data->addData( d );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+Formation::Ptr
+create_formation()
+{
+    Formation::Ptr ptr = Formation::create( FormationDT::NAME );
+    ptr->setVersion( "test" );
+    ptr->setRole( 1, "Goalie", RoleType( RoleType::Goalie, RoleType::Center ), 0 );
+    ptr->setRole( 2, "CenterBack", RoleType( RoleType::Defender, RoleType::Left ), -1 );
+    ptr->setRole( 3, "CenterBack", RoleType( RoleType::Defender, RoleType::Right ), 2 );
+    ptr->setRole( 4, "SideBack", RoleType( RoleType::Defender, RoleType::Left ), -1 );
+    ptr->setRole( 5, "SideBack", RoleType( RoleType::Defender, RoleType::Right ), 4 );
+    ptr->setRole( 6, "DefensiveHalf", RoleType( RoleType::MidFielder, RoleType::Center ), 0 );
+    ptr->setRole( 7, "OffensiveHalf", RoleType( RoleType::MidFielder, RoleType::Left ), -1 );
+    ptr->setRole( 8, "OffensiveHalf", RoleType( RoleType::MidFielder, RoleType::Right ), 7 );
+    ptr->setRole( 9, "SideForward", RoleType( RoleType::Forward, RoleType::Left ), -1 );
+    ptr->setRole( 10, "SideForward", RoleType( RoleType::Forward, RoleType::Right ), 9 );
+    ptr->setRole( 11, "CenterForward", RoleType( RoleType::Forward, RoleType::Center ), 0 );
+    FormationData data;
+    create_data( &data );
+    ptr->train( data );
+    return ptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief the interpolation by the line/segment intersection on the triangulation
+ */
+Vector2D
+reference_position( const FormationDT & f,
+                    const int num,
+                    const Vector2D & focus_point )
+{
+    const DelaunayTriangulation & t = f.triangulation();
+    const DelaunayTriangulation::Triangle * tri = t.findTriangleContains( focus_point );
+
+    if ( ! tri )
+    {
+        return f.points().at( t.findNearestVertex( focus_point )->id() ).getPosition( num );
+    }
+
+    const Vector2D result_0 = f.points().at( tri->vertex( 0 )->id() ).getPosition( num );
+    const Vector2D result_1 = f.points().at( tri->vertex( 1 )->id() ).getPosition( num );
+    const Vector2D result_2 = f.points().at( tri->vertex( 2 )->id() ).getPosition( num );
+
+    const Line2D line_0( tri->vertex( 0 )->pos(), focus_point );
+    const Segment2D segment_12( tri->vertex( 1 )->pos(), tri->vertex( 2 )->pos() );
+    const Vector2D intersection_12 = segment_12.intersection( line_0 );
+
+    if ( ! intersection_12.isValid() )
+    {
+        return result_0;
+    }
+
+    const double dist_1i = tri->vertex( 1 )->pos().dist( intersection_12 );
+    const double dist_2i = tri->vertex( 2 )->pos().dist( intersection_12 );
+    const Vector2D result_12 = result_1 + ( result_2 - result_1 ) * ( dist_1i / ( dist_1i + dist_2i ) );
+
+    const double dist_0b = tri->vertex( 0 )->pos().dist( focus_point );
+    const double dist_ib = intersection_12.dist( focus_point );
+
+    return result_0 + ( result_12 - result_0 ) * ( dist_0b / ( dist_0b + dist_ib ) );
+}
+
+/*-------------------------------------------------------------------*/
+std::vector< Vector2D >
+create_focus_points( const int size )
+{
+    std::mt19937 gen( 2 );
+    std::uniform_real_distribution<> x( -60.0, 60.0 );
+    std::uniform_real_distribution<> y( -42.0, 42.0 );
+
+    std::vector< Vector2D > result;
+    for ( int i = 0; i < size; ++i )
+    {
+        const double px = x( gen );
+        const double py = y( gen );
+        result.emplace_back( px, py );
+    }
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+void
+check_same_positions( const Formation & lhs,
+                      const Formation & rhs )
+{
+    std::vector< Vector2D > lhs_positions, rhs_positions;
+    for ( const Vector2D & p : create_focus_points( 2000 ) )
+    {
+        lhs.getPositions( p, lhs_positions );
+        rhs.getPositions( p, rhs_positions );
+        CPPUNIT_ASSERT_EQUAL( lhs_positions.size(), rhs_positions.size() );
+        for ( size_t i = 0; i < lhs_positions.size(); ++i )
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( lhs_positions[i].x, rhs_positions[i].x, 1.0e-9 );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( lhs_positions[i].y, rhs_positions[i].y, 1.0e-9 );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+std::string
+read_file( const std::string & filepath )
+{
+    std::ifstream fin( filepath, std::ios::binary );
+    return std::string( std::istreambuf_iterator< char >( fin ),
+                        std::istreambuf_iterator< char >() );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+
+class FormationCacheTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( FormationCacheTest );
+    CPPUNIT_TEST( testTable );
+    CPPUNIT_TEST( testCache );
+    CPPUNIT_TEST( testBrokenSampleSize );
+    CPPUNIT_TEST( testBenchmark );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testTable();
+    void testCache();
+    void testBrokenSampleSize();
+    void testBenchmark();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( FormationCacheTest );
+
+/*-------------------------------------------------------------------*/
+void
+FormationCacheTest::setUp()
+{
+    Formation::Ptr f = create_formation();
+    std::ofstream fout( CONF_PATH );
+    f->print( fout );
+}
+
+/*-------------------------------------------------------------------*/
+void
+FormationCacheTest::tearDown()
+{
+    FormationCache::set_enabled( true );
+    std::remove( CONF_PATH.c_str() );
+    std::remove( FormationCache::cache_path( CONF_PATH ).c_str() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+FormationCacheTest::testTable()
+{
+    Formation::Ptr ptr = create_formation();
+    const FormationDT & f = dynamic_cast< const FormationDT & >( *ptr );
+
+    CPPUNIT_ASSERT_EQUAL( f.points().size(), f.table().vertexSize() );
+    CPPUNIT_ASSERT( f.table().triangleSize() > 0 );
+
+    std::vector< Vector2D > positions;
+    for ( const Vector2D & p : create_focus_points( 2000 ) )
+    {
+        f.getPositions( p, positions );
+        CPPUNIT_ASSERT_EQUAL( size_t( 11 ), positions.size() );
+        for ( int num = 1; num <= 11; ++num )
+        {
+            const Vector2D ref = reference_position( f, num, p );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( ref.x, positions[num - 1].x, 1.0e-6 );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( ref.y, positions[num - 1].y, 1.0e-6 );
+            CPPUNIT_ASSERT( positions[num - 1].equalsWeakly( f.getPosition( num, p ) ) );
+        }
+    }
+
+    // the sample points are reproduced
+    for ( const FormationData::Data & d : f.points() )
+    {
+        f.getPositions( d.ball_, positions );
+        for ( int i = 0; i < 11; ++i )
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( d.players_[i].x, positions[i].x, 1.0e-6 );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( d.players_[i].y, positions[i].y, 1.0e-6 );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+FormationCacheTest::testCache()
+{
+    const std::string cache_path = FormationCache::cache_path( CONF_PATH );
+
+    FormationCache::set_enabled( false );
+    Formation::Ptr text = FormationParser::parse( CONF_PATH );
+    CPPUNIT_ASSERT( text );
+    CPPUNIT_ASSERT( ! std::ifstream( cache_path ) );
+
+    // the first parse writes the cache file
+    FormationCache::set_enabled( true );
+    Formation::Ptr first = FormationParser::parse( CONF_PATH );
+    CPPUNIT_ASSERT( first );
+    CPPUNIT_ASSERT( std::ifstream( cache_path ) );
+
+    std::string content = read_file( CONF_PATH );
+    Formation::Ptr cached = FormationCache::load( cache_path, FormationCache::hash( content ) );
+    CPPUNIT_ASSERT( cached );
+    CPPUNIT_ASSERT( ! FormationCache::load( cache_path, FormationCache::hash( content + ' ' ) ) );
+
+    CPPUNIT_ASSERT_EQUAL( text->methodName(), cached->methodName() );
+    CPPUNIT_ASSERT_EQUAL( text->version(), cached->version() );
+    for ( int num = 1; num <= 11; ++num )
+    {
+        CPPUNIT_ASSERT_EQUAL( text->roleName( num ), cached->roleName( num ) );
+        CPPUNIT_ASSERT_EQUAL( text->roleType( num ).type(), cached->roleType( num ).type() );
+        CPPUNIT_ASSERT_EQUAL( text->roleType( num ).side(), cached->roleType( num ).side() );
+        CPPUNIT_ASSERT_EQUAL( text->pairedNumber( num ), cached->pairedNumber( num ) );
+    }
+
+    check_same_positions( *text, *cached );
+    check_same_positions( *text, *FormationParser::parse( CONF_PATH ) );
+
+    // the triangulation is rebuilt on demand
+    const FormationDT & dt = dynamic_cast< const FormationDT & >( *cached );
+    CPPUNIT_ASSERT_EQUAL( dt.points().size(), dt.triangulation().vertices().size() );
+    CPPUNIT_ASSERT( ! dt.triangulation().triangles().empty() );
+
+    // the edit of the source file invalidates the cache
+    {
+        std::ofstream fout( CONF_PATH, std::ios::app );
+        fout << '\n';
+    }
+    Formation::Ptr edited = FormationParser::parse( CONF_PATH );
+    CPPUNIT_ASSERT( edited );
+    check_same_positions( *text, *edited );
+
+    content = read_file( CONF_PATH );
+    CPPUNIT_ASSERT( FormationCache::load( cache_path, FormationCache::hash( content ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+FormationCacheTest::testBrokenSampleSize()
+{
+    const std::string cache_path = FormationCache::cache_path( CONF_PATH );
+
+    CPPUNIT_ASSERT( FormationParser::parse( CONF_PATH ) );
+
+    const std::string content = read_file( CONF_PATH );
+    std::string cache = read_file( cache_path );
+    CPPUNIT_ASSERT( FormationCache::load( cache_path, FormationCache::hash( content ) ) );
+
+    // skip the file header, the method name, the version and the role data
+    std::size_t pos = 40;
+    for ( int i = 0; i < 2 + 11; ++i )
+    {
+        std::uint32_t len = 0;
+        std::memcpy( &len, cache.data() + pos, sizeof( len ) );
+        pos += sizeof( len ) + len;
+        if ( i >= 2 )
+        {
+            pos += 3 * sizeof( std::int32_t );
+        }
+    }
+
+    std::uint32_t sample_size = 0;
+    std::memcpy( &sample_size, cache.data() + pos, sizeof( sample_size ) );
+    CPPUNIT_ASSERT_EQUAL( create_formation()->toData()->dataCont().size(), std::size_t( sample_size ) );
+
+    // the broken sample size must be rejected without reserving the memory
+    sample_size = 0x7fffffff;
+    std::memcpy( &cache[pos], &sample_size, sizeof( sample_size ) );
+    {
+        std::ofstream fout( cache_path, std::ios::binary | std::ios::trunc );
+        fout.write( cache.data(), cache.size() );
+    }
+
+    CPPUNIT_ASSERT( ! FormationCache::load( cache_path, FormationCache::hash( content ) ) );
+
+    // the broken cache file is replaced by the next parse
+    CPPUNIT_ASSERT( FormationParser::parse( CONF_PATH ) );
+    CPPUNIT_ASSERT( FormationCache::load( cache_path, FormationCache::hash( content ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+FormationCacheTest::testBenchmark()
+{
+    const int max_loop = 20;
+    double total = 0.0;
+
+    {
+        FormationCache::set_enabled( false );
+        Timer timer;
+        for ( int i = 0; i < max_loop; ++i )
+        {
+            Formation::Ptr f = FormationParser::parse( CONF_PATH );
+            total += f->getPosition( 11, Vector2D( 0.0, 0.0 ) ).x;
+        }
+        std::cout << "\nFormationParser::parse (text) elapsed "
+                  << timer.elapsedReal() / max_loop << " [ms]" << std::endl;
+    }
+
+    {
+        FormationCache::set_enabled( true );
+        FormationParser::parse( CONF_PATH );
+        Timer timer;
+        for ( int i = 0; i < max_loop; ++i )
+        {
+            Formation::Ptr f = FormationParser::parse( CONF_PATH );
+            total -= f->getPosition( 11, Vector2D( 0.0, 0.0 ) ).x;
+        }
+        std::cout << "FormationParser::parse (cache) elapsed "
+                  << timer.elapsedReal() / max_loop << " [ms]" << std::endl;
+    }
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, total, 1.0e-6 );
+
+    Formation::Ptr ptr = create_formation();
+    const FormationDT & f = dynamic_cast< const FormationDT & >( *ptr );
+    const std::vector< Vector2D > focus_points = create_focus_points( 20000 );
+
+    {
+        Timer timer;
+        for ( const Vector2D & p : focus_points )
+        {
+            for ( int num = 1; num <= 11; ++num )
+            {
+                total += reference_position( f, num, p ).x;
+            }
+        }
+        std::cout << "line/segment interpolation elapsed "
+                  << timer.elapsedReal() << " [ms] for " << focus_points.size() << " points." << std::endl;
+    }
+
+    {
+        std::vector< Vector2D > positions;
+        Timer timer;
+        for ( const Vector2D & p : focus_points )
+        {
+            f.getPositions( p, positions );
+            for ( const Vector2D & pos : positions )
+            {
+                total -= pos.x;
+            }
+        }
+        std::cout << "FormationDT::getPositions elapsed "
+                  << timer.elapsedReal() << " [ms] for " << focus_points.size() << " points." << std::endl;
+    }
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, total, 1.0e-3 );
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,1139 @@
+// -*-c++-*-
+
+/*!
+  \file dynamic_voronoi_diagram.cpp
+  \brief incrementally updated 2D voronoi diagram Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "dynamic_voronoi_diagram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace rcsc {
+
+const double DynamicVoronoiDiagram::EPSILON = 1.0e-10;
+
+namespace {
+
+//! the size of the super triangle relative to the input region
+constexpr double SUPER_TRIANGLE_SCALE = 1000.0;
+
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief doubled signed area of the triangle (a, b, c)
+  \return positive value if (a, b, c) is counterclockwise
+ */
+inline
+double
+orient( const Vector2D & a,
+        const Vector2D & b,
+        const Vector2D & c )
+{
+    return ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief incircle test for the counterclockwise triangle (a, b, c)
+  \return positive value if d is inside the circumcircle
+ */
+inline
+double
+incircle( const Vector2D & a,
+          const Vector2D & b,
+          const Vector2D & c,
+          const Vector2D & d )
+{
+    const double adx = a.x - d.x, ady = a.y - d.y;
+    const double bdx = b.x - d.x, bdy = b.y - d.y;
+    const double cdx = c.x - d.x, cdy = c.y - d.y;
+
+    const double alift = adx * adx + ady * ady;
+    const double blift = bdx * bdx + bdy * bdy;
+    const double clift = cdx * cdx + cdy * cdy;
+
+    return ( alift * ( bdx * cdy - bdy * cdx )
+             + blift * ( cdx * ady - cdy * adx )
+             + clift * ( adx * bdy - ady * bdx ) );
+}
+
+inline
+int
+next3( const int i )
+{
+    return ( i + 1 ) % 3;
+}
+
+inline
+int
+prev3( const int i )
+{
+    return ( i + 2 ) % 3;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+DynamicVoronoiDiagram::DynamicVoronoiDiagram( const Rect2D & bounding_rect )
+    : M_bounding_rect( bounding_rect ),
+      M_last_triangle( -1 ),
+      M_flip_count( 0 ),
+      M_rebuild_count( 0 )
+{
+    clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+DynamicVoronoiDiagram::DynamicVoronoiDiagram( const Rect2D & bounding_rect,
+                                              const std::vector< Vector2D > & points )
+    : M_bounding_rect( bounding_rect ),
+      M_last_triangle( -1 ),
+      M_flip_count( 0 ),
+      M_rebuild_count( 0 )
+{
+    build( points );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::clear()
+{
+    M_points.resize( 3 );
+    M_vertex_triangle.resize( 3 );
+    createSuperTriangle();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::build( const std::vector< Vector2D > & points )
+{
+    M_points.resize( 3 );
+    M_points.insert( M_points.end(), points.begin(), points.end() );
+    M_vertex_triangle.resize( M_points.size() );
+
+    rebuild();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+DynamicVoronoiDiagram::addPoint( const Vector2D & p )
+{
+    const int v = static_cast< int >( M_points.size() );
+    M_points.push_back( p );
+    M_vertex_triangle.push_back( -1 );
+
+    if ( ! M_valid_area.contains( p ) )
+    {
+        rebuild();
+    }
+    else
+    {
+        insertVertex( v );
+    }
+
+    return v - 3;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DynamicVoronoiDiagram::movePoint( const int index,
+                                  const Vector2D & p )
+{
+    const int v = index + 3;
+
+    if ( ! M_valid_area.contains( p ) )
+    {
+        M_points[v] = p;
+        rebuild();
+        return false;
+    }
+
+    if ( canMoveInPlace( v, p ) )
+    {
+        moveInPlace( v, p );
+        return true;
+    }
+
+    //
+    // the new position is not visible from the current star polygon.
+    // the vertex is removed and inserted again.
+    //
+
+    if ( M_vertex_triangle[v] >= 0
+         && ! removeVertex( v ) )
+    {
+        M_points[v] = p;
+        rebuild();
+        return false;
+    }
+
+    M_points[v] = p;
+    insertVertex( v );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::moveInPlace( const int v,
+                                    const Vector2D & p )
+{
+    M_points[v] = p;
+
+    //
+    // all triangles around the moved vertex may violate the delaunay condition.
+    //
+
+    M_flip_stack.clear();
+
+    const int start = M_vertex_triangle[v];
+    int t = start;
+    do
+    {
+        const Triangle & tri = M_triangles[t];
+        const int i = ( tri.vertices_[0] == v ? 0
+                        : tri.vertices_[1] == v ? 1
+                        : 2 );
+        // the edge opposite to the moved vertex and the edge to the next triangle
+        M_flip_stack.emplace_back( t, i );
+        M_flip_stack.emplace_back( t, next3( i ) );
+        t = tri.neighbors_[next3( i )];
+    }
+    while ( t != start );
+
+    M_last_triangle = start;
+    flipEdges();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::update( const std::vector< Vector2D > & points )
+{
+    assert( points.size() == size() );
+
+    const int n = static_cast< int >( points.size() );
+    for ( int i = 0; i < n; ++i )
+    {
+        if ( M_points[i + 3] != points[i] )
+        {
+            movePoint( i, points[i] );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::rebuild()
+{
+    ++M_rebuild_count;
+
+    createSuperTriangle();
+
+    const int n = static_cast< int >( M_points.size() );
+    for ( int v = 3; v < n; ++v )
+    {
+        insertVertex( v );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::createSuperTriangle()
+{
+    double min_x = M_bounding_rect.left();
+    double max_x = M_bounding_rect.right();
+    double min_y = M_bounding_rect.top();
+    double max_y = M_bounding_rect.bottom();
+
+    const int n = static_cast< int >( M_points.size() );
+    for ( int v = 3; v < n; ++v )
+    {
+        min_x = std::min( min_x, M_points[v].x );
+        max_x = std::max( max_x, M_points[v].x );
+        min_y = std::min( min_y, M_points[v].y );
+        max_y = std::max( max_y, M_points[v].y );
+    }
+
+    const Vector2D center( ( min_x + max_x ) * 0.5, ( min_y + max_y ) * 0.5 );
+    const double size = std::max( max_x - min_x, max_y - min_y ) + 1.0;
+    const double s = size * SUPER_TRIANGLE_SCALE;
+
+    // points can move inside this area without rebuilding the super triangle.
+    M_valid_area = Rect2D::from_center( center, size * 4.0, size * 4.0 );
+
+    M_points[0].assign( center.x - 2.0 * s, center.y - s );
+    M_points[1].assign( center.x + 2.0 * s, center.y - s );
+    M_points[2].assign( center.x, center.y + 2.0 * s );
+
+    M_triangles.clear();
+    M_triangles.push_back( Triangle{ { 0, 1, 2 }, { -1, -1, -1 } } );
+    M_free_triangles.clear();
+
+    std::fill( M_vertex_triangle.begin(), M_vertex_triangle.end(), -1 );
+    M_vertex_triangle[0] = M_vertex_triangle[1] = M_vertex_triangle[2] = 0;
+
+    M_last_triangle = 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DynamicVoronoiDiagram::insertVertex( const int v )
+{
+    const Vector2D & p = M_points[v];
+
+    const int t = locate( p );
+    if ( t < 0 )
+    {
+        return false;
+    }
+
+    const Triangle & tri = M_triangles[t];
+
+    for ( int i = 0; i < 3; ++i )
+    {
+        if ( M_points[tri.vertices_[i]].dist2( p ) < EPSILON * EPSILON )
+        {
+            // duplicated point. this vertex does not have its own cell.
+            M_vertex_triangle[v] = -1;
+            return false;
+        }
+    }
+
+    M_flip_stack.clear();
+
+    int on_edge = -1;
+    for ( int i = 0; i < 3; ++i )
+    {
+        if ( std::fabs( orient( M_points[tri.vertices_[next3( i )]],
+                                M_points[tri.vertices_[prev3( i )]],
+                                p ) ) < EPSILON )
+        {
+            on_edge = i;
+            break;
+        }
+    }
+
+    if ( on_edge >= 0
+         && tri.neighbors_[on_edge] >= 0 )
+    {
+        splitEdge( t, on_edge, v );
+    }
+    else
+    {
+        splitTriangle( t, v );
+    }
+
+    flipEdges();
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+DynamicVoronoiDiagram::locate( const Vector2D & p ) const
+{
+    const int n_tri = static_cast< int >( M_triangles.size() );
+
+    int t = ( 0 <= M_last_triangle && M_last_triangle < n_tri
+              ? M_last_triangle
+              : 0 );
+
+    // visibility walk.  the walk always terminates on a delaunay triangulation.
+    for ( int loop = 0; loop < n_tri; ++loop )
+    {
+        const Triangle & tri = M_triangles[t];
+        int next = -1;
+        for ( int i = 0; i < 3; ++i )
+        {
+            if ( orient( M_points[tri.vertices_[next3( i )]],
+                         M_points[tri.vertices_[prev3( i )]],
+                         p ) < 0.0 )
+            {
+                next = tri.neighbors_[i];
+                break;
+            }
+        }
+
+        if ( next < 0 )
+        {
+            return t;
+        }
+        t = next;
+    }
+
+    // fall back to the linear search
+    for ( t = 0; t < n_tri; ++t )
+    {
+        const Triangle & tri = M_triangles[t];
+        if ( tri.vertices_[0] >= 0
+             && orient( M_points[tri.vertices_[0]], M_points[tri.vertices_[1]], p ) >= 0.0
+             && orient( M_points[tri.vertices_[1]], M_points[tri.vertices_[2]], p ) >= 0.0
+             && orient( M_points[tri.vertices_[2]], M_points[tri.vertices_[0]], p ) >= 0.0 )
+        {
+            return t;
+        }
+    }
+
+    return -1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::splitTriangle( const int t,
+                                      const int v )
+{
+    const Triangle old = M_triangles[t];
+    const int a = old.vertices_[0], b = old.vertices_[1], c = old.vertices_[2];
+    const int n0 = old.neighbors_[0], n1 = old.neighbors_[1], n2 = old.neighbors_[2];
+
+    const int ta = t;
+    const int tb = createTriangle();
+    const int tc = createTriangle();
+
+    M_triangles[ta] = Triangle{ { a, b, v }, { tb, tc, n2 } };
+    M_triangles[tb] = Triangle{ { b, c, v }, { tc, ta, n0 } };
+    M_triangles[tc] = Triangle{ { c, a, v }, { ta, tb, n1 } };
+
+    replaceNeighbor( n0, t, tb );
+    replaceNeighbor( n1, t, tc );
+
+    M_vertex_triangle[a] = ta;
+    M_vertex_triangle[b] = tb;
+    M_vertex_triangle[c] = tc;
+    M_vertex_triangle[v] = ta;
+
+    M_flip_stack.emplace_back( ta, 2 );
+    M_flip_stack.emplace_back( tb, 2 );
+    M_flip_stack.emplace_back( tc, 2 );
+
+    M_last_triangle = ta;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::splitEdge( const int t,
+                                  const int i,
+                                  const int v )
+{
+    const Triangle old_t = M_triangles[t];
+    const int u = old_t.neighbors_[i];
+    const Triangle old_u = M_triangles[u];
+
+    const int j = ( old_u.neighbors_[0] == t ? 0
+                    : old_u.neighbors_[1] == t ? 1
+                    : 2 );
+
+    // t = (c, a, b), u = (d, b, a)
+    const int c = old_t.vertices_[i];
+    const int a = old_t.vertices_[next3( i )];
+    const int b = old_t.vertices_[prev3( i )];
+    const int d = old_u.vertices_[j];
+
+    const int n_ca = old_t.neighbors_[prev3( i )];
+    const int n_bc = old_t.neighbors_[next3( i )];
+    const int n_ad = old_u.neighbors_[next3( j )];
+    const int n_db = old_u.neighbors_[prev3( j )];
+
+    const int t1 = t;
+    const int u1 = u;
+    const int t2 = createTriangle();
+    const int u2 = createTriangle();
+
+    M_triangles[t1] = Triangle{ { c, a, v }, { u2, t2, n_ca } };
+    M_triangles[u1] = Triangle{ { d, b, v }, { t2, u2, n_db } };
+    M_triangles[t2] = Triangle{ { c, v, b }, { u1, n_bc, t1 } };
+    M_triangles[u2] = Triangle{ { d, v, a }, { t1, n_ad, u1 } };
+
+    replaceNeighbor( n_bc, t, t2 );
+    replaceNeighbor( n_ad, u, u2 );
+
+    M_vertex_triangle[a] = t1;
+    M_vertex_triangle[b] = u1;
+    M_vertex_triangle[c] = t1;
+    M_vertex_triangle[d] = u1;
+    M_vertex_triangle[v] = t1;
+
+    M_flip_stack.emplace_back( t1, 2 );
+    M_flip_stack.emplace_back( t2, 1 );
+    M_flip_stack.emplace_back( u1, 2 );
+    M_flip_stack.emplace_back( u2, 1 );
+
+    M_last_triangle = t1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::replaceNeighbor( const int t,
+                                        const int old_neighbor,
+                                        const int new_neighbor )
+{
+    if ( t < 0 )
+    {
+        return;
+    }
+
+    for ( int & n : M_triangles[t].neighbors_ )
+    {
+        if ( n == old_neighbor )
+        {
+            n = new_neighbor;
+            return;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+DynamicVoronoiDiagram::createTriangle()
+{
+    if ( ! M_free_triangles.empty() )
+    {
+        const int t = M_free_triangles.back();
+        M_free_triangles.pop_back();
+        return t;
+    }
+
+    M_triangles.push_back( Triangle{ { -1, -1, -1 }, { -1, -1, -1 } } );
+    return static_cast< int >( M_triangles.size() ) - 1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::destroyTriangle( const int t )
+{
+    M_triangles[t] = Triangle{ { -1, -1, -1 }, { -1, -1, -1 } };
+    M_free_triangles.push_back( t );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DynamicVoronoiDiagram::flipIfNeeded( const int t,
+                                     const int i )
+{
+    const int u = M_triangles[t].neighbors_[i];
+    if ( u < 0 )
+    {
+        return false;
+    }
+
+    const Triangle & tri_t = M_triangles[t];
+    const Triangle & tri_u = M_triangles[u];
+
+    const int j = ( tri_u.neighbors_[0] == t ? 0
+                    : tri_u.neighbors_[1] == t ? 1
+                    : 2 );
+
+    // t = (p, a, b), u = (q, b, a)
+    const Vector2D & pp = M_points[tri_t.vertices_[i]];
+    const Vector2D & pa = M_points[tri_t.vertices_[next3( i )]];
+    const Vector2D & pb = M_points[tri_t.vertices_[prev3( i )]];
+    const Vector2D & pq = M_points[tri_u.vertices_[j]];
+
+    if ( incircle( pp, pa, pb, pq ) <= EPSILON )
+    {
+        return false;
+    }
+
+    // the quadrilateral must be convex
+    if ( orient( pp, pa, pq ) <= 0.0
+         || orient( pq, pb, pp ) <= 0.0 )
+    {
+        return false;
+    }
+
+    flip( t, i );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::flip( const int t,
+                             const int i )
+{
+    const int u = M_triangles[t].neighbors_[i];
+    const Triangle & tri_t = M_triangles[t];
+    const Triangle & tri_u = M_triangles[u];
+
+    const int j = ( tri_u.neighbors_[0] == t ? 0
+                    : tri_u.neighbors_[1] == t ? 1
+                    : 2 );
+
+    // t = (p, a, b), u = (q, b, a)  ==>  t = (p, a, q), u = (q, b, p)
+    const int p = tri_t.vertices_[i];
+    const int a = tri_t.vertices_[next3( i )];
+    const int b = tri_t.vertices_[prev3( i )];
+    const int q = tri_u.vertices_[j];
+
+    const int n_bp = tri_t.neighbors_[next3( i )];
+    const int n_pa = tri_t.neighbors_[prev3( i )];
+    const int n_aq = tri_u.neighbors_[next3( j )];
+    const int n_qb = tri_u.neighbors_[prev3( j )];
+
+    M_triangles[t] = Triangle{ { p, a, q }, { n_aq, u, n_pa } };
+    M_triangles[u] = Triangle{ { q, b, p }, { n_bp, t, n_qb } };
+
+    replaceNeighbor( n_aq, u, t );
+    replaceNeighbor( n_bp, t, u );
+
+    M_vertex_triangle[p] = t;
+    M_vertex_triangle[a] = t;
+    M_vertex_triangle[q] = t;
+    M_vertex_triangle[b] = u;
+
+    ++M_flip_count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::flipEdges()
+{
+    // guard against the infinite loop caused by the rounding errors
+    long max_flips = static_cast< long >( M_triangles.size() ) * 16 + 64;
+
+    while ( ! M_flip_stack.empty() )
+    {
+        const std::pair< int, int > e = M_flip_stack.back();
+        M_flip_stack.pop_back();
+
+        if ( flipIfNeeded( e.first, e.second ) )
+        {
+            const int u = M_triangles[e.first].neighbors_[1];
+            M_flip_stack.emplace_back( e.first, 0 );
+            M_flip_stack.emplace_back( e.first, 2 );
+            M_flip_stack.emplace_back( u, 0 );
+            M_flip_stack.emplace_back( u, 2 );
+
+            if ( --max_flips <= 0 )
+            {
+                M_flip_stack.clear();
+                break;
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DynamicVoronoiDiagram::canMoveInPlace( const int v,
+                                       const Vector2D & p ) const
+{
+    if ( M_vertex_triangle[v] < 0
+         || ! M_valid_area.contains( p ) )
+    {
+        return false;
+    }
+
+    // the new position must be in the kernel of the star polygon.
+    const int start = M_vertex_triangle[v];
+    int t = start;
+    do
+    {
+        const Triangle & tri = M_triangles[t];
+        const int i = ( tri.vertices_[0] == v ? 0
+                        : tri.vertices_[1] == v ? 1
+                        : 2 );
+        if ( orient( M_points[tri.vertices_[next3( i )]],
+                     M_points[tri.vertices_[prev3( i )]],
+                     p ) <= EPSILON )
+        {
+            return false;
+        }
+        t = tri.neighbors_[next3( i )];
+    }
+    while ( t != start && t >= 0 );
+
+    return t == start;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DynamicVoronoiDiagram::removeVertex( const int v )
+{
+    //
+    // reduce the degree of the vertex to 3 by flipping its edges.
+    // all flips are done inside the star polygon, so the touched
+    // triangles are always the triangles of the initial star.
+    //
+
+    M_star_triangles.clear();
+
+    const int start = M_vertex_triangle[v];
+    int t = start;
+    do
+    {
+        M_star_triangles.push_back( t );
+        const Triangle & tri = M_triangles[t];
+        const int i = ( tri.vertices_[0] == v ? 0
+                        : tri.vertices_[1] == v ? 1
+                        : 2 );
+        t = tri.neighbors_[next3( i )];
+    }
+    while ( t != start && t >= 0 );
+
+    if ( t != start )
+    {
+        return false;
+    }
+
+    int degree = static_cast< int >( M_star_triangles.size() );
+    while ( degree > 3 )
+    {
+        bool flipped = false;
+
+        t = M_vertex_triangle[v];
+        for ( int k = 0; k < degree; ++k )
+        {
+            // t = (v, a, b), u = (v, b, c)
+            const Triangle & tri = M_triangles[t];
+            const int i = ( tri.vertices_[0] == v ? 0
+                            : tri.vertices_[1] == v ? 1
+                            : 2 );
+            const int u = tri.neighbors_[next3( i )];
+            const Triangle & tri_u = M_triangles[u];
+            const int j = ( tri_u.vertices_[0] == v ? 0
+                            : tri_u.vertices_[1] == v ? 1
+                            : 2 );
+
+            const Vector2D & pv = M_points[v];
+            const Vector2D & pa = M_points[tri.vertices_[next3( i )]];
+            const Vector2D & pb = M_points[tri.vertices_[prev3( i )]];
+            const Vector2D & pc = M_points[tri_u.vertices_[prev3( j )]];
+
+            if ( orient( pa, pb, pc ) > EPSILON
+                 && orient( pv, pa, pc ) > EPSILON )
+            {
+                // edge (v, b) is replaced by (a, c)
+                flip( t, next3( i ) );
+                flipped = true;
+                break;
+            }
+
+            t = u;
+        }
+
+        if ( ! flipped )
+        {
+            return false;
+        }
+
+        --degree;
+    }
+
+    //
+    // merge 3 triangles (v, a, b), (v, b, c), (v, c, a) into (a, b, c)
+    //
+
+    const int t0 = M_vertex_triangle[v];
+    const int i0 = ( M_triangles[t0].vertices_[0] == v ? 0
+                     : M_triangles[t0].vertices_[1] == v ? 1
+                     : 2 );
+    const int t1 = M_triangles[t0].neighbors_[next3( i0 )];
+    const int i1 = ( M_triangles[t1].vertices_[0] == v ? 0
+                     : M_triangles[t1].vertices_[1] == v ? 1
+                     : 2 );
+    const int t2 = M_triangles[t1].neighbors_[next3( i1 )];
+    const int i2 = ( M_triangles[t2].vertices_[0] == v ? 0
+                     : M_triangles[t2].vertices_[1] == v ? 1
+                     : 2 );
+
+    const int a = M_triangles[t0].vertices_[next3( i0 )];
+    const int b = M_triangles[t1].vertices_[next3( i1 )];
+    const int c = M_triangles[t2].vertices_[next3( i2 )];
+
+    const int n_ab = M_triangles[t0].neighbors_[i0];
+    const int n_bc = M_triangles[t1].neighbors_[i1];
+    const int n_ca = M_triangles[t2].neighbors_[i2];
+
+    M_triangles[t0] = Triangle{ { a, b, c }, { n_bc, n_ca, n_ab } };
+    replaceNeighbor( n_bc, t1, t0 );
+    replaceNeighbor( n_ca, t2, t0 );
+
+    destroyTriangle( t1 );
+    destroyTriangle( t2 );
+
+    M_vertex_triangle[a] = M_vertex_triangle[b] = M_vertex_triangle[c] = t0;
+    M_vertex_triangle[v] = -1;
+    M_last_triangle = t0;
+
+    //
+    // restore the delaunay property inside the old star polygon
+    //
+
+    M_flip_stack.clear();
+    for ( const int st : M_star_triangles )
+    {
+        if ( st != t1 && st != t2 )
+        {
+            M_flip_stack.emplace_back( st, 0 );
+            M_flip_stack.emplace_back( st, 1 );
+            M_flip_stack.emplace_back( st, 2 );
+        }
+    }
+    flipEdges();
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::getNeighbors( const int index,
+                                     std::vector< int > * result ) const
+{
+    result->clear();
+
+    const int v = index + 3;
+    const int start = M_vertex_triangle[v];
+    if ( start < 0 )
+    {
+        return;
+    }
+
+    int t = start;
+    do
+    {
+        const Triangle & tri = M_triangles[t];
+        const int i = ( tri.vertices_[0] == v ? 0
+                        : tri.vertices_[1] == v ? 1
+                        : 2 );
+        const int n = tri.vertices_[next3( i )];
+        if ( n >= 3 )
+        {
+            result->push_back( n - 3 );
+        }
+        t = tri.neighbors_[next3( i )];
+    }
+    while ( t != start && t >= 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::clipCell( const int index,
+                                 std::vector< Vector2D > & buf0,
+                                 std::vector< Vector2D > & buf1 ) const
+{
+    buf0.clear();
+
+    const int v = index + 3;
+    const int start = M_vertex_triangle[v];
+    if ( start < 0 )
+    {
+        return;
+    }
+
+    buf0.emplace_back( M_bounding_rect.left(), M_bounding_rect.top() );
+    buf0.emplace_back( M_bounding_rect.left(), M_bounding_rect.bottom() );
+    buf0.emplace_back( M_bounding_rect.right(), M_bounding_rect.bottom() );
+    buf0.emplace_back( M_bounding_rect.right(), M_bounding_rect.top() );
+
+    const Vector2D & pv = M_points[v];
+
+    int t = start;
+    do
+    {
+        const Triangle & tri = M_triangles[t];
+        const int i = ( tri.vertices_[0] == v ? 0
+                        : tri.vertices_[1] == v ? 1
+                        : 2 );
+        const int n = tri.vertices_[next3( i )];
+        t = tri.neighbors_[next3( i )];
+
+        if ( n < 3 )
+        {
+            continue;
+        }
+
+        //
+        // clip by the half plane: dot( x, normal ) <= limit
+        //
+        const Vector2D & pn = M_points[n];
+        const Vector2D normal = pn - pv;
+        const double limit = ( pn.r2() - pv.r2() ) * 0.5;
+
+        buf1.clear();
+        const std::size_t size = buf0.size();
+        for ( std::size_t k = 0; k < size; ++k )
+        {
+            const Vector2D & s = buf0[k];
+            const Vector2D & e = buf0[( k + 1 ) % size];
+            const double ds = s.x * normal.x + s.y * normal.y - limit;
+            const double de = e.x * normal.x + e.y * normal.y - limit;
+
+            if ( ds <= 0.0 )
+            {
+                buf1.push_back( s );
+            }
+
+            if ( ( ds < 0.0 && de > 0.0 )
+                 || ( ds > 0.0 && de < 0.0 ) )
+            {
+                const double r = ds / ( ds - de );
+                buf1.emplace_back( s.x + ( e.x - s.x ) * r,
+                                   s.y + ( e.y - s.y ) * r );
+            }
+        }
+
+        buf0.swap( buf1 );
+    }
+    while ( t != start && t >= 0 && ! buf0.empty() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagram::getCellVertices( const int index,
+                                        std::vector< Vector2D > * result ) const
+{
+    std::vector< Vector2D > buf;
+    clipCell( index, *result, buf );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Polygon2D
+DynamicVoronoiDiagram::cellPolygon( const int index ) const
+{
+    std::vector< Vector2D > vertices;
+    getCellVertices( index, &vertices );
+    return Polygon2D( vertices );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+DynamicVoronoiDiagram::cellArea( const int index )
+{
+    clipCell( index, M_clip_buffer[0], M_clip_buffer[1] );
+
+    const std::vector< Vector2D > & v = M_clip_buffer[0];
+    const std::size_t size = v.size();
+    if ( size < 3 )
+    {
+        return 0.0;
+    }
+
+    double area2 = 0.0;
+    for ( std::size_t k = 0; k < size; ++k )
+    {
+        const Vector2D & s = v[k];
+        const Vector2D & e = v[( k + 1 ) % size];
+        area2 += s.x * e.y - e.x * s.y;
+    }
+
+    return std::fabs( area2 ) * 0.5;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+DynamicVoronoiDiagram::findNearestPoint( const Vector2D & p ) const
+{
+    const int n = static_cast< int >( M_points.size() );
+
+    int v = -1;
+    for ( int i = 3; i < n; ++i )
+    {
+        if ( M_vertex_triangle[i] >= 0 )
+        {
+            v = i;
+            break;
+        }
+    }
+
+    if ( v < 0 )
+    {
+        return -1;
+    }
+
+    // greedy walk on the delaunay graph reaches the nearest point.
+    double min_dist2 = M_points[v].dist2( p );
+    bool updated = true;
+    while ( updated )
+    {
+        updated = false;
+
+        const int start = M_vertex_triangle[v];
+        int t = start;
+        do
+        {
+            const Triangle & tri = M_triangles[t];
+            const int i = ( tri.vertices_[0] == v ? 0
+                            : tri.vertices_[1] == v ? 1
+                            : 2 );
+            const int nv = tri.vertices_[next3( i )];
+            t = tri.neighbors_[next3( i )];
+
+            if ( nv >= 3 )
+            {
+                const double d2 = M_points[nv].dist2( p );
+                if ( d2 < min_dist2 )
+                {
+                    min_dist2 = d2;
+                    v = nv;
+                    updated = true;
+                    break;
+                }
+            }
+        }
+        while ( t != start && t >= 0 );
+    }
+
+    return v - 3;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DynamicVoronoiDiagram::isDelaunay() const
+{
+    const int n_tri = static_cast< int >( M_triangles.size() );
+    for ( int t = 0; t < n_tri; ++t )
+    {
+        const Triangle & tri = M_triangles[t];
+        if ( tri.vertices_[0] < 3 // including the free slot
+             || tri.vertices_[1] < 3
+             || tri.vertices_[2] < 3 )
+        {
+            continue;
+        }
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            const int u = tri.neighbors_[i];
+            if ( u < 0 ) continue;
+
+            const Triangle & tri_u = M_triangles[u];
+            const int j = ( tri_u.neighbors_[0] == t ? 0
+                            : tri_u.neighbors_[1] == t ? 1
+                            : 2 );
+            const int q = tri_u.vertices_[j];
+            if ( q < 3 ) continue;
+
+            const Vector2D & pa = M_points[tri.vertices_[0]];
+            const Vector2D & pb = M_points[tri.vertices_[1]];
+            const Vector2D & pc = M_points[tri.vertices_[2]];
+            const Vector2D & pq = M_points[q];
+
+            // scale the tolerance by the magnitude of the determinant
+            const double scale = std::max( { pa.dist2( pq ), pb.dist2( pq ), pc.dist2( pq ), 1.0 } );
+            if ( incircle( pa, pb, pc, pq ) > 1.0e-9 * scale * scale )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,298 @@
+// -*-c++-*-
+
+/*!
+  \file dynamic_voronoi_diagram.h
+  \brief incrementally updated 2D voronoi diagram Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_GEOM_DYNAMIC_VORONOI_DIAGRAM_H
+#define RCSC_GEOM_DYNAMIC_VORONOI_DIAGRAM_H
+
+#include <rcsc/geom/polygon_2d.h>
+#include <rcsc/geom/rect_2d.h>
+#include <rcsc/geom/vector_2d.h>
+
+#include <vector>
+#include <array>
+#include <utility>
+
+namespace rcsc {
+
+/*!
+  \class DynamicVoronoiDiagram
+  \brief voronoi diagram that supports moving its kernel points.
+
+  The dual delaunay triangulation is kept as an index based triangle
+  array.  Moving a point updates the triangulation in place and restores
+  the delaunay property by local edge flips, so that the diagram for a
+  set of slowly moving points (e.g. the players in every cycle) can be
+  maintained without rebuilding everything.  If the new position is not
+  visible from the current star polygon, the vertex is removed and
+  inserted again.
+
+  Voronoi cells are always clipped by the bounding rectangle.
+*/
+class DynamicVoronoiDiagram {
+public:
+
+    static const double EPSILON; //!< tolerance threshold
+
+    /*!
+      \struct Triangle
+      \brief triangle data.  vertices are stored in counterclockwise order.
+     */
+    struct Triangle {
+        std::array< int, 3 > vertices_; //!< vertex indices (including the super triangle)
+        std::array< int, 3 > neighbors_; //!< neighbor triangle opposite to each vertex, or -1
+    };
+
+    typedef std::vector< Triangle > TriangleCont; //!< triangle container type
+
+private:
+
+    Rect2D M_bounding_rect; //!< clipping region of voronoi cells
+
+    //! vertex coordinates. the first 3 elements are the super triangle vertices.
+    std::vector< Vector2D > M_points;
+
+    //! one triangle index incident to each vertex, or -1 if the vertex is not in the triangulation
+    std::vector< int > M_vertex_triangle;
+
+    TriangleCont M_triangles; //!< triangle array
+    std::vector< int > M_free_triangles; //!< indices of the unused triangle slots
+
+    int M_last_triangle; //!< start point of the point location
+
+    Rect2D M_valid_area; //!< region where points can be moved without rebuilding
+
+    std::vector< std::pair< int, int > > M_flip_stack; //!< work area for the edge flips
+    std::vector< int > M_star_triangles; //!< work area for the vertex removal
+    std::vector< Vector2D > M_clip_buffer[2]; //!< work area for the cell clipping
+
+    // statistics
+    long M_flip_count; //!< total number of edge flips
+    long M_rebuild_count; //!< total number of the full rebuilds
+
+public:
+
+    /*!
+      \brief create an empty diagram with the bounding rectangle
+      \param bounding_rect clipping region of voronoi cells
+     */
+    explicit
+    DynamicVoronoiDiagram( const Rect2D & bounding_rect );
+
+    /*!
+      \brief create a diagram with points
+      \param bounding_rect clipping region of voronoi cells
+      \param points input points
+     */
+    DynamicVoronoiDiagram( const Rect2D & bounding_rect,
+                           const std::vector< Vector2D > & points );
+
+    /*!
+      \brief set the bounding rectangle.
+      \param rect clipping region of voronoi cells
+     */
+    void setBoundingRect( const Rect2D & rect )
+      {
+          M_bounding_rect = rect;
+      }
+
+    /*!
+      \brief get the bounding rectangle.
+      \return const reference to the rectangle
+     */
+    const Rect2D & boundingRect() const
+      {
+          return M_bounding_rect;
+      }
+
+    /*!
+      \brief remove all points
+     */
+    void clear();
+
+    /*!
+      \brief rebuild the triangulation from the given points
+      \param points input points. point index is used as a cell index.
+     */
+    void build( const std::vector< Vector2D > & points );
+
+    /*!
+      \brief add a new point. the triangulation is updated incrementally.
+      \param p coordinate of the new point
+      \return index of the added point
+     */
+    int addPoint( const Vector2D & p );
+
+    /*!
+      \brief move the point to the new position.
+      \param index point index
+      \param p new coordinate
+      \return true if the move was applied without the full rebuild
+     */
+    bool movePoint( const int index,
+                    const Vector2D & p );
+
+    /*!
+      \brief move all points. equivalent to calling movePoint() for each point.
+      \param points new coordinates. the size must be same as size().
+     */
+    void update( const std::vector< Vector2D > & points );
+
+    /*!
+      \brief get the number of input points
+      \return the number of input points
+     */
+    std::size_t size() const
+      {
+          return M_points.size() - 3;
+      }
+
+    /*!
+      \brief get the coordinate of the point
+      \param index point index
+      \return coordinate of the point
+     */
+    const Vector2D & point( const int index ) const
+      {
+          return M_points[index + 3];
+      }
+
+    /*!
+      \brief get the triangles including the super triangle vertices.
+      unused slots have negative vertex indices.
+      \return const reference to the container
+     */
+    const TriangleCont & triangles() const
+      {
+          return M_triangles;
+      }
+
+    /*!
+      \brief get the delaunay neighbors of the point
+      \param index point index
+      \param result container to store the neighbor point indices
+     */
+    void getNeighbors( const int index,
+                       std::vector< int > * result ) const;
+
+    /*!
+      \brief get the vertices of the voronoi cell clipped by the bounding rectangle
+      \param index point index
+      \param result container to store the vertices in counterclockwise order
+     */
+    void getCellVertices( const int index,
+                          std::vector< Vector2D > * result ) const;
+
+    /*!
+      \brief get the voronoi cell clipped by the bounding rectangle
+      \param index point index
+      \return polygon object
+     */
+    Polygon2D cellPolygon( const int index ) const;
+
+    /*!
+      \brief get the area of the voronoi cell clipped by the bounding rectangle
+      \param index point index
+      \return area value
+     */
+    double cellArea( const int index );
+
+    /*!
+      \brief get the index of the point whose cell contains the given point
+      \param p target point
+      \return point index, or -1 if no point exists
+     */
+    int findNearestPoint( const Vector2D & p ) const;
+
+    /*!
+      \brief check if all edges satisfy the local delaunay condition
+      \return checked result
+     */
+    bool isDelaunay() const;
+
+    /*!
+      \brief get the total number of edge flips
+      \return the number of flips
+     */
+    long flipCount() const
+      {
+          return M_flip_count;
+      }
+
+    /*!
+      \brief get the total number of full rebuilds
+      \return the number of rebuilds
+     */
+    long rebuildCount() const
+      {
+          return M_rebuild_count;
+      }
+
+private:
+
+    void rebuild();
+    void createSuperTriangle();
+
+    bool insertVertex( const int v );
+    int locate( const Vector2D & p ) const;
+
+    void splitTriangle( const int t,
+                        const int v );
+    void splitEdge( const int t,
+                    const int i,
+                    const int v );
+
+    void replaceNeighbor( const int t,
+                          const int old_neighbor,
+                          const int new_neighbor );
+    int createTriangle();
+    void destroyTriangle( const int t );
+
+    bool flipIfNeeded( const int t,
+                       const int i );
+    void flip( const int t,
+               const int i );
+    void flipEdges();
+
+    bool canMoveInPlace( const int v,
+                         const Vector2D & p ) const;
+    void moveInPlace( const int v,
+                      const Vector2D & p );
+    bool removeVertex( const int v );
+
+    void clipCell( const int index,
+                   std::vector< Vector2D > & buf0,
+                   std::vector< Vector2D > & buf1 ) const;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,293 @@
+// -*-c++-*-
+
+/*!
+  \file test_dynamic_voronoi_diagram.cpp
+  \brief test code for rcsc::DynamicVoronoiDiagram
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "dynamic_voronoi_diagram.h"
+#include "voronoi_diagram.h"
+
+#include <rcsc/time/timer.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+class DynamicVoronoiDiagramTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( DynamicVoronoiDiagramTest );
+    CPPUNIT_TEST( testSquare );
+    CPPUNIT_TEST( testMove );
+    CPPUNIT_TEST( testBenchmark );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testSquare();
+    void testMove();
+    void testBenchmark();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( DynamicVoronoiDiagramTest );
+
+namespace {
+
+const rcsc::Rect2D PITCH_RECT = rcsc::Rect2D::from_center( 0.0, 0.0, 105.0, 68.0 );
+
+/*-------------------------------------------------------------------*/
+void
+move_players( std::mt19937 & gen,
+              const double max_move,
+              std::vector< rcsc::Vector2D > * players )
+{
+    std::uniform_real_distribution<> dist( -max_move, max_move );
+    for ( rcsc::Vector2D & p : *players )
+    {
+        p.x = std::clamp( p.x + dist( gen ), -55.0, 55.0 );
+        p.y = std::clamp( p.y + dist( gen ), -36.0, 36.0 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+std::vector< rcsc::Vector2D >
+create_players( std::mt19937 & gen )
+{
+    std::uniform_real_distribution<> x_dist( -52.5, 52.5 );
+    std::uniform_real_distribution<> y_dist( -34.0, 34.0 );
+
+    std::vector< rcsc::Vector2D > players;
+    for ( int i = 0; i < 22; ++i )
+    {
+        players.emplace_back( x_dist( gen ), y_dist( gen ) );
+    }
+    return players;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagramTest::testSquare()
+{
+    //                          //
+    //  +10   p1 *------* p0    //
+    //           |      |       //
+    //           |  p4  |       //
+    //           |   *  |       //
+    //           |      |       //
+    //  -10   p2 *------* p3    //
+    //         -10     +10      //
+
+    std::vector< rcsc::Vector2D > points;
+    points.emplace_back( +10.0, +10.0 );
+    points.emplace_back( -10.0, +10.0 );
+    points.emplace_back( -10.0, -10.0 );
+    points.emplace_back( +10.0, -10.0 );
+    points.emplace_back( 0.0, 0.0 );
+
+    rcsc::DynamicVoronoiDiagram v( rcsc::Rect2D::from_center( 0.0, 0.0, 40.0, 40.0 ),
+                                   points );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 5 ), v.size() );
+    CPPUNIT_ASSERT( v.isDelaunay() );
+
+    // the center cell is a diamond
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 200.0, v.cellArea( 4 ), 1.0e-6 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 350.0, v.cellArea( 0 ), 1.0e-6 );
+
+    double total = 0.0;
+    for ( int i = 0; i < 5; ++i )
+    {
+        total += v.cellArea( i );
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1600.0, total, 1.0e-6 );
+
+    std::vector< int > neighbors;
+    v.getNeighbors( 4, &neighbors );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 4 ), neighbors.size() );
+
+    CPPUNIT_ASSERT_EQUAL( 4, v.findNearestPoint( rcsc::Vector2D( 1.0, -2.0 ) ) );
+    CPPUNIT_ASSERT_EQUAL( 1, v.findNearestPoint( rcsc::Vector2D( -15.0, 12.0 ) ) );
+
+    // move the center point to the corner cell
+    v.movePoint( 4, rcsc::Vector2D( 15.0, 15.0 ) );
+    CPPUNIT_ASSERT( v.isDelaunay() );
+    CPPUNIT_ASSERT_EQUAL( 4, v.findNearestPoint( rcsc::Vector2D( 19.0, 19.0 ) ) );
+    CPPUNIT_ASSERT_EQUAL( 3, v.findNearestPoint( rcsc::Vector2D( 1.0, -2.0 ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagramTest::testMove()
+{
+    std::mt19937 gen( 1 );
+
+    for ( int trial = 0; trial < 20; ++trial )
+    {
+        std::vector< rcsc::Vector2D > players = create_players( gen );
+        rcsc::DynamicVoronoiDiagram v( PITCH_RECT, players );
+
+        for ( int cycle = 0; cycle < 100; ++cycle )
+        {
+            move_players( gen, 1.0, &players );
+            v.update( players );
+
+            CPPUNIT_ASSERT( v.isDelaunay() );
+
+            rcsc::DynamicVoronoiDiagram fresh( PITCH_RECT, players );
+
+            double total = 0.0;
+            for ( int i = 0; i < 22; ++i )
+            {
+                const double area = v.cellArea( i );
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( fresh.cellArea( i ), area, 1.0e-6 );
+                total += area;
+            }
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( PITCH_RECT.area(), total, 1.0e-6 );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DynamicVoronoiDiagramTest::testBenchmark()
+{
+    const int max_cycle = 6000;
+
+    std::mt19937 gen( 2 );
+    const std::vector< rcsc::Vector2D > initial_players = create_players( gen );
+
+    std::vector< rcsc::Vector2D > players;
+    double total = 0.0;
+
+    {
+        std::mt19937 move_gen( 3 );
+        players = initial_players;
+        rcsc::DynamicVoronoiDiagram v( PITCH_RECT, players );
+
+        rcsc::Timer timer;
+        for ( int cycle = 0; cycle < max_cycle; ++cycle )
+        {
+            move_players( move_gen, 0.5, &players );
+            v.update( players );
+            for ( int i = 0; i < 22; ++i ) total += v.cellArea( i );
+        }
+        std::cout << "\nDynamicVoronoiDiagram::update elapsed "
+                  << timer.elapsedReal() << " [ms] for " << max_cycle << " cycles."
+                  << " flips=" << v.flipCount()
+                  << " rebuilds=" << v.rebuildCount() << std::endl;
+    }
+
+    {
+        std::mt19937 move_gen( 3 );
+        players = initial_players;
+        rcsc::DynamicVoronoiDiagram v( PITCH_RECT );
+
+        rcsc::Timer timer;
+        for ( int cycle = 0; cycle < max_cycle; ++cycle )
+        {
+            move_players( move_gen, 0.5, &players );
+            v.build( players );
+            for ( int i = 0; i < 22; ++i ) total -= v.cellArea( i );
+        }
+        std::cout << "DynamicVoronoiDiagram::build elapsed "
+                  << timer.elapsedReal() << " [ms] for " << max_cycle << " cycles." << std::endl;
+    }
+
+    // both diagrams must have the same cells
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, total, 1.0e-3 );
+
+    {
+        std::mt19937 move_gen( 3 );
+        players = initial_players;
+
+        rcsc::Timer timer;
+        for ( int cycle = 0; cycle < max_cycle; ++cycle )
+        {
+            move_players( move_gen, 0.5, &players );
+            rcsc::VoronoiDiagram v( players );
+            v.setBoundingRect( PITCH_RECT );
+            v.compute();
+        }
+        std::cout << "VoronoiDiagram::compute elapsed "
+                  << timer.elapsedReal() << " [ms] for " << max_cycle << " cycles." << std::endl;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
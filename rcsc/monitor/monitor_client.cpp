@@ -0,0 +1,441 @@
+// -*-c++-*-
+
+/*!
+  \file monitor_client.cpp
+  \brief monitor protocol client Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "monitor_client.h"
+
+#include "monitor_command.h"
+
+#include <rcsc/net/udp_socket.h>
+#include <rcsc/rcg/handler.h>
+#include <rcsc/rcg/parser_v4.h>
+#include <rcsc/rcg/parser_simdjson.h>
+
+#include <sstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+
+#include <sys/select.h> // select()
+#include <sys/time.h> // select()
+#include <sys/types.h> // select()
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class MonitorClient::Dispatcher
+  \brief rcg handler that forwards all data to the user's handler and
+  publishes the show data to the frame buffer.
+ */
+class MonitorClient::Dispatcher
+    : public rcg::Handler {
+private:
+
+    rcg::Handler * M_handler;
+    MonitorFrameBuffer & M_frame_buffer;
+
+    PlayMode M_playmode;
+    rcg::TeamT M_team_l;
+    rcg::TeamT M_team_r;
+
+public:
+
+    Dispatcher( rcg::Handler * handler,
+                MonitorFrameBuffer & frame_buffer )
+        : M_handler( handler ),
+          M_frame_buffer( frame_buffer ),
+          M_playmode( PM_Null )
+      { }
+
+    bool handleLogVersion( const int ver ) override
+      {
+          rcg::Handler::handleLogVersion( ver );
+          return ( M_handler ? M_handler->handleLogVersion( ver ) : true );
+      }
+
+    bool handleEOF() override
+      {
+          return ( M_handler ? M_handler->handleEOF() : true );
+      }
+
+    bool handleShow( const rcg::ShowInfoT & show ) override
+      {
+          MonitorFrame & frame = M_frame_buffer.writeBuffer();
+          frame.show_ = show;
+          frame.playmode_ = M_playmode;
+          frame.team_l_ = M_team_l;
+          frame.team_r_ = M_team_r;
+          M_frame_buffer.publish();
+
+          return ( M_handler ? M_handler->handleShow( show ) : true );
+      }
+
+    bool handleMsg( const int time,
+                    const int board,
+                    const std::string & msg ) override
+      {
+          return ( M_handler ? M_handler->handleMsg( time, board, msg ) : true );
+      }
+
+    bool handleDraw( const int time,
+                     const rcg::drawinfo_t & draw ) override
+      {
+          return ( M_handler ? M_handler->handleDraw( time, draw ) : true );
+      }
+
+    bool handlePlayMode( const int time,
+                         const PlayMode pm ) override
+      {
+          M_playmode = pm;
+          return ( M_handler ? M_handler->handlePlayMode( time, pm ) : true );
+      }
+
+    bool handleTeam( const int time,
+                     const rcg::TeamT & team_l,
+                     const rcg::TeamT & team_r ) override
+      {
+          M_team_l = team_l;
+          M_team_r = team_r;
+          return ( M_handler ? M_handler->handleTeam( time, team_l, team_r ) : true );
+      }
+
+    bool handleServerParam( const rcg::ServerParamT & param ) override
+      {
+          return ( M_handler ? M_handler->handleServerParam( param ) : true );
+      }
+
+    bool handlePlayerParam( const rcg::PlayerParamT & param ) override
+      {
+          return ( M_handler ? M_handler->handlePlayerParam( param ) : true );
+      }
+
+    bool handlePlayerType( const rcg::PlayerTypeT & param ) override
+      {
+          return ( M_handler ? M_handler->handlePlayerType( param ) : true );
+      }
+
+    bool handleTeamGraphic( const char side,
+                            const int x,
+                            const int y,
+                            const std::vector< std::string > & xpm_data ) override
+      {
+          return ( M_handler ? M_handler->handleTeamGraphic( side, x, y, xpm_data ) : true );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+MonitorClient::MonitorClient( rcg::Handler * handler )
+    : M_version( 4 ),
+      M_dispatcher( new Dispatcher( handler, M_frame_buffer ) ),
+      M_text_parser( new rcg::ParserV4() ),
+      M_json_parser( new rcg::ParserSimdJSON() ),
+      M_buffer( new char[MAX_MESG] ),
+      M_running( false ),
+      M_server_alive( false ),
+      M_interval_msec( 100 ),
+      M_max_timeout_count( 50 ),
+      M_received_count( 0 ),
+      M_error_count( 0 )
+{
+    M_message.reserve( MAX_MESG );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+MonitorClient::~MonitorClient()
+{
+    disconnect();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+MonitorClient::rcg_version( const int version )
+{
+    return ( version <= 3 ? rcg::REC_VERSION_4
+             : version == 4 ? rcg::REC_VERSION_5
+             : rcg::REC_VERSION_6 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MonitorClient::connectTo( const char * hostname,
+                          const int port,
+                          const int version )
+{
+    M_socket = std::shared_ptr< UDPSocket >( new UDPSocket( hostname, port ) );
+
+    if ( ! M_socket
+         || M_socket->fd() == -1 )
+    {
+        std::cerr << "(MonitorClient::connectTo) Failed to create connection."
+                  << std::endl;
+        M_socket.reset();
+        M_server_alive = false;
+        return false;
+    }
+
+    M_version = version;
+    M_server_alive = true;
+    M_dispatcher->handleLogVersion( rcg_version( version ) );
+
+    if ( sendCommand( MonitorInitCommand( version ) ) <= 0 )
+    {
+        M_socket.reset();
+        M_server_alive = false;
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MonitorClient::disconnect()
+{
+    if ( M_socket )
+    {
+        sendCommand( MonitorByeCommand() );
+        M_socket.reset();
+    }
+
+    M_server_alive = false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+MonitorClient::sendCommand( const MonitorCommand & com )
+{
+    if ( ! M_socket )
+    {
+        return -1;
+    }
+
+    std::ostringstream os;
+    com.toCommandString( os );
+    const std::string msg = os.str();
+
+    // the server expects the null terminated string.
+    return M_socket->writeDatagram( msg.c_str(), msg.length() + 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+MonitorClient::receiveMessage()
+{
+    if ( ! M_socket )
+    {
+        return -1;
+    }
+
+    // the peer address is updated to the server's dedicated port.
+    const int n = M_socket->readDatagram( M_buffer.get(), MAX_MESG - 1 );
+
+    if ( n > 0 )
+    {
+        dispatch( M_buffer.get(), n );
+    }
+
+    return n;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MonitorClient::dispatch( const char * msg,
+                         const std::size_t len )
+{
+    ++M_received_count;
+
+    std::size_t n = len;
+    while ( n > 0
+            && ( msg[n - 1] == '\0'
+                 || msg[n - 1] == '\n'
+                 || msg[n - 1] == '\r' ) )
+    {
+        --n;
+    }
+
+    std::size_t begin = 0;
+    while ( begin < n
+            && ( msg[begin] == ' ' || msg[begin] == '\t' ) )
+    {
+        ++begin;
+    }
+
+    if ( begin >= n )
+    {
+        return true;
+    }
+
+    // assign() reuses the reserved capacity.
+    M_message.assign( msg + begin, n - begin );
+
+    bool result = true;
+    if ( M_message[0] == '{' )
+    {
+        result = M_json_parser->parseData( M_message, *M_dispatcher );
+    }
+    else if ( M_message.compare( 0, 4, "(ok " ) == 0
+              || M_message.compare( 0, 7, "(error " ) == 0
+              || M_message.compare( 0, 9, "(warning " ) == 0 )
+    {
+        // reply to the monitor command
+        result = true;
+    }
+    else if ( M_message[0] == '(' )
+    {
+        result = M_text_parser->parseLine( static_cast< int >( M_received_count ),
+                                           M_message,
+                                           *M_dispatcher );
+    }
+    else
+    {
+        result = false;
+    }
+
+    if ( ! result )
+    {
+        ++M_error_count;
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MonitorClient::setTimeout( const int interval_msec,
+                           const int max_count )
+{
+    if ( interval_msec > 0 )
+    {
+        M_interval_msec = interval_msec;
+    }
+
+    if ( max_count > 0 )
+    {
+        M_max_timeout_count = max_count;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MonitorClient::run()
+{
+    if ( ! M_socket )
+    {
+        return;
+    }
+
+    M_running = true;
+
+    struct timeval interval;
+
+    fd_set read_fds;
+    fd_set read_fds_back;
+
+    FD_ZERO( &read_fds );
+    FD_SET( M_socket->fd(), &read_fds );
+    read_fds_back = read_fds;
+
+    int timeout_count = 0;
+
+    while ( M_running
+            && M_server_alive )
+    {
+        read_fds = read_fds_back;
+        interval.tv_sec = M_interval_msec / 1000;
+        interval.tv_usec = ( M_interval_msec % 1000 ) * 1000;
+
+        int ret = ::select( M_socket->fd() + 1, &read_fds,
+                            static_cast< fd_set * >( 0 ),
+                            static_cast< fd_set * >( 0 ),
+                            &interval );
+        if ( ret < 0 )
+        {
+            std::perror( "select" );
+            break;
+        }
+        else if ( ret == 0 )
+        {
+            if ( ++timeout_count >= M_max_timeout_count )
+            {
+                std::cerr << "(MonitorClient::run) server down?" << std::endl;
+                M_server_alive = false;
+            }
+        }
+        else
+        {
+            timeout_count = 0;
+
+            // read all datagrams in the socket queue
+            while ( receiveMessage() > 0 )
+            {
+
+            }
+        }
+    }
+
+    M_running = false;
+}
+
+}
@@ -0,0 +1,231 @@
+// -*-c++-*-
+
+/*!
+  \file monitor_client.h
+  \brief monitor protocol client Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_MONITOR_MONITOR_CLIENT_H
+#define RCSC_MONITOR_MONITOR_CLIENT_H
+
+#include <rcsc/monitor/monitor_frame.h>
+
+#include <memory>
+#include <string>
+#include <atomic>
+
+namespace rcsc {
+
+class UDPSocket;
+class MonitorCommand;
+
+namespace rcg {
+class Handler;
+class ParserV4;
+class ParserSimdJSON;
+}
+
+/*!
+  \class MonitorClient
+  \brief client of the server's monitor protocol.
+
+  Each received datagram is parsed in place by the rcg parser (the text
+  format of rcg v4+ or the JSON format) and dispatched to the registered
+  rcg::Handler immediately.  In addition, every show data is published
+  to MonitorFrameBuffer together with the last playmode and team
+  information, so that another thread can read the newest frame without
+  locking.
+
+  run() can be executed in a dedicated thread and be finished by stop().
+ */
+class MonitorClient {
+public:
+
+    enum {
+        MAX_MESG = 65536, //!< max length of the receive buffer.
+    };
+
+private:
+
+    class Dispatcher;
+
+    std::shared_ptr< UDPSocket > M_socket; //!< udp connection
+    int M_version; //!< monitor protocol version
+
+    std::unique_ptr< Dispatcher > M_dispatcher; //!< handler wrapper
+    std::unique_ptr< rcg::ParserV4 > M_text_parser; //!< rcg v4+ text parser
+    std::unique_ptr< rcg::ParserSimdJSON > M_json_parser; //!< json parser
+
+    MonitorFrameBuffer M_frame_buffer; //!< published frames
+
+    std::unique_ptr< char[] > M_buffer; //!< receive buffer
+    std::string M_message; //!< work area passed to the parser
+
+    std::atomic< bool > M_running; //!< loop flag used by run()
+    bool M_server_alive; //!< server status flag
+
+    int M_interval_msec; //!< timeout interval for select()
+    int M_max_timeout_count; //!< the number of timeouts to recognize the server down
+
+    long M_received_count; //!< the number of received datagrams
+    long M_error_count; //!< the number of datagrams that could not be parsed
+
+    // not used
+    MonitorClient( const MonitorClient & ) = delete;
+    MonitorClient & operator=( const MonitorClient & ) = delete;
+
+public:
+
+    /*!
+      \brief create the client
+      \param handler pointer to the rcg data handler. NULL is allowed,
+      in which case only the frame buffer is updated.
+     */
+    explicit
+    MonitorClient( rcg::Handler * handler = nullptr );
+
+    /*!
+      \brief close the connection
+     */
+    ~MonitorClient();
+
+    /*!
+      \brief connect to the server and send the dispinit command.
+      \param hostname server host name
+      \param port server's monitor port number
+      \param version monitor protocol version (3: rcg v4 text, 4: rcg v5 text, 5: rcg v6 text)
+      \return true if the dispinit command has been sent.
+     */
+    bool connectTo( const char * hostname,
+                    const int port = 6000,
+                    const int version = 4 );
+
+    /*!
+      \brief send the dispbye command and close the connection
+     */
+    void disconnect();
+
+    /*!
+      \brief send the monitor command to the server
+      \param com command object
+      \return the length of sent data, or -1 if failed.
+     */
+    int sendCommand( const MonitorCommand & com );
+
+    /*!
+      \brief receive one datagram in the socket queue and dispatch it.
+      \return length of received message. 0 if no data, -1 if an error occurred.
+     */
+    int receiveMessage();
+
+    /*!
+      \brief handle the given message data as a received datagram.
+      \param msg message data
+      \param len length of the message data
+      \return true if successfully parsed.
+     */
+    bool dispatch( const char * msg,
+                   const std::size_t len );
+
+    /*!
+      \brief receive and dispatch datagrams until the server is down or stop() is called.
+     */
+    void run();
+
+    /*!
+      \brief request the run() loop to be finished. this can be called from another thread.
+     */
+    void stop()
+      {
+          M_running = false;
+      }
+
+    /*!
+      \brief check if the server is alive
+      \return checked result
+     */
+    bool isServerAlive() const
+      {
+          return M_server_alive;
+      }
+
+    /*!
+      \brief set the timeout interval used by run()
+      \param interval_msec interval of select() by milli second
+      \param max_count the number of timeouts to recognize the server down
+     */
+    void setTimeout( const int interval_msec,
+                     const int max_count );
+
+    /*!
+      \brief get the monitor protocol version
+      \return protocol version number
+     */
+    int version() const
+      {
+          return M_version;
+      }
+
+    /*!
+      \brief get the frame buffer. The reader thread can call fetch() and frame().
+      \return reference to the frame buffer
+     */
+    MonitorFrameBuffer & frameBuffer()
+      {
+          return M_frame_buffer;
+      }
+
+    /*!
+      \brief get the number of received datagrams
+      \return the number of datagrams
+     */
+    long receivedCount() const
+      {
+          return M_received_count;
+      }
+
+    /*!
+      \brief get the number of datagrams that could not be parsed
+      \return the number of errors
+     */
+    long errorCount() const
+      {
+          return M_error_count;
+      }
+
+    /*!
+      \brief get the rcg version corresponding to the monitor protocol version
+      \param version monitor protocol version
+      \return rcg version number
+     */
+    static
+    int rcg_version( const int version );
+};
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+// -*-c++-*-
+
+/*!
+  \file monitor_frame.cpp
+  \brief display frame published by the monitor client Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "monitor_frame.h"
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+MonitorFrameBuffer::MonitorFrameBuffer()
+    : M_middle( 1 ),
+      M_back( 0 ),
+      M_front( 2 ),
+      M_published_count( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MonitorFrameBuffer::publish()
+{
+    M_frames[M_back].seq_ = ++M_published_count;
+
+    // release: the frame data must be visible before the index.
+    // acquire: the returned slot may still be read by the reader just before the exchange.
+    const unsigned int old = M_middle.exchange( M_back | FRESH_BIT,
+                                                std::memory_order_acq_rel );
+    M_back = old & INDEX_MASK;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MonitorFrameBuffer::fetch()
+{
+    if ( ! ( M_middle.load( std::memory_order_relaxed ) & FRESH_BIT ) )
+    {
+        return false;
+    }
+
+    const unsigned int old = M_middle.exchange( M_front,
+                                                std::memory_order_acq_rel );
+    M_front = old & INDEX_MASK;
+    return true;
+}
+
+}
@@ -0,0 +1,147 @@
+// -*-c++-*-
+
+/*!
+  \file monitor_frame.h
+  \brief display frame published by the monitor client Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_MONITOR_MONITOR_FRAME_H
+#define RCSC_MONITOR_MONITOR_FRAME_H
+
+#include <rcsc/rcg/types.h>
+#include <rcsc/types.h>
+
+#include <atomic>
+
+namespace rcsc {
+
+/*!
+  \struct MonitorFrame
+  \brief one display frame received from the server.
+ */
+struct MonitorFrame {
+    long seq_; //!< serial number of the published frame. 0 means no data.
+    rcg::ShowInfoT show_; //!< positions of the ball and players
+    PlayMode playmode_; //!< the last received playmode
+    rcg::TeamT team_l_; //!< the last received left team information
+    rcg::TeamT team_r_; //!< the last received right team information
+
+    MonitorFrame()
+        : seq_( 0 ),
+          playmode_( PM_Null )
+      { }
+};
+
+/*!
+  \class MonitorFrameBuffer
+  \brief lock-free triple buffer to pass the latest frame from one
+  writer thread to one reader thread.
+
+  The writer fills writeBuffer() and calls publish().  The reader calls
+  fetch() to take the newest published frame and reads it by frame().
+  Neither side blocks the other, and the reader never sees a partially
+  written frame.  Older frames that were not fetched are dropped.
+ */
+class MonitorFrameBuffer {
+private:
+
+    enum {
+        INDEX_MASK = 0x03,
+        FRESH_BIT = 0x04,
+    };
+
+    MonitorFrame M_frames[3]; //!< frame slots
+
+    //! index of the slot exchanged between the writer and the reader
+    std::atomic< unsigned int > M_middle;
+
+    unsigned int M_back; //!< slot index owned by the writer
+    unsigned int M_front; //!< slot index owned by the reader
+
+    long M_published_count; //!< the number of published frames (writer side)
+
+    // not used
+    MonitorFrameBuffer( const MonitorFrameBuffer & ) = delete;
+    MonitorFrameBuffer & operator=( const MonitorFrameBuffer & ) = delete;
+
+public:
+
+    /*!
+      \brief initialize all slots
+     */
+    MonitorFrameBuffer();
+
+    //
+    // writer interface
+    //
+
+    /*!
+      \brief get the slot to be written
+      \return reference to the writer's frame
+     */
+    MonitorFrame & writeBuffer()
+      {
+          return M_frames[M_back];
+      }
+
+    /*!
+      \brief make the written frame visible to the reader
+     */
+    void publish();
+
+    /*!
+      \brief get the number of published frames
+      \return the number of frames. this can be called only by the writer.
+     */
+    long publishedCount() const
+      {
+          return M_published_count;
+      }
+
+    //
+    // reader interface
+    //
+
+    /*!
+      \brief take the newest published frame if exists
+      \return true if frame() has been updated
+     */
+    bool fetch();
+
+    /*!
+      \brief get the frame fetched by the last fetch()
+      \return const reference to the reader's frame
+     */
+    const MonitorFrame & frame() const
+      {
+          return M_frames[M_front];
+      }
+};
+
+}
+
+#endif
@@ -0,0 +1,278 @@
+// -*-c++-*-
+
+/*!
+  \file monitor_replayer.cpp
+  \brief rcg file replayer that serves the monitor protocol Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "monitor_replayer.h"
+
+#include <rcsc/net/udp_socket.h>
+#include <rcsc/gz/gzfstream.h>
+#include <rcsc/rcg/types.h>
+
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+
+#include <unistd.h> // usleep()
+#include <sys/select.h> // select()
+#include <sys/time.h> // select()
+#include <sys/types.h> // select()
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+MonitorReplayer::MonitorReplayer()
+    : M_connected( false ),
+      M_version( 0 ),
+      M_index( 0 ),
+      M_interval_msec( 100 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+MonitorReplayer::~MonitorReplayer()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MonitorReplayer::open( const std::string & filepath )
+{
+    gzifstream fin( filepath.c_str() );
+    if ( ! fin.is_open() )
+    {
+        std::cerr << "(MonitorReplayer::open) could not open the file "
+                  << filepath << std::endl;
+        return false;
+    }
+
+    return open( fin );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MonitorReplayer::open( std::istream & is )
+{
+    M_version = 0;
+    M_lines.clear();
+    M_index = 0;
+
+    std::string line;
+    if ( ! std::getline( is, line )
+         || line.length() < 4
+         || line.compare( 0, 3, "ULG" ) != 0 )
+    {
+        std::cerr << "(MonitorReplayer::open) unsupported rcg format." << std::endl;
+        return false;
+    }
+
+    const int version = line[3] - '0';
+    if ( version != rcg::REC_VERSION_4
+         && version != rcg::REC_VERSION_5
+         && version != rcg::REC_VERSION_6 )
+    {
+        std::cerr << "(MonitorReplayer::open) unsupported rcg version: "
+                  << line << std::endl;
+        return false;
+    }
+
+    M_version = version;
+
+    while ( std::getline( is, line ) )
+    {
+        if ( line.empty()
+             || line[0] != '(' )
+        {
+            continue;
+        }
+
+        M_lines.push_back( line );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MonitorReplayer::bind( const int port )
+{
+    M_socket = std::shared_ptr< UDPSocket >( new UDPSocket( port ) );
+    M_connected = false;
+
+    if ( M_socket->fd() == -1 )
+    {
+        std::cerr << "(MonitorReplayer::bind) failed to create the socket."
+                  << std::endl;
+        M_socket.reset();
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+MonitorReplayer::port() const
+{
+    return ( M_socket
+             ? static_cast< int >( M_socket->localPort() )
+             : 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MonitorReplayer::waitClient( const int timeout_msec )
+{
+    if ( ! M_socket )
+    {
+        return false;
+    }
+
+    char buf[512];
+    int waited_msec = 0;
+
+    while ( waited_msec <= timeout_msec )
+    {
+        fd_set read_fds;
+        FD_ZERO( &read_fds );
+        FD_SET( M_socket->fd(), &read_fds );
+
+        struct timeval interval;
+        interval.tv_sec = 0;
+        interval.tv_usec = 10 * 1000;
+
+        const int ret = ::select( M_socket->fd() + 1, &read_fds,
+                                  static_cast< fd_set * >( 0 ),
+                                  static_cast< fd_set * >( 0 ),
+                                  &interval );
+        if ( ret < 0 )
+        {
+            std::perror( "select" );
+            return false;
+        }
+
+        if ( ret == 0 )
+        {
+            waited_msec += 10;
+            continue;
+        }
+
+        // the peer address is set to the client address.
+        const int n = M_socket->readDatagram( buf, sizeof( buf ) - 1 );
+        if ( n > 0 )
+        {
+            buf[n] = '\0';
+            if ( ! std::strncmp( buf, "(dispinit", 9 ) )
+            {
+                M_connected = true;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MonitorReplayer::sendNext()
+{
+    if ( ! M_socket
+         || ! M_connected
+         || M_index >= M_lines.size() )
+    {
+        return false;
+    }
+
+    const std::string & line = M_lines[M_index];
+    ++M_index;
+
+    return M_socket->writeDatagram( line.c_str(), line.length() + 1 ) > 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+MonitorReplayer::replay()
+{
+    std::size_t count = 0;
+
+    while ( ! isFinished() )
+    {
+        const bool show = ( M_lines[M_index].compare( 0, 6, "(show " ) == 0 );
+
+        if ( ! sendNext() )
+        {
+            break;
+        }
+        ++count;
+
+        if ( show
+             && M_interval_msec > 0 )
+        {
+            ::usleep( M_interval_msec * 1000 );
+        }
+    }
+
+    return count;
+}
+
+}
@@ -0,0 +1,177 @@
+// -*-c++-*-
+
+/*!
+  \file monitor_replayer.h
+  \brief rcg file replayer that serves the monitor protocol Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_MONITOR_MONITOR_REPLAYER_H
+#define RCSC_MONITOR_MONITOR_REPLAYER_H
+
+#include <algorithm>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rcsc {
+
+class UDPSocket;
+
+/*!
+  \class MonitorReplayer
+  \brief local server that sends the records of an rcg file to a
+  monitor client over UDP.
+
+  Only the text format of rcg v4 or later is supported.  Each line of
+  the file is sent as one datagram, the same as the server's monitor
+  protocol.  This class is intended to test the monitor clients without
+  running the real server.
+ */
+class MonitorReplayer {
+private:
+
+    std::shared_ptr< UDPSocket > M_socket; //!< server socket
+    bool M_connected; //!< true if a client has been accepted
+
+    int M_version; //!< rcg version of the loaded file
+    std::vector< std::string > M_lines; //!< data lines of the loaded file
+    std::size_t M_index; //!< index of the next line to be sent
+
+    int M_interval_msec; //!< wait interval after each show line
+
+    // not used
+    MonitorReplayer( const MonitorReplayer & ) = delete;
+    MonitorReplayer & operator=( const MonitorReplayer & ) = delete;
+
+public:
+
+    /*!
+      \brief initialize member variables
+     */
+    MonitorReplayer();
+
+    /*!
+      \brief destructor
+     */
+    ~MonitorReplayer();
+
+    /*!
+      \brief load the rcg file
+      \param filepath rcg file path (gzipped file is allowed)
+      \return true if the file is loaded.
+     */
+    bool open( const std::string & filepath );
+
+    /*!
+      \brief load the rcg data from the input stream
+      \param is input stream
+      \return true if the data is loaded.
+     */
+    bool open( std::istream & is );
+
+    /*!
+      \brief create the server socket
+      \param port port number. if 0, the number assigned by the system is used.
+      \return true if the socket is created.
+     */
+    bool bind( const int port );
+
+    /*!
+      \brief get the bound port number
+      \return port number
+     */
+    int port() const;
+
+    /*!
+      \brief wait for the dispinit command from a client
+      \param timeout_msec max waiting time by milli second
+      \return true if a client is accepted.
+     */
+    bool waitClient( const int timeout_msec );
+
+    /*!
+      \brief send the next data line to the client
+      \return false if no line remains or failed to send.
+     */
+    bool sendNext();
+
+    /*!
+      \brief send all remaining lines. wait the interval after each show line.
+      \return the number of sent lines
+     */
+    std::size_t replay();
+
+    /*!
+      \brief set the wait interval after each show line
+      \param interval_msec interval by milli second. 0 means no wait.
+     */
+    void setInterval( const int interval_msec )
+      {
+          M_interval_msec = std::max( 0, interval_msec );
+      }
+
+    /*!
+      \brief check if a client has been accepted
+      \return checked result
+     */
+    bool isConnected() const
+      {
+          return M_connected;
+      }
+
+    /*!
+      \brief check if all lines have been sent
+      \return checked result
+     */
+    bool isFinished() const
+      {
+          return M_index >= M_lines.size();
+      }
+
+    /*!
+      \brief get the rcg version of the loaded data
+      \return rcg version number
+     */
+    int version() const
+      {
+          return M_version;
+      }
+
+    /*!
+      \brief get the loaded data lines
+      \return const reference to the container
+     */
+    const std::vector< std::string > & lines() const
+      {
+          return M_lines;
+      }
+};
+
+}
+
+#endif
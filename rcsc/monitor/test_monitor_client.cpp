@@ -0,0 +1,334 @@
+// -*-c++-*-
+
+/*!
+  \file test_monitor_client.cpp
+  \brief test code for rcsc::MonitorClient
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "monitor_client.h"
+#include "monitor_replayer.h"
+
+#include <rcsc/rcg/handler.h>
+#include <rcsc/rcg/serializer.h>
+#include <rcsc/rcg/types.h>
+#include <rcsc/time/timer.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+/*!
+  \brief count the dispatched data
+ */
+class CountHandler
+    : public rcsc::rcg::Handler {
+public:
+
+    std::vector< rcsc::rcg::ShowInfoT > shows_;
+    int playmode_count_;
+    int team_count_;
+
+    CountHandler()
+        : playmode_count_( 0 ),
+          team_count_( 0 )
+      { }
+
+    bool handleEOF() override { return true; }
+    bool handleShow( const rcsc::rcg::ShowInfoT & show ) override
+      {
+          shows_.push_back( show );
+          return true;
+      }
+    bool handleMsg( const int, const int, const std::string & ) override { return true; }
+    bool handleDraw( const int, const rcsc::rcg::drawinfo_t & ) override { return true; }
+    bool handlePlayMode( const int, const rcsc::PlayMode ) override
+      {
+          ++playmode_count_;
+          return true;
+      }
+    bool handleTeam( const int,
+                     const rcsc::rcg::TeamT &,
+                     const rcsc::rcg::TeamT & ) override
+      {
+          ++team_count_;
+          return true;
+      }
+    bool handleServerParam( const rcsc::rcg::ServerParamT & ) override { return true; }
+    bool handlePlayerParam( const rcsc::rcg::PlayerParamT & ) override { return true; }
+    bool handlePlayerType( const rcsc::rcg::PlayerTypeT & ) override { return true; }
+    bool handleTeamGraphic( const char, const int, const int,
+                            const std::vector< std::string > & ) override { return true; }
+};
+
+/*!
+  \brief create the rcg v5 data
+ */
+void
+create_rcg( const int n_show,
+            std::ostream & os )
+{
+    rcsc::rcg::Serializer::Ptr serializer = rcsc::rcg::Serializer::create( rcsc::rcg::REC_VERSION_5 );
+
+    serializer->serializeBegin( os, "test", "" );
+
+    rcsc::rcg::TeamT team_l;
+    rcsc::rcg::TeamT team_r;
+    team_l.name_ = "left";
+    team_r.name_ = "right";
+
+    os << "(playmode 1 play_on)\n";
+    serializer->serialize( os, team_l, team_r );
+
+    for ( int t = 1; t <= n_show; ++t )
+    {
+        rcsc::rcg::ShowInfoT show;
+        show.time_ = t;
+        show.ball_.x_ = 0.01f * t;
+        show.ball_.y_ = -0.01f * t;
+        show.ball_.vx_ = 0.5f;
+        show.ball_.vy_ = 0.0f;
+        for ( int i = 0; i < rcsc::MAX_PLAYER * 2; ++i )
+        {
+            rcsc::rcg::PlayerT & p = show.player_[i];
+            p.side_ = ( i < rcsc::MAX_PLAYER ? 'l' : 'r' );
+            p.unum_ = i % rcsc::MAX_PLAYER + 1;
+            p.state_ = rcsc::rcg::STAND;
+            p.x_ = ( i < rcsc::MAX_PLAYER ? -1.0f : 1.0f ) * ( i % rcsc::MAX_PLAYER + 1 );
+            p.y_ = 0.1f * t;
+            p.stamina_ = 8000.0f;
+            p.effort_ = 1.0f;
+            p.recovery_ = 1.0f;
+            p.stamina_capacity_ = 130600.0f;
+        }
+
+        serializer->serialize( os, show );
+    }
+}
+
+}
+
+class MonitorClientTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( MonitorClientTest );
+    CPPUNIT_TEST( testDispatch );
+    CPPUNIT_TEST( testReplay );
+    CPPUNIT_TEST( testFrameBuffer );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testDispatch();
+    void testReplay();
+    void testFrameBuffer();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( MonitorClientTest );
+
+/*-------------------------------------------------------------------*/
+void
+MonitorClientTest::testDispatch()
+{
+    std::stringstream ss;
+    create_rcg( 6000, ss );
+
+    rcsc::MonitorReplayer replayer;
+    CPPUNIT_ASSERT( replayer.open( ss ) );
+    CPPUNIT_ASSERT_EQUAL( rcsc::rcg::REC_VERSION_5, replayer.version() );
+
+    CountHandler handler;
+    handler.handleLogVersion( rcsc::rcg::REC_VERSION_5 );
+    rcsc::MonitorClient client( &handler );
+
+    // without network
+    rcsc::Timer timer;
+    for ( const std::string & line : replayer.lines() )
+    {
+        CPPUNIT_ASSERT( client.dispatch( line.c_str(), line.length() + 1 ) );
+    }
+    const double elapsed = timer.elapsedReal();
+
+    std::cout << "\n" << replayer.lines().size() << " datagrams dispatched. elapsed "
+              << elapsed << " [ms] ("
+              << elapsed * 1000.0 / replayer.lines().size() << " [us/datagram])" << std::endl;
+
+    CPPUNIT_ASSERT_EQUAL( 6000, static_cast< int >( handler.shows_.size() ) );
+    CPPUNIT_ASSERT_EQUAL( 1, handler.playmode_count_ );
+    CPPUNIT_ASSERT_EQUAL( 1, handler.team_count_ );
+    CPPUNIT_ASSERT_EQUAL( 0L, client.errorCount() );
+    CPPUNIT_ASSERT( elapsed / replayer.lines().size() < 1.0 );
+
+    CPPUNIT_ASSERT( client.frameBuffer().fetch() );
+    const rcsc::MonitorFrame & frame = client.frameBuffer().frame();
+    CPPUNIT_ASSERT_EQUAL( 6000L, frame.seq_ );
+    CPPUNIT_ASSERT_EQUAL( 6000, static_cast< int >( frame.show_.time_ ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 60.0, frame.show_.ball_.x_, 1.0e-3 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 600.0, frame.show_.player_[0].y_, 1.0e-2 );
+    CPPUNIT_ASSERT_EQUAL( rcsc::PM_PlayOn, frame.playmode_ );
+    CPPUNIT_ASSERT_EQUAL( std::string( "left" ), frame.team_l_.name_ );
+    CPPUNIT_ASSERT_EQUAL( std::string( "right" ), frame.team_r_.name_ );
+    CPPUNIT_ASSERT( ! client.frameBuffer().fetch() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+MonitorClientTest::testReplay()
+{
+    std::stringstream ss;
+    create_rcg( 100, ss );
+
+    rcsc::MonitorReplayer replayer;
+    CPPUNIT_ASSERT( replayer.open( ss ) );
+    CPPUNIT_ASSERT( replayer.bind( 0 ) );
+    CPPUNIT_ASSERT( replayer.port() > 0 );
+
+    CountHandler handler;
+    rcsc::MonitorClient client( &handler );
+    CPPUNIT_ASSERT( client.connectTo( "127.0.0.1", replayer.port(), 4 ) );
+    CPPUNIT_ASSERT( replayer.waitClient( 1000 ) );
+    CPPUNIT_ASSERT_EQUAL( rcsc::rcg::REC_VERSION_5, handler.logVersion() );
+
+    while ( replayer.sendNext() )
+    {
+        int n = 0;
+        for ( int i = 0; i < 100000 && n == 0; ++i )
+        {
+            n = client.receiveMessage();
+        }
+        CPPUNIT_ASSERT( n > 0 );
+    }
+
+    CPPUNIT_ASSERT( replayer.isFinished() );
+    CPPUNIT_ASSERT_EQUAL( 100, static_cast< int >( handler.shows_.size() ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, handler.shows_.back().ball_.x_, 1.0e-3 );
+
+    CPPUNIT_ASSERT( client.frameBuffer().fetch() );
+    CPPUNIT_ASSERT_EQUAL( 100, static_cast< int >( client.frameBuffer().frame().show_.time_ ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+MonitorClientTest::testFrameBuffer()
+{
+    const int n_frame = 200000;
+
+    rcsc::MonitorFrameBuffer buffer;
+
+    std::thread writer( [&]()
+                        {
+                            for ( int t = 1; t <= n_frame; ++t )
+                            {
+                                rcsc::MonitorFrame & frame = buffer.writeBuffer();
+                                frame.show_.time_ = t;
+                                for ( int i = 0; i < rcsc::MAX_PLAYER * 2; ++i )
+                                {
+                                    frame.show_.player_[i].x_ = static_cast< float >( t );
+                                }
+                                frame.show_.ball_.x_ = static_cast< float >( t );
+                                buffer.publish();
+                                if ( t % 16 == 0 )
+                                {
+                                    std::this_thread::yield();
+                                }
+                            }
+                        } );
+
+    long last_seq = 0;
+    long fetch_count = 0;
+    bool consistent = true;
+    while ( last_seq < n_frame )
+    {
+        if ( ! buffer.fetch() )
+        {
+            continue;
+        }
+
+        const rcsc::MonitorFrame & frame = buffer.frame();
+        if ( frame.seq_ <= last_seq
+             || frame.seq_ != static_cast< long >( frame.show_.time_ )
+             || frame.show_.ball_.x_ != static_cast< float >( frame.show_.time_ )
+             || frame.show_.player_[0].x_ != frame.show_.ball_.x_
+             || frame.show_.player_[rcsc::MAX_PLAYER * 2 - 1].x_ != frame.show_.ball_.x_ )
+        {
+            consistent = false;
+        }
+
+        last_seq = frame.seq_;
+        ++fetch_count;
+    }
+
+    writer.join();
+
+    std::cout << "\n" << fetch_count << " of " << n_frame << " frames fetched." << std::endl;
+
+    CPPUNIT_ASSERT( consistent );
+    CPPUNIT_ASSERT_EQUAL( static_cast< long >( n_frame ), last_seq );
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -157,6 +157,15 @@ AbstractSocket::bind( const HostAddress::PortNumber port )
         return false;
     }
 
+    // if port 0 is given, the number assigned by the system is recorded.
+    socklen_t addr_size = sizeof( HostAddress::AddrType );
+    if ( ::getsockname( fd(),
+                        reinterpret_cast< struct sockaddr * >( &my_addr ),
+                        &addr_size ) < 0 )
+    {
+        my_addr.sin_port = htons( port );
+    }
+
     M_local_address.setAddress( my_addr );
     return true;
 }
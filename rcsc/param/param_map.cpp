@@ -37,33 +37,12 @@
 
 #include <sstream>
 #include <algorithm>
+#include <stdexcept>
 
 namespace rcsc {
 
 namespace {
 
-/*-------------------------------------------------------------------*/
-inline
-bool
-is_true( const std::string & value_str )
-{
-    return ( value_str == "true"
-             || value_str == "on"
-             || value_str == "1"
-             || value_str == "yes" );
-}
-
-/*-------------------------------------------------------------------*/
-inline
-bool
-is_false( const std::string & value_str )
-{
-    return ( value_str == "false"
-             || value_str == "off"
-             || value_str == "0"
-             || value_str == "no" );
-}
-
 /*-------------------------------------------------------------------*/
 struct IsSwitch {
 
@@ -111,38 +90,39 @@ struct IsSwitch {
 
 /*-------------------------------------------------------------------*/
 struct ValueParser {
-    const std::string & value_str;
+    std::string_view value_str;
 
-    ValueParser( const std::string & str )
+    ValueParser( std::string_view str )
         : value_str( str )
       { }
 
     void operator()( int * ptr )
       {
-          *ptr = std::stoi( value_str );
+          if ( ! parse_param_value( value_str, ptr ) )
+          {
+              throw( std::invalid_argument( "Illegal integer string." ) );
+          }
       }
 
     void operator()( size_t * ptr )
       {
-          *ptr = std::stoul( value_str );
+          if ( ! parse_param_value( value_str, ptr ) )
+          {
+              throw( std::invalid_argument( "Illegal integer string." ) );
+          }
       }
 
     void operator()( double * ptr )
       {
-          *ptr = std::stod( value_str );
+          if ( ! parse_param_value( value_str, ptr ) )
+          {
+              throw( std::invalid_argument( "Illegal double string." ) );
+          }
       }
 
     void operator()( bool * ptr )
       {
-          if ( is_true( value_str ) )
-          {
-              *ptr = true;
-          }
-          else if ( is_false( value_str ) )
-          {
-              *ptr = false;
-          }
-          else
+          if ( ! parse_param_value( value_str, ptr ) )
           {
               throw( std::invalid_argument( "Unknown bool string." ) );
           }
@@ -150,18 +130,12 @@ struct ValueParser {
 
     void operator()( NegateBool ptr )
       {
-          if ( is_true( value_str ) )
-          {
-              *(ptr.ptr_) = false;
-          }
-          else if ( is_false( value_str ) )
-          {
-              *(ptr.ptr_) = true;
-          }
-          else
+          bool value = false;
+          if ( ! parse_param_value( value_str, &value ) )
           {
               throw( std::invalid_argument( "Unknown bool string." ) );
           }
+          *(ptr.ptr_) = ! value;
       }
 
     void operator()( BoolSwitch ptr )
@@ -176,7 +150,7 @@ struct ValueParser {
 
     void operator()( std::string * ptr )
       {
-          *ptr = value_str;
+          ptr->assign( value_str.data(), value_str.length() );
       }
 
 };
@@ -294,7 +268,7 @@ ParamEntity::isSwitch() const
 
 /*-------------------------------------------------------------------*/
 bool
-ParamEntity::analyze( const std::string & value_str )
+ParamEntity::analyze( std::string_view value_str )
 {
     try
     {
@@ -459,6 +433,7 @@ ParamMap::add( ParamEntity::Ptr param )
     }
 
     M_parameters.push_back( param );
+    M_long_name_index_valid = false;
 
     M_long_name_map[ param->longName() ] = param;
 
@@ -481,6 +456,7 @@ ParamMap::remove( const std::string & long_name )
                                               return v->longName() == long_name;
                                           } ),
                         M_parameters.end() );
+    M_long_name_index_valid = false;
 
     Map::iterator it_long = M_long_name_map.find( long_name );
     if ( it_long != M_long_name_map.end() )
@@ -497,13 +473,25 @@ ParamMap::remove( const std::string & long_name )
 
 /*-------------------------------------------------------------------*/
 ParamEntity::Ptr
-ParamMap::findLongName( const std::string & long_name )
+ParamMap::findLongName( std::string_view long_name )
 {
-    Map::iterator it = M_long_name_map.find( long_name );
+    if ( ! M_long_name_index_valid )
+    {
+        std::vector< std::string_view > names;
+        names.reserve( M_parameters.size() );
+        for ( const ParamEntity::Ptr & p : M_parameters )
+        {
+            names.push_back( p->longName() );
+        }
 
-    if ( it != M_long_name_map.end() )
+        M_long_name_index.build( names );
+        M_long_name_index_valid = true;
+    }
+
+    const int idx = M_long_name_index.find( long_name );
+    if ( idx >= 0 )
     {
-        return it->second;
+        return M_parameters[idx];
     }
 
     return ParamEntity::Ptr();
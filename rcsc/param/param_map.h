@@ -32,10 +32,13 @@
 #ifndef RCSC_PARAM_PARAM_MAP_H
 #define RCSC_PARAM_PARAM_MAP_H
 
+#include <rcsc/param/param_table.h>
+
 #include <memory>
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <iostream>
 #include <cassert>
@@ -210,10 +213,10 @@ public:
     bool isSwitch() const;
 
     /*!
-      \brief pure virtual method. analyze value string.
+      \brief analyze value string without memory allocation except for the string parameter.
       \return boolean status of analysis result
     */
-    bool analyze( const std::string & value_str );
+    bool analyze( std::string_view value_str );
 
     /*!
       \brief print help name strings
@@ -303,6 +306,12 @@ private:
     //! short name option map
     Map M_short_name_map;
 
+    //! perfect hash index of long names. the index of M_parameters is returned.
+    ParamNameIndex M_long_name_index;
+
+    //! flag to rebuild M_long_name_index
+    bool M_long_name_index_valid;
+
 
     // no copyable
     ParamMap( const ParamMap & );
@@ -315,7 +324,8 @@ public:
      */
     ParamMap()
         : M_valid( true ),
-          M_registrar( *this )
+          M_registrar( *this ),
+          M_long_name_index_valid( false )
       { }
 
     /*!
@@ -326,7 +336,8 @@ public:
     ParamMap( const std::string & group_name )
         : M_valid( true ),
           M_registrar( *this ),
-          M_group_name( group_name )
+          M_group_name( group_name ),
+          M_long_name_index_valid( false )
       { }
 
     /*!
@@ -405,8 +416,11 @@ public:
       \brief get parameter entry that has the argument name
       \param long_name long version parameter name string
       \return parameter entry pointer. if not found, NULL is returned.
+
+      The name is looked up through the perfect hash index that is
+      rebuilt at the first call after the registration is changed.
      */
-    ParamEntity::Ptr findLongName( const std::string & long_name );
+    ParamEntity::Ptr findLongName( std::string_view long_name );
 
     /*!
       \brief get parameter entry that has the argument name
@@ -0,0 +1,368 @@
+// -*-c++-*-
+
+/*!
+  \file param_table.cpp
+  \brief perfect hashed parameter table Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "param_table.h"
+
+#include <limits>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace rcsc {
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class TerminatedString
+  \brief null terminated copy of the string view for the C library
+  functions. short strings are copied into the stack buffer.
+ */
+class TerminatedString {
+private:
+    char M_buf[64];
+    std::string M_long;
+    const char * M_str;
+public:
+    explicit
+    TerminatedString( std::string_view str )
+      {
+          if ( str.length() < sizeof( M_buf ) )
+          {
+              std::memcpy( M_buf, str.data(), str.length() );
+              M_buf[str.length()] = '\0';
+              M_str = M_buf;
+          }
+          else
+          {
+              M_long.assign( str.data(), str.length() );
+              M_str = M_long.c_str();
+          }
+      }
+
+    const char * c_str() const
+      {
+          return M_str;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+inline
+std::uint64_t
+ceil_pow2( const std::uint64_t n )
+{
+    std::uint64_t p = 1;
+    while ( p < n )
+    {
+        p <<= 1;
+    }
+    return p;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+parse_param_value( std::string_view str,
+                   int * value )
+{
+    const TerminatedString s( str );
+    char * end = nullptr;
+    errno = 0;
+    const long v = std::strtol( s.c_str(), &end, 10 );
+    if ( end == s.c_str()
+         || errno == ERANGE
+         || v < std::numeric_limits< int >::min()
+         || std::numeric_limits< int >::max() < v )
+    {
+        return false;
+    }
+
+    *value = static_cast< int >( v );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+parse_param_value( std::string_view str,
+                   std::size_t * value )
+{
+    const TerminatedString s( str );
+    char * end = nullptr;
+    errno = 0;
+    const unsigned long v = std::strtoul( s.c_str(), &end, 10 );
+    if ( end == s.c_str()
+         || errno == ERANGE )
+    {
+        return false;
+    }
+
+    *value = static_cast< std::size_t >( v );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+parse_param_value( std::string_view str,
+                   double * value )
+{
+    const TerminatedString s( str );
+    char * end = nullptr;
+    errno = 0;
+    const double v = std::strtod( s.c_str(), &end );
+    if ( end == s.c_str()
+         || errno == ERANGE )
+    {
+        return false;
+    }
+
+    *value = v;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+parse_param_value( std::string_view str,
+                   bool * value )
+{
+    if ( str == "true"
+         || str == "on"
+         || str == "1"
+         || str == "yes" )
+    {
+        *value = true;
+        return true;
+    }
+
+    if ( str == "false"
+         || str == "off"
+         || str == "0"
+         || str == "no" )
+    {
+        *value = false;
+        return true;
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::string
+unquote_param_value( std::string_view str )
+{
+    if ( ! is_quoted_param_value( str ) )
+    {
+        return std::string( str );
+    }
+
+    const char quote = str.front();
+    str = str.substr( 1, str.length() - 2 );
+
+    std::string result;
+    result.reserve( str.length() );
+
+    for ( std::string_view::size_type i = 0; i < str.length(); ++i )
+    {
+        // replace "\'" with "'", or "\"" with """
+        if ( str[i] == '\\'
+             && i + 1 < str.length()
+             && str[i + 1] == quote )
+        {
+            ++i;
+        }
+        result += str[i];
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ParamNameIndex::ParamNameIndex()
+    : M_bucket_mask( 0 ),
+      M_slot_mask( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ParamNameIndex::clear()
+{
+    M_names.clear();
+    M_seeds.clear();
+    M_slots.clear();
+    M_bucket_mask = 0;
+    M_slot_mask = 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParamNameIndex::build( const std::vector< std::string_view > & names )
+{
+    clear();
+
+    if ( names.empty() )
+    {
+        return true;
+    }
+
+    {
+        std::vector< std::string_view > sorted = names;
+        std::sort( sorted.begin(), sorted.end() );
+        if ( std::adjacent_find( sorted.begin(), sorted.end() ) != sorted.end() )
+        {
+            return false;
+        }
+    }
+
+    const std::uint32_t max_seed = 1 << 16;
+
+    std::vector< std::uint64_t > hashes;
+    hashes.reserve( names.size() );
+    for ( const std::string_view & n : names )
+    {
+        hashes.push_back( hash( n ) );
+    }
+
+    // load factor <= 0.5, about 4 names per bucket
+    for ( std::uint64_t slot_size = ceil_pow2( names.size() * 2 );
+          slot_size <= ( std::uint64_t( 1 ) << 30 );
+          slot_size <<= 1 )
+    {
+        const std::uint64_t bucket_size = std::max< std::uint64_t >( 1, slot_size / 8 );
+
+        std::vector< std::vector< std::int32_t > > buckets( bucket_size );
+        for ( std::size_t i = 0; i < hashes.size(); ++i )
+        {
+            buckets[( hashes[i] >> 32 ) & ( bucket_size - 1 )].push_back( static_cast< std::int32_t >( i ) );
+        }
+
+        std::vector< std::size_t > order( bucket_size );
+        for ( std::size_t b = 0; b < bucket_size; ++b )
+        {
+            order[b] = b;
+        }
+        std::stable_sort( order.begin(), order.end(),
+                          [&]( const std::size_t lhs, const std::size_t rhs )
+                            {
+                                return buckets[lhs].size() > buckets[rhs].size();
+                            } );
+
+        std::vector< std::uint32_t > seeds( bucket_size, 0 );
+        std::vector< std::int32_t > slots( slot_size, -1 );
+        std::vector< std::uint64_t > positions;
+
+        bool success = true;
+        for ( const std::size_t b : order )
+        {
+            const std::vector< std::int32_t > & items = buckets[b];
+            if ( items.empty() )
+            {
+                break;
+            }
+
+            bool found = false;
+            for ( std::uint32_t seed = 1; seed < max_seed && ! found; ++seed )
+            {
+                positions.clear();
+                found = true;
+                for ( const std::int32_t i : items )
+                {
+                    const std::uint64_t pos = mix( hashes[i], seed ) & ( slot_size - 1 );
+                    if ( slots[pos] >= 0
+                         || std::find( positions.begin(), positions.end(), pos ) != positions.end() )
+                    {
+                        found = false;
+                        break;
+                    }
+                    positions.push_back( pos );
+                }
+
+                if ( found )
+                {
+                    seeds[b] = seed;
+                    for ( std::size_t k = 0; k < items.size(); ++k )
+                    {
+                        slots[positions[k]] = items[k];
+                    }
+                }
+            }
+
+            if ( ! found )
+            {
+                success = false;
+                break;
+            }
+        }
+
+        if ( success )
+        {
+            M_names = names;
+            M_seeds.swap( seeds );
+            M_slots.swap( slots );
+            M_bucket_mask = bucket_size - 1;
+            M_slot_mask = slot_size - 1;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
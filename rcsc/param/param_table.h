@@ -0,0 +1,471 @@
+// -*-c++-*-
+
+/*!
+  \file param_table.h
+  \brief perfect hashed parameter table Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_PARAM_PARAM_TABLE_H
+#define RCSC_PARAM_PARAM_TABLE_H
+
+#include <initializer_list>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <iostream>
+#include <cstdint>
+#include <cstddef>
+
+namespace rcsc {
+
+/*!
+  \brief parse an integer value string without memory allocation.
+  \param str value string
+  \param value pointer to the result variable
+  \return true if success. the same strings as std::stoi are accepted.
+ */
+bool parse_param_value( std::string_view str,
+                        int * value );
+
+/*!
+  \brief parse an unsigned integer value string without memory allocation.
+  \param str value string
+  \param value pointer to the result variable
+  \return true if success. the same strings as std::stoul are accepted.
+ */
+bool parse_param_value( std::string_view str,
+                        std::size_t * value );
+
+/*!
+  \brief parse a floating point value string without memory allocation.
+  \param str value string
+  \param value pointer to the result variable
+  \return true if success. the same strings as std::stod are accepted.
+ */
+bool parse_param_value( std::string_view str,
+                        double * value );
+
+/*!
+  \brief parse a boolean value string.
+  \param str value string. "true", "on", "1", "yes" or "false", "off", "0", "no"
+  \param value pointer to the result variable
+  \return true if success
+ */
+bool parse_param_value( std::string_view str,
+                        bool * value );
+
+/*!
+  \brief check if the string is quoted by ' or "
+  \param str checked string
+  \return checked result
+ */
+inline
+bool
+is_quoted_param_value( std::string_view str )
+{
+    return ( str.length() >= 2
+             && ( str.front() == '\'' || str.front() == '"' )
+             && str.back() == str.front() );
+}
+
+/*!
+  \brief remove the quotation and the escape characters
+  \param str quoted value string
+  \return cleaned string. if str is not quoted, just a copy is returned.
+ */
+std::string unquote_param_value( std::string_view str );
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class ParamNameIndex
+  \brief minimal perfect hash index of a static parameter name set.
+
+  The index is built by the hash and displace method.  The names are
+  distributed to buckets by the FNV-1a hash value, and a displacement
+  seed is searched for each bucket, from the largest bucket, so that
+  all names are placed in different slots.  A lookup costs one hash
+  computation, two array accesses and one string comparison to reject
+  unknown names.
+
+  The index holds only string views, so the name strings must outlive
+  the index.
+ */
+class ParamNameIndex {
+private:
+
+    std::vector< std::string_view > M_names; //!< registered names
+    std::vector< std::uint32_t > M_seeds; //!< displacement seed for each bucket
+    std::vector< std::int32_t > M_slots; //!< slot -> name index, or -1
+    std::uint64_t M_bucket_mask; //!< bucket size - 1
+    std::uint64_t M_slot_mask; //!< slot size - 1
+
+public:
+
+    /*!
+      \brief create an empty index
+     */
+    ParamNameIndex();
+
+    /*!
+      \brief build the index
+      \param names name set. the index of the name is used as the result of find().
+      \return false if the names contain duplicated names
+     */
+    bool build( const std::vector< std::string_view > & names );
+
+    /*!
+      \brief clear all data
+     */
+    void clear();
+
+    /*!
+      \brief get the number of registered names
+      \return the number of registered names
+     */
+    std::size_t size() const
+      {
+          return M_names.size();
+      }
+
+    /*!
+      \brief find the name
+      \param name searched name
+      \return index of the name, or -1 if not found
+     */
+    int find( std::string_view name ) const
+      {
+          if ( M_slots.empty() )
+          {
+              return -1;
+          }
+
+          const std::uint64_t h = hash( name );
+          const int idx = M_slots[mix( h, M_seeds[( h >> 32 ) & M_bucket_mask] ) & M_slot_mask];
+          return ( idx >= 0 && M_names[idx] == name ) ? idx : -1;
+      }
+
+    /*!
+      \brief 64bit FNV-1a hash function
+      \param str source string
+      \return hash value
+     */
+    static
+    std::uint64_t hash( std::string_view str )
+      {
+          std::uint64_t h = 14695981039346656037ULL;
+          for ( const char c : str )
+          {
+              h ^= static_cast< unsigned char >( c );
+              h *= 1099511628211ULL;
+          }
+          return h;
+      }
+
+private:
+
+    static
+    std::uint64_t mix( std::uint64_t h,
+                       const std::uint32_t seed )
+      {
+          h ^= seed * 0x9e3779b97f4a7c15ULL;
+          h ^= h >> 33;
+          h *= 0xff51afd7ed558ccdULL;
+          h ^= h >> 33;
+          return h;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class ParamTable
+  \brief static table from the parameter name to the typed member
+  pointer of the parameter class T.
+
+  The table is intended to be created once per class as a function
+  local static variable, and shared by all instances.  All setters take
+  string views and never allocate memory except for the string type
+  parameters.
+ */
+template < typename T >
+class ParamTable {
+public:
+
+    //! typed member pointer
+    using MemberPtr = std::variant< int T::*, double T::*, bool T::*, std::string T::* >;
+
+    /*!
+      \struct Entry
+      \brief table entry
+     */
+    struct Entry {
+        std::string_view name_; //!< parameter name. must be a string literal
+        MemberPtr member_; //!< member pointer
+    };
+
+private:
+
+    //! message name used in error messages
+    std::string_view M_group_name;
+
+    //! entries sorted by name
+    std::vector< Entry > M_entries;
+
+    //! name index
+    ParamNameIndex M_index;
+
+public:
+
+    /*!
+      \brief create the table
+      \param group_name message name used in error messages
+      \param entries all entries
+     */
+    ParamTable( std::string_view group_name,
+                std::initializer_list< Entry > entries )
+        : M_group_name( group_name ),
+          M_entries( entries )
+      {
+          std::sort( M_entries.begin(), M_entries.end(),
+                     []( const Entry & lhs, const Entry & rhs )
+                       {
+                           return lhs.name_ < rhs.name_;
+                       } );
+
+          std::vector< std::string_view > names;
+          names.reserve( M_entries.size() );
+          for ( const Entry & e : M_entries )
+          {
+              names.push_back( e.name_ );
+          }
+
+          if ( ! M_index.build( names ) )
+          {
+              std::cerr << "(ParamTable) ERROR: duplicated parameter name in "
+                        << M_group_name << std::endl;
+          }
+      }
+
+    /*!
+      \brief get all entries sorted by name
+      \return const reference to the entry container
+     */
+    const std::vector< Entry > & entries() const
+      {
+          return M_entries;
+      }
+
+    /*!
+      \brief find the entry
+      \param name parameter name
+      \return pointer to the entry, or nullptr if not found
+     */
+    const Entry * find( std::string_view name ) const
+      {
+          const int idx = M_index.find( name );
+          return idx >= 0 ? &M_entries[idx] : nullptr;
+      }
+
+    /*!
+      \brief set the value string to the parameter.
+      \param obj target object
+      \param name parameter name
+      \param value value string. string type value can be quoted.
+      \return false if unknown parameter or illegal value
+     */
+    bool setValue( T & obj,
+                   std::string_view name,
+                   std::string_view value ) const
+      {
+          const Entry * e = find( name );
+          if ( ! e )
+          {
+              std::cerr << "Unsupported parameter. " << M_group_name
+                        << " (" << name << ' ' << value << ')' << std::endl;
+              return false;
+          }
+
+          if ( const auto * m = std::get_if< int T::* >( &e->member_ ) )
+          {
+              if ( ! parse_param_value( value, &( obj.**m ) ) )
+              {
+                  std::cerr << "Illegal integer value. " << M_group_name
+                            << " (" << name << ' ' << value << ')' << std::endl;
+                  return false;
+              }
+          }
+          else if ( const auto * m = std::get_if< double T::* >( &e->member_ ) )
+          {
+              if ( ! parse_param_value( value, &( obj.**m ) ) )
+              {
+                  std::cerr << "Illegal double value. " << M_group_name
+                            << " (" << name << ' ' << value << ')' << std::endl;
+                  return false;
+              }
+          }
+          else if ( const auto * m = std::get_if< bool T::* >( &e->member_ ) )
+          {
+              if ( ! parse_param_value( value, &( obj.**m ) ) )
+              {
+                  std::cerr << "Unknown bool value. " << M_group_name
+                            << " (" << name << ' ' << value << ')' << std::endl;
+              }
+          }
+          else if ( const auto * m = std::get_if< std::string T::* >( &e->member_ ) )
+          {
+              obj.**m = unquote_param_value( value );
+          }
+
+          return true;
+      }
+
+    /*!
+      \brief set the integer value to the integer, double or bool parameter
+      \param obj target object
+      \param name parameter name
+      \param value parameter value
+      \return false if unsupported parameter
+     */
+    bool setInt( T & obj,
+                 std::string_view name,
+                 const int value ) const
+      {
+          if ( const Entry * e = find( name ) )
+          {
+              if ( const auto * m = std::get_if< int T::* >( &e->member_ ) )
+              {
+                  obj.**m = value;
+                  return true;
+              }
+              if ( const auto * m = std::get_if< double T::* >( &e->member_ ) )
+              {
+                  obj.**m = static_cast< double >( value );
+                  return true;
+              }
+              if ( const auto * m = std::get_if< bool T::* >( &e->member_ ) )
+              {
+                  obj.**m = ( value != 0 );
+                  return true;
+              }
+          }
+
+          std::cerr << "Unsupported parameter. name=" << name << " value=" << value << std::endl;
+          return false;
+      }
+
+    /*!
+      \brief set the double value to the double parameter
+      \param obj target object
+      \param name parameter name
+      \param value parameter value
+      \return false if unsupported parameter
+     */
+    bool setDouble( T & obj,
+                    std::string_view name,
+                    const double value ) const
+      {
+          return setTyped< double >( obj, name, value, "Unsupported parameter." );
+      }
+
+    /*!
+      \brief set the bool value to the bool parameter
+      \param obj target object
+      \param name parameter name
+      \param value parameter value
+      \return false if unsupported parameter
+     */
+    bool setBool( T & obj,
+                  std::string_view name,
+                  const bool value ) const
+      {
+          return setTyped< bool >( obj, name, value, "Unsupported bool parameter." );
+      }
+
+    /*!
+      \brief set the string value to the string parameter as is
+      \param obj target object
+      \param name parameter name
+      \param value parameter value
+      \return false if unsupported parameter
+     */
+    bool setString( T & obj,
+                    std::string_view name,
+                    std::string_view value ) const
+      {
+          if ( const Entry * e = find( name ) )
+          {
+              if ( const auto * m = std::get_if< std::string T::* >( &e->member_ ) )
+              {
+                  ( obj.**m ).assign( value.data(), value.length() );
+                  return true;
+              }
+          }
+
+          std::cerr << "Unsupported string parameter. name=" << name << " value=" << value << std::endl;
+          return false;
+      }
+
+    /*!
+      \brief copy all registered parameters
+      \param from source object
+      \param to destination object
+     */
+    void copy( const T & from,
+               T & to ) const
+      {
+          for ( const Entry & e : M_entries )
+          {
+              std::visit( [&]( auto m ) { to.*m = from.*m; }, e.member_ );
+          }
+      }
+
+private:
+
+    template < typename V >
+    bool setTyped( T & obj,
+                   std::string_view name,
+                   const V value,
+                   const char * error_message ) const
+      {
+          if ( const Entry * e = find( name ) )
+          {
+              if ( const auto * m = std::get_if< V T::* >( &e->member_ ) )
+              {
+                  obj.**m = value;
+                  return true;
+              }
+          }
+
+          std::cerr << error_message << " name=" << name << " value=" << value << std::endl;
+          return false;
+      }
+};
+
+}
+
+#endif
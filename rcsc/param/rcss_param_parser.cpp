@@ -36,6 +36,7 @@
 #include "rcss_param_parser.h"
 
 #include "param_map.h"
+#include "param_table.h"
 
 #include <iostream>
 #include <cstdio>
@@ -81,9 +82,11 @@ RCSSParamParser::parse( ParamMap & param_map )
         // get parameter entry from map
         ParamEntity::Ptr param_ptr = param_map.findLongName( it->first );
 
-        // analyze value string
+        // analyze value string. only the quoted value is copied.
         if ( param_ptr
-             && param_ptr->analyze( it->second ) )
+             && ( is_quoted_param_value( it->second )
+                  ? param_ptr->analyze( unquote_param_value( it->second ) )
+                  : param_ptr->analyze( it->second ) ) )
         {
             ++n_params;
         }
@@ -103,63 +106,6 @@ RCSSParamParser::parse( ParamMap & param_map )
     return true;
 }
 
-/*-------------------------------------------------------------------*/
-/*!
-
- */
-std::string
-RCSSParamParser::cleanString( std::string str )
-{
-    if( str.empty() )
-    {
-        return str;
-    }
-
-    if ( *str.begin() == '\'' )
-    {
-        if( *str.rbegin() == '\''  )
-        {
-            str = str.substr( 1, str.length() - 2 );
-        }
-        else
-        {
-            return str;
-        }
-
-        // replace escape character
-        for ( std::string::size_type escape_pos = str.find( "\\'" );
-              escape_pos != std::string::npos;
-              escape_pos = str.find( "\\'" ) )
-        {
-            // replace "\'" with "'"
-            str.replace( escape_pos, 2, "'" );
-        }
-    }
-    else if ( *str.begin() == '"' )
-    {
-        if ( *str.rbegin() == '"'  )
-        {
-            str = str.substr( 1, str.length() - 2 );
-        }
-        else
-        {
-            return str;
-        }
-
-        // replace escape character
-        for ( std::string::size_type escape_pos = str.find( "\\\"" );
-              escape_pos != std::string::npos;
-              escape_pos = str.find( "\\\"" ) )
-        {
-            // replace "\"" with """
-            str.replace( escape_pos, 2, "\"" );
-        }
-    }
-
-    return str;
-}
-
-
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -178,14 +124,15 @@ RCSSParamParser::init( const char * msg )
 
     M_param_name = buf;
 
-    const std::string msg_str( msg );
+    M_message = msg;
+    const std::string_view msg_str( M_message );
 
-    for ( std::string::size_type pos = msg_str.find_first_of( '(', n_read );
-          pos != std::string::npos;
+    for ( std::string_view::size_type pos = msg_str.find_first_of( '(', n_read );
+          pos != std::string_view::npos;
           pos = msg_str.find_first_of( '(', pos ) )
     {
-        std::string::size_type end_pos = msg_str.find_first_of( ' ', pos );
-        if ( end_pos == std::string::npos )
+        std::string_view::size_type end_pos = msg_str.find_first_of( ' ', pos );
+        if ( end_pos == std::string_view::npos )
         {
             std::cerr << __FILE__ << ": ***ERROR*** "
                       << "Failed to parse parameter name. " << msg << std::endl;
@@ -193,12 +140,12 @@ RCSSParamParser::init( const char * msg )
         }
 
         pos += 1;
-        const std::string name_str( msg_str, pos, end_pos - pos );
+        const std::string_view name_str = msg_str.substr( pos, end_pos - pos );
 
         pos = end_pos;
         // search end paren or double quatation
         end_pos = msg_str.find_first_of( ")\"", end_pos ); //"
-        if ( end_pos == std::string::npos )
+        if ( end_pos == std::string_view::npos )
         {
             std::cerr << __FILE__ << ": ***ERROR*** "
                       << "Failed to parse parameter value for [" << name_str << "] in "
@@ -211,7 +158,7 @@ RCSSParamParser::init( const char * msg )
         {
             pos = end_pos;
             end_pos = msg_str.find_first_of( '\"', end_pos + 1 ); //"
-            if ( end_pos == std::string::npos )
+            if ( end_pos == std::string_view::npos )
             {
                 std::cerr << __FILE__ << ": ***ERROR*** "
                           << "Failed to parse string parameter value for [" << name_str << "] in "
@@ -225,10 +172,7 @@ RCSSParamParser::init( const char * msg )
             pos += 1; // skip white space
         }
 
-        std::string value_str( msg_str, pos, end_pos - pos );
-        value_str = cleanString( value_str );
-
-        M_str_pairs.push_back( std::make_pair( name_str, value_str ) );
+        M_str_pairs.emplace_back( name_str, msg_str.substr( pos, end_pos - pos ) );
 
         pos = end_pos;
     }
@@ -35,6 +35,7 @@
 #include <rcsc/param/param_parser.h>
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 
@@ -47,16 +48,21 @@ namespace rcsc {
 class RCSSParamParser
     : public ParamParser {
 private:
-    typedef std::vector< std::pair< std::string, std::string > > StrPairVec;
+    typedef std::vector< std::pair< std::string_view, std::string_view > > StrPairVec;
 
     //! parameter type name (server_param, player_param ...)
     std::string M_param_name;
 
-    //! container of string pair(parameter name and value)
+    //! copy of the raw message. M_str_pairs refers to this buffer.
+    std::string M_message;
+
+    //! container of string pair(parameter name and value). quoted values are kept as is.
     StrPairVec M_str_pairs;
 
     //! not used
     RCSSParamParser() = delete;
+    RCSSParamParser( const RCSSParamParser & ) = delete;
+    RCSSParamParser & operator=( const RCSSParamParser & ) = delete;
 public:
     /*!
       \brief construct with original command line arguments
@@ -75,13 +81,6 @@ public:
 
 private:
 
-    /*!
-      \brief remove escaped quatation character from string.
-      \param str string variable to be checked
-      \return clened string
-     */
-    std::string cleanString( std::string str );
-
     /*!
       \brief lexical analyze and create string pair vector
       \param msg raw server message string
@@ -0,0 +1,415 @@
+// -*-c++-*-
+
+/*!
+  \file test_param_table.cpp
+  \brief test code for rcsc::ParamNameIndex and rcsc::ParamTable
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "param_table.h"
+#include "param_map.h"
+#include "rcss_param_parser.h"
+
+#include <rcsc/common/player_type.h>
+#include <rcsc/rcg/types.h>
+#include <rcsc/time/timer.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+#include <iostream>
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+using namespace rcsc;
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+std::vector< std::string >
+create_names( const int size )
+{
+    std::vector< std::string > names;
+    for ( int i = 0; i < size; ++i )
+    {
+        names.push_back( "param_" + std::to_string( i * 7 ) + ( i % 2 == 0 ? "_min" : "_max" ) );
+    }
+    return names;
+}
+
+/*-------------------------------------------------------------------*/
+struct TestParam {
+    int int_;
+    double double_;
+    bool bool_;
+    std::string string_;
+};
+
+}
+
+/*-------------------------------------------------------------------*/
+
+class ParamTableTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( ParamTableTest );
+    CPPUNIT_TEST( testIndex );
+    CPPUNIT_TEST( testValue );
+    CPPUNIT_TEST( testTable );
+    CPPUNIT_TEST( testParamMap );
+    CPPUNIT_TEST( testMessage );
+    CPPUNIT_TEST( testBenchmark );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testIndex();
+    void testValue();
+    void testTable();
+    void testParamMap();
+    void testMessage();
+    void testBenchmark();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ParamTableTest );
+
+/*-------------------------------------------------------------------*/
+void
+ParamTableTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+ParamTableTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+ParamTableTest::testIndex()
+{
+    for ( const int size : { 1, 2, 3, 29, 250, 2000 } )
+    {
+        const std::vector< std::string > names = create_names( size );
+        const std::vector< std::string_view > views( names.begin(), names.end() );
+
+        ParamNameIndex index;
+        CPPUNIT_ASSERT( index.build( views ) );
+        CPPUNIT_ASSERT_EQUAL( names.size(), index.size() );
+
+        for ( int i = 0; i < size; ++i )
+        {
+            CPPUNIT_ASSERT_EQUAL( i, index.find( names[i] ) );
+            CPPUNIT_ASSERT_EQUAL( -1, index.find( names[i] + "x" ) );
+            CPPUNIT_ASSERT_EQUAL( -1, index.find( std::string_view( names[i] ).substr( 1 ) ) );
+        }
+
+        CPPUNIT_ASSERT_EQUAL( -1, index.find( "" ) );
+        CPPUNIT_ASSERT_EQUAL( -1, index.find( "unknown" ) );
+    }
+
+    ParamNameIndex index;
+    CPPUNIT_ASSERT_EQUAL( -1, index.find( "param_0_min" ) );
+    CPPUNIT_ASSERT( ! index.build( { "a", "b", "a" } ) );
+    CPPUNIT_ASSERT_EQUAL( -1, index.find( "a" ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ParamTableTest::testValue()
+{
+    int i = 0;
+    CPPUNIT_ASSERT( parse_param_value( "-12", &i ) );
+    CPPUNIT_ASSERT_EQUAL( -12, i );
+    CPPUNIT_ASSERT( parse_param_value( std::string_view( "345)", 3 ), &i ) );
+    CPPUNIT_ASSERT_EQUAL( 345, i );
+    CPPUNIT_ASSERT( ! parse_param_value( "abc", &i ) );
+    CPPUNIT_ASSERT( ! parse_param_value( "", &i ) );
+    CPPUNIT_ASSERT( ! parse_param_value( "99999999999", &i ) );
+    CPPUNIT_ASSERT_EQUAL( 345, i );
+
+    std::size_t s = 0;
+    CPPUNIT_ASSERT( parse_param_value( "4096", &s ) );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 4096 ), s );
+
+    double d = 0.0;
+    CPPUNIT_ASSERT( parse_param_value( "1.25e-3", &d ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.25e-3, d, 1.0e-12 );
+    CPPUNIT_ASSERT( parse_param_value( std::string_view( "0.5 0.7", 3 ), &d ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5, d, 1.0e-12 );
+    CPPUNIT_ASSERT( parse_param_value( std::string( 100, '0' ) + "1", &d ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, d, 1.0e-12 );
+    CPPUNIT_ASSERT( ! parse_param_value( "x", &d ) );
+
+    bool b = false;
+    CPPUNIT_ASSERT( parse_param_value( "on", &b ) );
+    CPPUNIT_ASSERT( b );
+    CPPUNIT_ASSERT( parse_param_value( "0", &b ) );
+    CPPUNIT_ASSERT( ! b );
+    CPPUNIT_ASSERT( ! parse_param_value( "truee", &b ) );
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "abc" ), unquote_param_value( "abc" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "a\"b" ), unquote_param_value( "\"a\\\"b\"" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "it's" ), unquote_param_value( "'it\\'s'" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "\"abc" ), unquote_param_value( "\"abc" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string(), unquote_param_value( "\"\"" ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ParamTableTest::testTable()
+{
+    const ParamTable< TestParam > table( "test", {
+            { "int", &TestParam::int_ },
+            { "double", &TestParam::double_ },
+            { "bool", &TestParam::bool_ },
+            { "string", &TestParam::string_ }
+        } );
+
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 4 ), table.entries().size() );
+    CPPUNIT_ASSERT( table.entries().front().name_ == "bool" );
+    CPPUNIT_ASSERT( table.entries().back().name_ == "string" );
+
+    TestParam p = { 0, 0.0, false, "" };
+    CPPUNIT_ASSERT( table.setValue( p, "int", "7" ) );
+    CPPUNIT_ASSERT( table.setValue( p, "double", "2.5" ) );
+    CPPUNIT_ASSERT( table.setValue( p, "bool", "true" ) );
+    CPPUNIT_ASSERT( table.setValue( p, "string", "\"a b\"" ) );
+    CPPUNIT_ASSERT_EQUAL( 7, p.int_ );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.5, p.double_, 1.0e-12 );
+    CPPUNIT_ASSERT( p.bool_ );
+    CPPUNIT_ASSERT_EQUAL( std::string( "a b" ), p.string_ );
+
+    CPPUNIT_ASSERT( ! table.setValue( p, "unknown", "1" ) );
+    CPPUNIT_ASSERT( ! table.setValue( p, "int", "x" ) );
+    CPPUNIT_ASSERT_EQUAL( 7, p.int_ );
+
+    CPPUNIT_ASSERT( table.setInt( p, "double", 3 ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0, p.double_, 1.0e-12 );
+    CPPUNIT_ASSERT( table.setInt( p, "bool", 0 ) );
+    CPPUNIT_ASSERT( ! p.bool_ );
+    CPPUNIT_ASSERT( ! table.setDouble( p, "int", 1.0 ) );
+    CPPUNIT_ASSERT( table.setString( p, "string", "'q'" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "'q'" ), p.string_ );
+
+    TestParam q = { 0, 0.0, true, "" };
+    table.copy( p, q );
+    CPPUNIT_ASSERT_EQUAL( p.int_, q.int_ );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( p.double_, q.double_, 1.0e-12 );
+    CPPUNIT_ASSERT_EQUAL( p.bool_, q.bool_ );
+    CPPUNIT_ASSERT_EQUAL( p.string_, q.string_ );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ParamTableTest::testParamMap()
+{
+    int int_value = 0;
+    double double_value = 0.0;
+    bool bool_value = false;
+    std::string string_value;
+
+    ParamMap param_map( "test" );
+    param_map.add()
+        ( "int_value", "", &int_value )
+        ( "double_value", "", &double_value )
+        ( "bool_value", "", &bool_value )
+        ( "string_value", "", &string_value );
+
+    CPPUNIT_ASSERT( param_map.findLongName( "int_value" ) );
+    CPPUNIT_ASSERT( ! param_map.findLongName( "int_valu" ) );
+
+    RCSSParamParser parser( "(test (int_value 3) (double_value -0.25) (bool_value on) (string_value \"x (y)\"))" );
+    CPPUNIT_ASSERT( parser.parse( param_map ) );
+
+    CPPUNIT_ASSERT_EQUAL( 3, int_value );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( -0.25, double_value, 1.0e-12 );
+    CPPUNIT_ASSERT( bool_value );
+    CPPUNIT_ASSERT_EQUAL( std::string( "x (y)" ), string_value );
+
+    param_map.remove( "double_value" );
+    CPPUNIT_ASSERT( ! param_map.findLongName( "double_value" ) );
+    CPPUNIT_ASSERT( param_map.findLongName( "string_value" ) );
+    CPPUNIT_ASSERT( param_map.findLongName( "string_value" )->analyze( "z" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "z" ), string_value );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ParamTableTest::testMessage()
+{
+    const std::string msg = "(server_param (goal_width 15.5) (golden_goal 1) (foul_cycles 7)"
+        " (fixed_teamname_l \"Left Team\") (kickable_margin 0.8) (unknown_param 3))";
+
+    rcg::ServerParamT server_param( msg );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 15.5, server_param.goal_width_, 1.0e-12 );
+    CPPUNIT_ASSERT( server_param.golden_goal_ );
+    CPPUNIT_ASSERT_EQUAL( 7, server_param.foul_cycles_ );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Left Team" ), server_param.fixed_teamname_l_ );
+
+    std::ostringstream os1;
+    server_param.toServerString( os1 );
+
+    rcg::ServerParamT server_param2( os1.str() );
+    std::ostringstream os2;
+    server_param2.toServerString( os2 );
+    CPPUNIT_ASSERT_EQUAL( os1.str(), os2.str() );
+
+    rcg::PlayerTypeT player_type;
+    CPPUNIT_ASSERT( player_type.setValue( "id", "3" ) );
+    CPPUNIT_ASSERT( player_type.setValue( std::string_view( "kick_rand 0.1", 9 ), "0.1" ) );
+    CPPUNIT_ASSERT( ! player_type.setValue( "kick_rnd", "0.1" ) );
+    CPPUNIT_ASSERT_EQUAL( 3, player_type.id_ );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.1, player_type.kick_rand_, 1.0e-12 );
+
+    const rcg::PlayerTypeT player_type2 = player_type;
+    CPPUNIT_ASSERT_EQUAL( 3, player_type2.id_ );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.1, player_type2.kick_rand_, 1.0e-12 );
+
+    const PlayerType pt( "(player_type (id 2) (player_speed_max 1.1) (kickable_margin 0.75) (land_focus_dist_noise_rate 0.002))",
+                         19.0 );
+    CPPUNIT_ASSERT_EQUAL( 2, pt.id() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.1, pt.playerSpeedMax(), 1.0e-12 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.75, pt.kickableMargin(), 1.0e-12 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.002, pt.landFocusDistNoiseRate(), 1.0e-12 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ParamTableTest::testBenchmark()
+{
+    rcg::ServerParamT server_param;
+    std::ostringstream os;
+    server_param.toServerString( os );
+    const std::string msg = os.str();
+
+    std::vector< std::string_view > names;
+    for ( std::string::size_type pos = msg.find( '(', 1 );
+          pos != std::string::npos;
+          pos = msg.find( '(', pos + 1 ) )
+    {
+        names.push_back( std::string_view( msg ).substr( pos + 1, msg.find( ' ', pos ) - pos - 1 ) );
+    }
+
+    std::unordered_map< std::string, int > name_map;
+    for ( std::size_t i = 0; i < names.size(); ++i )
+    {
+        name_map.emplace( std::string( names[i] ), static_cast< int >( i ) );
+    }
+
+    ParamNameIndex index;
+    CPPUNIT_ASSERT( index.build( names ) );
+
+    const int max_loop = 20000;
+    long long sum_map = 0;
+    long long sum_index = 0;
+
+    {
+        Timer timer;
+        for ( int loop = 0; loop < max_loop; ++loop )
+        {
+            for ( const std::string_view & n : names )
+            {
+                sum_map += name_map.find( std::string( n ) )->second;
+            }
+        }
+        std::cout << "\nunordered_map< std::string > lookup elapsed "
+                  << timer.elapsedReal() << " [ms] for " << max_loop * names.size() << " names." << std::endl;
+    }
+
+    {
+        Timer timer;
+        for ( int loop = 0; loop < max_loop; ++loop )
+        {
+            for ( const std::string_view & n : names )
+            {
+                sum_index += index.find( n );
+            }
+        }
+        std::cout << "ParamNameIndex lookup elapsed "
+                  << timer.elapsedReal() << " [ms] for " << max_loop * names.size() << " names." << std::endl;
+    }
+
+    CPPUNIT_ASSERT_EQUAL( sum_map, sum_index );
+
+    {
+        const int parse_loop = 2000;
+        double total = 0.0;
+        Timer timer;
+        for ( int loop = 0; loop < parse_loop; ++loop )
+        {
+            rcg::ServerParamT p( msg );
+            total += p.goal_width_;
+        }
+        std::cout << "ServerParamT::fromServerString elapsed "
+                  << timer.elapsedReal() / parse_loop << " [ms]" << std::endl;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( server_param.goal_width_ * parse_loop, total, 1.0e-6 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -46,6 +46,8 @@
 #include <rcsc/common/server_param.h>
 #include <rcsc/common/logger.h>
 
+#include <algorithm>
+
 namespace rcsc {
 
 /*-------------------------------------------------------------------*/
@@ -102,47 +104,7 @@ ActionEffector::ActionEffector( const PlayerAgent & agent )
 */
 ActionEffector::~ActionEffector()
 {
-    if ( M_command_body )
-    {
-        delete M_command_body;
-        M_command_body = nullptr;
-    }
-
-    if ( M_command_turn_neck )
-    {
-        delete M_command_turn_neck;
-        M_command_turn_neck = nullptr;
-    }
-
-    if ( M_command_change_view )
-    {
-        delete M_command_change_view;
-        M_command_change_view = nullptr;
-    }
-
-    if ( M_command_change_focus )
-    {
-        delete M_command_change_focus;
-        M_command_change_focus = nullptr;
-    }
 
-    if ( M_command_say )
-    {
-        delete M_command_say;
-        M_command_say = nullptr;
-    }
-
-    if ( M_command_pointto )
-    {
-        delete M_command_pointto;
-        M_command_pointto = nullptr;
-    }
-
-    if ( M_command_attentionto )
-    {
-        delete M_command_attentionto;
-        M_command_attentionto = nullptr;
-    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -467,9 +429,44 @@ ActionEffector::checkCommandCount( const BodySensor & sense )
 /*!
 
 */
-std::ostream &
-ActionEffector::makeCommand( std::ostream & to )
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief append the command string to the buffer.
+  if the buffer is too short, the command is dropped.
+*/
+inline
+char *
+append_command( const PlayerCommand & com,
+                char * first,
+                char * last )
 {
+    char * end = com.toCommandBuffer( first, last );
+    if ( ! end )
+    {
+        std::cerr << "(ActionEffector) command buffer overflow. type="
+                  << com.type() << std::endl;
+        dlog.addText( Logger::SYSTEM,
+                      __FILE__": command buffer overflow. type=%d", com.type() );
+        return first;
+    }
+    return end;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+const char *
+ActionEffector::makeCommand()
+{
+    // keep the last byte for the null terminator
+    char * first = M_command_buffer;
+    char * const last = M_command_buffer + COMMAND_BUFFER_SIZE - 1;
+
     M_last_body_command_type[1] = M_last_body_command_type[0];
 
     M_last_action_time = M_agent.world().time();
@@ -481,9 +478,8 @@ ActionEffector::makeCommand( std::ostream & to )
         {
             M_catch_time = M_agent.world().time();
         }
-        M_command_body->toCommandString( to );
+        first = append_command( *M_command_body, first, last );
         incCommandCount( M_command_body->type() );
-        delete M_command_body;
         M_command_body = nullptr;
     }
     else
@@ -498,7 +494,7 @@ ActionEffector::makeCommand( std::ostream & to )
                       << "  WARNING. no body command." << std::endl;
             // register dummy command
             PlayerTurnCommand turn( 0 );
-            turn.toCommandString( to );
+            first = append_command( turn, first, last );
             incCommandCount( PlayerCommand::TURN );
         }
     }
@@ -506,109 +502,81 @@ ActionEffector::makeCommand( std::ostream & to )
     if ( M_command_turn_neck )
     {
         M_done_turn_neck = true;
-        M_command_turn_neck->toCommandString( to );
+        first = append_command( *M_command_turn_neck, first, last );
         incCommandCount( PlayerCommand::TURN_NECK );
-        delete M_command_turn_neck;
         M_command_turn_neck = nullptr;
     }
 
     if ( M_command_change_view )
     {
-        M_command_change_view->toCommandString( to );
+        first = append_command( *M_command_change_view, first, last );
         incCommandCount( PlayerCommand::CHANGE_VIEW );
-        delete M_command_change_view;
         M_command_change_view = nullptr;
     }
 
     if ( M_command_change_focus )
     {
-        M_command_change_focus->toCommandString( to );
+        first = append_command( *M_command_change_focus, first, last );
         incCommandCount( PlayerCommand::CHANGE_FOCUS );
-        delete M_command_change_focus;
         M_command_change_focus = nullptr;
     }
 
     if ( M_command_pointto )
     {
-        M_command_pointto->toCommandString( to );
+        first = append_command( *M_command_pointto, first, last );
         incCommandCount( PlayerCommand::POINTTO );
-        delete M_command_pointto;
         M_command_pointto = nullptr;
     }
 
     if ( M_command_attentionto )
     {
-        M_command_attentionto->toCommandString( to );
+        first = append_command( *M_command_attentionto, first, last );
         incCommandCount( PlayerCommand::ATTENTIONTO );
-        delete M_command_attentionto;
         M_command_attentionto = nullptr;
     }
 
     if ( ServerParam::i().synchMode() )
     {
         PlayerDoneCommand done_com;
-        done_com.toCommandString( to );
+        first = append_command( done_com, first, last );
     }
 
     makeSayCommand();
     if ( M_command_say )
     {
-        M_command_say->toCommandString( to );
+        first = append_command( *M_command_say, first, last );
         incCommandCount( PlayerCommand::SAY );
     }
 
-    return to;
+    *first = '\0';
+    return M_command_buffer;
 }
 
-
 /*-------------------------------------------------------------------*/
 /*!
 
 */
-void
-ActionEffector::clearAllCommands()
+std::ostream &
+ActionEffector::makeCommand( std::ostream & to )
 {
-    if ( M_command_body )
-    {
-        delete M_command_body;
-        M_command_body = nullptr;
-    }
-
-    if ( M_command_turn_neck )
-    {
-        delete M_command_turn_neck;
-        M_command_turn_neck = nullptr;
-    }
-
-    if ( M_command_change_view )
-    {
-        delete M_command_change_view;
-        M_command_change_view = nullptr;
-    }
+    return to << makeCommand();
+}
 
-    if ( M_command_change_focus )
-    {
-        delete M_command_change_focus;
-        M_command_change_focus = nullptr;
-    }
 
-    if ( M_command_pointto )
-    {
-        delete M_command_pointto;
-        M_command_pointto = nullptr;
-    }
-
-    if ( M_command_attentionto )
-    {
-        delete M_command_attentionto;
-        M_command_attentionto = nullptr;
-    }
+/*-------------------------------------------------------------------*/
+/*!
 
-    if ( M_command_say )
-    {
-        delete M_command_say;
-        M_command_say = nullptr;
-    }
+*/
+void
+ActionEffector::clearAllCommands()
+{
+    M_command_body = nullptr;
+    M_command_turn_neck = nullptr;
+    M_command_change_view = nullptr;
+    M_command_change_focus = nullptr;
+    M_command_pointto = nullptr;
+    M_command_attentionto = nullptr;
+    M_command_say = nullptr;
 
     M_say_message_cont.clear();
 }
@@ -661,12 +629,7 @@ ActionEffector::setKick( const double & power,
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_body )
-    {
-        delete M_command_body;
-        M_command_body = nullptr;
-    }
-    M_command_body = new PlayerKickCommand( command_power, rel_dir.degree() );
+    M_command_body = &M_body_command.emplace< PlayerKickCommand >( command_power, rel_dir.degree() );
 
     // set estimated action effect
     M_kick_accel.setPolar( command_power * M_agent.world().self().kickRate(),
@@ -852,12 +815,7 @@ ActionEffector::setDash( const double & power,
     //
     // create command object
     //
-    if ( M_command_body )
-    {
-        delete M_command_body;
-        M_command_body = nullptr;
-    }
-    M_command_body = new PlayerDashCommand( command_power, command_dir );
+    M_command_body = &M_body_command.emplace< PlayerDashCommand >( command_power, command_dir );
 
     //
     // set estimated command effect: accel magnitude
@@ -1023,13 +981,8 @@ ActionEffector::setDash( const double left_power,
     double right_command_dir = check_and_normalize_dash_dir( wm, right_dir.degree() );
 
     // create command object
-    if ( M_command_body )
-    {
-        delete M_command_body;
-        M_command_body = nullptr;
-    }
-    M_command_body = new PlayerDashCommand( left_command_power, left_command_dir,
-                                            right_command_power, right_command_dir );
+    M_command_body = &M_body_command.emplace< PlayerDashCommand >( left_command_power, left_command_dir,
+                                                                   right_command_power, right_command_dir );
 
     // estimate command effect
     double left_dir_rate = ServerParam::i().dashDirRate( left_command_dir );
@@ -1112,14 +1065,8 @@ ActionEffector::setTurn( const AngleDeg & moment )
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_body )
-    {
-        delete M_command_body;
-        M_command_body = nullptr;
-    }
-
     // moment is a command param, not a real moment.
-    M_command_body = new PlayerTurnCommand( command_moment );
+    M_command_body = &M_body_command.emplace< PlayerTurnCommand >( command_moment );
 
     // set estimated action effect
     /*
@@ -1254,12 +1201,7 @@ ActionEffector::setMove( const double & x,
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_body )
-    {
-        delete M_command_body;
-        M_command_body = nullptr;
-    }
-    M_command_body = new PlayerMoveCommand( command_x, command_y );
+    M_command_body = &M_body_command.emplace< PlayerMoveCommand >( command_x, command_y );
 
     M_move_pos.assign( command_x, command_y );
 }
@@ -1310,12 +1252,7 @@ ActionEffector::setCatch()
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_body )
-    {
-        delete M_command_body;
-        M_command_body = nullptr;
-    }
-    M_command_body = new PlayerCatchCommand( catch_angle.degree() );
+    M_command_body = &M_body_command.emplace< PlayerCatchCommand >( catch_angle.degree() );
 }
 
 /*-------------------------------------------------------------------*/
@@ -1382,12 +1319,7 @@ ActionEffector::setTackle( const double & power_or_dir,
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_body )
-    {
-        delete M_command_body;
-        M_command_body = nullptr;
-    }
-    M_command_body = new PlayerTackleCommand( actual_power_or_dir, foul );
+    M_command_body = &M_body_command.emplace< PlayerTackleCommand >( actual_power_or_dir, foul );
 
     // set estimated command effect
     M_tackle_power = actual_power_or_dir;
@@ -1471,12 +1403,7 @@ ActionEffector::setTurnNeck( const AngleDeg & moment )
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_turn_neck )
-    {
-        delete M_command_turn_neck;
-        M_command_turn_neck = nullptr;
-    }
-    M_command_turn_neck = new PlayerTurnNeckCommand( command_moment );
+    M_command_turn_neck = &M_turn_neck_command.emplace( command_moment );
 
     // set estimated command effect
     M_turn_neck_moment = command_moment;
@@ -1495,14 +1422,8 @@ ActionEffector::setChangeView( const ViewWidth & width )
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_change_view )
-    {
-        delete M_command_change_view;
-        M_command_change_view = nullptr;
-    }
-
-    M_command_change_view = new PlayerChangeViewCommand( width,
-                                                         ViewQuality::HIGH );
+    M_command_change_view = &M_change_view_command.emplace( width,
+                                                            ViewQuality::HIGH );
 }
 
 /*-------------------------------------------------------------------*/
@@ -1519,16 +1440,10 @@ ActionEffector::setChangeFocus( const double moment_dist,
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_change_focus )
-    {
-        delete M_command_change_focus;
-        M_command_change_focus = nullptr;
-    }
-
     double command_moment_dist = rint( moment_dist * 1000.0 ) * 0.001;
     double command_moment_dir = rint( moment_dir.degree() * 1000.0 ) * 0.001;
 
-    M_command_change_focus = new PlayerChangeFocusCommand( command_moment_dist, command_moment_dir );
+    M_command_change_focus = &M_change_focus_command.emplace( command_moment_dist, command_moment_dir );
 }
 
 /*-------------------------------------------------------------------*/
@@ -1616,13 +1531,8 @@ ActionEffector::setPointto( const double & x,
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_pointto )
-    {
-        delete M_command_pointto;
-        M_command_pointto = nullptr;
-    }
-    M_command_pointto = new PlayerPointtoCommand( target_rel.r(),
-                                                  target_rel.th().degree() );
+    M_command_pointto = &M_pointto_command.emplace( target_rel.r(),
+                                                    target_rel.th().degree() );
 
     // set estimated commadn effect
     M_pointto_pos = target_pos;
@@ -1640,12 +1550,7 @@ ActionEffector::setPointtoOff()
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_pointto )
-    {
-        delete M_command_pointto;
-        M_command_pointto = nullptr;
-    }
-    M_command_pointto = new PlayerPointtoCommand();
+    M_command_pointto = &M_pointto_command.emplace();
 
     // set estimated command effect
     M_pointto_pos.invalidate();
@@ -1665,17 +1570,11 @@ ActionEffector::setAttentionto( const SideID side,
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_attentionto )
-    {
-        delete M_command_attentionto;
-        M_command_attentionto = nullptr;
-    }
-
     M_command_attentionto
-        = new PlayerAttentiontoCommand( ( M_agent.world().ourSide() == side
-                                          ? PlayerAttentiontoCommand::OUR
-                                          : PlayerAttentiontoCommand::OPP ),
-                                        unum );
+        = &M_attentionto_command.emplace( ( M_agent.world().ourSide() == side
+                                            ? PlayerAttentiontoCommand::OUR
+                                            : PlayerAttentiontoCommand::OPP ),
+                                          unum );
 }
 
 /*-------------------------------------------------------------------*/
@@ -1690,12 +1589,7 @@ ActionEffector::setAttentiontoOff()
 
     //////////////////////////////////////////////////
     // create command object
-    if ( M_command_attentionto )
-    {
-        delete M_command_attentionto;
-        M_command_attentionto = nullptr;
-    }
-    M_command_attentionto = new PlayerAttentiontoCommand();
+    M_command_attentionto = &M_attentionto_command.emplace();
 }
 
 /*-------------------------------------------------------------------*/
@@ -1722,17 +1616,20 @@ ActionEffector::getSayMessageLength() const
 void
 ActionEffector::makeSayCommand()
 {
-    if ( M_command_say )
-    {
-        delete M_command_say;
-        M_command_say = nullptr;
-    }
+    M_command_say = nullptr;
 
     M_say_message.erase();
 
     // std::sort( M_say_message_cont.begin(), M_say_message_cont.end(),
     //            SayMessagePtrSorter() );
 
+    // the joint message fills the remaining budget, so it must be the last one.
+    std::stable_partition( M_say_message_cont.begin(), M_say_message_cont.end(),
+                           []( const SayMessage::Ptr & i )
+                           {
+                               return i->header() != JointMessageParser::sheader();
+                           } );
+
     for ( const SayMessage::Ptr & i : M_say_message_cont )
     {
         if ( ! i->appendTo( M_say_message ) )
@@ -1752,8 +1649,8 @@ ActionEffector::makeSayCommand()
         return;
     }
 
-    M_command_say = new PlayerSayCommand( M_say_message,
-                                          M_agent.config().version() );
+    M_command_say = &M_say_command.emplace( M_say_message,
+                                            M_agent.config().version() );
 
     dlog.addText( Logger::ACTION,
                   __FILE__" (makeSayCommand) say message [%s]",
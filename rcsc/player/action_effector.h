@@ -41,7 +41,9 @@
 #include <rcsc/types.h>
 
 #include <iostream>
+#include <optional>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace rcsc {
@@ -58,7 +60,29 @@ private:
     //! const reference to the PlayerAgent instance
     const PlayerAgent & M_agent;
 
-    //! pointer of body action for dynamic allocation
+    //! storage of the body command. only one body command is sent in one cycle.
+    std::variant< std::monostate,
+                  PlayerMoveCommand,
+                  PlayerDashCommand,
+                  PlayerTurnCommand,
+                  PlayerKickCommand,
+                  PlayerCatchCommand,
+                  PlayerTackleCommand > M_body_command;
+
+    //! storage of the turn_neck command
+    std::optional< PlayerTurnNeckCommand > M_turn_neck_command;
+    //! storage of the change_view command
+    std::optional< PlayerChangeViewCommand > M_change_view_command;
+    //! storage of the change_focus command
+    std::optional< PlayerChangeFocusCommand > M_change_focus_command;
+    //! storage of the say command
+    std::optional< PlayerSayCommand > M_say_command;
+    //! storage of the pointto command
+    std::optional< PlayerPointtoCommand > M_pointto_command;
+    //! storage of the attentionto command
+    std::optional< PlayerAttentiontoCommand > M_attentionto_command;
+
+    //! pointer to the registered body command in M_body_command, or NULL
     PlayerBodyCommand * M_command_body;
 
     //! left leg command
@@ -66,19 +90,23 @@ private:
     //! right leg command
     // PlayerLegCommand * M_command_right_leg;
 
-    //! pointer of turn_neck for dynamic allocation
+    //! pointer to the registered turn_neck command, or NULL
     PlayerTurnNeckCommand * M_command_turn_neck;
-    //! pointer of change_view for dynamic allocation
+    //! pointer to the registered change_view command, or NULL
     PlayerChangeViewCommand * M_command_change_view;
-    //! pointer of change_focus for dynamic allocation
+    //! pointer to the registered change_focus command, or NULL
     PlayerChangeFocusCommand * M_command_change_focus;
-    //! pointer of say for dynamic allocation
+    //! pointer to the registered say command, or NULL
     PlayerSayCommand * M_command_say;
-    //! pointer of pointto for dynamic allocation
+    //! pointer to the registered pointto command, or NULL
     PlayerPointtoCommand * M_command_pointto;
-    //! pointer to attentionto for dynamic allocation
+    //! pointer to the registered attentionto command, or NULL
     PlayerAttentiontoCommand * M_command_attentionto;
 
+    //! the size of the command buffer
+    static const std::size_t COMMAND_BUFFER_SIZE = 8192;
+    //! reusable buffer to compose the command string sent to the server
+    char M_command_buffer[COMMAND_BUFFER_SIZE];
 
     //! command counter
     int M_command_counter[PlayerCommand::ILLEGAL + 1];
@@ -171,17 +199,25 @@ public:
     */
     void checkCommandCount( const BodySensor & sense );
 
+    /*!
+      \brief make command string into the internal buffer and update last action time
+      \return null terminated command string. the buffer is reused in the next call.
+
+      After command string composition, all registered commands are released.
+    */
+    const char * makeCommand();
+
     /*!
       \brief make command string and update last action time
       \param to reference to the output stream
       \return reference to the output stream
 
-      After command string composition, all command objects are deleted.
+      After command string composition, all registered commands are released.
     */
     std::ostream & makeCommand( std::ostream & to );
 
     /*!
-      \brief delete all command objects and say messages.
+      \brief release all registered commands and say messages.
      */
     void clearAllCommands();
 
@@ -0,0 +1,193 @@
+// -*-c++-*-
+
+/*!
+  \file assignment_solver.cpp
+  \brief minimum cost assignment solver Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "assignment_solver.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+AssignmentSolver::AssignmentSolver()
+    : M_rows( 0 ),
+      M_cols( 0 ),
+      M_size( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AssignmentSolver::assign( const int rows,
+                          const int cols )
+{
+    M_rows = std::max( 0, rows );
+    M_cols = std::max( 0, cols );
+    M_size = std::max( M_rows, M_cols );
+
+    M_cost.assign( M_rows * M_cols, -1.0 );
+    M_assignment.assign( M_rows, -1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+AssignmentSolver::solve()
+{
+    std::fill( M_assignment.begin(), M_assignment.end(), -1 );
+
+    if ( M_rows == 0
+         || M_cols == 0 )
+    {
+        return 0;
+    }
+
+    //
+    // the disallowed pairs and the dummy rows/columns have the same big cost.
+    // it is greater than the sum of all allowed costs, so the number of
+    // allowed pairs in the result is always maximized.
+    //
+
+    double max_cost = 0.0;
+    for ( const double c : M_cost )
+    {
+        max_cost = std::max( max_cost, c );
+    }
+    const double dummy_cost = ( max_cost + 1.0 ) * ( M_size + 1 );
+
+    const int n = M_size;
+    const double inf = std::numeric_limits< double >::max();
+
+    M_u.assign( n + 1, 0.0 );
+    M_v.assign( n + 1, 0.0 );
+    M_p.assign( n + 1, 0 );
+    M_way.assign( n + 1, 0 );
+    M_min_v.resize( n + 1 );
+    M_used.resize( n + 1 );
+
+    for ( int i = 1; i <= n; ++i )
+    {
+        // find the augmenting path from the row i
+        M_p[0] = i;
+        int j0 = 0;
+        std::fill( M_min_v.begin(), M_min_v.end(), inf );
+        std::fill( M_used.begin(), M_used.end(), 0 );
+
+        do
+        {
+            M_used[j0] = 1;
+            const int i0 = M_p[j0];
+            double delta = inf;
+            int j1 = 0;
+
+            for ( int j = 1; j <= n; ++j )
+            {
+                if ( M_used[j] ) continue;
+
+                double cost = dummy_cost;
+                if ( i0 <= M_rows
+                     && j <= M_cols )
+                {
+                    const double c = M_cost[( i0 - 1 ) * M_cols + ( j - 1 )];
+                    if ( c >= 0.0 ) cost = c;
+                }
+
+                const double cur = cost - M_u[i0] - M_v[j];
+                if ( cur < M_min_v[j] )
+                {
+                    M_min_v[j] = cur;
+                    M_way[j] = j0;
+                }
+
+                // strict comparison. the smaller index is selected for ties.
+                if ( M_min_v[j] < delta )
+                {
+                    delta = M_min_v[j];
+                    j1 = j;
+                }
+            }
+
+            for ( int j = 0; j <= n; ++j )
+            {
+                if ( M_used[j] )
+                {
+                    M_u[M_p[j]] += delta;
+                    M_v[j] -= delta;
+                }
+                else
+                {
+                    M_min_v[j] -= delta;
+                }
+            }
+
+            j0 = j1;
+        }
+        while ( M_p[j0] != 0 );
+
+        // update the assignment along the path
+        do
+        {
+            const int j1 = M_way[j0];
+            M_p[j0] = M_p[j1];
+            j0 = j1;
+        }
+        while ( j0 != 0 );
+    }
+
+    int count = 0;
+    for ( int j = 1; j <= M_cols; ++j )
+    {
+        const int i = M_p[j];
+        if ( i < 1 || M_rows < i ) continue;
+
+        if ( M_cost[( i - 1 ) * M_cols + ( j - 1 )] < 0.0 ) continue;
+
+        M_assignment[i - 1] = j - 1;
+        ++count;
+    }
+
+    return count;
+}
+
+}
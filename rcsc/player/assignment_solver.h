@@ -0,0 +1,149 @@
+// -*-c++-*-
+
+/*!
+  \file assignment_solver.h
+  \brief minimum cost assignment solver Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_PLAYER_ASSIGNMENT_SOLVER_H
+#define RCSC_PLAYER_ASSIGNMENT_SOLVER_H
+
+#include <vector>
+
+namespace rcsc {
+
+/*!
+  \class AssignmentSolver
+  \brief minimum cost bipartite assignment by the Hungarian method.
+
+  The rows and columns are matched one-to-one.  Only the pairs given by
+  setCost() are allowed.  The solver first maximizes the number of the
+  assigned pairs and then minimizes the sum of their costs.  The time
+  complexity is O(n^3) where n is max(rows, cols).  The buffers are
+  reused by the next problem, so the solver should be kept alive while
+  the problem size does not grow.  The result depends only on the
+  problem, i.e., ties are always broken by the smaller index.
+ */
+class AssignmentSolver {
+private:
+    //! the number of rows
+    int M_rows;
+    //! the number of columns
+    int M_cols;
+    //! the size of the square problem, max(rows, cols)
+    int M_size;
+
+    //! cost matrix (M_rows x M_cols). negative value means a disallowed pair.
+    std::vector< double > M_cost;
+
+    //! row potential (1-indexed)
+    std::vector< double > M_u;
+    //! column potential (1-indexed)
+    std::vector< double > M_v;
+    //! row assigned to each column (1-indexed, 0 means none)
+    std::vector< int > M_p;
+    //! the previous column on the augmenting path
+    std::vector< int > M_way;
+    //! the minimum slack of each column
+    std::vector< double > M_min_v;
+    //! visited flag of each column
+    std::vector< char > M_used;
+
+    //! the result. assigned column of each row, or -1.
+    std::vector< int > M_assignment;
+
+    // not used
+    AssignmentSolver( const AssignmentSolver & ) = delete;
+    AssignmentSolver & operator=( const AssignmentSolver & ) = delete;
+
+public:
+
+    /*!
+      \brief create the empty solver
+     */
+    AssignmentSolver();
+
+    /*!
+      \brief clear the result and set the problem size. all pairs are disallowed.
+      \param rows the number of rows
+      \param cols the number of columns
+     */
+    void assign( const int rows,
+                 const int cols );
+
+    /*!
+      \brief allow the pair with the cost
+      \param row row index
+      \param col column index
+      \param cost non negative cost value
+     */
+    void setCost( const int row,
+                  const int col,
+                  const double cost )
+      {
+          M_cost[row * M_cols + col] = cost;
+      }
+
+    /*!
+      \brief get the number of rows
+      \return the number of rows
+     */
+    int rows() const
+      {
+          return M_rows;
+      }
+
+    /*!
+      \brief get the number of columns
+      \return the number of columns
+     */
+    int cols() const
+      {
+          return M_cols;
+      }
+
+    /*!
+      \brief solve the current problem
+      \return the number of the assigned pairs
+     */
+    int solve();
+
+    /*!
+      \brief get the result of the row
+      \param row row index
+      \return the assigned column index, or -1 if not assigned
+     */
+    int assignment( const int row ) const
+      {
+          return M_assignment[row];
+      }
+
+};
+
+}
+
+#endif
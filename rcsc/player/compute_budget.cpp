@@ -0,0 +1,93 @@
+// -*-c++-*-
+
+/*!
+  \file compute_budget.cpp
+  \brief per-cycle compute budget for the action decision Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "compute_budget.h"
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ComputeBudget::ComputeBudget()
+    : M_deadline(),
+      M_expired( false ),
+      M_search_count( 0 ),
+      M_truncated_count( 0 ),
+      M_total_cycle_count( 0 ),
+      M_total_truncated_cycle_count( 0 ),
+      M_total_search_count( 0 ),
+      M_total_truncated_count( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ComputeBudget::start( const TimeStamp & deadline )
+{
+    M_deadline = deadline;
+    M_expired = false;
+    M_search_count = 0;
+    M_truncated_count = 0;
+
+    ++M_total_cycle_count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ComputeBudget::addSearch( const bool truncated )
+{
+    ++M_search_count;
+    ++M_total_search_count;
+
+    if ( truncated )
+    {
+        if ( M_truncated_count == 0 )
+        {
+            ++M_total_truncated_cycle_count;
+        }
+        ++M_truncated_count;
+        ++M_total_truncated_count;
+    }
+}
+
+}
@@ -0,0 +1,196 @@
+// -*-c++-*-
+
+/*!
+  \file compute_budget.h
+  \brief per-cycle compute budget for the action decision Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_PLAYER_COMPUTE_BUDGET_H
+#define RCSC_PLAYER_COMPUTE_BUDGET_H
+
+#include <rcsc/time/timer.h>
+
+#include <cstdint>
+
+namespace rcsc {
+
+/*!
+  \class ComputeBudget
+  \brief time budget of the action decision in the current cycle.
+
+  PlayerAgent starts the budget at every decision with the deadline of
+  the command sending.  Search based actions poll shouldStop() between
+  candidates and return the best result found so far when the budget is
+  expired.  Each search reports whether it was truncated by addSearch().
+  The budget without a deadline never expires.
+ */
+class ComputeBudget {
+private:
+    //! the deadline. invalid if no limit
+    TimeStamp M_deadline;
+    //! true if the deadline has already been detected
+    mutable bool M_expired;
+
+    //! the number of searches in the current cycle
+    int M_search_count;
+    //! the number of truncated searches in the current cycle
+    int M_truncated_count;
+
+    //! the number of started cycles
+    long M_total_cycle_count;
+    //! the number of cycles in which at least one search was truncated
+    long M_total_truncated_cycle_count;
+    //! the number of all searches
+    long M_total_search_count;
+    //! the number of all truncated searches
+    long M_total_truncated_count;
+
+public:
+
+    /*!
+      \brief create the budget without a deadline
+     */
+    ComputeBudget();
+
+    /*!
+      \brief start the budget of the new cycle
+      \param deadline time to stop searches. invalid time stamp means no limit.
+     */
+    void start( const TimeStamp & deadline );
+
+    /*!
+      \brief record the result of one search
+      \param truncated true if the search was stopped by the budget
+     */
+    void addSearch( const bool truncated );
+
+    /*!
+      \brief check if the budget has the deadline
+      \return checked result
+     */
+    bool isLimited() const
+      {
+          return M_deadline.isValid();
+      }
+
+    /*!
+      \brief get the deadline
+      \return const reference to the time stamp. invalid if no limit.
+     */
+    const TimeStamp & deadline() const
+      {
+          return M_deadline;
+      }
+
+    /*!
+      \brief get the time left until the deadline
+      \return micro seconds. INT64_MAX if no limit, negative if expired.
+     */
+    std::int64_t remainingUSec() const
+      {
+          if ( ! M_deadline.isValid() )
+          {
+              return INT64_MAX;
+          }
+          return M_deadline.usecSince( TimeStamp::now() );
+      }
+
+    /*!
+      \brief check if searches should stop now. once the deadline is
+      detected, the clock is not read any more in this cycle.
+      \return checked result
+     */
+    bool shouldStop() const
+      {
+          if ( ! M_expired
+               && M_deadline.isValid()
+               && M_deadline.nsecSince( TimeStamp::now() ) <= 0 )
+          {
+              M_expired = true;
+          }
+          return M_expired;
+      }
+
+    /*!
+      \brief get the number of searches in the current cycle
+      \return the number of searches
+     */
+    int searchCount() const
+      {
+          return M_search_count;
+      }
+
+    /*!
+      \brief get the number of truncated searches in the current cycle
+      \return the number of searches
+     */
+    int truncatedCount() const
+      {
+          return M_truncated_count;
+      }
+
+    /*!
+      \brief get the number of started cycles
+      \return the number of cycles
+     */
+    long totalCycleCount() const
+      {
+          return M_total_cycle_count;
+      }
+
+    /*!
+      \brief get the number of cycles in which any search was truncated
+      \return the number of cycles
+     */
+    long totalTruncatedCycleCount() const
+      {
+          return M_total_truncated_cycle_count;
+      }
+
+    /*!
+      \brief get the number of all searches
+      \return the number of searches
+     */
+    long totalSearchCount() const
+      {
+          return M_total_search_count;
+      }
+
+    /*!
+      \brief get the number of all truncated searches
+      \return the number of searches
+     */
+    long totalTruncatedCount() const
+      {
+          return M_total_truncated_count;
+      }
+
+};
+
+}
+
+#endif
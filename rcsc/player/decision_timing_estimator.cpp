@@ -0,0 +1,246 @@
+// -*-c++-*-
+
+/*!
+  \file decision_timing_estimator.cpp
+  \brief online estimator of the action decision timing Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "decision_timing_estimator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+namespace rcsc {
+
+const std::size_t DecisionTimingEstimator::DEFAULT_WINDOW;
+const std::size_t DecisionTimingEstimator::MIN_SAMPLES;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+DecisionTimingEstimator::DecisionTimingEstimator( const std::size_t window )
+    : M_window( std::max( window, MIN_SAMPLES ) ),
+      M_cycle_msec( 100.0 ),
+      M_miss_probability( 0.01 ),
+      M_margin_msec( 1.0 )
+{
+    M_see_offsets.reserve( M_window );
+    M_think_times.reserve( M_window );
+    M_work.reserve( M_window );
+    clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DecisionTimingEstimator::clear()
+{
+    M_see_offsets.clear();
+    M_see_index = 0;
+    M_think_times.clear();
+    M_think_index = 0;
+
+    M_decision_count = 0;
+    M_missed_cycle_count = 0;
+    M_missed_see_count = 0;
+    M_idle_slack_msec = 0.0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DecisionTimingEstimator::setMissProbability( const double prob )
+{
+    if ( prob <= 0.0 || 1.0 <= prob )
+    {
+        std::cerr << "(DecisionTimingEstimator::setMissProbability) illegal probability "
+                  << prob << std::endl;
+        return;
+    }
+
+    M_miss_probability = prob;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DecisionTimingEstimator::add( const double value,
+                              std::vector< double > & samples,
+                              std::size_t & index )
+{
+    if ( samples.size() < M_window )
+    {
+        samples.push_back( value );
+    }
+    else
+    {
+        samples[index] = value;
+    }
+
+    index = ( index + 1 ) % M_window;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DecisionTimingEstimator::addSeeOffset( const double msec )
+{
+    if ( msec < 0.0 )
+    {
+        return;
+    }
+
+    add( msec, M_see_offsets, M_see_index );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DecisionTimingEstimator::addThinkTime( const double msec )
+{
+    if ( msec < 0.0 )
+    {
+        return;
+    }
+
+    add( msec, M_think_times, M_think_index );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DecisionTimingEstimator::addDecision( const double sent_msec,
+                                      const bool see_missed )
+{
+    ++M_decision_count;
+
+    if ( sent_msec > M_cycle_msec )
+    {
+        ++M_missed_cycle_count;
+    }
+    else
+    {
+        M_idle_slack_msec += M_cycle_msec - sent_msec;
+    }
+
+    if ( see_missed )
+    {
+        ++M_missed_see_count;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+DecisionTimingEstimator::quantile( const std::vector< double > & samples,
+                                   const double prob ) const
+{
+    if ( samples.empty() )
+    {
+        return 0.0;
+    }
+
+    M_work.assign( samples.begin(), samples.end() );
+
+    // use the upper side of the sample to be conservative.
+    std::size_t n = static_cast< std::size_t >( std::ceil( prob * M_work.size() ) );
+    if ( n > 0 ) --n;
+    n = std::min( n, M_work.size() - 1 );
+
+    std::nth_element( M_work.begin(), M_work.begin() + n, M_work.end() );
+    return M_work[n];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+DecisionTimingEstimator::latestSafeMSec() const
+{
+    if ( ! isReady() )
+    {
+        return M_cycle_msec;
+    }
+
+    const double think = quantile( M_think_times, 1.0 - M_miss_probability );
+    return std::max( 0.0, M_cycle_msec - think - M_margin_msec );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+DecisionTimingEstimator::synchViewWaitMSec( const double default_msec ) const
+{
+    if ( ! isReady()
+         || M_see_offsets.size() < MIN_SAMPLES )
+    {
+        return default_msec;
+    }
+
+    const double see = quantile( M_see_offsets, 1.0 - M_miss_probability );
+    return std::min( see, latestSafeMSec() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+DecisionTimingEstimator::noSynchViewWaitMSec( const double default_msec ) const
+{
+    if ( ! isReady() )
+    {
+        return default_msec;
+    }
+
+    return std::min( default_msec, latestSafeMSec() );
+}
+
+}
@@ -0,0 +1,222 @@
+// -*-c++-*-
+
+/*!
+  \file decision_timing_estimator.h
+  \brief online estimator of the action decision timing Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_PLAYER_DECISION_TIMING_ESTIMATOR_H
+#define RCSC_PLAYER_DECISION_TIMING_ESTIMATOR_H
+
+#include <vector>
+#include <cstddef>
+
+namespace rcsc {
+
+/*!
+  \class DecisionTimingEstimator
+  \brief learns the see arrival offset and the think time online, and
+  estimates the latest safe moment to start the action decision.
+
+  All times are milli seconds measured from the sense_body arrival in
+  the real time, i.e., the server's slow down factor is already applied.
+  The latest safe moment is the cycle length minus the (1 - p) quantile
+  of the recent think times, where p is the target miss probability.
+  The agent waits for the see message until the (1 - p) quantile of the
+  recent see offsets, but never beyond the latest safe moment.
+ */
+class DecisionTimingEstimator {
+public:
+
+    static const std::size_t DEFAULT_WINDOW = 100; //!< default number of samples used
+    static const std::size_t MIN_SAMPLES = 10; //!< the number of samples required to estimate
+
+private:
+
+    //! the number of recent samples used for the estimation
+    std::size_t M_window;
+
+    //! the length of one cycle
+    double M_cycle_msec;
+    //! target probability that the command is sent after the end of the cycle
+    double M_miss_probability;
+    //! time reserved for the network delay
+    double M_margin_msec;
+
+    //! ring buffer of the see arrival offsets from sense_body
+    std::vector< double > M_see_offsets;
+    std::size_t M_see_index; //!< next write position of M_see_offsets
+
+    //! ring buffer of the think times
+    std::vector< double > M_think_times;
+    std::size_t M_think_index; //!< next write position of M_think_times
+
+    //! work area for the quantile calculation
+    mutable std::vector< double > M_work;
+
+    int M_decision_count; //!< the number of recorded decisions
+    int M_missed_cycle_count; //!< the number of commands sent after the end of the cycle
+    int M_missed_see_count; //!< the number of decisions done before the expected see arrival
+    double M_idle_slack_msec; //!< total time left in the cycle after the command was sent
+
+public:
+
+    /*!
+      \brief construct with the number of recent samples
+      \param window the number of recent samples used for the estimation
+     */
+    explicit
+    DecisionTimingEstimator( const std::size_t window = DEFAULT_WINDOW );
+
+    /*!
+      \brief remove all samples and reset counters
+     */
+    void clear();
+
+    /*!
+      \brief set the length of one cycle
+      \param msec milli seconds in the real time
+     */
+    void setCycleMSec( const double msec )
+      {
+          M_cycle_msec = msec;
+      }
+
+    /*!
+      \brief set the target probability of missing the cycle end
+      \param prob probability value (0, 1)
+     */
+    void setMissProbability( const double prob );
+
+    /*!
+      \brief set the time reserved for the network delay
+      \param msec milli seconds
+     */
+    void setMarginMSec( const double msec )
+      {
+          M_margin_msec = msec;
+      }
+
+    /*!
+      \brief add the arrival offset of the see message
+      \param msec milli seconds from the sense_body arrival
+     */
+    void addSeeOffset( const double msec );
+
+    /*!
+      \brief add the think time, i.e., the elapsed time from the decision start to the command sending.
+      \param msec milli seconds
+     */
+    void addThinkTime( const double msec );
+
+    /*!
+      \brief record the result of the decision in the current cycle
+      \param sent_msec time when the command was sent, from the sense_body arrival
+      \param see_missed true if the decision started before the expected see arrival
+     */
+    void addDecision( const double sent_msec,
+                      const bool see_missed );
+
+    /*!
+      \brief check if enough samples have been collected
+      \return checked result
+     */
+    bool isReady() const
+      {
+          return M_think_times.size() >= MIN_SAMPLES;
+      }
+
+    /*!
+      \brief get the latest moment to start the decision in order to send the command within the cycle
+      \return milli seconds from the sense_body arrival. if no enough samples, the cycle length is returned.
+     */
+    double latestSafeMSec() const;
+
+    /*!
+      \brief get the wait threshold for the see message in the synch view mode.
+      \param default_msec value returned if no enough samples
+      \return milli seconds from the sense_body arrival
+     */
+    double synchViewWaitMSec( const double default_msec ) const;
+
+    /*!
+      \brief get the wait threshold in the no synch view mode.
+      The see arrival cannot be predicted, so the given value is only limited by the latest safe moment.
+      \param default_msec configured threshold
+      \return milli seconds from the sense_body arrival
+     */
+    double noSynchViewWaitMSec( const double default_msec ) const;
+
+    /*!
+      \brief get the number of recorded decisions
+      \return the number of decisions
+     */
+    int decisionCount() const
+      {
+          return M_decision_count;
+      }
+
+    /*!
+      \brief get the number of commands sent after the end of the cycle
+      \return counter value
+     */
+    int missedCycleCount() const
+      {
+          return M_missed_cycle_count;
+      }
+
+    /*!
+      \brief get the number of decisions done before the expected see arrival
+      \return counter value
+     */
+    int missedSeeCount() const
+      {
+          return M_missed_see_count;
+      }
+
+    /*!
+      \brief get the total time left in the cycle after the command sending
+      \return milli seconds
+     */
+    double idleSlackMSec() const
+      {
+          return M_idle_slack_msec;
+      }
+
+private:
+
+    void add( const double value,
+              std::vector< double > & samples,
+              std::size_t & index );
+
+    double quantile( const std::vector< double > & samples,
+                     const double prob ) const;
+};
+
+}
+
+#endif
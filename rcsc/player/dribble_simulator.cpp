@@ -0,0 +1,530 @@
+// -*-c++-*-
+
+/*!
+  \file dribble_simulator.cpp
+  \brief batch simulator for kick-dashes dribble candidates Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "dribble_simulator.h"
+
+#include <rcsc/player/world_model.h>
+#include <rcsc/player/reach_grid.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/common/stamina_model.h>
+#include <rcsc/geom/rect_2d.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace rcsc {
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief same ordering as Body_Dribble2008::doKickDashesWithBall()
+  \return true if lhs is better than rhs
+ */
+inline
+bool
+is_better_kick( const DribbleSimulator::Result & lhs,
+                const DribbleSimulator::Result & rhs )
+{
+    if ( lhs.dash_count_ > rhs.dash_count_ ) return true;
+    if ( lhs.dash_count_ == rhs.dash_count_ )
+    {
+        if ( lhs.min_opp_margin_ > 5.0
+             && rhs.min_opp_margin_ > 5.0 )
+        {
+            return lhs.ball_forward_travel_ > rhs.ball_forward_travel_;
+        }
+        return lhs.min_opp_margin_ > rhs.min_opp_margin_;
+    }
+    return false;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+DribbleSimulator::DribbleSimulator( const int max_dash_count )
+    : M_update_time( -1, 0 )
+    , M_max_dash_count( std::max( 1, max_dash_count ) )
+    , M_simulation_count( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DribbleSimulator::update( const WorldModel & wm )
+{
+    if ( M_update_time == wm.time() )
+    {
+        return;
+    }
+
+    M_update_time = wm.time();
+    M_self_caches.clear();
+    M_simulation_count = 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+DribbleSimulator::simulate( const WorldModel & wm,
+                            const std::vector< Candidate > & candidates,
+                            std::vector< Result > * results )
+{
+    update( wm );
+
+    results->clear();
+    results->reserve( candidates.size() );
+
+    const int size = candidates.size();
+    for ( int i = 0; i < size; ++i )
+    {
+        Result result;
+        if ( simulateOne( wm, candidates[i], &result ) )
+        {
+            result.candidate_index_ = i;
+            results->push_back( result );
+        }
+    }
+
+    std::sort( results->begin(), results->end(), DribbleSimulator::is_safer );
+
+    return results->size();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DribbleSimulator::simulateOne( const WorldModel & wm,
+                               const Candidate & candidate,
+                               Result * result )
+{
+    update( wm );
+
+    if ( candidate.dash_count_ <= 0
+         || std::fabs( candidate.dash_power_ ) < 1.0e-5 )
+    {
+        return false;
+    }
+
+    const SelfCache & cache = getSelfCache( wm, candidate );
+
+    const AngleDeg accel_angle = ( cache.dash_power_ > 0.0
+                                   ? wm.self().body() + cache.dash_dir_
+                                   : wm.self().body() + cache.dash_dir_ - 180.0 );
+
+    //
+    // same search space as Body_Dribble2008::doKickDashesWithBall()
+    //
+
+    const int DIST_DIVS = 10;
+
+    const double kickable_area = wm.self().playerType().kickableArea();
+    const double max_dist = kickable_area + 0.2;
+    double first_ball_dist = ( wm.self().playerType().playerSize()
+                               + ServerParam::i().ballSize()
+                               + 0.15 );
+    const double dist_step = ( max_dist - first_ball_dist ) / ( DIST_DIVS - 1 );
+
+    const double angle_range = 240.0;
+    const double angle_range_forward = 160.0;
+    const double arc_dist_step = 0.1;
+
+    const Vector2D & my_next = cache.positions_.front();
+
+    bool found = false;
+
+    for ( int dist_loop = 0;
+          dist_loop < DIST_DIVS;
+          ++dist_loop, first_ball_dist += dist_step )
+    {
+        const double angle_step
+            = ( arc_dist_step * 360.0 )
+            / ( 2.0 * first_ball_dist * M_PI );
+        const int ANGLE_DIVS
+            = ( first_ball_dist < kickable_area - 0.1
+                ? static_cast< int >( std::ceil( angle_range / angle_step ) ) + 1
+                : static_cast< int >( std::ceil( angle_range_forward / angle_step ) ) + 1 );
+
+        AngleDeg first_ball_angle = accel_angle - angle_step * ( ANGLE_DIVS/2 );
+
+        for ( int angle_loop = 0;
+              angle_loop < ANGLE_DIVS;
+              ++angle_loop, first_ball_angle += angle_step )
+        {
+            const Vector2D first_ball_pos
+                = my_next
+                + Vector2D::polar2vector( first_ball_dist, first_ball_angle );
+            const Vector2D first_ball_vel = first_ball_pos - wm.ball().pos();
+
+            Result tmp;
+            if ( simulateKickDashes( wm,
+                                     cache.positions_,
+                                     candidate.dash_count_,
+                                     accel_angle,
+                                     first_ball_pos,
+                                     first_ball_vel,
+                                     &tmp ) )
+            {
+                if ( ! found
+                     || is_better_kick( tmp, *result ) )
+                {
+                    *result = tmp;
+                    found = true;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DribbleSimulator::is_safer( const Result & lhs,
+                            const Result & rhs )
+{
+    if ( lhs.min_opp_margin_ != rhs.min_opp_margin_ )
+    {
+        return lhs.min_opp_margin_ > rhs.min_opp_margin_;
+    }
+
+    if ( lhs.dash_count_ != rhs.dash_count_ )
+    {
+        return lhs.dash_count_ > rhs.dash_count_;
+    }
+
+    return lhs.candidate_index_ < rhs.candidate_index_;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const DribbleSimulator::SelfCache &
+DribbleSimulator::getSelfCache( const WorldModel & wm,
+                                const Candidate & candidate )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    const AngleDeg dash_angle = ( candidate.dash_power_ > 0.0
+                                  ? candidate.dash_angle_
+                                  : candidate.dash_angle_ + 180.0 );
+    const double dash_dir = SP.discretizeDashAngle( ( dash_angle - wm.self().body() ).degree() );
+    const std::size_t length = std::max( M_max_dash_count, candidate.dash_count_ ) + 1;
+
+    for ( const SelfCache & c : M_self_caches )
+    {
+        if ( std::fabs( c.dash_dir_ - dash_dir ) < 1.0e-5
+             && std::fabs( c.dash_power_ - candidate.dash_power_ ) < 1.0e-5
+             && c.positions_.size() >= length )
+        {
+            return c;
+        }
+    }
+
+    M_self_caches.push_back( SelfCache() );
+
+    SelfCache & cache = M_self_caches.back();
+    cache.dash_dir_ = dash_dir;
+    cache.dash_power_ = candidate.dash_power_;
+    predict_self_positions( wm.self().playerType(),
+                            wm.self().pos(),
+                            wm.self().vel(),
+                            wm.self().body(),
+                            wm.self().staminaModel(),
+                            dash_dir,
+                            candidate.dash_power_,
+                            length - 1,
+                            &cache.positions_ );
+    return cache;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DribbleSimulator::predict_self_positions( const PlayerType & ptype,
+                                          const Vector2D & pos,
+                                          const Vector2D & vel,
+                                          const AngleDeg & body,
+                                          const StaminaModel & stamina,
+                                          const double dash_dir,
+                                          const double dash_power,
+                                          const int dash_count,
+                                          std::vector< Vector2D > * positions )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    positions->clear();
+    positions->reserve( dash_count + 1 );
+
+    StaminaModel stamina_model = stamina;
+
+    Vector2D my_pos = pos;
+    Vector2D my_vel = vel;
+
+    my_pos += my_vel;
+    my_vel *= ptype.playerDecay();
+
+    positions->push_back( my_pos ); // first element is next cycle just after kick
+
+    stamina_model.simulateWaits( ptype, 1 );
+
+    const AngleDeg accel_angle = ( dash_power > 0.0
+                                   ? body + dash_dir
+                                   : body + dash_dir - 180.0 );
+    const double dir_rate = SP.dashDirRate( dash_dir );
+
+    for ( int i = 0; i < dash_count; ++i )
+    {
+        double available_stamina
+            =  std::max( 0.0,
+                         stamina_model.stamina()
+                         - SP.recoverDecThrValue()
+                         - 300.0 );
+        double consumed_stamina = ( dash_power > 0.0
+                                    ? dash_power
+                                    : dash_power * -2.0 );
+        consumed_stamina = std::min( available_stamina,
+                                     consumed_stamina );
+        double used_power = ( dash_power > 0.0
+                              ? consumed_stamina
+                              : consumed_stamina * -0.5 );
+        double max_accel_mag = ( std::fabs( used_power )
+                                 * ptype.dashRate( stamina_model.effort() )
+                                 * dir_rate );
+        double accel_mag = max_accel_mag;
+        if ( max_accel_mag > 1.0e-10
+             && ptype.normalizeAccel( my_vel, accel_angle, &accel_mag ) )
+        {
+            used_power *= accel_mag / max_accel_mag;
+        }
+
+        my_vel += Vector2D::polar2vector( std::fabs( used_power )
+                                          * ptype.dashRate( stamina_model.effort() )
+                                          * dir_rate,
+                                          accel_angle );
+        my_pos += my_vel;
+
+        positions->push_back( my_pos );
+
+        my_vel *= ptype.playerDecay();
+
+        stamina_model.simulateDash( ptype, used_power );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DribbleSimulator::simulateKickDashes( const WorldModel & wm,
+                                      const std::vector< Vector2D > & self_cache,
+                                      const int dash_count,
+                                      const AngleDeg & accel_angle,
+                                      const Vector2D & first_ball_pos,
+                                      const Vector2D & first_ball_vel,
+                                      Result * result )
+{
+    static const Rect2D pitch_rect( Vector2D( - ServerParam::i().pitchHalfLength() + 0.2,
+                                              - ServerParam::i().pitchHalfWidth() + 0.2 ),
+                                    Size2D( ServerParam::i().pitchLength() - 0.4,
+                                            ServerParam::i().pitchWidth() - 0.4 ) );
+
+    ++M_simulation_count;
+
+    if ( ! pitch_rect.contains( first_ball_pos ) )
+    {
+        return false;
+    }
+
+    const ServerParam & param = ServerParam::i();
+    const double collide_dist = ( wm.self().playerType().playerSize()
+                                  + param.ballSize() );
+    const double kickable_area = wm.self().playerType().kickableArea();
+
+    const Vector2D first_ball_accel = first_ball_vel - wm.ball().vel();
+    const double first_ball_accel_r = first_ball_accel.r();
+
+    if ( first_ball_vel.r() > param.ballSpeedMax()
+         || first_ball_accel_r > param.ballAccelMax()
+         || ( first_ball_accel_r > wm.self().kickRate() * param.maxPower() )
+         )
+    {
+        // cannot acccelerate to the desired speed
+        return false;
+    }
+
+    double min_opp_margin = 1000.0;
+
+    // the ball reaches first_ball_pos at the next cycle
+    int ball_step = 1;
+    if ( existReachableOpponent( wm, first_ball_pos, ball_step, &min_opp_margin ) )
+    {
+        return false;
+    }
+
+    Vector2D ball_pos = first_ball_pos;
+    Vector2D ball_vel = first_ball_vel;
+    ball_vel *= param.ballDecay();
+
+    int tmp_dash_count = 0;
+    Vector2D total_ball_move( 0.0, 0.0 );
+    Vector2D last_ball_rel( 0.0, 0.0 );
+
+    // future state loop
+    // the cache may be longer than the requested dash count.
+    const std::size_t length = std::min( self_cache.size(),
+                                         static_cast< std::size_t >( dash_count ) + 1 );
+    for ( std::vector< Vector2D >::const_iterator my_pos = self_cache.begin() + 1, end = self_cache.begin() + length;
+          my_pos != end;
+          ++my_pos )
+    {
+        ball_pos += ball_vel;
+        ++ball_step;
+
+        // out of pitch
+        if ( ! pitch_rect.contains( ball_pos ) ) break;
+
+        const Vector2D ball_rel = ( ball_pos - *my_pos ).rotatedVector( - accel_angle );
+        const double new_ball_dist = ball_rel.r();
+
+        const double ball_travel = ball_pos.dist( wm.ball().pos() );
+        const double my_travel = my_pos->dist( wm.self().pos() );
+
+        // check collision
+        double dist_buf = std::min( 0.02 * ball_travel + 0.03 * my_travel,
+                                    0.1 );
+        if ( new_ball_dist < collide_dist - dist_buf + 0.2 ) break;
+
+        // check kickable
+        if ( tmp_dash_count == dash_count - 1
+             && ball_rel.x > 0.0
+             && new_ball_dist > kickable_area - 0.25 ) break;
+
+        if ( new_ball_dist > kickable_area - 0.2 ) break;
+
+        // front x buffer
+        dist_buf = std::min( 0.02 * ball_travel + 0.04 * my_travel,
+                             0.2 );
+        if ( ball_rel.x > kickable_area - dist_buf - 0.2 ) break;
+
+        // side y buffer
+        dist_buf = std::min( 0.02 * ball_travel + 0.055 + my_travel,
+                             0.35 );
+        if ( ball_rel.absY() > kickable_area - dist_buf - 0.15 ) break;
+
+        // check opponent reach possibility
+        if ( existReachableOpponent( wm, ball_pos, ball_step, &min_opp_margin ) )
+        {
+            break;
+        }
+
+        total_ball_move = ball_pos - wm.ball().pos();
+        ++tmp_dash_count;
+        last_ball_rel = ball_rel;
+        ball_vel *= param.ballDecay();
+    }
+
+    if ( tmp_dash_count > 0 )
+    {
+        result->first_ball_vel_ = first_ball_vel;
+        result->last_ball_rel_ = last_ball_rel;
+        result->ball_forward_travel_ = total_ball_move.rotate( - accel_angle ).x;
+        result->dash_count_ = tmp_dash_count;
+        result->min_opp_margin_ = min_opp_margin;
+    }
+
+    return ( tmp_dash_count > 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DribbleSimulator::existReachableOpponent( const WorldModel & wm,
+                                          const Vector2D & ball_pos,
+                                          const int ball_step,
+                                          double * min_opp_margin ) const
+{
+    const ServerParam & SP = ServerParam::i();
+
+    // goalie's catchable check
+    if ( ball_pos.x > SP.theirPenaltyAreaLineX()
+         && ball_pos.absY() < SP.penaltyAreaHalfWidth() )
+    {
+        const AbstractPlayerObject * goalie = wm.getTheirGoalie();
+        if ( goalie
+             && goalie->posCount() <= 5
+             && goalie->pos().dist( ball_pos ) < SP.catchableArea() )
+        {
+            return true;
+        }
+    }
+
+    // the opponent arrival step includes the kickable area and the accuracy bonus
+    const double margin = wm.reachGrid().opponentStep( ball_pos ) - ball_step;
+    if ( margin <= 0.0 )
+    {
+        return true;
+    }
+
+    if ( *min_opp_margin > margin )
+    {
+        *min_opp_margin = margin;
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,231 @@
+// -*-c++-*-
+
+/*!
+  \file dribble_simulator.h
+  \brief batch simulator for kick-dashes dribble candidates Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_PLAYER_DRIBBLE_SIMULATOR_H
+#define RCSC_PLAYER_DRIBBLE_SIMULATOR_H
+
+#include <rcsc/game_time.h>
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/angle_deg.h>
+
+#include <vector>
+
+namespace rcsc {
+
+class PlayerType;
+class StaminaModel;
+class WorldModel;
+
+/*!
+  \class DribbleSimulator
+  \brief batch evaluator of "kick -> dash -> dash -> ..." dribbles.
+
+  The ball keeping criteria are same as Body_Dribble2008::simulateKickDashes().
+  The self movement caches are created only once per cycle, and they are
+  shared by all candidates evaluated in the cycle.  Opponents are checked
+  by WorldModel::reachGrid().
+  Dash directions other than the current body angle are simulated as omni
+  directional dashes.
+ */
+class DribbleSimulator {
+public:
+
+    /*!
+      \struct Candidate
+      \brief input dribble candidate
+     */
+    struct Candidate {
+        AngleDeg dash_angle_; //!< global dash (= dribble) direction
+        double dash_power_; //!< dash power. negative value means back dash.
+        int dash_count_; //!< requested dash count after kick
+
+        /*!
+          \brief construct with all variables
+          \param dash_angle global dash direction
+          \param dash_power dash power
+          \param dash_count requested dash count
+         */
+        Candidate( const AngleDeg & dash_angle,
+                   const double dash_power,
+                   const int dash_count )
+            : dash_angle_( dash_angle )
+            , dash_power_( dash_power )
+            , dash_count_( dash_count )
+          { }
+    };
+
+    /*!
+      \struct Result
+      \brief the best kick found for each candidate
+     */
+    struct Result {
+        int candidate_index_; //!< index in the input candidate container
+        Vector2D first_ball_vel_; //!< ball velocity just after the first kick
+        Vector2D last_ball_rel_; //!< relative ball position at the last dash
+        double ball_forward_travel_; //!< ball travel distance for the dribble direction
+        int dash_count_; //!< the number of dashes the ball can be kept
+        double min_opp_margin_; //!< minimum (opponent reach step - ball step) while dribbling
+
+        Result()
+            : candidate_index_( -1 )
+            , first_ball_vel_( 0.0, 0.0 )
+            , last_ball_rel_( 0.0, 0.0 )
+            , ball_forward_travel_( 0.0 )
+            , dash_count_( 0 )
+            , min_opp_margin_( 0.0 )
+          { }
+    };
+
+private:
+
+    /*!
+      \struct SelfCache
+      \brief predicted self positions for one (dash direction, dash power) pair
+     */
+    struct SelfCache {
+        double dash_dir_; //!< relative dash direction (discretized)
+        double dash_power_; //!< dash power
+        std::vector< Vector2D > positions_; //!< the first element is the next cycle just after kick
+    };
+
+    GameTime M_update_time; //!< last updated time
+    int M_max_dash_count; //!< length of self movement caches
+
+    std::vector< SelfCache > M_self_caches; //!< self movement caches in this cycle
+
+    int M_simulation_count; //!< the number of kick-dashes simulations in this cycle
+
+public:
+
+    /*!
+      \brief create an empty simulator
+      \param max_dash_count maximum number of simulated dashes
+     */
+    explicit
+    DribbleSimulator( const int max_dash_count = 12 );
+
+    /*!
+      \brief clear the caches if the world model is updated.
+      this method is called from simulate() automatically.
+      \param wm const reference to the world model
+     */
+    void update( const WorldModel & wm );
+
+    /*!
+      \brief evaluate all candidates and store the feasible results.
+      \param wm const reference to the world model
+      \param candidates dribble candidates
+      \param results container to store the results sorted by safety
+      (the opponent reach step margin, then the dash count).
+      \return the number of results
+     */
+    std::size_t simulate( const WorldModel & wm,
+                          const std::vector< Candidate > & candidates,
+                          std::vector< Result > * results );
+
+    /*!
+      \brief evaluate one candidate
+      \param wm const reference to the world model
+      \param candidate dribble candidate
+      \param result pointer to the variable to store the result
+      \return true if the ball can be kept at least one dash
+     */
+    bool simulateOne( const WorldModel & wm,
+                      const Candidate & candidate,
+                      Result * result );
+
+    /*!
+      \brief get the number of kick-dashes simulations in this cycle
+      \return the number of simulations
+     */
+    int simulationCount() const
+      {
+          return M_simulation_count;
+      }
+
+    /*!
+      \brief compare the safety of results.
+      \param lhs left hand side result
+      \param rhs right hand side result
+      \return true if lhs is safer than rhs
+     */
+    static
+    bool is_safer( const Result & lhs,
+                   const Result & rhs );
+
+    /*!
+      \brief predict the self positions of "kick -> dash -> dash -> ...".
+      the dash power is limited by the stamina in the same way as
+      Body_Dribble2008.
+      \param ptype player type
+      \param pos current position
+      \param vel current velocity
+      \param body current body angle
+      \param stamina current stamina model
+      \param dash_dir discretized dash direction relative to the body angle
+      \param dash_power dash power. negative value means back dash.
+      \param dash_count the number of dashes after kick
+      \param positions container to store the result. the first element
+      is the position at the next cycle just after kick.
+     */
+    static
+    void predict_self_positions( const PlayerType & ptype,
+                                 const Vector2D & pos,
+                                 const Vector2D & vel,
+                                 const AngleDeg & body,
+                                 const StaminaModel & stamina,
+                                 const double dash_dir,
+                                 const double dash_power,
+                                 const int dash_count,
+                                 std::vector< Vector2D > * positions );
+
+private:
+
+    const SelfCache & getSelfCache( const WorldModel & wm,
+                                    const Candidate & candidate );
+
+    bool simulateKickDashes( const WorldModel & wm,
+                             const std::vector< Vector2D > & self_cache,
+                             const int dash_count,
+                             const AngleDeg & accel_angle,
+                             const Vector2D & first_ball_pos,
+                             const Vector2D & first_ball_vel,
+                             Result * result );
+
+    bool existReachableOpponent( const WorldModel & wm,
+                                 const Vector2D & ball_pos,
+                                 const int ball_step,
+                                 double * min_opp_margin ) const;
+};
+
+}
+
+#endif
@@ -188,8 +188,14 @@ InterceptSimulatorPlayer::createBallCache( const Vector2D & ball_pos,
 int
 InterceptSimulatorPlayer::simulate( const WorldModel & wm,
                                     const PlayerObject & player,
-                                    const bool goalie ) const
+                                    const bool goalie,
+                                    bool * turned ) const
 {
+    if ( turned )
+    {
+        *turned = false;
+    }
+
     if ( player.posCount() >= 15 )
     {
         return 1000;
@@ -241,7 +247,7 @@ InterceptSimulatorPlayer::simulate( const WorldModel & wm,
 
     if ( min_step > max_step )
     {
-        return predictFinal( data );
+        return predictFinal( data, turned );
     }
 
     for ( int total_step = min_step; total_step < max_step; ++total_step )
@@ -281,9 +287,28 @@ InterceptSimulatorPlayer::simulate( const WorldModel & wm,
             continue;
         }
 
+        // lower bound by the reach step table. the turn is not considered.
+        // the difference of the control area and the table resolution are
+        // subtracted from the distance.
+        if ( data.ptype_.reachStep( data.inertiaPoint( total_step ).dist( ball_pos )
+                                    - ( data.control_area_ - data.ptype_.kickableArea() )
+                                    - PlayerType::reach_step_dist_resolution(),
+                                    0.0 )
+             - data.bonus_step_ + data.penalty_step_ > total_step )
+        {
+            // never reach
+#ifdef DEBUG2
+            dlog.addText( Logger::INTERCEPT,
+                          "--->step=%d  never reach by the reach step table. ball(%.2f %.2f)",
+                          total_step, ball_pos.x, ball_pos.y );
+#endif
+            continue;
+        }
+
         if ( canReachAfterTurnDash( data,
                                     ball_pos,
-                                    total_step ) )
+                                    total_step,
+                                    turned ) )
         {
 #ifdef DEBUG
             dlog.addText( Logger::INTERCEPT,
@@ -306,7 +331,7 @@ InterceptSimulatorPlayer::simulate( const WorldModel & wm,
         return 1000;
     }
 
-    return predictFinal( data );
+    return predictFinal( data, turned );
 }
 
 /*-------------------------------------------------------------------*/
@@ -331,7 +356,8 @@ InterceptSimulatorPlayer::estimateMinStep( const PlayerData & data ) const
 bool
 InterceptSimulatorPlayer::canReachAfterTurnDash( const PlayerData & data,
                                                  const Vector2D & ball_pos,
-                                                 const int total_step ) const
+                                                 const int total_step,
+                                                 bool * turned ) const
 {
     /*
       TODO
@@ -342,6 +368,11 @@ InterceptSimulatorPlayer::canReachAfterTurnDash( const PlayerData & data,
     */
 
     int n_turn = predictTurnCycle( data, ball_pos, total_step );
+    if ( turned
+         && n_turn > 0 )
+    {
+        *turned = true;
+    }
 #ifdef DEBUG2
     dlog.addText( Logger::INTERCEPT,
                   "______ step %d  turn=%d",
@@ -481,7 +512,8 @@ InterceptSimulatorPlayer::canReachAfterDash( const PlayerData & data,
 
  */
 int
-InterceptSimulatorPlayer::predictFinal( const PlayerData & data ) const
+InterceptSimulatorPlayer::predictFinal( const PlayerData & data,
+                                        bool * turned ) const
 {
     Vector2D ball_pos = M_ball_cache.back();
     int ball_step = M_ball_cache.size() - 1;
@@ -489,6 +521,11 @@ InterceptSimulatorPlayer::predictFinal( const PlayerData & data ) const
     Vector2D inertia_pos = data.inertiaPoint( 100 );
 
     int n_turn = predictTurnCycle( data, ball_pos, 100 );
+    if ( turned
+         && n_turn > 0 )
+    {
+        *turned = true;
+    }
 
     double dash_dist = inertia_pos.dist( ball_pos ) - data.control_area_;
 
@@ -107,18 +107,30 @@ public:
     ~InterceptSimulatorPlayer()
     { }
 
+    /*!
+      \brief get the number of predicted ball positions
+      \return size of the ball position cache
+    */
+    std::size_t ballCacheSize() const
+    {
+        return M_ball_cache.size();
+    }
+
     //////////////////////////////////////////////////////////
     /*!
       \brief get predicted ball gettable cycle
       \param wm const reference to the instance of world model
       \param player const reference to the player object
       \param goalie goalie mode or not
-      \param max_cycle max predict cycle. estimation loop is limited to this value.
+      \param turned if not null, set to true if any evaluated step requires turns.
+      only a result without turns is the same problem shifted by one step
+      in the next cycle.
       \return predicted cycle value
     */
     int simulate( const WorldModel & wm,
                   const PlayerObject & player,
-                  const bool goalie ) const;
+                  const bool goalie,
+                  bool * turned = nullptr ) const;
 
 private:
 
@@ -147,11 +159,13 @@ private:
       \param total_step total time step
       \param bonus_step bonus time step for the target player
       \param penalty_step penalty time step for the target player
+      \param turned set to true if turns are required, if not null
       \return true if player can get the ball
     */
     bool canReachAfterTurnDash( const PlayerData & data,
                                 const Vector2D & ball_pos,
-                                const int total_step ) const;
+                                const int total_step,
+                                bool * turned ) const;
 
     /*!
       \brief predict required cycle to face to the ball position
@@ -185,9 +199,11 @@ private:
       \brief predict player's reachable cycle to the ball final point
       \param player const reference to the player object
       \param player_type player type parameter
+      \param turned set to true if turns are required, if not null
       \return predicted cycle value
     */
-    int predictFinal( const PlayerData & data ) const;
+    int predictFinal( const PlayerData & data,
+                      bool * turned ) const;
 
 };
 
@@ -49,13 +49,24 @@
 #include <rcsc/game_time.h>
 
 #include <algorithm>
+#include <cmath>
 
 // #define DEBUG_PRINT
 
+// compare the reused results with the full simulation
+// #define DEBUG_VERIFY_CACHE
+
 namespace rcsc {
 
 namespace {
 const int MAX_STEP = 50;
+
+//! the bonus step limit in InterceptSimulatorPlayer
+const int MAX_BONUS_STEP = 3;
+
+//! tolerance of the ball state on the predicted trajectory
+const double BALL_POS_EPS = 1.0e-3;
+const double BALL_VEL_EPS = 1.0e-3;
 }
 
 /*-------------------------------------------------------------------*/
@@ -64,9 +75,16 @@ const int MAX_STEP = 50;
 */
 InterceptTable::InterceptTable()
     : M_update_time( 0, 0 ),
-      M_self_simulator( new InterceptSimulatorSelfV17 )
+      M_self_simulator( new InterceptSimulatorSelfV17 ),
+      M_cache_time( -1, 0 ),
+      M_cache_ball_pos( 0.0, 0.0 ),
+      M_cache_ball_vel( 0.0, 0.0 ),
+      M_cache_ball_steps( 0 ),
+      M_reuse_count( 0 )
 {
     M_self_results.reserve( ( MAX_STEP + 1 ) * 2 );
+    M_last_player_cache.reserve( 22 );
+    M_player_cache.reserve( 22 );
 
     clear();
 }
@@ -94,6 +112,8 @@ InterceptTable::clear()
     M_self_results.clear();
 
     M_player_map.clear();
+
+    M_reuse_count = 0;
 }
 
 /*-------------------------------------------------------------------*/
@@ -106,6 +126,192 @@ InterceptTable::setSimulator( std::shared_ptr< InterceptSimulatorSelf > self )
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+bool
+InterceptTable::isCacheConsistent( const WorldModel & wm ) const
+{
+    if ( M_cache_time.cycle() < 0
+         || M_cache_time.stopped() != 0
+         || wm.time().stopped() != 0
+         || wm.time().cycle() != M_cache_time.cycle() + 1 )
+    {
+        return false;
+    }
+
+    if ( wm.gameMode().type() != GameMode::PlayOn
+         || ! wm.self().posValid()
+         || ! wm.ball().posValid()
+         || wm.self().isKickable()
+         || wm.kickableTeammate()
+         || wm.kickableOpponent() )
+    {
+        return false;
+    }
+
+    const Vector2D ball_pos = M_cache_ball_pos + M_cache_ball_vel;
+    const Vector2D ball_vel = M_cache_ball_vel * ServerParam::i().ballDecay();
+
+    if ( wm.ball().pos().dist2( ball_pos ) > std::pow( BALL_POS_EPS, 2 )
+         || wm.ball().vel().dist2( ball_vel ) > std::pow( BALL_VEL_EPS, 2 ) )
+    {
+        dlog.addText( Logger::INTERCEPT,
+                      __FILE__" (isCacheConsistent) ball is not on the predicted path" );
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+InterceptTable::getShiftedStep( const PlayerObject & player,
+                                const int ball_steps,
+                                int & step,
+                                int & goalie_step ) const
+{
+    if ( M_last_player_cache.empty()
+         || player.isTackling()
+         || player.isKickable( 0.0 ) )
+    {
+        return false;
+    }
+
+    // the estimated velocity is changed every cycle.
+    if ( player.velCount() < player.seenVelCount() )
+    {
+        return false;
+    }
+
+    for ( const PlayerCache & c : M_last_player_cache )
+    {
+        if ( c.id_ != player.id() )
+        {
+            continue;
+        }
+
+        // the player must not be observed after the last simulation,
+        // and the bonus step must be increased by one.
+        if ( std::min( c.seen_pos_count_, c.heard_pos_count_ ) >= MAX_BONUS_STEP
+             || player.seenPosCount() != std::min( 1000, c.seen_pos_count_ + 1 )
+             || player.heardPosCount() != std::min( 1000, c.heard_pos_count_ + 1 ) )
+        {
+            return false;
+        }
+
+        // the turn cycles and the bonus step consumed by turns depend on
+        // the current velocity, so that such a result is not shifted.
+        if ( ! c.turn_free_ )
+        {
+            return false;
+        }
+
+        // the last result must be found within both ball trajectories.
+        const int max_step = std::min( M_cache_ball_steps, ball_steps + 1 ) - 1;
+
+        if ( c.step_ < 2
+             || max_step <= c.step_ )
+        {
+            return false;
+        }
+
+        if ( player.goalie() )
+        {
+            if ( c.goalie_step_ < 2
+                 || max_step <= c.goalie_step_ )
+            {
+                return false;
+            }
+            goalie_step = c.goalie_step_ - 1;
+        }
+        else
+        {
+            goalie_step = -1;
+        }
+
+        step = c.step_ - 1;
+        return true;
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+InterceptTable::predictPlayer( const WorldModel & wm,
+                               const InterceptSimulatorPlayer & sim,
+                               const PlayerObject & player,
+                               int & step,
+                               int & goalie_step )
+{
+    bool turn_free = true;
+
+    if ( getShiftedStep( player, sim.ballCacheSize(), step, goalie_step ) )
+    {
+        dlog.addText( Logger::INTERCEPT,
+                      "---> %c %d reuse the last result. step=%d goalie_step=%d",
+                      side_char( player.side() ), player.unum(),
+                      step, goalie_step );
+        ++M_reuse_count;
+#ifdef DEBUG_VERIFY_CACHE
+        {
+            static int s_verify_count = 0;
+            static int s_mismatch_count = 0;
+
+            const int full_step = sim.simulate( wm, player, false );
+            const int full_goalie_step = ( player.goalie()
+                                           ? sim.simulate( wm, player, true )
+                                           : -1 );
+            ++s_verify_count;
+            if ( full_step != step
+                 || full_goalie_step != goalie_step )
+            {
+                ++s_mismatch_count;
+                dlog.addText( Logger::INTERCEPT,
+                              "xxx %c %d cache mismatch. reuse=%d/%d full=%d/%d (%d/%d)",
+                              side_char( player.side() ), player.unum(),
+                              step, goalie_step,
+                              full_step, full_goalie_step,
+                              s_mismatch_count, s_verify_count );
+                std::cerr << wm.ourTeamName() << ' ' << wm.self().unum() << ": "
+                          << wm.time()
+                          << " (InterceptTable::predictPlayer) cache mismatch "
+                          << side_char( player.side() ) << ' ' << player.unum()
+                          << " reuse=" << step << " full=" << full_step
+                          << " (" << s_mismatch_count << '/' << s_verify_count << ')'
+                          << std::endl;
+            }
+        }
+#endif
+    }
+    else
+    {
+        bool turned = false;
+        bool goalie_turned = false;
+
+        step = sim.simulate( wm, player, false, &turned );
+        goalie_step = ( player.goalie()
+                        ? sim.simulate( wm, player, true, &goalie_turned )
+                        : -1 );
+        turn_free = ( ! turned && ! goalie_turned );
+    }
+
+    M_player_cache.push_back( PlayerCache{ player.id(),
+                                           player.seenPosCount(),
+                                           player.heardPosCount(),
+                                           step,
+                                           goalie_step,
+                                           turn_free } );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 void
 InterceptTable::update( const WorldModel & wm )
@@ -125,6 +331,15 @@ InterceptTable::update( const WorldModel & wm )
     // clear all data
     this->clear();
 
+    // keep the last player results only if the ball is on the predicted path
+    M_last_player_cache.swap( M_player_cache );
+    M_player_cache.clear();
+    if ( ! isCacheConsistent( wm ) )
+    {
+        M_last_player_cache.clear();
+    }
+    M_cache_time.assign( -1, 0 );
+
     // playmode check
     if ( wm.gameMode().type() == GameMode::TimeOver
          || wm.gameMode().type() == GameMode::BeforeKickOff )
@@ -157,19 +372,33 @@ InterceptTable::update( const WorldModel & wm )
 
     predictSelf( wm );
 
+    const Vector2D ball_vel = ( wm.kickableOpponent() ? Vector2D( 0.0, 0.0 ) : wm.ball().vel() );
+    const InterceptSimulatorPlayer sim( wm.ball().pos(), ball_vel );
+
 #ifdef DEBUG
     dlog.addText( Logger::INTERCEPT,
                   "==========Intercept Predict Opponent==========" );
 #endif
 
-    predictOpponent( wm );
+    predictOpponent( wm, sim );
 
 #ifdef DEBUG
     dlog.addText( Logger::INTERCEPT,
                   "==========Intercept Predict Teammate==========" );
 #endif
 
-    predictTeammate( wm );
+    predictTeammate( wm, sim );
+
+    if ( wm.gameMode().type() == GameMode::PlayOn
+         && ! wm.self().isKickable()
+         && ! wm.kickableTeammate()
+         && ! wm.kickableOpponent() )
+    {
+        M_cache_time = wm.time();
+        M_cache_ball_pos = wm.ball().pos();
+        M_cache_ball_vel = ball_vel;
+        M_cache_ball_steps = sim.ballCacheSize();
+    }
 
     dlog.addText( Logger::INTERCEPT,
                   "<-----Intercept Self reach step = %d. exhaust reach step = %d ",
@@ -403,7 +632,8 @@ InterceptTable::predictSelf( const WorldModel & wm )
 
 */
 void
-InterceptTable::predictTeammate( const WorldModel & wm )
+InterceptTable::predictTeammate( const WorldModel & wm,
+                                 const InterceptSimulatorPlayer & sim )
 {
     int min_step = 1000;
     int second_min_step = 1000;
@@ -422,9 +652,6 @@ InterceptTable::predictTeammate( const WorldModel & wm )
                       M_first_teammate->pos().x, M_first_teammate->pos().y );
     }
 
-    InterceptSimulatorPlayer sim( wm.ball().pos(),
-                                  ( wm.kickableOpponent() ? Vector2D( 0.0, 0.0 ) : wm.ball().vel() ) );
-
     for ( const PlayerObject * t : wm.teammatesFromBall() )
     {
         if ( t == wm.kickableTeammate() )
@@ -443,10 +670,12 @@ InterceptTable::predictTeammate( const WorldModel & wm )
             continue;
         }
 
-        int step = sim.simulate( wm, *t, false );
+        int step = 1000;
+        int goalie_step = -1;
+        predictPlayer( wm, sim, *t, step, goalie_step );
         if ( t->goalie() )
         {
-            M_our_goalie_step = sim.simulate( wm, *t, true );
+            M_our_goalie_step = goalie_step;
             if ( step > M_our_goalie_step )
             {
                 step = M_our_goalie_step;
@@ -490,7 +719,8 @@ InterceptTable::predictTeammate( const WorldModel & wm )
 
 */
 void
-InterceptTable::predictOpponent( const WorldModel & wm )
+InterceptTable::predictOpponent( const WorldModel & wm,
+                                 const InterceptSimulatorPlayer & sim )
 {
     int min_step = 1000;
     int second_min_step = 1000;
@@ -509,9 +739,6 @@ InterceptTable::predictOpponent( const WorldModel & wm )
                       M_first_opponent->pos().x, M_first_opponent->pos().y );
     }
 
-    InterceptSimulatorPlayer sim( wm.ball().pos(),
-                                  ( wm.kickableOpponent() ? Vector2D( 0.0, 0.0 ) : wm.ball().vel() ) );
-
     for ( const PlayerObject * o : wm.opponentsFromBall() )
     {
         if ( o == wm.kickableOpponent() )
@@ -530,10 +757,11 @@ InterceptTable::predictOpponent( const WorldModel & wm )
             continue;
         }
 
-        int step = sim.simulate( wm, *o, false );
+        int step = 1000;
+        int goalie_step = -1;
+        predictPlayer( wm, sim, *o, step, goalie_step );
         if ( o->goalie() )
         {
-            int goalie_step = sim.simulate( wm, *o, true );
             if ( goalie_step > 0
                  && step > goalie_step )
             {
@@ -42,6 +42,7 @@
 namespace rcsc {
 
 class AbstractPlayerObject;
+class InterceptSimulatorPlayer;
 class InterceptSimulatorSelf;
 class PlayerObject;
 class WorldModel;
@@ -51,10 +52,32 @@ class WorldModel;
 /*!
   \class InterceptTable
   \brief interception info holder for all players
+
+  The results of other players are reused in the next cycle if the ball
+  follows the predicted free flight trajectory and nobody can kick it.
+  A player who is not observed in the next cycle is simulated from the
+  same last observed state with one more bonus step, so the reach step
+  of the last cycle minus one is reused.  Only the results that need no
+  turn are reused, because the turn cycles depend on the predicted
+  velocity.  Players with new observations are simulated again, and all
+  players are simulated again if the ball state is changed.
 */
 class InterceptTable {
 private:
 
+    /*!
+      \struct PlayerCache
+      \brief simulation result of the player in the last update
+    */
+    struct PlayerCache {
+        int id_; //!< player object id
+        int seen_pos_count_; //!< seen position accuracy at the simulation
+        int heard_pos_count_; //!< heard position accuracy at the simulation
+        int step_; //!< simulated reach step
+        int goalie_step_; //!< simulated reach step as goalie. negative if not simulated
+        bool turn_free_; //!< true if no turn is required in the simulation
+    };
+
     //! last updated time
     GameTime M_update_time;
 
@@ -91,6 +114,21 @@ private:
     //! all players' intercept step container. key: pointer, value: step value
     std::map< const AbstractPlayerObject *, int > M_player_map;
 
+    //! time of the cached player results. only valid in play_on
+    GameTime M_cache_time;
+    //! ball position used in the cached player results
+    Vector2D M_cache_ball_pos;
+    //! ball velocity used in the cached player results
+    Vector2D M_cache_ball_vel;
+    //! size of the predicted ball positions used in the cached player results
+    int M_cache_ball_steps;
+    //! simulation results of the last update
+    std::vector< PlayerCache > M_last_player_cache;
+    //! simulation results of the current update
+    std::vector< PlayerCache > M_player_cache;
+    //! number of players whose last result is reused in the current update
+    int M_reuse_count;
+
     // not used
     InterceptTable( const InterceptTable & ) = delete;
     InterceptTable & operator=( const InterceptTable & ) = delete;
@@ -228,12 +266,55 @@ public:
           return M_player_map;
       }
 
+    /*!
+      \brief get the number of players whose last result is reused in the last update
+      \return the number of players
+     */
+    int reuseCount() const
+      {
+          return M_reuse_count;
+      }
+
 private:
     /*!
       \brief clear all cached data
     */
     void clear();
 
+    /*!
+      \brief check if the last player results can be reused in this cycle
+      \param wm const reference to the world model
+      \return true if the ball follows the predicted trajectory
+    */
+    bool isCacheConsistent( const WorldModel & wm ) const;
+
+    /*!
+      \brief get the shifted step from the last player results
+      \param player the target player
+      \param ball_steps size of the predicted ball positions in this cycle
+      \param step reference to the result variable
+      \param goalie_step reference to the result variable
+      \return true if the last result is reused
+    */
+    bool getShiftedStep( const PlayerObject & player,
+                         const int ball_steps,
+                         int & step,
+                         int & goalie_step ) const;
+
+    /*!
+      \brief predict the reach step of the player, or reuse the last result
+      \param wm const reference to the world model
+      \param sim player intercept simulator for this cycle
+      \param player the target player
+      \param step reference to the result variable
+      \param goalie_step reference to the result variable. negative if not simulated
+    */
+    void predictPlayer( const WorldModel & wm,
+                        const InterceptSimulatorPlayer & sim,
+                        const PlayerObject & player,
+                        int & step,
+                        int & goalie_step );
+
     /*!
       \brief predict self interception
       \param wm const reference to the world model
@@ -243,14 +324,18 @@ private:
     /*!
       \predict teammate interception
       \param wm const reference to the world model
+      \param sim player intercept simulator for this cycle
     */
-    void predictTeammate( const WorldModel & wm );
+    void predictTeammate( const WorldModel & wm,
+                          const InterceptSimulatorPlayer & sim );
 
     /*!
       \predict opponent interception
       \param wm const reference to the world model
+      \param sim player intercept simulator for this cycle
     */
-    void predictOpponent( const WorldModel & wm );
+    void predictOpponent( const WorldModel & wm,
+                          const InterceptSimulatorPlayer & sim );
 };
 
 }
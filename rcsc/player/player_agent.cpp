@@ -42,6 +42,8 @@
 
 #include "localization_default.h"
 
+#include "compute_budget.h"
+#include "decision_timing_estimator.h"
 #include "player_command.h"
 #include "say_message_builder.h"
 #include "soccer_action.h"
@@ -63,10 +65,13 @@
 #include <rcsc/game_time.h>
 #include <rcsc/game_mode.h>
 #include <rcsc/timer.h>
+#include <rcsc/time/cycle_clock.h>
 #include <rcsc/version.h>
 
+#include <algorithm>
 #include <sstream>
 #include <cstdio>
+#include <cmath>
 #include <cstring>
 
 //#define PROFILE_SEE
@@ -128,6 +133,25 @@ struct PlayerAgent::Impl {
     //! counter of see message arrival timing
     int see_timings_[11];
 
+    //! timeout count since the last server message
+    int timeout_count_;
+
+    //! cycle relative time based on body_time_stamp_
+    CycleClock cycle_clock_;
+    //! time when the current decision is started
+    TimeStamp decision_start_time_;
+
+    //! estimator of the see arrival offset and the think time
+    DecisionTimingEstimator timing_estimator_;
+
+    //! milli seconds left in the cycle when the last command was sent
+    double decision_slack_msec_;
+    //! minimum slack of all decisions
+    double slack_min_;
+
+    //! time budget of the current decision
+    ComputeBudget compute_budget_;
+
     //! pointer to reserved action
     std::shared_ptr< ArmAction > arm_action_;
 
@@ -154,7 +178,11 @@ struct PlayerAgent::Impl {
           last_decision_time_( -1, 0 ),
           current_time_( 0, 0 ),
           clang_min_( 0 ),
-          clang_max_( 0 )
+          clang_max_( 0 ),
+          timeout_count_( 0 ),
+          timing_estimator_(),
+          decision_slack_msec_( 0.0 ),
+          slack_min_( 0.0 )
       {
           for ( int i = 0; i < 11; ++i )
           {
@@ -351,6 +379,31 @@ struct PlayerAgent::Impl {
     bool isDecisionTiming( const long & msec_from_sense,
                            const int timeout_count ) const;
 
+    /*!
+      \brief estimate the time until the decision timing.
+      This method follows the same conditions as isDecisionTiming().
+      \return micro seconds from now. if the decision is not pending,
+      the value for the server down check is returned.
+    */
+    std::int64_t decisionTimeoutUSec() const;
+
+    /*!
+      \brief get the wait threshold for the see message
+      \return milli seconds from the sense_body arrival in the real time
+     */
+    double waitTimeThreshold() const;
+
+    /*!
+      \brief start the compute budget of the current decision.
+     */
+    void startComputeBudget();
+
+    /*!
+      \brief record the slack between the command send time and the end of the current cycle.
+      \param see_missed true if the decision is started before the expected see arrival
+     */
+    void updateDecisionSlack( const bool see_missed );
+
 
     /*!
       \brief adjust see message timing.
@@ -585,9 +638,7 @@ PlayerAgent::Impl::isDecisionTiming( const long & msec_from_sense,
         return true;
     }
 
-    const int wait_thr = ( see_state_.isSynch()
-                           ? agent_.config().waitTimeThrSynchView()
-                           : agent_.config().waitTimeThrNoSynchView() );
+    const double wait_thr = waitTimeThreshold();
 
     // already done in sense_body received cycle.
     // When referee message is sent before sense_body,
@@ -609,11 +660,11 @@ PlayerAgent::Impl::isDecisionTiming( const long & msec_from_sense,
 
     // synch_see mode, and big see_offset
     if ( SeeState::synch_see_mode()
-         && ServerParam::i().synchSeeOffset() > wait_thr
+         && ServerParam::i().synchSeeOffset() * ServerParam::i().slowDownFactor() > wait_thr
          && msec_from_sense >= 0 )
     {
         dlog.addText( Logger::SYSTEM,
-                      __FILE__" (isDicisionTiming) [true] synch_see mode. offset(%d) > threshold(%d)",
+                      __FILE__" (isDicisionTiming) [true] synch_see mode. offset(%d) > threshold(%.1f)",
                       ServerParam::i().synchSeeOffset(), wait_thr );
         return true;
     }
@@ -629,7 +680,7 @@ PlayerAgent::Impl::isDecisionTiming( const long & msec_from_sense,
     }
 
     // over the wait threshold
-    if ( msec_from_sense >= wait_thr * ServerParam::i().slowDownFactor() )
+    if ( msec_from_sense >= wait_thr )
     {
         if ( see_state_.isSynch() )
         {
@@ -653,6 +704,137 @@ PlayerAgent::Impl::isDecisionTiming( const long & msec_from_sense,
     return false;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::int64_t
+PlayerAgent::Impl::decisionTimeoutUSec() const
+{
+    // used if no decision is pending. the client wakes up only to check the server status.
+    const std::int64_t idle_usec = static_cast< std::int64_t >( ServerParam::i().simulatorStep() )
+        * ServerParam::i().slowDownFactor() * 1000;
+
+    if ( ServerParam::i().synchMode()
+         || ! body_time_stamp_.isValid()
+         || last_decision_time_ == current_time_
+         || agent_.world().self().unum() == Unum_Unknown )
+    {
+        return idle_usec;
+    }
+
+    if ( agent_.world().seeTime() == current_time_ )
+    {
+        return 0;
+    }
+
+    const double wait_thr = waitTimeThreshold();
+
+    // waiting for sense_body. see isDecisionTiming().
+    if ( last_decision_time_ == agent_.world().senseBodyTime()
+         && timeout_count_ <= 2 )
+    {
+        return static_cast< std::int64_t >( agent_.M_client->intervalMSec() ) * 1000;
+    }
+
+    if ( SeeState::synch_see_mode()
+         && ServerParam::i().synchSeeOffset() * ServerParam::i().slowDownFactor() > wait_thr )
+    {
+        return 0;
+    }
+
+    if ( see_state_.isSynch()
+         && see_state_.cyclesTillNextSee() > 0 )
+    {
+        return 0;
+    }
+
+    const std::int64_t usec_from_sense = TimeStamp::now().usecSince( body_time_stamp_ );
+    // isDecisionTiming() compares the truncated milli seconds
+    const std::int64_t deadline_usec = static_cast< std::int64_t >( std::ceil( wait_thr ) ) * 1000;
+
+    return std::max( static_cast< std::int64_t >( 0 ), deadline_usec - usec_from_sense );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+PlayerAgent::Impl::waitTimeThreshold() const
+{
+    const int slow_down = ServerParam::i().slowDownFactor();
+
+    if ( see_state_.isSynch() )
+    {
+        const double thr = agent_.config().waitTimeThrSynchView() * slow_down;
+        return ( agent_.config().adaptiveWaitTime()
+                 ? timing_estimator_.synchViewWaitMSec( thr )
+                 : thr );
+    }
+
+    const double thr = agent_.config().waitTimeThrNoSynchView() * slow_down;
+    return ( agent_.config().adaptiveWaitTime()
+             ? timing_estimator_.noSynchViewWaitMSec( thr )
+             : thr );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerAgent::Impl::startComputeBudget()
+{
+    if ( ServerParam::i().synchMode()
+         || ! cycle_clock_.isValid() )
+    {
+        // no real time deadline
+        compute_budget_.start( TimeStamp() );
+        return;
+    }
+
+    const double deadline_msec = cycle_clock_.cycleMSec() - agent_.config().computeBudgetMargin();
+    compute_budget_.start( cycle_clock_.at( deadline_msec ) );
+
+    dlog.addText( Logger::SYSTEM,
+                  __FILE__" (startComputeBudget) deadline %.3f [ms] from sense_body, remaining %.3f [ms]",
+                  deadline_msec, compute_budget_.remainingUSec() * 0.001 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerAgent::Impl::updateDecisionSlack( const bool see_missed )
+{
+    if ( ServerParam::i().synchMode()
+         || ! body_time_stamp_.isValid() )
+    {
+        return;
+    }
+
+    const TimeStamp now = TimeStamp::now();
+    const double msec_from_sense = cycle_clock_.msecFromSenseBody( now );
+    const double think_msec = now.msecSince( decision_start_time_ );
+
+    decision_slack_msec_ = cycle_clock_.msecToCycleEnd( now );
+
+    if ( timing_estimator_.decisionCount() == 0
+         || decision_slack_msec_ < slack_min_ )
+    {
+        slack_min_ = decision_slack_msec_;
+    }
+
+    timing_estimator_.addThinkTime( think_msec );
+    timing_estimator_.addDecision( msec_from_sense, see_missed );
+
+    dlog.addText( Logger::SYSTEM,
+                  __FILE__" (updateDecisionSlack) %.3f [ms] from sense_body, think %.3f [ms], slack %.3f [ms]",
+                  msec_from_sense, think_msec, decision_slack_msec_ );
+}
+
 ///////////////////////////////////////////////////////////////////////
 
 /*-------------------------------------------------------------------*/
@@ -780,6 +962,48 @@ PlayerAgent::seeTimeStamp() const
     return M_impl->see_time_stamp_;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const
+CycleClock &
+PlayerAgent::cycleClock() const
+{
+    return M_impl->cycle_clock_;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+PlayerAgent::decisionSlackMSec() const
+{
+    return M_impl->decision_slack_msec_;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ComputeBudget &
+PlayerAgent::computeBudget()
+{
+    return M_impl->compute_budget_;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const
+ComputeBudget &
+PlayerAgent::computeBudget() const
+{
+    return M_impl->compute_budget_;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -879,6 +1103,7 @@ PlayerAgent::handleStart()
     }
 
     M_client->setIntervalMSec( config().intervalMSec() );
+    M_impl->timing_estimator_.setMissProbability( config().decisionMissProbability() );
 
     M_impl->sendInitCommand();
     return true;
@@ -923,6 +1148,8 @@ PlayerAgent::handleMessage()
     int counter = 0;
     GameTime start_time = M_impl->current_time_;
 
+    M_impl->timeout_count_ = 0;
+
     // receive and analyze message
     while ( M_client->receiveMessage() > 0 )
     {
@@ -1022,6 +1249,8 @@ PlayerAgent::handleTimeout( const int timeout_count,
         return;
     }
 
+    M_impl->timeout_count_ = timeout_count;
+
     TimeStamp cur_time;
     cur_time.setNow();
 
@@ -1067,6 +1296,16 @@ PlayerAgent::handleTimeout( const int timeout_count,
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::int64_t
+PlayerAgent::nextTimeoutUSec() const
+{
+    return M_impl->decisionTimeoutUSec();
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -1154,6 +1393,30 @@ PlayerAgent::finalize()
         std::printf( "%6d", M_impl->see_timings_[i] );
     }
     std::printf( "\n" );
+    {
+        const DecisionTimingEstimator & est = M_impl->timing_estimator_;
+        if ( est.decisionCount() > 0 )
+        {
+            std::printf( "decision timing: %d decisions, %d missed cycles, %d missed sees,"
+                         " mean idle slack %.2f min slack %.2f [ms]\n",
+                         est.decisionCount(),
+                         est.missedCycleCount(),
+                         est.missedSeeCount(),
+                         est.idleSlackMSec() / est.decisionCount(),
+                         M_impl->slack_min_ );
+        }
+    }
+    {
+        const ComputeBudget & budget = M_impl->compute_budget_;
+        if ( budget.totalSearchCount() > 0 )
+        {
+            std::printf( "compute budget: %ld/%ld searches truncated in %ld/%ld cycles\n",
+                         budget.totalTruncatedCount(),
+                         budget.totalSearchCount(),
+                         budget.totalTruncatedCycleCount(),
+                         budget.totalCycleCount() );
+        }
+    }
 #endif
     std::cout << config().teamName() << ' '
               << world().self().unum() << ": "
@@ -1555,6 +1818,11 @@ PlayerAgent::Impl::analyzeSee( const char * msg )
     if ( body_time_stamp_.isValid() )
     {
         msec_from_sense = see_time_stamp_.elapsedSince( body_time_stamp_ );
+        if ( see_state_.isSynch()
+             && ! ServerParam::i().synchMode() )
+        {
+            timing_estimator_.addSeeOffset( cycle_clock_.msecFromSenseBody( see_time_stamp_ ) );
+        }
 #ifdef PROFILE_SEE
         if ( see_state_.isSynch() )
         {
@@ -1631,6 +1899,9 @@ void
 PlayerAgent::Impl::analyzeSenseBody( const char * msg )
 {
     body_time_stamp_.setNow();
+    cycle_clock_.setSenseBody( body_time_stamp_ );
+    cycle_clock_.setCycleMSec( ServerParam::i().simulatorStep() * ServerParam::i().slowDownFactor() );
+    timing_estimator_.setCycleMSec( cycle_clock_.cycleMSec() );
 
     // parse cycle info
     if ( ! analyzeCycle( msg, true ) )
@@ -2361,6 +2632,7 @@ void
 PlayerAgent::action()
 {
     Timer timer;
+    M_impl->decision_start_time_ = timer.startTime();
     dlog.addText( Logger::SYSTEM,
                   __FILE__" (action) start" );
 
@@ -2371,9 +2643,10 @@ PlayerAgent::action()
     }
 
     // check see synchronization
-    if ( M_impl->see_state_.isSynch()
-         && M_impl->see_state_.cyclesTillNextSee() == 0
-         && world().seeTime() != M_impl->current_time_ )
+    const bool see_missed = ( M_impl->see_state_.isSynch()
+                              && M_impl->see_state_.cyclesTillNextSee() == 0
+                              && world().seeTime() != M_impl->current_time_ );
+    if ( see_missed )
     {
         if ( SeeState::synch_see_mode()
              && ServerParam::i().synchSeeOffset() > ServerParam::i().synchOffset() )
@@ -2409,6 +2682,8 @@ PlayerAgent::action()
     // reset last action effect
     M_effector.reset();
 
+    M_impl->startComputeBudget();
+
     //
     // handle action start event
     //
@@ -2444,17 +2719,16 @@ PlayerAgent::action()
     // ------------------------------------------------------------------------
     // compose command string, and send it to the rcssserver
     {
-        std::ostringstream ostr;
-        M_effector.makeCommand( ostr );
-        const std::string str = ostr.str();
-        if ( str.length() > 0 )
+        const char * msg = M_effector.makeCommand();
+        if ( *msg != '\0' )
         {
             dlog.addText( Logger::SYSTEM,
                           "---- send[%s]",
-                          str.c_str() );
-            M_client->sendMessage( str.c_str() );
+                          msg );
+            M_client->sendMessage( msg );
         }
     }
+    M_impl->updateDecisionSlack( see_missed );
 
     // ------------------------------------------------------------------------
     // update last decision time
@@ -2463,6 +2737,13 @@ PlayerAgent::action()
 
     dlog.addText( Logger::SYSTEM,
                   __FILE__" (action) elapsed %lf [ms]", elapsed );
+    if ( M_impl->compute_budget_.truncatedCount() > 0 )
+    {
+        dlog.addText( Logger::SYSTEM,
+                      __FILE__" (action) budget truncated %d/%d searches",
+                      M_impl->compute_budget_.truncatedCount(),
+                      M_impl->compute_budget_.searchCount() );
+    }
     M_debug_client.addMessage( "%.0fms", elapsed );
 
     //
@@ -49,6 +49,8 @@ namespace rcsc {
 class AudioSensor;
 class ArmAction;
 class BodySensor;
+class ComputeBudget;
+class CycleClock;
 class FullstateSensor;
 class FreeformMessageParser;
 class SayMessage;
@@ -203,6 +205,34 @@ public:
     */
     const TimeStamp & seeTimeStamp() const;
 
+    /*!
+      \brief get the clock relative to the sense_body arrival of the current cycle
+      \return const reference to the clock object
+    */
+    const CycleClock & cycleClock() const;
+
+    /*!
+      \brief get the slack of the last decision, i.e., the time left in
+      the cycle when the last command was sent.
+      \return milli seconds. a negative value means the command was sent
+      after the estimated end of the cycle.
+    */
+    double decisionSlackMSec() const;
+
+    /*!
+      \brief get the compute budget of the current decision. search based
+      actions should poll ComputeBudget::shouldStop() and report the
+      result by ComputeBudget::addSearch().
+      \return reference to the budget object
+    */
+    ComputeBudget & computeBudget();
+
+    /*!
+      \brief get the compute budget of the current decision
+      \return const reference to the budget object
+    */
+    const ComputeBudget & computeBudget() const;
+
     /*!
       \brief register kick command
       \param power command argument: kick power
@@ -459,6 +489,14 @@ protected:
     void handleTimeout( const int timeout_count,
                         const int waited_msec );
 
+    /*!
+      \brief get the time until the decision deadline.
+      \return micro seconds from now.
+      This method is called from AbstractClient::run() method to arm the timer.
+    */
+    virtual
+    std::int64_t nextTimeoutUSec() const;
+
     /*!
       \brief handle exit event
     */
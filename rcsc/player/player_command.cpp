@@ -37,8 +37,123 @@
 
 #include "see_state.h"
 
+#include <charconv>
+#include <cstring>
+
 namespace rcsc {
 
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief append the string. NULL is propagated.
+ */
+inline
+char *
+put_str( char * first,
+         char * last,
+         const char * str,
+         const std::size_t len )
+{
+    if ( ! first
+         || static_cast< std::size_t >( last - first ) < len )
+    {
+        return nullptr;
+    }
+
+    std::memcpy( first, str, len );
+    return first + len;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief append the string literal. NULL is propagated.
+ */
+template < std::size_t N >
+inline
+char *
+put_str( char * first,
+         char * last,
+         const char ( &str )[N] )
+{
+    return put_str( first, last, str, N - 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief append the string. NULL is propagated.
+ */
+inline
+char *
+put_str( char * first,
+         char * last,
+         const std::string & str )
+{
+    return put_str( first, last, str.data(), str.length() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief append the character. NULL is propagated.
+ */
+inline
+char *
+put_char( char * first,
+          char * last,
+          const char c )
+{
+    if ( ! first
+         || first == last )
+    {
+        return nullptr;
+    }
+
+    *first = c;
+    return first + 1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief append the integer. NULL is propagated.
+ */
+inline
+char *
+put_int( char * first,
+         char * last,
+         const int value )
+{
+    if ( ! first )
+    {
+        return nullptr;
+    }
+
+    const std::to_chars_result result = std::to_chars( first, last, value );
+    return ( result.ec == std::errc() ? result.ptr : nullptr );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief append the floating point value in the same format as the
+  default std::ostream (%g, precision 6). NULL is propagated.
+ */
+inline
+char *
+put_double( char * first,
+            char * last,
+            const double value )
+{
+    if ( ! first )
+    {
+        return nullptr;
+    }
+
+    const std::to_chars_result result = std::to_chars( first, last, value,
+                                                       std::chars_format::general, 6 );
+    return ( result.ec == std::errc() ? result.ptr : nullptr );
+}
+
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -79,6 +194,29 @@ PlayerInitCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerInitCommand::toCommandBuffer( char * first,
+                                    char * last ) const
+{
+    first = put_str( first, last, "(init " );
+    first = put_str( first, last, M_team_name );
+    if ( M_version >= 4.0 )
+    {
+        first = put_str( first, last, " (version " );
+        first = put_double( first, last, M_version );
+        first = put_char( first, last, ')' );
+        if ( M_goalie )
+        {
+            first = put_str( first, last, " (goalie)" );
+        }
+    }
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 PlayerReconnectCommand::PlayerReconnectCommand( const std::string & team_name,
                                                 const int unum )
@@ -101,6 +239,21 @@ PlayerReconnectCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerReconnectCommand::toCommandBuffer( char * first,
+                                         char * last ) const
+{
+    first = put_str( first, last, "(reconnect " );
+    first = put_str( first, last, M_team_name );
+    first = put_char( first, last, ' ' );
+    first = put_int( first, last, M_unum );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 PlayerByeCommand::PlayerByeCommand()
 {
@@ -120,6 +273,17 @@ PlayerByeCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerByeCommand::toCommandBuffer( char * first,
+                                   char * last ) const
+{
+    return put_str( first, last, "(bye)" );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerMoveCommand::toCommandString( std::ostream & to ) const
@@ -130,6 +294,21 @@ PlayerMoveCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerMoveCommand::toCommandBuffer( char * first,
+                                    char * last ) const
+{
+    first = put_str( first, last, "(move " );
+    first = put_double( first, last, M_x );
+    first = put_char( first, last, ' ' );
+    first = put_double( first, last, M_y );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerDashCommand::toCommandString( std::ostream & to ) const
@@ -154,6 +333,37 @@ PlayerDashCommand::toCommandString( std::ostream & to ) const
     return to;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+char *
+PlayerDashCommand::toCommandBuffer( char * first,
+                                    char * last ) const
+{
+    if ( ! M_two_legs )
+    {
+        first = put_str( first, last, "(dash " );
+        first = put_double( first, last, M_power );
+        if ( M_dir != 0.0 )
+        {
+            first = put_char( first, last, ' ' );
+            first = put_double( first, last, M_dir );
+        }
+        return put_char( first, last, ')' );
+    }
+
+    first = put_str( first, last, "(dash (l " );
+    first = put_double( first, last, M_left_power );
+    first = put_char( first, last, ' ' );
+    first = put_double( first, last, M_left_dir );
+    first = put_str( first, last, ") (r " );
+    first = put_double( first, last, M_right_power );
+    first = put_char( first, last, ' ' );
+    first = put_double( first, last, M_right_dir );
+    return put_str( first, last, "))" );
+}
+
 
 /*-------------------------------------------------------------------*/
 // std::ostream &
@@ -179,6 +389,19 @@ PlayerTurnCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerTurnCommand::toCommandBuffer( char * first,
+                                    char * last ) const
+{
+    first = put_str( first, last, "(turn " );
+    first = put_double( first, last, M_moment );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerKickCommand::toCommandString( std::ostream & to ) const
@@ -189,6 +412,21 @@ PlayerKickCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerKickCommand::toCommandBuffer( char * first,
+                                    char * last ) const
+{
+    first = put_str( first, last, "(kick " );
+    first = put_double( first, last, M_power );
+    first = put_char( first, last, ' ' );
+    first = put_double( first, last, M_dir );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerCatchCommand::toCommandString( std::ostream & to ) const
@@ -199,6 +437,19 @@ PlayerCatchCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerCatchCommand::toCommandBuffer( char * first,
+                                     char * last ) const
+{
+    first = put_str( first, last, "(catch " );
+    first = put_double( first, last, M_dir );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerTackleCommand::toCommandString( std::ostream & to ) const
@@ -216,6 +467,23 @@ PlayerTackleCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerTackleCommand::toCommandBuffer( char * first,
+                                      char * last ) const
+{
+    first = put_str( first, last, "(tackle " );
+    first = put_double( first, last, M_power_or_dir );
+    if ( M_foul )
+    {
+        first = put_str( first, last, " on" );
+    }
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerTurnNeckCommand::toCommandString( std::ostream & to ) const
@@ -226,6 +494,19 @@ PlayerTurnNeckCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerTurnNeckCommand::toCommandBuffer( char * first,
+                                        char * last ) const
+{
+    first = put_str( first, last, "(turn_neck " );
+    first = put_double( first, last, M_moment );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerChangeViewCommand::toCommandString( std::ostream & to ) const
@@ -244,6 +525,26 @@ PlayerChangeViewCommand::toCommandString( std::ostream & to ) const
     return to;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+char *
+PlayerChangeViewCommand::toCommandBuffer( char * first,
+                                          char * last ) const
+{
+    first = put_str( first, last, "(change_view " );
+    first = put_str( first, last, M_width.str() );
+
+    if ( ! SeeState::synch_see_mode() )
+    {
+        first = put_char( first, last, ' ' );
+        first = put_str( first, last, M_quality.str() );
+    }
+
+    return put_char( first, last, ')' );
+}
+
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -258,6 +559,21 @@ PlayerChangeFocusCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerChangeFocusCommand::toCommandBuffer( char * first,
+                                           char * last ) const
+{
+    first = put_str( first, last, "(change_focus " );
+    first = put_double( first, last, M_moment_dist );
+    first = put_char( first, last, ' ' );
+    first = put_double( first, last, M_moment_dir );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerSayCommand::toCommandString( std::ostream & to ) const
@@ -279,6 +595,31 @@ PlayerSayCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerSayCommand::toCommandBuffer( char * first,
+                                   char * last ) const
+{
+    if ( M_message.empty() )
+    {
+        return first;
+    }
+
+    if ( M_version >= 8.0 )
+    {
+        first = put_str( first, last, "(say \"" );
+        first = put_str( first, last, M_message );
+        return put_str( first, last, "\")" );
+    }
+
+    first = put_str( first, last, "(say " );
+    first = put_str( first, last, M_message );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerPointtoCommand::toCommandString( std::ostream & to ) const
@@ -297,6 +638,26 @@ PlayerPointtoCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerPointtoCommand::toCommandBuffer( char * first,
+                                       char * last ) const
+{
+    if ( ! M_on )
+    {
+        return put_str( first, last, "(pointto off)" );
+    }
+
+    first = put_str( first, last, "(pointto " );
+    first = put_double( first, last, M_dist );
+    first = put_char( first, last, ' ' );
+    first = put_double( first, last, M_dir );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerAttentiontoCommand::toCommandString( std::ostream & to ) const
@@ -314,6 +675,31 @@ PlayerAttentiontoCommand::toCommandString( std::ostream & to ) const
     return to;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+char *
+PlayerAttentiontoCommand::toCommandBuffer( char * first,
+                                           char * last ) const
+{
+    if ( M_side == NONE )
+    {
+        return put_str( first, last, "(attentionto off)" );
+    }
+
+    if ( M_side == OUR )
+    {
+        first = put_str( first, last, "(attentionto our " );
+    }
+    else
+    {
+        first = put_str( first, last, "(attentionto opp " );
+    }
+    first = put_int( first, last, M_number );
+    return put_char( first, last, ')' );
+}
+
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -328,6 +714,21 @@ PlayerCLangCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerCLangCommand::toCommandBuffer( char * first,
+                                     char * last ) const
+{
+    first = put_str( first, last, "(clang (ver " );
+    first = put_int( first, last, M_min );
+    first = put_char( first, last, ' ' );
+    first = put_int( first, last, M_max );
+    return put_str( first, last, "))" );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerEarCommand::toCommandString( std::ostream & to ) const
@@ -372,6 +773,48 @@ PlayerEarCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerEarCommand::toCommandBuffer( char * first,
+                                   char * last ) const
+{
+    first = put_str( first, last, "(ear (" );
+
+    if ( M_onoff == ON )
+    {
+        first = put_str( first, last, "on" );
+    }
+    else
+    {
+        first = put_str( first, last, "off" );
+    }
+
+    if ( M_side == OUR )
+    {
+        first = put_str( first, last, " our" );
+    }
+    else
+    {
+        first = put_str( first, last, " opp" );
+    }
+
+    switch ( M_mode ) {
+    case COMPLETE:
+        first = put_str( first, last, " complete" );
+        break;
+    case PARTIAL:
+        first = put_str( first, last, " partial" );
+        break;
+    default:
+        break;
+    }
+
+    return put_str( first, last, "))" );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerSenseBodyCommand::toCommandString( std::ostream & to ) const
@@ -382,6 +825,17 @@ PlayerSenseBodyCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerSenseBodyCommand::toCommandBuffer( char * first,
+                                         char * last ) const
+{
+    return put_str( first, last, "(sense_body)" );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerScoreCommand::toCommandString( std::ostream & to ) const
@@ -392,6 +846,17 @@ PlayerScoreCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerScoreCommand::toCommandBuffer( char * first,
+                                     char * last ) const
+{
+    return put_str( first, last, "(score)" );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerCompressionCommand::toCommandString( std::ostream & to ) const
@@ -402,6 +867,19 @@ PlayerCompressionCommand::toCommandString( std::ostream & to ) const
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+char *
+PlayerCompressionCommand::toCommandBuffer( char * first,
+                                           char * last ) const
+{
+    first = put_str( first, last, "(compression " );
+    first = put_int( first, last, M_level );
+    return put_char( first, last, ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 std::ostream &
 PlayerDoneCommand::toCommandString( std::ostream & to ) const
@@ -409,4 +887,15 @@ PlayerDoneCommand::toCommandString( std::ostream & to ) const
     return to << "(done)";
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+char *
+PlayerDoneCommand::toCommandBuffer( char * first,
+                                    char * last ) const
+{
+    return put_str( first, last, "(done)" );
+}
+
 }
@@ -113,6 +113,16 @@ public:
     virtual
     std::ostream & toCommandString( std::ostream & to ) const = 0;
 
+    /*!
+      \brief write command string to the buffer (pure virtual)
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    virtual
+    char * toCommandBuffer( char * first,
+                            char * last ) const = 0;
+
     /*!
       \brief get command name (pure virtual)
       \return command name string
@@ -168,6 +178,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -221,6 +240,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -268,6 +296,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -317,6 +354,16 @@ public:
     virtual
     std::ostream & toCommandString( std::ostream & to ) const = 0;
 
+    /*!
+      \brief write command string to the buffer (pure virtual)
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    virtual
+    char * toCommandBuffer( char * first,
+                            char * last ) const = 0;
+
     /*!
       \brief get command name (pure virtual)
       \return command name string
@@ -447,6 +494,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -544,6 +600,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -689,6 +754,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -752,6 +826,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -820,6 +903,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -888,6 +980,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -951,6 +1052,16 @@ public:
     virtual
     std::ostream & toCommandString( std::ostream & to ) const = 0;
 
+    /*!
+      \brief write command string to the buffer (pure virtual)
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    virtual
+    char * toCommandBuffer( char * first,
+                            char * last ) const = 0;
+
     /*!
       \brief get command name (pure virtual)
       \return command name string
@@ -1001,6 +1112,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command name
       \return command name string
@@ -1067,6 +1187,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -1143,6 +1272,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get thencommand name
       \return command name string
@@ -1236,6 +1374,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -1330,6 +1477,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -1434,6 +1590,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -1516,6 +1681,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -1643,6 +1817,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -1721,6 +1904,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -1771,6 +1963,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -1824,6 +2025,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -1881,6 +2091,15 @@ public:
     */
     std::ostream & toCommandString( std::ostream & to ) const;
 
+    /*!
+      \brief write command string to the buffer
+      \param first the first position of the buffer
+      \param last the end of the buffer
+      \return the end of the written string. if the buffer is too short, NULL is returned.
+    */
+    char * toCommandBuffer( char * first,
+                            char * last ) const;
+
     /*!
       \brief get command paramter
       \return turn neck moment of this command
@@ -84,6 +84,10 @@ PlayerConfig::setDefaultParam()
     M_wait_time_thr_synch_view = 30; //79;
     M_wait_time_thr_nosynch_view = 75;
 
+    M_adaptive_wait_time = false;
+    M_decision_miss_probability = 0.01;
+    M_compute_budget_margin = 5.0;
+
     M_normal_view_time_thr = 15;
 
     M_rcssserver_host = "localhost";
@@ -198,6 +202,12 @@ PlayerConfig::createParamMap()
 
         ( "wait_time_thr_synch_view", "", &M_wait_time_thr_synch_view )
         ( "wait_time_thr_nosynch_view","", &M_wait_time_thr_nosynch_view )
+        ( "adaptive_wait_time", "", &M_adaptive_wait_time,
+          "estimate the wait time thresholds from the observed see arrival and think time." )
+        ( "decision_miss_probability", "", &M_decision_miss_probability,
+          "target probability to send the command after the end of the cycle, used with adaptive_wait_time." )
+        ( "compute_budget_margin", "", &M_compute_budget_margin,
+          "milli seconds left before the end of the cycle when the compute budget of the actions expires." )
 
         ( "normal_view_time_thr", "", &M_normal_view_time_thr )
 
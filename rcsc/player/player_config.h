@@ -64,6 +64,13 @@ private:
     //! msec threshold for action decision timing when no see sync
     int M_wait_time_thr_nosynch_view;
 
+    //! if true, wait time thresholds are estimated online
+    bool M_adaptive_wait_time;
+    //! target probability to send the command after the end of the cycle
+    double M_decision_miss_probability;
+    //! milli seconds left before the end of the cycle when the compute budget expires
+    double M_compute_budget_margin;
+
     //! msec threshold for normal view width when manual see sync
     int M_normal_view_time_thr;
 
@@ -256,6 +263,24 @@ public:
      */
     int waitTimeThrNoSynchView() const { return M_wait_time_thr_nosynch_view; }
 
+    /*!
+      \brief check if the wait time thresholds are estimated from the observed timings
+      \return checked result
+     */
+    bool adaptiveWaitTime() const { return M_adaptive_wait_time; }
+
+    /*!
+      \brief get the target probability to send the command after the end of the cycle
+      \return probability value
+     */
+    double decisionMissProbability() const { return M_decision_miss_probability; }
+
+    /*!
+      \brief get the time left before the end of the cycle when the compute budget expires
+      \return milli seconds
+     */
+    double computeBudgetMargin() const { return M_compute_budget_margin; }
+
     /*!
       \brief get the threshold time to change to normal view width for old timer synch view mode
       \return the threshold time to change to normal view width
@@ -0,0 +1,197 @@
+// -*-c++-*-
+
+/*!
+  \file reach_grid.cpp
+  \brief opponent and teammate reach step grid Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "reach_grid.h"
+
+#include <rcsc/player/world_model.h>
+#include <rcsc/player/abstract_player_object.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/math_util.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace rcsc {
+
+const double ReachGrid::GRID_LENGTH = 1.0;
+
+const double ReachGrid::PITCH_MAX_X = ( std::ceil( ( +ServerParam::DEFAULT_PITCH_LENGTH*0.5 + 2.0 ) / ReachGrid::GRID_LENGTH )
+                                        * ReachGrid::GRID_LENGTH );
+const double ReachGrid::PITCH_MAX_Y = ( std::ceil( ( +ServerParam::DEFAULT_PITCH_WIDTH*0.5 + 2.0 ) / ReachGrid::GRID_LENGTH )
+                                        * ReachGrid::GRID_LENGTH );
+
+const int ReachGrid::GRID_X_SIZE = static_cast< int >( std::ceil( ReachGrid::PITCH_MAX_X * 2.0 / ReachGrid::GRID_LENGTH ) ) + 1;
+const int ReachGrid::GRID_Y_SIZE = static_cast< int >( std::ceil( ReachGrid::PITCH_MAX_Y * 2.0 / ReachGrid::GRID_LENGTH ) ) + 1;
+
+const int ReachGrid::MAX_STEP = 24;
+const int ReachGrid::MAX_BONUS_STEP = 3;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+ReachGrid::ReachGrid()
+    : M_valid( false ),
+      M_opponent_step( GRID_X_SIZE * GRID_Y_SIZE, MAX_STEP ),
+      M_teammate_step( GRID_X_SIZE * GRID_Y_SIZE, MAX_STEP )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+ReachGrid::update( const WorldModel & wm )
+{
+    if ( M_valid )
+    {
+        return;
+    }
+
+    M_valid = true;
+
+    std::fill( M_opponent_step.begin(), M_opponent_step.end(), MAX_STEP );
+    std::fill( M_teammate_step.begin(), M_teammate_step.end(), MAX_STEP );
+
+    for ( const PlayerObject * p : wm.opponentsFromSelf() )
+    {
+        if ( p->posCount() > 10 ) continue;
+        add_player( *p, M_opponent_step );
+    }
+
+    for ( const PlayerObject * p : wm.teammatesFromSelf() )
+    {
+        if ( p->posCount() > 10 ) continue;
+        add_player( *p, M_teammate_step );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+ReachGrid::add_player( const AbstractPlayerObject & player,
+                       std::vector< unsigned char > & grid )
+{
+    const PlayerType * ptype = player.playerTypePtr();
+    if ( ! ptype )
+    {
+        return;
+    }
+
+    const int bonus_step = std::min( MAX_BONUS_STEP, player.posCount() );
+    const Vector2D start = player.inertiaPoint( 1 );
+    const bool use_body = ( player.bodyCount() <= 3 );
+
+    const double max_dist = ( ptype->kickableArea()
+                              + ptype->getMovableDistance( MAX_STEP + bonus_step )
+                              + GRID_LENGTH );
+    const double max_dist2 = max_dist * max_dist;
+
+    const int min_ix = bound( 0,
+                              static_cast< int >( std::ceil( ( start.x - max_dist + PITCH_MAX_X ) / GRID_LENGTH ) ),
+                              GRID_X_SIZE - 1 );
+    const int max_ix = bound( 0,
+                              static_cast< int >( std::floor( ( start.x + max_dist + PITCH_MAX_X ) / GRID_LENGTH ) ),
+                              GRID_X_SIZE - 1 );
+    const int min_iy = bound( 0,
+                              static_cast< int >( std::ceil( ( start.y - max_dist + PITCH_MAX_Y ) / GRID_LENGTH ) ),
+                              GRID_Y_SIZE - 1 );
+    const int max_iy = bound( 0,
+                              static_cast< int >( std::floor( ( start.y + max_dist + PITCH_MAX_Y ) / GRID_LENGTH ) ),
+                              GRID_Y_SIZE - 1 );
+
+    for ( int ix = min_ix; ix <= max_ix; ++ix )
+    {
+        const double dx = ix * GRID_LENGTH - PITCH_MAX_X - start.x;
+
+        for ( int iy = min_iy; iy <= max_iy; ++iy )
+        {
+            const double dy = iy * GRID_LENGTH - PITCH_MAX_Y - start.y;
+            const double d2 = dx * dx + dy * dy;
+            if ( d2 > max_dist2 ) continue;
+
+            const double dist = std::sqrt( d2 );
+            const double angle_diff = ( use_body && dist > 1.0e-3
+                                        ? ( AngleDeg::atan2_deg( dy, dx ) - player.body() ).abs()
+                                        : 0.0 );
+
+            const int step = bound( 0,
+                                    ptype->reachStep( dist, angle_diff ) - bonus_step,
+                                    MAX_STEP );
+
+            unsigned char & value = grid[ix * GRID_Y_SIZE + iy];
+            if ( step < value )
+            {
+                value = static_cast< unsigned char >( step );
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+double
+ReachGrid::interpolate( const std::vector< unsigned char > & grid,
+                        const Vector2D & pos )
+{
+    const double fx = bound( 0.0,
+                             ( pos.x + PITCH_MAX_X ) / GRID_LENGTH,
+                             static_cast< double >( GRID_X_SIZE - 1 ) );
+    const double fy = bound( 0.0,
+                             ( pos.y + PITCH_MAX_Y ) / GRID_LENGTH,
+                             static_cast< double >( GRID_Y_SIZE - 1 ) );
+
+    const int ix = std::min( static_cast< int >( fx ), GRID_X_SIZE - 2 );
+    const int iy = std::min( static_cast< int >( fy ), GRID_Y_SIZE - 2 );
+
+    const double tx = fx - ix;
+    const double ty = fy - iy;
+
+    const int idx = ix * GRID_Y_SIZE + iy;
+
+    return ( ( 1.0 - tx ) * ( 1.0 - ty ) * grid[idx]
+             + tx * ( 1.0 - ty ) * grid[idx + GRID_Y_SIZE]
+             + ( 1.0 - tx ) * ty * grid[idx + 1]
+             + tx * ty * grid[idx + GRID_Y_SIZE + 1] );
+}
+
+}
@@ -0,0 +1,188 @@
+// -*-c++-*-
+
+/*!
+  \file reach_grid.h
+  \brief opponent and teammate reach step grid Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_PLAYER_REACH_GRID_H
+#define RCSC_PLAYER_REACH_GRID_H
+
+#include <rcsc/geom/vector_2d.h>
+
+#include <vector>
+
+namespace rcsc {
+
+class AbstractPlayerObject;
+class WorldModel;
+
+/*!
+  \class ReachGrid
+  \brief grid map that stores the minimum arrival step of opponents and
+  teammates for each grid point.
+
+  The arrival step is estimated by PlayerType::reachStep() from the
+  inertia point of each player.  The position accuracy count is treated
+  as a bonus step.  The grid is not updated until it is required.
+ */
+class ReachGrid {
+public:
+
+    static const double GRID_LENGTH; //!< grid interval
+
+    static const double PITCH_MAX_X; //!< x range of the grid
+    static const double PITCH_MAX_Y; //!< y range of the grid
+
+    static const int GRID_X_SIZE; //!< the number of grid points for x
+    static const int GRID_Y_SIZE; //!< the number of grid points for y
+
+    static const int MAX_STEP; //!< the maximum step stored in the grid
+    static const int MAX_BONUS_STEP; //!< the maximum bonus step by the accuracy count
+
+private:
+
+    bool M_valid; //!< if false, the grid needs to be updated
+
+    std::vector< unsigned char > M_opponent_step; //!< opponent arrival step grid
+    std::vector< unsigned char > M_teammate_step; //!< teammate arrival step grid (excluding self)
+
+public:
+
+    /*!
+      \brief create the empty grid
+    */
+    ReachGrid();
+
+    /*!
+      \brief mark the grid as invalid. the grid is updated when it is required.
+     */
+    void invalidate()
+      {
+          M_valid = false;
+      }
+
+    /*!
+      \brief check if the grid is up to date
+      \return checked result
+     */
+    bool isValid() const
+      {
+          return M_valid;
+      }
+
+    /*!
+      \brief update all grid values if the grid is invalid
+      \param wm const reference to the world model
+     */
+    void update( const WorldModel & wm );
+
+    /*!
+      \brief get the opponent arrival step at the grid point
+      \param ix x index
+      \param iy y index
+      \return arrival step. MAX_STEP means that nobody can reach within MAX_STEP.
+     */
+    int opponentStepAt( const int ix,
+                        const int iy ) const
+      {
+          return M_opponent_step[ix * GRID_Y_SIZE + iy];
+      }
+
+    /*!
+      \brief get the teammate arrival step at the grid point
+      \param ix x index
+      \param iy y index
+      \return arrival step. MAX_STEP means that nobody can reach within MAX_STEP.
+     */
+    int teammateStepAt( const int ix,
+                        const int iy ) const
+      {
+          return M_teammate_step[ix * GRID_Y_SIZE + iy];
+      }
+
+    /*!
+      \brief get the opponent arrival step at the point by the bilinear interpolation
+      \param pos global coordinate
+      \return interpolated arrival step
+     */
+    double opponentStep( const Vector2D & pos ) const
+      {
+          return interpolate( M_opponent_step, pos );
+      }
+
+    /*!
+      \brief get the teammate arrival step at the point by the bilinear interpolation
+      \param pos global coordinate
+      \return interpolated arrival step
+     */
+    double teammateStep( const Vector2D & pos ) const
+      {
+          return interpolate( M_teammate_step, pos );
+      }
+
+    /*!
+      \brief get the coordinate of the grid point
+      \param ix x index
+      \param iy y index
+      \return global coordinate
+     */
+    static
+    Vector2D grid_point( const int ix,
+                         const int iy )
+      {
+          return Vector2D( ix * GRID_LENGTH - PITCH_MAX_X,
+                           iy * GRID_LENGTH - PITCH_MAX_Y );
+      }
+
+    /*!
+      \brief update the grid values by the arrival step of the player.
+      the position accuracy count is subtracted as the bonus step.
+      \param player player object
+      \param grid step grid. the size must be GRID_X_SIZE * GRID_Y_SIZE.
+     */
+    static
+    void add_player( const AbstractPlayerObject & player,
+                     std::vector< unsigned char > & grid );
+
+    /*!
+      \brief get the grid value at the point by the bilinear interpolation.
+      the point is clamped into the grid range.
+      \param grid step grid. the size must be GRID_X_SIZE * GRID_Y_SIZE.
+      \param pos global coordinate
+      \return interpolated value
+     */
+    static
+    double interpolate( const std::vector< unsigned char > & grid,
+                        const Vector2D & pos );
+
+};
+
+}
+
+#endif
@@ -40,6 +40,7 @@
 #include <rcsc/common/server_param.h>
 #include <rcsc/math_util.h>
 
+#include <algorithm>
 #include <cstring>
 
 namespace rcsc {
@@ -558,12 +559,8 @@ SetplayMessage::appendTo( std::string & to ) const
         return false;
     }
 
-    char ch;
-    try
-    {
-        ch = AudioCodec::i().intToCharMap().at( M_wait_step );
-    }
-    catch ( std::exception & e )
+    const char ch = AudioCodec::i().intToChar( M_wait_step );
+    if ( ch == '\0' )
     {
         std::cerr << __FILE__ << ":" << __LINE__
                   << " ***ERROR*** SetplayMessage. cannot encode wait_step = " << M_wait_step
@@ -606,29 +603,18 @@ InterceptMessage::appendTo( std::string & to ) const
         return false;
     }
 
-    try
-    {
-        int unum = ( M_our ? M_unum : M_unum + MAX_PLAYER );
-
-        char unum_ch = AudioCodec::i().intToCharMap().at( unum );
-        char cycle_ch = AudioCodec::i().intToCharMap().at( M_cycle );
+    const int unum = ( M_our ? M_unum : M_unum + MAX_PLAYER );
 
-        to += header();
-        to += unum_ch;
-        to += cycle_ch;
+    const char unum_ch = AudioCodec::i().intToChar( unum );
+    const char cycle_ch = AudioCodec::i().intToChar( M_cycle );
 
-        dlog.addText( Logger::SENSOR,
-                      "InterceptMessage. success! %s unum = %d, cycle = %d -> [%c%c]",
-                      M_our ? "our" : "opp",
-                      M_unum, M_cycle, unum_ch, cycle_ch );
-
-    }
-    catch ( ... )
+    if ( unum_ch == '\0'
+         || cycle_ch == '\0' )
     {
         std::cerr << __FILE__ << ":" << __LINE__
                   << " ***ERROR*** InterceptMessage."
-                  << " Exception caught! Failed to encode cycle = "
-                  << M_cycle
+                  << " Failed to encode unum = " << M_unum
+                  << " cycle = " << M_cycle
                   << std::endl;
         dlog.addText( Logger::SENSOR,
                       "InterceptMessage. error! unum = %d, cycle = %d",
@@ -636,6 +622,14 @@ InterceptMessage::appendTo( std::string & to ) const
         return false;
     }
 
+    to += header();
+    to += unum_ch;
+    to += cycle_ch;
+
+    dlog.addText( Logger::SENSOR,
+                  "InterceptMessage. success! %s unum = %d, cycle = %d -> [%c%c]",
+                  M_our ? "our" : "opp",
+                  M_unum, M_cycle, unum_ch, cycle_ch );
 
     return true;
 }
@@ -1800,4 +1794,97 @@ BallPlayerMessage::printDebug( std::ostream & os ) const
     return os;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+JointMessage::length() const
+{
+    const JointMessageCodec & codec = JointMessageCodec::i();
+
+    const std::vector< std::size_t > selected = codec.select( M_items,
+                                                              ServerParam::i().playerSayMsgSize() - 1 );
+    if ( selected.empty() )
+    {
+        return 0;
+    }
+
+    std::vector< JointItem > items;
+    items.reserve( selected.size() );
+    for ( std::size_t i : selected )
+    {
+        items.push_back( M_items[i] );
+    }
+
+    std::string msg;
+    return 1 + std::max( 0, codec.encode( items, msg ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+JointMessage::appendTo( std::string & to ) const
+{
+    const JointMessageCodec & codec = JointMessageCodec::i();
+
+    const int max_length = ServerParam::i().playerSayMsgSize() - static_cast< int >( to.length() ) - 1;
+
+    const std::vector< std::size_t > selected = codec.select( M_items, max_length );
+    if ( selected.empty() )
+    {
+        dlog.addText( Logger::SENSOR,
+                      "JointMessage. no item fits in the budget %d",
+                      max_length );
+        return M_items.empty();
+    }
+
+    std::vector< JointItem > items;
+    items.reserve( selected.size() );
+    for ( std::size_t i : selected )
+    {
+        items.push_back( M_items[i] );
+    }
+
+    std::string msg;
+    msg.reserve( max_length );
+
+    const int len = codec.encode( items, msg );
+    if ( len <= 0
+         || max_length < len )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " ***ERROR*** JointMessage. "
+                  << std::endl;
+        dlog.addText( Logger::SENSOR,
+                      "JointMessage. error! len=%d budget=%d",
+                      len, max_length );
+        return false;
+    }
+
+    dlog.addText( Logger::SENSOR,
+                  "JointMessage. success! %d/%d items -> [%s]",
+                  static_cast< int >( items.size() ),
+                  static_cast< int >( M_items.size() ),
+                  msg.c_str() );
+
+    to += header();
+    to += msg;
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::ostream &
+JointMessage::printDebug( std::ostream & os ) const
+{
+    os << "[Joint:" << M_items.size() << ']';
+    return os;
+}
+
 }
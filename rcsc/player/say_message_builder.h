@@ -34,8 +34,10 @@
 
 #include <rcsc/common/say_message.h>
 #include <rcsc/common/say_message_parser.h>
+#include <rcsc/common/joint_message_codec.h>
 #include <rcsc/geom/vector_2d.h>
 
+#include <vector>
 #include <string>
 #include <iostream>
 
@@ -1688,6 +1690,75 @@ public:
 
 };
 
+/*-------------------------------------------------------------------*/
+/*!
+  \class JointMessage
+  \brief joint message encoder that packs the most valuable items into
+  the remaining say budget.
+
+  format:
+  "J<payload>"
+  The payload length is variable and continues to the end of the say
+  message.  ActionEffector always appends this message after all other
+  messages.  Only one joint message can be registered at a time.
+*/
+class JointMessage
+    : public SayMessage {
+private:
+
+    std::vector< JointItem > M_items; //!< candidate items
+
+public:
+
+    /*!
+      \brief construct with candidate items
+      \param items candidate items. the value of each item is used as its importance.
+    */
+    explicit
+    JointMessage( const std::vector< JointItem > & items )
+        : M_items( items )
+      { }
+
+    /*!
+      \brief get the header character of this message
+      \return header character of this message
+     */
+    char header() const
+      {
+          return JointMessageParser::sheader();
+      }
+
+    /*!
+      \brief get the length of this message when the whole say budget is available
+      \return the length of encoded message
+    */
+    int length() const;
+
+    /*!
+      \brief get the candidate items
+      \return const reference to the item container
+     */
+    const std::vector< JointItem > & items() const
+      {
+          return M_items;
+      }
+
+    /*!
+      \brief select the items that fit the remaining budget and append them
+      \param to reference to the message string instance
+      \return result status of encoding
+    */
+    bool appendTo( std::string & to ) const;
+
+    /*!
+      \brief append the debug message
+      \param os reference to the output stream
+      \return reference to the output stream
+     */
+    std::ostream & printDebug( std::ostream & os ) const;
+
+};
+
 }
 
 #endif
@@ -0,0 +1,404 @@
+// -*-c++-*-
+
+/*!
+  \file test_assignment_solver.cpp
+  \brief test code for rcsc::AssignmentSolver
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "assignment_solver.h"
+
+#include <rcsc/time/timer.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <iostream>
+#include <limits>
+#include <cmath>
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+
+class AssignmentSolverTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( AssignmentSolverTest );
+    CPPUNIT_TEST( testEmpty );
+    CPPUNIT_TEST( testSimple );
+    CPPUNIT_TEST( testRandom );
+    CPPUNIT_TEST( testTie );
+    CPPUNIT_TEST( testBenchmark );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testEmpty();
+    void testSimple();
+    void testRandom();
+    void testTie();
+    void testBenchmark();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( AssignmentSolverTest );
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief exhaustive search. the result is (count, cost).
+ */
+void
+search_best( const std::vector< std::vector< double > > & costs,
+             const std::size_t row,
+             std::vector< char > & used_cols,
+             const int count,
+             const double cost,
+             int * best_count,
+             double * best_cost )
+{
+    if ( row == costs.size() )
+    {
+        if ( count > *best_count
+             || ( count == *best_count && cost < *best_cost ) )
+        {
+            *best_count = count;
+            *best_cost = cost;
+        }
+        return;
+    }
+
+    // not assigned
+    search_best( costs, row + 1, used_cols, count, cost, best_count, best_cost );
+
+    for ( std::size_t col = 0; col < used_cols.size(); ++col )
+    {
+        if ( used_cols[col] ) continue;
+        if ( costs[row][col] < 0.0 ) continue;
+
+        used_cols[col] = 1;
+        search_best( costs, row + 1, used_cols,
+                     count + 1, cost + costs[row][col],
+                     best_count, best_cost );
+        used_cols[col] = 0;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the problem like the crowded corner kick scene.
+ */
+void
+set_crowded_problem( std::mt19937 & gen,
+                     const int rows,
+                     const int cols,
+                     AssignmentSolver * solver )
+{
+    std::uniform_real_distribution<> x_dist( 40.0, 52.5 );
+    std::uniform_real_distribution<> y_dist( 20.0, 34.0 );
+    std::normal_distribution<> noise( 0.0, 1.0 );
+
+    std::vector< double > row_x( rows ), row_y( rows );
+    for ( int i = 0; i < rows; ++i )
+    {
+        row_x[i] = x_dist( gen );
+        row_y[i] = y_dist( gen );
+    }
+
+    solver->assign( rows, cols );
+    for ( int j = 0; j < cols; ++j )
+    {
+        const int i = j % rows;
+        const double x = row_x[i] + noise( gen );
+        const double y = row_y[i] + noise( gen );
+        for ( int r = 0; r < rows; ++r )
+        {
+            const double d2 = std::pow( row_x[r] - x, 2 ) + std::pow( row_y[r] - y, 2 );
+            if ( d2 < 10.0 * 10.0 )
+            {
+                solver->setCost( r, j, d2 );
+            }
+        }
+    }
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+AssignmentSolverTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+AssignmentSolverTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+AssignmentSolverTest::testEmpty()
+{
+    AssignmentSolver solver;
+
+    solver.assign( 0, 0 );
+    CPPUNIT_ASSERT_EQUAL( 0, solver.solve() );
+
+    solver.assign( 3, 0 );
+    CPPUNIT_ASSERT_EQUAL( 0, solver.solve() );
+    CPPUNIT_ASSERT_EQUAL( -1, solver.assignment( 2 ) );
+
+    // no allowed pair
+    solver.assign( 2, 2 );
+    CPPUNIT_ASSERT_EQUAL( 0, solver.solve() );
+    CPPUNIT_ASSERT_EQUAL( -1, solver.assignment( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( -1, solver.assignment( 1 ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+AssignmentSolverTest::testSimple()
+{
+    AssignmentSolver solver;
+
+    // the greedy matching selects (0,0) and leaves the row 1.
+    solver.assign( 2, 2 );
+    solver.setCost( 0, 0, 1.0 );
+    solver.setCost( 0, 1, 2.0 );
+    solver.setCost( 1, 0, 1.5 );
+
+    CPPUNIT_ASSERT_EQUAL( 2, solver.solve() );
+    CPPUNIT_ASSERT_EQUAL( 1, solver.assignment( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( 0, solver.assignment( 1 ) );
+
+    // more columns than rows
+    solver.assign( 1, 3 );
+    solver.setCost( 0, 0, 5.0 );
+    solver.setCost( 0, 2, 0.5 );
+
+    CPPUNIT_ASSERT_EQUAL( 1, solver.solve() );
+    CPPUNIT_ASSERT_EQUAL( 2, solver.assignment( 0 ) );
+
+    // more rows than columns
+    solver.assign( 3, 1 );
+    solver.setCost( 0, 0, 5.0 );
+    solver.setCost( 1, 0, 0.5 );
+    solver.setCost( 2, 0, 1.0 );
+
+    CPPUNIT_ASSERT_EQUAL( 1, solver.solve() );
+    CPPUNIT_ASSERT_EQUAL( -1, solver.assignment( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( 0, solver.assignment( 1 ) );
+    CPPUNIT_ASSERT_EQUAL( -1, solver.assignment( 2 ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+AssignmentSolverTest::testRandom()
+{
+    std::mt19937 gen( 1 );
+    std::uniform_int_distribution<> size_dist( 1, 6 );
+    std::uniform_real_distribution<> cost_dist( 0.0, 100.0 );
+    std::uniform_real_distribution<> prob_dist( 0.0, 1.0 );
+
+    AssignmentSolver solver;
+
+    for ( int loop = 0; loop < 500; ++loop )
+    {
+        const int rows = size_dist( gen );
+        const int cols = size_dist( gen );
+        const double allow_rate = prob_dist( gen );
+
+        std::vector< std::vector< double > > costs( rows, std::vector< double >( cols, -1.0 ) );
+
+        solver.assign( rows, cols );
+        for ( int i = 0; i < rows; ++i )
+        {
+            for ( int j = 0; j < cols; ++j )
+            {
+                if ( prob_dist( gen ) < allow_rate )
+                {
+                    costs[i][j] = cost_dist( gen );
+                    solver.setCost( i, j, costs[i][j] );
+                }
+            }
+        }
+
+        std::vector< char > used_cols( cols, 0 );
+        int best_count = -1;
+        double best_cost = 0.0;
+        search_best( costs, 0, used_cols, 0, 0.0, &best_count, &best_cost );
+
+        const int count = solver.solve();
+
+        double cost = 0.0;
+        std::vector< char > assigned_cols( cols, 0 );
+        for ( int i = 0; i < rows; ++i )
+        {
+            const int j = solver.assignment( i );
+            if ( j < 0 ) continue;
+
+            CPPUNIT_ASSERT( costs[i][j] >= 0.0 );
+            CPPUNIT_ASSERT( ! assigned_cols[j] );
+            assigned_cols[j] = 1;
+            cost += costs[i][j];
+        }
+
+        CPPUNIT_ASSERT_EQUAL( best_count, count );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( best_cost, cost, 1.0e-6 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+AssignmentSolverTest::testTie()
+{
+    AssignmentSolver solver;
+
+    std::vector< int > first_result;
+    for ( int loop = 0; loop < 3; ++loop )
+    {
+        solver.assign( 4, 4 );
+        for ( int i = 0; i < 4; ++i )
+        {
+            for ( int j = 0; j < 4; ++j )
+            {
+                solver.setCost( i, j, 1.0 );
+            }
+        }
+
+        CPPUNIT_ASSERT_EQUAL( 4, solver.solve() );
+
+        std::vector< int > result;
+        for ( int i = 0; i < 4; ++i )
+        {
+            result.push_back( solver.assignment( i ) );
+        }
+
+        if ( first_result.empty() )
+        {
+            first_result = result;
+        }
+
+        CPPUNIT_ASSERT( first_result == result );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+AssignmentSolverTest::testBenchmark()
+{
+    // crowded scenes such as a corner kick.
+    // 22x22: all players are tracked and seen.
+    // 64x32: the matching buffer sizes in WorldModel, the worst case.
+    const int max_loop = 1000;
+    const int sizes[2][2] = { { 22, 22 }, { 64, 32 } };
+
+    // the worst case latency must be below a tenth of the 100 ms cycle.
+    const double max_latency_msec = 10.0;
+
+    std::mt19937 gen( 2 );
+    AssignmentSolver solver;
+
+    for ( const auto & size : sizes )
+    {
+        const int rows = size[0];
+        const int cols = size[1];
+
+        double total_msec = 0.0;
+        double max_msec = 0.0;
+        for ( int loop = 0; loop < max_loop; ++loop )
+        {
+            set_crowded_problem( gen, rows, cols, &solver );
+
+            // the same problem is solved several times and the fastest one
+            // is used, so that the scheduling noise is not measured.
+            double msec = std::numeric_limits< double >::max();
+            for ( int trial = 0; trial < 3; ++trial )
+            {
+                Timer timer;
+                const int count = solver.solve();
+                msec = std::min( msec, timer.elapsedNSec() * 1.0e-6 );
+
+                CPPUNIT_ASSERT( count > 0 );
+            }
+
+            total_msec += msec;
+            max_msec = std::max( max_msec, msec );
+        }
+
+        std::cout << "\nAssignmentSolver::solve " << rows << "x" << cols
+                  << " average " << total_msec / max_loop << " [ms]"
+                  << " max " << max_msec << " [ms]" << std::endl;
+
+        CPPUNIT_ASSERT( max_msec < max_latency_msec );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
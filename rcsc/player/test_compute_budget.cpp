@@ -0,0 +1,214 @@
+// -*-c++-*-
+
+/*!
+  \file test_compute_budget.cpp
+  \brief test code for rcsc::ComputeBudget
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "compute_budget.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+
+class ComputeBudgetTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( ComputeBudgetTest );
+    CPPUNIT_TEST( testUnlimited );
+    CPPUNIT_TEST( testDeadline );
+    CPPUNIT_TEST( testAnytimeSearch );
+    CPPUNIT_TEST( testMetrics );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testUnlimited();
+    void testDeadline();
+    void testAnytimeSearch();
+    void testMetrics();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ComputeBudgetTest );
+
+/*-------------------------------------------------------------------*/
+void
+ComputeBudgetTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+ComputeBudgetTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+ComputeBudgetTest::testUnlimited()
+{
+    ComputeBudget budget;
+    CPPUNIT_ASSERT( ! budget.isLimited() );
+    CPPUNIT_ASSERT( ! budget.shouldStop() );
+    CPPUNIT_ASSERT_EQUAL( INT64_MAX, budget.remainingUSec() );
+
+    budget.start( TimeStamp() );
+    CPPUNIT_ASSERT( ! budget.isLimited() );
+    CPPUNIT_ASSERT( ! budget.shouldStop() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ComputeBudgetTest::testDeadline()
+{
+    ComputeBudget budget;
+
+    // already expired
+    budget.start( TimeStamp::now().addNSec( -1000 ) );
+    CPPUNIT_ASSERT( budget.isLimited() );
+    CPPUNIT_ASSERT( budget.remainingUSec() < 0 );
+    CPPUNIT_ASSERT( budget.shouldStop() );
+
+    // enough time
+    budget.start( TimeStamp::now().addNSec( 10LL * 1000 * 1000 * 1000 ) );
+    CPPUNIT_ASSERT( ! budget.shouldStop() );
+    CPPUNIT_ASSERT( budget.remainingUSec() > 9 * 1000 * 1000 );
+
+    // expires during the busy wait
+    const TimeStamp deadline = TimeStamp::now().addNSec( 2 * 1000 * 1000 );
+    budget.start( deadline );
+    while ( ! budget.shouldStop() )
+    {
+    }
+    CPPUNIT_ASSERT( TimeStamp::now().nsecSince( deadline ) >= 0 );
+    CPPUNIT_ASSERT( budget.shouldStop() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ComputeBudgetTest::testAnytimeSearch()
+{
+    // each candidate takes 10us. the search should be stopped
+    // shortly after the 1ms budget is expired.
+    const int size = 1000 * 1000;
+
+    ComputeBudget budget;
+    budget.start( TimeStamp::now().addNSec( 1000 * 1000 ) );
+
+    int count = 0;
+    bool truncated = false;
+    for ( int i = 0; i < size; ++i, ++count )
+    {
+        if ( budget.shouldStop() )
+        {
+            truncated = true;
+            break;
+        }
+
+        const TimeStamp start = TimeStamp::now();
+        while ( TimeStamp::now().nsecSince( start ) < 10 * 1000 )
+        {
+        }
+    }
+    budget.addSearch( truncated );
+
+    CPPUNIT_ASSERT( truncated );
+    CPPUNIT_ASSERT( count < size );
+    CPPUNIT_ASSERT_EQUAL( 1, budget.truncatedCount() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ComputeBudgetTest::testMetrics()
+{
+    ComputeBudget budget;
+
+    budget.start( TimeStamp() );
+    budget.addSearch( false );
+    budget.addSearch( false );
+    CPPUNIT_ASSERT_EQUAL( 2, budget.searchCount() );
+    CPPUNIT_ASSERT_EQUAL( 0, budget.truncatedCount() );
+
+    budget.start( TimeStamp() );
+    budget.addSearch( true );
+    budget.addSearch( true );
+    budget.addSearch( false );
+    CPPUNIT_ASSERT_EQUAL( 3, budget.searchCount() );
+    CPPUNIT_ASSERT_EQUAL( 2, budget.truncatedCount() );
+
+    budget.start( TimeStamp() );
+    budget.addSearch( true );
+
+    CPPUNIT_ASSERT_EQUAL( 3L, budget.totalCycleCount() );
+    CPPUNIT_ASSERT_EQUAL( 2L, budget.totalTruncatedCycleCount() );
+    CPPUNIT_ASSERT_EQUAL( 6L, budget.totalSearchCount() );
+    CPPUNIT_ASSERT_EQUAL( 3L, budget.totalTruncatedCount() );
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
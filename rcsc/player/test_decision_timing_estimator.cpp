@@ -0,0 +1,358 @@
+// -*-c++-*-
+
+/*!
+  \file test_decision_timing_estimator.cpp
+  \brief replay test code for rcsc::DecisionTimingEstimator
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "decision_timing_estimator.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+using namespace rcsc;
+
+namespace {
+
+const double CYCLE_MSEC = 100.0;
+const double STATIC_THR = 30.0;
+
+/*!
+  \brief one cycle of the recorded timestamps
+ */
+struct TraceItem {
+    double see_offset_; //!< see arrival offset from sense_body
+    double think_; //!< think time
+};
+
+typedef std::vector< TraceItem > Trace;
+
+/*!
+  \brief read the trace. each line is "<see offset msec> <think msec>".
+ */
+Trace
+read_trace( std::istream & is )
+{
+    Trace trace;
+    std::string line;
+    while ( std::getline( is, line ) )
+    {
+        if ( line.empty() || line[0] == '#' ) continue;
+
+        std::istringstream istr( line );
+        TraceItem item;
+        if ( istr >> item.see_offset_ >> item.think_ )
+        {
+            trace.push_back( item );
+        }
+    }
+    return trace;
+}
+
+/*!
+  \brief replay the trace in the same way as PlayerAgent.
+  The decision starts at the see arrival if it arrives before the threshold.
+ */
+void
+replay( const Trace & trace,
+        const bool adaptive,
+        DecisionTimingEstimator * est )
+{
+    est->setCycleMSec( CYCLE_MSEC );
+
+    for ( const TraceItem & item : trace )
+    {
+        const double thr = ( adaptive
+                             ? est->synchViewWaitMSec( STATIC_THR )
+                             : STATIC_THR );
+        const bool see_missed = ( item.see_offset_ > thr );
+        const double start = ( see_missed ? thr : item.see_offset_ );
+
+        est->addThinkTime( item.think_ );
+        est->addDecision( start + item.think_, see_missed );
+        est->addSeeOffset( item.see_offset_ );
+    }
+}
+
+/*!
+  \brief generate the trace with the normal distributions
+ */
+Trace
+generate_trace( const int n,
+                const double see_mean,
+                const double see_stddev,
+                const double think_mean,
+                const double think_stddev,
+                const unsigned int seed )
+{
+    std::mt19937 engine( seed );
+    std::normal_distribution<> see( see_mean, see_stddev );
+    std::normal_distribution<> think( think_mean, think_stddev );
+
+    Trace trace;
+    for ( int i = 0; i < n; ++i )
+    {
+        trace.push_back( TraceItem{ std::max( 0.0, see( engine ) ),
+                                    std::max( 0.1, think( engine ) ) } );
+    }
+    return trace;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+
+class DecisionTimingEstimatorTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( DecisionTimingEstimatorTest );
+    CPPUNIT_TEST( testEstimate );
+    CPPUNIT_TEST( testRecordedTrace );
+    CPPUNIT_TEST( testLateSee );
+    CPPUNIT_TEST( testHeavyThink );
+    CPPUNIT_TEST( testLoadChange );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testEstimate();
+    void testRecordedTrace();
+    void testLateSee();
+    void testHeavyThink();
+    void testLoadChange();
+};
+
+
+/*-------------------------------------------------------------------*/
+
+CPPUNIT_TEST_SUITE_REGISTRATION( DecisionTimingEstimatorTest );
+
+/*-------------------------------------------------------------------*/
+void
+DecisionTimingEstimatorTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+DecisionTimingEstimatorTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+DecisionTimingEstimatorTest::testEstimate()
+{
+    DecisionTimingEstimator est( 20 );
+    est.setCycleMSec( 100.0 );
+    est.setMarginMSec( 0.0 );
+    est.setMissProbability( 0.1 );
+
+    // not ready
+    CPPUNIT_ASSERT( ! est.isReady() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 30.0, est.synchViewWaitMSec( 30.0 ), 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 100.0, est.latestSafeMSec(), 1.0e-9 );
+
+    for ( int i = 1; i <= 20; ++i )
+    {
+        est.addThinkTime( i );
+        est.addSeeOffset( 20.0 + i );
+    }
+
+    CPPUNIT_ASSERT( est.isReady() );
+    // 90% quantile of 1..20 is 18
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 100.0 - 18.0, est.latestSafeMSec(), 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 38.0, est.synchViewWaitMSec( 30.0 ), 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 75.0, est.noSynchViewWaitMSec( 75.0 ), 1.0e-9 );
+
+    // old samples are dropped from the window
+    for ( int i = 0; i < 20; ++i )
+    {
+        est.addThinkTime( 90.0 );
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 10.0, est.latestSafeMSec(), 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 10.0, est.synchViewWaitMSec( 30.0 ), 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 10.0, est.noSynchViewWaitMSec( 75.0 ), 1.0e-9 );
+
+    // counters
+    est.addDecision( 40.0, false );
+    est.addDecision( 105.0, true );
+    CPPUNIT_ASSERT_EQUAL( 2, est.decisionCount() );
+    CPPUNIT_ASSERT_EQUAL( 1, est.missedCycleCount() );
+    CPPUNIT_ASSERT_EQUAL( 1, est.missedSeeCount() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 60.0, est.idleSlackMSec(), 1.0e-9 );
+
+    est.clear();
+    CPPUNIT_ASSERT( ! est.isReady() );
+    CPPUNIT_ASSERT_EQUAL( 0, est.decisionCount() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+DecisionTimingEstimatorTest::testRecordedTrace()
+{
+    // sample trace text. the see message arrives 30-34 ms after sense_body.
+    std::istringstream istr( "# see think\n"
+                             "31.2 4.1\n" "30.4 3.9\n" "33.8 5.2\n" "32.1 4.4\n" "30.9 4.0\n"
+                             "31.7 4.8\n" "33.2 4.3\n" "30.2 4.1\n" "32.6 6.0\n" "31.1 4.2\n"
+                             "30.8 4.4\n" "32.9 4.6\n" "31.5 3.8\n" "33.6 4.9\n" "30.6 4.0\n"
+                             "31.9 4.2\n" "32.4 5.1\n" "30.3 4.3\n" "33.1 4.7\n" "31.4 4.1\n"
+                             "32.2 4.5\n" "30.7 4.0\n" "33.5 4.4\n" "31.8 4.2\n" "32.7 5.3\n" );
+    const Trace trace = read_trace( istr );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 25 ), trace.size() );
+
+    DecisionTimingEstimator fixed;
+    replay( trace, false, &fixed );
+
+    DecisionTimingEstimator adaptive;
+    replay( trace, true, &adaptive );
+
+    // the static threshold (30ms) misses all see messages.
+    CPPUNIT_ASSERT_EQUAL( 25, fixed.missedSeeCount() );
+    // the adaptive threshold waits for the see after the first samples.
+    CPPUNIT_ASSERT_EQUAL( int( DecisionTimingEstimator::MIN_SAMPLES ), adaptive.missedSeeCount() );
+    CPPUNIT_ASSERT_EQUAL( 0, adaptive.missedCycleCount() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+DecisionTimingEstimatorTest::testLateSee()
+{
+    const Trace trace = generate_trace( 3000, 31.0, 1.5, 5.0, 1.0, 1 );
+
+    DecisionTimingEstimator fixed;
+    replay( trace, false, &fixed );
+
+    DecisionTimingEstimator adaptive;
+    replay( trace, true, &adaptive );
+
+    std::cout << "\n  late see: static missed sees " << fixed.missedSeeCount()
+              << " adaptive missed sees " << adaptive.missedSeeCount()
+              << " missed cycles " << adaptive.missedCycleCount()
+              << " idle " << adaptive.idleSlackMSec() / adaptive.decisionCount()
+              << std::endl;
+
+    CPPUNIT_ASSERT( fixed.missedSeeCount() > 1500 );
+    CPPUNIT_ASSERT( adaptive.missedSeeCount() < 3000 * 0.03 );
+    CPPUNIT_ASSERT_EQUAL( 0, adaptive.missedCycleCount() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+DecisionTimingEstimatorTest::testHeavyThink()
+{
+    // the decision itself consumes most of the cycle.
+    const Trace trace = generate_trace( 3000, 35.0, 2.0, 75.0, 2.0, 2 );
+
+    DecisionTimingEstimator fixed;
+    replay( trace, false, &fixed );
+
+    DecisionTimingEstimator adaptive;
+    replay( trace, true, &adaptive );
+
+    std::cout << "\n  heavy think: static missed cycles " << fixed.missedCycleCount()
+              << " adaptive missed cycles " << adaptive.missedCycleCount()
+              << std::endl;
+
+    CPPUNIT_ASSERT( fixed.missedCycleCount() > 1500 );
+    CPPUNIT_ASSERT( adaptive.missedCycleCount() < 3000 * 0.03 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+DecisionTimingEstimatorTest::testLoadChange()
+{
+    // the see offset and the think time change in the middle of the match.
+    Trace trace = generate_trace( 1000, 20.0, 1.0, 5.0, 1.0, 3 );
+    const Trace loaded = generate_trace( 1000, 45.0, 2.0, 40.0, 3.0, 4 );
+    trace.insert( trace.end(), loaded.begin(), loaded.end() );
+
+    DecisionTimingEstimator adaptive;
+    replay( trace, true, &adaptive );
+
+    std::cout << "\n  load change: missed sees " << adaptive.missedSeeCount()
+              << " missed cycles " << adaptive.missedCycleCount()
+              << std::endl;
+
+    // the estimator has to follow the change within the window size.
+    CPPUNIT_ASSERT( adaptive.missedSeeCount() < int( DecisionTimingEstimator::DEFAULT_WINDOW ) );
+    CPPUNIT_ASSERT( adaptive.missedCycleCount() < int( DecisionTimingEstimator::DEFAULT_WINDOW ) );
+
+    // after the change, the threshold has to be later than the static value
+    // and still leave the time to think.
+    const double thr = adaptive.synchViewWaitMSec( STATIC_THR );
+    CPPUNIT_ASSERT( thr > 45.0 );
+    CPPUNIT_ASSERT( thr < CYCLE_MSEC - 40.0 );
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,417 @@
+// -*-c++-*-
+
+/*!
+  \file test_dribble_simulator.cpp
+  \brief test code for rcsc::DribbleSimulator
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "dribble_simulator.h"
+#include "player_agent.h"
+#include "action_effector.h"
+#include "world_model.h"
+#include "fullstate_sensor.h"
+#include "localization_default.h"
+
+#include <rcsc/sim/simulator.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/game_mode.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+#include <vector>
+#include <cmath>
+
+using namespace rcsc;
+
+namespace {
+
+/*!
+  \brief player agent only used to create the action effector
+ */
+class DummyAgent
+    : public PlayerAgent {
+protected:
+    void actionImpl() override
+      { }
+};
+
+/*!
+  \brief player state written into the fullstate message
+ */
+struct PlayerState {
+    Vector2D pos_;
+    Vector2D vel_;
+    double body_;
+
+    PlayerState( const Vector2D & pos,
+                 const Vector2D & vel,
+                 const double body )
+        : pos_( pos ),
+          vel_( vel ),
+          body_( body )
+      { }
+};
+
+/*!
+  \brief world model of the left player 10 updated by one fullstate message
+ */
+class FullstateWorld {
+private:
+    DummyAgent M_agent;
+    ActionEffector M_effector;
+    WorldModel M_world;
+
+public:
+
+    FullstateWorld( const PlayerState & self,
+                    const Vector2D & ball_pos,
+                    const Vector2D & ball_vel,
+                    const std::vector< PlayerState > & opponents )
+        : M_effector( M_agent )
+      {
+          M_world.setLocalization( std::shared_ptr< Localization >( new LocalizationDefault() ) );
+          M_world.init( "left", LEFT, 10, false, 18.0 );
+
+          std::ostringstream os;
+          os << "(fullstate 1 (pmode play_on) (vmode high normal)"
+             << " (count 0 0 0 0 0 0 0 0)"
+             << " (arm (movable 0) (expires 0) (target 0 0) (count 0))"
+             << " (score 0 0)"
+             << " ((b) " << ball_pos.x << ' ' << ball_pos.y
+             << ' ' << ball_vel.x << ' ' << ball_vel.y << ')';
+          write_player( os, 'l', 10, self );
+          for ( std::size_t i = 0; i < opponents.size(); ++i )
+          {
+              write_player( os, 'r', static_cast< int >( i ) + 1, opponents[i] );
+          }
+          os << ')';
+
+          const GameTime current( 1, 0 );
+
+          GameMode mode;
+          mode.update( "play_on", current );
+          M_world.updateGameMode( mode, current );
+
+          FullstateSensor fullstate;
+          fullstate.parse( os.str().c_str(), LEFT, 18.0, current );
+          M_world.updateAfterFullstate( fullstate, M_effector, current );
+          M_world.updateJustBeforeDecision( M_effector, current );
+      }
+
+    const WorldModel & world() const
+      {
+          return M_world;
+      }
+
+private:
+
+    static
+    void write_player( std::ostream & os,
+                       const char side,
+                       const int unum,
+                       const PlayerState & p )
+      {
+          os << " ((p " << side << ' ' << unum << " 0) "
+             << p.pos_.x << ' ' << p.pos_.y << ' '
+             << p.vel_.x << ' ' << p.vel_.y << ' '
+             << p.body_ << " 0 (stamina 8000 1 1 130600))";
+      }
+};
+
+}
+
+/*-------------------------------------------------------------------*/
+
+class DribbleSimulatorTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( DribbleSimulatorTest );
+    CPPUNIT_TEST( testSelfPositions );
+    CPPUNIT_TEST( testKickDashes );
+    CPPUNIT_TEST( testOpponent );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+
+    void checkRollout( const WorldModel & wm,
+                       const DribbleSimulator::Candidate & candidate,
+                       const DribbleSimulator::Result & result );
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testSelfPositions();
+    void testKickDashes();
+    void testOpponent();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( DribbleSimulatorTest );
+
+/*-------------------------------------------------------------------*/
+void
+DribbleSimulatorTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+DribbleSimulatorTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  replay the kick and the dashes of the result in rcsc::Simulator, and
+  check that the ball is kept as predicted.
+ */
+void
+DribbleSimulatorTest::checkRollout( const WorldModel & wm,
+                                    const DribbleSimulator::Candidate & candidate,
+                                    const DribbleSimulator::Result & result )
+{
+    const ServerParam & SP = ServerParam::i();
+    const PlayerType & ptype = wm.self().playerType();
+
+    SimState state;
+    state.assign( wm );
+
+    const SimPlayer * self = state.player( LEFT, wm.self().unum() );
+    CPPUNIT_ASSERT( self );
+    const int index = static_cast< int >( self - state.players_ );
+
+    // kick
+    const Vector2D ball_rel = state.ball_.pos_ - self->pos_;
+    const double kick_rate = ptype.kickRate( ball_rel.r(), ( ball_rel.th() - self->body_ ).abs() );
+    const Vector2D accel = result.first_ball_vel_ - state.ball_.vel_;
+    const double kick_power = accel.r() / kick_rate;
+    CPPUNIT_ASSERT( kick_power <= SP.maxPower() + 1.0e-6 );
+
+    Simulator simulator;
+    SimCommandSet commands;
+
+    commands[index] = SimCommand::kick( kick_power, ( accel.th() - self->body_ ).degree() );
+    simulator.step( &state, commands );
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( ( wm.ball().pos() + result.first_ball_vel_ ).x, state.ball_.pos_.x, 1.0e-6 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( ( wm.ball().pos() + result.first_ball_vel_ ).y, state.ball_.pos_.y, 1.0e-6 );
+
+    // dashes
+    const AngleDeg dash_angle = ( candidate.dash_power_ > 0.0
+                                  ? candidate.dash_angle_
+                                  : candidate.dash_angle_ + 180.0 );
+    const double dash_dir = ( dash_angle - wm.self().body() ).degree();
+
+    commands[index] = SimCommand::dash( candidate.dash_power_, dash_dir );
+    for ( int i = 0; i < result.dash_count_; ++i )
+    {
+        simulator.step( &state, commands );
+
+        const double ball_dist = state.ball_.pos_.dist( self->pos_ );
+        CPPUNIT_ASSERT( ball_dist < ptype.kickableArea() );
+        CPPUNIT_ASSERT( ball_dist > ptype.playerSize() + SP.ballSize() );
+    }
+
+    const Vector2D last_rel = ( state.ball_.pos_ - self->pos_ ).rotatedVector( - candidate.dash_angle_ );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( result.last_ball_rel_.x, last_rel.x, 1.0e-6 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( result.last_ball_rel_.y, last_rel.y, 1.0e-6 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+DribbleSimulatorTest::testSelfPositions()
+{
+    const ServerParam & SP = ServerParam::i();
+    const PlayerType & ptype = PlayerTypeSet::i().defaultType();
+
+    const int dash_count = 10;
+    const double dirs[] = { 0.0, 45.0, -90.0, 180.0 };
+    const double powers[] = { 100.0, 50.0, 20.0 };
+
+    Simulator simulator;
+    std::vector< Vector2D > positions;
+
+    for ( const double dir : dirs )
+    {
+        for ( const double power : powers )
+        {
+            SimState state;
+            SimPlayer & p = state.players_[0];
+            p.side_ = LEFT;
+            p.unum_ = 1;
+            p.type_ = &ptype;
+            p.pos_.assign( -10.0, 5.0 );
+            p.vel_.assign( 0.3, -0.1 );
+            p.body_ = 30.0;
+            p.stamina_.init( ptype );
+            state.ball_.pos_.assign( 30.0, -20.0 );
+
+            DribbleSimulator::predict_self_positions( ptype,
+                                                      p.pos_, p.vel_, p.body_,
+                                                      p.stamina_,
+                                                      SP.discretizeDashAngle( dir ),
+                                                      power,
+                                                      dash_count,
+                                                      &positions );
+            CPPUNIT_ASSERT_EQUAL( static_cast< std::size_t >( dash_count + 1 ), positions.size() );
+
+            // kick cycle
+            simulator.step( &state );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( positions[0].x, p.pos_.x, 1.0e-6 );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( positions[0].y, p.pos_.y, 1.0e-6 );
+
+            SimCommandSet commands;
+            commands[0] = SimCommand::dash( power, dir );
+            for ( int i = 1; i <= dash_count; ++i )
+            {
+                simulator.step( &state, commands );
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( positions[i].x, p.pos_.x, 1.0e-6 );
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( positions[i].y, p.pos_.y, 1.0e-6 );
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+DribbleSimulatorTest::testKickDashes()
+{
+    const FullstateWorld world( PlayerState( Vector2D( 0.0, 0.0 ), Vector2D( 0.2, 0.0 ), 0.0 ),
+                                Vector2D( 0.6, 0.3 ), Vector2D( 0.0, 0.0 ),
+                                std::vector< PlayerState >() );
+    const WorldModel & wm = world.world();
+    CPPUNIT_ASSERT( wm.self().isKickable() );
+
+    DribbleSimulator simulator;
+
+    const DribbleSimulator::Candidate candidates[] = {
+        DribbleSimulator::Candidate( 0.0, 100.0, 4 ),
+        DribbleSimulator::Candidate( 0.0, 60.0, 6 ),
+        DribbleSimulator::Candidate( 45.0, 100.0, 3 ),
+        DribbleSimulator::Candidate( -90.0, 100.0, 3 ),
+    };
+
+    for ( const DribbleSimulator::Candidate & c : candidates )
+    {
+        DribbleSimulator::Result result;
+        CPPUNIT_ASSERT( simulator.simulateOne( wm, c, &result ) );
+        CPPUNIT_ASSERT( 1 <= result.dash_count_ );
+        CPPUNIT_ASSERT( result.dash_count_ <= c.dash_count_ );
+
+        checkRollout( wm, c, result );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+DribbleSimulatorTest::testOpponent()
+{
+    const PlayerState self( Vector2D( 0.0, 0.0 ), Vector2D( 0.0, 0.0 ), 0.0 );
+    const Vector2D ball_pos( 0.6, 0.0 );
+
+    const FullstateWorld free_world( self, ball_pos, Vector2D( 0.0, 0.0 ),
+                                     std::vector< PlayerState >() );
+    const FullstateWorld far_world( self, ball_pos, Vector2D( 0.0, 0.0 ),
+                                    std::vector< PlayerState >( 1, PlayerState( Vector2D( 5.0, 0.0 ),
+                                                                                Vector2D( 0.0, 0.0 ),
+                                                                                180.0 ) ) );
+    const FullstateWorld near_world( self, ball_pos, Vector2D( 0.0, 0.0 ),
+                                     std::vector< PlayerState >( 1, PlayerState( Vector2D( 2.0, 0.0 ),
+                                                                                 Vector2D( 0.0, 0.0 ),
+                                                                                 180.0 ) ) );
+
+    const DribbleSimulator::Candidate forward( 0.0, 100.0, 6 );
+
+    DribbleSimulator simulator;
+
+    DribbleSimulator::Result free_result;
+    CPPUNIT_ASSERT( simulator.simulateOne( free_world.world(), forward, &free_result ) );
+
+    // the opponent in the dribble route reduces the margin.
+    DribbleSimulator::Result far_result;
+    CPPUNIT_ASSERT( simulator.simulateOne( far_world.world(), forward, &far_result ) );
+    CPPUNIT_ASSERT( far_result.min_opp_margin_ > 0.0 );
+    CPPUNIT_ASSERT( far_result.min_opp_margin_ < free_result.min_opp_margin_ );
+    checkRollout( far_world.world(), forward, far_result );
+
+    // the opponent can reach the ball route.
+    DribbleSimulator::Result near_result;
+    CPPUNIT_ASSERT( ! simulator.simulateOne( near_world.world(), forward, &near_result ) );
+
+    // the candidate away from the opponent is safer.
+    std::vector< DribbleSimulator::Candidate > candidates;
+    candidates.push_back( forward );
+    candidates.push_back( DribbleSimulator::Candidate( 90.0, 100.0, 2 ) );
+
+    std::vector< DribbleSimulator::Result > results;
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), simulator.simulate( far_world.world(), candidates, &results ) );
+    CPPUNIT_ASSERT_EQUAL( 1, results[0].candidate_index_ );
+    CPPUNIT_ASSERT( ! DribbleSimulator::is_safer( results[1], results[0] ) );
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
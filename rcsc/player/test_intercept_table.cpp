@@ -0,0 +1,405 @@
+// -*-c++-*-
+
+/*!
+  \file test_intercept_table.cpp
+  \brief test code for rcsc::InterceptTable
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "intercept_table.h"
+#include "player_agent.h"
+#include "action_effector.h"
+#include "world_model.h"
+#include "fullstate_sensor.h"
+#include "localization_default.h"
+
+#include <rcsc/common/server_param.h>
+#include <rcsc/game_mode.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+#include <vector>
+
+using namespace rcsc;
+
+namespace {
+
+/*!
+  \brief player agent only used to create the action effector
+ */
+class DummyAgent
+    : public PlayerAgent {
+protected:
+    void actionImpl() override
+      { }
+};
+
+/*!
+  \brief player state written into the fullstate message
+ */
+struct PlayerState {
+    SideID side_;
+    int unum_;
+    bool goalie_;
+    Vector2D pos_;
+    Vector2D vel_;
+
+    PlayerState( const SideID side,
+                 const int unum,
+                 const bool goalie,
+                 const Vector2D & pos,
+                 const Vector2D & vel )
+        : side_( side ),
+          unum_( unum ),
+          goalie_( goalie ),
+          pos_( pos ),
+          vel_( vel )
+      { }
+};
+
+/*!
+  \brief world model of the left player 10 updated cycle by cycle.
+  the players in the fullstate messages are seen again, and the others
+  are only predicted by the world model.
+ */
+class CycleWorld {
+private:
+    DummyAgent M_agent;
+    ActionEffector M_effector;
+    WorldModel M_world;
+
+public:
+
+    CycleWorld()
+        : M_effector( M_agent )
+      {
+          M_world.setLocalization( std::shared_ptr< Localization >( new LocalizationDefault() ) );
+          M_world.init( "left", LEFT, 10, false, 18.0 );
+
+          GameMode mode;
+          mode.update( "play_on", GameTime( 1, 0 ) );
+          M_world.updateGameMode( mode, GameTime( 1, 0 ) );
+      }
+
+    const WorldModel & world() const
+      {
+          return M_world;
+      }
+
+    void fullstate( const int cycle,
+                    const Vector2D & ball_pos,
+                    const Vector2D & ball_vel,
+                    const std::vector< PlayerState > & players )
+      {
+          std::ostringstream os;
+          os << "(fullstate " << cycle << " (pmode play_on) (vmode high normal)"
+             << " (count 0 0 0 0 0 0 0 0)"
+             << " (arm (movable 0) (expires 0) (target 0 0) (count 0))"
+             << " (score 0 0)"
+             << " ((b) " << ball_pos.x << ' ' << ball_pos.y
+             << ' ' << ball_vel.x << ' ' << ball_vel.y << ')';
+          for ( const PlayerState & p : players )
+          {
+              os << " ((p " << ( p.side_ == LEFT ? 'l' : 'r' ) << ' ' << p.unum_
+                 << ( p.goalie_ ? " g" : "" ) << " 0) "
+                 << p.pos_.x << ' ' << p.pos_.y << ' '
+                 << p.vel_.x << ' ' << p.vel_.y << ' '
+                 << ( ball_pos - p.pos_ ).th().degree()
+                 << " 0 (stamina 8000 1 1 130600))";
+          }
+          os << ')';
+
+          const GameTime current( cycle, 0 );
+
+          FullstateSensor sensor;
+          sensor.parse( os.str().c_str(), LEFT, 18.0, current );
+          M_world.updateAfterFullstate( sensor, M_effector, current );
+          M_world.updateJustBeforeDecision( M_effector, current );
+      }
+
+    void predict( const int cycle )
+      {
+          M_world.updateJustBeforeDecision( M_effector, GameTime( cycle, 0 ) );
+      }
+};
+
+/*!
+  \brief the initial players. self, 3 teammates and 4 opponents with their goalie.
+ */
+std::vector< PlayerState >
+create_players()
+{
+    std::vector< PlayerState > players;
+    players.emplace_back( LEFT, 10, false, Vector2D( -20.0, -10.0 ), Vector2D( 0.0, 0.0 ) );
+    players.emplace_back( LEFT, 7, false, Vector2D( 10.0, -15.0 ), Vector2D( 0.2, 0.1 ) );
+    players.emplace_back( LEFT, 9, false, Vector2D( 25.0, 10.0 ), Vector2D( 0.0, -0.2 ) );
+    players.emplace_back( LEFT, 11, false, Vector2D( 5.0, 20.0 ), Vector2D( 0.3, 0.0 ) );
+    players.emplace_back( RIGHT, 1, true, Vector2D( 48.0, 2.0 ), Vector2D( 0.0, 0.0 ) );
+    players.emplace_back( RIGHT, 2, false, Vector2D( 15.0, 3.0 ), Vector2D( -0.3, 0.0 ) );
+    players.emplace_back( RIGHT, 3, false, Vector2D( 30.0, -8.0 ), Vector2D( 0.0, 0.2 ) );
+    players.emplace_back( RIGHT, 4, false, Vector2D( 20.0, 15.0 ), Vector2D( 0.1, -0.1 ) );
+    return players;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+
+class InterceptTableTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( InterceptTableTest );
+    CPPUNIT_TEST( testPredictedPath );
+    CPPUNIT_TEST( testSeenAgain );
+    CPPUNIT_TEST( testKicked );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+
+    void checkFullUpdate( const WorldModel & wm );
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testPredictedPath();
+    void testSeenAgain();
+    void testKicked();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( InterceptTableTest );
+
+/*-------------------------------------------------------------------*/
+void
+InterceptTableTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+InterceptTableTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  compare the table of the world model, that may reuse the last results,
+  with a new table that simulates all players.
+ */
+void
+InterceptTableTest::checkFullUpdate( const WorldModel & wm )
+{
+    const InterceptTable & table = wm.interceptTable();
+
+    InterceptTable full;
+    full.update( wm );
+
+    CPPUNIT_ASSERT_EQUAL( 0, full.reuseCount() );
+    CPPUNIT_ASSERT( table.playerMap() == full.playerMap() );
+
+    CPPUNIT_ASSERT_EQUAL( full.teammateStep(), table.teammateStep() );
+    CPPUNIT_ASSERT_EQUAL( full.secondTeammateStep(), table.secondTeammateStep() );
+    CPPUNIT_ASSERT_EQUAL( full.ourGoalieStep(), table.ourGoalieStep() );
+    CPPUNIT_ASSERT_EQUAL( full.opponentStep(), table.opponentStep() );
+    CPPUNIT_ASSERT_EQUAL( full.secondOpponentStep(), table.secondOpponentStep() );
+    CPPUNIT_ASSERT( full.firstTeammate() == table.firstTeammate() );
+    CPPUNIT_ASSERT( full.secondTeammate() == table.secondTeammate() );
+    CPPUNIT_ASSERT( full.firstOpponent() == table.firstOpponent() );
+    CPPUNIT_ASSERT( full.secondOpponent() == table.secondOpponent() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  the ball moves on the predicted path and no player is seen again.
+  the results are reused until the bonus step reaches its limit.
+ */
+void
+InterceptTableTest::testPredictedPath()
+{
+    const std::vector< PlayerState > players = create_players();
+
+    CycleWorld world;
+    world.fullstate( 1, Vector2D( 0.0, 0.0 ), Vector2D( 2.0, 0.4 ), players );
+
+    CPPUNIT_ASSERT_EQUAL( 0, world.world().interceptTable().reuseCount() );
+    checkFullUpdate( world.world() );
+
+    for ( int cycle = 2; cycle <= 5; ++cycle )
+    {
+        world.predict( cycle );
+
+        const int reuse_count = world.world().interceptTable().reuseCount();
+        if ( cycle <= 4 )
+        {
+            // the teammate 9 and the opponent 2
+            CPPUNIT_ASSERT_EQUAL( 2, reuse_count );
+        }
+        else
+        {
+            // the bonus step has reached its limit.
+            CPPUNIT_ASSERT_EQUAL( 0, reuse_count );
+        }
+
+        checkFullUpdate( world.world() );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  the ball moves on the predicted path, and some players are seen again.
+  only the other players can reuse the last results.
+  in this situation, the teammate 9 and the opponent 2 need no turn, and
+  their results are reusable.
+ */
+void
+InterceptTableTest::testSeenAgain()
+{
+    const double decay = ServerParam::i().ballDecay();
+    std::vector< PlayerState > players = create_players();
+
+    CycleWorld world;
+
+    Vector2D ball_pos( 0.0, 0.0 );
+    Vector2D ball_vel( 2.0, 0.4 );
+    world.fullstate( 1, ball_pos, ball_vel, players );
+
+    ball_pos += ball_vel;
+    ball_vel *= decay;
+
+    // self and the opponent 2, that is moved from its predicted position.
+    std::vector< PlayerState > seen;
+    seen.push_back( players[0] );
+    seen.emplace_back( RIGHT, 2, false, Vector2D( 12.0, 6.0 ), Vector2D( 0.0, 0.3 ) );
+    world.fullstate( 2, ball_pos, ball_vel, seen );
+
+    CPPUNIT_ASSERT_EQUAL( 1, world.world().interceptTable().reuseCount() );
+    checkFullUpdate( world.world() );
+
+    ball_pos += ball_vel;
+    ball_vel *= decay;
+
+    // the teammate 9 and the goalie are seen again at their predicted positions.
+    // the goalie result is simulated again because of its turns.
+    seen.clear();
+    seen.push_back( players[0] );
+    for ( const PlayerState & p : players )
+    {
+        if ( ( p.side_ == LEFT && p.unum_ == 9 )
+             || p.goalie_ )
+        {
+            const Vector2D vel = p.vel_ * ServerParam::i().defaultPlayerDecay() * ServerParam::i().defaultPlayerDecay();
+            seen.emplace_back( p.side_, p.unum_, p.goalie_,
+                               p.pos_ + p.vel_ + p.vel_ * ServerParam::i().defaultPlayerDecay(),
+                               vel );
+        }
+    }
+    world.fullstate( 3, ball_pos, ball_vel, seen );
+
+    CPPUNIT_ASSERT_EQUAL( 0, world.world().interceptTable().reuseCount() );
+    checkFullUpdate( world.world() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  the ball is kicked and leaves the predicted path.
+  all players are simulated again.
+ */
+void
+InterceptTableTest::testKicked()
+{
+    const double decay = ServerParam::i().ballDecay();
+    const std::vector< PlayerState > players = create_players();
+
+    CycleWorld world;
+
+    Vector2D ball_pos( 0.0, 0.0 );
+    Vector2D ball_vel( 2.0, 0.4 );
+    world.fullstate( 1, ball_pos, ball_vel, players );
+
+    world.predict( 2 );
+    CPPUNIT_ASSERT( world.world().interceptTable().reuseCount() > 0 );
+    checkFullUpdate( world.world() );
+
+    ball_pos += ball_vel;
+    ball_vel *= decay;
+    ball_pos += ball_vel;
+    ball_vel *= decay;
+
+    // the ball velocity is changed by someone's kick.
+    std::vector< PlayerState > seen;
+    seen.push_back( players[0] );
+    world.fullstate( 3, ball_pos, Vector2D( -1.5, 1.0 ), seen );
+
+    CPPUNIT_ASSERT_EQUAL( 0, world.world().interceptTable().reuseCount() );
+    checkFullUpdate( world.world() );
+
+    // a small change is also detected.
+    ball_pos += Vector2D( -1.5, 1.0 );
+    world.fullstate( 4, ball_pos, Vector2D( -1.5, 1.0 ) * decay + Vector2D( 0.01, 0.0 ), seen );
+
+    CPPUNIT_ASSERT_EQUAL( 0, world.world().interceptTable().reuseCount() );
+    checkFullUpdate( world.world() );
+}
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,356 @@
+// -*-c++-*-
+
+/*!
+  \file test_player_command.cpp
+  \brief test code for rcsc::PlayerCommand string composition
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "player_command.h"
+#include "see_state.h"
+
+#include <rcsc/time/timer.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+#include <sstream>
+#include <iostream>
+#include <limits>
+#include <cmath>
+
+using namespace rcsc;
+
+namespace {
+
+/*!
+  \brief compose the command by both methods and compare them.
+  \return true if both strings are identical
+ */
+bool
+compare( const PlayerCommand & com )
+{
+    std::ostringstream ostr;
+    com.toCommandString( ostr );
+    const std::string expected = ostr.str();
+
+    char buf[1024];
+    char * end = com.toCommandBuffer( buf, buf + sizeof( buf ) );
+    if ( ! end )
+    {
+        std::cerr << "\nbuffer overflow. expected=[" << expected << "]" << std::endl;
+        return false;
+    }
+
+    const std::string actual( buf, end - buf );
+    if ( expected != actual )
+    {
+        std::cerr << "\nexpected=[" << expected << "]\n"
+                  << "  actual=[" << actual << "]" << std::endl;
+        return false;
+    }
+
+    // the output must fit the exact size, and must fail if one byte is missing.
+    if ( ! com.toCommandBuffer( buf, buf + expected.length() )
+         || ( ! expected.empty()
+              && com.toCommandBuffer( buf, buf + expected.length() - 1 ) ) )
+    {
+        std::cerr << "\nbad boundary check. expected=[" << expected << "]" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+  \brief generate the double values that cover the formatting cases
+ */
+std::vector< double >
+sample_values()
+{
+    std::vector< double > values = {
+        0.0, -0.0, 1.0, -1.0, 0.5, -0.5, 100.0, -100.0, 180.0, -180.0,
+        0.001, -0.001, 1.0e-4, 1.0e-5, 1.234567e-5, 123456.0, 1234567.0,
+        999999.5, 9999995.0, 1.0e+15, -1.0e+15, 0.1, 0.2, 0.3, 1.0 / 3.0,
+        2.0 / 3.0, 52.5, -34.0, 3.14159265358979, 99.99995, 0.0000995,
+        std::numeric_limits< double >::min(),
+        std::numeric_limits< double >::max(),
+        std::numeric_limits< double >::denorm_min(),
+    };
+
+    std::mt19937 engine( 12345 );
+    std::uniform_real_distribution<> wide( -200.0, 200.0 );
+    std::uniform_real_distribution<> exponent( -12.0, 12.0 );
+    std::uniform_int_distribution<> integer( -200, 200 );
+
+    for ( int i = 0; i < 3000; ++i )
+    {
+        values.push_back( wide( engine ) );
+        values.push_back( std::pow( 10.0, exponent( engine ) ) * ( i % 2 ? 1.0 : -1.0 ) );
+        values.push_back( integer( engine ) );
+        values.push_back( std::rint( wide( engine ) * 1000.0 ) * 0.001 );
+    }
+
+    return values;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+
+class PlayerCommandTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( PlayerCommandTest );
+    CPPUNIT_TEST( testBodyCommands );
+    CPPUNIT_TEST( testSupportCommands );
+    CPPUNIT_TEST( testBench );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testBodyCommands();
+    void testSupportCommands();
+    void testBench();
+};
+
+
+/*-------------------------------------------------------------------*/
+
+CPPUNIT_TEST_SUITE_REGISTRATION( PlayerCommandTest );
+
+/*-------------------------------------------------------------------*/
+void
+PlayerCommandTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+PlayerCommandTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+PlayerCommandTest::testBodyCommands()
+{
+    const std::vector< double > values = sample_values();
+
+    for ( std::size_t i = 0; i < values.size(); ++i )
+    {
+        const double a = values[i];
+        const double b = values[( i * 7 + 3 ) % values.size()];
+        const double c = values[( i * 13 + 5 ) % values.size()];
+        const double d = values[( i * 17 + 11 ) % values.size()];
+
+        CPPUNIT_ASSERT( compare( PlayerMoveCommand( a, b ) ) );
+        CPPUNIT_ASSERT( compare( PlayerDashCommand( a ) ) );
+        CPPUNIT_ASSERT( compare( PlayerDashCommand( a, b ) ) );
+        CPPUNIT_ASSERT( compare( PlayerDashCommand( a, b, c, d ) ) );
+        CPPUNIT_ASSERT( compare( PlayerTurnCommand( a ) ) );
+        CPPUNIT_ASSERT( compare( PlayerKickCommand( a, b ) ) );
+        CPPUNIT_ASSERT( compare( PlayerCatchCommand( a ) ) );
+        CPPUNIT_ASSERT( compare( PlayerTackleCommand( a ) ) );
+        CPPUNIT_ASSERT( compare( PlayerTackleCommand( a, true ) ) );
+        CPPUNIT_ASSERT( compare( PlayerTackleCommand( a, false ) ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+PlayerCommandTest::testSupportCommands()
+{
+    const std::vector< double > values = sample_values();
+
+    for ( std::size_t i = 0; i < values.size(); ++i )
+    {
+        const double a = values[i];
+        const double b = values[( i * 7 + 3 ) % values.size()];
+
+        CPPUNIT_ASSERT( compare( PlayerTurnNeckCommand( a ) ) );
+        CPPUNIT_ASSERT( compare( PlayerChangeFocusCommand( a, b ) ) );
+        CPPUNIT_ASSERT( compare( PlayerPointtoCommand( a, b ) ) );
+    }
+
+    const double versions[] = { 3.0, 7.0, 8.0, 13.0, 18.0 };
+    for ( const double v : versions )
+    {
+        CPPUNIT_ASSERT( compare( PlayerInitCommand( "HELIOS_base", v, false ) ) );
+        CPPUNIT_ASSERT( compare( PlayerInitCommand( "HELIOS_base", v, true ) ) );
+        CPPUNIT_ASSERT( compare( PlayerSayCommand( "abc\"def", v ) ) );
+        CPPUNIT_ASSERT( compare( PlayerSayCommand( std::string( "Bz?(0-" ), v ) ) );
+        CPPUNIT_ASSERT( compare( PlayerSayCommand( v ) ) );
+    }
+
+    CPPUNIT_ASSERT( compare( PlayerReconnectCommand( "HELIOS_base", 1 ) ) );
+    CPPUNIT_ASSERT( compare( PlayerReconnectCommand( "HELIOS_base", 11 ) ) );
+    CPPUNIT_ASSERT( compare( PlayerByeCommand() ) );
+    CPPUNIT_ASSERT( compare( PlayerPointtoCommand() ) );
+    CPPUNIT_ASSERT( compare( PlayerAttentiontoCommand() ) );
+    CPPUNIT_ASSERT( compare( PlayerCLangCommand( 7, 8 ) ) );
+    CPPUNIT_ASSERT( compare( PlayerSenseBodyCommand() ) );
+    CPPUNIT_ASSERT( compare( PlayerScoreCommand() ) );
+    CPPUNIT_ASSERT( compare( PlayerDoneCommand() ) );
+
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        CPPUNIT_ASSERT( compare( PlayerAttentiontoCommand( PlayerAttentiontoCommand::OUR, unum ) ) );
+        CPPUNIT_ASSERT( compare( PlayerAttentiontoCommand( PlayerAttentiontoCommand::OPP, unum ) ) );
+    }
+
+    for ( int level = 0; level <= 9; ++level )
+    {
+        CPPUNIT_ASSERT( compare( PlayerCompressionCommand( level ) ) );
+    }
+
+    const PlayerEarCommand::OnOffType onoff[] = { PlayerEarCommand::ON, PlayerEarCommand::OFF };
+    const PlayerEarCommand::SideType side[] = { PlayerEarCommand::OUR, PlayerEarCommand::OPP };
+    const PlayerEarCommand::ModeType mode[] = { PlayerEarCommand::COMPLETE,
+                                                PlayerEarCommand::PARTIAL,
+                                                PlayerEarCommand::ALL };
+    for ( const PlayerEarCommand::OnOffType o : onoff )
+    {
+        for ( const PlayerEarCommand::SideType s : side )
+        {
+            CPPUNIT_ASSERT( compare( PlayerEarCommand( o, s ) ) );
+            for ( const PlayerEarCommand::ModeType m : mode )
+            {
+                CPPUNIT_ASSERT( compare( PlayerEarCommand( o, s, m ) ) );
+            }
+        }
+    }
+
+    const ViewWidth::Type widths[] = { ViewWidth::NARROW, ViewWidth::NORMAL, ViewWidth::WIDE };
+    const ViewQuality::Type qualities[] = { ViewQuality::HIGH, ViewQuality::LOW };
+
+    // the synch see mode cannot be reset. check the normal mode first.
+    for ( int synch = 0; synch < 2; ++synch )
+    {
+        if ( synch )
+        {
+            SeeState see_state;
+            see_state.setSynchSeeMode();
+        }
+
+        for ( const ViewWidth::Type w : widths )
+        {
+            for ( const ViewQuality::Type q : qualities )
+            {
+                CPPUNIT_ASSERT( compare( PlayerChangeViewCommand( w, q ) ) );
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+PlayerCommandTest::testBench()
+{
+    const std::vector< double > values = sample_values();
+    const std::size_t n_loop = 20;
+
+    std::size_t total_length = 0;
+
+    Timer timer;
+    for ( std::size_t loop = 0; loop < n_loop; ++loop )
+    {
+        for ( std::size_t i = 0; i + 1 < values.size(); ++i )
+        {
+            std::ostringstream ostr;
+            PlayerDashCommand( values[i], values[i + 1] ).toCommandString( ostr );
+            PlayerTurnNeckCommand( values[i + 1] ).toCommandString( ostr );
+            const std::string str = ostr.str();
+            total_length += str.length();
+        }
+    }
+    const double stream_msec = timer.elapsedReal();
+
+    char buf[1024];
+    timer.restart();
+    for ( std::size_t loop = 0; loop < n_loop; ++loop )
+    {
+        for ( std::size_t i = 0; i + 1 < values.size(); ++i )
+        {
+            char * first = buf;
+            char * const last = buf + sizeof( buf ) - 1;
+            first = PlayerDashCommand( values[i], values[i + 1] ).toCommandBuffer( first, last );
+            first = PlayerTurnNeckCommand( values[i + 1] ).toCommandBuffer( first, last );
+            *first = '\0';
+            total_length -= ( first - buf );
+        }
+    }
+    const double buffer_msec = timer.elapsedReal();
+
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), total_length );
+
+    const double n_message = n_loop * ( values.size() - 1 );
+    std::cout << "\n  ostream: " << n_message / std::max( 1.0e-3, stream_msec ) * 1000.0 << " msg/s"
+              << "\n  buffer:  " << n_message / std::max( 1.0e-3, buffer_msec ) * 1000.0 << " msg/s"
+              << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,360 @@
+// -*-c++-*-
+
+/*!
+  \file test_reach_grid.cpp
+  \brief test code for rcsc::ReachGrid
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "reach_grid.h"
+#include "player_object.h"
+#include "localization.h"
+
+#include <rcsc/common/player_type.h>
+#include <rcsc/math_util.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+
+class ReachGridTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( ReachGridTest );
+    CPPUNIT_TEST( testAddPlayer );
+    CPPUNIT_TEST( testBonusStep );
+    CPPUNIT_TEST( testInterpolateCorner );
+    CPPUNIT_TEST( testInterpolateEdge );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+
+    PlayerObject createPlayer( const Vector2D & pos,
+                               const int pos_count );
+
+    std::vector< unsigned char > createGrid( const PlayerObject & player );
+
+    int expectedStep( const PlayerObject & player,
+                      const int ix,
+                      const int iy );
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testAddPlayer();
+    void testBonusStep();
+    void testInterpolateCorner();
+    void testInterpolateEdge();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ReachGridTest );
+
+/*-------------------------------------------------------------------*/
+void
+ReachGridTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+ReachGridTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+PlayerObject
+ReachGridTest::createPlayer( const Vector2D & pos,
+                             const int pos_count )
+{
+    Localization::PlayerT p;
+    p.pos_ = pos;
+
+    PlayerObject player( LEFT, p );
+    player.setPlayerType( Hetero_Default );
+    for ( int i = 0; i < pos_count; ++i )
+    {
+        player.update();
+    }
+
+    return player;
+}
+
+/*-------------------------------------------------------------------*/
+std::vector< unsigned char >
+ReachGridTest::createGrid( const PlayerObject & player )
+{
+    std::vector< unsigned char > grid( ReachGrid::GRID_X_SIZE * ReachGrid::GRID_Y_SIZE,
+                                       ReachGrid::MAX_STEP );
+    ReachGrid::add_player( player, grid );
+    return grid;
+}
+
+/*-------------------------------------------------------------------*/
+int
+ReachGridTest::expectedStep( const PlayerObject & player,
+                             const int ix,
+                             const int iy )
+{
+    const PlayerType * ptype = player.playerTypePtr();
+    const int bonus = std::min( ReachGrid::MAX_BONUS_STEP, player.posCount() );
+    const double dist = ReachGrid::grid_point( ix, iy ).dist( player.pos() );
+
+    if ( dist > ( ptype->kickableArea()
+                  + ptype->getMovableDistance( ReachGrid::MAX_STEP + bonus ) ) )
+    {
+        return ReachGrid::MAX_STEP;
+    }
+
+    return bound( 0, ptype->reachStep( dist, 0.0 ) - bonus, ReachGrid::MAX_STEP );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ReachGridTest::testAddPlayer()
+{
+    const Vector2D pos( 10.3, -5.6 );
+    const PlayerObject player = createPlayer( pos, 0 );
+    CPPUNIT_ASSERT( player.playerTypePtr() );
+    CPPUNIT_ASSERT_EQUAL( 0, player.posCount() );
+
+    const std::vector< unsigned char > grid = createGrid( player );
+
+    for ( int ix = 0; ix < ReachGrid::GRID_X_SIZE; ++ix )
+    {
+        for ( int iy = 0; iy < ReachGrid::GRID_Y_SIZE; ++iy )
+        {
+            CPPUNIT_ASSERT_EQUAL( expectedStep( player, ix, iy ),
+                                  static_cast< int >( grid[ix * ReachGrid::GRID_Y_SIZE + iy] ) );
+        }
+    }
+
+    // the nearest grid point is reachable in a few steps.
+    const int ix = static_cast< int >( std::floor( ( pos.x + ReachGrid::PITCH_MAX_X ) / ReachGrid::GRID_LENGTH + 0.5 ) );
+    const int iy = static_cast< int >( std::floor( ( pos.y + ReachGrid::PITCH_MAX_Y ) / ReachGrid::GRID_LENGTH + 0.5 ) );
+    CPPUNIT_ASSERT( grid[ix * ReachGrid::GRID_Y_SIZE + iy] <= 1 );
+
+    // the step never decreases while moving away from the player.
+    for ( int i = ix + 1; i < ReachGrid::GRID_X_SIZE; ++i )
+    {
+        CPPUNIT_ASSERT( grid[( i - 1 ) * ReachGrid::GRID_Y_SIZE + iy]
+                        <= grid[i * ReachGrid::GRID_Y_SIZE + iy] );
+    }
+
+    // the grid point far from the player is not changed.
+    CPPUNIT_ASSERT_EQUAL( ReachGrid::MAX_STEP,
+                          static_cast< int >( grid[0] ) );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ReachGridTest::testBonusStep()
+{
+    const Vector2D pos( -20.0, 15.0 );
+    const std::vector< unsigned char > grid0 = createGrid( createPlayer( pos, 0 ) );
+
+    for ( int count = 1; count <= ReachGrid::MAX_BONUS_STEP + 2; ++count )
+    {
+        const PlayerObject player = createPlayer( pos, count );
+        CPPUNIT_ASSERT_EQUAL( count, player.posCount() );
+
+        const int bonus = std::min( ReachGrid::MAX_BONUS_STEP, count );
+        const std::vector< unsigned char > grid = createGrid( player );
+
+        for ( int ix = 0; ix < ReachGrid::GRID_X_SIZE; ++ix )
+        {
+            for ( int iy = 0; iy < ReachGrid::GRID_Y_SIZE; ++iy )
+            {
+                const int idx = ix * ReachGrid::GRID_Y_SIZE + iy;
+                CPPUNIT_ASSERT_EQUAL( expectedStep( player, ix, iy ),
+                                      static_cast< int >( grid[idx] ) );
+
+                // the bonus step is subtracted from the step without bonus
+                if ( grid0[idx] < ReachGrid::MAX_STEP )
+                {
+                    CPPUNIT_ASSERT_EQUAL( std::max( 0, grid0[idx] - bonus ),
+                                          static_cast< int >( grid[idx] ) );
+                }
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+ReachGridTest::testInterpolateCorner()
+{
+    // linear function is exactly reproduced by the bilinear interpolation
+    std::vector< unsigned char > grid( ReachGrid::GRID_X_SIZE * ReachGrid::GRID_Y_SIZE );
+    for ( int ix = 0; ix < ReachGrid::GRID_X_SIZE; ++ix )
+    {
+        for ( int iy = 0; iy < ReachGrid::GRID_Y_SIZE; ++iy )
+        {
+            grid[ix * ReachGrid::GRID_Y_SIZE + iy] = static_cast< unsigned char >( ix + iy );
+        }
+    }
+
+    for ( int ix = 0; ix < ReachGrid::GRID_X_SIZE; ++ix )
+    {
+        for ( int iy = 0; iy < ReachGrid::GRID_Y_SIZE; ++iy )
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( ix + iy,
+                                          ReachGrid::interpolate( grid, ReachGrid::grid_point( ix, iy ) ),
+                                          1.0e-9 );
+        }
+    }
+
+    const Vector2D pos = ReachGrid::grid_point( 20, 30 )
+        + Vector2D( 0.25, 0.75 ) * ReachGrid::GRID_LENGTH;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 20 + 30 + 0.25 + 0.75,
+                                  ReachGrid::interpolate( grid, pos ),
+                                  1.0e-9 );
+
+    // single peak. the value at the cell center is the quarter of the peak.
+    std::fill( grid.begin(), grid.end(), 0 );
+    grid[20 * ReachGrid::GRID_Y_SIZE + 30] = 100;
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 100.0,
+                                  ReachGrid::interpolate( grid, ReachGrid::grid_point( 20, 30 ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0,
+                                  ReachGrid::interpolate( grid, ReachGrid::grid_point( 21, 30 ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0,
+                                  ReachGrid::interpolate( grid, ReachGrid::grid_point( 20, 31 ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 25.0,
+                                  ReachGrid::interpolate( grid,
+                                                          ReachGrid::grid_point( 20, 30 )
+                                                          + Vector2D( 0.5, 0.5 ) * ReachGrid::GRID_LENGTH ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 25.0,
+                                  ReachGrid::interpolate( grid,
+                                                          ReachGrid::grid_point( 20, 30 )
+                                                          - Vector2D( 0.5, 0.5 ) * ReachGrid::GRID_LENGTH ),
+                                  1.0e-9 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ReachGridTest::testInterpolateEdge()
+{
+    const int max_ix = ReachGrid::GRID_X_SIZE - 1;
+    const int max_iy = ReachGrid::GRID_Y_SIZE - 1;
+
+    std::vector< unsigned char > grid( ReachGrid::GRID_X_SIZE * ReachGrid::GRID_Y_SIZE );
+    for ( int ix = 0; ix < ReachGrid::GRID_X_SIZE; ++ix )
+    {
+        for ( int iy = 0; iy < ReachGrid::GRID_Y_SIZE; ++iy )
+        {
+            grid[ix * ReachGrid::GRID_Y_SIZE + iy] = static_cast< unsigned char >( ix + iy );
+        }
+    }
+
+    // four corners of the grid
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0,
+                                  ReachGrid::interpolate( grid, ReachGrid::grid_point( 0, 0 ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( max_ix,
+                                  ReachGrid::interpolate( grid, ReachGrid::grid_point( max_ix, 0 ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( max_iy,
+                                  ReachGrid::interpolate( grid, ReachGrid::grid_point( 0, max_iy ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( max_ix + max_iy,
+                                  ReachGrid::interpolate( grid, ReachGrid::grid_point( max_ix, max_iy ) ),
+                                  1.0e-9 );
+
+    // the points outside of the grid are clamped to the edge
+    const double far = 1000.0;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0,
+                                  ReachGrid::interpolate( grid, Vector2D( -far, -far ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( max_ix + max_iy,
+                                  ReachGrid::interpolate( grid, Vector2D( +far, +far ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( max_ix + 10,
+                                  ReachGrid::interpolate( grid,
+                                                          Vector2D( +far, ReachGrid::grid_point( 0, 10 ).y ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 10 + max_iy,
+                                  ReachGrid::interpolate( grid,
+                                                          Vector2D( ReachGrid::grid_point( 10, 0 ).x, +far ) ),
+                                  1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 10.5,
+                                  ReachGrid::interpolate( grid,
+                                                          Vector2D( -far,
+                                                                    ReachGrid::grid_point( 0, 10 ).y
+                                                                    + 0.5 * ReachGrid::GRID_LENGTH ) ),
+                                  1.0e-9 );
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+// -*-c++-*-
+
+/*!
+  \file test_view_grid_map.cpp
+  \brief test code for rcsc::ViewGridMap
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "view_grid_map.h"
+#include "view_area.h"
+
+#include <rcsc/common/server_param.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+#include <vector>
+#include <cmath>
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+
+class ViewGridMapTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( ViewGridMapTest );
+    CPPUNIT_TEST( testUpdate );
+    CPPUNIT_TEST( testAngleSum );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    std::mt19937 M_engine;
+
+    //! per cell counter updated by the straightforward method.
+    std::vector< int > M_counts;
+
+    ViewArea createViewArea( const GameTime & time );
+    void updateCounts( const ViewArea & view_area );
+    void checkCounts( const ViewGridMap & grid_map );
+
+    long sumAngle( const Vector2D & origin,
+                   const AngleDeg & left_angle,
+                   const int width );
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testUpdate();
+    void testAngleSum();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ViewGridMapTest );
+
+/*-------------------------------------------------------------------*/
+void
+ViewGridMapTest::setUp()
+{
+    M_engine.seed( 12345 );
+    M_counts.assign( ViewGridMap::GRID_X_SIZE * ViewGridMap::GRID_Y_SIZE, 0 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ViewGridMapTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+ViewArea
+ViewGridMapTest::createViewArea( const GameTime & time )
+{
+    static const double widths[] = { 60.0, 120.0, 180.0 };
+
+    std::uniform_real_distribution< double > x_dist( -ViewGridMap::PITCH_MAX_X - 5.0,
+                                                     +ViewGridMap::PITCH_MAX_X + 5.0 );
+    std::uniform_real_distribution< double > y_dist( -ViewGridMap::PITCH_MAX_Y - 5.0,
+                                                     +ViewGridMap::PITCH_MAX_Y + 5.0 );
+    std::uniform_real_distribution< double > angle_dist( -180.0, 180.0 );
+    std::uniform_int_distribution< int > width_dist( 0, 2 );
+
+    return ViewArea( widths[width_dist( M_engine )],
+                     Vector2D( x_dist( M_engine ), y_dist( M_engine ) ),
+                     AngleDeg( angle_dist( M_engine ) ),
+                     time );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ViewGridMapTest::updateCounts( const ViewArea & view_area )
+{
+    const AngleDeg left_angle = view_area.angle() - view_area.viewWidth() * 0.5 + 2.0;
+    const AngleDeg right_angle = view_area.angle() + view_area.viewWidth() * 0.5 - 2.0;
+    const double visible_dist = ServerParam::i().visibleDistance() - 0.5;
+
+    for ( int ix = 0; ix < ViewGridMap::GRID_X_SIZE; ++ix )
+    {
+        for ( int iy = 0; iy < ViewGridMap::GRID_Y_SIZE; ++iy )
+        {
+            int & count = M_counts[ix * ViewGridMap::GRID_Y_SIZE + iy];
+            ++count;
+
+            const Vector2D rpos = ViewGridMap::gridCenter( ix, iy ) - view_area.origin();
+            if ( rpos.r() < visible_dist )
+            {
+                count = 0;
+                continue;
+            }
+
+            const AngleDeg angle = rpos.th();
+            if ( angle.isRightOf( left_angle )
+                 && angle.isLeftOf( right_angle ) )
+            {
+                count = 0;
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+void
+ViewGridMapTest::checkCounts( const ViewGridMap & grid_map )
+{
+    for ( int ix = 0; ix < ViewGridMap::GRID_X_SIZE; ++ix )
+    {
+        for ( int iy = 0; iy < ViewGridMap::GRID_Y_SIZE; ++iy )
+        {
+            CPPUNIT_ASSERT_EQUAL( M_counts[ix * ViewGridMap::GRID_Y_SIZE + iy],
+                                  grid_map.seenCount( ix, iy ) );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+long
+ViewGridMapTest::sumAngle( const Vector2D & origin,
+                           const AngleDeg & left_angle,
+                           const int width )
+{
+    const int first_bin = static_cast< int >( std::floor( left_angle.degree() + 180.0 ) ) % 360;
+
+    long sum = 0;
+    for ( int ix = 0; ix < ViewGridMap::GRID_X_SIZE; ++ix )
+    {
+        for ( int iy = 0; iy < ViewGridMap::GRID_Y_SIZE; ++iy )
+        {
+            const Vector2D rpos = ViewGridMap::gridCenter( ix, iy ) - origin;
+            const int bin = static_cast< int >( std::floor( rpos.th().degree() + 180.0 ) ) % 360;
+            if ( ( bin - first_bin + 360 ) % 360 < width )
+            {
+                sum += M_counts[ix * ViewGridMap::GRID_Y_SIZE + iy];
+            }
+        }
+    }
+
+    return sum;
+}
+
+/*-------------------------------------------------------------------*/
+void
+ViewGridMapTest::testUpdate()
+{
+    ViewGridMap grid_map;
+
+    for ( int t = 1; t <= 200; ++t )
+    {
+        const GameTime time( t, 0 );
+        const ViewArea view_area = createViewArea( time );
+
+        grid_map.incrementAll();
+        grid_map.update( time, view_area );
+        updateCounts( view_area );
+
+        checkCounts( grid_map );
+    }
+
+    // the second update in the same cycle is ignored.
+    const GameTime last_time( 200, 0 );
+    grid_map.update( last_time, createViewArea( last_time ) );
+    checkCounts( grid_map );
+}
+
+/*-------------------------------------------------------------------*/
+void
+ViewGridMapTest::testAngleSum()
+{
+    ViewGridMap grid_map;
+
+    std::uniform_real_distribution< double > x_dist( -ViewGridMap::PITCH_MAX_X,
+                                                     +ViewGridMap::PITCH_MAX_X );
+    std::uniform_real_distribution< double > y_dist( -ViewGridMap::PITCH_MAX_Y,
+                                                     +ViewGridMap::PITCH_MAX_Y );
+    std::uniform_int_distribution< int > angle_dist( -180, 179 );
+
+    for ( int t = 1; t <= 30; ++t )
+    {
+        const GameTime time( t, 0 );
+        const ViewArea view_area = createViewArea( time );
+
+        grid_map.incrementAll();
+        grid_map.update( time, view_area );
+        updateCounts( view_area );
+
+        const Vector2D origin( x_dist( M_engine ), y_dist( M_engine ) );
+
+        for ( int i = 0; i < 10; ++i )
+        {
+            const AngleDeg left_angle( angle_dist( M_engine ) );
+            const int width = 60 * ( 1 + i % 3 );
+
+            CPPUNIT_ASSERT_EQUAL( sumAngle( origin, left_angle, width ),
+                                  grid_map.angleSeenCountSum( origin, left_angle, width ) );
+        }
+
+        // the best angle within the scan range
+        const AngleDeg left_start( angle_dist( M_engine ) );
+        const int scan_range = 240;
+        const int view_width = 60;
+
+        int best_offset = 0;
+        long best_sum = -1;
+        for ( int offset = 0; offset <= scan_range - view_width; ++offset )
+        {
+            const long sum = sumAngle( origin, left_start + offset, view_width );
+            if ( sum > best_sum )
+            {
+                best_offset = offset;
+                best_sum = sum;
+            }
+        }
+
+        long count_sum = 0;
+        const AngleDeg best_angle = grid_map.bestViewAngle( origin, left_start,
+                                                            scan_range, view_width,
+                                                            &count_sum );
+        CPPUNIT_ASSERT_EQUAL( best_sum, count_sum );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( ( left_start + ( best_offset + view_width * 0.5 ) ).degree(),
+                                      best_angle.degree(),
+                                      1.0e-6 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -43,9 +43,9 @@
 #include <rcsc/math_util.h>
 
 
+#include <algorithm>
+#include <limits>
 #include <vector>
-#include <iostream>
-#include <cstring>
 #include <cmath>
 
 #define DEBUG_PROFILE
@@ -69,25 +69,9 @@ const int ViewGridMap::GRID_Y_SIZE = static_cast< int >( std::ceil( ViewGridMap:
 const double ViewGridMap::GRID_RADIUS = ViewGridMap::GRID_LENGTH*0.5 * std::sqrt( 2.0 );
 
 
-namespace {
-
-inline
-int
-grid_x_index( const double x )
-{
-    int ix = static_cast< int >( std::ceil( ( x + ViewGridMap::PITCH_MAX_X )
-                                            / ViewGridMap::GRID_LENGTH ) );
-    return bound( 0, ix, ViewGridMap::GRID_X_SIZE );
-}
+const int ViewGridMap::ANGLE_DIVS;
 
-inline
-int
-grid_y_index( const double y )
-{
-    int iy = static_cast< int >( std::ceil( ( y + ViewGridMap::PITCH_MAX_Y )
-                                            / ViewGridMap::GRID_LENGTH ) );
-    return bound( 0, iy, ViewGridMap::GRID_Y_SIZE );
-}
+namespace {
 
 inline
 int
@@ -103,21 +87,40 @@ grid_index( const Vector2D & pos )
     return ix * ViewGridMap::GRID_Y_SIZE + iy;
 }
 
+/*!
+  \brief restrict the range of t to satisfy a * t > b.
+ */
 inline
-Vector2D
-grid_center( const int ix,
-             const int iy )
+void
+restrict_range( const double a,
+                const double b,
+                double * min_t,
+                double * max_t )
 {
-    return Vector2D( ix * ViewGridMap::GRID_LENGTH - ViewGridMap::PITCH_MAX_X,
-                     iy * ViewGridMap::GRID_LENGTH - ViewGridMap::PITCH_MAX_Y );
+    if ( a > 0.0 )
+    {
+        *min_t = std::max( *min_t, b / a );
+    }
+    else if ( a < 0.0 )
+    {
+        *max_t = std::min( *max_t, b / a );
+    }
+    else if ( b >= 0.0 )
+    {
+        *max_t = *min_t; // empty
+    }
 }
 
+/*!
+  \brief get the histogram bin index of the direction
+ */
 inline
-Vector2D
-grid_center( const int idx )
+int
+angle_bin( const double degree )
 {
-    return grid_center( idx / ViewGridMap::GRID_Y_SIZE,
-                        idx % ViewGridMap::GRID_Y_SIZE );
+    int bin = static_cast< int >( std::floor( degree + 180.0 ) ) % ViewGridMap::ANGLE_DIVS;
+    if ( bin < 0 ) bin += ViewGridMap::ANGLE_DIVS;
+    return bin;
 }
 
 }
@@ -130,16 +133,14 @@ grid_center( const int idx )
 
 */
 ViewGridMap::ViewGridMap()
+    : M_tick( 0 ),
+      M_seen_tick( GRID_X_SIZE * GRID_Y_SIZE, 0 ),
+      M_update_time( -1, 0 ),
+      M_version( 0 ),
+      M_histogram_origin( Vector2D::INVALIDATED ),
+      M_histogram_version( -1 ),
+      M_angle_prefix_sum( ANGLE_DIVS + 1, 0 )
 {
-    M_grid_map.reserve( GRID_X_SIZE * GRID_Y_SIZE );
-
-    for ( int x = 0; x < GRID_X_SIZE; ++x )
-    {
-        for ( int y = 0; y < GRID_Y_SIZE; ++y )
-        {
-            M_grid_map.emplace_back( grid_center( x, y ) );
-        }
-    }
 
 }
 
@@ -159,9 +160,30 @@ ViewGridMap::~ViewGridMap()
 void
 ViewGridMap::incrementAll()
 {
-    for ( Grid & p : M_grid_map )
+    ++M_tick;
+    ++M_version;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+ViewGridMap::setSeenColumn( const int ix,
+                            const double min_y,
+                            const double max_y )
+{
+    // the grid center is included if min_y < y < max_y
+    // the range is clamped before the conversion, because the view cone may be unbounded.
+    const double min_fy = std::floor( ( std::max( min_y, -PITCH_MAX_Y - GRID_LENGTH ) + PITCH_MAX_Y ) / GRID_LENGTH );
+    const double max_fy = std::ceil( ( std::min( max_y, PITCH_MAX_Y + GRID_LENGTH ) + PITCH_MAX_Y ) / GRID_LENGTH );
+    const int min_iy = std::max( 0, static_cast< int >( min_fy ) + 1 );
+    const int max_iy = std::min( GRID_Y_SIZE - 1, static_cast< int >( max_fy ) - 1 );
+
+    int * column = &M_seen_tick[ix * GRID_Y_SIZE];
+    for ( int iy = min_iy; iy <= max_iy; ++iy )
     {
-        p.seen_count_ += 1;
+        column[iy] = M_tick;
     }
 }
 
@@ -173,13 +195,11 @@ void
 ViewGridMap::update( const GameTime & time,
                      const ViewArea & view_area )
 {
-    static GameTime s_update_time( 0, 0 );
-
-    if ( s_update_time == time )
+    if ( M_update_time == time )
     {
         return;
     }
-    s_update_time = time;
+    M_update_time = time;
 
 
 #ifdef DEBUG_PROFILE
@@ -191,35 +211,68 @@ ViewGridMap::update( const GameTime & time,
         return;
     }
 
-    const AngleDeg left_angle = view_area.angle() - view_area.viewWidth() * 0.5 + 2.0;
-    const AngleDeg right_angle = view_area.angle() + view_area.viewWidth() * 0.5 - 2.0;
+    ++M_version;
+
+    const double cone_width = view_area.viewWidth() - 4.0;
+    const AngleDeg left_angle = view_area.angle() - cone_width * 0.5;
+    const AngleDeg right_angle = view_area.angle() + cone_width * 0.5;
 
     static const double VISIBLE_DIST = ServerParam::i().visibleDistance() - 0.5;
+    static const double VISIBLE_DIST2 = VISIBLE_DIST * VISIBLE_DIST;
+
+    const Vector2D & origin = view_area.origin();
+
+    // unit vectors of the cone edges.
+    // a direction v is in the cone if cross(left, v) > 0 and cross(v, right) > 0.
+    const double left_x = left_angle.cos();
+    const double left_y = left_angle.sin();
+    const double right_x = right_angle.cos();
+    const double right_y = right_angle.sin();
 
-    for ( Grid & p : M_grid_map )
+    for ( int ix = 0; ix < GRID_X_SIZE; ++ix )
     {
-        const double dist = view_area.origin().dist( p.center_ );
-        if ( dist < VISIBLE_DIST )
+        const double dx = ( ix * GRID_LENGTH - PITCH_MAX_X ) - origin.x;
+
+        // visible distance
+        if ( dx * dx < VISIBLE_DIST2 )
+        {
+            const double dy = std::sqrt( VISIBLE_DIST2 - dx * dx );
+            setSeenColumn( ix, origin.y - dy, origin.y + dy );
+        }
+
+        // view cone
+        if ( cone_width < 180.0 )
         {
-            p.seen_count_ = 0;
+            // v = ( dx, t ), t = y - origin.y
+            double min_t = -std::numeric_limits< double >::max();
+            double max_t = +std::numeric_limits< double >::max();
+            restrict_range( left_x, left_y * dx, &min_t, &max_t );
+            restrict_range( -right_x, -right_y * dx, &min_t, &max_t );
+
+            if ( min_t < max_t )
+            {
+                setSeenColumn( ix, origin.y + min_t, origin.y + max_t );
+            }
         }
         else
         {
-            const AngleDeg angle = ( p.center_ - view_area.origin() ).th();
-            if ( angle.isRightOf( left_angle )
-                 && angle.isLeftOf( right_angle ) )
+            for ( int iy = 0; iy < GRID_Y_SIZE; ++iy )
             {
-                p.seen_count_ = 0;
+                const AngleDeg angle = ( gridCenter( ix, iy ) - origin ).th();
+                if ( angle.isRightOf( left_angle )
+                     && angle.isLeftOf( right_angle ) )
+                {
+                    M_seen_tick[ix * GRID_Y_SIZE + iy] = M_tick;
+                }
             }
         }
-
     }
 
 #ifdef DEBUG_PROFILE
     dlog.addText( Logger::WORLD,
                   __FILE__" (update) PROFILE elapsed %f [ms] grid_size=%d",
                   timer.elapsedReal(),
-                  M_grid_map.size() );
+                  static_cast< int >( M_seen_tick.size() ) );
 #endif
 }
 
@@ -230,31 +283,145 @@ ViewGridMap::update( const GameTime & time,
 int
 ViewGridMap::seenCount( const Vector2D & pos ) const
 {
-    try
+    return M_tick - M_seen_tick[grid_index( pos )];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+ViewGridMap::updateAngleHistogram( const Vector2D & origin ) const
+{
+    if ( M_histogram_version == M_version
+         && M_histogram_origin.equals( origin ) )
+    {
+        return;
+    }
+
+    M_histogram_origin = origin;
+    M_histogram_version = M_version;
+
+    std::vector< long > & sum = M_angle_prefix_sum;
+    std::fill( sum.begin(), sum.end(), 0 );
+
+    // histogram is stored to sum[bin+1]
+    for ( int ix = 0; ix < GRID_X_SIZE; ++ix )
+    {
+        const int * column = &M_seen_tick[ix * GRID_Y_SIZE];
+        const double dx = ( ix * GRID_LENGTH - PITCH_MAX_X ) - origin.x;
+        for ( int iy = 0; iy < GRID_Y_SIZE; ++iy )
+        {
+            const double dy = ( iy * GRID_LENGTH - PITCH_MAX_Y ) - origin.y;
+            sum[angle_bin( AngleDeg::atan2_deg( dy, dx ) ) + 1] += M_tick - column[iy];
+        }
+    }
+
+    for ( int i = 1; i <= ANGLE_DIVS; ++i )
+    {
+        sum[i] += sum[i - 1];
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+long
+ViewGridMap::angleBinSum( const int first_bin,
+                          const int n_bins ) const
+{
+    if ( n_bins <= 0 )
+    {
+        return 0;
+    }
+
+    const std::vector< long > & sum = M_angle_prefix_sum;
+
+    if ( n_bins >= ANGLE_DIVS )
+    {
+        return sum[ANGLE_DIVS];
+    }
+
+    const int last_bin = first_bin + n_bins;
+    if ( last_bin <= ANGLE_DIVS )
+    {
+        return sum[last_bin] - sum[first_bin];
+    }
+
+    // wrap around
+    return ( sum[ANGLE_DIVS] - sum[first_bin] ) + sum[last_bin - ANGLE_DIVS];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+long
+ViewGridMap::angleSeenCountSum( const Vector2D & origin,
+                                const AngleDeg & left_angle,
+                                const double width ) const
+{
+    updateAngleHistogram( origin );
+
+    return angleBinSum( angle_bin( left_angle.degree() ),
+                        static_cast< int >( rint( width ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+AngleDeg
+ViewGridMap::bestViewAngle( const Vector2D & origin,
+                            const AngleDeg & left_start,
+                            const double scan_range,
+                            const double view_width,
+                            long * count_sum ) const
+{
+    updateAngleHistogram( origin );
+
+    const int first_bin = angle_bin( left_start.degree() );
+    const int n_bins = std::max( 1, static_cast< int >( rint( view_width ) ) );
+    const int n_candidates = std::max( 1, static_cast< int >( rint( scan_range - view_width ) ) + 1 );
+
+    int best_offset = 0;
+    long best_sum = -1;
+
+    for ( int i = 0; i < n_candidates; ++i )
     {
-        return M_grid_map.at( grid_index( pos ) ).seen_count_;
+        const long value = angleBinSum( ( first_bin + i ) % ANGLE_DIVS, n_bins );
+        if ( value > best_sum )
+        {
+            best_offset = i;
+            best_sum = value;
+        }
     }
-    catch ( std::exception & e )
+
+    if ( count_sum )
     {
-        std::cerr << __FILE__ ": out of the grid range " << pos
-                  << " " << e.what()
-                  << std::endl;
-        return 1000;
+        *count_sum = best_sum;
     }
+
+    return left_start + ( best_offset + n_bins * 0.5 );
 }
 
 /*-------------------------------------------------------------------*/
 void
 ViewGridMap::debugOutput() const
 {
-    for ( const Grid & p : M_grid_map )
+    for ( int ix = 0; ix < GRID_X_SIZE; ++ix )
     {
-        const int col = std::max( 0, 255 - p.seen_count_ * 20 );
-        dlog.addRect( Logger::WORLD,
-                      p.center_.x - GRID_LENGTH*0.05, p.center_.y - GRID_LENGTH*0.05,
-                      GRID_LENGTH*0.1, GRID_LENGTH*0.1,
-                      col, col, col,
-                      true );
+        for ( int iy = 0; iy < GRID_Y_SIZE; ++iy )
+        {
+            const Vector2D center = gridCenter( ix, iy );
+            const int col = std::max( 0, 255 - seenCount( ix, iy ) * 20 );
+            dlog.addRect( Logger::WORLD,
+                          center.x - GRID_LENGTH*0.05, center.y - GRID_LENGTH*0.05,
+                          GRID_LENGTH*0.1, GRID_LENGTH*0.1,
+                          col, col, col,
+                          true );
+        }
     }
 }
 
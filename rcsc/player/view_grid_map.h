@@ -33,39 +33,27 @@
 #define RCSC_PLAYER_VIEW_GRID_MAP_H
 
 #include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/angle_deg.h>
+#include <rcsc/game_time.h>
 
 #include <vector>
-#include <utility>
 
 namespace rcsc {
 
-class GameTime;
 class ViewArea;
 
 /*!
   \class ViewGridMap
   \brief grid map that stores field accuracy information
+
+  Each grid stores the counter value of its last observation, so the
+  count since the last observation is the difference from the current
+  counter, and incrementAll() does not touch the grids.  The view cone
+  is rasterized column by column, so that only the covered grids are
+  updated.  The seen counts can be summed by the direction from the
+  given origin using the angular histogram with prefix sums.
  */
 class ViewGridMap {
-public:
-
-    struct Grid {
-        const rcsc::Vector2D center_;
-        int seen_count_;
-
-        Grid() = delete;
-
-        explicit
-        Grid( const rcsc::Vector2D & center )
-            : center_( center ),
-              seen_count_( 0 )
-        { }
-    };
-
-private:
-
-    std::vector< Grid > M_grid_map;
-
 public:
 
     static const double GRID_LENGTH;
@@ -80,6 +68,29 @@ public:
     static const double GRID_RADIUS;
     static const double GRID_RADIUS2;
 
+    static const int ANGLE_DIVS = 360; //!< the number of angular histogram bins
+
+private:
+
+    //! the number of incrementAll() calls
+    int M_tick;
+
+    //! the counter value at the last observation of each grid. index = ix * GRID_Y_SIZE + iy
+    std::vector< int > M_seen_tick;
+
+    //! the last see time
+    GameTime M_update_time;
+
+    //! modification counter to check the histogram cache
+    int M_version;
+
+    //! the origin of the cached histogram
+    mutable Vector2D M_histogram_origin;
+    //! the modification counter of the cached histogram
+    mutable int M_histogram_version;
+    //! prefix sums of the seen counts in each direction bin. size = ANGLE_DIVS + 1
+    mutable std::vector< long > M_angle_prefix_sum;
+
 public:
 
     /*!
@@ -103,9 +114,30 @@ public:
     void update( const GameTime & time,
                  const ViewArea & view_area );
 
-    const std::vector< Grid > & gridMap() const
+    /*!
+      \brief get the center point of the grid
+      \param ix x index
+      \param iy y index
+      \return center point
+     */
+    static
+    Vector2D gridCenter( const int ix,
+                         const int iy )
     {
-        return M_grid_map;
+        return Vector2D( ix * GRID_LENGTH - PITCH_MAX_X,
+                         iy * GRID_LENGTH - PITCH_MAX_Y );
+    }
+
+    /*!
+      \brief get the count since last observation
+      \param ix x index
+      \param iy y index
+      \return count value
+     */
+    int seenCount( const int ix,
+                   const int iy ) const
+    {
+        return M_tick - M_seen_tick[ix * GRID_Y_SIZE + iy];
     }
 
     /*!
@@ -115,11 +147,64 @@ public:
      */
     int seenCount( const Vector2D & pos ) const;
 
+    /*!
+      \brief get the sum of the seen counts of the grids in the direction range
+      \param origin view point
+      \param left_angle the left end of the direction range
+      \param width the width of the direction range (degree)
+      \return sum of the seen counts
+     */
+    long angleSeenCountSum( const Vector2D & origin,
+                            const AngleDeg & left_angle,
+                            const double width ) const;
+
+    /*!
+      \brief get the view direction that covers the largest sum of the seen counts
+      \param origin view point
+      \param left_start the left end of the scan range
+      \param scan_range the width of the scan range (degree)
+      \param view_width the view width (degree)
+      \param count_sum pointer to the variable to store the sum of the seen counts. may be null.
+      \return the center direction of the best view
+     */
+    AngleDeg bestViewAngle( const Vector2D & origin,
+                            const AngleDeg & left_start,
+                            const double scan_range,
+                            const double view_width,
+                            long * count_sum = nullptr ) const;
+
     /*!
       \brief output the debug data
      */
     void debugOutput() const;
 
+private:
+
+    /*!
+      \brief set the grids in the column observed
+      \param ix x index
+      \param min_y the minimum y coordinate (exclusive)
+      \param max_y the maximum y coordinate (exclusive)
+     */
+    void setSeenColumn( const int ix,
+                        const double min_y,
+                        const double max_y );
+
+    /*!
+      \brief build the angular histogram viewed from the origin if needed
+      \param origin view point
+     */
+    void updateAngleHistogram( const Vector2D & origin ) const;
+
+    /*!
+      \brief get the sum of the histogram bins
+      \param first_bin the first bin index
+      \param n_bins the number of bins
+      \return sum of the seen counts
+     */
+    long angleBinSum( const int first_bin,
+                      const int n_bins ) const;
+
 };
 
 }
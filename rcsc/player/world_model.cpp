@@ -54,6 +54,7 @@
 #include <rcsc/soccer_math.h>
 #include <rcsc/math_util.h>
 
+#include <array>
 #include <set>
 #include <algorithm>
 #include <limits>
@@ -745,6 +746,8 @@ WorldModel::update( const ActionEffector & act,
 
     M_time = current;
 
+    M_reach_grid.invalidate();
+
     // playmode is updated in updateJustBeforeDecision
 
     // the last state is saved as the previous state
@@ -2026,6 +2029,8 @@ WorldModel::updateJustBeforeDecision( const ActionEffector & act,
 
     updateLastKicker();
 
+    M_reach_grid.invalidate();
+
     updateInterceptTable();
 
     updateOffsideLine();
@@ -2693,14 +2698,6 @@ WorldModel::estimateBallVelByPosDiff( const VisualSensor & see,
 void
 WorldModel::localizePlayers( const VisualSensor & see )
 {
-#if 0
-    PlayerObjectUpdater updater;
-    if ( ! updater.localizePlayers( M_self, see, M_localize,
-                                    M_teammates, M_opponents, M_unknown_players ) )
-    {
-        return;
-    }
-#else
     if ( ! self().faceValid()
          || ! self().posValid() )
     {
@@ -2709,37 +2706,16 @@ WorldModel::localizePlayers( const VisualSensor & see )
 
     ////////////////////////////////////////////////////////////////
     // update policy
-    //   for each (seen player objects)
-    //       if exist matched player in memory list
-    //           -> splice from memory to temporary
-    //       else
-    //           -> assign new data to temporary list
-    //   after loop, copy from temporary to memory again
-
-    // temporary data list
-    PlayerObject::List new_teammates;
-    PlayerObject::List new_opponents;
-    PlayerObject::List new_unknown_players;
+    //   localize all seen players into the fixed size buffer.
+    //   match the seen players with the players in memory at once.
+    //   matched players are updated and moved to the end of the list.
+    //   unmatched seen players are added as new players.
 
     const Vector2D MYPOS = self().pos();
     const Vector2D MYVEL = self().vel();
     const double MY_FACE = self().face().degree();
     const double MY_FACE_ERR = self().faceError();
 
-    //////////////////////////////////////////////////////////////////
-    // search order is very important !!
-    //   If we replace the unknown player to unknown teammate,
-    //   it may cause a mistake for pass target selection.
-
-    // current version search order is
-    //   [unum opp -> side opp -> unum mate -> side mate -> unknown]
-
-    // if matched, that player is removed from memory list
-    // and copy to temporary
-
-    //////////////////////////////////////////////////////////////////
-    // localize, matching and splice from memory list to temporary list
-
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
     dlog.addText( Logger::WORLD,
                   __FILE__" ========== (localizePlayers) ==========" );
@@ -2766,185 +2742,63 @@ WorldModel::localizePlayers( const VisualSensor & see )
 #endif
 #endif
 
-    //
-    // opponent (side & unum)
-    //
-    for ( const VisualSensor::PlayerT & p : see.opponents() )
-    {
-        Localization::PlayerT player;
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          "(localizePlayers) failed opponent %d",
-                          player.unum_ );
-#endif
-            continue;
-        }
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " opponent %d pos=(%.2f, %.2f) vel=(%.2f, %.2f)",
-                      player.unum_,
-                      player.pos_.x, player.pos_.y,
-                      player.vel_.x, player.vel_.y );
-#endif
-        // matching, splice or create
-        checkTeamPlayer( theirSide(),
-                         player,
-                         M_opponents,
-                         M_unknown_players,
-                         new_opponents );
-    }
-
-    //
-    // unknown opponent (no uniform number)
-    //
-    for ( const VisualSensor::PlayerT & p : see.unknownOpponents() )
-    {
-        Localization::PlayerT player;
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          "(localizePlayers) failed unknown opponent" );
-#endif
-            continue;
-        }
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " unknown opponent pos=(%.2f, %.2f)",
-                      player.pos_.x, player.pos_.y );
-#endif
-        // matching, splice or create
-        checkTeamPlayer( theirSide(),
-                         player,
-                         M_opponents,
-                         M_unknown_players,
-                         new_opponents );
-    }
-
-    //
-    // teammate (side & unum)
-    //
-    for ( const VisualSensor::PlayerT & p : see.teammates() )
-    {
-        Localization::PlayerT player;
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          __FILE__" (localizePlayers) failed teammate %d",
-                          player.unum_ );
-#endif
-            continue;
-        }
+    //////////////////////////////////////////////////////////////////
+    // localize order is
+    //   [unum opp -> side opp -> unum mate -> side mate -> unknown]
+    // the order is used to break the tie in matching.
 
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " teammate %d pos=(%.2f, %.2f) vel=(%.2f, %.2f)",
-                      player.unum_,
-                      player.pos_.x, player.pos_.y,
-                      player.vel_.x, player.vel_.y );
-#endif
-        // matching, splice or create
-        checkTeamPlayer( ourSide(),
-                         player,
-                         M_teammates,
-                         M_unknown_players,
-                         new_teammates );
-    }
+    std::array< Localization::PlayerT, MAX_SEEN_PLAYERS > seen_players;
+    int seen_size = 0;
 
-    //
-    // unknown teammate (no uniform number)
-    //
-    for ( const VisualSensor::PlayerT & p : see.unknownTeammates() )
-    {
-        Localization::PlayerT player;
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
+    const auto localize = [&]( const VisualSensor::PlayerCont & players,
+                               const SideID side )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          "(localizePlayers) failed uunknown teammate" );
-#endif
-            continue;
-        }
+            for ( const VisualSensor::PlayerT & p : players )
+            {
+                if ( seen_size >= MAX_SEEN_PLAYERS )
+                {
+                    dlog.addText( Logger::WORLD,
+                                  __FILE__" (localizePlayers) too many seen players" );
+                    return;
+                }
 
+                Localization::PlayerT & player = seen_players[seen_size];
+                player = Localization::PlayerT();
+                if ( ! M_localize->localizePlayer( *this,
+                                                   p,
+                                                   MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
+                                                   &player ) )
+                {
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " unknown teammate pos=(%.2f, %.2f)",
-                      player.pos_.x, player.pos_.y );
+                    dlog.addText( Logger::WORLD,
+                                  "(localizePlayers) failed %s %d",
+                                  side_str( side ), p.unum_ );
 #endif
-        // matching, splice or create
-        checkTeamPlayer( ourSide(),
-                         player,
-                         M_teammates,
-                         M_unknown_players,
-                         new_teammates );
-    }
+                    continue;
+                }
 
-    //
-    // unknown player
-    //
-    for ( const VisualSensor::PlayerT & p : see.unknownPlayers() )
-    {
-        Localization::PlayerT player;
-        // localize
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
-        {
+                player.side_ = side;
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          __FILE__" (localizePlayers) failed unknown player" );
+                dlog.addText( Logger::WORLD,
+                              "(localizePlayers)"
+                              " seen %s %d pos=(%.2f, %.2f) vel=(%.2f, %.2f)",
+                              side_str( side ), player.unum_,
+                              player.pos_.x, player.pos_.y,
+                              player.vel_.x, player.vel_.y );
 #endif
-            continue;
-        }
+                ++seen_size;
+            }
+        };
 
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " unknown player: pos=(%.2f, %.2f)",
-                      player.pos_.x, player.pos_.y );
-#endif
-        // matching, splice or create
-        checkUnknownPlayer( player,
-                            M_teammates,
-                            M_opponents,
-                            M_unknown_players,
-                            new_teammates,
-                            new_opponents,
-                            new_unknown_players );
-    }
+    localize( see.opponents(), theirSide() );
+    localize( see.unknownOpponents(), theirSide() );
+    localize( see.teammates(), ourSide() );
+    localize( see.unknownTeammates(), ourSide() );
+    localize( see.unknownPlayers(), NEUTRAL );
 
     //////////////////////////////////////////////////////////////////
-    // splice temporary seen players to memory list
-    // temporary lists are cleared
-    M_teammates.splice( M_teammates.end(),
-                        new_teammates );
-    M_opponents.splice( M_opponents.end(),
-                        new_opponents );
-    M_unknown_players.splice( M_unknown_players.end(),
-                              new_unknown_players );
-#endif
+    // matching, update or create
+    matchSeenPlayers( seen_players.data(), seen_size );
 
     //////////////////////////////////////////////////////////////////
     // create team member pointer vector for sort
@@ -3058,270 +2912,76 @@ WorldModel::localizePlayers( const VisualSensor & see )
     // ghost check is done in checkGhost()
 }
 
-/*-------------------------------------------------------------------*/
+namespace {
+
 /*!
+  \struct PlayerMatchingRow
+  \brief reference to the player in memory used by the seen player matching
+ */
+struct PlayerMatchingRow {
+    PlayerObject::List * list_; //!< the list that contains the player
+    PlayerObject::List::iterator player_; //!< the player in memory
+    SideID side_; //!< side of the list. NEUTRAL means the unknown player list
+    int seen_; //!< index of the matched seen player, or -1
+};
 
+/*!
+  \brief get the matching cost of the player in memory and the seen player
+  \param row player in memory
+  \param seen localized seen player
+  \param dash_noise dash noise rate
+  \param self_error self localization error
+  \return squared distance, or negative value if the pair cannot be matched
  */
-void
-WorldModel::checkTeamPlayer( const SideID side,
-                             const Localization::PlayerT & player,
-                             PlayerObject::List & old_known_players,
-                             PlayerObject::List & old_unknown_players,
-                             PlayerObject::List & new_known_players )
+double
+get_matching_cost( const PlayerMatchingRow & row,
+                   const Localization::PlayerT & seen,
+                   const double dash_noise,
+                   const double self_error )
 {
-    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
-    //  if matched player is found, that player is removed from old list
-    //  and updated data is splice to new container
-    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
-
-    //////////////////////////////////////////////////////////////////
-    // pre check
-    // unum is seen -> search the player that has the same uniform number
-    if ( player.unum_ != Unum_Unknown )
-    {
-        // search from old unum known players
-        for ( PlayerObject::List::iterator it = old_known_players.begin(), end = old_known_players.end();
-              it != end;
-              ++it )
-        {
-            if ( it->unum() == player.unum_ )
-            {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-                dlog.addText( Logger::WORLD,
-                              "(checkTeamPlayer)"
-                              " >>> matched!"
-                              " unum = %d pos =(%.1f %.1f)",
-                              player.unum_, player.pos_.x, player.pos_.y );
-#endif
-                it->updateBySee( side, player );
-                new_known_players.splice( new_known_players.end(),
-                                          old_known_players,
-                                          it );
-                return; // success!!
-            }
-        }
-    }
-
-    //////////////////////////////////////////////////////////////////
-    // find nearest player
-
-    const double dash_noise = 1.0 + ServerParam::i().playerRand();
-    const double self_error = 0.5 * 2.0;
-
-    double min_team_dist = 10.0 * 10.0;
-    double min_unknown_dist = 10.0 * 10.0;
-
-    PlayerObject::List::iterator candidate_team = old_known_players.end();
-    PlayerObject::List::iterator candidate_unknown = old_unknown_players.end();
-
-    //////////////////////////////////////////////////////////////////
-    // search from old same team players
-    for ( PlayerObject::List::iterator it = old_known_players.begin(), end = old_known_players.end();
-          it != end;
-          ++it )
-    {
-        if ( player.unum_ != Unum_Unknown
-             && it->unum() != Unum_Unknown
-             && it->unum() != player.unum_ )
-        {
-            // unum is seen
-            // and it does not match with old player's unum.
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          __FILE__" (checkTeamPlayer)"
-                          "___ known player: unum is not match."
-                          " seen unum = %d, old_unum = %d",
-                          player.unum_, it->unum() );
-#endif
-            continue;
-        }
-
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() < it->seenPosCount() )
-        {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
-        }
-
-        const double d = player.pos_.dist( old_pos );
-
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
-        {
-            // TODO: inertia movement should be considered.
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkTeamPlayer)"
-                          "___ known player: dist over."
-                          " dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
-                          player.pos_.x, player.pos_.y,
-                          it->pos().x, it->pos().y );
-#endif
-            continue;
-        }
+    const PlayerObject & p = *row.player_;
 
-        if ( d < min_team_dist )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkTeamPlayer)"
-                          "___ known player: update."
-                          " dist=%.2f < min_team_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_team_dist,
-                          player.pos_.x, player.pos_.y,
-                          it->pos().x, it->pos().y );
-#endif
-            min_team_dist = d;
-            candidate_team = it;
-        }
-    }
-
-    //////////////////////////////////////////////////////////////////
-    // search from unknown players
-    for ( PlayerObject::List::iterator it = old_unknown_players.begin(),
-              end = old_unknown_players.end();
-          it != end;
-          ++it )
+    if ( seen.side_ != NEUTRAL )
     {
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() < it->seenPosCount() )
-        {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
-        }
-
-        const double d = player.pos_.dist( old_pos );
-
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
+        if ( row.side_ != NEUTRAL
+             && row.side_ != seen.side_ )
         {
-            // TODO: inertia movement should be considered.
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkTeamPlayer)"
-                          "__ unknown player: dist over. "
-                          "dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            continue;
+            return -1.0;
         }
 
-        if ( d < min_unknown_dist )
+        if ( seen.unum_ != Unum_Unknown
+             && p.unum() != Unum_Unknown
+             && p.unum() != seen.unum_ )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkTeamPlayer)"
-                          "__ unknown player: update. "
-                          " dist=%.2f < min_unknown_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_unknown_dist,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            min_unknown_dist = d;
-            candidate_unknown = it;
+            return -1.0;
         }
     }
 
-    PlayerObject::List::iterator candidate = old_unknown_players.end();
-    PlayerObject::List * target_list = nullptr;
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-    double min_dist = 1000.0;
-#endif
-
-    if ( candidate_team != old_known_players.end()
-         && min_team_dist < min_unknown_dist )
-    {
-        candidate = candidate_team;
-        target_list = &old_known_players;
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        min_dist = min_team_dist;
-        dlog.addText( Logger::WORLD,
-                      "(checkTeamPlayer)"
-                      ">>> %d (%.1f %.1f)"
-                      " -> %s player %d %s (%.2f, %.2f) dist=%.2f",
-                      player.unum_,
-                      player.pos_.x, player.pos_.y,
-                      side_str( candidate->side() ),
-                      candidate->unum(),
-                      ( candidate->goalie() ? "goalie" : "field" ),
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
-#endif
-    }
-
-    if ( candidate_unknown != old_unknown_players.end()
-         && min_unknown_dist < min_team_dist )
+    int count = p.seenPosCount();
+    Vector2D old_pos = p.seenPos();
+    double heard_error = 0.0;
+    if ( p.heardPosCount() < p.seenPosCount() )
     {
-        candidate = candidate_unknown;
-        target_list = &old_unknown_players;
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        min_dist = min_unknown_dist;
-        dlog.addText( Logger::WORLD,
-                      "(checkTeamPlayer)"
-                      ">>> %d (%.1f %.1f)"
-                      " -> unknown player (%.2f, %.2f) dist=%.2f",
-                      player.unum_,
-                      player.pos_.x, player.pos_.y,
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
-#endif
+        count = p.heardPosCount();
+        old_pos = p.heardPos();
+        heard_error = 2.0;
     }
 
-    if ( candidate != old_unknown_players.end()
-         && target_list )
+    // TODO: inertia movement should be considered.
+    const double max_dist = std::min( 10.0 * 10.0,
+                                      p.playerTypePtr()->realSpeedMax() * dash_noise * count
+                                      + heard_error
+                                      + self_error
+                                      + seen.dist_error_ * 2.0 );
+    const double d2 = seen.pos_.dist2( old_pos );
+    if ( d2 > std::pow( max_dist, 2 ) )
     {
-        // update & splice to new list
-        candidate->updateBySee( side, player );
-
-        new_known_players.splice( new_known_players.end(),
-                                  *target_list,
-                                  candidate );
-        return;
+        return -1.0;
     }
 
-    //
-    // not found -> generate new player
-    //
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-    dlog.addText( Logger::WORLD,
-                  "(checkTeamPlayer)"
-                  " XXX unmatch. min_dist= %.2f"
-                  " generate new known player pos=(%.2f, %.2f)",
-                  min_dist,
-                  player.pos_.x, player.pos_.y );
-#endif
+    return d2;
+}
 
-    new_known_players.emplace_back( side, player );
 }
 
 /*-------------------------------------------------------------------*/
@@ -3329,308 +2989,151 @@ WorldModel::checkTeamPlayer( const SideID side,
 
  */
 void
-WorldModel::checkUnknownPlayer( const Localization::PlayerT & player,
-                                PlayerObject::List & old_teammates,
-                                PlayerObject::List & old_opponents,
-                                PlayerObject::List & old_unknown_players,
-                                PlayerObject::List & new_teammates,
-                                PlayerObject::List & new_opponents,
-                                PlayerObject::List & new_unknown_players )
+WorldModel::matchSeenPlayers( const Localization::PlayerT * seen_players,
+                              const int seen_size )
 {
-    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
-    //  if matched player is found, that player is removed from old list
-    //  and updated data is splice to new container
-    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
+    //////////////////////////////////////////////////////////////////
+    // create the rows from the players in memory
 
-    // matching start
-    // search the nearest player
+    std::array< PlayerMatchingRow, MAX_MATCHING_PLAYERS > rows;
+    int rows_size = 0;
 
-    double min_opponent_dist = 100.0;
-    double min_teammate_dist = 100.0;
-    double min_unknown_dist = 100.0;
+    const auto add_rows = [&]( PlayerObject::List & players,
+                               const SideID side )
+        {
+            for ( PlayerObject::List::iterator it = players.begin(), end = players.end();
+                  it != end && rows_size < MAX_MATCHING_PLAYERS;
+                  ++it )
+            {
+                rows[rows_size] = PlayerMatchingRow{ &players, it, side, -1 };
+                ++rows_size;
+            }
+        };
 
-    PlayerObject::List::iterator candidate_opponent = old_opponents.end();
-    PlayerObject::List::iterator candidate_teammate = old_teammates.end();
-    PlayerObject::List::iterator candidate_unknown = old_unknown_players.end();
+    add_rows( M_teammates, ourSide() );
+    add_rows( M_opponents, theirSide() );
+    add_rows( M_unknown_players, NEUTRAL );
 
-    const double dash_noise = 1.0 + ServerParam::i().playerRand();
-    const double self_error = 0.5 * 2.0;
+    std::array< int, MAX_SEEN_PLAYERS > seen_rows;
+    std::fill( seen_rows.begin(), seen_rows.end(), -1 );
 
     //////////////////////////////////////////////////////////////////
-    // search from old opponents
-    for ( PlayerObject::List::iterator it = old_opponents.begin(), end = old_opponents.end();
-          it != end;
-          ++it )
-    {
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() < it->seenPosCount() )
-        {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
-        }
-
-        const double d = player.pos_.dist( old_pos );
+    // pre check
+    // unum is seen -> the player that has the same uniform number is matched
 
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
+    for ( int c = 0; c < seen_size; ++c )
+    {
+        const Localization::PlayerT & seen = seen_players[c];
+        if ( seen.side_ == NEUTRAL
+             || seen.unum_ == Unum_Unknown )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ opp %d: dist over."
-                          " dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          it->unum(),
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
             continue;
         }
 
-        if ( d < min_opponent_dist )
+        for ( int r = 0; r < rows_size; ++r )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ opp player: update."
-                          " dist=%.2f < min_opp_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_opponent_dist,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
+            if ( rows[r].seen_ < 0
+                 && rows[r].side_ == seen.side_
+                 && rows[r].player_->unum() == seen.unum_ )
+            {
+#ifdef DEBUG_PRINT_PLAYER_UPDATE
+                dlog.addText( Logger::WORLD,
+                              "(matchSeenPlayers)"
+                              " >>> matched! %s unum = %d pos =(%.1f %.1f)",
+                              side_str( seen.side_ ), seen.unum_,
+                              seen.pos_.x, seen.pos_.y );
 #endif
-            min_opponent_dist = d;
-            candidate_opponent = it;
+                rows[r].seen_ = c;
+                seen_rows[c] = r;
+                break;
+            }
         }
     }
 
     //////////////////////////////////////////////////////////////////
-    // search from old teammates
-    for ( PlayerObject::List::iterator it = old_teammates.begin(), end = old_teammates.end();
-          it != end;
-          ++it )
-    {
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() <= it->seenPosCount() )
-        {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
-        }
+    // solve the assignment problem for the rest players.
+    // the number of the matched pairs is maximized first, and then
+    // the sum of the squared distance is minimized.
 
-        const double d = player.pos_.dist( old_pos );
+    const double dash_noise = 1.0 + ServerParam::i().playerRand();
+    const double self_error = 0.5 * 2.0;
 
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ our %d: dist over."
-                          " dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          it->unum(),
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            continue;
-        }
+    M_player_assignment.assign( rows_size, seen_size );
+    for ( int r = 0; r < rows_size; ++r )
+    {
+        if ( rows[r].seen_ >= 0 ) continue;
 
-        if ( d < min_teammate_dist )
+        for ( int c = 0; c < seen_size; ++c )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ our player: update."
-                          " dist=%.2f < min_our_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_teammate_dist,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            min_teammate_dist = d;
-            candidate_teammate = it;
+            if ( seen_rows[c] >= 0 ) continue;
+
+            const double cost = get_matching_cost( rows[r], seen_players[c],
+                                                   dash_noise, self_error );
+            if ( cost >= 0.0 )
+            {
+                M_player_assignment.setCost( r, c, cost );
+            }
         }
     }
 
-    //////////////////////////////////////////////////////////////////
-    // search from old unknown players
-    for ( PlayerObject::List::iterator it = old_unknown_players.begin(), end = old_unknown_players.end();
-          it != end;
-          ++it )
+    M_player_assignment.solve();
+
+    for ( int r = 0; r < rows_size; ++r )
     {
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() < it->seenPosCount() )
+        const int c = M_player_assignment.assignment( r );
+        if ( c >= 0 )
         {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
+            rows[r].seen_ = c;
+            seen_rows[c] = r;
         }
+    }
 
-        const double d = player.pos_.dist( old_pos );
+    //////////////////////////////////////////////////////////////////
+    // update or create.
+    // updated players are moved to the end of the list in the seen order.
 
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
+    const auto target_list = [this]( const SideID side ) -> PlayerObject::List &
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ unknown player: dist over."
-                          " dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            continue;
-        }
+            return ( side == ourSide() ? M_teammates
+                     : side == theirSide() ? M_opponents
+                     : M_unknown_players );
+        };
 
-        if ( d < min_unknown_dist )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ unknown player: update."
-                          " dist=%.2f < min_unknown_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_unknown_dist,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            min_unknown_dist = d;
-            candidate_unknown = it;
-        }
-    }
-
-    PlayerObject::List::iterator candidate = old_unknown_players.end();;
-    PlayerObject::List * new_list = nullptr;
-    PlayerObject::List * old_list = nullptr;
-    SideID side = NEUTRAL;
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-    double min_dist = 1000.0;
-#endif
-
-    if ( candidate_teammate != old_teammates.end()
-         && min_teammate_dist < min_opponent_dist
-         && min_teammate_dist < min_unknown_dist )
+    for ( int c = 0; c < seen_size; ++c )
     {
-        candidate = candidate_teammate;
-        new_list = &new_teammates;
-        old_list = &old_teammates;
-        side = ourSide();
+        const Localization::PlayerT & seen = seen_players[c];
+        const int r = seen_rows[c];
 
+        if ( r < 0 )
+        {
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
-        min_dist = min_teammate_dist;
-        dlog.addText( Logger::WORLD,
-                      "(checkUnknownPlayer)"
-                      ">>> (%.1f %.1f) -> teammate %d (%.1f %.1f) dist=%.2f",
-                      player.pos_.x, player.pos_.y,
-                      candidate->unum(),
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
+            dlog.addText( Logger::WORLD,
+                          "(matchSeenPlayers)"
+                          " XXX unmatch. generate new %s player pos=(%.2f, %.2f)",
+                          side_str( seen.side_ ),
+                          seen.pos_.x, seen.pos_.y );
 #endif
-    }
+            target_list( seen.side_ ).emplace_back( seen.side_, seen );
+            continue;
+        }
 
-    if ( candidate_opponent != old_opponents.end()
-         //&& min_opponent_dist * 0.5 - 3.0 < min_teammate_dist
-         && min_opponent_dist < min_teammate_dist
-         && min_opponent_dist < min_unknown_dist )
-    {
-        candidate = candidate_opponent;
-        new_list = &new_opponents;
-        old_list = &old_opponents;
-        side = theirSide();
+        const SideID side = ( seen.side_ != NEUTRAL
+                              ? seen.side_
+                              : rows[r].side_ );
+        PlayerObject::List & players = target_list( side );
 
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
-        min_dist = min_opponent_dist;
         dlog.addText( Logger::WORLD,
-                      "(checkUnknownPlayer)"
-                      ">>> (%.1f %.1f) -> opponent %d (%.1f %.1f) dist=%.2f",
-                      player.pos_.x, player.pos_.y,
-                      candidate->unum(),
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
+                      "(matchSeenPlayers)"
+                      ">>> %s %d (%.1f %.1f) -> %s %d (%.2f, %.2f)",
+                      side_str( seen.side_ ), seen.unum_,
+                      seen.pos_.x, seen.pos_.y,
+                      side_str( rows[r].side_ ), rows[r].player_->unum(),
+                      rows[r].player_->pos().x, rows[r].player_->pos().y );
 #endif
+        rows[r].player_->updateBySee( side, seen );
+        players.splice( players.end(), *rows[r].list_, rows[r].player_ );
     }
-
-    if ( candidate_unknown != old_unknown_players.end()
-         //&& min_unknown_dist * 0.5 - 3.0 < min_teammate_dist
-         && min_unknown_dist < min_teammate_dist
-         && min_unknown_dist < min_opponent_dist )
-    {
-        candidate = candidate_unknown;
-        new_list = &new_unknown_players;
-        old_list = &old_unknown_players;
-        side = NEUTRAL;
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-        min_dist = min_unknown_dist;
-        dlog.addText( Logger::WORLD,
-                      "(checkUnknownPlayer)"
-                      ">>> (%.1f %.1f) -> unknown (%.1f %.1f) dist=%.2f",
-                      player.pos_.x, player.pos_.y,
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
-#endif
-    }
-
-
-    //////////////////////////////////////////////////////////////////
-    // check player movable radius
-    if ( candidate != old_unknown_players.end()
-         && new_list
-         && old_list )
-    {
-        // update & splice to new list
-        candidate->updateBySee( side, player );
-        new_list->splice( new_list->end(),
-                          *old_list,
-                          candidate );
-        return;
-    }
-
-    //////////////////////////////////////////////////////////////////
-    // generate new player
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-    dlog.addText( Logger::WORLD,
-                  "(checkUnknownPlayer)"
-                  " XXX unmatch. dist_error=%f"
-                  " generate new unknown player. pos=(%.2f, %.2f)",
-                  player.dist_error_,
-                  player.pos_.x, player.pos_.y );
-#endif
-
-    new_unknown_players.emplace_back( NEUTRAL, player );
 }
 
 /*-------------------------------------------------------------------*/
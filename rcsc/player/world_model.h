@@ -37,6 +37,8 @@
 #include <rcsc/player/player_object.h>
 #include <rcsc/player/view_area.h>
 #include <rcsc/player/view_grid_map.h>
+#include <rcsc/player/reach_grid.h>
+#include <rcsc/player/assignment_solver.h>
 #include <rcsc/player/intercept_table.h>
 #include <rcsc/player/penalty_kick_state.h>
 
@@ -69,7 +71,9 @@ class WorldModel {
 public:
 
     enum {
-        DIR_CONF_DIVS = 72
+        DIR_CONF_DIVS = 72,
+        MAX_SEEN_PLAYERS = 32, //!< the size of the seen player buffer
+        MAX_MATCHING_PLAYERS = 64, //!< the max number of the players in memory for matching
     };
 
     static const double DIST_TOO_FAR; //!< long distance
@@ -198,6 +202,12 @@ private:
     //! accuracy count grid map
     ViewGridMap M_view_grid_map;
 
+    //! player reach step grid map. updated when it is required.
+    mutable ReachGrid M_reach_grid;
+
+    //! seen player matching solver. the buffer is reused.
+    AssignmentSolver M_player_assignment;
+
     //////////////////////////////////////////////////
 
     //! not used
@@ -507,36 +517,13 @@ private:
     void localizePlayers( const VisualSensor & see );
 
     /*!
-      \brief check player that has team info
-      \param side seen side info
-      \param player localized info
-      \param old_known_players old team known players
-      \param old_unknown_players previous unknown players
-      \param new_known_players new team known players
-    */
-    void checkTeamPlayer( const SideID side,
-                          const Localization::PlayerT & player,
-                          PlayerObject::List & old_known_players,
-                          PlayerObject::List & old_unknown_players,
-                          PlayerObject::List & new_known_players );
-
-    /*!
-      \brief check player that has no identifier. matching to unknown players
-      \param player localized info
-      \param old_teammates previous seen teammates
-      \param old_opponents previous seen opponents
-      \param old_unknown_players previous seen unknown player
-      \param new_teammates current seen teammates
-      \param new_opponents current seen opponents
-      \param new_unknown_players current seen unknown players
+      \brief match the seen players with the players in memory.
+      matched players are updated, and new players are created for the rest.
+      \param seen_players localized seen players
+      \param seen_size the number of seen players
     */
-    void checkUnknownPlayer( const Localization::PlayerT & player,
-                             PlayerObject::List & old_teammates,
-                             PlayerObject::List & old_opponent,
-                             PlayerObject::List & old_unknown_players,
-                             PlayerObject::List & new_teammates,
-                             PlayerObject::List & new_opponents,
-                             PlayerObject::List & new_unknown_players );
+    void matchSeenPlayers( const Localization::PlayerT * seen_players,
+                           const int seen_size );
 
     /*!
       \brief set collision effect with ball
@@ -1268,6 +1255,17 @@ public:
      */
     const ViewGridMap & viewGridMap() const { return M_view_grid_map; }
 
+    /*!
+      \brief get the grid map that holds the minimum reach step of players.
+      the grid is updated at the first call in each decision.
+      \return const reference to the ReachGrid instance
+     */
+    const ReachGrid & reachGrid() const
+      {
+          M_reach_grid.update( *this );
+          return M_reach_grid;
+      }
+
     /*!
       \brief get the specific point accuracy count
       \param point global cooridinate value of checked point
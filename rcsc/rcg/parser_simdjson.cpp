@@ -200,10 +200,9 @@ ParserSimdJSON::Impl::parseServerParam( simdjson::ondemand::value & val,
             return false;
         }
 
-        const std::string name( key.substr( 1, key.length() - 2 ) );
-        const std::string value( param.value().raw_json_token() );
+        const std::string_view value = param.value().raw_json_token();
 
-        server_param.setValue( name, value );
+        server_param.setValue( key.substr( 1, key.length() - 2 ), value );
     }
 
     return handler.handleServerParam( server_param );
@@ -227,10 +226,9 @@ ParserSimdJSON::Impl::parsePlayerParam( simdjson::ondemand::value & val,
             return false;
         }
 
-        const std::string name( key.substr( 1, key.length() - 2 ) );
-        const std::string value( param.value().raw_json_token() );
+        const std::string_view value = param.value().raw_json_token();
 
-        player_param.setValue( name, value );
+        player_param.setValue( key.substr( 1, key.length() - 2 ), value );
     }
 
     return handler.handlePlayerParam( player_param );
@@ -254,10 +252,9 @@ ParserSimdJSON::Impl::parsePlayerType( simdjson::ondemand::value & val,
             return false;
         }
 
-        const std::string name( key.substr( 1, key.length() - 2 ) );
-        const std::string value( param.value().raw_json_token() );
+        const std::string_view value = param.value().raw_json_token();
 
-        player_type.setValue( name, value );
+        player_type.setValue( key.substr( 1, key.length() - 2 ), value );
     }
 
     return handler.handlePlayerType( player_type );
@@ -36,6 +36,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <cmath>
 #include <cstdint>
 
@@ -1489,23 +1490,20 @@ struct ServerParamT {
 
     bool fromStruct( const server_params_t & data );
 
-    bool setValue( const std::string & name,
-                   const std::string & value );
+    bool setValue( std::string_view name,
+                   std::string_view value );
 
-    bool setInt( const std::string & name,
+    bool setInt( std::string_view name,
                  const int value );
-    bool setDouble( const std::string & name,
+    bool setDouble( std::string_view name,
                     const double value );
-    bool setBool( const std::string & name,
+    bool setBool( std::string_view name,
                   const bool value );
-    bool setString( const std::string & name,
-                    const std::string & value );
+    bool setString( std::string_view name,
+                    std::string_view value );
 private:
     ServerParamT( const ServerParamT & ) = delete;
     const ServerParamT & operator=( const ServerParamT & ) = delete;
-
-    struct Impl;
-    std::shared_ptr< Impl > impl_;
 };
 
 
@@ -1589,21 +1587,18 @@ struct PlayerParamT {
 
     bool fromStruct( const player_params_t & data );
 
-    bool setValue( const std::string & name,
-                   const std::string & value );
+    bool setValue( std::string_view name,
+                   std::string_view value );
 
-    bool setInt( const std::string & name,
+    bool setInt( std::string_view name,
                  const int value );
-    bool setDouble( const std::string & name,
+    bool setDouble( std::string_view name,
                     const double value );
-    bool setBool( const std::string & name,
+    bool setBool( std::string_view name,
                   const bool value );
 private:
     PlayerParamT( const PlayerParamT & ) = delete;
     const PlayerParamT& operator=( const PlayerParamT & ) = delete;
-
-    struct Impl;
-    std::shared_ptr< Impl > impl_;
 };
 
 
@@ -1682,16 +1677,12 @@ struct PlayerTypeT {
 
     bool fromStruct( const player_type_t & data );
 
-    bool setValue( const std::string & name,
-                   const std::string & value );
-    bool setInt( const std::string & name,
+    bool setValue( std::string_view name,
+                   std::string_view value );
+    bool setInt( std::string_view name,
                  const int value );
-    bool setDouble( const std::string & name,
+    bool setDouble( std::string_view name,
                     const double value );
-
-private:
-    struct Impl;
-    std::shared_ptr< Impl > impl_;
 };
 
 //! recorded value of rcg v4
@@ -0,0 +1,191 @@
+// -*-c++-*-
+
+/*!
+  \file episode_runner.cpp
+  \brief parallel runner of trainer scenarios on the local server Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "episode_runner.h"
+
+#include <rcsc/time/timer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+EpisodeRunner::EpisodeRunner( const SimScenario::Creator & creator )
+    : M_creator( creator ),
+      M_thread_count( 1 ),
+      M_max_step( 100 ),
+      M_noise( false ),
+      M_seed( 0 ),
+      M_elapsed_msec( 0.0 )
+{
+    setThreadCount( 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EpisodeRunner::setThreadCount( const int count )
+{
+    M_thread_count = count;
+    if ( M_thread_count <= 0 )
+    {
+        M_thread_count = static_cast< int >( std::thread::hardware_concurrency() );
+    }
+
+    if ( M_thread_count <= 0 )
+    {
+        M_thread_count = 1;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+EpisodeResult
+EpisodeRunner::runEpisode( const int episode,
+                           SimScenario & scenario,
+                           SimServer & server ) const
+{
+    EpisodeResult result;
+    result.episode_ = episode;
+
+    server.clear();
+    if ( M_noise )
+    {
+        server.simulator().setNoise( M_seed + static_cast< unsigned int >( episode ) );
+    }
+    else
+    {
+        server.simulator().clearNoise();
+    }
+
+    scenario.setup( episode, server );
+
+    SimCommandSet commands;
+    while ( true )
+    {
+        if ( scenario.judge( server, &result.reward_ ) )
+        {
+            result.finished_ = true;
+            break;
+        }
+
+        if ( result.step_ >= M_max_step )
+        {
+            break;
+        }
+
+        commands.fill( SimCommand() );
+        scenario.decide( server, &commands );
+        server.step( commands );
+        ++result.step_;
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+EpisodeRunner::run( const int n_episode,
+                    std::vector< EpisodeResult > * results )
+{
+    results->assign( std::max( 0, n_episode ), EpisodeResult() );
+
+    const int n_thread = std::max( 1, std::min( M_thread_count, n_episode ) );
+
+    // the creator may not be thread safe.
+    std::vector< SimScenario::Ptr > scenarios;
+    scenarios.reserve( n_thread );
+    for ( int i = 0; i < n_thread; ++i )
+    {
+        scenarios.push_back( M_creator() );
+    }
+
+    std::atomic< int > next_episode( 0 );
+
+    auto worker = [&]( SimScenario & scenario )
+        {
+            SimServer server;
+            int episode;
+            while ( ( episode = next_episode.fetch_add( 1 ) ) < n_episode )
+            {
+                (*results)[episode] = runEpisode( episode, scenario, server );
+            }
+        };
+
+    Timer timer;
+
+    if ( n_thread == 1 )
+    {
+        worker( *scenarios.front() );
+    }
+    else
+    {
+        std::vector< std::thread > threads;
+        threads.reserve( n_thread );
+        for ( int i = 0; i < n_thread; ++i )
+        {
+            threads.emplace_back( worker, std::ref( *scenarios[i] ) );
+        }
+
+        for ( std::thread & t : threads )
+        {
+            t.join();
+        }
+    }
+
+    M_elapsed_msec = timer.elapsedReal();
+
+    int n_finished = 0;
+    for ( const EpisodeResult & r : *results )
+    {
+        if ( r.finished_ ) ++n_finished;
+    }
+
+    return n_finished;
+}
+
+}
@@ -0,0 +1,236 @@
+// -*-c++-*-
+
+/*!
+  \file episode_runner.h
+  \brief parallel runner of trainer scenarios on the local server Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_SIM_EPISODE_RUNNER_H
+#define RCSC_SIM_EPISODE_RUNNER_H
+
+#include <rcsc/sim/sim_server.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace rcsc {
+
+/*!
+  \class SimScenario
+  \brief abstract training scenario. setup() and judge() play the role
+  of the trainer and decide() plays the role of the players.
+
+  Each worker thread has its own instance and uses it sequentially.
+  setup() must reset any state kept in the instance, so that the
+  result of an episode depends only on its index.
+ */
+class SimScenario {
+public:
+
+    //! pointer type
+    typedef std::shared_ptr< SimScenario > Ptr;
+
+    //! function that creates a new scenario instance
+    typedef std::function< Ptr() > Creator;
+
+protected:
+
+    /*!
+      \brief constructor is protected because this is abstract class.
+     */
+    SimScenario()
+      { }
+
+public:
+
+    /*!
+      \brief virtual destructor
+     */
+    virtual
+    ~SimScenario()
+      { }
+
+    /*!
+      \brief initialize the episode by the trainer commands. the server
+      is cleared before this method is called.
+      \param episode episode index
+      \param server reference to the server
+     */
+    virtual
+    void setup( const int episode,
+                SimServer & server ) = 0;
+
+    /*!
+      \brief decide the player commands for the next cycle
+      \param server const reference to the server
+      \param commands pointer to the commands for each player slot
+     */
+    virtual
+    void decide( const SimServer & server,
+                 SimCommandSet * commands ) = 0;
+
+    /*!
+      \brief check if the episode is finished
+      \param server const reference to the server
+      \param reward pointer to the variable to store the episode reward
+      \return true if the episode is finished
+     */
+    virtual
+    bool judge( const SimServer & server,
+                double * reward ) = 0;
+};
+
+/*!
+  \struct EpisodeResult
+  \brief result of one episode
+ */
+struct EpisodeResult {
+    int episode_; //!< episode index
+    int step_; //!< the number of simulated cycles
+    bool finished_; //!< true if judged as finished before the step limit
+    double reward_; //!< reward given by the scenario
+
+    EpisodeResult()
+        : episode_( -1 ),
+          step_( 0 ),
+          finished_( false ),
+          reward_( 0.0 )
+      { }
+};
+
+/*!
+  \class EpisodeRunner
+  \brief run many independent episodes in parallel without the real
+  server.
+
+  Each thread has its own SimServer and scenario instance. Episodes
+  are stepped immediately without waiting for the server cycle. The
+  results do not depend on the number of threads.
+ */
+class EpisodeRunner {
+private:
+
+    SimScenario::Creator M_creator; //!< scenario factory
+    int M_thread_count; //!< the number of worker threads
+    int M_max_step; //!< step limit of each episode
+
+    bool M_noise; //!< noise flag
+    unsigned int M_seed; //!< base seed of the noise
+
+    double M_elapsed_msec; //!< real time used by the last run()
+
+public:
+
+    /*!
+      \brief create a runner
+      \param creator scenario factory. called once for each thread.
+     */
+    explicit
+    EpisodeRunner( const SimScenario::Creator & creator );
+
+    /*!
+      \brief set the number of worker threads
+      \param count thread count. if count <= 0, the hardware
+      concurrency is used.
+     */
+    void setThreadCount( const int count );
+
+    /*!
+      \brief set the step limit of each episode
+      \param max_step step limit
+     */
+    void setMaxStep( const int max_step )
+      {
+          M_max_step = max_step;
+      }
+
+    /*!
+      \brief enable the simulator noise. the episode i is seeded by (seed + i).
+      \param seed base seed
+     */
+    void setNoise( const unsigned int seed )
+      {
+          M_noise = true;
+          M_seed = seed;
+      }
+
+    /*!
+      \brief get the number of worker threads
+      \return thread count
+     */
+    int threadCount() const
+      {
+          return M_thread_count;
+      }
+
+    /*!
+      \brief run episodes
+      \param n_episode the number of episodes
+      \param results container to store the result of each episode,
+      ordered by the episode index
+      \return the number of finished episodes
+     */
+    int run( const int n_episode,
+             std::vector< EpisodeResult > * results );
+
+    /*!
+      \brief get the real time used by the last run()
+      \return milliseconds
+     */
+    double elapsedMSec() const
+      {
+          return M_elapsed_msec;
+      }
+
+    /*!
+      \brief get the throughput of the last run()
+      \param n_episode the number of episodes
+      \return episodes per second
+     */
+    double episodesPerSecond( const int n_episode ) const
+      {
+          return ( M_elapsed_msec > 0.0
+                   ? n_episode * 1000.0 / M_elapsed_msec
+                   : 0.0 );
+      }
+
+    /*!
+      \brief run one episode on the given server
+      \param episode episode index
+      \param scenario reference to the scenario
+      \param server reference to the server
+      \return episode result
+     */
+    EpisodeResult runEpisode( const int episode,
+                              SimScenario & scenario,
+                              SimServer & server ) const;
+};
+
+}
+
+#endif
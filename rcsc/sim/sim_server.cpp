@@ -0,0 +1,318 @@
+// -*-c++-*-
+
+/*!
+  \file sim_server.cpp
+  \brief local stand-in of the server for trainer scenarios Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "sim_server.h"
+
+#include <rcsc/common/player_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/common/server_param.h>
+
+#include <cmath>
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SimServer::SimServer()
+    : M_simulator(),
+      M_state(),
+      M_playmode( PM_BeforeKickOff ),
+      M_score_left( 0 ),
+      M_score_right( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SimServer::clear()
+{
+    M_state.clear();
+    M_playmode = PM_BeforeKickOff;
+    M_score_left = 0;
+    M_score_right = 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SimServer::addPlayer( const SideID side,
+                      const int unum,
+                      const bool goalie,
+                      const Vector2D & pos,
+                      const AngleDeg & body )
+{
+    if ( side == NEUTRAL
+         || unum < 1 || 11 < unum
+         || findPlayer( side, unum ) )
+    {
+        return false;
+    }
+
+    // same slot as SimState::assign()
+    SimPlayer & p = M_state.players_[( side == LEFT ? 0 : 11 ) + unum - 1];
+    if ( p.isValid() )
+    {
+        return false;
+    }
+
+    p = SimPlayer();
+    p.side_ = side;
+    p.unum_ = unum;
+    p.goalie_ = goalie;
+    p.type_ = &PlayerTypeSet::i().defaultType();
+    p.pos_ = pos;
+    p.body_ = body;
+    p.stamina_.init( *p.type_ );
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SimServer::doKickOff()
+{
+    if ( M_playmode != PM_BeforeKickOff )
+    {
+        return false;
+    }
+
+    M_playmode = PM_PlayOn;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SimServer::doMoveBall( const Vector2D & pos,
+                       const Vector2D & vel )
+{
+    M_state.ball_.pos_ = pos;
+    M_state.ball_.vel_ = vel;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SimServer::doMovePlayer( const SideID side,
+                         const int unum,
+                         const Vector2D & pos,
+                         const AngleDeg & angle )
+{
+    return doMovePlayer( side, unum, pos, angle, Vector2D( 0.0, 0.0 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SimServer::doMovePlayer( const SideID side,
+                         const int unum,
+                         const Vector2D & pos,
+                         const AngleDeg & angle,
+                         const Vector2D & vel )
+{
+    SimPlayer * p = findPlayer( side, unum );
+    if ( ! p )
+    {
+        return false;
+    }
+
+    p->pos_ = pos;
+    p->body_ = angle;
+    p->vel_ = vel;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SimServer::doRecover()
+{
+    for ( SimPlayer & p : M_state.players_ )
+    {
+        if ( ! p.isValid() ) continue;
+
+        p.stamina_.init( *p.type_ );
+        p.tackle_cycles_ = 0;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SimServer::doChangeMode( const PlayMode mode )
+{
+    if ( mode <= PM_Null
+         || PM_MAX <= mode )
+    {
+        return false;
+    }
+
+    M_playmode = mode;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SimServer::doChangePlayerType( const SideID side,
+                               const int unum,
+                               const int type )
+{
+    SimPlayer * p = findPlayer( side, unum );
+    const PlayerType * ptype = ( 0 <= type && type < PlayerParam::i().playerTypes()
+                                 ? PlayerTypeSet::i().get( type )
+                                 : nullptr );
+    if ( ! p
+         || ! ptype )
+    {
+        return false;
+    }
+
+    p->type_ = ptype;
+    p->stamina_.init( *ptype );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SimServer::step( const SimCommandSet & commands )
+{
+    if ( M_playmode == PM_PlayOn )
+    {
+        M_simulator.step( &M_state, commands );
+        referee();
+    }
+    else
+    {
+        M_simulator.step( &M_state );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SimServer::step()
+{
+    M_simulator.step( &M_state );
+
+    if ( M_playmode == PM_PlayOn )
+    {
+        referee();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SimPlayer *
+SimServer::findPlayer( const SideID side,
+                       const int unum )
+{
+    for ( SimPlayer & p : M_state.players_ )
+    {
+        if ( p.isValid()
+             && p.side_ == side
+             && p.unum_ == unum )
+        {
+            return &p;
+        }
+    }
+
+    return nullptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SimServer::referee()
+{
+    const ServerParam & SP = ServerParam::i();
+    const Vector2D & ball = M_state.ball_.pos_;
+
+    if ( std::fabs( ball.y ) > SP.goalHalfWidth()
+         || std::fabs( ball.x ) <= SP.pitchHalfLength() + SP.ballSize() )
+    {
+        return;
+    }
+
+    if ( ball.x > 0.0 )
+    {
+        ++M_score_left;
+        M_playmode = PM_AfterGoal_Left;
+    }
+    else
+    {
+        ++M_score_right;
+        M_playmode = PM_AfterGoal_Right;
+    }
+
+    M_state.ball_.vel_.assign( 0.0, 0.0 );
+}
+
+}
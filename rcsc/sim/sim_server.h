@@ -0,0 +1,240 @@
+// -*-c++-*-
+
+/*!
+  \file sim_server.h
+  \brief local stand-in of the server for trainer scenarios Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_SIM_SIM_SERVER_H
+#define RCSC_SIM_SIM_SERVER_H
+
+#include <rcsc/sim/simulator.h>
+#include <rcsc/sim/sim_state.h>
+#include <rcsc/types.h>
+
+namespace rcsc {
+
+/*!
+  \class SimServer
+  \brief local deterministic stand-in of rcssserver for trainer scenarios.
+
+  The trainer commands of TrainerAgent are applied to the state
+  directly and the cycle advances as soon as step() is called, like
+  the synch_mode of the server.  The dynamics are given by Simulator.
+  The referee only detects goals in play_on mode.  Players are
+  identified by their side instead of the team name.
+ */
+class SimServer {
+private:
+
+    Simulator M_simulator; //!< dynamics
+    SimState M_state; //!< current state
+    PlayMode M_playmode; //!< current playmode
+    int M_score_left; //!< left team score
+    int M_score_right; //!< right team score
+
+public:
+
+    /*!
+      \brief create an empty field
+     */
+    SimServer();
+
+    /*!
+      \brief remove all players and reset the ball, the cycle, the
+      playmode and the scores. the noise setting is not changed.
+     */
+    void clear();
+
+    /*!
+      \brief get the simulator
+      \return reference to the simulator
+     */
+    Simulator & simulator()
+      {
+          return M_simulator;
+      }
+
+    /*!
+      \brief get the current state
+      \return const reference to the state
+     */
+    const SimState & state() const
+      {
+          return M_state;
+      }
+
+    /*!
+      \brief get the current cycle
+      \return cycle value
+     */
+    long cycle() const
+      {
+          return M_state.cycle_;
+      }
+
+    /*!
+      \brief get the current playmode
+      \return playmode Id
+     */
+    PlayMode playMode() const
+      {
+          return M_playmode;
+      }
+
+    /*!
+      \brief get the left team score
+      \return score value
+     */
+    int scoreLeft() const
+      {
+          return M_score_left;
+      }
+
+    /*!
+      \brief get the right team score
+      \return score value
+     */
+    int scoreRight() const
+      {
+          return M_score_right;
+      }
+
+    /*!
+      \brief replace the current state. the playmode is not changed.
+      \param state new state
+     */
+    void assign( const SimState & state )
+      {
+          M_state = state;
+      }
+
+    /*!
+      \brief connect a new player to the empty slot
+      \param side team side
+      \param unum uniform number (1-11)
+      \param goalie goalie flag
+      \param pos initial position
+      \param body initial body angle
+      \return true if the player is added
+     */
+    bool addPlayer( const SideID side,
+                    const int unum,
+                    const bool goalie,
+                    const Vector2D & pos,
+                    const AngleDeg & body );
+
+    /*!
+      \brief start the game, same as the start command
+      \return true if the playmode is changed
+     */
+    bool doKickOff();
+
+    /*!
+      \brief move the ball
+      \param pos new position
+      \param vel new velocity
+      \return always true
+     */
+    bool doMoveBall( const Vector2D & pos,
+                     const Vector2D & vel );
+
+    /*!
+      \brief move the player. the velocity is reset to zero.
+      \param side target player's side
+      \param unum target player's uniform number
+      \param pos new position
+      \param angle new body angle
+      \return true if the player is found
+     */
+    bool doMovePlayer( const SideID side,
+                       const int unum,
+                       const Vector2D & pos,
+                       const AngleDeg & angle );
+
+    /*!
+      \brief move the player
+      \param side target player's side
+      \param unum target player's uniform number
+      \param pos new position
+      \param angle new body angle
+      \param vel player's velocity after move
+      \return true if the player is found
+     */
+    bool doMovePlayer( const SideID side,
+                       const int unum,
+                       const Vector2D & pos,
+                       const AngleDeg & angle,
+                       const Vector2D & vel );
+
+    /*!
+      \brief recover the stamina of all players
+      \return always true
+     */
+    bool doRecover();
+
+    /*!
+      \brief change the playmode
+      \param mode new playmode Id
+      \return true if the mode is valid
+     */
+    bool doChangeMode( const PlayMode mode );
+
+    /*!
+      \brief change the player type
+      \param side target player's side
+      \param unum target player's uniform number
+      \param type new player type Id
+      \return true if the player and the type are found
+     */
+    bool doChangePlayerType( const SideID side,
+                             const int unum,
+                             const int type );
+
+    /*!
+      \brief advance one cycle immediately. the commands are ignored if
+      the playmode is not play_on.
+      \param commands commands for each player slot
+     */
+    void step( const SimCommandSet & commands );
+
+    /*!
+      \brief advance one cycle without any command
+     */
+    void step();
+
+private:
+
+    SimPlayer * findPlayer( const SideID side,
+                            const int unum );
+
+    void referee();
+};
+
+}
+
+#endif
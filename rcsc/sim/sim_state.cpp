@@ -0,0 +1,237 @@
+// -*-c++-*-
+
+/*!
+  \file sim_state.cpp
+  \brief world state used by the forward simulator Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "sim_state.h"
+
+#include <rcsc/player/world_model.h>
+#include <rcsc/common/player_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/rcg/types.h>
+
+namespace rcsc {
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief set the player data estimated by the world model
+ */
+void
+assign_player( const WorldModel & wm,
+               const AbstractPlayerObject & p,
+               SimPlayer * result )
+{
+    result->side_ = p.side();
+    result->unum_ = p.unum();
+    result->goalie_ = p.goalie();
+    result->type_ = ( p.playerTypePtr()
+                      ? p.playerTypePtr()
+                      : &PlayerTypeSet::i().defaultType() );
+    result->pos_ = p.pos();
+    result->vel_ = p.vel();
+    result->body_ = p.body();
+
+    if ( p.isSelf() )
+    {
+        result->stamina_ = wm.self().staminaModel();
+        result->tackle_cycles_ = wm.self().tackleExpires();
+    }
+    else
+    {
+        result->stamina_.init( *result->type_ );
+        result->tackle_cycles_ = ( p.isTackling() ? 1 : 0 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief set the players of one team. the players whose uniform number
+  is unknown are stored in the remaining slots.
+ */
+void
+assign_team( const WorldModel & wm,
+             const AbstractPlayerObject::Cont & players,
+             SimPlayer * slots )
+{
+    for ( const AbstractPlayerObject * p : players )
+    {
+        if ( 1 <= p->unum() && p->unum() <= 11
+             && ! slots[p->unum() - 1].isValid() )
+        {
+            assign_player( wm, *p, &slots[p->unum() - 1] );
+        }
+    }
+
+    int index = 0;
+    for ( const AbstractPlayerObject * p : players )
+    {
+        if ( 1 <= p->unum() && p->unum() <= 11
+             && slots[p->unum() - 1].side_ == p->side()
+             && slots[p->unum() - 1].unum_ == p->unum() )
+        {
+            continue;
+        }
+
+        while ( index < 11 && slots[index].isValid() )
+        {
+            ++index;
+        }
+
+        if ( index >= 11 )
+        {
+            break;
+        }
+
+        assign_player( wm, *p, &slots[index] );
+    }
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SimState::clear()
+{
+    cycle_ = 0;
+    ball_ = SimBall();
+    for ( SimPlayer & p : players_ )
+    {
+        p = SimPlayer();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SimState::assign( const WorldModel & wm )
+{
+    clear();
+
+    cycle_ = wm.time().cycle();
+
+    if ( wm.ball().posValid() )
+    {
+        ball_.pos_ = wm.ball().pos();
+    }
+
+    if ( wm.ball().velValid() )
+    {
+        ball_.vel_ = wm.ball().vel();
+    }
+
+    assign_team( wm, wm.ourPlayers(), players_ );
+    assign_team( wm, wm.theirPlayers(), players_ + 11 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SimState::assign( const rcg::ShowInfoT & show )
+{
+    clear();
+
+    cycle_ = static_cast< long >( show.time_ );
+
+    ball_.pos_.assign( show.ball_.x_, show.ball_.y_ );
+    ball_.vel_.assign( show.ball_.vx_, show.ball_.vy_ );
+
+    for ( int i = 0; i < MAX_PLAYER; ++i )
+    {
+        const rcg::PlayerT & from = show.player_[i];
+        SimPlayer & p = players_[i];
+
+        if ( ! from.isAlive() )
+        {
+            continue;
+        }
+
+        const PlayerType * ptype = ( 0 <= from.type_ && from.type_ < PlayerParam::i().playerTypes()
+                                     ? PlayerTypeSet::i().get( from.type_ )
+                                     : nullptr );
+
+        p.side_ = from.side();
+        p.unum_ = from.unum_;
+        p.goalie_ = from.isGoalie();
+        p.type_ = ( ptype ? ptype : &PlayerTypeSet::i().defaultType() );
+        p.pos_.assign( from.x_, from.y_ );
+        p.vel_.assign( from.vx_, from.vy_ );
+        p.body_ = from.body_;
+
+        p.stamina_.init( *p.type_ );
+        if ( from.hasStamina() )
+        {
+            p.stamina_.setValues( from.stamina_,
+                                  from.effort_,
+                                  from.recovery_,
+                                  ( from.hasStaminaCapacity()
+                                    ? from.stamina_capacity_
+                                    : ServerParam::i().staminaCapacity() ) );
+        }
+
+        // the remaining frozen cycles cannot be known from the log.
+        p.tackle_cycles_ = ( from.isTackling() ? 1 : 0 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const SimPlayer *
+SimState::player( const SideID side,
+                  const int unum ) const
+{
+    for ( const SimPlayer & p : players_ )
+    {
+        if ( p.isValid()
+             && p.side_ == side
+             && p.unum_ == unum )
+        {
+            return &p;
+        }
+    }
+
+    return nullptr;
+}
+
+}
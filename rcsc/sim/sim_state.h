@@ -0,0 +1,153 @@
+// -*-c++-*-
+
+/*!
+  \file sim_state.h
+  \brief world state used by the forward simulator Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_SIM_SIM_STATE_H
+#define RCSC_SIM_SIM_STATE_H
+
+#include <rcsc/common/stamina_model.h>
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/angle_deg.h>
+#include <rcsc/types.h>
+
+namespace rcsc {
+
+class PlayerType;
+class WorldModel;
+
+namespace rcg {
+struct ShowInfoT;
+}
+
+/*!
+  \struct SimBall
+  \brief ball state in the forward simulator
+ */
+struct SimBall {
+    Vector2D pos_; //!< global position
+    Vector2D vel_; //!< velocity
+
+    SimBall()
+        : pos_( 0.0, 0.0 ),
+          vel_( 0.0, 0.0 )
+      { }
+};
+
+/*!
+  \struct SimPlayer
+  \brief player state in the forward simulator
+ */
+struct SimPlayer {
+    SideID side_; //!< team side
+    int unum_; //!< uniform number
+    bool goalie_; //!< goalie flag
+    const PlayerType * type_; //!< player type. NULL means an unused slot.
+
+    Vector2D pos_; //!< global position
+    Vector2D vel_; //!< velocity
+    AngleDeg body_; //!< global body angle
+
+    StaminaModel stamina_; //!< stamina, effort, recovery and capacity
+
+    int tackle_cycles_; //!< the number of remaining frozen cycles after tackle
+
+    SimPlayer()
+        : side_( NEUTRAL ),
+          unum_( Unum_Unknown ),
+          goalie_( false ),
+          type_( nullptr ),
+          pos_( 0.0, 0.0 ),
+          vel_( 0.0, 0.0 ),
+          body_( 0.0 ),
+          tackle_cycles_( 0 )
+      { }
+
+    /*!
+      \brief check if this slot is used
+      \return checked result
+     */
+    bool isValid() const
+      {
+          return type_ != nullptr;
+      }
+};
+
+/*!
+  \struct SimState
+  \brief snapshot of the ball and all players.
+
+  players_[0-10] are the left (or our) players and players_[11-21] are
+  the right (or their) players.  Each player is stored at the index of
+  its uniform number if it is known.
+ */
+struct SimState {
+
+    static const int MAX_PLAYER = 22; //!< the number of player slots
+
+    long cycle_; //!< simulated cycle
+    SimBall ball_; //!< ball state
+    SimPlayer players_[MAX_PLAYER]; //!< player states
+
+    SimState()
+        : cycle_( 0 )
+      { }
+
+    /*!
+      \brief remove all players and reset the ball
+     */
+    void clear();
+
+    /*!
+      \brief set the state estimated by the player's world model.
+      our players are stored in players_[0-10] and the coordinates are
+      the same as the world model.
+      \param wm const reference to the world model
+     */
+    void assign( const WorldModel & wm );
+
+    /*!
+      \brief set the state recorded in the game log.
+      \param show one cycle display data
+     */
+    void assign( const rcg::ShowInfoT & show );
+
+    /*!
+      \brief get the player slot
+      \param side team side
+      \param unum uniform number (1-11)
+      \return const pointer to the player. if not found, NULL is returned.
+     */
+    const SimPlayer * player( const SideID side,
+                              const int unum ) const;
+};
+
+}
+
+#endif
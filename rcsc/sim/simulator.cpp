@@ -0,0 +1,543 @@
+// -*-c++-*-
+
+/*!
+  \file simulator.cpp
+  \brief forward simulator of the player and ball dynamics Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "simulator.h"
+
+#include <rcsc/common/player_type.h>
+#include <rcsc/common/server_param.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Simulator::Simulator()
+    : M_noise( false ),
+      M_engine(),
+      M_ball_accel( 0.0, 0.0 ),
+      M_step_count( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::setNoise( const unsigned int seed )
+{
+    M_noise = true;
+    M_engine.seed( seed );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::step( SimState * state,
+                 const SimCommandSet & commands )
+{
+    executeCommands( state, commands );
+    move( state );
+    collide( state );
+
+    for ( SimPlayer & p : state->players_ )
+    {
+        if ( ! p.isValid() ) continue;
+
+        p.stamina_.simulateWait( *p.type_ );
+        if ( p.tackle_cycles_ > 0 )
+        {
+            --p.tackle_cycles_;
+        }
+    }
+
+    ++state->cycle_;
+    ++M_step_count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::step( SimState * state )
+{
+    static const SimCommandSet s_no_commands = SimCommandSet();
+
+    step( state, s_no_commands );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::run( SimState * state,
+                const int n_step )
+{
+    for ( int i = 0; i < n_step; ++i )
+    {
+        step( state );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::run( SimState * state,
+                const Policy & policy,
+                const int n_step )
+{
+    SimCommandSet commands;
+
+    for ( int i = 0; i < n_step; ++i )
+    {
+        commands.fill( SimCommand() );
+        policy( *state, &commands );
+        step( state, commands );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+Simulator::runBatch( const SimState & initial,
+                     const std::vector< SimCommandSet > & first_commands,
+                     const int n_step,
+                     std::vector< SimState > * results )
+{
+    results->resize( first_commands.size() );
+
+    for ( std::size_t i = 0; i < first_commands.size(); ++i )
+    {
+        SimState & state = (*results)[i];
+        state = initial;
+
+        if ( n_step <= 0 ) continue;
+
+        step( &state, first_commands[i] );
+        run( &state, n_step - 1 );
+    }
+
+    return results->size();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+Simulator::runBatch( const SimState & initial,
+                     const std::vector< Policy > & policies,
+                     const int n_step,
+                     std::vector< SimState > * results )
+{
+    results->resize( policies.size() );
+
+    for ( std::size_t i = 0; i < policies.size(); ++i )
+    {
+        SimState & state = (*results)[i];
+        state = initial;
+        run( &state, policies[i], n_step );
+    }
+
+    return results->size();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+Simulator::tackle_probability( const SimPlayer & player,
+                               const Vector2D & ball_pos )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    const Vector2D player2ball = ( ball_pos - player.pos_ ).rotatedVector( -player.body_ );
+
+    const double tackle_dist = ( player2ball.x > 0.0
+                                 ? SP.tackleDist()
+                                 : SP.tackleBackDist() );
+    if ( tackle_dist < 1.0e-5 )
+    {
+        return 0.0;
+    }
+
+    const double fail_prob = ( std::pow( player2ball.absX() / tackle_dist,
+                                         SP.tackleExponent() )
+                               + std::pow( player2ball.absY() / SP.tackleWidth(),
+                                           SP.tackleExponent() ) );
+
+    return std::max( 0.0, 1.0 - fail_prob );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::executeCommands( SimState * state,
+                            const SimCommandSet & commands )
+{
+    M_ball_accel.assign( 0.0, 0.0 );
+
+    for ( int i = 0; i < SimState::MAX_PLAYER; ++i )
+    {
+        M_player_accel[i].assign( 0.0, 0.0 );
+
+        SimPlayer & p = state->players_[i];
+        if ( ! p.isValid() ) continue;
+
+        // the player is frozen by the tackle
+        if ( p.tackle_cycles_ > 0 ) continue;
+
+        const SimCommand & command = commands[i];
+        switch ( command.type_ ) {
+        case SimCommand::DASH:
+            dash( i, p, command );
+            break;
+        case SimCommand::TURN:
+            turn( p, command );
+            break;
+        case SimCommand::KICK:
+            kick( p, state->ball_, command );
+            break;
+        case SimCommand::TACKLE:
+            tackle( p, state->ball_, command );
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::turn( SimPlayer & player,
+                 const SimCommand & command )
+{
+    double moment = ServerParam::i().normalizeMoment( command.power_ );
+    if ( M_noise )
+    {
+        moment *= 1.0 + uniform( -ServerParam::i().playerRand(), ServerParam::i().playerRand() );
+    }
+
+    player.body_ += player.type_->effectiveTurn( moment, player.vel_.r() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::dash( const int index,
+                 SimPlayer & player,
+                 const SimCommand & command )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    const double dir = SP.discretizeDashAngle( command.dir_ );
+    double power = SP.normalizeDashPower( command.power_ );
+    const bool back_dash = ( power < 0.0 );
+
+    // the available stamina limits the dash power
+    const double available = player.stamina_.stamina() + player.type_->extraStamina();
+    const double required = ( back_dash ? power * -2.0 : power );
+    if ( required > available )
+    {
+        power = ( back_dash ? available * -0.5 : available );
+    }
+
+    player.stamina_.setStamina( std::max( 0.0,
+                                          player.stamina_.stamina()
+                                          - ( back_dash ? power * -2.0 : power ) ) );
+
+    AngleDeg accel_angle = player.body_ + dir;
+    if ( back_dash )
+    {
+        accel_angle += 180.0;
+    }
+
+    const double accel_mag = ( std::fabs( power )
+                               * player.type_->dashRate( player.stamina_.effort() )
+                               * SP.dashDirRate( dir ) );
+
+    M_player_accel[index] += Vector2D::polar2vector( accel_mag, accel_angle );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::kick( const SimPlayer & player,
+                 const SimBall & ball,
+                 const SimCommand & command )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    const Vector2D rel = ball.pos_ - player.pos_;
+    const double ball_dist = rel.r();
+
+    if ( ball_dist > player.type_->kickableArea() )
+    {
+        return;
+    }
+
+    const double power = SP.normalizePower( command.power_ );
+    const AngleDeg dir = command.dir_;
+    const double dir_diff = ( rel.th() - player.body_ ).abs();
+    const double kick_rate = player.type_->kickRate( ball_dist, dir_diff );
+
+    Vector2D accel = Vector2D::polar2vector( power * kick_rate, player.body_ + dir );
+
+    if ( M_noise
+         && SP.maxPower() > 0.0 )
+    {
+        const double pos_rate
+            = 0.5 + 0.25 * ( dir_diff / 180.0
+                             + ( ball_dist - player.type_->playerSize() - SP.ballSize() )
+                             / player.type_->kickableMargin() );
+        accel += noise( player.type_->kickRand() * ( power / SP.maxPower() ) * pos_rate );
+    }
+
+    M_ball_accel += accel;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::tackle( SimPlayer & player,
+                   const SimBall & ball,
+                   const SimCommand & command )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    player.tackle_cycles_ = SP.tackleCycles();
+
+    const double prob = tackle_probability( player, ball.pos_ );
+    if ( M_noise
+         ? uniform( 0.0, 1.0 ) >= prob
+         : prob < 0.5 )
+    {
+        return;
+    }
+
+    const double dir = AngleDeg::normalize_angle( command.dir_ );
+
+    double eff_power = ( SP.maxBackTacklePower()
+                         + ( SP.maxTacklePower() - SP.maxBackTacklePower() )
+                         * ( 1.0 - std::fabs( dir ) / 180.0 ) );
+    eff_power *= SP.tacklePowerRate();
+
+    const AngleDeg ball_angle = ( ball.pos_ - player.pos_ ).th();
+    eff_power *= 1.0 - 0.5 * ( ( ball_angle - player.body_ ).abs() / 180.0 );
+
+    M_ball_accel += Vector2D::polar2vector( eff_power, player.body_ + dir );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Simulator::move( SimState * state )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    //
+    // ball
+    //
+    {
+        SimBall & ball = state->ball_;
+
+        if ( M_ball_accel.r2() > std::pow( SP.ballAccelMax(), 2 ) )
+        {
+            M_ball_accel.setLength( SP.ballAccelMax() );
+        }
+
+        ball.vel_ += M_ball_accel;
+        if ( M_noise )
+        {
+            ball.vel_ += noise( ball.vel_.r() * SP.ballRand() );
+        }
+
+        if ( ball.vel_.r2() > std::pow( SP.ballSpeedMax(), 2 ) )
+        {
+            ball.vel_.setLength( SP.ballSpeedMax() );
+        }
+
+        ball.pos_ += ball.vel_;
+        ball.vel_ *= SP.ballDecay();
+    }
+
+    //
+    // players
+    //
+    for ( int i = 0; i < SimState::MAX_PLAYER; ++i )
+    {
+        SimPlayer & p = state->players_[i];
+        if ( ! p.isValid() ) continue;
+
+        Vector2D & accel = M_player_accel[i];
+        if ( accel.r2() > std::pow( SP.playerAccelMax(), 2 ) )
+        {
+            accel.setLength( SP.playerAccelMax() );
+        }
+
+        p.vel_ += accel;
+        if ( M_noise )
+        {
+            p.vel_ += noise( p.vel_.r() * SP.playerRand() );
+        }
+
+        if ( p.vel_.r2() > std::pow( p.type_->playerSpeedMax(), 2 ) )
+        {
+            p.vel_.setLength( p.type_->playerSpeedMax() );
+        }
+
+        p.pos_ += p.vel_;
+        p.vel_ *= p.type_->playerDecay();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  Overlapped objects are pushed apart along the line connecting their
+  centers, and their velocities are multiplied by -0.1.
+ */
+void
+Simulator::collide( SimState * state )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    SimBall & ball = state->ball_;
+
+    for ( int i = 0; i < SimState::MAX_PLAYER; ++i )
+    {
+        SimPlayer & p = state->players_[i];
+        if ( ! p.isValid() ) continue;
+
+        //
+        // player and ball
+        //
+        {
+            const double min_dist = p.type_->playerSize() + SP.ballSize();
+            Vector2D rel = ball.pos_ - p.pos_;
+            if ( rel.r2() < min_dist * min_dist )
+            {
+                if ( rel.r2() < 1.0e-10 )
+                {
+                    rel = Vector2D::polar2vector( 1.0, p.body_ );
+                }
+                ball.pos_ = p.pos_ + rel.setLengthVector( min_dist );
+                ball.vel_ *= -0.1;
+                p.vel_ *= -0.1;
+            }
+        }
+
+        //
+        // player and player
+        //
+        for ( int j = i + 1; j < SimState::MAX_PLAYER; ++j )
+        {
+            SimPlayer & o = state->players_[j];
+            if ( ! o.isValid() ) continue;
+
+            const double min_dist = p.type_->playerSize() + o.type_->playerSize();
+            Vector2D rel = o.pos_ - p.pos_;
+            const double d2 = rel.r2();
+            if ( d2 >= min_dist * min_dist ) continue;
+
+            const double d = std::sqrt( d2 );
+            if ( d < 1.0e-10 )
+            {
+                rel = Vector2D::polar2vector( 1.0, p.body_ );
+            }
+
+            const Vector2D push = rel.setLengthVector( ( min_dist - d ) * 0.5 );
+            p.pos_ -= push;
+            o.pos_ += push;
+            p.vel_ *= -0.1;
+            o.vel_ *= -0.1;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Vector2D
+Simulator::noise( const double max_rand )
+{
+    return Vector2D( uniform( -max_rand, max_rand ),
+                     uniform( -max_rand, max_rand ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+Simulator::uniform( const double min,
+                    const double max )
+{
+    if ( max - min < 1.0e-10 )
+    {
+        return min;
+    }
+
+    return std::uniform_real_distribution< double >( min, max )( M_engine );
+}
+
+}
@@ -0,0 +1,272 @@
+// -*-c++-*-
+
+/*!
+  \file simulator.h
+  \brief forward simulator of the player and ball dynamics Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_SIM_SIMULATOR_H
+#define RCSC_SIM_SIMULATOR_H
+
+#include <rcsc/sim/sim_state.h>
+
+#include <functional>
+#include <random>
+#include <vector>
+#include <array>
+
+namespace rcsc {
+
+/*!
+  \struct SimCommand
+  \brief body command given to a simulated player
+ */
+struct SimCommand {
+
+    /*!
+      \enum Type
+      \brief command type
+     */
+    enum Type {
+        NONE, //!< no command
+        DASH, //!< dash (power, dir)
+        TURN, //!< turn (moment)
+        KICK, //!< kick (power, dir)
+        TACKLE, //!< tackle (dir)
+    };
+
+    Type type_; //!< command type
+    double power_; //!< dash/kick power or turn moment
+    double dir_; //!< dash/kick/tackle direction relative to the body angle
+
+    SimCommand()
+        : type_( NONE ),
+          power_( 0.0 ),
+          dir_( 0.0 )
+      { }
+
+    SimCommand( const Type type,
+                const double power,
+                const double dir )
+        : type_( type ),
+          power_( power ),
+          dir_( dir )
+      { }
+
+    static SimCommand dash( const double power,
+                            const double dir = 0.0 )
+      {
+          return SimCommand( DASH, power, dir );
+      }
+
+    static SimCommand turn( const double moment )
+      {
+          return SimCommand( TURN, moment, 0.0 );
+      }
+
+    static SimCommand kick( const double power,
+                            const double dir )
+      {
+          return SimCommand( KICK, power, dir );
+      }
+
+    static SimCommand tackle( const double dir )
+      {
+          return SimCommand( TACKLE, 0.0, dir );
+      }
+};
+
+//! commands for all player slots. the index is same as SimState::players_.
+typedef std::array< SimCommand, SimState::MAX_PLAYER > SimCommandSet;
+
+/*!
+  \class Simulator
+  \brief forward simulator of rcssserver's player and ball dynamics.
+
+  One step consists of the command execution (turn, dash, kick and
+  tackle), the movement of all objects, the collision resolution and
+  the stamina update, in the same order as the server.  All values are
+  taken from ServerParam and PlayerType.  By default no noise is added,
+  so that the same input always gives the same result.  Seeded noise
+  can be enabled for Monte Carlo rollouts.
+
+  Not simulated: catch, move, referee actions and the game mode
+  transitions.
+ */
+class Simulator {
+public:
+
+    //! policy function that decides the commands for the next step
+    typedef std::function< void( const SimState &, SimCommandSet * ) > Policy;
+
+private:
+
+    bool M_noise; //!< noise flag
+    std::mt19937 M_engine; //!< random engine used if noise is enabled
+
+    Vector2D M_ball_accel; //!< work area for the accumulated ball acceleration
+    Vector2D M_player_accel[SimState::MAX_PLAYER]; //!< work area for the player accelerations
+
+    long M_step_count; //!< total number of simulated steps
+
+public:
+
+    /*!
+      \brief create a simulator without noise
+     */
+    Simulator();
+
+    /*!
+      \brief enable the seeded noise
+      \param seed random seed
+     */
+    void setNoise( const unsigned int seed );
+
+    /*!
+      \brief disable the noise
+     */
+    void clearNoise()
+      {
+          M_noise = false;
+      }
+
+    /*!
+      \brief check if the noise is enabled
+      \return checked result
+     */
+    bool hasNoise() const
+      {
+          return M_noise;
+      }
+
+    /*!
+      \brief get the total number of simulated steps
+      \return the number of steps
+     */
+    long stepCount() const
+      {
+          return M_step_count;
+      }
+
+    /*!
+      \brief advance the state one cycle
+      \param state pointer to the state to be updated
+      \param commands commands for each player slot
+     */
+    void step( SimState * state,
+               const SimCommandSet & commands );
+
+    /*!
+      \brief advance the state one cycle without any command
+      \param state pointer to the state to be updated
+     */
+    void step( SimState * state );
+
+    /*!
+      \brief advance the state n cycles without any command
+      \param state pointer to the state to be updated
+      \param n_step the number of cycles
+     */
+    void run( SimState * state,
+              const int n_step );
+
+    /*!
+      \brief advance the state n cycles with the commands given by the policy
+      \param state pointer to the state to be updated
+      \param policy command generator called before each step
+      \param n_step the number of cycles
+     */
+    void run( SimState * state,
+              const Policy & policy,
+              const int n_step );
+
+    /*!
+      \brief simulate many rollouts from the same initial state.
+      The first cycle of each rollout uses the given command set and the
+      following cycles are simulated without commands.
+      \param initial initial state
+      \param first_commands the first commands for each rollout
+      \param n_step the number of cycles of each rollout (>= 1)
+      \param results container to store the final state of each rollout
+      \return the number of rollouts
+     */
+    std::size_t runBatch( const SimState & initial,
+                          const std::vector< SimCommandSet > & first_commands,
+                          const int n_step,
+                          std::vector< SimState > * results );
+
+    /*!
+      \brief simulate many rollouts from the same initial state.
+      \param initial initial state
+      \param policies command generator for each rollout
+      \param n_step the number of cycles of each rollout
+      \param results container to store the final state of each rollout
+      \return the number of rollouts
+     */
+    std::size_t runBatch( const SimState & initial,
+                          const std::vector< Policy > & policies,
+                          const int n_step,
+                          std::vector< SimState > * results );
+
+    /*!
+      \brief calculate the tackle success probability
+      \param player player state
+      \param ball_pos ball position
+      \return probability value [0, 1]
+     */
+    static
+    double tackle_probability( const SimPlayer & player,
+                               const Vector2D & ball_pos );
+
+private:
+
+    void executeCommands( SimState * state,
+                          const SimCommandSet & commands );
+
+    void turn( SimPlayer & player,
+               const SimCommand & command );
+    void dash( const int index,
+               SimPlayer & player,
+               const SimCommand & command );
+    void kick( const SimPlayer & player,
+               const SimBall & ball,
+               const SimCommand & command );
+    void tackle( SimPlayer & player,
+                 const SimBall & ball,
+                 const SimCommand & command );
+
+    void move( SimState * state );
+    void collide( SimState * state );
+
+    Vector2D noise( const double max_rand );
+    double uniform( const double min,
+                    const double max );
+};
+
+}
+
+#endif
@@ -0,0 +1,283 @@
+// -*-c++-*-
+
+/*!
+  \file test_episode_runner.cpp
+  \brief test code for rcsc::EpisodeRunner and rcsc::SimServer
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "episode_runner.h"
+
+#include <rcsc/common/player_type.h>
+#include <rcsc/common/server_param.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+#include <iostream>
+
+namespace {
+
+/*!
+  \brief one player chases the moving ball until it becomes kickable.
+ */
+class ChaseScenario
+    : public rcsc::SimScenario {
+public:
+
+    void setup( const int episode,
+                rcsc::SimServer & server ) override
+      {
+          std::mt19937 engine( episode );
+          std::uniform_real_distribution<> x_rng( -40.0, 40.0 );
+          std::uniform_real_distribution<> y_rng( -25.0, 25.0 );
+          std::uniform_real_distribution<> vel_rng( -1.5, 1.5 );
+          std::uniform_real_distribution<> dir_rng( -180.0, 180.0 );
+
+          server.addPlayer( rcsc::LEFT, 1, false, rcsc::Vector2D( 0.0, 0.0 ), 0.0 );
+          server.doMovePlayer( rcsc::LEFT, 1,
+                               rcsc::Vector2D( x_rng( engine ), y_rng( engine ) ),
+                               dir_rng( engine ) );
+          server.doMoveBall( rcsc::Vector2D( x_rng( engine ), y_rng( engine ) ),
+                             rcsc::Vector2D( vel_rng( engine ), vel_rng( engine ) ) );
+          server.doKickOff();
+      }
+
+    void decide( const rcsc::SimServer & server,
+                 rcsc::SimCommandSet * commands ) override
+      {
+          const rcsc::SimPlayer & p = server.state().players_[0];
+          const rcsc::Vector2D ball_next = server.state().ball_.pos_ + server.state().ball_.vel_;
+          const rcsc::AngleDeg diff = ( ball_next - p.pos_ ).th() - p.body_;
+
+          if ( diff.abs() > 15.0 )
+          {
+              (*commands)[0] = rcsc::SimCommand::turn( diff.degree() * ( 1.0 + p.type_->inertiaMoment() * p.vel_.r() ) );
+          }
+          else
+          {
+              (*commands)[0] = rcsc::SimCommand::dash( 100.0 );
+          }
+      }
+
+    bool judge( const rcsc::SimServer & server,
+                double * reward ) override
+      {
+          const rcsc::SimPlayer & p = server.state().players_[0];
+          if ( p.pos_.dist( server.state().ball_.pos_ ) < p.type_->kickableArea() )
+          {
+              *reward = 1.0 - server.cycle() * 0.01;
+              return true;
+          }
+          return false;
+      }
+};
+
+}
+
+class EpisodeRunnerTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( EpisodeRunnerTest );
+    CPPUNIT_TEST( testServer );
+    CPPUNIT_TEST( testGoal );
+    CPPUNIT_TEST( testRun );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testServer();
+    void testGoal();
+    void testRun();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EpisodeRunnerTest );
+
+/*-------------------------------------------------------------------*/
+void
+EpisodeRunnerTest::testServer()
+{
+    rcsc::SimServer server;
+
+    CPPUNIT_ASSERT_EQUAL( rcsc::PM_BeforeKickOff, server.playMode() );
+    CPPUNIT_ASSERT( server.addPlayer( rcsc::RIGHT, 3, false, rcsc::Vector2D( 10.0, 5.0 ), 90.0 ) );
+    CPPUNIT_ASSERT( ! server.addPlayer( rcsc::RIGHT, 3, false, rcsc::Vector2D( 0.0, 0.0 ), 0.0 ) );
+    CPPUNIT_ASSERT( ! server.addPlayer( rcsc::LEFT, 12, false, rcsc::Vector2D( 0.0, 0.0 ), 0.0 ) );
+    CPPUNIT_ASSERT( server.state().players_[13].isValid() );
+
+    CPPUNIT_ASSERT( ! server.doMovePlayer( rcsc::LEFT, 3, rcsc::Vector2D( 0.0, 0.0 ), 0.0 ) );
+    CPPUNIT_ASSERT( server.doMovePlayer( rcsc::RIGHT, 3, rcsc::Vector2D( -5.0, 1.0 ), 45.0,
+                                         rcsc::Vector2D( 0.5, 0.0 ) ) );
+    CPPUNIT_ASSERT( server.doChangePlayerType( rcsc::RIGHT, 3, 0 ) );
+    CPPUNIT_ASSERT( ! server.doChangePlayerType( rcsc::RIGHT, 3, -1 ) );
+
+    // players cannot move before kick off, but the objects keep their velocity.
+    rcsc::SimCommandSet commands;
+    commands[13] = rcsc::SimCommand::dash( 100.0 );
+    server.step( commands );
+    const double decay = server.state().players_[13].type_->playerDecay();
+    CPPUNIT_ASSERT_EQUAL( 1L, server.cycle() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5 * decay, server.state().players_[13].vel_.x, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( server.state().players_[13].stamina_.stamina(),
+                                  rcsc::ServerParam::i().staminaMax(), 1.0e-9 );
+
+    CPPUNIT_ASSERT( server.doKickOff() );
+    CPPUNIT_ASSERT( ! server.doKickOff() );
+    CPPUNIT_ASSERT_EQUAL( rcsc::PM_PlayOn, server.playMode() );
+    server.step( commands );
+    CPPUNIT_ASSERT( server.state().players_[13].stamina_.stamina() < rcsc::ServerParam::i().staminaMax() );
+
+    CPPUNIT_ASSERT( server.doRecover() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( server.state().players_[13].stamina_.stamina(),
+                                  rcsc::ServerParam::i().staminaMax(), 1.0e-9 );
+
+    CPPUNIT_ASSERT( ! server.doChangeMode( rcsc::PM_MAX ) );
+    CPPUNIT_ASSERT( server.doChangeMode( rcsc::PM_FreeKick_Left ) );
+    CPPUNIT_ASSERT_EQUAL( rcsc::PM_FreeKick_Left, server.playMode() );
+
+    server.clear();
+    CPPUNIT_ASSERT_EQUAL( 0L, server.cycle() );
+    CPPUNIT_ASSERT( ! server.state().players_[13].isValid() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+EpisodeRunnerTest::testGoal()
+{
+    rcsc::SimServer server;
+    server.doKickOff();
+    server.doMoveBall( rcsc::Vector2D( 50.0, 1.0 ), rcsc::Vector2D( 2.5, 0.0 ) );
+
+    for ( int i = 0; i < 5; ++i )
+    {
+        server.step();
+    }
+
+    CPPUNIT_ASSERT_EQUAL( rcsc::PM_AfterGoal_Left, server.playMode() );
+    CPPUNIT_ASSERT_EQUAL( 1, server.scoreLeft() );
+    CPPUNIT_ASSERT_EQUAL( 0, server.scoreRight() );
+
+    server.doChangeMode( rcsc::PM_PlayOn );
+    server.doMoveBall( rcsc::Vector2D( -50.0, 20.0 ), rcsc::Vector2D( -2.5, 0.0 ) );
+    for ( int i = 0; i < 5; ++i )
+    {
+        server.step();
+    }
+    CPPUNIT_ASSERT_EQUAL( rcsc::PM_PlayOn, server.playMode() );
+    CPPUNIT_ASSERT_EQUAL( 0, server.scoreRight() );
+}
+
+/*-------------------------------------------------------------------*/
+void
+EpisodeRunnerTest::testRun()
+{
+    const int n_episode = 2000;
+
+    rcsc::EpisodeRunner runner( []() { return rcsc::SimScenario::Ptr( new ChaseScenario() ); } );
+    runner.setMaxStep( 200 );
+
+    std::vector< rcsc::EpisodeResult > serial;
+    runner.setThreadCount( 1 );
+    const int n_finished = runner.run( n_episode, &serial );
+    const double serial_rate = runner.episodesPerSecond( n_episode );
+
+    std::vector< rcsc::EpisodeResult > parallel;
+    runner.setThreadCount( 0 );
+    CPPUNIT_ASSERT_EQUAL( n_finished, runner.run( n_episode, &parallel ) );
+    const double parallel_rate = runner.episodesPerSecond( n_episode );
+    const int n_thread = runner.threadCount();
+
+    CPPUNIT_ASSERT_EQUAL( std::size_t( n_episode ), serial.size() );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( n_episode ), parallel.size() );
+    CPPUNIT_ASSERT( n_finished > n_episode / 2 );
+
+    for ( int i = 0; i < n_episode; ++i )
+    {
+        CPPUNIT_ASSERT_EQUAL( i, serial[i].episode_ );
+        CPPUNIT_ASSERT_EQUAL( i, parallel[i].episode_ );
+        CPPUNIT_ASSERT_EQUAL( serial[i].step_, parallel[i].step_ );
+        CPPUNIT_ASSERT_EQUAL( serial[i].finished_, parallel[i].finished_ );
+        CPPUNIT_ASSERT_EQUAL( serial[i].reward_, parallel[i].reward_ );
+        CPPUNIT_ASSERT( serial[i].finished_ || serial[i].step_ == 200 );
+    }
+
+    // the noise is reproducible for each episode
+    std::vector< rcsc::EpisodeResult > noisy1, noisy2;
+    runner.setNoise( 10 );
+    runner.run( 200, &noisy1 );
+    runner.setThreadCount( 3 );
+    runner.run( 200, &noisy2 );
+    for ( int i = 0; i < 200; ++i )
+    {
+        CPPUNIT_ASSERT_EQUAL( noisy1[i].step_, noisy2[i].step_ );
+        CPPUNIT_ASSERT_EQUAL( noisy1[i].reward_, noisy2[i].reward_ );
+    }
+
+    std::cerr << "\n  " << n_episode << " episodes (" << n_finished << " finished)"
+              << ": 1 thread " << serial_rate << " episodes/sec"
+              << ", " << n_thread << " threads " << parallel_rate << " episodes/sec"
+              << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
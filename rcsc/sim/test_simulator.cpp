@@ -0,0 +1,545 @@
+// -*-c++-*-
+
+/*!
+  \file test_simulator.cpp
+  \brief test code for rcsc::Simulator
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "simulator.h"
+
+#include <rcsc/common/player_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/rcg/handler.h>
+#include <rcsc/rcg/parser.h>
+#include <rcsc/rcg/types.h>
+#include <rcsc/gz/gzfstream.h>
+#include <rcsc/time/timer.h>
+#include <rcsc/soccer_math.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+namespace {
+
+/*!
+  \brief collect show data from the rcg file
+ */
+class ShowCollector
+    : public rcsc::rcg::Handler {
+public:
+
+    std::vector< rcsc::rcg::ShowInfoT > shows_;
+    std::vector< rcsc::PlayMode > playmodes_;
+    rcsc::PlayMode playmode_;
+
+    ShowCollector()
+        : playmode_( rcsc::PM_Null )
+      { }
+
+    bool handleEOF() override
+      {
+          return true;
+      }
+
+    bool handleShow( const rcsc::rcg::ShowInfoT & show ) override
+      {
+          shows_.push_back( show );
+          playmodes_.push_back( playmode_ );
+          return true;
+      }
+
+    bool handleMsg( const int, const int, const std::string & ) override
+      {
+          return true;
+      }
+
+    bool handleDraw( const int, const rcsc::rcg::drawinfo_t & ) override
+      {
+          return true;
+      }
+
+    bool handlePlayMode( const int, const rcsc::PlayMode pm ) override
+      {
+          playmode_ = pm;
+          return true;
+      }
+
+    bool handleTeam( const int,
+                     const rcsc::rcg::TeamT &,
+                     const rcsc::rcg::TeamT & ) override
+      {
+          return true;
+      }
+
+    bool handleServerParam( const rcsc::rcg::ServerParamT & param ) override
+      {
+          rcsc::ServerParam::instance().convertFrom( param );
+          return true;
+      }
+
+    bool handlePlayerParam( const rcsc::rcg::PlayerParamT & param ) override
+      {
+          rcsc::PlayerParam::instance().convertFrom( param );
+          return true;
+      }
+
+    bool handlePlayerType( const rcsc::rcg::PlayerTypeT & param ) override
+      {
+          rcsc::PlayerTypeSet::instance().insert( rcsc::PlayerType( param ) );
+          return true;
+      }
+
+    bool handleTeamGraphic( const char,
+                            const int,
+                            const int,
+                            const std::vector< std::string > & ) override
+      {
+          return true;
+      }
+};
+
+/*!
+  \brief check if the player performed no command in the last cycle
+ */
+bool
+is_waiting( const rcsc::rcg::PlayerT & prev,
+            const rcsc::rcg::PlayerT & next )
+{
+    return ( prev.kick_count_ == next.kick_count_
+             && prev.dash_count_ == next.dash_count_
+             && prev.turn_count_ == next.turn_count_
+             && prev.catch_count_ == next.catch_count_
+             && prev.move_count_ == next.move_count_
+             && prev.tackle_count_ == next.tackle_count_
+             && ! next.isTackling()
+             && ! next.isCollidedBall()
+             && ! next.isCollidedPlayer() );
+}
+
+}
+
+class SimulatorTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( SimulatorTest );
+    CPPUNIT_TEST( testBall );
+    CPPUNIT_TEST( testDash );
+    CPPUNIT_TEST( testKick );
+    CPPUNIT_TEST( testCollision );
+    CPPUNIT_TEST( testNoise );
+    CPPUNIT_TEST( testRcg );
+    CPPUNIT_TEST( testBenchmark );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testBall();
+    void testDash();
+    void testKick();
+    void testCollision();
+    void testNoise();
+    void testRcg();
+    void testBenchmark();
+
+private:
+
+    static
+    void create_player( const rcsc::SideID side,
+                        const int unum,
+                        const rcsc::Vector2D & pos,
+                        const double body,
+                        rcsc::SimPlayer * p )
+      {
+          p->side_ = side;
+          p->unum_ = unum;
+          p->type_ = &rcsc::PlayerTypeSet::i().defaultType();
+          p->pos_ = pos;
+          p->body_ = body;
+          p->stamina_.init( *p->type_ );
+      }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SimulatorTest );
+
+/*-------------------------------------------------------------------*/
+void
+SimulatorTest::testBall()
+{
+    const rcsc::ServerParam & SP = rcsc::ServerParam::i();
+
+    rcsc::SimState state;
+    state.ball_.pos_.assign( -10.0, 5.0 );
+    state.ball_.vel_.assign( 2.0, -1.0 );
+
+    const rcsc::SimBall initial = state.ball_;
+
+    rcsc::Simulator sim;
+    sim.run( &state, 10 );
+
+    const rcsc::Vector2D expected_pos = rcsc::inertia_n_step_point( initial.pos_,
+                                                                    initial.vel_,
+                                                                    10,
+                                                                    SP.ballDecay() );
+    const rcsc::Vector2D expected_vel = initial.vel_ * std::pow( SP.ballDecay(), 10 );
+
+    CPPUNIT_ASSERT_EQUAL( 10L, state.cycle_ );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected_pos.x, state.ball_.pos_.x, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected_pos.y, state.ball_.pos_.y, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected_vel.x, state.ball_.vel_.x, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected_vel.y, state.ball_.vel_.y, 1.0e-9 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+SimulatorTest::testDash()
+{
+    const rcsc::ServerParam & SP = rcsc::ServerParam::i();
+
+    rcsc::SimState state;
+    state.ball_.pos_.assign( 30.0, 30.0 );
+    create_player( rcsc::LEFT, 1, rcsc::Vector2D( 0.0, 0.0 ), 30.0, &state.players_[0] );
+
+    const rcsc::PlayerType & ptype = *state.players_[0].type_;
+
+    rcsc::SimCommandSet commands;
+    commands[0] = rcsc::SimCommand::dash( 100.0 );
+
+    rcsc::Simulator sim;
+
+    rcsc::Vector2D pos( 0.0, 0.0 );
+    rcsc::Vector2D vel( 0.0, 0.0 );
+    rcsc::StaminaModel stamina;
+    stamina.init( ptype );
+
+    for ( int i = 0; i < 5; ++i )
+    {
+        vel += rcsc::Vector2D::polar2vector( 100.0 * ptype.dashRate( stamina.effort() ), 30.0 );
+        if ( vel.r() > ptype.playerSpeedMax() ) vel.setLength( ptype.playerSpeedMax() );
+        pos += vel;
+        vel *= ptype.playerDecay();
+        stamina.simulateDash( ptype, 100.0 );
+
+        sim.step( &state, commands );
+    }
+
+    const rcsc::SimPlayer & p = state.players_[0];
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( pos.x, p.pos_.x, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( pos.y, p.pos_.y, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( vel.x, p.vel_.x, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( vel.y, p.vel_.y, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( stamina.stamina(), p.stamina_.stamina(), 1.0e-9 );
+    CPPUNIT_ASSERT( p.stamina_.stamina() < SP.staminaMax() );
+
+    // turn
+    commands[0] = rcsc::SimCommand::turn( 60.0 );
+    const double expected_body = ( p.body_ + ptype.effectiveTurn( 60.0, p.vel_.r() ) ).degree();
+    sim.step( &state, commands );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected_body, state.players_[0].body_.degree(), 1.0e-9 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+SimulatorTest::testKick()
+{
+    const rcsc::ServerParam & SP = rcsc::ServerParam::i();
+
+    rcsc::SimState state;
+    create_player( rcsc::LEFT, 1, rcsc::Vector2D( 0.0, 0.0 ), 0.0, &state.players_[0] );
+    state.ball_.pos_.assign( 0.7, 0.0 );
+
+    const rcsc::PlayerType & ptype = *state.players_[0].type_;
+
+    rcsc::SimCommandSet commands;
+    commands[0] = rcsc::SimCommand::kick( 100.0, 20.0 );
+
+    rcsc::Simulator sim;
+    sim.step( &state, commands );
+
+    double accel = 100.0 * ptype.kickRate( 0.7, 0.0 );
+    accel = std::min( accel, SP.ballAccelMax() );
+    const rcsc::Vector2D vel = rcsc::Vector2D::polar2vector( accel, 20.0 );
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.7 + vel.x, state.ball_.pos_.x, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( vel.y, state.ball_.pos_.y, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( vel.x * SP.ballDecay(), state.ball_.vel_.x, 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( vel.y * SP.ballDecay(), state.ball_.vel_.y, 1.0e-9 );
+
+    // out of kickable area
+    const rcsc::SimBall ball = state.ball_;
+    sim.step( &state, commands );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( ( ball.pos_ + ball.vel_ ).x, state.ball_.pos_.x, 1.0e-9 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+SimulatorTest::testCollision()
+{
+    const rcsc::ServerParam & SP = rcsc::ServerParam::i();
+
+    rcsc::SimState state;
+    state.ball_.pos_.assign( 30.0, 30.0 );
+    create_player( rcsc::LEFT, 1, rcsc::Vector2D( 0.0, 0.0 ), 0.0, &state.players_[0] );
+    create_player( rcsc::RIGHT, 1, rcsc::Vector2D( 1.0, 0.0 ), 180.0, &state.players_[11] );
+    state.players_[0].vel_.assign( 0.5, 0.0 );
+    state.players_[11].vel_.assign( -0.5, 0.0 );
+
+    rcsc::Simulator sim;
+    sim.step( &state );
+
+    const double min_dist = state.players_[0].type_->playerSize() + state.players_[11].type_->playerSize();
+    CPPUNIT_ASSERT( state.players_[0].pos_.dist( state.players_[11].pos_ ) >= min_dist - 1.0e-9 );
+    CPPUNIT_ASSERT( state.players_[0].vel_.x < 0.0 );
+    CPPUNIT_ASSERT( state.players_[11].vel_.x > 0.0 );
+
+    // ball
+    state.clear();
+    create_player( rcsc::LEFT, 1, rcsc::Vector2D( 0.0, 0.0 ), 0.0, &state.players_[0] );
+    state.ball_.pos_.assign( 2.0, 0.0 );
+    state.ball_.vel_.assign( -2.0, 0.0 );
+    sim.step( &state );
+
+    CPPUNIT_ASSERT( state.ball_.pos_.dist( state.players_[0].pos_ )
+                    >= state.players_[0].type_->playerSize() + SP.ballSize() - 1.0e-9 );
+    CPPUNIT_ASSERT( state.ball_.vel_.x > 0.0 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+SimulatorTest::testNoise()
+{
+    rcsc::SimState initial;
+    initial.ball_.vel_.assign( 2.0, 0.0 );
+    create_player( rcsc::LEFT, 1, rcsc::Vector2D( -10.0, 0.0 ), 0.0, &initial.players_[0] );
+
+    rcsc::SimCommandSet commands;
+    commands[0] = rcsc::SimCommand::dash( 100.0 );
+
+    rcsc::Simulator sim0;
+    rcsc::Simulator sim1;
+    rcsc::Simulator sim2;
+    sim0.setNoise( 1 );
+    sim1.setNoise( 1 );
+    sim2.setNoise( 2 );
+
+    rcsc::SimState s0 = initial;
+    rcsc::SimState s1 = initial;
+    rcsc::SimState s2 = initial;
+    for ( int i = 0; i < 10; ++i )
+    {
+        sim0.step( &s0, commands );
+        sim1.step( &s1, commands );
+        sim2.step( &s2, commands );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( s0.ball_.pos_.x, s1.ball_.pos_.x );
+    CPPUNIT_ASSERT_EQUAL( s0.players_[0].pos_.y, s1.players_[0].pos_.y );
+    CPPUNIT_ASSERT( s0.ball_.pos_.x != s2.ball_.pos_.x );
+    CPPUNIT_ASSERT( s0.players_[0].pos_.y != s2.players_[0].pos_.y );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  Compare the prediction with the recorded game log given by the
+  environment variable RCSC_TEST_RCG.  Only the free ball movement
+  and the players that executed no command are checked, and the error
+  must be within the server's noise range.
+ */
+void
+SimulatorTest::testRcg()
+{
+    const char * path = std::getenv( "RCSC_TEST_RCG" );
+    if ( ! path )
+    {
+        std::cout << "\nRCSC_TEST_RCG is not set. skip the rcg validation." << std::endl;
+        return;
+    }
+
+    rcsc::gzifstream fin( path );
+    CPPUNIT_ASSERT( fin.is_open() );
+
+    rcsc::rcg::Parser::Ptr parser = rcsc::rcg::Parser::create( fin );
+    CPPUNIT_ASSERT( parser );
+
+    ShowCollector collector;
+    CPPUNIT_ASSERT( parser->parse( fin, collector ) );
+
+    const rcsc::ServerParam & SP = rcsc::ServerParam::i();
+
+    rcsc::Simulator sim;
+    int ball_count = 0;
+    int player_count = 0;
+
+    for ( std::size_t i = 1; i < collector.shows_.size(); ++i )
+    {
+        const rcsc::rcg::ShowInfoT & prev = collector.shows_[i - 1];
+        const rcsc::rcg::ShowInfoT & next = collector.shows_[i];
+
+        if ( next.time_ != prev.time_ + 1
+             || collector.playmodes_[i - 1] != rcsc::PM_PlayOn
+             || collector.playmodes_[i] != rcsc::PM_PlayOn )
+        {
+            continue;
+        }
+
+        rcsc::SimState state;
+        state.assign( prev );
+        sim.step( &state );
+
+        // free ball
+        bool free_ball = true;
+        for ( const rcsc::SimPlayer & p : state.players_ )
+        {
+            if ( p.isValid()
+                 && p.pos_.dist( state.ball_.pos_ ) < 3.0 )
+            {
+                free_ball = false;
+                break;
+            }
+        }
+
+        if ( free_ball )
+        {
+            const rcsc::Vector2D prev_vel( prev.ball_.vx_, prev.ball_.vy_ );
+            const double max_err = prev_vel.r() * SP.ballRand() * std::sqrt( 2.0 ) + 1.0e-3;
+
+            CPPUNIT_ASSERT( state.ball_.pos_.dist( rcsc::Vector2D( next.ball_.x_, next.ball_.y_ ) ) <= max_err );
+            ++ball_count;
+        }
+
+        // waiting players
+        for ( int p = 0; p < rcsc::SimState::MAX_PLAYER; ++p )
+        {
+            if ( ! state.players_[p].isValid()
+                 || ! is_waiting( prev.player_[p], next.player_[p] ) )
+            {
+                continue;
+            }
+
+            const rcsc::Vector2D prev_vel( prev.player_[p].vx_, prev.player_[p].vy_ );
+            const double max_err = prev_vel.r() * SP.playerRand() * std::sqrt( 2.0 ) + 1.0e-3;
+
+            CPPUNIT_ASSERT( state.players_[p].pos_.dist( rcsc::Vector2D( next.player_[p].x_,
+                                                                         next.player_[p].y_ ) ) <= max_err );
+            ++player_count;
+        }
+    }
+
+    std::cout << "\nrcg validation: " << collector.shows_.size() << " shows, "
+              << ball_count << " free ball moves, "
+              << player_count << " player moves checked." << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+void
+SimulatorTest::testBenchmark()
+{
+    rcsc::SimState initial;
+    initial.ball_.pos_.assign( 0.0, 0.0 );
+    for ( int i = 0; i < rcsc::SimState::MAX_PLAYER; ++i )
+    {
+        create_player( ( i < 11 ? rcsc::LEFT : rcsc::RIGHT ), i % 11 + 1,
+                       rcsc::Vector2D( ( i < 11 ? -1.0 : 1.0 ) * ( 5.0 + 4.0 * ( i % 11 ) ),
+                                       -20.0 + 4.0 * ( i % 11 ) ),
+                       ( i < 11 ? 0.0 : 180.0 ),
+                       &initial.players_[i] );
+    }
+    create_player( rcsc::LEFT, 1, rcsc::Vector2D( -0.7, 0.0 ), 0.0, &initial.players_[0] );
+
+    // kick candidates
+    std::vector< rcsc::SimCommandSet > candidates;
+    for ( int p = 0; p < 10; ++p )
+    {
+        for ( int d = 0; d < 200; ++d )
+        {
+            rcsc::SimCommandSet commands;
+            commands[0] = rcsc::SimCommand::kick( 10.0 + 10.0 * p, -180.0 + 1.8 * d );
+            for ( int i = 1; i < rcsc::SimState::MAX_PLAYER; ++i )
+            {
+                commands[i] = rcsc::SimCommand::dash( 100.0 );
+            }
+            candidates.push_back( commands );
+        }
+    }
+
+    rcsc::Simulator sim;
+    std::vector< rcsc::SimState > results;
+
+    rcsc::Timer timer;
+    sim.runBatch( initial, candidates, 20, &results );
+    const double elapsed = timer.elapsedReal();
+
+    std::cout << "\n" << results.size() << " rollouts x 20 cycles elapsed "
+              << elapsed << " [ms]" << std::endl;
+
+    CPPUNIT_ASSERT_EQUAL( candidates.size(), results.size() );
+    CPPUNIT_ASSERT_EQUAL( 20L, results.front().cycle_ );
+    CPPUNIT_ASSERT_EQUAL( static_cast< long >( candidates.size() * 20 ), sim.stepCount() );
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
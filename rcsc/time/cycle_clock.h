@@ -0,0 +1,179 @@
+// -*-c++-*-
+
+/*!
+  \file cycle_clock.h
+  \brief cycle relative time helper Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_TIME_CYCLE_CLOCK_H
+#define RCSC_TIME_CYCLE_CLOCK_H
+
+#include <rcsc/time/timer.h>
+
+namespace rcsc {
+
+/*!
+  \class CycleClock
+  \brief expresses the monotonic time relative to the sense_body
+  arrival of the current cycle.
+
+  The cycle length is the real time length, i.e., the simulator step
+  multiplied by the slow down factor.
+ */
+class CycleClock {
+private:
+    //! arrival time of the last sense_body message
+    TimeStamp M_sense_body;
+    //! length of one cycle in nanoseconds
+    std::int64_t M_cycle_nsec;
+
+public:
+
+    /*!
+      \brief construct with the default cycle length (100ms)
+     */
+    CycleClock()
+        : M_sense_body(),
+          M_cycle_nsec( 100 * 1000 * 1000 )
+      { }
+
+    /*!
+      \brief set the length of one cycle
+      \param msec milli seconds in the real time
+     */
+    void setCycleMSec( const int msec )
+      {
+          M_cycle_nsec = static_cast< std::int64_t >( msec ) * 1000 * 1000;
+      }
+
+    /*!
+      \brief set the arrival time of the sense_body message
+      \param stamp time stamp
+     */
+    void setSenseBody( const TimeStamp & stamp )
+      {
+          M_sense_body = stamp;
+      }
+
+    /*!
+      \brief check if the sense_body has been received
+      \return checked result
+     */
+    bool isValid() const
+      {
+          return M_sense_body.isValid();
+      }
+
+    /*!
+      \brief get the arrival time of the sense_body message
+      \return const reference to the time stamp
+     */
+    const TimeStamp & senseBody() const
+      {
+          return M_sense_body;
+      }
+
+    /*!
+      \brief get the length of one cycle
+      \return milli seconds
+     */
+    double cycleMSec() const
+      {
+          return M_cycle_nsec * 1.0e-6;
+      }
+
+    /*!
+      \brief get the estimated end of the current cycle
+      \return time stamp
+     */
+    TimeStamp cycleEnd() const
+      {
+          return M_sense_body.addNSec( M_cycle_nsec );
+      }
+
+    /*!
+      \brief get the time stamp relative to the sense_body arrival
+      \param msec milli seconds from the sense_body arrival
+      \return time stamp
+     */
+    TimeStamp at( const double msec ) const
+      {
+          return M_sense_body.addNSec( static_cast< std::int64_t >( msec * 1.0e+6 ) );
+      }
+
+    /*!
+      \brief get the elapsed nanoseconds from the sense_body arrival
+      \param stamp target time
+      \return nanoseconds
+     */
+    std::int64_t nsecFromSenseBody( const TimeStamp & stamp ) const
+      {
+          return stamp.nsecSince( M_sense_body );
+      }
+
+    /*!
+      \brief get the elapsed milli seconds from the sense_body arrival
+      \param stamp target time
+      \return milli seconds including the fraction
+     */
+    double msecFromSenseBody( const TimeStamp & stamp ) const
+      {
+          return stamp.msecSince( M_sense_body );
+      }
+
+    /*!
+      \brief get the elapsed milli seconds from the sense_body arrival until now
+      \return milli seconds including the fraction
+     */
+    double msecFromSenseBody() const
+      {
+          return msecFromSenseBody( TimeStamp::now() );
+      }
+
+    /*!
+      \brief get the milli seconds left until the estimated end of the current cycle
+      \param stamp target time
+      \return milli seconds. negative value if the cycle has already ended.
+     */
+    double msecToCycleEnd( const TimeStamp & stamp ) const
+      {
+          return ( M_cycle_nsec - nsecFromSenseBody( stamp ) ) * 1.0e-6;
+      }
+
+    /*!
+      \brief get the milli seconds left from now until the estimated end of the current cycle
+      \return milli seconds. negative value if the cycle has already ended.
+     */
+    double msecToCycleEnd() const
+      {
+          return msecToCycleEnd( TimeStamp::now() );
+      }
+};
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+// -*-c++-*-
+
+/*!
+  \file test_cycle_clock.cpp
+  \brief test code for rcsc::CycleClock and rcsc::TscClock
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "cycle_clock.h"
+#include "tsc_clock.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cmath>
+
+using namespace rcsc;
+
+/*-------------------------------------------------------------------*/
+
+class CycleClockTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( CycleClockTest );
+    CPPUNIT_TEST( testMonotonic );
+    CPPUNIT_TEST( testCycleRelative );
+    CPPUNIT_TEST( testTscClock );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+protected:
+    void testMonotonic();
+    void testCycleRelative();
+    void testTscClock();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CycleClockTest );
+
+/*-------------------------------------------------------------------*/
+void
+CycleClockTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+CycleClockTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+void
+CycleClockTest::testMonotonic()
+{
+    CPPUNIT_ASSERT( ! TimeStamp().isValid() );
+
+    TimeStamp prev = TimeStamp::now();
+    CPPUNIT_ASSERT( prev.isValid() );
+
+    for ( int i = 0; i < 10000; ++i )
+    {
+        const TimeStamp cur = TimeStamp::now();
+        CPPUNIT_ASSERT( cur.nsecSince( prev ) >= 0 );
+        prev = cur;
+    }
+
+    const TimeStamp base = TimeStamp::now();
+    const TimeStamp later = base.addNSec( 2500 * 1000 );
+    CPPUNIT_ASSERT_EQUAL( std::int64_t( 2500 * 1000 ), later.nsecSince( base ) );
+    CPPUNIT_ASSERT_EQUAL( std::int64_t( 2500 ), later.usecSince( base ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.5, later.msecSince( base ), 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( -2.5, base.msecSince( later ), 1.0e-9 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+CycleClockTest::testCycleRelative()
+{
+    CycleClock clock;
+    CPPUNIT_ASSERT( ! clock.isValid() );
+
+    const TimeStamp sense_body = TimeStamp::now();
+    clock.setSenseBody( sense_body );
+    clock.setCycleMSec( 150 );
+    CPPUNIT_ASSERT( clock.isValid() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 150.0, clock.cycleMSec(), 1.0e-9 );
+
+    const TimeStamp see = clock.at( 37.5 );
+    CPPUNIT_ASSERT_EQUAL( std::int64_t( 37500 * 1000 ), clock.nsecFromSenseBody( see ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 37.5, clock.msecFromSenseBody( see ), 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 112.5, clock.msecToCycleEnd( see ), 1.0e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, clock.msecToCycleEnd( clock.cycleEnd() ), 1.0e-9 );
+    CPPUNIT_ASSERT( clock.msecToCycleEnd( clock.at( 160.0 ) ) < 0.0 );
+
+    CPPUNIT_ASSERT( clock.msecFromSenseBody() >= 0.0 );
+}
+
+/*-------------------------------------------------------------------*/
+void
+CycleClockTest::testTscClock()
+{
+    CPPUNIT_ASSERT( TscClock::nsecPerTick() > 0.0 );
+
+    const TimeStamp start_time = TimeStamp::now();
+    const TscClock::tick_type start_tick = TscClock::now();
+
+    TimeStamp end_time;
+    do
+    {
+        end_time = TimeStamp::now();
+    }
+    while ( end_time.msecSince( start_time ) < 20.0 );
+
+    const TscClock::tick_type end_tick = TscClock::now();
+
+    // the calibrated ticks should agree with the steady clock within 5%.
+    const double tick_msec = TscClock::toMSec( end_tick - start_tick );
+    const double steady_msec = end_time.msecSince( start_time );
+    CPPUNIT_ASSERT( std::fabs( tick_msec - steady_msec ) < steady_msec * 0.05 );
+}
+
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -2,7 +2,7 @@
 
 /*!
   \file timer.cpp
-  \brief milli second timer Source File
+  \brief monotonic time stamp and timer Source File
 */
 
 /*
@@ -46,17 +46,19 @@ namespace rcsc {
 std::int64_t
 Timer::elapsed( const Type type ) const
 {
+    const TimeStamp::clock_type::duration d = TimeStamp::clock_type::now() - M_start_time.timePoint();
+
     switch ( type ) {
     case MSec:
-        return std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::system_clock::now() - M_start_time.timePoint() ).count();
+        return std::chrono::duration_cast< std::chrono::milliseconds >( d ).count();
     case Sec:
-        return std::chrono::duration_cast< std::chrono::seconds >( std::chrono::system_clock::now() - M_start_time.timePoint() ).count();
+        return std::chrono::duration_cast< std::chrono::seconds >( d ).count();
     case Min:
-        return std::chrono::duration_cast< std::chrono::minutes >( std::chrono::system_clock::now() - M_start_time.timePoint() ).count();
+        return std::chrono::duration_cast< std::chrono::minutes >( d ).count();
     case Hour:
-        return std::chrono::duration_cast< std::chrono::hours >( std::chrono::system_clock::now() - M_start_time.timePoint() ).count();
+        return std::chrono::duration_cast< std::chrono::hours >( d ).count();
     case Day:
-        return std::chrono::duration_cast< std::chrono::hours >( std::chrono::system_clock::now() - M_start_time.timePoint() ).count() / 24;
+        return std::chrono::duration_cast< std::chrono::hours >( d ).count() / 24;
     default:
         break;
     }
@@ -71,7 +73,7 @@ Timer::elapsed( const Type type ) const
 double
 Timer::elapsedReal( const Type type ) const
 {
-    const double nano = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::system_clock::now() - M_start_time.timePoint() ).count();
+    const double nano = elapsedNSec();
 
     switch ( type ) {
     case MSec:
@@ -81,9 +83,9 @@ Timer::elapsedReal( const Type type ) const
     case Min:
         return nano * 0.001 * 0.001 * 0.001 / 60.0;
     case Hour:
-        return nano * 0.001 * 0.001 * 0.001 * 0.001 / 60.0 / 60.0;
+        return nano * 0.001 * 0.001 * 0.001 / 60.0 / 60.0;
     case Day:
-        return nano * 0.001 * 0.001 * 0.001 * 0.001 / 60.0 / 60.0 / 24.0;
+        return nano * 0.001 * 0.001 * 0.001 / 60.0 / 60.0 / 24.0;
     default:
         break;
     }
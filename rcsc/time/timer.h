@@ -2,7 +2,7 @@
 
 /*!
   \file timer.h
-  \brief milli second timer Header File
+  \brief monotonic time stamp and timer Header File
 */
 
 /*
@@ -39,13 +39,18 @@ namespace rcsc {
 
 /*!
   \class TimeStamp
-  \brief wrapper class of the system time point
+  \brief wrapper class of the monotonic time point.
+
+  The time point is taken from std::chrono::steady_clock, so it is not
+  affected by the system clock adjustment.  The resolution is
+  nanoseconds on the common platforms.
  */
 class TimeStamp {
 public:
-    typedef std::chrono::system_clock::time_point value_type;
+    typedef std::chrono::steady_clock clock_type;
+    typedef clock_type::time_point value_type;
 private:
-    std::chrono::system_clock::time_point M_time_point;
+    value_type M_time_point;
 
 public:
 
@@ -65,6 +70,16 @@ public:
         : M_time_point( tp )
       { }
 
+    /*!
+      \brief create the time stamp of the current time
+      \return time stamp instance
+     */
+    static
+    TimeStamp now()
+      {
+          return TimeStamp( clock_type::now() );
+      }
+
     bool isValid() const
       {
           return M_time_point.time_since_epoch().count() > 0;
@@ -75,7 +90,7 @@ public:
      */
     void setNow()
       {
-          M_time_point = std::chrono::system_clock::now();
+          M_time_point = clock_type::now();
       }
 
     /*!
@@ -96,11 +111,49 @@ public:
           return std::chrono::duration_cast< std::chrono::milliseconds >( this->timePoint() - other.timePoint() ).count();
       }
 
+    /*!
+      \brief get the microseconds value since the given time stamp
+      \return count value in the order of microsecond
+     */
+    std::int64_t usecSince( const TimeStamp & other ) const
+      {
+          return std::chrono::duration_cast< std::chrono::microseconds >( this->timePoint() - other.timePoint() ).count();
+      }
+
+    /*!
+      \brief get the nanoseconds value since the given time stamp
+      \return count value in the order of nanosecond
+     */
+    std::int64_t nsecSince( const TimeStamp & other ) const
+      {
+          return std::chrono::duration_cast< std::chrono::nanoseconds >( this->timePoint() - other.timePoint() ).count();
+      }
+
+    /*!
+      \brief get the milliseconds since the given time stamp by floating point number
+      \return milli seconds including the fraction
+     */
+    double msecSince( const TimeStamp & other ) const
+      {
+          return nsecSince( other ) * 1.0e-6;
+      }
+
+    /*!
+      \brief get the time stamp shifted by the given duration
+      \param nsec nanoseconds to be added
+      \return new time stamp instance
+     */
+    TimeStamp addNSec( const std::int64_t nsec ) const
+      {
+          return TimeStamp( M_time_point
+                            + std::chrono::duration_cast< clock_type::duration >( std::chrono::nanoseconds( nsec ) ) );
+      }
+
 };
 
 /*!
   \class Timer
-  \brief this class enables to measure the elapsed time.
+  \brief this class enables to measure the elapsed time on the monotonic clock.
  */
 class Timer {
 public:
@@ -122,10 +175,10 @@ private:
 
 public:
     /*!
-      \brief construct with the current system clock time
+      \brief construct with the current time
      */
     Timer()
-        : M_start_time( std::chrono::system_clock::now() )
+        : M_start_time( TimeStamp::now() )
       { }
 
     /*!
@@ -136,6 +189,15 @@ public:
           M_start_time.setNow();
       }
 
+    /*!
+      \brief get the started time
+      \return const reference to the time stamp
+     */
+    const TimeStamp & startTime() const
+      {
+          return M_start_time;
+      }
+
     /*!
       \brief elapsed milli seconds since last start time.
       \return elapsed milli seconde by long integer
@@ -147,6 +209,15 @@ public:
       \return elapsed milli seconde by floating point number
      */
     double elapsedReal( const Type type = MSec ) const;
+
+    /*!
+      \brief elapsed nanoseconds since last start time.
+      \return elapsed nanoseconds
+     */
+    std::int64_t elapsedNSec() const
+      {
+          return TimeStamp::now().nsecSince( M_start_time );
+      }
 };
 
 /*-------------------------------------------------------------------*/
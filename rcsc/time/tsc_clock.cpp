@@ -0,0 +1,87 @@
+// -*-c++-*-
+
+/*!
+  \file tsc_clock.cpp
+  \brief low overhead tick counter for profiling Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "tsc_clock.h"
+
+namespace rcsc {
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief measure the tick length by the busy wait of a few milli seconds.
+ */
+double
+calibrate()
+{
+#ifdef RCSC_TSC_CLOCK_RDTSC
+    const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    const TscClock::tick_type start_tick = TscClock::now();
+
+    std::chrono::steady_clock::time_point end_time;
+    do
+    {
+        end_time = std::chrono::steady_clock::now();
+    }
+    while ( end_time - start_time < std::chrono::milliseconds( 5 ) );
+
+    const TscClock::tick_type end_tick = TscClock::now();
+
+    const double nsec = std::chrono::duration_cast< std::chrono::nanoseconds >( end_time - start_time ).count();
+    if ( end_tick <= start_tick )
+    {
+        return 1.0;
+    }
+
+    return nsec / static_cast< double >( end_tick - start_tick );
+#else
+    return 1.0;
+#endif
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+double
+TscClock::nsecPerTick()
+{
+    static const double s_nsec_per_tick = calibrate();
+    return s_nsec_per_tick;
+}
+
+}
@@ -0,0 +1,122 @@
+// -*-c++-*-
+
+/*!
+  \file tsc_clock.h
+  \brief low overhead tick counter for profiling Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_TIME_TSC_CLOCK_H
+#define RCSC_TIME_TSC_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#if ( defined(__x86_64__) || defined(__i386__) ) && defined(__GNUC__)
+#include <x86intrin.h>
+#define RCSC_TSC_CLOCK_RDTSC
+#endif
+
+namespace rcsc {
+
+/*!
+  \class TscClock
+  \brief low overhead tick counter for the hot path instrumentation.
+
+  On x86 the time stamp counter is read directly and the tick length is
+  calibrated against std::chrono::steady_clock at the first call of
+  nsecPerTick().  On other platforms the ticks are the nanoseconds of
+  steady_clock.  The ticks should be used only to measure short
+  intervals on the same thread.
+ */
+class TscClock {
+public:
+    //! tick count type
+    typedef std::uint64_t tick_type;
+
+    /*!
+      \brief read the current tick count
+      \return tick count
+     */
+    static
+    tick_type now()
+      {
+#ifdef RCSC_TSC_CLOCK_RDTSC
+          return __rdtsc();
+#else
+          return static_cast< tick_type >
+              ( std::chrono::duration_cast< std::chrono::nanoseconds >
+                ( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#endif
+      }
+
+    /*!
+      \brief check if the hardware counter is used
+      \return checked result
+     */
+    static
+    bool isHardwareCounter()
+      {
+#ifdef RCSC_TSC_CLOCK_RDTSC
+          return true;
+#else
+          return false;
+#endif
+      }
+
+    /*!
+      \brief get the calibrated length of one tick
+      \return nanoseconds per tick
+     */
+    static
+    double nsecPerTick();
+
+    /*!
+      \brief convert the tick count to nanoseconds
+      \param ticks tick count, usually the difference of two now() values
+      \return nanoseconds
+     */
+    static
+    double toNSec( const tick_type ticks )
+      {
+          return ticks * nsecPerTick();
+      }
+
+    /*!
+      \brief convert the tick count to milli seconds
+      \param ticks tick count, usually the difference of two now() values
+      \return milli seconds
+     */
+    static
+    double toMSec( const tick_type ticks )
+      {
+          return ticks * nsecPerTick() * 1.0e-6;
+      }
+};
+
+}
+
+#endif
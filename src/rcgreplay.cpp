@@ -0,0 +1,122 @@
+// -*-c++-*-
+
+/*!
+  \file rcgreplay.cpp
+  \brief rcg replayer over the monitor protocol source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsc/monitor/monitor_replayer.h>
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+///////////////////////////////////////////////////////////
+
+/*---------------------------------------------------------------*/
+/*
+
+*/
+static
+void
+usage( const char * prog )
+{
+    std::cerr << "Usage: " << prog << " [--port <Port>] [--interval <MSec>] <RcgFile>[.gz]\n"
+              << "  Wait for a monitor client and send the rcg data over UDP.\n"
+              << "  The default port is 6000 and the default interval is 100 [ms]."
+              << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+
+int
+main( int argc, char ** argv )
+{
+    int port = 6000;
+    int interval = 100;
+    std::string filepath;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        if ( arg == "--port" && i + 1 < argc )
+        {
+            port = std::atoi( argv[++i] );
+        }
+        else if ( arg == "--interval" && i + 1 < argc )
+        {
+            interval = std::atoi( argv[++i] );
+        }
+        else if ( arg[0] != '-' )
+        {
+            filepath = arg;
+        }
+        else
+        {
+            usage( argv[0] );
+            return 1;
+        }
+    }
+
+    if ( filepath.empty() )
+    {
+        usage( argv[0] );
+        return 1;
+    }
+
+    rcsc::MonitorReplayer replayer;
+    replayer.setInterval( interval );
+
+    if ( ! replayer.open( filepath ) )
+    {
+        return 1;
+    }
+
+    if ( ! replayer.bind( port ) )
+    {
+        return 1;
+    }
+
+    std::cout << "waiting for a monitor client on port " << replayer.port()
+              << " ..." << std::endl;
+
+    while ( ! replayer.waitClient( 1000 ) )
+    {
+
+    }
+
+    const std::size_t count = replayer.replay();
+
+    std::cout << count << " lines sent." << std::endl;
+
+    return 0;
+}